@@ -19,6 +19,7 @@ option(RETDEC_ENABLE_CAPSTONE2LLVMIRTOOL "" OFF)
 option(RETDEC_ENABLE_COMMON "" OFF)
 option(RETDEC_ENABLE_CONFIG "" OFF)
 option(RETDEC_ENABLE_CPDETECT "" OFF)
+option(RETDEC_ENABLE_CPDETECTTOOL "" OFF)
 option(RETDEC_ENABLE_CTYPES "" OFF)
 option(RETDEC_ENABLE_CTYPESPARSER "" OFF)
 option(RETDEC_ENABLE_DEBUGFORMAT "" OFF)
@@ -76,6 +77,7 @@ foreach(t ${RETDEC_ENABLE})
 	set_if_equal(${t} "common" RETDEC_ENABLE_COMMON)
 	set_if_equal(${t} "config" RETDEC_ENABLE_CONFIG)
 	set_if_equal(${t} "cpdetect" RETDEC_ENABLE_CPDETECT)
+	set_if_equal(${t} "cpdetecttool" RETDEC_ENABLE_CPDETECTTOOL)
 	set_if_equal(${t} "ctypes" RETDEC_ENABLE_CTYPES)
 	set_if_equal(${t} "ctypesparser" RETDEC_ENABLE_CTYPESPARSER)
 	set_if_equal(${t} "debugformat" RETDEC_ENABLE_DEBUGFORMAT)
@@ -118,6 +120,7 @@ if (RETDEC_ENABLE_AR_EXTRACTOR
 	OR RETDEC_ENABLE_COMMON
 	OR RETDEC_ENABLE_CONFIG
 	OR RETDEC_ENABLE_CPDETECT
+	OR RETDEC_ENABLE_CPDETECTTOOL
 	OR RETDEC_ENABLE_CTYPES
 	OR RETDEC_ENABLE_CTYPESPARSER
 	OR RETDEC_ENABLE_DEBUGFORMAT
@@ -189,6 +192,9 @@ if(RETDEC_DEV_TOOLS)
 			RETDEC_ENABLE_ALL)
 endif()
 
+set_if_at_least_one_set(RETDEC_ENABLE_CPDETECTTOOL
+		RETDEC_ENABLE_ALL)
+
 if(RETDEC_DEV_TOOLS)
 	set_if_at_least_one_set(RETDEC_ENABLE_DEMANGLERTOOL
 			RETDEC_ENABLE_ALL)
@@ -263,10 +269,12 @@ set_if_at_least_one_set(RETDEC_ENABLE_CAPSTONE2LLVMIR
 set_if_at_least_one_set(RETDEC_ENABLE_STACOFIN
 		RETDEC_ENABLE_ALL
 		RETDEC_ENABLE_BIN2LLVMIR
+		RETDEC_ENABLE_PAT2YARA
 		RETDEC_ENABLE_STACOFINTOOL)
 
 set_if_at_least_one_set(RETDEC_ENABLE_CPDETECT
 		RETDEC_ENABLE_ALL
+		RETDEC_ENABLE_CPDETECTTOOL
 		RETDEC_ENABLE_FILEINFO
 		RETDEC_ENABLE_BIN2LLVMIR
 		RETDEC_ENABLE_UNPACKERTOOL)
@@ -360,6 +368,7 @@ set_if_at_least_one_set(RETDEC_ENABLE_UTILS
 		RETDEC_ENABLE_CAPSTONE2LLVMIRTOOL
 		RETDEC_ENABLE_CONFIG
 		RETDEC_ENABLE_COMMON
+		RETDEC_ENABLE_CPDETECTTOOL
 		RETDEC_ENABLE_CTYPES
 		RETDEC_ENABLE_CTYPESPARSER
 		RETDEC_ENABLE_FILEFORMAT
@@ -392,6 +401,9 @@ set_if_all_set(RETDEC_ENABLE_CAPSTONE2LLVMIR_TESTS
 set_if_all_set(RETDEC_ENABLE_CONFIG_TESTS
 		RETDEC_TESTS
 		RETDEC_ENABLE_CONFIG)
+set_if_all_set(RETDEC_ENABLE_CPDETECT_TESTS
+		RETDEC_TESTS
+		RETDEC_ENABLE_CPDETECT)
 set_if_all_set(RETDEC_ENABLE_CTYPES_TESTS
 		RETDEC_TESTS
 		RETDEC_ENABLE_CTYPES)
@@ -416,6 +428,9 @@ set_if_all_set(RETDEC_ENABLE_LOADER_TESTS
 set_if_all_set(RETDEC_ENABLE_SERDES_TESTS
 		RETDEC_TESTS
 		RETDEC_ENABLE_SERDES)
+set_if_all_set(RETDEC_ENABLE_STACOFIN_TESTS
+		RETDEC_TESTS
+		RETDEC_ENABLE_STACOFIN)
 set_if_all_set(RETDEC_ENABLE_UNPACKER_TESTS
 		RETDEC_TESTS
 		RETDEC_ENABLE_UNPACKER)
@@ -425,6 +440,9 @@ set_if_all_set(RETDEC_ENABLE_COMMON_TESTS
 set_if_all_set(RETDEC_ENABLE_UTILS_TESTS
 		RETDEC_TESTS
 		RETDEC_ENABLE_UTILS)
+set_if_all_set(RETDEC_ENABLE_YARACPP_TESTS
+		RETDEC_TESTS
+		RETDEC_ENABLE_YARACPP)
 
 # src depending on tests
 set_if_at_least_one_set(RETDEC_ENABLE_LLVMIR_EMUL
@@ -446,6 +464,7 @@ set_if_at_least_one_set(RETDEC_ENABLE_GOOGLETEST
 		RETDEC_ENABLE_CAPSTONE2LLVMIR_TESTS
 		RETDEC_ENABLE_COMMON_TESTS
 		RETDEC_ENABLE_CONFIG_TESTS
+		RETDEC_ENABLE_CPDETECT_TESTS
 		RETDEC_ENABLE_CTYPES_TESTS
 		RETDEC_ENABLE_CTYPESPARSER_TESTS
 		RETDEC_ENABLE_DEMANGLER_TESTS
@@ -454,8 +473,10 @@ set_if_at_least_one_set(RETDEC_ENABLE_GOOGLETEST
 		RETDEC_ENABLE_LLVMIR2HLL_TESTS
 		RETDEC_ENABLE_LOADER_TESTS
 		RETDEC_ENABLE_SERDES_TESTS
+		RETDEC_ENABLE_STACOFIN_TESTS
 		RETDEC_ENABLE_UNPACKER_TESTS
-		RETDEC_ENABLE_UTILS_TESTS)
+		RETDEC_ENABLE_UTILS_TESTS
+		RETDEC_ENABLE_YARACPP_TESTS)
 
 set_if_at_least_one_set(RETDEC_ENABLE_KEYSTONE
 		RETDEC_ENABLE_CAPSTONE2LLVMIRTOOL
@@ -478,6 +499,7 @@ set_if_at_least_one_set(RETDEC_ENABLE_RAPIDJSON
 		RETDEC_ENABLE_AR_EXTRACTOR
 		RETDEC_ENABLE_AR_EXTRACTORTOOL
 		RETDEC_ENABLE_CONFIG
+		RETDEC_ENABLE_CPDETECTTOOL
 		RETDEC_ENABLE_CTYPESPARSER
 		RETDEC_ENABLE_FILEINFO
 		RETDEC_ENABLE_MACHO_EXTRACTOR
@@ -522,6 +544,7 @@ set_if_at_least_one_set(RETDEC_ENABLE_SUPPORT_YARA_SIGNSRCH
 set_if_at_least_one_set(RETDEC_ENABLE_SUPPORT_YARA_TOOLS
 		RETDEC_ENABLE_RETDEC
 		RETDEC_ENABLE_CPDETECT
+		RETDEC_ENABLE_CPDETECTTOOL
 		RETDEC_ENABLE_FILEINFO)
 
 set_if_at_least_one_set(RETDEC_ENABLE_SUPPORT_YARA_STATIC_CODE
@@ -77,6 +77,10 @@ class elfio
         real_file_length = 0;
         header           = 0;
         current_file_pos = 0;
+        // DECOMPILER BEGIN
+        file_data        = 0;
+        file_data_size   = 0;
+        // DECOMPILER END
         create( ELFCLASS32, ELFDATA2LSB );
     }
 
@@ -112,6 +116,28 @@ class elfio
         return load(ifStream);
     }
 
+// DECOMPILER BEGIN
+//------------------------------------------------------------------------------
+    // Load from the stream, but make section and segment data references into
+    // the file content already available in memory (data, size) instead of
+    // reading their copies. The buffer must outlive this object.
+    bool load( std::istream &stream, const char* data, size_t size )
+    {
+        set_file_data( data, size );
+        return load( stream );
+    }
+
+//------------------------------------------------------------------------------
+    // Sections and segments created from now on reference data in the given
+    // file content buffer when they are loaded. Use (0, 0) to copy data again.
+    void set_file_data( const char* data, size_t size )
+    {
+        file_data        = data;
+        file_data_size   = data ? size : 0;
+        real_file_length = file_data_size;
+    }
+// DECOMPILER END
+
 //------------------------------------------------------------------------------
     bool load( std::istream &stream )
     {
@@ -123,6 +149,12 @@ class elfio
         stream.seekg( 0, std::ios::end );
         real_file_length = stream.tellg();
         clean();
+        // DECOMPILER BEGIN
+        if ( file_data_size < real_file_length ) {
+            file_data      = 0;
+            file_data_size = 0;
+        }
+        // DECOMPILER END
 
         unsigned char e_ident[EI_NIDENT];
 
@@ -334,10 +366,10 @@ class elfio
         unsigned char file_class = get_class();
 
         if ( file_class == ELFCLASS64 ) {
-            new_section = new section_impl<Elf64_Shdr>( &convertor, real_file_length );
+            new_section = new section_impl<Elf64_Shdr>( &convertor, real_file_length, file_data );
         }
         else if ( file_class == ELFCLASS32 ) {
-            new_section = new section_impl<Elf32_Shdr>( &convertor, real_file_length );
+            new_section = new section_impl<Elf32_Shdr>( &convertor, real_file_length, file_data );
         }
         else {
             return 0;
@@ -356,10 +388,10 @@ class elfio
         unsigned char file_class = header->get_class();
 
         if ( file_class == ELFCLASS64 ) {
-            new_segment = new segment_impl<Elf64_Phdr>( &convertor, real_file_length );
+            new_segment = new segment_impl<Elf64_Phdr>( &convertor, real_file_length, file_data );
         }
         else if ( file_class == ELFCLASS32 ) {
-            new_segment = new segment_impl<Elf32_Phdr>( &convertor, real_file_length );
+            new_segment = new segment_impl<Elf32_Phdr>( &convertor, real_file_length, file_data );
         }
         else {
             return 0;
@@ -441,10 +473,10 @@ class elfio
             unsigned char file_class = header->get_class();
 
             if ( file_class == ELFCLASS64 ) {
-                seg = new segment_impl<Elf64_Phdr>( &convertor, real_file_length );
+                seg = new segment_impl<Elf64_Phdr>( &convertor, real_file_length, file_data );
             }
             else if ( file_class == ELFCLASS32 ) {
-                seg = new segment_impl<Elf32_Phdr>( &convertor, real_file_length );
+                seg = new segment_impl<Elf32_Phdr>( &convertor, real_file_length, file_data );
             }
             else {
                 return false;
@@ -871,6 +903,10 @@ class elfio
 //------------------------------------------------------------------------------
   private:
     size_t                real_file_length;
+    // DECOMPILER BEGIN
+    const char*           file_data;
+    size_t                file_data_size;
+    // DECOMPILER END
     elf_header*           header;
     std::ifstream         ifStream;
     std::istream*         iStream;
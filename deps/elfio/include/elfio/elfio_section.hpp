@@ -54,6 +54,9 @@ class section
     virtual void        set_data( const std::string& data )             = 0;
     virtual void        append_data( const char* pData, Elf_Word size ) = 0;
     virtual void        append_data( const std::string& data )          = 0;
+    // DECOMPILER BEGIN
+    virtual void        set_data_reference( const char* pData, Elf_Xword size ) = 0;
+    // DECOMPILER END
 
   protected:
     ELFIO_SET_ACCESS_DECL( Elf_Half,  index  );
@@ -74,20 +77,27 @@ class section_impl : public section
 {
   public:
 //------------------------------------------------------------------------------
-    section_impl( const endianess_convertor* convertor_, size_t file_length_ ) :
-        convertor( convertor_ ), file_length( file_length_ )
+    // DECOMPILER BEGIN
+    // If file_data_ is given, section data are references into it instead of
+    // copies read from the stream. The buffer must outlive the section.
+    section_impl( const endianess_convertor* convertor_, size_t file_length_,
+                  const char* file_data_ = 0 ) :
+        convertor( convertor_ ), file_length( file_length_ ),
+        file_data( file_data_ )
     {
         std::fill_n( reinterpret_cast<char*>( &header ), sizeof( header ), '\0' );
         is_address_set = false;
         data           = 0;
         data_size      = 0;
+        data_owned     = true;
     }
 
 //------------------------------------------------------------------------------
     ~section_impl()
     {
-        delete [] data;
+        release_data();
     }
+    // DECOMPILER END
 
 //------------------------------------------------------------------------------
     // Section info functions
@@ -158,7 +168,9 @@ class section_impl : public section
     set_data( const char* raw_data, Elf_Word size )
     {
         if ( get_type() != SHT_NOBITS ) {
-            delete [] data;
+            // DECOMPILER BEGIN
+            release_data();
+            // DECOMPILER END
             try {
                 data = new char[size];
             } catch (const std::bad_alloc&) {
@@ -187,7 +199,9 @@ class section_impl : public section
     append_data( const char* raw_data, Elf_Word size )
     {
         if ( get_type() != SHT_NOBITS ) {
-            if ( get_size() + size < data_size ) {
+            // DECOMPILER BEGIN
+            if ( data_owned && get_size() + size < data_size ) {
+            // DECOMPILER END
                 std::copy( raw_data, raw_data + size, data + get_size() );
             }
             else {
@@ -202,8 +216,11 @@ class section_impl : public section
                 if ( 0 != new_data ) {
                     std::copy( data, data + get_size(), new_data );
                     std::copy( raw_data, raw_data + size, new_data + get_size() );
-                    delete [] data;
-                    data = new_data;
+                    // DECOMPILER BEGIN
+                    release_data();
+                    data       = new_data;
+                    data_owned = true;
+                    // DECOMPILER END
                 }
             }
             set_size( get_size() + size );
@@ -224,8 +241,21 @@ class section_impl : public section
           size_t        size )
     {
         if ( get_type() != SHT_NULL && get_type() != SHT_NOBITS && size != 0 ) {
+            // DECOMPILER BEGIN
+            if ( 0 != file_data ) {
+                release_data();
+                data_owned = false;
+                if ( data_offset < file_length ) {
+                    data      = const_cast<char*>( file_data + data_offset );
+                    data_size = std::min<Elf_Xword>( file_length - data_offset, size );
+                }
+                return;
+            }
+            // DECOMPILER END
             stream.seekg( data_offset );
-            delete [] data;
+            // DECOMPILER BEGIN
+            release_data();
+            // DECOMPILER END
             try {
                 data = new char[size];
             } catch (const std::bad_alloc&) {
@@ -240,6 +270,24 @@ class section_impl : public section
         }
     }
 
+// DECOMPILER BEGIN
+//------------------------------------------------------------------------------
+    // Use data owned by somebody else (e.g. the loaded input file). They are
+    // not copied, so they must outlive the section.
+    void
+    set_data_reference( const char* raw_data, Elf_Xword size )
+    {
+        if ( get_type() != SHT_NOBITS ) {
+            release_data();
+            data       = const_cast<char*>( raw_data );
+            data_size  = raw_data ? size : 0;
+            data_owned = false;
+        }
+
+        set_size( size );
+    }
+// DECOMPILER END
+
 //------------------------------------------------------------------------------
   protected:
 //------------------------------------------------------------------------------
@@ -257,8 +305,9 @@ class section_impl : public section
     load( std::istream&  stream,
           std::streampos header_offset )
     {
-        data = 0;
-        data_size = 0;
+        // DECOMPILER BEGIN
+        release_data();
+        // DECOMPILER END
         if ( header_offset >= file_length ) {
             return;
         }
@@ -276,6 +325,14 @@ class section_impl : public section
 
         Elf_Xword size = get_size();
         size = std::min<Elf_Xword>( file_length - section_offset, size );
+        // DECOMPILER BEGIN
+        if ( 0 != file_data && SHT_NULL != get_type() && SHT_NOBITS != get_type() && 0 != size ) {
+            data       = const_cast<char*>( file_data + section_offset );
+            data_size  = size;
+            data_owned = false;
+            return;
+        }
+        // DECOMPILER END
         if ( 0 == data && SHT_NULL != get_type() && SHT_NOBITS != get_type() && 0 != size ) {
             try {
                 data = new char[size];
@@ -329,6 +386,20 @@ class section_impl : public section
         f.write( get_data(), get_size() );
     }
 
+// DECOMPILER BEGIN
+//------------------------------------------------------------------------------
+    void
+    release_data()
+    {
+        if ( data_owned ) {
+            delete [] data;
+        }
+        data       = 0;
+        data_size  = 0;
+        data_owned = true;
+    }
+// DECOMPILER END
+
 //------------------------------------------------------------------------------
   private:
     T                          header;
@@ -339,6 +410,10 @@ class section_impl : public section
     const endianess_convertor* convertor;
     bool                       is_address_set;
     size_t                     file_length;
+    // DECOMPILER BEGIN
+    const char*                file_data;
+    bool                       data_owned;
+    // DECOMPILER END
 };
 
 } // namespace ELFIO
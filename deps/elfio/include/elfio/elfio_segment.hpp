@@ -71,8 +71,13 @@ class segment_impl : public segment
 {
   public:
 //------------------------------------------------------------------------------
-    segment_impl( endianess_convertor* convertor_, size_t file_length_ ) :
-        convertor( convertor_ ), file_length( file_length_ )
+    // DECOMPILER BEGIN
+    // If file_data_ is given, segment data are references into it instead of
+    // copies read from the stream. The buffer must outlive the segment.
+    segment_impl( endianess_convertor* convertor_, size_t file_length_,
+                  const char* file_data_ = 0 ) :
+        convertor( convertor_ ), file_length( file_length_ ),
+        file_data( file_data_ )
     {
         is_offset_set = false;
         std::fill_n( reinterpret_cast<char*>( &ph ), sizeof( ph ), '\0' );
@@ -83,8 +88,9 @@ class segment_impl : public segment
 //------------------------------------------------------------------------------
     virtual ~segment_impl()
     {
-        delete [] data;
+        release_data();
     }
+    // DECOMPILER END
 
 //------------------------------------------------------------------------------
     // Section info functions
@@ -187,8 +193,9 @@ class segment_impl : public segment
     load( std::istream&  stream,
           std::streampos header_offset )
     {
-        data = 0;
-        data_size = 0;
+        // DECOMPILER BEGIN
+        release_data();
+        // DECOMPILER END
         if ( header_offset >= file_length ) {
             return;
         }
@@ -203,6 +210,13 @@ class segment_impl : public segment
             stream.seekg( segmentOffset );
             Elf_Xword size = std::min<Elf_Xword>( file_length - segmentOffset,
                 get_file_size() );
+            // DECOMPILER BEGIN
+            if ( 0 != file_data ) {
+                data      = const_cast<char*>( file_data + segmentOffset );
+                data_size = size;
+                return;
+            }
+            // DECOMPILER END
             try {
                 data = new char[size];
             } catch (const std::bad_alloc&) {
@@ -236,9 +250,20 @@ class segment_impl : public segment
           size_t        size )
     {
         if ( PT_NULL != get_type() && 0 != size ) {
+            // DECOMPILER BEGIN
+            if ( 0 != file_data ) {
+                release_data();
+                is_offset_set = true;
+                if ( data_offset < file_length ) {
+                    data      = const_cast<char*>( file_data + data_offset );
+                    data_size = std::min<Elf_Xword>( file_length - data_offset, size );
+                }
+                return;
+            }
+            // DECOMPILER END
             stream.seekg( data_offset );
             is_offset_set = true;
-            delete [] data;
+            release_data();
             try {
                 data = new char[size];
             } catch (const std::bad_alloc&) {
@@ -252,6 +277,20 @@ class segment_impl : public segment
         }
     }
 
+// DECOMPILER BEGIN
+//------------------------------------------------------------------------------
+  private:
+    void
+    release_data()
+    {
+        if ( 0 == file_data ) {
+            delete [] data;
+        }
+        data      = 0;
+        data_size = 0;
+    }
+// DECOMPILER END
+
 //------------------------------------------------------------------------------
   private:
     T                     ph;
@@ -262,6 +301,9 @@ class segment_impl : public segment
     endianess_convertor*  convertor;
     bool                  is_offset_set;
     size_t                file_length;
+    // DECOMPILER BEGIN
+    const char*           file_data;
+    // DECOMPILER END
 };
 
 } // namespace ELFIO
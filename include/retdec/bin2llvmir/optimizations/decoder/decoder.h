@@ -82,6 +82,7 @@ class Decoder : public llvm::ModulePass
 		void initJumpTargetsSymbols();
 		void initConfigFunctions();
 		void initStaticCode();
+		bool canSkipStaticCodeLifting(const stacofin::DetectedFunction* sf);
 		void initVtables();
 
 	private:
@@ -305,6 +306,12 @@ class Decoder : public llvm::ModulePass
 		RangesToDecode _ranges;
 		JumpTargets _jumpTargets;
 
+		/// Demand-driven selective decompilation: only code in selected
+		/// ranges is decoded, functions outside them are only declared.
+		bool _demandDriven = false;
+		/// Selected ranges, they do not shrink as the code is decoded.
+		common::AddressRangeContainer _selectedRanges;
+
 		/// Name of all extern functions gathered from object files
 		std::set<std::string> _externs;
 		std::set<common::Address> _imports;
@@ -7,12 +7,27 @@
 #ifndef RETDEC_BIN2LLVMIR_OPTIMIZATIONS_INST_OPT_INST_OPT_H
 #define RETDEC_BIN2LLVMIR_OPTIMIZATIONS_INST_OPT_INST_OPT_H
 
+#include <vector>
+
 #include <llvm/IR/Instruction.h>
 
 namespace retdec {
 namespace bin2llvmir {
 namespace inst_opt {
 
+/**
+ * Optimization of a single instruction.
+ */
+struct Rule
+{
+	/// Rule name used in statistics.
+	const char* name;
+	/// Returns @c true if the instruction was changed (it may be erased).
+	bool (*apply)(llvm::Instruction*);
+};
+
+const std::vector<const Rule*>& getRules(unsigned opcode);
+const Rule* optimizeWithRule(llvm::Instruction* insn);
 bool optimize(llvm::Instruction* insn);
 
 } // namespace inst_opt
@@ -7,14 +7,33 @@
 #ifndef RETDEC_BIN2LLVMIR_OPTIMIZATIONS_INST_OPT_INST_OPT_PASS_H
 #define RETDEC_BIN2LLVMIR_OPTIMIZATIONS_INST_OPT_INST_OPT_PASS_H
 
+#include <map>
+#include <string>
+
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/Module.h>
+#include <llvm/IR/ValueMap.h>
 #include <llvm/Pass.h>
 
 namespace retdec {
 namespace bin2llvmir {
 
+/**
+ * Optimizes instructions using rules from @c inst_opt.
+ *
+ * The pass runs several times in the pipeline and most of the instructions
+ * do not change between the runs. Therefore, fingerprints of all instructions
+ * are remembered (per module) at the end of each run and the next run starts
+ * only from instructions that changed since then (or whose operands changed).
+ * Instructions affected by an applied rule are revisited until no rule
+ * applies.
+ *
+ * Fingerprints of erased instructions are dropped together with them, so
+ * a new instruction allocated at the same address is never mistaken for
+ * an already optimized one. All the fingerprints are dropped by @c clear(),
+ * which is called at the start of every decompilation.
+ */
 class InstructionOptimizer : public llvm::ModulePass
 {
 	public:
@@ -23,11 +42,37 @@ class InstructionOptimizer : public llvm::ModulePass
 		virtual bool runOnModule(llvm::Module& m) override;
 		bool runOnModuleCustom(llvm::Module& m);
 
+		const std::map<std::string, std::size_t>& getRuleHits() const;
+		std::size_t getNumberOfVisitedInstructions() const;
+
+		static void clear();
+
+	private:
+		/// Fingerprints stay with the original instructions on RAUW. Keys are
+		/// values, because rules replace instructions by arbitrary values.
+		struct FingerprintsConfig :
+				llvm::ValueMapConfig<const llvm::Value*>
+		{
+			enum { FollowRAUW = false };
+		};
+		using Fingerprints = llvm::ValueMap<
+				const llvm::Value*,
+				std::size_t,
+				FingerprintsConfig>;
+
 	private:
 		bool run();
+		void reportRuleHits() const;
 
 	private:
 		llvm::Module* _module = nullptr;
+		/// Number of applications of each rule in the last run.
+		std::map<std::string, std::size_t> _ruleHits;
+		/// Number of instructions taken from the worklist in the last run.
+		std::size_t _visited = 0;
+
+		/// Instruction fingerprints from the end of the last run on a module.
+		static std::map<const llvm::Module*, Fingerprints> _fingerprints;
 };
 
 } // namespace bin2llvmir
@@ -0,0 +1,55 @@
+/**
+ * @file include/retdec/bin2llvmir/optimizations/provider_init/crypto_patterns.h
+ * @brief Detection of crypto patterns in the loaded file image.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_BIN2LLVMIR_OPTIMIZATIONS_PROVIDER_INIT_CRYPTO_PATTERNS_H
+#define RETDEC_BIN2LLVMIR_OPTIMIZATIONS_PROVIDER_INIT_CRYPTO_PATTERNS_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include "retdec/bin2llvmir/providers/config.h"
+#include "retdec/bin2llvmir/providers/fileimage.h"
+#include "retdec/yaracpp/yara_detector.h"
+
+namespace retdec {
+namespace bin2llvmir {
+
+/**
+ * Scans the in-memory file image for crypto patterns (YARA rules from
+ * @c cryptoPatternPaths) and stores them into the config.
+ *
+ * Rule sets are compiled only once per process and shared by all the
+ * subsequent scans that use the same rule files. Only the initialized parts
+ * of the image segments are scanned, the input file is not re-read.
+ */
+class CryptoPatterns
+{
+	public:
+		static std::size_t detect(
+				FileImage* image,
+				Config* config,
+				bool parallel = true);
+		static void clear();
+
+	private:
+		static const yaracpp::YaraDetector* getRules(
+				const std::set<std::string>& paths);
+
+	private:
+		/// Compiled rule sets indexed by the set of their rule files.
+		static std::map<
+				std::set<std::string>,
+				std::unique_ptr<yaracpp::YaraDetector>> _rules;
+		static std::mutex _rulesMutex;
+};
+
+} // namespace bin2llvmir
+} // namespace retdec
+
+#endif
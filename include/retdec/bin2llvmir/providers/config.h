@@ -170,6 +170,11 @@ class Config
 		//
 		llvm::GlobalVariable* getGlobalDummy();
 		fs::path getOutputDirectory();
+
+		// Patterns
+		//
+		void addPattern(retdec::common::Pattern p);
+		void indexPatterns();
 		bool getCryptoPattern(
 				retdec::common::Address addr,
 				std::string& name,
@@ -196,6 +201,9 @@ class Config
 
 		std::map<IntrinsicFunctionCreatorPtr, llvm::Function*> _intrinsicFunctions;
 		std::set<llvm::Function*> _pseudoAsmFunctions;
+
+		/// Index of matches of all patterns in the config.
+		retdec::common::PatternIndex _patternIndex;
 };
 
 class ConfigProvider
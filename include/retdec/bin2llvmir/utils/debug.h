@@ -16,16 +16,19 @@
 #include <llvm/Support/raw_ostream.h>
 
 #include "retdec/utils/filesystem.h"
+#include "retdec/utils/io/log.h"
 
 namespace retdec {
 namespace bin2llvmir {
 
 /**
- * Set \c debug_enabled to \c true to enable this LOG macro.
+ * Set \c debug_enabled to \c true to enable this LOG macro. The messages go
+ * into the debug logger, so they are neither formatted nor written unless
+ * the logger is verbose.
  */
 #define LOG \
 	if (!debug_enabled) {} \
-	else std::cout << std::showbase
+	else RETDEC_LOG_DEBUG << std::showbase
 
 /**
  * Print any LLVM object which implements @c print(llvm::raw_string_ostream&)
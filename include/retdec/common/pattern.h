@@ -7,8 +7,10 @@
 #ifndef RETDEC_COMMON_PATTERN_H
 #define RETDEC_COMMON_PATTERN_H
 
-#include <string>
+#include <map>
 #include <optional>
+#include <string>
+#include <vector>
 
 #include "retdec/common/address.h"
 
@@ -210,6 +212,47 @@ class Pattern
 
 using PatternContainer = std::vector<Pattern>;
 
+/**
+ * Index of pattern matches by their start addresses.
+ *
+ * Entries refer to patterns and matches by their positions in the indexed
+ * pattern container. The index must be updated by insert() whenever a new
+ * pattern is appended to the container, and rebuilt by build() if the
+ * container is modified in any other way.
+ */
+class PatternIndex
+{
+	public:
+		/// Match of pattern @c pattern at position @c match in its matches,
+		/// covering addresses <start, end).
+		struct Entry
+		{
+			retdec::common::Address start;
+			retdec::common::Address end;
+			std::size_t pattern = 0;
+			std::size_t match = 0;
+		};
+
+	public:
+		PatternIndex() = default;
+		PatternIndex(const PatternContainer& patterns);
+
+		void build(const PatternContainer& patterns);
+		void insert(const Pattern& pattern, std::size_t patternIndex);
+		void clear();
+
+		/// @name Pattern index query methods.
+		/// @{
+		bool empty() const;
+		std::size_t size() const;
+		std::vector<Entry> findAt(const retdec::common::Address& addr) const;
+		/// @}
+
+	private:
+		/// Entries ordered by their start addresses.
+		std::multimap<std::uint64_t, Entry> _entries;
+};
+
 } // namespace common
 } // namespace retdec
 
@@ -34,15 +34,29 @@ class Config
 		static Config empty();
 		static Config fromFile(const std::string& path);
 		static Config fromJsonString(const std::string& json);
+		static Config fromBinaryString(const std::string& binary);
 		/// @}
 
+		static bool isBinary(const std::string& content);
+
 		std::string generateJsonString() const;
 		std::string generateJsonFile() const;
 		std::string generateJsonFile(const std::string& outputFilePath) const;
 
+		std::string generateBinaryString() const;
+		std::string generateBinaryFile(const std::string& outputFilePath) const;
+
+		std::string generateFile(const std::string& outputFilePath) const;
+
 		void readJsonString(const std::string& json);
 		void readJsonFile(const std::string& input);
 
+		void readBinaryString(const std::string& binary);
+		void readBinary(const char* data, std::size_t size);
+
+		void readString(const std::string& content);
+		void readFile(const std::string& input);
+
 	public:
 		Parameters parameters;
 		common::Architecture architecture;
@@ -30,8 +30,12 @@ class Parameters
 		bool isVerboseOutput() const;
 		bool isKeepAllFunctions() const;
 		bool isSelectedDecodeOnly() const;
+		bool isSelectedDemandDriven() const;
+		bool isDemandDriven() const;
 		bool isDetectStaticCode() const;
+		bool isSkipStaticCodeLifting() const;
 		bool isTimeout() const;
+		bool isFastExit() const;
 		bool isMaxMemoryLimitHalfRam() const;
 		bool isBackendNoOpts() const;
 		bool isBackendEmitCfg() const;
@@ -42,6 +46,7 @@ class Parameters
 		bool isBackendNoVarRenaming() const;
 		bool isBackendNoCompoundOperators() const;
 		bool isBackendNoSymbolicNames() const;
+		bool isConfigFormatBinary() const;
 		/// @}
 
 		/// @name Parameters set methods.
@@ -49,6 +54,7 @@ class Parameters
 		void setIsVerboseOutput(bool b);
 		void setIsKeepAllFunctions(bool b);
 		void setIsSelectedDecodeOnly(bool b);
+		void setIsSelectedDemandDriven(bool b);
 		void setOrdinalNumbersDirectory(const std::string& n);
 		void setInputFile(const std::string& file);
 		void setInputPdbFile(const std::string& file);
@@ -59,11 +65,16 @@ class Parameters
 		void setOutputConfigFile(const std::string& file);
 		void setOutputUnpackedFile(const std::string& file);
 		void setOutputFormat(const std::string& format);
+		void setConfigFormat(const std::string& format);
 		void setLogFile(const std::string& file);
 		void setErrFile(const std::string& file);
+		void setMetricsFile(const std::string& file);
+		void setTraceFile(const std::string& file);
 		void setMaxMemoryLimit(uint64_t limit);
 		void setIsMaxMemoryLimitHalfRam(bool f);
 		void setTimeout(uint64_t seconds);
+		void setMaxThreads(uint64_t threads);
+		void setIsFastExit(bool b);
 		void setEntryPoint(const retdec::common::Address& a);
 		void setMainAddress(const retdec::common::Address& a);
 		void setSectionVMA(const retdec::common::Address& a);
@@ -71,7 +82,9 @@ class Parameters
 		void setBackendEnabledOpts(const std::string& o);
 		void setBackendCallInfoObtainer(const std::string& val);
 		void setBackendVarRenamer(const std::string& val);
+		void setBackendGraphFormat(const std::string& val);
 		void setIsDetectStaticCode(bool b);
+		void setIsSkipStaticCodeLifting(bool b);
 		void setIsBackendNoOpts(bool b);
 		void setIsBackendEmitCfg(bool b);
 		void setIsBackendEmitCg(bool b);
@@ -95,10 +108,14 @@ class Parameters
 		const std::string& getOutputConfigFile() const;
 		const std::string& getOutputUnpackedFile() const;
 		const std::string& getOutputFormat() const;
+		const std::string& getConfigFormat() const;
 		const std::string& getLogFile() const;
 		const std::string& getErrFile() const;
+		const std::string& getMetricsFile() const;
+		const std::string& getTraceFile() const;
 		uint64_t getMaxMemoryLimit() const;
 		uint64_t getTimeout() const;
+		uint64_t getMaxThreads() const;
 		retdec::common::Address getEntryPoint() const;
 		retdec::common::Address getMainAddress() const;
 		retdec::common::Address getSectionVMA() const;
@@ -106,6 +123,7 @@ class Parameters
 		const std::string& getBackendEnabledOpts() const;
 		const std::string& getBackendCallInfoObtainer() const;
 		const std::string& getBackendVarRenamer() const;
+		const std::string& getBackendGraphFormat() const;
 		/// @}
 
 		void fixRelativePaths(const std::string& configPath);
@@ -150,6 +168,11 @@ class Parameters
 		/// results.
 		bool _selectedDecodeOnly = false;
 
+		/// Decode only parts selected through selective decompilation and
+		/// represent functions called from them by declarations.
+		/// Whole-program analyses are skipped.
+		bool _selectedDemandDriven = false;
+
 		std::string _ordinalNumbersDirectory;
 		std::string _inputFile;
 		std::string _inputPdbFile;
@@ -160,17 +183,36 @@ class Parameters
 		std::string _outputConfigFile;
 		std::string _outputUnpackedFile;
 		std::string _outputFormat;
+		/// Format of the generated config files: "json" or "binary".
+		std::string _configFormat = "json";
 		std::string _logFile;
 		std::string _errFile;
+		/// Aggregated times of decompilation phases are written here (JSON).
+		std::string _metricsFile;
+		/// Timeline of decompilation phases is written here
+		/// (Chrome trace event format).
+		std::string _traceFile;
 		uint64_t _maxMemoryLimit = 0;
 		bool _maxMemoryLimitHalfRam = true;
 		uint64_t _timeout = 0;
+		/// Maximal number of threads used by all components
+		/// (0 = number of hardware threads).
+		uint64_t _maxThreads = 0;
+		/// Exit right after all outputs are written, without destroying
+		/// the decompiled module and other global state. Used by the tools;
+		/// retdec::decompile() itself always tears down normally.
+		bool _fastExit = false;
 
 		bool _detectStaticCode = true;
+		/// Do not decode confirmed statically linked functions, create only
+		/// their declarations.
+		bool _skipStaticCodeLifting = false;
 		std::string _backendDisabledOpts;
 		std::string _backendEnabledOpts;
 		std::string _backendCallInfoObtainer = "optim";
 		std::string _backendVarRenamer = "readable";
+		/// Format of emitted CFGs and CGs (dot|jsonl).
+		std::string _backendGraphFormat = "dot";
 		bool _backendNoOpts = false;
 		bool _backendEmitCfg = false;
 		bool _backendEmitCg = false;
@@ -15,6 +15,11 @@
 #include "retdec/cpdetect/search.h"
 
 namespace retdec {
+
+namespace yaracpp {
+class YaraDetector;
+} // namespace yaracpp
+
 namespace cpdetect {
 
 /**
@@ -26,6 +31,8 @@ class CompilerDetector : private retdec::utils::NonCopyable
 		retdec::fileformat::FileFormat &fileParser;
 		DetectParams &cpParams;
 		std::vector<std::string> externalDatabase;
+		/// compiled signatures shared with other detectors (may be null)
+		const retdec::yaracpp::YaraDetector *signatures = nullptr;
 
 		/// @name External databases parsing
 		/// @{
@@ -72,6 +79,12 @@ class CompilerDetector : private retdec::utils::NonCopyable
 				DetectParams &params,
 				ToolInformation &toolInfo);
 
+		/// @name Signatures
+		/// @{
+		const std::vector<std::string>& getInternalRuleFiles() const;
+		void setSignatures(const retdec::yaracpp::YaraDetector *rules);
+		/// @}
+
 		/// @name Detection methods
 		/// @{
 		ReturnCode getAllInformation();
@@ -29,15 +29,56 @@ struct PeHeaderStyle
 class PeHeuristics : public Heuristics
 {
 	private:
+		/**
+		 * Area of file searched for patterns of several heuristics
+		 *
+		 * Patterns are declared up front and the area is searched for all
+		 * of them in one pass when the first of them is queried.
+		 */
+		struct ScanArea
+		{
+			std::size_t startOffset = 0; ///< start offset in file
+			std::size_t stopOffset = 0;  ///< stop offset in file
+			bool valid = false;          ///< @c true if area is in file
+
+			/// signatures searched in area
+			std::vector<std::string> signatures;
+			/// plain strings searched in area
+			std::vector<std::string> strings;
+
+			/// numbers of significant nibbles of found signatures
+			std::vector<unsigned long long> signatureResults;
+			/// offsets of found strings
+			std::vector<std::size_t> stringResults;
+			/// @c true if area was already searched for signatures
+			bool signaturesScanned = false;
+			/// @c true if area was already searched for strings
+			bool stringsScanned = false;
+		};
+
 		retdec::fileformat::PeFormat &peParser; ///< parser of input PE file
 
 		std::size_t declaredLength; ///< declared length of file
 		std::size_t loadedLength;   ///< actual loaded length of file
 
+		ScanArea firstSectionArea; ///< patterns in the first section
+		ScanArea rdataArea;        ///< patterns in section .rdata
+		ScanArea headerArea;       ///< patterns at start of file
+
 		/// @name Auxiliary methods
 		/// @{
 		std::string getEnigmaVersion();
 		std::string getUpxAdditionalInfo(std::size_t metadataPos);
+		void initScanArea(
+				ScanArea &area,
+				const retdec::fileformat::Section *section);
+		unsigned long long findSignatureInArea(
+				ScanArea &area,
+				const std::string &signPattern);
+		std::size_t findStringInArea(
+				ScanArea &area,
+				const std::string &str);
+		bool hasStringInArea(ScanArea &area, const std::string &str);
 		/// @}
 
 		/// @name Heuristics for detection of original language
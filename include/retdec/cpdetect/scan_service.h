@@ -0,0 +1,136 @@
+/**
+ * @file include/retdec/cpdetect/scan_service.h
+ * @brief Service detecting tools in many inputs with resident rules.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_CPDETECT_SCAN_SERVICE_H
+#define RETDEC_CPDETECT_SCAN_SERVICE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "retdec/fileformat/fftypes.h"
+#include "retdec/utils/non_copyable.h"
+#include "retdec/cpdetect/cptypes.h"
+#include "retdec/cpdetect/errors.h"
+#include "retdec/yaracpp/yara_rule.h"
+
+namespace retdec {
+
+namespace yaracpp {
+class YaraDetector;
+} // namespace yaracpp
+
+namespace cpdetect {
+
+/**
+ * ScanService - detect tools (compilers, packers...) and match YARA rules
+ * in memory buffers
+ *
+ * Unlike running fileinfo for every input, the service compiles signatures
+ * of tools and the given YARA rule sets only once and keeps them resident.
+ * Signatures are compiled lazily for every distinct combination of file
+ * format and architecture. Inputs are scanned concurrently; a single instance
+ * can be used from multiple threads at once. Scans over the limit of YARA
+ * (YaraDetector::getMaxConcurrentScans()) wait until other scans finish.
+ *
+ * Usage:
+ * @code
+ * ScanService::Settings settings;
+ * settings.yaraRuleSets["malware"] = {"malware.yar"};
+ * ScanService service(settings);
+ * auto results = service.scan(buffers);
+ * @endcode
+ */
+class ScanService : private retdec::utils::NonCopyable
+{
+	public:
+		/**
+		 * Settings of the service
+		 */
+		struct Settings
+		{
+			/// type of signature search
+			SearchType searchType = SearchType::EXACT_MATCH;
+			/// number of entry point bytes to report
+			std::size_t epBytesCount = EP_BYTES_SIZE;
+			/// external signature databases (added to internal ones)
+			std::vector<std::string> externalDatabases;
+			/// YARA rule files by name of the rule set (e.g. "malware")
+			std::map<std::string, std::set<std::string>> yaraRuleSets;
+		};
+
+		/**
+		 * Result of scanning of one input
+		 */
+		struct Result
+		{
+			/// status of tool detection
+			ReturnCode status = ReturnCode::OK;
+			/// detected file format
+			retdec::fileformat::Format format =
+					retdec::fileformat::Format::UNDETECTABLE;
+			/// detected tools and languages
+			ToolInformation toolInfo;
+			/// matched rules by name of the rule set
+			std::map<std::string, std::vector<retdec::yaracpp::YaraRule>> yaraMatches;
+			/// @c true if matching of some YARA rule set failed
+			bool yaraFailed = false;
+		};
+
+	private:
+		using RulesPtr = std::unique_ptr<retdec::yaracpp::YaraDetector>;
+		class ScanSlot;
+
+		Settings settings;
+		/// rule sets given in settings (compiled in constructor)
+		std::map<std::string, RulesPtr> yaraRuleSets;
+		/// compiled signatures by their rule files
+		std::map<std::vector<std::string>, RulesPtr> signatures;
+		/// guards @a signatures
+		mutable std::mutex signaturesMutex;
+		/// number of scans that may start before some running scan finishes
+		std::size_t freeScanSlots = 0;
+		/// guards @a freeScanSlots
+		std::mutex scanSlotsMutex;
+		/// signalled when a scan finishes
+		std::condition_variable scanSlotsCond;
+		/// internal state of instance
+		bool stateIsValid = true;
+
+		/// @name Auxiliary methods
+		/// @{
+		const retdec::yaracpp::YaraDetector* getSignatures(
+				const std::vector<std::string> &internalRuleFiles);
+		/// @}
+
+	public:
+		explicit ScanService(const Settings &serviceSettings);
+		~ScanService();
+
+		/// @name Other methods
+		/// @{
+		bool isInValidState() const;
+		const Settings& getSettings() const;
+		std::size_t getNumberOfCompiledSignatures() const;
+		/// @}
+
+		/// @name Scanning methods
+		/// @{
+		Result scan(const std::uint8_t *data, std::size_t size);
+		std::vector<Result> scan(
+				const std::vector<std::vector<std::uint8_t>> &inputs);
+		/// @}
+};
+
+} // namespace cpdetect
+} // namespace retdec
+
+#endif
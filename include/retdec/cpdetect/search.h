@@ -96,6 +96,10 @@ class Search
 				const std::string &signPattern,
 				std::size_t startOffset,
 				std::size_t stopOffset) const;
+		std::vector<unsigned long long> findUnslashedSignatures(
+				const std::vector<std::string> &signPatterns,
+				std::size_t startOffset,
+				std::size_t stopOffset) const;
 		unsigned long long exactComparison(
 				const std::string &signPattern,
 				std::size_t fileOffset,
@@ -129,6 +133,14 @@ class Search
 		bool hasStringInSection(
 				const std::string &str,
 				const std::string &sectionName) const;
+		std::size_t findString(
+				const std::string &str,
+				std::size_t startOffset,
+				std::size_t stopOffset) const;
+		std::vector<std::size_t> findStrings(
+				const std::vector<std::string> &strs,
+				std::size_t startOffset,
+				std::size_t stopOffset) const;
 		/// @}
 
 		/// @name Signature methods
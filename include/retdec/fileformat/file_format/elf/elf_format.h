@@ -64,6 +64,7 @@ class ElfFormat : public FileFormat
 
 		/// @name Auxiliary methods
 		/// @{
+		void setSectionData(ELFIO::section *sec, const char *data, std::size_t size);
 		ELFIO::section* addStringTable(ELFIO::section *dynamicSection, const DynamicTable &table);
 		ELFIO::section* addSymbolTable(ELFIO::section *dynamicSection, const DynamicTable &table, ELFIO::section *stringTable);
 		ELFIO::section* addRelocationTable(ELFIO::section *dynamicSection, const RelocationTableInfo &info, ELFIO::section *symbolTable);
@@ -73,7 +74,7 @@ class ElfFormat : public FileFormat
 		ELFIO::section* addGlobalOffsetTable(ELFIO::section *dynamicSection, const DynamicTable &table);
 		ELFIO::Elf_Half fixSymbolLink(ELFIO::Elf_Half symbolLink, ELFIO::Elf64_Addr symbolValue);
 		bool getRelocationMask(unsigned relType, std::vector<std::uint8_t> &mask);
-		void loadRelocations(const ELFIO::elfio *file, const ELFIO::section *symbolTable, std::unordered_multimap<std::string, unsigned long long> &nameAddressMap);
+		void loadRelocations(const ELFIO::elfio *file, const ELFIO::section *symbolTable, std::unordered_map<std::string, std::vector<unsigned long long>> &nameAddressMap);
 		void loadSymbols(const ELFIO::elfio *file, const ELFIO::symbol_section_accessor *elfSymbolTable, const ELFIO::section *elfSection);
 		void loadSymbols(const SymbolTable &oldTab, const DynamicTable &dynTab, ELFIO::section &got);
 		void loadDynamicTable(DynamicTable &table, const ELFIO::dynamic_section_accessor *elfDynamicTable);
@@ -87,11 +88,12 @@ class ElfFormat : public FileFormat
 		void loadInfoFromDynamicTables(DynamicTable &dynTab, ELFIO::section *sec);
 		void loadInfoFromDynamicSegment();
 		void loadNoteSecSeg(ElfNoteSecSeg &noteSecSegs) const;
+		void loadNoteSecSegs(std::vector<ElfNoteSecSeg> &candidates);
 		void loadNotes();
-		void loadCoreFileMap(std::size_t offset, std::size_t size);
-		void loadCorePrStat(std::size_t offset, std::size_t size);
-		void loadCorePrPsInfo(std::size_t offset, std::size_t size);
-		void loadCoreAuxvInfo(std::size_t offset, std::size_t size);
+		void loadCoreFileMap(std::size_t offset, std::size_t size, ElfCoreInfo &info) const;
+		void loadCorePrStat(std::size_t offset, std::size_t size, ElfCoreInfo &coreInfo) const;
+		void loadCorePrPsInfo(std::size_t offset, std::size_t size, ElfCoreInfo &info) const;
+		void loadCoreAuxvInfo(std::size_t offset, std::size_t size, ElfCoreInfo &info) const;
 		void loadCoreInfo();
 		void loadTelfhash();
 		/// @}
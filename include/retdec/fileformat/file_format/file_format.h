@@ -10,6 +10,7 @@
 #include <fstream>
 #include <initializer_list>
 #include <map>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <utility>
@@ -46,11 +47,15 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 		std::istream auxIStream;                 ///< auxiliary input stream
 		std::vector<unsigned char> *loadedBytes; ///< reference to serialized content of input file
 		LoadFlags loadFlags;                     ///< load flags for configurable file loading
+		bool lazyFileHashes = false;             ///< @c true if file hashes are computed on the first request
+		mutable std::once_flag fileHashesFlag;   ///< guards computation of lazy file hashes
 
 		/// @name Initialization methods
 		/// @{
 		void init();
 		void initStream();
+		void computeFileHashes() const;
+		void loadLazyFileHashes() const;
 		/// @}
 
 		/// @name Pure virtual initialization methods
@@ -58,9 +63,9 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 		virtual std::size_t initSectionTableHashOffsets() = 0;
 		/// @}
 	protected:
-		std::string crc32;                                                ///< CRC32 of file content
-		std::string md5;                                                  ///< MD5 of file content
-		std::string sha256;                                               ///< SHA256 of file content
+		mutable std::string crc32;                                        ///< CRC32 of file content
+		mutable std::string md5;                                          ///< MD5 of file content
+		mutable std::string sha256;                                       ///< SHA256 of file content
 		std::string sectionCrc32;                                         ///< CRC32 of section table
 		std::string sectionMd5;                                           ///< MD5 of section table
 		std::string sectionSha256;                                        ///< SHA256 of section table
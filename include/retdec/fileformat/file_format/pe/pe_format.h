@@ -82,6 +82,7 @@ class PeFormat : public FileFormat
 		/// @{
 		void loadDotnetHeaders();
 		void parseMetadataStream(std::uint64_t baseAddress, std::uint64_t offset, std::uint64_t size);
+		llvm::StringRef getStreamBytes(std::uint64_t address, std::uint64_t size) const;
 		void parseBlobStream(std::uint64_t baseAddress, std::uint64_t offset, std::uint64_t size);
 		void parseGuidStream(std::uint64_t baseAddress, std::uint64_t offset, std::uint64_t size);
 		void parseStringStream(std::uint64_t baseAddress, std::uint64_t offset, std::uint64_t size);
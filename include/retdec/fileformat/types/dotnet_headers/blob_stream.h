@@ -7,22 +7,61 @@
 #ifndef RETDEC_FILEFORMAT_TYPES_DOTNET_HEADERS_BLOB_STREAM_H
 #define RETDEC_FILEFORMAT_TYPES_DOTNET_HEADERS_BLOB_STREAM_H
 
+#include <algorithm>
 #include <cstdint>
-#include <unordered_map>
+#include <vector>
+
+#include <llvm/ADT/StringRef.h>
 
 #include "retdec/fileformat/types/dotnet_headers/stream.h"
 
 namespace retdec {
 namespace fileformat {
 
+/**
+ * Read-only view of blob data (e.g. signature) which is consumed from
+ * its front. Consuming data does not modify nor copy the blob.
+ */
+class BlobCursor
+{
+	private:
+		const std::uint8_t* data = nullptr;
+		std::size_t length = 0;
+	public:
+		BlobCursor() = default;
+		BlobCursor(const std::uint8_t* blobData, std::size_t blobLength) : data(blobData), length(blobLength) {}
+
+		bool empty() const { return length == 0; }
+		std::size_t size() const { return length; }
+		const std::uint8_t* begin() const { return data; }
+		const std::uint8_t* end() const { return data + length; }
+		std::uint8_t operator[](std::size_t index) const { return data[index]; }
+
+		/**
+		 * Consume @a count bytes from the front of the view.
+		 */
+		void advance(std::size_t count)
+		{
+			count = std::min(count, length);
+			data += count;
+			length -= count;
+		}
+};
+
+/**
+ * \#Blob heap. The heap is not copied, elements are decoded on demand
+ * directly from the bytes of the file the heap is stored in, so the file
+ * must outlive the stream.
+ */
 class BlobStream : public Stream
 {
 	private:
-		std::vector<std::uint8_t> data;
+		llvm::StringRef data;
 	public:
-		BlobStream(std::vector<std::uint8_t> data, std::uint64_t streamOffset, std::uint64_t streamSize);
+		BlobStream(llvm::StringRef data, std::uint64_t streamOffset, std::uint64_t streamSize);
 
 		std::vector<std::uint8_t> getElement(std::size_t offset) const;
+		BlobCursor getElementCursor(std::size_t offset) const;
 };
 
 } // namespace fileformat
@@ -7,28 +7,29 @@
 #ifndef RETDEC_FILEFORMAT_TYPES_DOTNET_HEADERS_STRING_STREAM_H
 #define RETDEC_FILEFORMAT_TYPES_DOTNET_HEADERS_STRING_STREAM_H
 
-#include <map>
+#include <llvm/ADT/StringRef.h>
 
 #include "retdec/fileformat/types/dotnet_headers/stream.h"
 
 namespace retdec {
 namespace fileformat {
 
+/**
+ * \#Strings heap. The heap is not copied, strings are decoded on demand
+ * directly from the bytes of the file the heap is stored in, so the file
+ * must outlive the stream.
+ */
 class StringStream : public Stream
 {
 	private:
-		std::map<std::size_t, std::string> strings;
+		llvm::StringRef data;
 	public:
-		StringStream(std::uint64_t streamOffset, std::uint64_t streamSize);
+		StringStream(llvm::StringRef data, std::uint64_t streamOffset, std::uint64_t streamSize);
 
 		/// @name Getters
 		/// @{
 		bool getString(std::size_t offset, std::string& result) const;
-		/// @}
-
-		/// @name String methods
-		/// @{
-		void addString(std::size_t offset, const std::string& string);
+		bool getStringRef(std::size_t offset, llvm::StringRef& result) const;
 		/// @}
 };
 
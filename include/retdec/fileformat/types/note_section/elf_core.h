@@ -53,8 +53,9 @@ class ElfCoreInfo
 {
 	private:
 		// NT_FILE
-		std::uint64_t pageSize;            ///< used page size
+		std::uint64_t pageSize = 0;        ///< used page size
 		std::vector<FileMapEntry> fileMap; ///< parsed file map
+		std::vector<std::size_t> fileMapByAddr; ///< file map indexes sorted by start address
 
 		// NT_PRSTATUS
 		std::vector<PrStatusInfo> prstatusInfos; ///< prstatus structures
@@ -82,10 +83,12 @@ class ElfCoreInfo
 		std::uint64_t getPageSize() const;
 		const std::vector<FileMapEntry>& getFileMap() const;
 		const std::vector<AuxVectorEntry>& getAuxVector() const;
+		const FileMapEntry* getFileMapEntry(std::uint64_t address) const;
 		/// @}
 
 		/// @name Helper methods
 		/// @{
+		void merge(const ElfCoreInfo& other);
 		void dump(std::ostream& outStream);
 		/// @}
 };
@@ -66,7 +66,7 @@ class ElfNoteSecSeg
 
 		/// @name Getters
 		/// @{
-		std::vector<ElfNoteEntry> getNotes() const;
+		const std::vector<ElfNoteEntry>& getNotes() const;
 		std::string getErrorMessage() const;
 		std::size_t getSecSegOffset() const;
 		std::size_t getSecSegLength() const;
@@ -7,6 +7,8 @@
 #ifndef RETDEC_FILEFORMAT_TYPES_SEC_SEG_SEC_SEG_H
 #define RETDEC_FILEFORMAT_TYPES_SEC_SEG_SEC_SEG_H
 
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -35,6 +37,24 @@ class SecSeg
 			INFO               ///< auxiliary information
 		};
 	private:
+		/**
+		 * Hashes and entropy computed on the first request
+		 * (see @c LoadFlags::LAZY_DIGESTS). Copies of section or segment
+		 * share them as they share the content.
+		 */
+		struct LazyDigests
+		{
+			std::once_flag hashesFlag;
+			std::once_flag entropyFlag;
+			bool hashesRequested = false;
+			bool entropyRequested = false;
+			std::string crc32;
+			std::string md5;
+			std::string sha256;
+			double entropy = 0.0;
+			bool isEntropyValid = false;
+		};
+
 		std::string crc32;                    ///< CRC32 of section or segment data
 		std::string md5;                      ///< MD5 of section or segment data
 		std::string sha256;                   ///< SHA256 of section or segment data
@@ -53,8 +73,11 @@ class SecSeg
 		bool isInMemory = false;              ///< @c true if the section or segment will appear in the memory image of a process
 		bool loaded = false;                  ///< @c true if content of section or segment was successfully loaded from input file
 		bool isEntropyValid = false;          ///< @c true if entropy has been computed
+		std::shared_ptr<LazyDigests> lazyDigests; ///< digests computed on request, if any
 
 		void computeHashes();
+		const LazyDigests* getLazyHashes() const;
+		const LazyDigests* getLazyEntropy() const;
 	public:
 		virtual ~SecSeg() = default;
 
@@ -7,13 +7,20 @@
 #ifndef RETDEC_FILEFORMAT_TYPES_SYMBOL_TABLE_SYMBOL_H
 #define RETDEC_FILEFORMAT_TYPES_SYMBOL_TABLE_SYMBOL_H
 
+#include <cstddef>
 #include <string>
 
 namespace retdec {
 namespace fileformat {
 
+class SymbolTable;
+
 /**
  * Class for one symbol
+ *
+ * Symbol can be stored in one @c SymbolTable at a time. Setters of the
+ * properties which the table indexes let the table know that the symbol
+ * has changed. Copies of symbols are not stored in any table.
  */
 class Symbol
 {
@@ -49,7 +56,18 @@ class Symbol
 		bool sizeIsValid = false;             ///< @c true if size of symbol is valid
 		bool linkIsValid = false;             ///< @c true if link to section is valid
 		bool thumbSymbol = false;             ///< @c true if symbol is THUMB symbol
+		SymbolTable *table = nullptr;         ///< table which stores symbol
+		std::size_t tableRow = 0;             ///< row of symbol in @c table
+
+		void notifyRenaming();
+		void notifyChange();
+
+		friend class SymbolTable;
 	public:
+		Symbol() = default;
+		Symbol(const Symbol &other);
+		Symbol& operator=(const Symbol &other);
+
 		/// @name Type queries
 		/// @{
 		bool isUndefined() const;
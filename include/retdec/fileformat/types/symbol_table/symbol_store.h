@@ -0,0 +1,115 @@
+/**
+ * @file include/retdec/fileformat/types/symbol_table/symbol_store.h
+ * @brief Struct-of-arrays store of symbols with name and address indexes.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_FILEFORMAT_TYPES_SYMBOL_TABLE_SYMBOL_STORE_H
+#define RETDEC_FILEFORMAT_TYPES_SYMBOL_TABLE_SYMBOL_STORE_H
+
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "retdec/fileformat/types/symbol_table/symbol.h"
+
+namespace retdec {
+namespace fileformat {
+
+/**
+ * Struct-of-arrays store of the symbol properties used for lookups.
+ *
+ * Every row describes one symbol (rows are in the order in which symbols
+ * were added). Names are interned without copying them -- each distinct name
+ * gets an id and the name index refers to the name string of the first symbol
+ * with that name, so the symbols must outlive the store. A row can be updated
+ * in place when its symbol changes; its name has to be detached before the
+ * symbol is renamed.
+ *
+ * All lookups return the first row (in the order of addition) with the
+ * requested property, i.e. the same symbol a linear search would find.
+ */
+class SymbolStore
+{
+	public:
+		/// Invalid row or name id.
+		static const std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+	public:
+		/// @name Getters
+		/// @{
+		std::size_t size() const;
+		bool empty() const;
+		std::size_t getNumberOfNames() const;
+		std::string_view getName(std::size_t row) const;
+		std::size_t getNameId(std::size_t row) const;
+		std::string_view getNameWithId(std::size_t nameId) const;
+		Symbol::UsageType getUsageType(std::size_t row) const;
+		unsigned long long getIndex(std::size_t row) const;
+		bool getAddress(std::size_t row, unsigned long long &address) const;
+		bool getRealAddress(std::size_t row, unsigned long long &address) const;
+		/// @}
+
+		/// @name Lookups
+		/// @{
+		std::size_t findName(std::string_view name) const;
+		std::size_t findByName(std::string_view name) const;
+		std::size_t findByAddress(unsigned long long address) const;
+		std::size_t findByIndex(unsigned long long index) const;
+		/// @}
+
+		/// @name Other methods
+		/// @{
+		void add(const Symbol &symbol);
+		void detachName(std::size_t row);
+		void update(std::size_t row);
+		void reserve(std::size_t n);
+		void clear();
+		/// @}
+
+	private:
+		/// Marks a missing row, or a row without name id.
+		static constexpr std::uint32_t noRow = std::numeric_limits<std::uint32_t>::max();
+
+		enum Flags : std::uint8_t
+		{
+			ADDRESS_VALID      = 1 << 0,
+			REAL_ADDRESS_VALID = 1 << 1,
+		};
+
+		/// @name Columns, one item per row
+		/// @{
+		std::vector<const Symbol*> symbols;
+		std::vector<std::uint32_t> nameIds;
+		std::vector<unsigned long long> addresses;
+		std::vector<unsigned long long> realAddresses;
+		std::vector<unsigned long long> indexes;
+		std::vector<Symbol::UsageType> usageTypes;
+		std::vector<std::uint8_t> flags;
+		/// @}
+
+		/// @name Interned names, one item per distinct name
+		/// @{
+		std::vector<std::uint32_t> firstRowWithName;
+		std::unordered_map<std::string_view, std::uint32_t> nameToId;
+		/// @}
+
+		/// @name Indexes of the first row with the given property
+		/// @{
+		std::unordered_map<unsigned long long, std::uint32_t> addressToRow;
+		std::unordered_map<unsigned long long, std::uint32_t> indexToRow;
+		/// @}
+
+		std::uint32_t internName(std::uint32_t row);
+		void setFirstRowWithName(std::uint32_t nameId, std::uint32_t row);
+		std::uint32_t findFirstRowWithName(std::uint32_t nameId) const;
+		std::uint32_t findFirstRowWithAddress(unsigned long long address) const;
+		std::uint32_t findFirstRowWithIndex(unsigned long long index) const;
+};
+
+} // namespace fileformat
+} // namespace retdec
+
+#endif
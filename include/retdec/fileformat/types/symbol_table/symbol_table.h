@@ -8,15 +8,26 @@
 #define RETDEC_FILEFORMAT_TYPES_SYMBOL_TABLE_SYMBOL_TABLE_H
 
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include "retdec/fileformat/types/symbol_table/symbol.h"
+#include "retdec/fileformat/types/symbol_table/symbol_store.h"
 
 namespace retdec {
 namespace fileformat {
 
 /**
  * Class for symbol table
+ *
+ * Lookups by name, address and index use indexes of the @c SymbolStore of
+ * the table, which is updated lazily. Symbols let their table know when they
+ * change (see @c Symbol), so only the changed rows are updated before the
+ * next lookup, no matter how the symbols were accessed.
+ *
+ * Const methods may be called concurrently, the lazy updates are guarded
+ * by a mutex. Modifications of the table or its symbols must not run
+ * concurrently with any other access to the table.
  */
 class SymbolTable
 {
@@ -25,7 +36,23 @@ class SymbolTable
 		using symbolsIterator = std::vector<std::shared_ptr<Symbol>>::iterator;
 		std::vector<std::shared_ptr<Symbol>> table; ///< stored symbols
 		std::string name;                           ///< name of symbol table
+		mutable SymbolStore store;                  ///< indexes of stored symbols
+		mutable std::vector<std::size_t> dirtyRows; ///< rows whose symbols have changed since indexing
+		mutable std::mutex storeMutex;              ///< guards lazy updates of @c store
+
+		const SymbolStore& syncStore() const;
+		void markRowDirty(std::size_t row);
+		void symbolWillBeRenamed(std::size_t row);
+		void symbolChanged(std::size_t row);
+		void unlinkSymbols();
+
+		friend class Symbol;
 	public:
+		SymbolTable() = default;
+		SymbolTable(const SymbolTable &other) = delete;
+		SymbolTable& operator=(const SymbolTable &other) = delete;
+		~SymbolTable();
+
 		/// @name Const getters
 		/// @{
 		std::size_t getNumberOfSymbols() const;
@@ -34,6 +61,7 @@ class SymbolTable
 		const Symbol* getSymbolOnAddress(unsigned long long addr) const;
 		const Symbol* getSymbolWithIndex(std::size_t symbolIndex) const;
 		const std::string& getName() const;
+		const SymbolStore& getStore() const;
 		/// @}
 
 		/// @name Getters
@@ -55,6 +83,7 @@ class SymbolTable
 		/// @name Other methods
 		/// @{
 		void clear();
+		void reserve(std::size_t n);
 		void addSymbol(const std::shared_ptr<Symbol> &symbol);
 		void addSymbol(std::shared_ptr<Symbol> &&symbol);
 		bool hasSymbols() const;
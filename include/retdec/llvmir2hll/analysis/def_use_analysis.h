@@ -8,10 +8,12 @@
 #define RETDEC_LLVMIR2HLL_ANALYSIS_DEF_USE_ANALYSIS_H
 
 #include <functional>
-#include <map>
-#include <set>
+#include <unordered_map>
 #include <vector>
 
+#include <llvm/ADT/BitVector.h>
+
+#include "retdec/llvmir2hll/graphs/cfg/bit_vector_dataflow.h"
 #include "retdec/llvmir2hll/graphs/cfg/cfg.h"
 #include "retdec/llvmir2hll/support/smart_ptr.h"
 #include "retdec/utils/non_copyable.h"
@@ -23,7 +25,6 @@ class CFGBuilder;
 class Function;
 class Module;
 class ValueAnalysis;
-class VarUsesVisitor;
 class Variable;
 
 /**
@@ -37,12 +38,6 @@ public:
 	/// (statement, variable) pair
 	using StmtVarPair = std::pair<ShPtr<Statement>, ShPtr<Variable>>;
 
-	/// Set of (statement, variable) pairs.
-	using StmtVarPairSet = std::set<StmtVarPair>;
-
-	/// Mapping of a CFG node into a set of (statement, variable) pairs.
-	using NodePairMap = std::map<ShPtr<CFG::Node>, StmtVarPairSet>;
-
 	/// A def-use chain (see [ItC]).
 	// Implementation note: we have to use std::vector instead of std::map to
 	// make the chain deterministic.
@@ -66,33 +61,24 @@ public:
 	/// <tt>DU(s, x)</tt> set in [ItC]).
 	DefUseChain du;
 
-	/// Mapping of a CFG node @c B into the following set:
-	/// @code
-	/// {(s, x) | s \notin B uses x and B defines x}
-	/// @endcode
-	/// (The @c KILL[B] set from Definition 27 in [ItC].)
-	NodePairMap kill;
-
-	/// Mapping of a CFG node @c B into the following set:
-	/// @code
-	/// {(s, x) | s \in B uses x and x is not defined prior to s in B}
-	/// @endcode
-	/// (The @c GEN[B] set from Definition 27 in [ItC].)
-	NodePairMap gen;
-
-	/// Mapping of a CFG node @c B into the following set:
-	/// @code
-	/// {(s, x) | s uses x and s is reachable from the beginning of B}
-	/// @endcode
-	/// (The @c IN[B] set from Definition 27 in [ItC].)
-	NodePairMap in;
-
-	/// Mapping of a CFG node @c B into the following set:
-	/// @code
-	/// {(s, x) | s \notin B uses x and s is reachable from the end of B}
-	/// @endcode
-	/// (The @c OUT[B] set from Definition 27 in [ItC].)
-	NodePairMap out;
+	/// All uses of variables in @c cfg, i.e. (s, x) pairs such that @c s reads
+	/// @c x and @c x should be included. The position of a pair is its index
+	/// in the sets of @c dataflow.
+	std::vector<StmtVarPair> uses;
+
+	/// Mapping of a variable @c x into the set of indexes of all uses of @c x.
+	std::unordered_map<ShPtr<Variable>, llvm::BitVector> usesOfVar;
+
+	/// Solution of the dataflow problem over @c uses. It contains the
+	/// following sets for every CFG node @c B (Definition 27 in [ItC]):
+	///  - @c KILL[B]: <tt>{(s, x) | s \notin B uses x and B defines x}</tt>
+	///  - @c GEN[B]: <tt>{(s, x) | s \in B uses x and x is not defined prior to
+	///    s in B}</tt>
+	///  - @c IN[B]: <tt>{(s, x) | s uses x and s is reachable from the
+	///    beginning of B}</tt>
+	///  - @c OUT[B]: <tt>{(s, x) | s \notin B uses x and s is reachable from
+	///    the end of B}</tt>
+	ShPtr<BitVectorDataflow> dataflow;
 };
 
 /**
@@ -106,6 +92,9 @@ public:
 * For some basic information about def-use chains, see
 * http://en.wikipedia.org/wiki/Use-define_chain.
 *
+* Uses of variables are numbered densely and the @c IN and @c OUT sets are
+* computed by BitVectorDataflow.
+*
 * Use create() to create instances. Instances of this class have
 * reference object semantics.
 */
@@ -119,18 +108,16 @@ public:
 	);
 
 	static ShPtr<DefUseAnalysis> create(ShPtr<Module> module,
-		ShPtr<ValueAnalysis> va, ShPtr<VarUsesVisitor> vuv = nullptr);
+		ShPtr<ValueAnalysis> va);
 
 private:
-	DefUseAnalysis(ShPtr<Module> module,
-		ShPtr<ValueAnalysis> va, ShPtr<VarUsesVisitor> vuv = nullptr);
+	DefUseAnalysis(ShPtr<Module> module, ShPtr<ValueAnalysis> va);
 
+	void computeUses(ShPtr<DefUseChains> ducs);
 	void computeGenAndKill(ShPtr<DefUseChains> ducs);
 	void computeGenAndKillForNode(ShPtr<DefUseChains> ducs,
-		ShPtr<CFG::Node> node);
+		ShPtr<CFG::Node> node, std::size_t &useIndex);
 	void computeInAndOut(ShPtr<DefUseChains> ducs);
-	bool computeInAndOutForNode(ShPtr<DefUseChains> ducs,
-		ShPtr<CFG::Node> node);
 	void computeDefUseChains(ShPtr<DefUseChains> ducs);
 	void computeDefUseChainForNode(ShPtr<DefUseChains> ducs,
 		ShPtr<CFG::Node> node);
@@ -146,9 +133,6 @@ private:
 	/// Analysis of used values.
 	ShPtr<ValueAnalysis> va;
 
-	/// Visitor for obtaining uses of variables.
-	ShPtr<VarUsesVisitor> vuv;
-
 	/// The used builder of CFGs.
 	ShPtr<CFGBuilder> cfgBuilder;
 };
@@ -0,0 +1,159 @@
+/**
+* @file include/retdec/llvmir2hll/graphs/cfg/bit_vector_dataflow.h
+* @brief A generic iterative solver of bit-vector dataflow problems over CFGs.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_LLVMIR2HLL_GRAPHS_CFG_BIT_VECTOR_DATAFLOW_H
+#define RETDEC_LLVMIR2HLL_GRAPHS_CFG_BIT_VECTOR_DATAFLOW_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include <llvm/ADT/BitVector.h>
+
+#include "retdec/llvmir2hll/graphs/cfg/cfg.h"
+#include "retdec/llvmir2hll/support/smart_ptr.h"
+#include "retdec/utils/non_copyable.h"
+
+namespace retdec {
+namespace llvmir2hll {
+
+/**
+* @brief A generic iterative solver of bit-vector dataflow problems over CFGs.
+*
+* Facts of the problem (e.g. variables or (statement, variable) pairs) are
+* numbered densely from zero by the client. For every node @c B, the client
+* sets up the @c GEN[B] and @c KILL[B] sets, and the solver computes the
+* least fixed point of the following equations:
+*
+*  - forward problems:
+*    @code
+*    IN[B]  = MEET_{P \in pred(B)} OUT[P]
+*    OUT[B] = GEN[B] \cup (IN[B] - KILL[B])
+*    @endcode
+*  - backward problems:
+*    @code
+*    OUT[B] = MEET_{S \in succ(B)} IN[S]
+*    IN[B]  = GEN[B] \cup (OUT[B] - KILL[B])
+*    @endcode
+*
+* where @c MEET is either a union or an intersection. Nodes without
+* predecessors (forward problems) or successors (backward problems), like the
+* entry and exit nodes, get the boundary value set by setBoundary() instead of
+* the meet.
+*
+* The nodes are processed by a worklist ordered by the reverse postorder of
+* the CFG (in the direction of the problem), so the solution of acyclic CFGs
+* is obtained in a single pass over the nodes.
+*
+* Instances of this class have reference object semantics.
+*/
+class BitVectorDataflow: private retdec::utils::NonCopyable {
+public:
+	/// Direction of the propagation of facts.
+	enum class Direction {
+		Forward,
+		Backward
+	};
+
+	/// Operator combining facts coming from several nodes.
+	enum class Meet {
+		Union,
+		Intersection
+	};
+
+public:
+	BitVectorDataflow(ShPtr<CFG> cfg, std::size_t numOfFacts,
+		Direction direction, Meet meet = Meet::Union);
+
+	ShPtr<CFG> getCFG() const;
+	std::size_t getNumOfFacts() const;
+
+	/// @name Setting Up The Problem
+	/// @{
+	llvm::BitVector &getGen(ShPtr<CFG::Node> node);
+	llvm::BitVector &getKill(ShPtr<CFG::Node> node);
+	void setBoundary(const llvm::BitVector &newBoundary);
+	/// @}
+
+	/// @name Solution
+	/// @{
+	void solve();
+	const llvm::BitVector &getGen(ShPtr<CFG::Node> node) const;
+	const llvm::BitVector &getKill(ShPtr<CFG::Node> node) const;
+	const llvm::BitVector &getIn(ShPtr<CFG::Node> node) const;
+	const llvm::BitVector &getOut(ShPtr<CFG::Node> node) const;
+	std::size_t getNumOfNodeEvaluations() const;
+	/// @}
+
+private:
+	/// Sets of facts of a single CFG node.
+	struct NodeSets {
+		explicit NodeSets(std::size_t numOfFacts);
+
+		/// The @c GEN[B] set.
+		llvm::BitVector gen;
+
+		/// The @c KILL[B] set.
+		llvm::BitVector kill;
+
+		/// The @c IN[B] set.
+		llvm::BitVector in;
+
+		/// The @c OUT[B] set.
+		llvm::BitVector out;
+	};
+
+private:
+	void computeOrder();
+	std::size_t getNodeIndex(ShPtr<CFG::Node> node) const;
+	bool evaluateNode(std::size_t index);
+
+private:
+	/// CFG over which the problem is solved.
+	ShPtr<CFG> cfg;
+
+	/// Number of facts.
+	std::size_t numOfFacts;
+
+	/// Direction of the problem.
+	Direction direction;
+
+	/// The used meet operator.
+	Meet meet;
+
+	/// Value of nodes without predecessors or successors (depending on the
+	/// direction of the problem).
+	llvm::BitVector boundary;
+
+	/// Nodes of the CFG in the order of their indexes.
+	std::vector<ShPtr<CFG::Node>> nodes;
+
+	/// Mapping of a node into its index.
+	std::unordered_map<ShPtr<CFG::Node>, std::size_t> nodeIndexes;
+
+	/// Sets of facts of the nodes (in the order of the node indexes).
+	std::vector<NodeSets> sets;
+
+	/// For each node, indexes of nodes from which the facts flow into it.
+	std::vector<std::vector<std::size_t>> inputs;
+
+	/// For each node, indexes of nodes into which its facts flow.
+	std::vector<std::vector<std::size_t>> dependents;
+
+	/// Indexes of nodes in the order in which they should be evaluated.
+	std::vector<std::size_t> order;
+
+	/// Mapping of a node index into its position in @c order.
+	std::vector<std::size_t> orderPositions;
+
+	/// Number of node evaluations performed by the last solve().
+	std::size_t numOfNodeEvaluations;
+};
+
+} // namespace llvmir2hll
+} // namespace retdec
+
+#endif
@@ -45,11 +45,6 @@ private:
 	/// Module which contains the function specified by its CFG.
 	ShPtr<Module> module;
 
-	/// Global variables in @c module. This is here to speedup the traversal. By
-	/// using this set, we do not have to ask @c module every time we need such
-	/// information.
-	VarSet globalVars;
-
 	/// Call graph of the module.
 	ShPtr<CG> cg;
 
@@ -81,6 +76,7 @@ private:
 		ShPtr<OptimCallInfoObtainer> cio, ShPtr<ValueAnalysis> va,
 		ShPtr<CFG> cfg);
 
+	bool isGlobalVar(ShPtr<Variable> var) const;
 	ShPtr<OptimFuncInfo> performComputation();
 	void precomputeAlwaysModifiedVarsBeforeRead();
 	void updateFuncInfo(ShPtr<Statement> stmt);
@@ -0,0 +1,64 @@
+/**
+* @file include/retdec/llvmir2hll/graphs/cfg/cfg_writers/jsonl_cfg_writer.h
+* @brief A CFG writer in the JSON Lines format.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_LLVMIR2HLL_GRAPHS_CFG_CFG_WRITERS_JSONL_CFG_WRITER_H
+#define RETDEC_LLVMIR2HLL_GRAPHS_CFG_CFG_WRITERS_JSONL_CFG_WRITER_H
+
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+#include "retdec/llvmir2hll/graphs/cfg/cfg_writer.h"
+#include "retdec/llvmir2hll/support/smart_ptr.h"
+
+namespace retdec {
+namespace llvmir2hll {
+
+class CFG;
+
+/**
+* @brief A CFG writer in the JSON Lines format (one JSON object per line).
+*
+* Unlike GraphvizCFGWriter, the output is meant to be processed by tools
+* (e.g. loaded into a graph database), so it is an edge list without any
+* layout information:
+* @code
+* {"type":"node","function":"main","id":0,"label":"entry","address":"0x401000","statements":["a = 1"]}
+* {"type":"edge","function":"main","src":0,"dst":1,"cond":"a < 1"}
+* @endcode
+* Nodes are numbered from 0 in the order in which they are stored in the CFG.
+* Only nodes with a label (e.g. the entry and exit nodes) have @c label. The
+* @c address of a node is the address of its first statement that has one (it
+* is omitted if there is no such statement). Edges without a condition have no
+* @c cond.
+*
+* Use create() to create instances. Instances of this class have
+* reference object semantics.
+*/
+class JsonlCFGWriter: public CFGWriter {
+public:
+	static ShPtr<CFGWriter> create(ShPtr<CFG> cfg, std::ostream &out);
+
+	virtual std::string getId() const override;
+	virtual bool emitCFG() override;
+
+private:
+	/// Mapping of nodes into their numbers.
+	using NodeIdMapping = std::unordered_map<CFG::Node *, std::size_t>;
+
+private:
+	JsonlCFGWriter(ShPtr<CFG> cfg, std::ostream &out);
+
+	void emitNode(ShPtr<CFG::Node> node, std::size_t id,
+		const std::string &funcName);
+	void emitEdge(ShPtr<CFG::Edge> edge, const NodeIdMapping &nodeIds,
+		const std::string &funcName);
+};
+
+} // namespace llvmir2hll
+} // namespace retdec
+
+#endif
@@ -0,0 +1,51 @@
+/**
+* @file include/retdec/llvmir2hll/graphs/cg/cg_writers/jsonl_cg_writer.h
+* @brief A CG writer in the JSON Lines format.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_LLVMIR2HLL_GRAPHS_CG_CG_WRITERS_JSONL_CG_WRITER_H
+#define RETDEC_LLVMIR2HLL_GRAPHS_CG_CG_WRITERS_JSONL_CG_WRITER_H
+
+#include <ostream>
+#include <string>
+
+#include "retdec/llvmir2hll/graphs/cg/cg.h"
+#include "retdec/llvmir2hll/graphs/cg/cg_writer.h"
+#include "retdec/llvmir2hll/support/smart_ptr.h"
+
+namespace retdec {
+namespace llvmir2hll {
+
+/**
+* @brief A CG writer in the JSON Lines format (one JSON object per line).
+*
+* The output is an edge list meant to be processed by tools:
+* @code
+* {"type":"function","name":"main","address":"0x401000","defined":true,"callsByPointer":false}
+* {"type":"call","caller":"main","callee":"printf"}
+* @endcode
+* All functions are emitted before the calls. The @c address is omitted if
+* the function has no address.
+*
+* Use create() to create instances. Instances of this class have
+* reference object semantics.
+*/
+class JsonlCGWriter: public CGWriter {
+public:
+	static ShPtr<CGWriter> create(ShPtr<CG> cg, std::ostream &out);
+
+	virtual std::string getId() const override;
+	virtual bool emitCG() override;
+
+private:
+	JsonlCGWriter(ShPtr<CG> cg, std::ostream &out);
+
+	void emitFunc(ShPtr<CG::CalledFuncs> calledFuncs);
+	void emitCall(ShPtr<Function> caller, ShPtr<Function> callee);
+};
+
+} // namespace llvmir2hll
+} // namespace retdec
+
+#endif
@@ -0,0 +1,86 @@
+/**
+* @file include/retdec/llvmir2hll/hll/output_managers/binary_manager.h
+* @brief A binary token stream output manager class.
+* @copyright (c) 2019 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_LLVMIR2HLL_HLL_OUTPUT_MANAGERS_BINARY_MANAGER_H
+#define RETDEC_LLVMIR2HLL_HLL_OUTPUT_MANAGERS_BINARY_MANAGER_H
+
+#include <cstdint>
+#include <stack>
+#include <unordered_map>
+
+#include <llvm/Support/raw_ostream.h>
+
+#include "retdec/llvmir2hll/hll/output_manager.h"
+#include "retdec/llvmir2hll/hll/output_managers/binary_tokens.h"
+
+namespace retdec {
+namespace llvmir2hll {
+
+/**
+ * Emits the same tokens as JsonOutputManager, but as a compact binary token
+ * stream (see binary_tokens.h). Token values are interned and addresses are
+ * delta-encoded. Tokens are written into the output stream right away.
+ */
+class BinaryOutputManager : public OutputManager
+{
+	public:
+		BinaryOutputManager(llvm::raw_ostream& out);
+		virtual void finalize() override;
+
+	public:
+		virtual void newLine() override;
+		virtual void space(const std::string& space = " ") override;
+		virtual void punctuation(char p) override;
+		virtual void operatorX(const std::string& op) override;
+		virtual void globalVariableId(const std::string& id) override;
+		virtual void localVariableId(const std::string& id) override;
+		virtual void memberId(const std::string& id) override;
+		virtual void labelId(const std::string& id) override;
+		virtual void functionId(const std::string& id) override;
+		virtual void parameterId(const std::string& id) override;
+		virtual void keyword(const std::string& k) override;
+		virtual void dataType(const std::string& t) override;
+		virtual void preprocessor(const std::string& p) override;
+		virtual void include(const std::string& i) override;
+		virtual void constantBool(const std::string& c) override;
+		virtual void constantInt(const std::string& c) override;
+		virtual void constantFloat(const std::string& c) override;
+		virtual void constantString(const std::string& c) override;
+		virtual void constantSymbol(const std::string& c) override;
+		virtual void constantPointer(const std::string& c) override;
+		virtual void comment(const std::string& comment) override;
+
+	public:
+		virtual void commentModifier() override;
+		virtual void addressPush(Address a) override;
+		virtual void addressPop() override;
+
+	private:
+		void binaryToken(binary_tokens::TokenKind k, const std::string& v);
+		void generateAddressEntry(Address a);
+		void writeByte(std::uint8_t b);
+		void writeVarint(std::uint64_t v);
+		void writeString(const std::string& s);
+
+	private:
+		llvm::raw_ostream& _out;
+
+		/// Indexes of already written strings.
+		std::unordered_map<std::string, std::uint64_t> _strings;
+		/// The last written defined address (base for delta encoding).
+		std::uint64_t _lastAddress = 0;
+
+		std::stack<std::pair<Address, bool>> _addrs;
+		std::pair<Address, bool> _addrToGenerate;
+		/// The same as in JsonOutputManager.
+		bool _commentModifierOn = false;
+		std::string _runningComment;
+};
+
+} // namespace llvmir2hll
+} // namespace retdec
+
+#endif
@@ -0,0 +1,135 @@
+/**
+* @file include/retdec/llvmir2hll/hll/output_managers/binary_tokens.h
+* @brief Format of the binary token stream and its reader.
+* @copyright (c) 2019 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_LLVMIR2HLL_HLL_OUTPUT_MANAGERS_BINARY_TOKENS_H
+#define RETDEC_LLVMIR2HLL_HLL_OUTPUT_MANAGERS_BINARY_TOKENS_H
+
+#include <cstdint>
+#include <deque>
+#include <istream>
+#include <string>
+#include <string_view>
+
+#include "retdec/common/address.h"
+
+namespace retdec {
+namespace llvmir2hll {
+namespace binary_tokens {
+
+/**
+ * Binary token stream is a compact alternative to the JSON output. It holds
+ * the same tokens, but it is written and read in a single pass without any
+ * buffering.
+ *
+ * Format (integers are unsigned LEB128 varints unless stated otherwise):
+ * @code
+ * stream    := MAGIC VERSION(u8) record* END string
+ * record    := kind(u8) string            -- token of the given TokenKind
+ *            | ADDRESS zigzag-varint      -- delta from the last address
+ *            | NO_ADDRESS                 -- following tokens have no address
+ * string    := 0 length bytes             -- new string, gets the next index
+ *            | index + 1                  -- previously defined string
+ * @endcode
+ * The string after @c END is the output language.
+ */
+const char MAGIC[] = {'R', 'D', 'T', 'K'};
+const std::uint8_t VERSION = 1;
+
+/**
+ * Kinds of tokens, they are the same as in the JSON output.
+ */
+enum class TokenKind : std::uint8_t
+{
+	NEWLINE = 0,
+	SPACE,
+	PUNCTUATION,
+	OPERATOR,
+	ID_GVAR,
+	ID_LVAR,
+	ID_MEMBER,
+	ID_LABEL,
+	ID_FUNCTION,
+	ID_PARAMETER,
+	KEYWORD,
+	DATA_TYPE,
+	PREPROCESSOR,
+	INCLUDE,
+	CONST_BOOL,
+	CONST_INT,
+	CONST_FLOAT,
+	CONST_STRING,
+	CONST_SYMBOL,
+	CONST_POINTER,
+	COMMENT,
+	// Keep as the last kind.
+	KINDS_COUNT
+};
+
+/**
+ * Tags of records other than tokens.
+ */
+enum class Tag : std::uint8_t
+{
+	ADDRESS = 0x80,
+	NO_ADDRESS = 0x81,
+	END = 0xff
+};
+
+const char* getTokenKindName(TokenKind kind);
+
+/**
+ * Token read from a binary token stream.
+ */
+struct Token
+{
+	TokenKind kind = TokenKind::NEWLINE;
+	/// Valid as long as the reader which read the token exists.
+	std::string_view value;
+	/// Address the token is associated with (may be undefined).
+	common::Address address;
+};
+
+/**
+ * Reads tokens from a binary token stream.
+ *
+ * Usage:
+ * @code
+ * BinaryTokenReader reader(in);
+ * Token t;
+ * while (reader.next(t)) { ... }
+ * @endcode
+ *
+ * Throws @c std::runtime_error if the stream is malformed.
+ */
+class BinaryTokenReader
+{
+	public:
+		explicit BinaryTokenReader(std::istream& in);
+
+		bool next(Token& token);
+		const std::string& getLanguage() const;
+
+	private:
+		std::uint8_t readByte();
+		std::uint64_t readVarint();
+		const std::string& readString();
+
+	private:
+		std::streambuf* _in = nullptr;
+		/// Interned strings, a deque keeps references to them valid.
+		std::deque<std::string> _strings;
+		/// The last defined address (base for delta encoding).
+		std::uint64_t _lastAddress = 0;
+		common::Address _address;
+		std::string _language;
+		bool _end = false;
+};
+
+} // namespace binary_tokens
+} // namespace llvmir2hll
+} // namespace retdec
+
+#endif
@@ -52,6 +52,7 @@ public:
 	/// @name Options
 	/// @{
 	void setOptionStrictFPUSemantics(bool strict = true);
+	void setOptionReleaseLLVMIR(bool release = true);
 	/// @}
 
 private:
@@ -77,6 +78,8 @@ private:
 	bool shouldBeConvertedAndAdded(const llvm::Function &func) const;
 	void convertAndAddFuncsDeclarations();
 	void convertFuncsBodies();
+	bool canReleaseFuncBody(const llvm::Function &func) const;
+	void releaseFuncBody(llvm::Function &func) const;
 	/// @}
 
 	/// @name Ensure that identifiers are valid
@@ -95,6 +98,9 @@ private:
 	/// Use strict FPU semantics?
 	bool optionStrictFPUSemantics;
 
+	/// Release bodies of LLVM functions once they are converted?
+	bool optionReleaseLLVMIR;
+
 	/// Should debugging messages be enabled?
 	bool enableDebug;
 
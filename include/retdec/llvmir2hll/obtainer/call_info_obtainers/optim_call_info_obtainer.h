@@ -12,6 +12,7 @@
 #include <string>
 
 #include "retdec/llvmir2hll/obtainer/call_info_obtainer.h"
+#include "retdec/llvmir2hll/support/indexed_var_set.h"
 #include "retdec/llvmir2hll/support/smart_ptr.h"
 
 namespace retdec {
@@ -29,7 +30,8 @@ class OptimCallInfo: public CallInfo {
 	friend class OptimFuncInfoCFGTraversal;
 
 public:
-	explicit OptimCallInfo(ShPtr<CallExpr> call);
+	explicit OptimCallInfo(ShPtr<CallExpr> call,
+		ShPtr<const VarIndex> globalVarIndex = nullptr);
 
 	void debugPrint();
 
@@ -46,28 +48,28 @@ public:
 
 private:
 	/// Variables that are never read in this function call.
-	VarSet neverReadVars;
+	IndexedVarSet neverReadVars;
 
 	/// Variables that may be read in this function call.
-	VarSet mayBeReadVars;
+	IndexedVarSet mayBeReadVars;
 
 	/// Variables that are always read in this function call.
-	VarSet alwaysReadVars;
+	IndexedVarSet alwaysReadVars;
 
 	/// Variables that are never modified in this function call.
-	VarSet neverModifiedVars;
+	IndexedVarSet neverModifiedVars;
 
 	/// Variables that may be modified in this function call.
-	VarSet mayBeModifiedVars;
+	IndexedVarSet mayBeModifiedVars;
 
 	/// Variables that are always modified in this function call.
-	VarSet alwaysModifiedVars;
+	IndexedVarSet alwaysModifiedVars;
 
 	/// Variables whose value is never changed in this function call.
-	VarSet varsWithNeverChangedValue;
+	IndexedVarSet varsWithNeverChangedValue;
 
 	/// Variables which are always modified before read in this function call.
-	VarSet varsAlwaysModifiedBeforeRead;
+	IndexedVarSet varsAlwaysModifiedBeforeRead;
 };
 
 /**
@@ -82,7 +84,8 @@ class OptimFuncInfo: public FuncInfo {
 	friend class OptimFuncInfoCFGTraversal;
 
 public:
-	explicit OptimFuncInfo(ShPtr<Function> func);
+	explicit OptimFuncInfo(ShPtr<Function> func,
+		ShPtr<const VarIndex> globalVarIndex = nullptr);
 
 	void debugPrint();
 
@@ -99,28 +102,28 @@ public:
 
 private:
 	/// Variables that are never read in this function.
-	VarSet neverReadVars;
+	IndexedVarSet neverReadVars;
 
 	/// Variables that may be read in this function.
-	VarSet mayBeReadVars;
+	IndexedVarSet mayBeReadVars;
 
 	/// Variables that are always read in this function.
-	VarSet alwaysReadVars;
+	IndexedVarSet alwaysReadVars;
 
 	/// Variables that are never modified in this function.
-	VarSet neverModifiedVars;
+	IndexedVarSet neverModifiedVars;
 
 	/// Variables that may be modified in this function.
-	VarSet mayBeModifiedVars;
+	IndexedVarSet mayBeModifiedVars;
 
 	/// Variables that are always modified in this function.
-	VarSet alwaysModifiedVars;
+	IndexedVarSet alwaysModifiedVars;
 
 	/// Variables whose value is never changed in this function.
-	VarSet varsWithNeverChangedValue;
+	IndexedVarSet varsWithNeverChangedValue;
 
 	/// Variables which are always modified before read in this function.
-	VarSet varsAlwaysModifiedBeforeRead;
+	IndexedVarSet varsAlwaysModifiedBeforeRead;
 };
 
 /**
@@ -135,6 +138,10 @@ private:
 *
 * Compare with PessimCallInfoObtainer.
 *
+* Information about global variables is stored in bit vectors over the global
+* variables of the module (see IndexedVarSet), so it is cheap to copy and
+* compare even in modules with thousands of global variables.
+*
 * Use create() to create instances. Instances of this class have
 * reference object semantics.
 */
@@ -160,10 +167,10 @@ private:
 private:
 	OptimCallInfoObtainer();
 
+	void initGlobalVarIndex();
 	void computeAllFuncInfos();
 	void computeFuncInfo(ShPtr<Function> func);
 	void computeFuncInfos(const FuncSet &funcs);
-	VarSet skipLocalVars(const VarSet &vars);
 	ShPtr<OptimFuncInfo> computeFuncInfoDeclaration(ShPtr<Function> func);
 	ShPtr<OptimFuncInfo> computeFuncInfoDefinition(ShPtr<Function> func);
 	ShPtr<OptimCallInfo> computeCallInfo(ShPtr<CallExpr> call,
@@ -182,7 +189,10 @@ private:
 	CallInfoMap callInfoMap;
 
 	/// Global variables in the module, including functions.
-	VarSet globalVars;
+	ShPtr<VarIndex> globalVarIndex;
+
+	/// Bits of variables from @c globalVarIndex that are not functions.
+	llvm::BitVector moduleGlobalVars;
 };
 
 } // namespace llvmir2hll
@@ -7,25 +7,29 @@
 #ifndef RETDEC_LLVMIR2HLL_OBTAINER_CALLS_IN_MODULE_OBTAINER_H
 #define RETDEC_LLVMIR2HLL_OBTAINER_CALLS_IN_MODULE_OBTAINER_H
 
+#include <functional>
 #include <vector>
 
+#include "retdec/llvmir2hll/support/fused_traversal.h"
 #include "retdec/llvmir2hll/support/smart_ptr.h"
-#include "retdec/llvmir2hll/support/visitors/ordered_all_visitor.h"
 #include "retdec/utils/non_copyable.h"
 
 namespace retdec {
 namespace llvmir2hll {
 
+class CallExpr;
 class Module;
 
 /**
 * @brief An obtainer of information about function calls in a module.
 *
+* Only calls in functions are obtained.
+*
 * This class implements the "static helper" (or "library") design pattern (it
-* has just static functions and no instances can be created).
+* has just static functions and no instances can be created). To obtain calls
+* during a traversal shared with other visitors, use Collector.
 */
-class CallsInModuleObtainer: private OrderedAllVisitor,
-		private retdec::utils::NonCopyable {
+class CallsInModuleObtainer: private retdec::utils::NonCopyable {
 public:
 	/// Information about a single call.
 	struct CallInfo {
@@ -45,24 +49,54 @@ public:
 	/// A list of calls.
 	using Calls = std::vector<CallInfo>;
 
+	/// Returns @c true if the given call in the given module should be
+	/// obtained. It has to be thread-safe.
+	using Filter = std::function<bool (ShPtr<CallExpr>, ShPtr<Module>)>;
+
+	class Collector;
+
 public:
-	static Calls getCalls(ShPtr<Module> module);
+	static Calls getCalls(ShPtr<Module> module, Filter filter = Filter());
 
 private:
-	CallsInModuleObtainer(ShPtr<Module> module);
+	CallsInModuleObtainer();
+};
+
+/**
+* @brief Collects function calls during a FusedTraversal.
+*
+* Use create() to create instances.
+*/
+class CallsInModuleObtainer::Collector: public FusedTraversal::Client {
+public:
+	static ShPtr<Collector> create(Filter filter = Filter());
+
+	bool hasCallsFrom(ShPtr<Module> module) const;
+	Calls takeCalls();
 
-	Calls getCallsImpl();
-	void obtainCallsInGlobalVars();
-	void obtainCallsInFuncs();
-	void obtainCallsInFunc(ShPtr<Function> func);
+	/// @name FusedTraversal::Client Interface
+	/// @{
+	virtual void startModule(ShPtr<Module> module) override;
+	virtual void startFunc(ShPtr<Function> func) override;
+	virtual void endFunc(ShPtr<Function> func) override;
+	virtual void endModule(ShPtr<Module> module) override;
+	virtual ShPtr<FusedTraversal::Client> createEmptyCopy() const override;
+	virtual void mergeCopy(FusedTraversal::Client &copy) override;
+	/// @}
 
 	/// @name Visitor Interface
 	/// @{
-	using OrderedAllVisitor::visit;
+	using FusedTraversal::Client::visit;
 	virtual void visit(ShPtr<CallExpr> expr) override;
 	/// @}
 
 private:
+	explicit Collector(Filter filter);
+
+private:
+	/// Only calls satisfying this filter (if any) are collected.
+	Filter filter;
+
 	/// Module in which the calls are searched.
 	ShPtr<Module> module;
 
@@ -71,6 +105,9 @@ private:
 
 	/// Found function calls.
 	Calls foundCalls;
+
+	/// Module whose traversal has been finished (the calls are complete).
+	ShPtr<Module> traversedModule;
 };
 
 } // namespace llvmir2hll
@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "retdec/llvmir2hll/pattern/pattern.h"
+#include "retdec/llvmir2hll/support/fused_traversal.h"
 #include "retdec/llvmir2hll/support/smart_ptr.h"
 #include "retdec/utils/non_copyable.h"
 
@@ -30,6 +31,11 @@ class CallInfoObtainer;
 *  - register itself at PatternFinderFactory by passing the static @c create
 *    function and the finder's ID
 *
+* A finder which only needs to gather some nodes from the module may return a
+* FusedTraversal::Client from getFusedTraversalClient(). PatternFinderRunner
+* then gathers the data for all such finders by a single traversal before the
+* finders are run.
+*
 * Note: Do NOT set the ID of your concrete finder to "all" as this ID is
 *       reserved.
 *
@@ -53,6 +59,8 @@ public:
 	*/
 	virtual Patterns findPatterns(ShPtr<Module> module) = 0;
 
+	virtual ShPtr<FusedTraversal::Client> getFusedTraversalClient() const;
+
 protected:
 	PatternFinder(ShPtr<ValueAnalysis> va, ShPtr<CallInfoObtainer> cio);
 
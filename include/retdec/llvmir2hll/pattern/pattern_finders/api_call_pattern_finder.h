@@ -9,6 +9,7 @@
 
 #include <string>
 
+#include "retdec/llvmir2hll/obtainer/calls_in_module_obtainer.h"
 #include "retdec/llvmir2hll/pattern/pattern_finder.h"
 
 namespace retdec {
@@ -35,6 +36,8 @@ class APICallPatternFinder: public PatternFinder {
 public:
 	virtual const std::string getId() const override;
 	virtual Patterns findPatterns(ShPtr<Module> module) override;
+	virtual ShPtr<FusedTraversal::Client> getFusedTraversalClient() const
+		override;
 
 	static ShPtr<PatternFinder> create(ShPtr<ValueAnalysis> va,
 		ShPtr<CallInfoObtainer> cio);
@@ -42,6 +45,10 @@ public:
 private:
 	APICallPatternFinder(ShPtr<ValueAnalysis> va,
 		ShPtr<CallInfoObtainer> cio);
+
+private:
+	/// Collector of calls of interesting functions.
+	ShPtr<CallsInModuleObtainer::Collector> apiCallsCollector;
 };
 
 } // namespace llvmir2hll
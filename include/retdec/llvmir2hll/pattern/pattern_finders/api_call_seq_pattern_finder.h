@@ -9,6 +9,7 @@
 
 #include <string>
 
+#include "retdec/llvmir2hll/obtainer/calls_in_module_obtainer.h"
 #include "retdec/llvmir2hll/pattern/pattern_finder.h"
 
 namespace retdec {
@@ -27,6 +28,8 @@ class APICallSeqPatternFinder: public PatternFinder {
 public:
 	virtual const std::string getId() const override;
 	virtual Patterns findPatterns(ShPtr<Module> module) override;
+	virtual ShPtr<FusedTraversal::Client> getFusedTraversalClient() const
+		override;
 
 	static ShPtr<PatternFinder> create(ShPtr<ValueAnalysis> va,
 		ShPtr<CallInfoObtainer> cio);
@@ -40,6 +43,9 @@ private:
 private:
 	/// Patterns to be returned.
 	Patterns foundPatterns;
+
+	/// Collector of calls that begin a sequence of API calls.
+	ShPtr<CallsInModuleObtainer::Collector> callsCollector;
 };
 
 } // namespace llvmir2hll
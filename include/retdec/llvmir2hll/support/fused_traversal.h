@@ -0,0 +1,110 @@
+/**
+* @file include/retdec/llvmir2hll/support/fused_traversal.h
+* @brief A single traversal of a module driving several read-only visitors.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_LLVMIR2HLL_SUPPORT_FUSED_TRAVERSAL_H
+#define RETDEC_LLVMIR2HLL_SUPPORT_FUSED_TRAVERSAL_H
+
+#include <vector>
+
+#include "retdec/llvmir2hll/support/smart_ptr.h"
+#include "retdec/llvmir2hll/support/visitor_adapter.h"
+#include "retdec/utils/non_copyable.h"
+
+namespace retdec {
+namespace llvmir2hll {
+
+class Function;
+class Module;
+class Statement;
+
+/**
+* @brief A single traversal of a module driving several read-only visitors.
+*
+* Every registered client is notified about every node of the module in the
+* same order in which OrderedAllVisitor traverses them. Global variables are
+* traversed first, then definitions of functions. Clients only observe the
+* nodes; the traversal itself is done by this class, so N clients cost one
+* walk over the module instead of N walks.
+*
+* Clients must not modify the module. If all clients can be copied (see
+* Client::createEmptyCopy()), functions can be traversed in parallel. Then,
+* every chunk of functions is traversed by its own copies of the clients and
+* the copies are merged into the original clients in the order of functions,
+* so the results do not depend on the number of threads.
+*
+* Usage:
+* @code
+* FusedTraversal traversal;
+* traversal.addClient(client1);
+* traversal.addClient(client2);
+* traversal.run(module);
+* @endcode
+*/
+class FusedTraversal: private retdec::utils::NonCopyable {
+public:
+	class Client;
+
+	/// A list of clients.
+	using Clients = std::vector<ShPtr<Client>>;
+
+public:
+	FusedTraversal();
+
+	void addClient(ShPtr<Client> client);
+	const Clients &getClients() const;
+	bool canRunInParallel() const;
+
+	void run(ShPtr<Module> module, bool parallel = false);
+
+private:
+	class FusedVisitor;
+
+	void runSerially(ShPtr<Module> module);
+	void runInParallel(ShPtr<Module> module);
+
+private:
+	/// Clients to be notified.
+	Clients clients;
+};
+
+/**
+* @brief A read-only visitor driven by FusedTraversal.
+*
+* A concrete client overrides the @c visit() functions of the nodes it is
+* interested in. It must not traverse the children of the visited nodes (the
+* traversal does it) and it must not modify the module.
+*
+* To support a parallel traversal, override createEmptyCopy() and
+* mergeCopy().
+*/
+class FusedTraversal::Client: public VisitorAdapter {
+public:
+	using VisitorAdapter::visit;
+
+	virtual void startModule(ShPtr<Module> module);
+	virtual void startFunc(ShPtr<Function> func);
+	virtual void endFunc(ShPtr<Function> func);
+	virtual void endModule(ShPtr<Module> module);
+
+	virtual ShPtr<Client> createEmptyCopy() const;
+	virtual void mergeCopy(Client &copy);
+
+protected:
+	Client();
+
+	ShPtr<Statement> getCurrentStmt() const;
+
+private:
+	friend class FusedTraversal;
+
+	/// The last statement entered by the traversal (may be null).
+	const ShPtr<Statement> *currStmt;
+};
+
+} // namespace llvmir2hll
+} // namespace retdec
+
+#endif
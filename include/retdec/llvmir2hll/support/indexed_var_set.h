@@ -0,0 +1,98 @@
+/**
+* @file include/retdec/llvmir2hll/support/indexed_var_set.h
+* @brief A set of variables storing indexed variables as a bit vector.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_LLVMIR2HLL_SUPPORT_INDEXED_VAR_SET_H
+#define RETDEC_LLVMIR2HLL_SUPPORT_INDEXED_VAR_SET_H
+
+#include <cstddef>
+#include <unordered_map>
+
+#include <llvm/ADT/BitVector.h>
+
+#include "retdec/llvmir2hll/support/smart_ptr.h"
+#include "retdec/llvmir2hll/support/types.h"
+
+namespace retdec {
+namespace llvmir2hll {
+
+/**
+* @brief A fixed sequence of variables, each of which has assigned an index.
+*
+* Indexes are assigned in the order in which the variables were given to the
+* constructor, starting from zero.
+*
+* Instances of this class have value object semantics.
+*/
+class VarIndex {
+public:
+	/// Index returned for variables which are not indexed.
+	static const std::size_t NO_INDEX;
+
+public:
+	explicit VarIndex(const VarVector &vars);
+
+	std::size_t size() const;
+	bool hasVar(ShPtr<Variable> var) const;
+	std::size_t getIndex(ShPtr<Variable> var) const;
+	ShPtr<Variable> getVar(std::size_t index) const;
+	const VarVector &getVars() const;
+
+private:
+	/// Indexed variables.
+	VarVector vars;
+
+	/// Mapping of a variable into its index.
+	std::unordered_map<ShPtr<Variable>, std::size_t> indexes;
+};
+
+/**
+* @brief A set of variables storing indexed variables as a bit vector.
+*
+* Variables from the used VarIndex are stored as bits, which makes the
+* set-wide operations (union, comparison) proportional to the number of
+* indexed variables divided by the size of a machine word. Other variables
+* are stored in an ordinary set. This is suitable for sets that contain many
+* global variables and just a few local variables.
+*
+* Instances of this class have value object semantics.
+*/
+class IndexedVarSet {
+public:
+	IndexedVarSet();
+	explicit IndexedVarSet(ShPtr<const VarIndex> index);
+
+	bool operator==(const IndexedVarSet &other) const;
+	bool operator!=(const IndexedVarSet &other) const;
+
+	bool hasVar(ShPtr<Variable> var) const;
+	bool empty() const;
+	VarSet getVars() const;
+	const llvm::BitVector &getIndexedVars() const;
+	const VarSet &getOtherVars() const;
+
+	void insert(ShPtr<Variable> var);
+	void insert(const VarSet &vars);
+	void insert(const IndexedVarSet &vars);
+	void insertIndexedVars(const IndexedVarSet &vars);
+	void insertIndexedVars(const llvm::BitVector &vars);
+	void insertAllIndexedVars();
+	void clear();
+
+private:
+	/// Index of variables stored in @c indexedVars.
+	ShPtr<const VarIndex> index;
+
+	/// Indexed variables in the set.
+	llvm::BitVector indexedVars;
+
+	/// Variables in the set that are not in @c index.
+	VarSet otherVars;
+};
+
+} // namespace llvmir2hll
+} // namespace retdec
+
+#endif
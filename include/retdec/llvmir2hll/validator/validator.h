@@ -8,9 +8,10 @@
 #define RETDEC_LLVMIR2HLL_VALIDATOR_VALIDATOR_H
 
 #include <string>
+#include <vector>
 
+#include "retdec/llvmir2hll/support/fused_traversal.h"
 #include "retdec/llvmir2hll/support/smart_ptr.h"
-#include "retdec/llvmir2hll/support/visitors/ordered_all_visitor.h"
 #include "retdec/utils/io/log.h"
 
 using namespace retdec::utils::io;
@@ -24,33 +25,53 @@ namespace llvmir2hll {
 * Every concrete validator has to:
 *  - define a static <tt>ShPtr<Validator> create()</tt> function
 *  - define @c getId(), which returns the ID of the validator
+*  - register itself at ValidatorFactory (its copies used in a parallel
+*    validation are created by the factory)
+*  - override the @c visit() functions of the nodes it checks; the traversal
+*    of the module is done by FusedTraversal, so they must not traverse the
+*    children of the nodes
 *  - when there is a validation error, validationError() has to be run
 *  - in its description, mention what validations are performed
-*  - if necessary, redefine @c runValidation()
 *
 * A concrete validator can utilize protected members of this base class.
 *
 * Instances of this class have reference object semantics.
 */
-class Validator: protected OrderedAllVisitor {
+class Validator: public FusedTraversal::Client {
+public:
+	/// A list of validators.
+	using Validators = std::vector<ShPtr<Validator>>;
+
 public:
 	virtual std::string getId() const = 0;
 
 	bool validate(ShPtr<Module> module, bool printMessageOnError = false);
+	static bool validateAll(const Validators &validators,
+		ShPtr<Module> module, bool printMessageOnError = false,
+		bool parallel = false);
+
+	/// @name FusedTraversal::Client Interface
+	/// @{
+	virtual void startModule(ShPtr<Module> module) override;
+	virtual void startFunc(ShPtr<Function> func) override;
+	virtual void endModule(ShPtr<Module> module) override;
+	virtual ShPtr<FusedTraversal::Client> createEmptyCopy() const override;
+	virtual void mergeCopy(FusedTraversal::Client &copy) override;
+	/// @}
 
 protected:
 	Validator();
 
-	void traverseAllGlobalVariables();
-	void traverseAllFunctions();
-
 	/**
 	* @brief Function to be called when there is a validation error.
 	*/
 	void validationError(const std::string &warningMessage) {
 		moduleIsCorrect = false;
 		if (printMessageOnError) {
-			Log::error() << Log::Warning << warningMessage << std::endl;
+			// The messages are printed after the whole module has been
+			// validated so that they do not interleave when functions are
+			// validated in parallel.
+			warningMessages.push_back(warningMessage);
 		}
 	}
 
@@ -61,15 +82,15 @@ protected:
 	/// The currently traversed function.
 	ShPtr<Function> func;
 
-private:
-	virtual void runValidation();
-
 private:
 	/// Should we print a warning message when encountering an error?
 	bool printMessageOnError;
 
 	/// @c true if there has not been an error, @c false otherwise.
 	bool moduleIsCorrect;
+
+	/// Messages to be printed when the validation ends.
+	std::vector<std::string> warningMessages;
 };
 
 } // namespace llvmir2hll
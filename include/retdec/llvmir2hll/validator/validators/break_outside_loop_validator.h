@@ -37,7 +37,7 @@ private:
 
 	/// @name Visitor Interface
 	/// @{
-	using OrderedAllVisitor::visit;
+	using Validator::visit;
 	virtual void visit(ShPtr<BreakStmt> stmt) override;
 	virtual void visit(ShPtr<ContinueStmt> stmt) override;
 	/// @}
@@ -38,7 +38,7 @@ private:
 
 	/// @name Visitor Interface
 	/// @{
-	using OrderedAllVisitor::visit;
+	using Validator::visit;
 	virtual void visit(ShPtr<VarDefStmt> stmt) override;
 	/// @}
 };
@@ -36,7 +36,7 @@ private:
 
 	/// @name Visitor Interface
 	/// @{
-	using OrderedAllVisitor::visit;
+	using Validator::visit;
 	virtual void visit(ShPtr<ReturnStmt> stmt) override;
 	/// @}
 };
@@ -9,6 +9,7 @@
 
 #include <capstone/capstone.h>
 #include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Module.h>
 
 #include "retdec/common/basic_block.h"
@@ -30,6 +31,18 @@ struct LlvmModuleContextPair
 	std::unique_ptr<llvm::LLVMContext> context;
 };
 
+/**
+ * Objects created by a decompilation, kept alive after it finished.
+ */
+struct DecompilationState
+{
+	// Order matters: members are destroyed in reverse order, and both
+	// passes and module use context.
+	std::unique_ptr<llvm::LLVMContext> context;
+	std::unique_ptr<llvm::Module> module;
+	std::unique_ptr<llvm::legacy::PassManager> passManager;
+};
+
 /**
  * \param[in]  inputPath Path the the input file to disassemble.
  * \param[out] fs        Set of functions to fill.
@@ -45,10 +58,14 @@ LlvmModuleContextPair disassemble(
  * Run a decompilation according to a \p config configuration.
  * If \p outString is set, decompilation output will be returned
  * in this string. Otherwise, output file is expected to be set in \p config.
+ * If \p state is set, the LLVM module and the passes (holding the back-end IR)
+ * are moved into it instead of being destroyed. This allows the caller
+ * to postpone or skip their destruction, which may take long.
  */
 bool decompile(
 		retdec::config::Config& config,
-		std::string* outString = nullptr
+		std::string* outString = nullptr,
+		DecompilationState* state = nullptr
 );
 
 } // namespace retdec
@@ -0,0 +1,373 @@
+/**
+ * @file include/retdec/serdes/binary.h
+ * @brief Compact binary encoding of serialized objects.
+ * @copyright (c) 2019 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_SERDES_BINARY_H
+#define RETDEC_SERDES_BINARY_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <rapidjson/rapidjson.h>
+
+namespace retdec {
+namespace serdes {
+
+/**
+ * Compact binary encoding of the JSON data model.
+ *
+ * The encoding stores the same stream of values the JSON serializers
+ * produce, so every object keeps its member names and the same
+ * deserializers are used for both the formats. Readers ignore unknown
+ * members and use defaults for missing ones, therefore the schema can
+ * evolve the same way it does in JSON.
+ *
+ * Layout:
+ * @code
+ *     header  := "RDCB" major:u8 minor:u8
+ *     value   := tag:u8 payload
+ * @endcode
+ * Integers are LEB128 varints (signed ones zig-zag encoded), doubles are
+ * little-endian IEEE 754. Short strings are stored only once, their
+ * subsequent occurrences refer to the first one by its index. Canonical
+ * hexadecimal addresses (@c 0x401000) are stored as numbers.
+ */
+namespace binary {
+
+const char Magic[] = {'R', 'D', 'C', 'B'};
+const std::uint8_t MajorVersion = 1;
+const std::uint8_t MinorVersion = 0;
+const std::size_t HeaderSize = sizeof(Magic) + 2;
+
+/// Strings up to this length are interned.
+const std::size_t MaxInternedLength = 64;
+
+enum class Tag : std::uint8_t
+{
+	Null = 0,
+	False,
+	True,
+	Int,
+	Uint,
+	Double,
+	String,
+	InternedString,
+	StringRef,
+	HexAddress,
+	StartObject,
+	EndObject,
+	StartArray,
+	EndArray,
+};
+
+bool isBinary(const char* data, std::size_t size);
+bool isBinary(const std::string& data);
+
+} // namespace binary
+
+/**
+ * Writer producing the binary encoding. It implements the same interface
+ * as rapidjson writers, so all the serializers can be used with it.
+ */
+class BinaryWriter
+{
+	public:
+		BinaryWriter();
+
+		bool Null();
+		bool Bool(bool b);
+		bool Int(int i);
+		bool Uint(unsigned u);
+		bool Int64(std::int64_t i);
+		bool Uint64(std::uint64_t u);
+		bool Double(double d);
+		bool RawNumber(const char* str, rapidjson::SizeType length, bool copy = false);
+		bool String(const char* str, rapidjson::SizeType length, bool copy = false);
+		bool String(const char* str);
+		bool String(const std::string& str);
+		bool Key(const char* str, rapidjson::SizeType length, bool copy = false);
+		bool Key(const std::string& str);
+		bool StartObject();
+		bool EndObject(rapidjson::SizeType memberCount = 0);
+		bool StartArray();
+		bool EndArray(rapidjson::SizeType elementCount = 0);
+
+		const std::string& getOutput() const;
+		std::string releaseOutput();
+
+	private:
+		void writeTag(binary::Tag t);
+		void writeVarint(std::uint64_t v);
+		void writeBytes(const char* str, std::size_t length);
+
+	private:
+		std::string _out;
+		std::unordered_map<std::string, std::size_t> _strings;
+};
+
+/**
+ * Reader of the binary encoding. It is a rapidjson generator, i.e. it
+ * replays the encoded values into any rapidjson handler:
+ * @code
+ *     BinaryReader reader(data, size);
+ *     rapidjson::Document doc;
+ *     doc.Populate(reader);
+ * @endcode
+ * Data are not copied, they must outlive the reader (the reader can be used
+ * directly on a mapped file).
+ */
+class BinaryReader
+{
+	public:
+		BinaryReader(const char* data, std::size_t size);
+
+		template <typename Handler>
+		bool operator()(Handler& handler);
+
+		bool hasError() const;
+		const std::string& getError() const;
+		std::size_t getErrorOffset() const;
+
+	private:
+		bool fail(const std::string& msg);
+		bool readVarint(std::uint64_t& v);
+		bool readBytes(const char*& str, std::size_t& length);
+		template <typename Handler>
+		bool emitString(
+				Handler& handler,
+				const char* str,
+				std::size_t length,
+				bool isKey);
+
+	private:
+		/// Open container, its type and number of values read so far.
+		struct Container
+		{
+			bool isObject = false;
+			std::size_t count = 0;
+		};
+
+	private:
+		const char* _data = nullptr;
+		std::size_t _size = 0;
+		std::size_t _pos = 0;
+		std::vector<std::pair<const char*, std::size_t>> _strings;
+		std::string _error;
+		std::size_t _errorOffset = 0;
+};
+
+template <typename Handler>
+bool BinaryReader::emitString(
+		Handler& handler,
+		const char* str,
+		std::size_t length,
+		bool isKey)
+{
+	auto l = static_cast<rapidjson::SizeType>(length);
+	bool ok = isKey ? handler.Key(str, l, true) : handler.String(str, l, true);
+	return ok || fail("handler rejected the string");
+}
+
+/**
+ * Replay all the encoded values into @a handler.
+ * @return @c true if the data were well formed and accepted by @a handler,
+ *         @c false otherwise (see @c getError()).
+ */
+template <typename Handler>
+bool BinaryReader::operator()(Handler& handler)
+{
+	_pos = 0;
+	_strings.clear();
+	_error.clear();
+
+	if (!binary::isBinary(_data, _size))
+	{
+		return fail("missing binary config header");
+	}
+	if (static_cast<std::uint8_t>(_data[sizeof(binary::Magic)])
+			> binary::MajorVersion)
+	{
+		return fail("unsupported binary config version");
+	}
+	_pos = binary::HeaderSize;
+
+	std::vector<Container> stack;
+	bool haveRoot = false;
+	while (_pos < _size)
+	{
+		if (haveRoot)
+		{
+			return fail("unexpected data after the root value");
+		}
+
+		auto tag = static_cast<binary::Tag>(_data[_pos++]);
+
+		// Keys are the even values in objects and they must be strings.
+		bool isKey = !stack.empty()
+				&& stack.back().isObject
+				&& stack.back().count % 2 == 0;
+		if (isKey
+				&& tag != binary::Tag::String
+				&& tag != binary::Tag::InternedString
+				&& tag != binary::Tag::StringRef
+				&& tag != binary::Tag::HexAddress
+				&& tag != binary::Tag::EndObject)
+		{
+			return fail("object key is not a string");
+		}
+
+		bool ok = true;
+		std::uint64_t v = 0;
+		const char* str = nullptr;
+		std::size_t length = 0;
+		switch (tag)
+		{
+			case binary::Tag::Null:
+				ok = handler.Null();
+				break;
+			case binary::Tag::False:
+				ok = handler.Bool(false);
+				break;
+			case binary::Tag::True:
+				ok = handler.Bool(true);
+				break;
+			case binary::Tag::Int:
+				if (!readVarint(v)) return false;
+				ok = handler.Int64(static_cast<std::int64_t>(v >> 1)
+						^ -static_cast<std::int64_t>(v & 1));
+				break;
+			case binary::Tag::Uint:
+				if (!readVarint(v)) return false;
+				ok = handler.Uint64(v);
+				break;
+			case binary::Tag::Double:
+			{
+				if (_size - _pos < 8) return fail("truncated double");
+				for (unsigned i = 0; i < 8; ++i)
+				{
+					v |= std::uint64_t(std::uint8_t(_data[_pos + i])) << (8 * i);
+				}
+				_pos += 8;
+				double d;
+				std::memcpy(&d, &v, sizeof(d));
+				ok = handler.Double(d);
+				break;
+			}
+			case binary::Tag::String:
+			case binary::Tag::InternedString:
+				if (!readBytes(str, length)) return false;
+				if (tag == binary::Tag::InternedString)
+				{
+					_strings.emplace_back(str, length);
+				}
+				if (!emitString(handler, str, length, isKey)) return false;
+				break;
+			case binary::Tag::StringRef:
+				if (!readVarint(v)) return false;
+				if (v >= _strings.size()) return fail("invalid string reference");
+				if (!emitString(
+						handler,
+						_strings[v].first,
+						_strings[v].second,
+						isKey))
+				{
+					return false;
+				}
+				break;
+			case binary::Tag::HexAddress:
+			{
+				if (!readVarint(v)) return false;
+				char buff[2 + 16];
+				buff[0] = '0';
+				buff[1] = 'x';
+				std::size_t n = 0;
+				char digits[16];
+				do
+				{
+					digits[n++] = "0123456789abcdef"[v & 0xf];
+					v >>= 4;
+				} while (v);
+				for (std::size_t i = 0; i < n; ++i)
+				{
+					buff[2 + i] = digits[n - i - 1];
+				}
+				if (!emitString(handler, buff, 2 + n, isKey)) return false;
+				break;
+			}
+			case binary::Tag::StartObject:
+			case binary::Tag::StartArray:
+				if (!stack.empty())
+				{
+					++stack.back().count;
+				}
+				stack.push_back(Container{tag == binary::Tag::StartObject, 0});
+				if (!(stack.back().isObject
+						? handler.StartObject()
+						: handler.StartArray()))
+				{
+					return fail("handler rejected the container");
+				}
+				continue;
+			case binary::Tag::EndObject:
+			case binary::Tag::EndArray:
+			{
+				bool isObject = tag == binary::Tag::EndObject;
+				if (stack.empty() || stack.back().isObject != isObject)
+				{
+					return fail("unbalanced container");
+				}
+				if (isObject && stack.back().count % 2)
+				{
+					return fail("object member without value");
+				}
+				auto count = static_cast<rapidjson::SizeType>(
+						isObject ? stack.back().count / 2 : stack.back().count);
+				stack.pop_back();
+				if (!(isObject
+						? handler.EndObject(count)
+						: handler.EndArray(count)))
+				{
+					return fail("handler rejected the container");
+				}
+				haveRoot = stack.empty();
+				continue;
+			}
+			default:
+				return fail("unknown value tag");
+		}
+
+		if (!ok)
+		{
+			return fail("handler rejected the value");
+		}
+		if (stack.empty())
+		{
+			haveRoot = true;
+		}
+		else
+		{
+			++stack.back().count;
+		}
+	}
+
+	if (!haveRoot || !stack.empty())
+	{
+		return fail("unexpected end of data");
+	}
+
+	return true;
+}
+
+bool jsonToBinary(const std::string& json, std::string& binary);
+bool binaryToJson(const std::string& binary, std::string& json);
+
+} // namespace serdes
+} // namespace retdec
+
+#endif
@@ -13,6 +13,8 @@
 #include <rapidjson/document.h>
 #include <rapidjson/encodings.h>
 
+#include "retdec/serdes/binary.h"
+
 namespace retdec {
 namespace serdes {
 
@@ -29,6 +31,9 @@ namespace serdes {
 		const T&);                                                             \
 	template void serialize(                                                   \
 		rapidjson::PrettyWriter<rapidjson::StringBuffer, rapidjson::ASCII<>>&, \
+		const T&);                                                             \
+	template void serialize(                                                   \
+		BinaryWriter&,                                                         \
 		const T&);
 
 int64_t deserializeInt64(
@@ -0,0 +1,65 @@
+/**
+ * @file include/retdec/stacofin/prefilter.h
+ * @brief Prefilter of static code signature files.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_STACOFIN_PREFILTER_H
+#define RETDEC_STACOFIN_PREFILTER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace retdec {
+namespace stacofin {
+
+/**
+ * Decides which signature files can not match an input without scanning it
+ * with their rules.
+ *
+ * Every signature file may have an index stored alongside it (see
+ * getIndexPath()). The index contains one anchor for every rule in the file:
+ * four consecutive bytes that must be present in the scanned data if the rule
+ * matches. The prefilter makes a single pass over the scanned data and
+ * remembers (in a bit set indexed by hashes) all their 4-grams. A signature
+ * file can match only if at least one of its anchors may be present.
+ * Signature files without an index, with an index that can not describe all
+ * the rules, or with an index created for a different version of the signature
+ * file (see getDigest()), are always scanned. Indexes are written only by
+ * writeIndex() (via @c retdec-pat2yara), there is no other implementation of
+ * the index format.
+ */
+class Prefilter
+{
+	public:
+		Prefilter(const std::uint8_t* data, std::size_t size);
+
+		bool mayContain(std::uint32_t anchor) const;
+		bool mayMatch(const std::string& signaturePath) const;
+
+		static std::string getIndexPath(const std::string& signaturePath);
+		static bool getAnchor(const std::string& hexString, std::uint32_t& anchor);
+		static bool getDigest(
+				const std::string& signaturePath,
+				std::string& digest);
+		static bool writeIndex(
+				const std::string& signaturePath,
+				const std::vector<std::uint32_t>& anchors,
+				bool complete);
+		static bool readIndex(
+				const std::string& signaturePath,
+				std::vector<std::uint32_t>& anchors);
+
+	private:
+		static std::size_t hash(std::uint32_t ngram);
+
+	private:
+		/// Bit set of hashes of all 4-grams in the scanned data.
+		std::vector<std::uint64_t> _ngrams;
+};
+
+} // namespace stacofin
+} // namespace retdec
+
+#endif
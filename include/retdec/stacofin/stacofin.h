@@ -157,18 +157,61 @@ class Finder
 	private:
 		using ByteData = typename std::pair<const std::uint8_t*, std::size_t>;
 
+		/**
+		 * Disassembler resolving references. References are resolved in
+		 * parallel, every thread uses its own instance.
+		 */
+		class Disassembler
+		{
+			public:
+				Disassembler(cs_arch arch, cs_mode mode);
+				~Disassembler();
+
+				Disassembler(const Disassembler&) = delete;
+				Disassembler& operator=(const Disassembler&) = delete;
+
+				bool isValid() const;
+				bool setMode(cs_mode mode);
+
+			public:
+				csh ce = 0;
+				cs_insn* insn = nullptr;
+				cs_mode mode = CS_MODE_LITTLE_ENDIAN;
+
+				/// Reference targets already computed from reference
+				/// addresses (and disassembler modes).
+				std::map<std::pair<common::Address, cs_mode>, common::Address>
+						refTargets;
+				/// Addresses of imports that stub functions on already
+				/// disassembled addresses jump to (undefined if there is no
+				/// such stub).
+				std::map<common::Address, common::Address> stubImports;
+		};
+
 	private:
 		bool initDisassembler();
 		void solveReferences();
+		void solveReferences(Disassembler& d, DetectedFunction& f);
 
-		common::Address getAddressFromRef(common::Address ref);
+		common::Address getAddressFromRef(
+				Disassembler& d,
+				common::Address ref);
 		common::Address getAddressFromRef_x86(common::Address ref);
-		common::Address getAddressFromRef_mips(common::Address ref);
-		common::Address getAddressFromRef_arm(common::Address ref);
-		common::Address getAddressFromRef_ppc(common::Address ref);
-
-		void checkRef(Reference& ref);
-		void checkRef_x86(Reference& ref);
+		common::Address getAddressFromRef_mips(
+				Disassembler& d,
+				common::Address ref);
+		common::Address getAddressFromRef_arm(
+				Disassembler& d,
+				common::Address ref);
+		common::Address getAddressFromRef_ppc(
+				Disassembler& d,
+				common::Address ref);
+
+		void checkRef(Disassembler& d, Reference& ref);
+		void checkRef_x86(Disassembler& d, Reference& ref);
+		common::Address getStubImport_x86(
+				Disassembler& d,
+				common::Address addr);
 
 		void confirmWithoutRefs();
 		void confirmAllRefsOk(std::size_t minFncSzWithoutRefs = 0x20);
@@ -179,9 +222,8 @@ class Finder
 		const retdec::config::Config* _config = nullptr;
 		const retdec::loader::Image* _image = nullptr;
 
-		csh _ce = 0;
+		cs_arch _ceArch = CS_ARCH_ALL;
 		cs_mode _ceMode = CS_MODE_LITTLE_ENDIAN;
-		cs_insn* _ceInsn = nullptr;
 
 		std::map<common::Address, std::string> _imports;
 		std::set<std::string> _sectionNames;
@@ -0,0 +1,107 @@
+/**
+* @file include/retdec/utils/io/async_log.h
+* @brief Asynchronous backend of loggers.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_UTILS_IO_ASYNC_LOG_H
+#define RETDEC_UTILS_IO_ASYNC_LOG_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace retdec {
+namespace utils {
+namespace io {
+
+/**
+ * @brief Writes log records to their streams in a background thread.
+ *
+ * Every thread producing records has its own lock-free ring buffer
+ * (single producer, single consumer), so logging threads never contend
+ * with each other. The background flusher periodically drains all rings
+ * and writes the records ordered by the time they were produced.
+ *
+ * Records are complete pieces of text; streams they are written to must
+ * outlive them, i.e. flush() has to be called before a stream is destroyed.
+ */
+class AsyncLogWriter {
+public:
+	static AsyncLogWriter& get();
+	~AsyncLogWriter();
+
+	void start();
+	void stop();
+	static bool isRunning();
+
+	void write(std::ostream& out, std::string&& text);
+	void flush();
+
+private:
+	/**
+	 * One record waiting to be written.
+	 */
+	struct Record {
+		std::uint64_t seq = 0;
+		std::ostream* out = nullptr;
+		std::string text;
+	};
+
+	/**
+	 * Ring buffer of records of one thread.
+	 */
+	struct Ring {
+		static constexpr std::size_t Capacity = 1024;
+
+		std::array<Record, Capacity> records;
+		/// Index of the next record to be read by the consumer.
+		std::atomic<std::size_t> head{0};
+		/// Index of the next record to be written by the producer.
+		std::atomic<std::size_t> tail{0};
+		/// Owning thread has finished, ring can be removed once empty.
+		std::atomic<bool> orphaned{false};
+	};
+
+private:
+	AsyncLogWriter() = default;
+
+	Ring& threadRing();
+	bool drain();
+	void flusherLoop();
+
+private:
+	/// Kept outside of the instance so that it can be checked even during
+	/// destruction of static objects.
+	static std::atomic<bool> _running;
+	std::atomic<std::uint64_t> _seq{0};
+
+	std::mutex _ringsMutex;
+	std::vector<std::shared_ptr<Ring>> _rings;
+
+	/// Only one thread drains rings at a time.
+	std::mutex _drainMutex;
+
+	std::mutex _flusherMutex;
+	std::condition_variable _flusherCond;
+	bool _stopFlusher = false;
+	std::thread _flusher;
+};
+
+inline bool AsyncLogWriter::isRunning()
+{
+	return _running.load(std::memory_order_relaxed);
+}
+
+}
+}
+}
+
+#endif
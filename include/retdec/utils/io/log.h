@@ -9,6 +9,36 @@
 
 #include "retdec/utils/io/logger.h"
 
+/**
+ * Logging of debug/info messages can be removed at compile time by defining
+ * these macros to 0. The macros below then cost nothing.
+ */
+#ifndef RETDEC_LOG_DEBUG_ENABLED
+#define RETDEC_LOG_DEBUG_ENABLED 1
+#endif
+#ifndef RETDEC_LOG_INFO_ENABLED
+#define RETDEC_LOG_INFO_ENABLED 1
+#endif
+
+/**
+ * Logs into debug/info logger. Unlike Log::debug()/Log::info(), the logged
+ * values are neither evaluated nor formatted if the logger is not verbose
+ * or the level is disabled at compile time:
+ *
+ *   RETDEC_LOG_DEBUG << "value: " << expensive() << std::endl;
+ */
+#define RETDEC_LOG_DEBUG \
+	if (!RETDEC_LOG_DEBUG_ENABLED \
+			|| !retdec::utils::io::Log::isEnabled( \
+				retdec::utils::io::Log::Type::Debug)) {} \
+	else retdec::utils::io::Log::debug()
+
+#define RETDEC_LOG_INFO \
+	if (!RETDEC_LOG_INFO_ENABLED \
+			|| !retdec::utils::io::Log::isEnabled( \
+				retdec::utils::io::Log::Type::Info)) {} \
+	else retdec::utils::io::Log::info()
+
 namespace retdec {
 namespace utils {
 namespace io {
@@ -50,6 +80,27 @@ public:
 	 */
 	static void set(const Type& logType, Logger::Ptr&& logger);
 
+	/**
+	 * Returns true if logger for logType writes anything.
+	 */
+	static bool isEnabled(const Type& logType);
+
+	/**
+	 * Turns asynchronous logging on/off. When it is on, records are
+	 * formatted into per-thread buffers and written by a background
+	 * thread, so logging does not block the logging threads on I/O.
+	 * Turn it on for verbose output, whose amount would otherwise slow
+	 * down the work being logged.
+	 */
+	static void setAsync(bool async);
+
+	/**
+	 * Writes all records queued by asynchronous logging. Call it before
+	 * writing into the logged streams directly. In the synchronous mode,
+	 * the logged streams are flushed.
+	 */
+	static void flush();
+
 	/**
 	 * Shortcut for Logger(Log::get(Log::Type::Info)).
 	 *
@@ -12,6 +12,8 @@
 #include <sstream>
 #include <memory>
 
+#include "retdec/utils/io/async_log.h"
+
 namespace retdec {
 namespace utils {
 namespace io {
@@ -58,9 +60,28 @@ public:
 	Logger& operator << (const Action& ia);
 	Logger& operator << (const Color& lc);
 
+	bool isVerbose() const;
+	void flush();
+
+	/**
+	 * Switches all loggers between writing directly into their streams
+	 * and queueing the records for the asynchronous writer.
+	 */
+	static void setAsync(bool async);
+	static bool isAsync();
+
+protected:
+	void commit();
+
 private:
 	bool isRedirected(const std::ostream& stream) const;
 
+	/**
+	 * Returns buffer of the current thread in which the record for
+	 * the output stream is being formatted in the asynchronous mode.
+	 */
+	std::ostringstream& pending();
+
 protected:
 	std::ostream& _out;
 
@@ -74,6 +95,7 @@ protected:
 class FileLogger : public Logger {
 public:
 	FileLogger(const std::string& file, bool verbose = true);
+	~FileLogger();
 
 private:
 	std::ofstream _file;
@@ -85,7 +107,10 @@ inline Logger& Logger::operator << (const T& p)
 	if (!_verbose)
 		return *this;
 
-	_out << p;
+	if (isAsync())
+		pending() << p;
+	else
+		_out << p;
 
 	return *this;
 }
@@ -95,11 +120,28 @@ inline Logger& Logger::operator << (const Logger::StreamManipulator& p)
 	if (!_verbose)
 		return *this;
 
-	_out << p;
+	if (isAsync()) {
+		pending() << p;
+		if (p == static_cast<StreamManipulator>(std::endl<char, std::char_traits<char>>)
+				|| p == static_cast<StreamManipulator>(std::flush<char, std::char_traits<char>>))
+			commit();
+	}
+	else
+		_out << p;
 
 	return *this;
 }
 
+inline bool Logger::isVerbose() const
+{
+	return _verbose;
+}
+
+inline bool Logger::isAsync()
+{
+	return AsyncLogWriter::isRunning();
+}
+
 }
 }
 }
@@ -0,0 +1,135 @@
+/**
+* @file include/retdec/utils/profiler.h
+* @brief Lightweight instrumentation of decompilation phases.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_UTILS_PROFILER_H
+#define RETDEC_UTILS_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "retdec/utils/non_copyable.h"
+
+namespace retdec {
+namespace utils {
+
+/**
+* @brief Collects time spent in named scopes and named counters.
+*
+* Instrumentation is always on and cheap: a scope costs two reads of the
+* monotonic clock and one short critical section when it ends. Times of
+* scopes with the same name are aggregated. Individual scope executions
+* are kept only if tracing is enabled (they are needed for the Chrome trace).
+*/
+class Profiler: private NonCopyable {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	/// Aggregated times of one scope.
+	struct ScopeStats {
+		std::uint64_t calls = 0;
+		std::uint64_t totalNs = 0;
+		std::uint64_t maxNs = 0;
+	};
+
+public:
+	static Profiler &get();
+
+	/// @name Recording
+	/// @{
+	void record(const std::string &name, Clock::time_point begin,
+		Clock::time_point end);
+	std::atomic<std::uint64_t> &counter(const std::string &name);
+	void addToCounter(const std::string &name, std::uint64_t value);
+	void setTraceEnabled(bool enabled);
+	bool isTraceEnabled() const;
+	void reset();
+	/// @}
+
+	/// @name Results
+	/// @{
+	std::map<std::string, ScopeStats> getScopeStats() const;
+	std::uint64_t getCounter(const std::string &name) const;
+	void writeMetrics(std::ostream &out) const;
+	void writeChromeTrace(std::ostream &out) const;
+	bool writeMetricsFile(const std::string &path) const;
+	bool writeChromeTraceFile(const std::string &path) const;
+	/// @}
+
+private:
+	/// One execution of a scope (for the trace).
+	struct Event {
+		std::string name;
+		std::uint64_t beginNs;
+		std::uint64_t durationNs;
+		std::uint32_t thread;
+	};
+
+private:
+	Profiler();
+
+private:
+	Clock::time_point startTime;
+	std::atomic<bool> traceEnabled{false};
+
+	mutable std::mutex mutex;
+	std::map<std::string, ScopeStats> scopes;
+	/// Counters are never removed, so references to them stay valid.
+	std::map<std::string, std::unique_ptr<std::atomic<std::uint64_t>>> counters;
+	std::vector<Event> events;
+};
+
+/**
+* @brief Measures time spent in the enclosing block.
+*
+* Usage:
+* @code
+* {
+*     ProfileScope scope("fileformat/load");
+*     ...
+* }
+* @endcode
+*/
+class ProfileScope: private NonCopyable {
+public:
+	explicit ProfileScope(std::string name);
+	~ProfileScope();
+
+private:
+	std::string name;
+	Profiler::Clock::time_point begin;
+};
+
+/**
+* @brief Measures a sequence of phases, each phase lasts until the next one
+*        starts or until the object is destroyed.
+*
+* Phase names are prefixed with the given prefix and a slash.
+*/
+class ProfilePhases: private NonCopyable {
+public:
+	explicit ProfilePhases(std::string prefix);
+	~ProfilePhases();
+
+	void next(const std::string &phase);
+	void end();
+
+private:
+	std::string prefix;
+	std::string current;
+	Profiler::Clock::time_point begin;
+};
+
+} // namespace utils
+} // namespace retdec
+
+#endif
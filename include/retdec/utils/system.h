@@ -14,6 +14,8 @@ bool isLittleEndian();
 
 bool systemHasLongDouble();
 
+[[noreturn]] void exitWithoutTeardown(int status);
+
 } // namespace utils
 } // namespace retdec
 
@@ -0,0 +1,165 @@
+/**
+* @file include/retdec/utils/thread_pool.h
+* @brief Work-stealing thread pool, task groups and parallel loops.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_UTILS_THREAD_POOL_H
+#define RETDEC_UTILS_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "retdec/utils/non_copyable.h"
+
+namespace retdec {
+namespace utils {
+
+/**
+* @brief Shared flag used to cancel not yet started work.
+*
+* Copies of a token share their state, i.e. cancelling one copy cancels all of
+* them. Cancellation is cooperative: running tasks are not interrupted, they
+* may only check isCancelled() and finish early.
+*/
+class CancellationToken {
+public:
+	CancellationToken();
+
+	void cancel() const;
+	bool isCancelled() const;
+
+private:
+	std::shared_ptr<std::atomic<bool>> cancelled;
+};
+
+/**
+* @brief Pool of worker threads executing submitted tasks.
+*
+* Every worker has its own task queue. Tasks submitted from a worker go to its
+* queue and the worker executes them in the LIFO order; idle workers steal the
+* oldest tasks from queues of other workers. Tasks submitted from other
+* threads are distributed among the queues in a round-robin fashion.
+*
+* Components should use the shared global() pool (usually through TaskGroup
+* or parallelFor()) so that the number of threads used by the whole process
+* stays within the limit set by setMaxConcurrency().
+*/
+class ThreadPool: private NonCopyable {
+public:
+	using Task = std::function<void()>;
+
+	explicit ThreadPool(std::size_t threads);
+	~ThreadPool();
+
+	std::size_t getNumberOfThreads() const;
+	void submit(Task task);
+	bool runPendingTask();
+
+	static ThreadPool &global();
+	static void setMaxConcurrency(std::size_t n);
+	static std::size_t getMaxConcurrency();
+
+private:
+	/// Queue of tasks owned by one worker.
+	struct Queue {
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	bool popTask(std::size_t self, Task &task);
+	void workerLoop(std::size_t index);
+
+private:
+	std::vector<std::unique_ptr<Queue>> queues;
+	std::vector<std::thread> workers;
+	std::atomic<std::size_t> nextQueue{0};
+	std::atomic<std::size_t> pending{0};
+	std::mutex sleepMutex;
+	std::condition_variable sleepCond;
+	bool stopping = false;
+
+	/// Maximal number of concurrently running threads (0 = all hardware threads).
+	static std::atomic<std::size_t> maxConcurrency;
+};
+
+/**
+* @brief Group of tasks that can be waited for as a whole.
+*
+* If a task throws, the group is cancelled (tasks that have not started yet are
+* skipped) and the first exception is rethrown from wait(). Threads waiting for
+* a group execute pending tasks of the pool in the meantime, so task groups may
+* be nested.
+*/
+class TaskGroup: private NonCopyable {
+public:
+	explicit TaskGroup(
+		ThreadPool &pool = ThreadPool::global(),
+		CancellationToken token = CancellationToken());
+	~TaskGroup();
+
+	void run(ThreadPool::Task task);
+	void wait();
+
+	void cancel();
+	bool isCancelled() const;
+	const CancellationToken &getCancellationToken() const;
+
+private:
+	/// State shared with the submitted tasks.
+	struct State {
+		std::mutex mutex;
+		std::condition_variable cond;
+		std::size_t unfinished = 0;
+		std::exception_ptr exception;
+	};
+
+private:
+	ThreadPool &pool;
+	CancellationToken token;
+	std::shared_ptr<State> state;
+};
+
+void parallelForRanges(std::size_t begin, std::size_t end,
+	const std::function<void(std::size_t, std::size_t)> &fnc,
+	const CancellationToken &token = CancellationToken(),
+	std::size_t grain = 0);
+
+/**
+* @brief Calls @a fnc for every index from <tt>[begin, end)</tt> in parallel.
+*
+* @param[in] begin First index.
+* @param[in] end Index after the last one.
+* @param[in] fnc Function called with each index. It has to be thread-safe.
+* @param[in] token Once cancelled, no more indexes are processed.
+* @param[in] grain Number of indexes processed by one task
+*                  (0 = chosen automatically).
+*
+* Indexes are split into contiguous chunks executed by the global thread pool.
+* The first exception thrown from @a fnc is rethrown.
+*/
+template<typename Fnc>
+void parallelFor(std::size_t begin, std::size_t end, Fnc &&fnc,
+		const CancellationToken &token = CancellationToken(),
+		std::size_t grain = 0) {
+	parallelForRanges(begin, end,
+		[&fnc, &token](std::size_t b, std::size_t e) {
+			for (std::size_t i = b; i < e && !token.isCancelled(); ++i) {
+				fnc(i);
+			}
+		},
+		token, grain);
+}
+
+} // namespace utils
+} // namespace retdec
+
+#endif
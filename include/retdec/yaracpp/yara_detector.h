@@ -7,6 +7,7 @@
 #ifndef RETDEC_YARACPP_YARA_DETECTOR_H
 #define RETDEC_YARACPP_YARA_DETECTOR_H
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -86,6 +87,8 @@ class YaraDetector
 		bool stateIsValid = true;
 		/// indicates whether text files need recompilation
 		bool needsRecompilation = true;
+		/// indicates whether any text rules were added
+		bool hasTextRules = false;
 
 		/// @name Static auxiliary methods
 		/// @{
@@ -104,6 +107,11 @@ class YaraDetector
 				bool storeAllRules = false
 		);
 		YR_RULES* getCompiledRules();
+		bool analyzeMemory(
+				const std::uint8_t *bytes,
+				std::size_t size,
+				CallbackSettings &settings
+		) const;
 		/// @}
 	public:
 		YaraDetector();
@@ -117,6 +125,8 @@ class YaraDetector
 				const std::string &nameSpace = std::string()
 		);
 		bool isInValidState() const;
+		bool compileRules();
+		static std::size_t getMaxConcurrentScans();
 		/// @}
 
 		/// @name Detection methods
@@ -129,6 +139,17 @@ class YaraDetector
 				std::vector<std::uint8_t> &bytes,
 				bool storeAllRules = false
 		);
+		bool analyze(
+				const std::uint8_t *bytes,
+				std::size_t size,
+				std::vector<YaraRule> &detected
+		) const;
+		bool analyze(
+				const std::uint8_t *bytes,
+				std::size_t size,
+				std::vector<YaraRule> &detected,
+				std::vector<YaraRule> &undetected
+		) const;
 		const std::vector<YaraRule>& getDetectedRules() const;
 		const std::vector<YaraRule>& getUndetectedRules() const;
 		/// @}
@@ -43,6 +43,12 @@ bool ClassHierarchyAnalysis::runOnModule(Module& M)
 		LOG << "[ABORT] config file is not available\n";
 		return false;
 	}
+	if (config->getConfig().parameters.isDemandDriven())
+	{
+		// Vtables and constructors are not decoded, only selected functions.
+		LOG << "[ABORT] demand-driven selective decompilation\n";
+		return false;
+	}
 
 	ctorDtor.runOnModule(&M, config, image);
 
@@ -8,6 +8,7 @@
 #include <llvm/IR/PatternMatch.h>
 
 #include "retdec/utils/conversion.h"
+#include "retdec/utils/profiler.h"
 #include "retdec/utils/string.h"
 #include "retdec/utils/io/log.h"
 #include "retdec/bin2llvmir/optimizations/decoder/decoder.h"
@@ -362,6 +363,13 @@ Decoder::translate(ByteData& bytes, common::Address& addr, llvm::IRBuilder<>& ir
 		_c2l->modifyBasicMode(CS_MODE_MIPS32);
 	}
 
+	if (!res.failed())
+	{
+		static auto& translated = utils::Profiler::get().counter(
+				"decoder.instructions");
+		translated.fetch_add(1, std::memory_order_relaxed);
+	}
+
 	return res;
 }
 
@@ -5,6 +5,7 @@
 */
 
 #include "retdec/bin2llvmir/optimizations/decoder/decoder.h"
+#include "retdec/utils/profiler.h"
 #include "retdec/utils/string.h"
 
 #include "retdec/loader/loader/elf/elf_image.h"
@@ -193,7 +194,10 @@ void Decoder::initRanges()
 	a = arch.isPpc() ? 4 : a;
 	_ranges.setArchitectureInstructionAlignment(a);
 
-	if (_config->getConfig().parameters.isSelectedDecodeOnly())
+	auto& params = _config->getConfig().parameters;
+	_demandDriven = params.isDemandDriven();
+
+	if (params.isSelectedDecodeOnly() || _demandDriven)
 	{
 		initAllowedRangesWithConfig();
 	}
@@ -343,6 +347,7 @@ void Decoder::initAllowedRangesWithConfig()
 	for (auto &p : _config->getConfig().parameters.selectedRanges)
 	{
 		_ranges.addPrimary(p);
+		_selectedRanges.insert(p);
 		LOG << "\t" << "[+] selected range @ " << p << std::endl;
 
 		if (auto* jt = _jumpTargets.push(
@@ -382,6 +387,7 @@ void Decoder::initAllowedRangesWithConfig()
 			Address end = df.getEnd();
 
 			_ranges.addPrimary(start, end);
+			_selectedRanges.insert(start, end);
 			LOG << "\t" << "[+] selected range from debug @ "
 					<< AddressRange(start, end) << std::endl;
 
@@ -498,6 +504,7 @@ void Decoder::initAllowedRangesWithConfig()
 			if (fIt != selectedFs.end() && foundFs.find(*fIt) == foundFs.end())
 			{
 				_ranges.addPrimary(start, end);
+				_selectedRanges.insert(start, end);
 				LOG << "\t" << "[+] selected range from symbol: "
 						<< start << std::endl;
 
@@ -534,6 +541,7 @@ void Decoder::initAllowedRangesWithConfig()
 	if (!_ranges.primaryEmpty() && plt)
 	{
 		_ranges.addPrimary(plt->getAddress(), plt->getPhysicalEndAddress());
+		_selectedRanges.insert(plt->getAddress(), plt->getPhysicalEndAddress());
 	}
 }
 
@@ -547,6 +555,15 @@ void Decoder::initJumpTargets()
 	{
 		initStaticCode();
 	}
+	if (_demandDriven)
+	{
+		// Selected functions were already added in
+		// initAllowedRangesWithConfig(). Do not seed jump targets from the
+		// rest of the program, only imports are needed to resolve calls.
+		initJumpTargetsExterns();
+		initJumpTargetsImports();
+		return;
+	}
 	initJumpTargetsEntryPoint();
 	initJumpTargetsExterns();
 	initJumpTargetsImports();
@@ -935,8 +952,13 @@ void Decoder::initStaticCode()
 	LOG << "\n" << "initStaticCode():" << std::endl;
 
 	stacofin::Finder SCA;
-	SCA.searchAndConfirm(*_image->getImage(), _config->getConfig());
+	{
+		utils::ProfileScope scope("stacofin");
+		SCA.searchAndConfirm(*_image->getImage(), _config->getConfig());
+	}
 
+	bool skipLifting = _config->getConfig().parameters.isSkipStaticCodeLifting()
+			|| _demandDriven;
 	for (auto& p : SCA.getConfirmedDetections())
 	{
 		auto* sf = p.second;
@@ -957,7 +979,21 @@ void Decoder::initStaticCode()
 			}
 		}
 
-		if (auto* jt = _jumpTargets.push(
+		if (skipLifting && canSkipStaticCodeLifting(sf))
+		{
+			auto* nf = createFunction(sf->getAddress(), true);
+			_staticFncs.insert(sf->getAddress());
+			if (sf->isTerminating())
+			{
+				_terminatingFncs.insert(nf);
+			}
+			addFunctionSize(nf, sf->size);
+			_ranges.remove(sf->getAddress(), sf->getAddress() + sf->size);
+
+			LOG << "\t" << "[+] " << sf->getAddress() << " @ "
+					<< nf->getName().str() << " (declaration)" << std::endl;
+		}
+		else if (auto* jt = _jumpTargets.push(
 				sf->getAddress(),
 				JumpTarget::eType::STATIC_CODE,
 				sf->isThumb() ? CS_MODE_THUMB : _c2l->getBasicMode(),
@@ -988,6 +1024,37 @@ void Decoder::initStaticCode()
 	}
 }
 
+/**
+ * \return \c True if statically linked function \p sf does not have to be
+ * decoded, i.e. it can be represented by a declaration whose body is not
+ * lifted at all.
+ *
+ * The function containing the entry point is always decoded because its body
+ * is used to find the main function. In the demand-driven selective
+ * decompilation, only functions in the selected ranges are decoded.
+ */
+bool Decoder::canSkipStaticCodeLifting(const stacofin::DetectedFunction* sf)
+{
+	Address start = sf->getAddress();
+	if (start.isUndefined() || sf->size == 0 || getFunctionAtAddress(start))
+	{
+		return false;
+	}
+
+	if (_demandDriven)
+	{
+		return !_selectedRanges.contains(start);
+	}
+
+	auto ep = _config->getConfig().parameters.getEntryPoint();
+	if (ep.isDefined() && start <= ep && ep < start + sf->size)
+	{
+		return false;
+	}
+
+	return _image->getImage()->hasDataOnAddress(start);
+}
+
 void Decoder::initVtables()
 {
 	LOG << "\n" << "initVtables():" << std::endl;
@@ -1041,6 +1108,13 @@ void Decoder::initConfigFunctions()
 
 		Address start = p.second;
 		Address end = getFunctionEndAddress(f);
+		// Declarations of statically linked functions that were not decoded
+		// keep the size of their code (see initStaticCode()).
+		auto szIt = _fnc2sz.find(f);
+		if (f->isDeclaration() && szIt != _fnc2sz.end())
+		{
+			end = start + szIt->second;
+		}
 		end = end > start ? end : Address(start + 1);
 
 		// TODO: this is really bad, should be solved by better design of config
@@ -104,6 +104,8 @@ llvm::Function* Decoder::getFunctionContainingAddress(common::Address a)
 
 /**
  * Create function at address \p a.
+ * In the demand-driven selective decompilation, functions outside the
+ * selected ranges are always created as declarations.
  * \return Created function.
  */
 llvm::Function* Decoder::createFunction(common::Address a, bool declaration)
@@ -141,6 +143,11 @@ llvm::Function* Decoder::createFunction(common::Address a, bool declaration)
 		fl.insert(fl.begin(), f);
 	}
 
+	if (_demandDriven && !_selectedRanges.contains(a))
+	{
+		declaration = true;
+	}
+
 	if (!declaration && known)
 	{
 		createBasicBlock(a, f);
@@ -542,34 +542,82 @@ bool loadFromBitcastPointer(llvm::Instruction* insn)
 /**
  * Order here is important.
  * More specific patterns must go first, more general later.
+ *
+ * Every rule is listed with opcodes of the only instructions it can change,
+ * so that instructions do not have to be matched against all the rules.
  */
-std::vector<bool (*)(llvm::Instruction*)> optimizations =
+const std::vector<std::pair<Rule, std::vector<unsigned>>> optimizations =
 {
-		&addZero,
-		&subZero,
-		&truncZext,
-		&xorLoadXX,
-		&xorXX,
-		&xor_i1,
-		&and_i1,
-		&orAndLoadXX,
-		&orAndXX,
-		&addSequence,
-		&castSequenceWrapper,
-		&storeToBitcastPointer,
-		&loadFromBitcastPointer,
+		{{"addZero", &addZero}, {Instruction::Add}},
+		{{"subZero", &subZero}, {Instruction::Sub}},
+		{{"truncZext", &truncZext}, {Instruction::ZExt}},
+		{{"xorLoadXX", &xorLoadXX}, {Instruction::Xor}},
+		{{"xorXX", &xorXX}, {Instruction::Xor}},
+		{{"xor_i1", &xor_i1}, {Instruction::Xor}},
+		{{"and_i1", &and_i1}, {Instruction::And}},
+		{{"orAndLoadXX", &orAndLoadXX}, {Instruction::Or, Instruction::And}},
+		{{"orAndXX", &orAndXX}, {Instruction::Or, Instruction::And}},
+		{{"addSequence", &addSequence}, {Instruction::Add}},
+		{{"castSequence", &castSequenceWrapper}, {
+				Instruction::Trunc,
+				Instruction::ZExt,
+				Instruction::SExt,
+				Instruction::FPToUI,
+				Instruction::FPToSI,
+				Instruction::UIToFP,
+				Instruction::SIToFP,
+				Instruction::FPTrunc,
+				Instruction::FPExt,
+				Instruction::PtrToInt,
+				Instruction::IntToPtr,
+				Instruction::BitCast,
+				Instruction::AddrSpaceCast}},
+		{{"storeToBitcastPointer", &storeToBitcastPointer}, {Instruction::Store}},
+		{{"loadFromBitcastPointer", &loadFromBitcastPointer}, {Instruction::Load}},
 };
 
-bool optimize(llvm::Instruction* insn)
+/**
+ * Get rules that may change instructions with the given @a opcode,
+ * in the order in which they should be tried.
+ */
+const std::vector<const Rule*>& getRules(unsigned opcode)
+{
+	static const auto rulesByOpcode = []()
+	{
+		std::vector<std::vector<const Rule*>> res(Instruction::OtherOpsEnd);
+		for (auto& o : optimizations)
+		{
+			for (auto op : o.second)
+			{
+				res[op].push_back(&o.first);
+			}
+		}
+		return res;
+	}();
+	static const std::vector<const Rule*> noRules;
+
+	return opcode < rulesByOpcode.size() ? rulesByOpcode[opcode] : noRules;
+}
+
+/**
+ * Try to optimize @a insn.
+ * @return Rule which changed the instruction, or @c nullptr if there was none.
+ */
+const Rule* optimizeWithRule(llvm::Instruction* insn)
 {
-	for (auto& f : optimizations)
+	for (auto* r : getRules(insn->getOpcode()))
 	{
-		if (f(insn))
+		if (r->apply(insn))
 		{
-			return true;
+			return r;
 		}
 	}
-	return false;
+	return nullptr;
+}
+
+bool optimize(llvm::Instruction* insn)
+{
+	return optimizeWithRule(insn) != nullptr;
 }
 
 } // namespace inst_opt
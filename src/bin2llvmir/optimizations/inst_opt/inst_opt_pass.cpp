@@ -4,18 +4,217 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <deque>
+#include <unordered_set>
+
+#include <llvm/ADT/Hashing.h>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ADT/SmallVector.h>
 #include <llvm/IR/InstIterator.h>
+#include <llvm/IR/ValueHandle.h>
 
 #include "retdec/bin2llvmir/optimizations/inst_opt/inst_opt_pass.h"
 #include "retdec/bin2llvmir/optimizations/inst_opt/inst_opt.h"
+#include "retdec/bin2llvmir/utils/debug.h"
+#include "retdec/utils/profiler.h"
 
 using namespace llvm;
 
 namespace retdec {
 namespace bin2llvmir {
 
+namespace {
+
+const bool debug_enabled = false;
+
+/**
+ * Fingerprint of all the instruction properties the rules look at.
+ */
+std::size_t fingerprint(const Instruction* i)
+{
+	return hash_combine(
+			i->getOpcode(),
+			i->getType(),
+			hash_combine_range(i->value_op_begin(), i->value_op_end()));
+}
+
+/**
+ * FIFO of instructions to (re)visit. Every instruction is in it at most once
+ * and erased instructions are dropped from it automatically.
+ */
+class Worklist
+{
+	public:
+		/**
+		 * Push @a i into the worklist if it is not already there.
+		 */
+		void push(Instruction* i)
+		{
+			if (_queued.insert(i).second)
+			{
+				_list.emplace_back(i, this);
+			}
+		}
+
+		/**
+		 * Push @a i and all its users into the worklist. Users which are
+		 * casts are followed transitively, because cast sequences are matched
+		 * across multiple instructions.
+		 */
+		void pushWithUsers(Instruction* i)
+		{
+			SmallVector<Instruction*, 8> todo = {i};
+			SmallPtrSet<Instruction*, 8> seen;
+			seen.insert(i);
+			push(i);
+
+			while (!todo.empty())
+			{
+				auto* c = todo.pop_back_val();
+				for (auto* u : c->users())
+				{
+					auto* ui = dyn_cast<Instruction>(u);
+					if (ui == nullptr || !seen.insert(ui).second)
+					{
+						continue;
+					}
+					push(ui);
+					if (isa<CastInst>(ui))
+					{
+						todo.push_back(ui);
+					}
+				}
+			}
+		}
+
+		/**
+		 * Pop the oldest instruction, @c nullptr if the worklist is empty.
+		 */
+		Instruction* pop()
+		{
+			while (!_list.empty())
+			{
+				auto* i = cast_or_null<Instruction>(static_cast<Value*>(_list.front()));
+				_list.pop_front();
+				if (i)
+				{
+					_queued.erase(i);
+					return i;
+				}
+			}
+			return nullptr;
+		}
+
+	private:
+		/**
+		 * Forgets its instruction when the instruction is erased.
+		 */
+		class Handle : public CallbackVH
+		{
+			public:
+				Handle(Instruction* i, Worklist* worklist) :
+						CallbackVH(i),
+						_worklist(worklist)
+				{
+
+				}
+
+				void deleted() override
+				{
+					_worklist->_queued.erase(getValPtr());
+					setValPtr(nullptr);
+				}
+
+			private:
+				Worklist* _worklist = nullptr;
+		};
+
+	private:
+		std::deque<Handle> _list;
+		std::unordered_set<Value*> _queued;
+};
+
+/**
+ * Try to optimize @a insn. If some rule applies, push all the instructions
+ * that might be affected by the change into @a worklist.
+ * @return Applied rule, or @c nullptr if there was none.
+ */
+const inst_opt::Rule* optimize(Instruction* insn, Worklist& worklist)
+{
+	auto& rules = inst_opt::getRules(insn->getOpcode());
+	if (rules.empty())
+	{
+		return nullptr;
+	}
+
+	// Rules may erase the instruction and its operands, and insert new
+	// instructions right before it. Rules never erase the following
+	// instruction and they do not change instructions terminating blocks.
+	BasicBlock* bb = insn->getParent();
+	WeakVH prev(insn->getPrevNode());
+	Instruction* next = insn->getNextNode();
+	SmallVector<WeakVH, 8> operands;
+	for (auto* op : insn->operand_values())
+	{
+		if (isa<Instruction>(op))
+		{
+			operands.emplace_back(op);
+		}
+	}
+	SmallVector<WeakVH, 8> users;
+	for (auto* u : insn->users())
+	{
+		if (isa<Instruction>(u))
+		{
+			users.emplace_back(u);
+		}
+	}
+
+	const inst_opt::Rule* applied = nullptr;
+	for (auto* r : rules)
+	{
+		if (r->apply(insn))
+		{
+			applied = r;
+			break;
+		}
+	}
+	if (applied == nullptr)
+	{
+		return nullptr;
+	}
+
+	// Changed and newly created instructions.
+	auto* first = prev ? cast<Instruction>(prev)->getNextNode() : &bb->front();
+	for (auto* i = first; i && i != next; i = i->getNextNode())
+	{
+		worklist.pushWithUsers(i);
+	}
+	for (auto& op : operands)
+	{
+		if (op)
+		{
+			worklist.push(cast<Instruction>(op));
+		}
+	}
+	for (auto& u : users)
+	{
+		if (u)
+		{
+			worklist.pushWithUsers(cast<Instruction>(u));
+		}
+	}
+
+	return applied;
+}
+
+} // anonymous namespace
+
 char InstructionOptimizer::ID = 0;
 
+std::map<const llvm::Module*, InstructionOptimizer::Fingerprints>
+		InstructionOptimizer::_fingerprints;
+
 static RegisterPass<InstructionOptimizer> X(
 		"retdec-inst-opt",
 		"LLVM instruction optimization",
@@ -41,21 +240,83 @@ bool InstructionOptimizer::runOnModuleCustom(llvm::Module& m)
 	return run();
 }
 
+/**
+ * @return Number of applications of each rule in the last run.
+ */
+const std::map<std::string, std::size_t>& InstructionOptimizer::getRuleHits() const
+{
+	return _ruleHits;
+}
+
+/**
+ * @return Number of instructions taken from the worklist in the last run.
+ *         Instructions visited multiple times are counted multiple times.
+ */
+std::size_t InstructionOptimizer::getNumberOfVisitedInstructions() const
+{
+	return _visited;
+}
+
+/**
+ * Forget fingerprints of instructions from all the previous runs.
+ */
+void InstructionOptimizer::clear()
+{
+	_fingerprints.clear();
+}
+
 bool InstructionOptimizer::run()
 {
-	bool changed = false;
+	_ruleHits.clear();
+	_visited = 0;
+	auto& fingerprints = _fingerprints[_module];
 
+	// Start only from instructions that changed since the last run.
+	//
+	Worklist worklist;
 	for (Function& f : *_module)
-	for (auto it = inst_begin(&f), eIt = inst_end(&f); it != eIt;)
+	for (Instruction& i : instructions(&f))
+	{
+		auto it = fingerprints.find(&i);
+		if (it == fingerprints.end() || it->second != fingerprint(&i))
+		{
+			worklist.pushWithUsers(&i);
+		}
+	}
+
+	bool changed = false;
+	while (auto* insn = worklist.pop())
 	{
-		Instruction* insn = &*it;
-		++it;
+		++_visited;
+		if (auto* r = optimize(insn, worklist))
+		{
+			++_ruleHits[r->name];
+			changed = true;
+		}
+	}
 
-		changed |= inst_opt::optimize(insn);
+	// All the instructions are optimized now, remember them. Fingerprints
+	// of erased instructions were already dropped.
+	//
+	for (Function& f : *_module)
+	for (Instruction& i : instructions(&f))
+	{
+		fingerprints[&i] = fingerprint(&i);
 	}
 
+	reportRuleHits();
 	return changed;
 }
 
+void InstructionOptimizer::reportRuleHits() const
+{
+	LOG << "\n" << "InstructionOptimizer rule hits:" << std::endl;
+	for (auto& h : _ruleHits)
+	{
+		LOG << "\t" << h.first << " : " << h.second << std::endl;
+		utils::Profiler::get().addToCounter("inst_opt." + h.first, h.second);
+	}
+}
+
 } // namespace bin2llvmir
 } // namespace retdec
@@ -101,6 +101,7 @@ bool MainDetection::run()
 bool MainDetection::skipAnalysis()
 {
 	return _config->getConfig().parameters.getMainAddress().isDefined()
+			|| _config->getConfig().parameters.isDemandDriven()
 			|| _config->getConfig().fileType.isShared();
 }
 
@@ -198,6 +198,10 @@ void ParamReturn::collectExtraData(DataFlowEntry* dataflow) const
 		auto isDecoded = config.parameters.selectedRanges.contains(rdFnc);
 		dataflow->setIsFullyDecoded(isDecoded);
 	}
+	else if (config.parameters.isDemandDriven()) {
+		// Functions outside the selection are only declared.
+		dataflow->setIsFullyDecoded(!fnc->isDeclaration());
+	}
 
 	// LTI info.
 	//
@@ -0,0 +1,296 @@
+/**
+ * @file src/bin2llvmir/optimizations/provider_init/crypto_patterns.cpp
+ * @brief Detection of crypto patterns in the loaded file image.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <algorithm>
+#include <regex>
+
+#include "retdec/bin2llvmir/optimizations/provider_init/crypto_patterns.h"
+#include "retdec/utils/profiler.h"
+#include "retdec/utils/string.h"
+#include "retdec/utils/thread_pool.h"
+
+using namespace retdec::loader;
+using namespace retdec::yaracpp;
+
+namespace retdec {
+namespace bin2llvmir {
+
+namespace {
+
+/**
+ * Crypto pattern created from a YARA rule together with information about
+ * its matches parsed from the rule name.
+ */
+struct CryptoRule
+{
+	common::Pattern pattern;
+	bool isInt = false;
+	bool isFlt = false;
+	unsigned long long entrySize = 0;
+};
+
+CryptoRule createCryptoRule(const YaraRule& rule)
+{
+	CryptoRule res;
+	auto& pattern = res.pattern;
+
+	const auto name = rule.getName();
+	pattern = common::Pattern::crypto(name, "", name);
+	const auto *descMeta = rule.getMeta("description");
+	if(!descMeta)
+	{
+		descMeta = rule.getMeta("desc");
+	}
+	pattern.setDescription(descMeta ? descMeta->getStringValue() : name);
+	std::smatch rMatch, rMatchFlt;
+	bool entrySize = false;
+	if(regex_search(name, rMatch, std::regex("__([0-9]+)_(big|lil|byt)_")))
+	{
+		entrySize = true;
+		if(rMatch[2] == "lil")
+		{
+			pattern.setIsEndianLittle();
+		}
+		else if(rMatch[2] == "big")
+		{
+			pattern.setIsEndianBig();
+		}
+
+		if(regex_search(name, rMatchFlt, std::regex("__flt([0-9]+)___")))
+		{
+			res.isFlt = true;
+			pattern.setName(rMatchFlt.prefix());
+			if(!descMeta)
+			{
+				pattern.setDescription(rMatchFlt.prefix());
+			}
+		}
+		else
+		{
+			res.isInt = true;
+			pattern.setName(rMatch.prefix());
+			if(!descMeta)
+			{
+				pattern.setDescription(rMatch.prefix());
+			}
+		}
+	}
+
+	std::string descInfo;
+	if(entrySize
+			&& rMatch.size() > 1
+			&& utils::strToNum(rMatch[1], res.entrySize, std::dec))
+	{
+		descInfo.push_back('(');
+		descInfo += rMatch[1];
+		descInfo += "-bit";
+	}
+	else
+	{
+		res.entrySize = 0;
+	}
+
+	if(pattern.isEndianLittle() || pattern.isEndianBig())
+	{
+		if(descInfo.empty())
+		{
+			descInfo.push_back('(');
+		}
+		else
+		{
+			descInfo += ", ";
+		}
+		descInfo += (pattern.isEndianLittle() ? "little" : "big");
+		descInfo += " endian";
+	}
+
+	if(!descInfo.empty())
+	{
+		if(descInfo[0] == '(')
+		{
+			descInfo.push_back(')');
+		}
+		pattern.setDescription(pattern.getDescription() + " " + descInfo);
+	}
+
+	return res;
+}
+
+/**
+ * Add matches of the @a rule found in segment @a seg into @a cr pattern.
+ * Match offsets reported by YARA are relative to the start of the segment.
+ */
+void addCryptoMatches(
+		CryptoRule& cr,
+		const YaraRule& rule,
+		const Segment* seg,
+		std::size_t byteLength)
+{
+	auto* secSeg = seg->getSecSeg();
+	for(const auto& match : rule.getMatches())
+	{
+		common::Pattern::Match patMatch;
+		if(cr.isFlt)
+		{
+			patMatch.setIsTypeFloatingPoint();
+		}
+		else if(cr.isInt)
+		{
+			patMatch.setIsTypeIntegral();
+		}
+		patMatch.setSize(match.getDataSize());
+
+		if(cr.entrySize)
+		{
+			patMatch.setEntrySize(cr.entrySize / byteLength);
+		}
+		if(secSeg)
+		{
+			patMatch.setOffset(secSeg->getOffset() + match.getOffset());
+		}
+		patMatch.setAddress(seg->getAddress() + match.getOffset());
+		cr.pattern.matches.push_back(patMatch);
+	}
+}
+
+} // anonymous namespace
+
+std::map<
+		std::set<std::string>,
+		std::unique_ptr<yaracpp::YaraDetector>> CryptoPatterns::_rules;
+std::mutex CryptoPatterns::_rulesMutex;
+
+/**
+ * Scan @a image for crypto patterns from @a config's crypto pattern paths
+ * and add all the detected patterns into @a config (and its pattern index).
+ * @param image    Loaded file image to scan.
+ * @param config   Config with the rule paths and patterns container.
+ * @param parallel Scan image segments concurrently.
+ * @return Number of patterns added to @a config.
+ */
+std::size_t CryptoPatterns::detect(
+		FileImage* image,
+		Config* config,
+		bool parallel)
+{
+	auto& paths = config->getConfig().parameters.cryptoPatternPaths;
+	if (paths.empty())
+	{
+		return 0;
+	}
+
+	// Rule compilation (on the first use of the paths) is measured too.
+	utils::ProfileScope profileScope("crypto patterns");
+	auto* yara = getRules(paths);
+	if (yara == nullptr)
+	{
+		return 0;
+	}
+
+	// Only segments with data initialized from the file are scanned.
+	//
+	std::vector<const Segment*> segs;
+	for (auto& seg : image->getImage()->getSegments())
+	{
+		auto* secSeg = seg->getSecSeg();
+		if ((secSeg && secSeg->isBss())
+				|| seg->getRawData().first == nullptr
+				|| seg->getRawData().second == 0)
+		{
+			continue;
+		}
+		segs.push_back(seg.get());
+	}
+
+	std::vector<std::vector<YaraRule>> detected(segs.size());
+	auto scan = [&](std::size_t i)
+	{
+		auto data = segs[i]->getRawData();
+		yara->analyze(data.first, data.second, detected[i]);
+		utils::Profiler::get().addToCounter("crypto.bytes_scanned", data.second);
+	};
+
+	if (parallel)
+	{
+		utils::parallelFor(0, segs.size(), scan, utils::CancellationToken(), 1);
+	}
+	else
+	{
+		for (std::size_t i = 0; i < segs.size(); ++i)
+		{
+			scan(i);
+		}
+	}
+
+	// Merge matches of the same rule from all segments into one pattern.
+	// Results are merged in the segments' order to stay deterministic.
+	//
+	std::vector<CryptoRule> rules;
+	std::map<std::string, std::size_t> rule2idx;
+	auto byteLength = image->getFileFormat()->getByteLength();
+	for (std::size_t i = 0; i < segs.size(); ++i)
+	{
+		for (auto& rule : detected[i])
+		{
+			auto it = rule2idx.find(rule.getName());
+			if (it == rule2idx.end())
+			{
+				it = rule2idx.emplace(rule.getName(), rules.size()).first;
+				rules.push_back(createCryptoRule(rule));
+			}
+			addCryptoMatches(rules[it->second], rule, segs[i], byteLength);
+		}
+	}
+
+	auto& patterns = config->getConfig().patterns;
+	patterns.reserve(patterns.size() + rules.size());
+	for (auto& r : rules)
+	{
+		config->addPattern(std::move(r.pattern));
+	}
+
+	return rules.size();
+}
+
+/**
+ * Drop all the cached compiled rule sets.
+ */
+void CryptoPatterns::clear()
+{
+	std::lock_guard<std::mutex> lock(_rulesMutex);
+	_rules.clear();
+}
+
+/**
+ * Get compiled rules from the rule files @a paths. Rules are compiled only
+ * the first time the set of paths is requested, then they are reused.
+ * @return Compiled rules or @c nullptr if they can not be compiled.
+ */
+const yaracpp::YaraDetector* CryptoPatterns::getRules(
+		const std::set<std::string>& paths)
+{
+	std::lock_guard<std::mutex> lock(_rulesMutex);
+
+	auto it = _rules.find(paths);
+	if (it == _rules.end())
+	{
+		auto yara = std::make_unique<yaracpp::YaraDetector>();
+		for (auto& p : paths)
+		{
+			yara->addRuleFile(p);
+		}
+		if (!yara->isInValidState() || !yara->compileRules())
+		{
+			yara = nullptr;
+		}
+		it = _rules.emplace(paths, std::move(yara)).first;
+	}
+
+	return it->second.get();
+}
+
+} // namespace bin2llvmir
+} // namespace retdec
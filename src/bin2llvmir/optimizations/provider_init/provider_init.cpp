@@ -4,12 +4,12 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
-#include <regex>
-
 #include <llvm/Support/CommandLine.h>
 
 #include "retdec/utils/io/log.h"
 #include "retdec/bin2llvmir/analyses/symbolic_tree.h"
+#include "retdec/bin2llvmir/optimizations/inst_opt/inst_opt_pass.h"
+#include "retdec/bin2llvmir/optimizations/provider_init/crypto_patterns.h"
 #include "retdec/bin2llvmir/optimizations/provider_init/provider_init.h"
 #include "retdec/bin2llvmir/providers/abi/abi.h"
 #include "retdec/bin2llvmir/providers/asm_instruction.h"
@@ -21,8 +21,8 @@
 #include "retdec/bin2llvmir/providers/lti.h"
 #include "retdec/bin2llvmir/providers/names.h"
 #include "retdec/cpdetect/cpdetect.h"
+#include "retdec/utils/profiler.h"
 #include "retdec/utils/string.h"
-#include "retdec/yaracpp/yara_detector.h"
 
 using namespace llvm;
 using namespace retdec::utils::io;
@@ -30,124 +30,6 @@ using namespace retdec::utils::io;
 namespace retdec {
 namespace bin2llvmir {
 
-common::Pattern saveCryptoRule(
-		const yaracpp::YaraRule &rule,
-		retdec::fileformat::FileFormat* file)
-{
-	const auto name = rule.getName();
-	auto pattern = common::Pattern::crypto(name, "", name);
-	const auto *descMeta = rule.getMeta("description");
-	if(!descMeta)
-	{
-		descMeta = rule.getMeta("desc");
-	}
-	pattern.setDescription(descMeta ? descMeta->getStringValue() : name);
-	std::smatch rMatch, rMatchFlt;
-	bool isInt = false, isFlt = false, entrySize = false;
-	if(regex_search(name, rMatch, std::regex("__([0-9]+)_(big|lil|byt)_")))
-	{
-		entrySize = true;
-		if(rMatch[2] == "lil")
-		{
-			pattern.setIsEndianLittle();
-		}
-		else if(rMatch[2] == "big")
-		{
-			pattern.setIsEndianBig();
-		}
-
-		if(regex_search(name, rMatchFlt, std::regex("__flt([0-9]+)___")))
-		{
-			isFlt = true;
-			pattern.setName(rMatchFlt.prefix());
-			if(!descMeta)
-			{
-				pattern.setDescription(rMatchFlt.prefix());
-			}
-		}
-		else
-		{
-			isInt = true;
-			pattern.setName(rMatch.prefix());
-			if(!descMeta)
-			{
-				pattern.setDescription(rMatch.prefix());
-			}
-		}
-	}
-
-	std::string descInfo;
-	unsigned long long entrySizeValue = 0;
-	if(entrySize
-			&& rMatch.size() > 1
-			&& utils::strToNum(rMatch[1], entrySizeValue, std::dec))
-	{
-		descInfo.push_back('(');
-		descInfo += rMatch[1];
-		descInfo += "-bit";
-	}
-	else
-	{
-		entrySize = false;
-	}
-
-	if(pattern.isEndianLittle() || pattern.isEndianBig())
-	{
-		if(descInfo.empty())
-		{
-			descInfo.push_back('(');
-		}
-		else
-		{
-			descInfo += ", ";
-		}
-		descInfo += (pattern.isEndianLittle() ? "little" : "big");
-		descInfo += " endian";
-	}
-
-	if(!descInfo.empty())
-	{
-		if(descInfo[0] == '(')
-		{
-			descInfo.push_back(')');
-		}
-		pattern.setDescription(pattern.getDescription() + " " + descInfo);
-	}
-
-	for(std::size_t i = 0, e = rule.getNumberOfMatches(); i < e; ++i)
-	{
-		const auto *match = rule.getMatch(i);
-		if(!match)
-		{
-			continue;
-		}
-		common::Pattern::Match patMatch;
-		if(isFlt)
-		{
-			patMatch.setIsTypeFloatingPoint();
-		}
-		else if(isInt)
-		{
-			patMatch.setIsTypeIntegral();
-		}
-		patMatch.setSize(match->getDataSize());
-
-		if(entrySize)
-		{
-			patMatch.setEntrySize(entrySizeValue / file->getByteLength());
-		}
-		patMatch.setOffset(match->getOffset());
-		std::uint64_t val = 0;
-		if(file->getAddressFromOffset(val, match->getOffset()))
-		{
-			patMatch.setAddress(val);
-		}
-		pattern.matches.push_back(patMatch);
-	}
-
-	return pattern;
-}
-
 char ProviderInitialization::ID = 0;
 
 static RegisterPass<ProviderInitialization> X(
@@ -183,6 +65,7 @@ bool ProviderInitialization::runOnModule(Module& m)
 	NamesProvider::clear();
 	SymbolicTree::clear();
 	CallingConventionProvider::clear();
+	InstructionOptimizer::clear();
 
 	// Config.
 	//
@@ -199,10 +82,14 @@ bool ProviderInitialization::runOnModule(Module& m)
 
 	// Fileimage.
 	//
-	auto* f = FileImageProvider::addFileImage(
-			&m,
-			c->getConfig().parameters.getInputFile(),
-			c);
+	FileImage* f = nullptr;
+	{
+		utils::ProfileScope scope("fileformat/load");
+		f = FileImageProvider::addFileImage(
+				&m,
+				c->getConfig().parameters.getInputFile(),
+				c);
+	}
 	if (f == nullptr)
 	{
 		throw std::runtime_error("ProviderInitialization: f == nullptr");
@@ -281,7 +168,12 @@ bool ProviderInitialization::runOnModule(Module& m)
 			searchParams,
 			tools
 	);
-	if (cd.getAllInformation() == cpdetect::ReturnCode::OK)
+	bool toolsDetected = false;
+	{
+		utils::ProfileScope scope("cpdetect");
+		toolsDetected = cd.getAllInformation() == cpdetect::ReturnCode::OK;
+	}
+	if (toolsDetected)
 	{
 		for (auto& t : tools.detectedTools)
 		{
@@ -356,20 +248,7 @@ bool ProviderInitialization::runOnModule(Module& m)
 
 	// YARA crypto patterns scanning.
 	//
-	yaracpp::YaraDetector yara;
-	for (auto& crypto : c->getConfig().parameters.cryptoPatternPaths)
-	{
-		yara.addRuleFile(crypto);
-	}
-	yara.analyze(c->getConfig().parameters.getInputFile());
-	for(const auto &rule : yara.getDetectedRules())
-	{
-		common::Pattern p = saveCryptoRule(
-				rule,
-				f->getFileFormat()
-		);
-		c->getConfig().patterns.push_back(p);
-	}
+	CryptoPatterns::detect(f, c);
 	// TODO: removeRedundantCryptoRules()
 	// TODO: sortCryptoPatternMatches()
 
@@ -59,6 +59,8 @@ Config Config::fromConfig(llvm::Module* m, retdec::config::Config& c)
 		config.getConfig().architecture.setIsPic32();
 	}
 
+	config.indexPatterns();
+
 	return config;
 }
 
@@ -72,7 +74,7 @@ void Config::doFinalization()
 
 	if (!_configDB.parameters.getOutputConfigFile().empty())
 	{
-		_configDB.generateJsonFile(_configDB.parameters.getOutputConfigFile());
+		_configDB.generateFile(_configDB.parameters.getOutputConfigFile());
 	}
 }
 
@@ -620,6 +622,26 @@ llvm::CallInst* Config::isPseudoAsmFunctionCall(llvm::Value* c)
 	return isPseudoAsmFunction(cc->getCalledFunction()) ? cc : nullptr;
 }
 
+/**
+ * Add pattern \p p to the config and index its matches.
+ * Patterns must be added through this method, otherwise they would not be
+ * found by pattern queries.
+ */
+void Config::addPattern(retdec::common::Pattern p)
+{
+	auto& patterns = getConfig().patterns;
+	patterns.push_back(std::move(p));
+	_patternIndex.insert(patterns.back(), patterns.size() - 1);
+}
+
+/**
+ * (Re)build index of all the patterns in the config.
+ */
+void Config::indexPatterns()
+{
+	_patternIndex.build(getConfig().patterns);
+}
+
 /**
  * Get crypto pattern information for address \p addr - fill \p name,
  * \p description, and \p type, if there is a pattern on address.
@@ -631,61 +653,60 @@ bool Config::getCryptoPattern(
 		std::string& description,
 		llvm::Type*& type) const
 {
-	for (auto& p : getConfig().patterns)
+	for (auto& e : _patternIndex.findAt(addr))
 	{
+		auto& p = getConfig().patterns[e.pattern];
 		if (!p.isTypeCrypto())
 		{
 			continue;
 		}
 
-		for (auto& m : p.matches)
+		auto& m = p.matches[e.match];
+		if (!m.isSizeDefined())
+		{
+			continue;
+		}
+
+		auto elemCount = m.getSize();
+		if (!elemCount.has_value())
+		{
+			continue;
+		}
+
+		Type* elemType = Type::getInt8Ty(_module->getContext());
+
+		if (m.isEntrySizeDefined())
 		{
-			if (m.getAddress() != addr || !m.isSizeDefined())
+			elemCount = elemCount.value() / m.getEntrySize().value();
+			if (m.isTypeFloatingPoint() && m.getEntrySize() == 8)
 			{
-				continue;
+				elemType = Type::getDoubleTy(_module->getContext());
 			}
-
-			auto elemCount = m.getSize();
-			if (!elemCount.has_value())
+			else if (m.isTypeFloatingPoint() && m.getEntrySize() == 2)
 			{
-				continue;
+				elemType = Type::getHalfTy(_module->getContext());
 			}
-
-			Type* elemType = Type::getInt8Ty(_module->getContext());
-
-			if (m.isEntrySizeDefined())
+			else if (m.isTypeFloatingPoint() && m.getEntrySize() == 10)
 			{
-				elemCount = elemCount.value() / m.getEntrySize().value();
-				if (m.isTypeFloatingPoint() && m.getEntrySize() == 8)
-				{
-					elemType = Type::getDoubleTy(_module->getContext());
-				}
-				else if (m.isTypeFloatingPoint() && m.getEntrySize() == 2)
-				{
-					elemType = Type::getHalfTy(_module->getContext());
-				}
-				else if (m.isTypeFloatingPoint() && m.getEntrySize() == 10)
-				{
-					elemType = Type::getX86_FP80Ty(_module->getContext());
-				}
-				else if (m.isTypeFloatingPoint())
-				{
-					elemType = Type::getFloatTy(_module->getContext());
-				}
-				else // integral || unknown
-				{
-					elemType = Type::getIntNTy(
-							_module->getContext(),
-							m.getEntrySize().value() * 8);
-				}
+				elemType = Type::getX86_FP80Ty(_module->getContext());
+			}
+			else if (m.isTypeFloatingPoint())
+			{
+				elemType = Type::getFloatTy(_module->getContext());
+			}
+			else // integral || unknown
+			{
+				elemType = Type::getIntNTy(
+						_module->getContext(),
+						m.getEntrySize().value() * 8);
 			}
-			auto d = elemCount.value() > 0 ? elemCount.value() : 1;
-			type = ArrayType::get(elemType, d);
-			name = retdec::utils::appendHexRet(p.getName() + "_at", addr);
-			description = p.getDescription();
-
-			return true;
 		}
+		auto d = elemCount.value() > 0 ? elemCount.value() : 1;
+		type = ArrayType::get(elemType, d);
+		name = retdec::utils::appendHexRet(p.getName() + "_at", addr);
+		description = p.getDescription();
+
+		return true;
 	}
 
 	return false;
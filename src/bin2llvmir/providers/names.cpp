@@ -411,13 +411,15 @@ void NameContainer::initFromImage()
 		}
 
 	for (const auto* t : _image->getFileFormat()->getSymbolTables())
-		for (const auto& s : *t)
+	{
+		const auto& store = t->getStore();
+		for (std::size_t i = 0, e = store.size(); i < e; ++i)
 		{
 			unsigned long long a = 0;
-			if (s->getRealAddress(a))
+			if (!store.getName(i).empty() && store.getRealAddress(i, a))
 			{
 				Name::eType t = Name::eType::SYMBOL_OTHER;
-				switch (s->getUsageType())
+				switch (store.getUsageType(i))
 				{
 				case retdec::fileformat::Symbol::UsageType::FUNCTION:
 					t = Name::eType::SYMBOL_FUNCTION;
@@ -438,9 +440,10 @@ void NameContainer::initFromImage()
 					a -= 1;
 				}
 
-				addNameForAddress(a, s->getName(), t);
+				addNameForAddress(a, std::string(store.getName(i)), t);
 			}
 		}
+	}
 
 	if (_image->getFileFormat())
 	{
@@ -353,5 +353,95 @@ bool Pattern::operator!=(const Pattern& val) const
 	return !(*this == val);
 }
 
+//
+//=============================================================================
+// PatternIndex
+//=============================================================================
+//
+
+PatternIndex::PatternIndex(const PatternContainer& patterns)
+{
+	build(patterns);
+}
+
+/**
+ * Index all matches with defined addresses of all the given @a patterns.
+ * Any previous content of the index is dropped.
+ */
+void PatternIndex::build(const PatternContainer& patterns)
+{
+	clear();
+	for (std::size_t i = 0; i < patterns.size(); ++i)
+	{
+		insert(patterns[i], i);
+	}
+}
+
+/**
+ * Index all matches with defined addresses of the @a pattern which is stored
+ * at position @a patternIndex in the indexed container.
+ * Matches without size are indexed as one byte long.
+ */
+void PatternIndex::insert(const Pattern& pattern, std::size_t patternIndex)
+{
+	for (std::size_t i = 0; i < pattern.matches.size(); ++i)
+	{
+		auto& m = pattern.matches[i];
+		if (!m.isAddressDefined())
+		{
+			continue;
+		}
+
+		std::uint64_t size = m.getSize().value_or(0);
+		size = size ? size : 1;
+
+		Entry e;
+		e.start = m.getAddress();
+		e.end = m.getAddress() + size;
+		e.pattern = patternIndex;
+		e.match = i;
+		_entries.emplace(e.start.getValue(), e);
+	}
+}
+
+void PatternIndex::clear()
+{
+	_entries.clear();
+}
+
+bool PatternIndex::empty() const
+{
+	return _entries.empty();
+}
+
+/**
+ * @return Number of indexed matches.
+ */
+std::size_t PatternIndex::size() const
+{
+	return _entries.size();
+}
+
+/**
+ * @return All the matches starting at address @a addr, in the order in which
+ *         they were indexed.
+ */
+std::vector<PatternIndex::Entry> PatternIndex::findAt(
+		const retdec::common::Address& addr) const
+{
+	std::vector<Entry> ret;
+	if (addr.isUndefined())
+	{
+		return ret;
+	}
+
+	auto range = _entries.equal_range(addr.getValue());
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		ret.push_back(it->second);
+	}
+	return ret;
+}
+
 } // namespace common
 } // namespace retdec
@@ -13,6 +13,7 @@
 #include "retdec/config/config.h"
 #include "retdec/serdes/address.h"
 #include "retdec/serdes/architecture.h"
+#include "retdec/serdes/binary.h"
 #include "retdec/serdes/class.h"
 #include "retdec/serdes/file_format.h"
 #include "retdec/serdes/file_type.h"
@@ -23,11 +24,21 @@
 #include "retdec/serdes/vtable.h"
 #include "retdec/serdes/tool_info.h"
 #include "retdec/serdes/type.h"
+#include "retdec/utils/os.h"
 #include "retdec/utils/string.h"
 #include "retdec/utils/time.h"
 
 #include "retdec/serdes/std.h"
 
+#ifdef OS_WINDOWS
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
 namespace {
 
 const std::string JSON_date              = "date";
@@ -46,6 +57,209 @@ const std::string JSON_vtables           = "vtables";
 const std::string JSON_classes           = "classes";
 const std::string JSON_patterns          = "patterns";
 
+/**
+ * Read the whole file into a string.
+ * If file can not be opened, an instance of @c FileNotFoundException is thrown.
+ */
+std::string readFileContent(const std::string& input)
+{
+	// The reading of the input file is based on
+	// http://insanecoding.blogspot.cz/2011/11/how-to-read-in-file-in-c.html
+	std::ifstream file(input, std::ios::in | std::ios::binary);
+	if (!file)
+	{
+		std::string msg = "Input file \"" + input + "\" can not be opened.";
+		throw retdec::config::FileNotFoundException(msg);
+	}
+
+	std::string content;
+	file.seekg(0, std::ios::end);
+	content.resize(file.tellg());
+	file.seekg(0, std::ios::beg);
+	file.read(&content[0], content.size());
+	file.close();
+
+	return content;
+}
+
+/**
+ * Read-only memory mapping of a whole file.
+ * Mapping fails for files which can not be opened and for empty files.
+ */
+class MappedFile
+{
+	public:
+		explicit MappedFile(const std::string& path);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool isMapped() const { return _data != nullptr; }
+		const char* data() const { return _data; }
+		std::size_t size() const { return _size; }
+
+	private:
+		const char* _data = nullptr;
+		std::size_t _size = 0;
+#ifdef OS_WINDOWS
+		HANDLE _file = INVALID_HANDLE_VALUE;
+		HANDLE _mapping = nullptr;
+#endif
+};
+
+#ifdef OS_WINDOWS
+
+MappedFile::MappedFile(const std::string& path)
+{
+	_file = CreateFileA(
+			path.c_str(),
+			GENERIC_READ,
+			FILE_SHARE_READ,
+			nullptr,
+			OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL,
+			nullptr
+	);
+	if (_file == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(_file, &size) || size.QuadPart <= 0)
+	{
+		return;
+	}
+
+	_mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (_mapping == nullptr)
+	{
+		return;
+	}
+
+	auto* view = MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view)
+	{
+		_data = static_cast<const char*>(view);
+		_size = static_cast<std::size_t>(size.QuadPart);
+	}
+}
+
+MappedFile::~MappedFile()
+{
+	if (_data)
+		UnmapViewOfFile(_data);
+	if (_mapping)
+		CloseHandle(_mapping);
+	if (_file != INVALID_HANDLE_VALUE)
+		CloseHandle(_file);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path)
+{
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		return;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+	{
+		auto* view = mmap(
+				nullptr,
+				st.st_size,
+				PROT_READ,
+				MAP_PRIVATE,
+				fd,
+				0
+		);
+		if (view != MAP_FAILED)
+		{
+			_data = static_cast<const char*>(view);
+			_size = static_cast<std::size_t>(st.st_size);
+		}
+	}
+
+	// The mapping stays valid after the descriptor is closed.
+	close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+	if (_data)
+		munmap(const_cast<char*>(_data), _size);
+}
+
+#endif
+
+/**
+ * Serialize the whole config with the given writer. Used for both JSON and
+ * binary formats, so they always contain the same information.
+ */
+template <typename Writer>
+void serializeConfig(Writer& writer, const retdec::config::Config& config)
+{
+	using namespace retdec;
+
+	writer.StartObject();
+
+	serdes::serializeString(writer, JSON_date, retdec::utils::getCurrentDate());
+	serdes::serializeString(writer, JSON_time, retdec::utils::getCurrentTime());
+
+	writer.String(JSON_parameters);
+	config.parameters.serialize(writer);
+
+	serdes::serialize(writer, JSON_architecture, config.architecture);
+	serdes::serialize(writer, JSON_fileType, config.fileType);
+	serdes::serialize(writer, JSON_fileFormat, config.fileFormat);
+	serdes::serializeContainer(writer, JSON_tools, config.tools);
+	serdes::serializeContainer(writer, JSON_languages, config.languages);
+	serdes::serializeContainer(writer, JSON_functions, config.functions);
+	serdes::serializeContainer(writer, JSON_globals, config.globals);
+	serdes::serializeContainer(writer, JSON_registers, config.registers);
+	serdes::serializeContainer(writer, JSON_structures, config.structures);
+	serdes::serializeContainer(writer, JSON_vtables, config.vtables);
+	serdes::serializeContainer(writer, JSON_classes, config.classes);
+	serdes::serializeContainer(writer, JSON_patterns, config.patterns);
+
+	writer.EndObject();
+}
+
+/**
+ * Deserialize the whole config from the document root. Used for both JSON
+ * and binary formats.
+ */
+void deserializeConfig(const rapidjson::Value& root, retdec::config::Config& config)
+{
+	using namespace retdec;
+
+	config = retdec::config::Config();
+
+	auto params = root.FindMember(JSON_parameters);
+	if (params != root.MemberEnd())
+	{
+		config.parameters.deserialize(params->value);
+	}
+
+	serdes::deserialize(root, JSON_architecture, config.architecture);
+	serdes::deserialize(root, JSON_fileType, config.fileType);
+	serdes::deserialize(root, JSON_fileFormat, config.fileFormat);
+
+	serdes::deserializeContainer(root, JSON_tools, config.tools);
+	serdes::deserializeContainer(root, JSON_languages, config.languages);
+	serdes::deserializeContainer(root, JSON_functions, config.functions);
+	serdes::deserializeContainer(root, JSON_globals, config.globals);
+	serdes::deserializeContainer(root, JSON_registers, config.registers);
+	serdes::deserializeContainer(root, JSON_structures, config.structures);
+	serdes::deserializeContainer(root, JSON_vtables, config.vtables);
+	serdes::deserializeContainer(root, JSON_classes, config.classes);
+	serdes::deserializeContainer(root, JSON_patterns, config.patterns);
+}
+
 } // anonymous namespace
 
 namespace retdec {
@@ -57,10 +271,13 @@ Config Config::empty()
 	return config;
 }
 
+/**
+ * Reads config from file in any of the supported formats.
+ */
 Config Config::fromFile(const std::string& path)
 {
 	Config config;
-	config.readJsonFile(path);
+	config.readFile(path);
 	return config;
 }
 
@@ -71,6 +288,21 @@ Config Config::fromJsonString(const std::string& json)
 	return config;
 }
 
+Config Config::fromBinaryString(const std::string& binary)
+{
+	Config config;
+	config.readBinaryString(binary);
+	return config;
+}
+
+/**
+ * Is @a content in the binary config format?
+ */
+bool Config::isBinary(const std::string& content)
+{
+	return serdes::binary::isBinary(content);
+}
+
 /**
  * Reads JSON file into internal representation.
  * If file can not be opened, an instance of @c FileNotFoundException is thrown.
@@ -79,23 +311,47 @@ Config Config::fromJsonString(const std::string& json)
  */
 void Config::readJsonFile(const std::string& input)
 {
-	// The reading of the input file is based on
-	// http://insanecoding.blogspot.cz/2011/11/how-to-read-in-file-in-c.html
-	std::ifstream jsonFile(input, std::ios::in | std::ios::binary);
-	if (!jsonFile)
+	readJsonString(readFileContent(input));
+}
+
+/**
+ * Reads config file in any of the supported formats (JSON or binary) into
+ * internal representation.
+ * If file can not be opened, an instance of @c FileNotFoundException is thrown.
+ * If file can not be parsed, an instance of @c ParseException is thrown.
+ * @param input Path to input config file.
+ */
+void Config::readFile(const std::string& input)
+{
+	// Binary configs are read straight from the mapped file, JSON configs
+	// have to be copied into a string for the parser anyway.
+	MappedFile file(input);
+	if (file.isMapped() && serdes::binary::isBinary(file.data(), file.size()))
 	{
-		std::string msg = "Input file \"" + input + "\" can not be opened.";
-		throw FileNotFoundException(msg);
+		readBinary(file.data(), file.size());
 	}
+	else
+	{
+		readString(readFileContent(input));
+	}
+}
 
-	std::string jsonContent;
-	jsonFile.seekg(0, std::ios::end);
-	jsonContent.resize(jsonFile.tellg());
-	jsonFile.seekg(0, std::ios::beg);
-	jsonFile.read(&jsonContent[0], jsonContent.size());
-	jsonFile.close();
-
-	readJsonString(jsonContent);
+/**
+ * Reads string containing config in any of the supported formats
+ * (JSON or binary).
+ * If string can not be parsed, an instance of @c ParseException is thrown.
+ * @param content Config string.
+ */
+void Config::readString(const std::string& content)
+{
+	if (isBinary(content))
+	{
+		readBinaryString(content);
+	}
+	else
+	{
+		readJsonString(content);
+	}
 }
 
 /**
@@ -135,31 +391,49 @@ std::string Config::generateJsonString() const
 {
 	rapidjson::StringBuffer sb;
 	rapidjson::PrettyWriter<rapidjson::StringBuffer, rapidjson::UTF8<>> writer(sb);
+	serializeConfig(writer, *this);
+	return sb.GetString();
+}
 
-	writer.StartObject();
+/**
+ * Generates string containing compact binary representation of configuration.
+ * @return Binary string.
+ */
+std::string Config::generateBinaryString() const
+{
+	serdes::BinaryWriter writer;
+	serializeConfig(writer, *this);
+	return writer.releaseOutput();
+}
 
-	serdes::serializeString(writer, JSON_date, retdec::utils::getCurrentDate());
-	serdes::serializeString(writer, JSON_time, retdec::utils::getCurrentTime());
+/**
+ * Generates binary configuration file.
+ * @param outputFilePath Path to output file. If not set, use 'inputName'.
+ * @return Path to generated file.
+ */
+std::string Config::generateBinaryFile(const std::string& outputFilePath) const
+{
+	std::string name = outputFilePath.empty()
+			? parameters.getInputFile() + ".bin"
+			: outputFilePath;
 
-	writer.String(JSON_parameters);
-	parameters.serialize(writer);
-
-	serdes::serialize(writer, JSON_architecture, architecture);
-	serdes::serialize(writer, JSON_fileType, fileType);
-	serdes::serialize(writer, JSON_fileFormat, fileFormat);
-	serdes::serializeContainer(writer, JSON_tools, tools);
-	serdes::serializeContainer(writer, JSON_languages, languages);
-	serdes::serializeContainer(writer, JSON_functions, functions);
-	serdes::serializeContainer(writer, JSON_globals, globals);
-	serdes::serializeContainer(writer, JSON_registers, registers);
-	serdes::serializeContainer(writer, JSON_structures, structures);
-	serdes::serializeContainer(writer, JSON_vtables, vtables);
-	serdes::serializeContainer(writer, JSON_classes, classes);
-	serdes::serializeContainer(writer, JSON_patterns, patterns);
+	std::ofstream file(name, std::ios::out | std::ios::binary);
+	file << generateBinaryString();
 
-	writer.EndObject();
+	return name;
+}
 
-	return sb.GetString();
+/**
+ * Generates configuration file in the format selected by
+ * @c Parameters::getConfigFormat().
+ * @param outputFilePath Path to output file.
+ * @return Path to generated file.
+ */
+std::string Config::generateFile(const std::string& outputFilePath) const
+{
+	return parameters.isConfigFormatBinary()
+			? generateBinaryFile(outputFilePath)
+			: generateJsonFile(outputFilePath);
 }
 
 /**
@@ -181,27 +455,42 @@ void Config::readJsonString(const std::string& json)
 		throw ParseException(errMsg, loc.first, loc.second);
 	}
 
-	*this = Config();
+	deserializeConfig(root, *this);
+}
 
-	auto params = root.FindMember(JSON_parameters);
-	if (params != root.MemberEnd())
+/**
+ * Reads string containing binary representation of configuration.
+ * If string can not be parsed, an instance of @c ParseException is thrown.
+ * Its column is set to the offset at which the error was found.
+ * @param binary Binary string.
+ */
+void Config::readBinaryString(const std::string& binary)
+{
+	readBinary(binary.data(), binary.size());
+}
+
+/**
+ * Reads binary representation of configuration from memory buffer.
+ * If it can not be parsed, an instance of @c ParseException is thrown.
+ * Its column is set to the offset at which the error was found.
+ * @param data Binary data. They are not copied.
+ * @param size Size of @a data.
+ */
+void Config::readBinary(const char* data, std::size_t size)
+{
+	serdes::BinaryReader reader(data, size);
+	rapidjson::Document root;
+	root.Populate(reader);
+	if (reader.hasError())
+	{
+		throw ParseException(reader.getError(), 0, reader.getErrorOffset());
+	}
+	if (!root.IsObject())
 	{
-		parameters.deserialize(params->value);
+		throw ParseException("Failed to parse configuration!", 0, 0);
 	}
 
-	serdes::deserialize(root, JSON_architecture, architecture);
-	serdes::deserialize(root, JSON_fileType, fileType);
-	serdes::deserialize(root, JSON_fileFormat, fileFormat);
-
-	serdes::deserializeContainer(root, JSON_tools, tools);
-	serdes::deserializeContainer(root, JSON_languages, languages);
-	serdes::deserializeContainer(root, JSON_functions, functions);
-	serdes::deserializeContainer(root, JSON_globals, globals);
-	serdes::deserializeContainer(root, JSON_registers, registers);
-	serdes::deserializeContainer(root, JSON_structures, structures);
-	serdes::deserializeContainer(root, JSON_vtables, vtables);
-	serdes::deserializeContainer(root, JSON_classes, classes);
-	serdes::deserializeContainer(root, JSON_patterns, patterns);
+	deserializeConfig(root, *this);
 }
 
 } // namespace config
@@ -17,6 +17,7 @@ namespace {
 const std::string JSON_verboseOut               = "verboseOut";
 const std::string JSON_keepAllFuncs             = "keepAllFuncs";
 const std::string JSON_selectedDecodeOnly       = "selectedDecodeOnly";
+const std::string JSON_selectedDemandDriven     = "selectedDemandDriven";
 const std::string JSON_ordinalNumDir            = "ordinalNumDirectory";
 const std::string JSON_userStaticSigPaths       = "userStaticSignPaths";
 const std::string JSON_staticSigPaths           = "staticSignPaths";
@@ -40,14 +41,19 @@ const std::string JSON_outputLlFile             = "outputLlFile";
 const std::string JSON_outputConfigFile         = "outputConfigFile";
 const std::string JSON_outputUnpackedFile       = "outputUnpackedFile";
 const std::string JSON_outputFormat             = "outputFormat";
+const std::string JSON_configFormat             = "configFormat";
 const std::string JSON_logFile                  = "logFile";
 const std::string JSON_errFile                  = "errFile";
+const std::string JSON_metricsFile              = "metricsFile";
+const std::string JSON_traceFile                = "traceFile";
 
 const std::string JSON_detectStaticCode         = "detectStaticCode";
+const std::string JSON_skipStaticCodeLifting    = "skipStaticCodeLifting";
 const std::string JSON_backendDisabledOpts      = "backendDisabledOpts";
 const std::string JSON_backendEnabledOpts       = "backendEnabledOpts";
 const std::string JSON_backendCallInfoObtainer  = "backendCallInfoObtainer";
 const std::string JSON_backendVarRenamer        = "backendVarRenamer";
+const std::string JSON_backendGraphFormat       = "backendGraphFormat";
 const std::string JSON_backendNoOpts            = "backendNoOpts";
 const std::string JSON_backendEmitCfg           = "backendEmitCfg";
 const std::string JSON_backendEmitCg            = "backendEmitCg";
@@ -61,6 +67,8 @@ const std::string JSON_backendNoSymbolicNames   = "backendNoSymbolicNames";
 const std::string JSON_timeout                  = "timeout";
 const std::string JSON_maxMemoryLimit           = "maxMemoryLimit";
 const std::string JSON_maxMemoryLimitHalfRam    = "maxMemoryLimitHalfRam";
+const std::string JSON_maxThreads               = "maxThreads";
+const std::string JSON_fastExit                 = "fastExit";
 
 } // anonymous namespace
 
@@ -91,6 +99,27 @@ bool Parameters::isKeepAllFunctions() const
  */
 bool Parameters::isSelectedDecodeOnly() const { return _selectedDecodeOnly; }
 
+/**
+ * @return Decode only parts selected through selective decompilation, starting
+ * from the selected functions. Functions called from them are not decoded,
+ * only their declarations are created, and analyses that need the whole
+ * program (e.g. main detection) are skipped.
+ */
+bool Parameters::isSelectedDemandDriven() const
+{
+	return _selectedDemandDriven;
+}
+
+/**
+ * @return @c True if demand-driven selective decompilation is in effect, i.e.
+ *         it was requested and some functions or ranges were selected.
+ *         Without a selection, the entire binary is decompiled as usual.
+ */
+bool Parameters::isDemandDriven() const
+{
+	return isSelectedDemandDriven() && isSomethingSelected();
+}
+
 /**
  * Find out if some functions or ranges were selected in selective decompilation.
  * @return @c True if @c selectedFunctions or @c selectedRanges not empty,
@@ -151,17 +180,41 @@ bool Parameters::isBackendNoSymbolicNames() const
 	return _backendNoSymbolicNames;
 }
 
+bool Parameters::isConfigFormatBinary() const
+{
+	return _configFormat == "binary";
+}
+
 
 bool Parameters::isDetectStaticCode() const
 {
 	return _detectStaticCode;
 }
 
+/**
+ * @return Statically linked functions confirmed by the static code detection
+ *         should not be decoded, only their declarations should be created.
+ */
+bool Parameters::isSkipStaticCodeLifting() const
+{
+	return _skipStaticCodeLifting;
+}
+
 bool Parameters::isTimeout() const
 {
 	return _timeout != 0;
 }
 
+/**
+ * @return The tool should exit right after all its outputs are written,
+ *         without the (possibly long) destruction of the decompiled module
+ *         and other global state.
+ */
+bool Parameters::isFastExit() const
+{
+	return _fastExit;
+}
+
 void Parameters::setIsVerboseOutput(bool b)
 {
 	_verboseOutput = b;
@@ -175,6 +228,10 @@ void Parameters::setIsSelectedDecodeOnly(bool b)
 {
 	_selectedDecodeOnly = b;
 }
+void Parameters::setIsSelectedDemandDriven(bool b)
+{
+	_selectedDemandDriven = b;
+}
 
 void Parameters::setOutputFile(const std::string& n)
 {
@@ -211,6 +268,11 @@ void Parameters::setOutputFormat(const std::string& format)
 	_outputFormat = format;
 }
 
+void Parameters::setConfigFormat(const std::string& format)
+{
+	_configFormat = format;
+}
+
 void Parameters::setLogFile(const std::string &file)
 {
 	_logFile = file;
@@ -221,6 +283,16 @@ void Parameters::setErrFile(const std::string &file)
 	_errFile = file;
 }
 
+void Parameters::setMetricsFile(const std::string &file)
+{
+	_metricsFile = file;
+}
+
+void Parameters::setTraceFile(const std::string &file)
+{
+	_traceFile = file;
+}
+
 void Parameters::setOrdinalNumbersDirectory(const std::string& n)
 {
 	_ordinalNumbersDirectory = n;
@@ -251,6 +323,16 @@ void Parameters::setTimeout(uint64_t seconds)
 	_timeout = seconds;
 }
 
+void Parameters::setMaxThreads(uint64_t threads)
+{
+	_maxThreads = threads;
+}
+
+void Parameters::setIsFastExit(bool b)
+{
+	_fastExit = b;
+}
+
 void Parameters::setEntryPoint(const retdec::common::Address& a)
 {
 	_entryPoint = a;
@@ -285,6 +367,11 @@ void Parameters::setBackendVarRenamer(const std::string& val)
 	_backendVarRenamer = val;
 }
 
+void Parameters::setBackendGraphFormat(const std::string& val)
+{
+	_backendGraphFormat = val;
+}
+
 void Parameters::setIsBackendNoOpts(bool b)
 {
 	_backendNoOpts = b;
@@ -335,6 +422,11 @@ void Parameters::setIsDetectStaticCode(bool b)
 	_detectStaticCode = b;
 }
 
+void Parameters::setIsSkipStaticCodeLifting(bool b)
+{
+	_skipStaticCodeLifting = b;
+}
+
 const std::string& Parameters::getOrdinalNumbersDirectory() const
 {
 	return _ordinalNumbersDirectory;
@@ -385,6 +477,11 @@ const std::string& Parameters::getOutputFormat() const
 	return _outputFormat;
 }
 
+const std::string& Parameters::getConfigFormat() const
+{
+	return _configFormat;
+}
+
 const std::string& Parameters::getLogFile() const
 {
 	return _logFile;
@@ -395,6 +492,16 @@ const std::string& Parameters::getErrFile() const
 	return _errFile;
 }
 
+const std::string& Parameters::getMetricsFile() const
+{
+	return _metricsFile;
+}
+
+const std::string& Parameters::getTraceFile() const
+{
+	return _traceFile;
+}
+
 uint64_t Parameters::getMaxMemoryLimit() const
 {
 	return _maxMemoryLimit;
@@ -405,6 +512,11 @@ uint64_t Parameters::getTimeout() const
 	return _timeout;
 }
 
+uint64_t Parameters::getMaxThreads() const
+{
+	return _maxThreads;
+}
+
 retdec::common::Address Parameters::getEntryPoint() const
 {
 	return _entryPoint;
@@ -440,6 +552,11 @@ const std::string& Parameters::getBackendVarRenamer() const
 	return _backendVarRenamer;
 }
 
+const std::string& Parameters::getBackendGraphFormat() const
+{
+	return _backendGraphFormat;
+}
+
 void fixPath(std::string& path, fs::path root)
 {
 	fs::path p(path);
@@ -485,6 +602,7 @@ void Parameters::serialize(Writer& writer) const
 	serdes::serializeBool(writer, JSON_verboseOut, isVerboseOutput());
 	serdes::serializeBool(writer, JSON_keepAllFuncs, isKeepAllFunctions());
 	serdes::serializeBool(writer, JSON_selectedDecodeOnly, isSelectedDecodeOnly());
+	serdes::serializeBool(writer, JSON_selectedDemandDriven, isSelectedDemandDriven());
 	serdes::serializeString(writer, JSON_ordinalNumDir, getOrdinalNumbersDirectory());
 
 	serdes::serializeString(writer, JSON_inputFile, getInputFile());
@@ -496,17 +614,22 @@ void Parameters::serialize(Writer& writer) const
 	serdes::serializeString(writer, JSON_outputConfigFile, getOutputConfigFile());
 	serdes::serializeString(writer, JSON_outputUnpackedFile, getOutputUnpackedFile());
 	serdes::serializeString(writer, JSON_outputFormat, getOutputFormat());
+	serdes::serializeString(writer, JSON_configFormat, getConfigFormat());
 	serdes::serializeString(writer, JSON_logFile, getLogFile());
 	serdes::serializeString(writer, JSON_errFile, getErrFile());
+	serdes::serializeString(writer, JSON_metricsFile, getMetricsFile());
+	serdes::serializeString(writer, JSON_traceFile, getTraceFile());
 
 	serdes::serializeString(writer, JSON_backendDisabledOpts, getBackendDisabledOpts());
 	serdes::serializeString(writer, JSON_backendEnabledOpts, getBackendEnabledOpts());
 	serdes::serializeString(writer, JSON_backendCallInfoObtainer, getBackendCallInfoObtainer());
 	serdes::serializeString(writer, JSON_backendVarRenamer, getBackendVarRenamer());
+	serdes::serializeString(writer, JSON_backendGraphFormat, getBackendGraphFormat());
 	serdes::serializeBool(writer, JSON_backendNoOpts, isBackendNoOpts());
 	serdes::serializeBool(writer, JSON_backendEmitCfg, isBackendEmitCfg());
 	serdes::serializeBool(writer, JSON_backendEmitCg, isBackendEmitCg());
 	serdes::serializeBool(writer, JSON_detectStaticCode, isDetectStaticCode());
+	serdes::serializeBool(writer, JSON_skipStaticCodeLifting, isSkipStaticCodeLifting());
 	serdes::serializeBool(writer, JSON_backendKeepAllBrackets, isBackendKeepAllBrackets());
 	serdes::serializeBool(writer, JSON_backendKeepLibraryFuncs, isBackendKeepLibraryFuncs());
 	serdes::serializeBool(writer, JSON_backendNoTimeVaryingInfo, isBackendNoTimeVaryingInfo());
@@ -517,6 +640,8 @@ void Parameters::serialize(Writer& writer) const
 	serdes::serializeUint64(writer, JSON_timeout, getTimeout());
 	serdes::serializeUint64(writer, JSON_maxMemoryLimit, getMaxMemoryLimit());
 	serdes::serializeBool(writer, JSON_maxMemoryLimitHalfRam, isMaxMemoryLimitHalfRam());
+	serdes::serializeUint64(writer, JSON_maxThreads, getMaxThreads());
+	serdes::serializeBool(writer, JSON_fastExit, isFastExit());
 
 	serdes::serializeContainer(writer, JSON_selectedRanges, selectedRanges);
 	serdes::serializeContainer(writer, JSON_userStaticSigPaths, userStaticSignaturePaths);
@@ -538,6 +663,8 @@ template void Parameters::serialize(
 	rapidjson::PrettyWriter<rapidjson::StringBuffer>&) const;
 template void Parameters::serialize(
 	rapidjson::PrettyWriter<rapidjson::StringBuffer, rapidjson::ASCII<>>&) const;
+template void Parameters::serialize(
+	serdes::BinaryWriter&) const;
 
 /**
  * Reads JSON object (associative array) holding parameters information.
@@ -553,6 +680,7 @@ void Parameters::deserialize(const rapidjson::Value& val)
 	setIsVerboseOutput( serdes::deserializeBool(val, JSON_verboseOut, false) );
 	setIsKeepAllFunctions( serdes::deserializeBool(val, JSON_keepAllFuncs) );
 	setIsSelectedDecodeOnly( serdes::deserializeBool(val, JSON_selectedDecodeOnly) );
+	setIsSelectedDemandDriven( serdes::deserializeBool(val, JSON_selectedDemandDriven, false) );
 	setOrdinalNumbersDirectory( serdes::deserializeString(val, JSON_ordinalNumDir) );
 
 	setInputFile( serdes::deserializeString(val, JSON_inputFile) );
@@ -564,14 +692,19 @@ void Parameters::deserialize(const rapidjson::Value& val)
 	setOutputConfigFile( serdes::deserializeString(val, JSON_outputConfigFile) );
 	setOutputUnpackedFile( serdes::deserializeString(val, JSON_outputUnpackedFile) );
 	setOutputFormat( serdes::deserializeString(val, JSON_outputFormat) );
+	setConfigFormat( serdes::deserializeString(val, JSON_configFormat, "json") );
 	setLogFile( serdes::deserializeString(val, JSON_logFile) );
 	setErrFile( serdes::deserializeString(val, JSON_errFile) );
+	setMetricsFile( serdes::deserializeString(val, JSON_metricsFile) );
+	setTraceFile( serdes::deserializeString(val, JSON_traceFile) );
 
 	setIsDetectStaticCode( serdes::deserializeBool(val, JSON_detectStaticCode, true) );
+	setIsSkipStaticCodeLifting( serdes::deserializeBool(val, JSON_skipStaticCodeLifting, false) );
 	setBackendDisabledOpts( serdes::deserializeString(val, JSON_backendDisabledOpts) );
 	setBackendEnabledOpts( serdes::deserializeString(val, JSON_backendEnabledOpts) );
 	setBackendCallInfoObtainer( serdes::deserializeString(val, JSON_backendCallInfoObtainer, "optim") );
 	setBackendVarRenamer( serdes::deserializeString(val, JSON_backendVarRenamer, "readable") );
+	setBackendGraphFormat( serdes::deserializeString(val, JSON_backendGraphFormat, "dot") );
 	setIsBackendNoOpts( serdes::deserializeBool(val, JSON_backendNoOpts, false) );
 	setIsBackendEmitCfg( serdes::deserializeBool(val, JSON_backendEmitCfg, false) );
 	setIsBackendEmitCg( serdes::deserializeBool(val, JSON_backendEmitCg, false) );
@@ -585,6 +718,8 @@ void Parameters::deserialize(const rapidjson::Value& val)
 	setTimeout( serdes::deserializeUint64(val, JSON_timeout, 0) );
 	setMaxMemoryLimit( serdes::deserializeUint64(val, JSON_maxMemoryLimit, 0) );
 	setIsMaxMemoryLimitHalfRam( serdes::deserializeBool(val, JSON_maxMemoryLimitHalfRam, true) );
+	setMaxThreads( serdes::deserializeUint64(val, JSON_maxThreads, 0) );
+	setIsFastExit( serdes::deserializeBool(val, JSON_fastExit, false) );
 
 	serdes::deserialize(val, JSON_entryPoint, _entryPoint);
 	serdes::deserialize(val, JSON_mainAddress, _mainAddress);
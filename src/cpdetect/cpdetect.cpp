@@ -498,32 +498,53 @@ void CompilerDetector::getAllHeuristics()
  */
 ReturnCode CompilerDetector::getAllSignatures()
 {
-	YaraDetector yara;
-
-	// Add internal paths.
-	unsigned iCntr = 0;
-	for (const auto &ruleFile : internalPaths)
-	{
-		std::string nameSpace = "internal_" + std::to_string(iCntr++);
-		yara.addRuleFile(ruleFile, nameSpace);
+	std::vector<YaraRule> detected;
+	std::vector<YaraRule> undetected;
+	if (signatures)
+	{
+		// Shared signatures are used by the scanning service, whose inputs
+		// are parsed from memory buffers (which have no path), so scan the
+		// bytes already loaded by the parser.
+		const auto &bytes = fileParser.getBytes();
+		if (cpParams.searchType == SearchType::EXACT_MATCH)
+		{
+			signatures->analyze(bytes.data(), bytes.size(), detected);
+		}
+		else
+		{
+			signatures->analyze(bytes.data(), bytes.size(), detected, undetected);
+		}
 	}
-
-	unsigned eCntr = 0;
-	if (cpParams.external && getExternalDatabases())
+	else
 	{
-		for (const auto &item : externalDatabase)
+		YaraDetector yara;
+
+		// Add internal paths.
+		unsigned iCntr = 0;
+		for (const auto &ruleFile : internalPaths)
+		{
+			std::string nameSpace = "internal_" + std::to_string(iCntr++);
+			yara.addRuleFile(ruleFile, nameSpace);
+		}
+
+		unsigned eCntr = 0;
+		if (cpParams.external && getExternalDatabases())
 		{
-			std::string nameSpace = "external_" + std::to_string(eCntr++);
-			yara.addRuleFile(item, nameSpace);
+			for (const auto &item : externalDatabase)
+			{
+				std::string nameSpace = "external_" + std::to_string(eCntr++);
+				yara.addRuleFile(item, nameSpace);
+			}
 		}
+
+		yara.analyze(
+				fileParser.getPathToFile(),
+				cpParams.searchType != SearchType::EXACT_MATCH
+		);
+		detected = yara.getDetectedRules();
+		undetected = yara.getUndetectedRules();
 	}
 
-	yara.analyze(
-			fileParser.getPathToFile(),
-			cpParams.searchType != SearchType::EXACT_MATCH
-	);
-	const auto &detected = yara.getDetectedRules();
-	const auto &undetected = yara.getUndetectedRules();
 	auto result = false;
 	if (cpParams.searchType == SearchType::EXACT_MATCH
 			|| (cpParams.searchType == SearchType::MOST_SIMILAR
@@ -751,6 +772,29 @@ ReturnCode CompilerDetector::getAllCompilers()
 			: status;
 }
 
+/**
+ * Get internal rule files matching format and architecture of the input file
+ */
+const std::vector<std::string>& CompilerDetector::getInternalRuleFiles() const
+{
+	return internalPaths;
+}
+
+/**
+ * Use already compiled signatures instead of compiling them for every input
+ * @param rules Compiled signatures or @c nullptr to compile them from
+ *    internal (and external) rule files
+ *
+ * The detector does not take ownership of @p rules. They are only scanned by
+ * const methods, so a single instance can be shared by detectors running in
+ * multiple threads. External databases are not searched when compiled
+ * signatures are used.
+ */
+void CompilerDetector::setSignatures(const retdec::yaracpp::YaraDetector *rules)
+{
+	signatures = rules;
+}
+
 /**
  * Detect all supported information about used compiler or packer
  * @return Status of detection (ReturnCode::OK if all is OK)
@@ -4,6 +4,7 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
 #include <initializer_list>
 #include <limits>
 #include <map>
@@ -93,6 +94,32 @@ const std::vector<std::string> dotNetShrinkPatterns =
 	"20E6EA19BE28--------13--2039EA19BE28--------13--11--11--161F4028--------26;"
 };
 
+const std::string ezirizSignature =
+	"558BECB90F0000006A006A004975F951535657B8--------E8;";
+const std::string phoenixSignature =
+	"0000010B160C----------0208----------0D0906085961D21304091E630861D21305070811051E62110460D19D081758;";
+const std::string assemblyInvokeSignature =
+	"282D00000A6F2E00000A14146F2F00000A;";
+const std::string cliSecureSignature =
+	"436C69005300650063007500720065;";
+
+const std::string enigmaString = "\0\0\0ENIGMA"s;
+const std::string adeptProtectorString = "ByAdeptProtector";
+const std::string staThreadString = "STAThreadAttribute";
+const std::string netSpiderString =
+	"Protected_By_Attribute\0NETSpider.Attribute"s;
+const std::string reNetPackString = "Protected/Packed with ReNET-Pack by stx";
+const std::string netzString = "\0NetzStarter\0netz\0"s;
+const std::string phoenixString = "?.resources";
+
+/// Strings of packers searched at the start of file
+const std::string upx10String = "UPX 1.0";
+const std::string upxString = "UPX!";
+const std::string peCompactString = "PEC2";
+const std::string peCompact2String = "PECompact2";
+/// Strings of packers must start in this number of bytes at the start of file
+const std::size_t HEADER_AREA_SIZE = 0x500;
+
 const std::string msvcRuntimeString = "Microsoft Visual C++ Runtime Library";
 
 const std::vector<std::string> msvcRuntimeStrings =
@@ -168,6 +195,152 @@ PeHeuristics::PeHeuristics(
 		, declaredLength(parser.getDeclaredFileLength())
 		, loadedLength(parser.getLoadedFileLength())
 {
+	firstSectionArea.signatures = {
+		ezirizSignature,
+		phoenixSignature,
+		assemblyInvokeSignature,
+		cliSecureSignature
+	};
+	firstSectionArea.signatures.insert(
+			firstSectionArea.signatures.end(),
+			dotNetShrinkPatterns.begin(),
+			dotNetShrinkPatterns.end());
+	firstSectionArea.strings = {
+		enigmaString,
+		adeptProtectorString,
+		staThreadString,
+		netSpiderString,
+		reNetPackString,
+		netzString,
+		phoenixString
+	};
+	initScanArea(firstSectionArea, fileParser.getSection(0));
+
+	rdataArea.strings = msvcRuntimeStrings;
+	initScanArea(rdataArea, fileParser.getSection(".rdata"));
+
+	headerArea.strings = {
+		upx10String,
+		upxString,
+		peCompactString,
+		peCompact2String
+	};
+	headerArea.valid = true;
+	for (const auto &str : headerArea.strings)
+	{
+		// string starting in the last byte of area must be found as well
+		headerArea.stopOffset = std::max(
+				headerArea.stopOffset,
+				HEADER_AREA_SIZE + str.length() - 2);
+	}
+}
+
+/**
+ * Set bounds of scanned area to the loaded content of section
+ * @param area Scanned area
+ * @param section Section or @c nullptr if section does not exist
+ *
+ * Area of a section without loaded content (e.g. a virtual-only section)
+ * stays invalid, so nothing is found in it.
+ */
+void PeHeuristics::initScanArea(
+		ScanArea &area,
+		const retdec::fileformat::Section *section)
+{
+	if (section && section->getLoadedSize())
+	{
+		area.startOffset = section->getOffset();
+		area.stopOffset = section->getOffset() + section->getLoadedSize() - 1;
+		area.valid = true;
+	}
+}
+
+/**
+ * Find signature in scanned area
+ * @param area Scanned area
+ * @param signPattern Signature pattern declared for @a area
+ * @return The same value as Search::findUnslashedSignature()
+ *
+ * On the first call, @a area is searched for all its signatures at once.
+ */
+unsigned long long PeHeuristics::findSignatureInArea(
+		ScanArea &area,
+		const std::string &signPattern)
+{
+	if (!area.valid)
+	{
+		return 0;
+	}
+
+	const auto it = std::find(
+			area.signatures.begin(),
+			area.signatures.end(),
+			signPattern);
+	if (it == area.signatures.end())
+	{
+		return search.findUnslashedSignature(
+				signPattern,
+				area.startOffset,
+				area.stopOffset);
+	}
+
+	if (!area.signaturesScanned)
+	{
+		area.signatureResults = search.findUnslashedSignatures(
+				area.signatures,
+				area.startOffset,
+				area.stopOffset);
+		area.signaturesScanned = true;
+	}
+
+	return area.signatureResults[it - area.signatures.begin()];
+}
+
+/**
+ * Find string in scanned area
+ * @param area Scanned area
+ * @param str String declared for @a area
+ * @return Offset of the first occurrence of @a str in @a area or
+ *         @c std::string::npos if @a str is not present in @a area
+ *
+ * On the first call, @a area is searched for all its strings at once.
+ */
+std::size_t PeHeuristics::findStringInArea(
+		ScanArea &area,
+		const std::string &str)
+{
+	if (!area.valid)
+	{
+		return std::string::npos;
+	}
+
+	const auto it = std::find(area.strings.begin(), area.strings.end(), str);
+	if (it == area.strings.end())
+	{
+		return search.findString(str, area.startOffset, area.stopOffset);
+	}
+
+	if (!area.stringsScanned)
+	{
+		area.stringResults = search.findStrings(
+				area.strings,
+				area.startOffset,
+				area.stopOffset);
+		area.stringsScanned = true;
+	}
+
+	return area.stringResults[it - area.strings.begin()];
+}
+
+/**
+ * Check if scanned area contains string
+ * @param area Scanned area
+ * @param str String declared for @a area
+ * @return @c true if @a str is present in @a area, @c false otherwise
+ */
+bool PeHeuristics::hasStringInArea(ScanArea &area, const std::string &str)
+{
+	return findStringInArea(area, str) != std::string::npos;
 }
 
 /**
@@ -186,15 +359,16 @@ std::string PeHeuristics::getEnigmaVersion()
 		}
 	}
 
-	const std::string pattern = "\0\0\0ENIGMA"s;
-	const auto &content = search.getPlainString();
-	const auto pos = content.find(pattern, sec->getOffset());
+	const auto pos = search.findString(
+			enigmaString,
+			sec->getOffset(),
+			sec->getOffset() + sec->getLoadedSize() + enigmaString.length() - 2);
 	if (pos < sec->getOffset() + sec->getLoadedSize())
 	{
 		std::uint64_t result1, result2;
-		if (fileParser.get1ByteOffset(pos + pattern.length(), result1)
+		if (fileParser.get1ByteOffset(pos + enigmaString.length(), result1)
 				&& fileParser.get1ByteOffset(
-						pos + pattern.length() + 1,
+						pos + enigmaString.length() + 1,
 						result2))
 		{
 			return std::to_string(result1) + "." + std::to_string(result2);
@@ -590,11 +764,11 @@ void PeHeuristics::getStarForceHeuristics()
  */
 void PeHeuristics::getSafeDiscHeuristics()
 {
-	const auto &content = search.getPlainString();
 	const std::string safeDiscString = "BoG_ *90.0&!!  Yy>";
-	auto pos = content.find(safeDiscString, peParser.getSizeOfHeaders() - 0x2C);
-
-	if (pos == peParser.getSizeOfHeaders() - 0x2C)
+	if (peParser.getSizeOfHeaders() >= 0x2C
+			&& search.hasString(
+					safeDiscString,
+					peParser.getSizeOfHeaders() - 0x2C))
 	{
 		addPacker(
 				DetectionMethod::SIGNATURE,
@@ -842,11 +1016,7 @@ void PeHeuristics::getEzirizReactorHeuristics()
 		const auto *sec0 = peParser.getPeSection(0);
 		const auto *sec1 = peParser.getPeSection(1);
 
-		if (sec0
-				&& search.findUnslashedSignature(
-						"558BECB90F0000006A006A004975F951535657B8--------E8;",
-						sec0->getOffset(),
-						sec0->getOffset() + sec0->getLoadedSize() - 1))
+		if (sec0 && findSignatureInArea(firstSectionArea, ezirizSignature))
 		{
 			version = "3.X";
 		}
@@ -905,10 +1075,9 @@ void PeHeuristics::getUpxHeuristics()
 
 	// UPX 1.00 - UPX 1.07
 	// format: UPX 1.0x
-	const std::string upxVer = "UPX 1.0";
 	const auto &content = search.getPlainString();
-	auto pos = content.find(upxVer);
-	if (pos < 0x500 && pos < content.length() - upxVer.length())
+	auto pos = findStringInArea(headerArea, upx10String);
+	if (pos < HEADER_AREA_SIZE && pos < content.length() - upx10String.length())
 	{
 		// we must decide between UPX and UPX$HiT
 		source = DetectionMethod::COMBINED;
@@ -926,7 +1095,7 @@ void PeHeuristics::getUpxHeuristics()
 					source,
 					strength,
 					"UPX",
-					versionPrefix + content[pos + upxVer.length()]
+					versionPrefix + content[pos + upx10String.length()]
 			);
 		}
 
@@ -936,8 +1105,11 @@ void PeHeuristics::getUpxHeuristics()
 	// UPX 1.08 and later
 	// format: x.xx'\0'UPX!
 	const std::size_t minPos = 5, verLen = 4;
-	pos = content.find("UPX!");
-	if (pos >= minPos && pos < 0x500 && !sections.empty() && pos < sections[0]->getOffset())
+	pos = findStringInArea(headerArea, upxString);
+	if (pos >= minPos
+			&& pos < HEADER_AREA_SIZE
+			&& !sections.empty()
+			&& pos < sections[0]->getOffset())
 	{
 		std::string version;
 		std::size_t num;
@@ -985,13 +1157,12 @@ void PeHeuristics::getPeCompactHeuristics()
 	auto strength = DetectionStrength::MEDIUM;
 
 	// format: PEC2[any character]O
-	const std::string pattern = "PEC2";
-	const auto patLen = pattern.length();
+	const auto patLen = peCompactString.length();
 
 	const auto &content = search.getPlainString();
-	const auto pos = content.find(pattern);
+	const auto pos = findStringInArea(headerArea, peCompactString);
 
-	if (pos < 0x500
+	if (pos < HEADER_AREA_SIZE
 			&& pos + patLen + 2 <= content.length()
 			&& content[pos + patLen + 1] == 'O')
 	{
@@ -1007,7 +1178,9 @@ void PeHeuristics::getPeCompactHeuristics()
 		addPacker(source, strength, "PECompact");
 	}
 
-	if (search.hasString("PECompact2", 0, 0x4FF))
+	const auto pos2 = findStringInArea(headerArea, peCompact2String);
+	if (pos2 != std::string::npos
+			&& pos2 + peCompact2String.length() <= HEADER_AREA_SIZE)
 	{
 		addPacker(source, strength, "PECompact", "2.xx - 3.xx");
 	}
@@ -1049,7 +1222,10 @@ void PeHeuristics::getEnigmaHeuristics()
 		{
 			const std::string pattern = "Enigma protector v";
 			const auto &content = search.getPlainString();
-			const auto pos = content.find(pattern, sec->getOffset());
+			const auto pos = search.findString(
+					pattern,
+					sec->getOffset(),
+					sec->getOffset() + sec->getSizeInFile() + pattern.length() - 2);
 			if (pos < sec->getOffset() + sec->getSizeInFile()
 					&& pos <= content.length() - 4)
 			{
@@ -1094,7 +1270,7 @@ void PeHeuristics::getEnigmaHeuristics()
 	}
 
 	if (peParser.isDotNet()
-			&& search.hasStringInSection("\0\0\0ENIGMA"s, std::size_t(0)))
+			&& hasStringInArea(firstSectionArea, enigmaString))
 	{
 		addPacker(DetectionMethod::SIGNATURE, strength, "Enigma");
 		return;
@@ -1154,10 +1330,10 @@ void PeHeuristics::getAdeptProtectorHeuristics()
 	auto strength = DetectionStrength::MEDIUM;
 
 	if (peParser.isDotNet()
-			&& search.hasStringInSection("ByAdeptProtector", std::size_t(0)))
+			&& hasStringInArea(firstSectionArea, adeptProtectorString))
 	{
 		std::string version;
-		if (search.hasStringInSection("STAThreadAttribute", std::size_t(0)))
+		if (hasStringInArea(firstSectionArea, staThreadString))
 		{
 			version = "2.1";
 		}
@@ -1194,39 +1370,28 @@ void PeHeuristics::getNetHeuristic()
 	}
 
 	// normal string search
-	std::size_t idx = 0;
-	if (search.hasStringInSection(
-			"Protected_By_Attribute\0NETSpider.Attribute"s,
-			idx))
+	if (hasStringInArea(firstSectionArea, netSpiderString))
 	{
 		addPacker(source, strength, ".NET Spider", "0.5 - 1.3");
 	}
-	if (search.hasStringInSection(
-			"Protected/Packed with ReNET-Pack by stx",
-			idx))
+	if (hasStringInArea(firstSectionArea, reNetPackString))
 	{
 		addPacker(source, strength, "ReNET-pack");
 	}
-	if (search.hasStringInSection("\0NetzStarter\0netz\0"s, idx))
+	if (hasStringInArea(firstSectionArea, netzString))
 	{
 		addPacker(source, strength, ".NETZ");
 	}
 
 	// unslashed signatures
-	const auto *sec = fileParser.getSection(0);
-	if (canSearch && sec)
+	if (canSearch && firstSectionArea.valid)
 	{
 		std::string version;
-		const auto start = sec->getOffset();
-		const auto end = start + sec->getLoadedSize() - 1;
-
-		const std::string sig =
-			"0000010B160C----------0208----------0D0906085961D21304091E630861D21305070811051E62110460D19D081758;";
-		if (search.findUnslashedSignature(sig, start, end))
+		if (findSignatureInArea(firstSectionArea, phoenixSignature))
 		{
 			version = "1.7 - 1.8";
 		}
-		else if (search.hasStringInSection("?.resources", sec))
+		else if (hasStringInArea(firstSectionArea, phoenixString))
 		{
 			version = "1.x";
 		}
@@ -1235,18 +1400,12 @@ void PeHeuristics::getNetHeuristic()
 			addPacker(source, strength, "Phoenix", version);
 		}
 
-		if (search.findUnslashedSignature(
-				"282D00000A6F2E00000A14146F2F00000A;",
-				start,
-				end))
+		if (findSignatureInArea(firstSectionArea, assemblyInvokeSignature))
 		{
 			addPacker(source, strength, "AssemblyInvoke");
 		}
 
-		if (search.findUnslashedSignature(
-				"436C69005300650063007500720065;",
-				start,
-				end))
+		if (findSignatureInArea(firstSectionArea, cliSecureSignature))
 		{
 			addPacker(source, strength, "CliSecure");
 		}
@@ -1255,7 +1414,7 @@ void PeHeuristics::getNetHeuristic()
 		//       please see #231 (compilation bug with GCC 5).
 		for (const auto& str : dotNetShrinkPatterns)
 		{
-			if (search.findUnslashedSignature(str, start, end))
+			if (findSignatureInArea(firstSectionArea, str))
 			{
 				addPacker(source, strength, ".netshrink", "2.01 (demo)");
 				break;
@@ -1410,7 +1569,7 @@ void PeHeuristics::getMsvcIntelHeuristics()
 	if (std::none_of(msvcRuntimeStrings.begin(), msvcRuntimeStrings.end(),
 		[this] (const auto &str)
 		{
-			return this->search.hasStringInSection(str, ".rdata");
+			return this->hasStringInArea(this->rdataArea, str);
 		}
 	))
 	{
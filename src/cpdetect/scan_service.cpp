@@ -0,0 +1,223 @@
+/**
+ * @file src/cpdetect/scan_service.cpp
+ * @brief Service detecting tools in many inputs with resident rules.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include "retdec/fileformat/format_factory.h"
+#include "retdec/utils/thread_pool.h"
+#include "retdec/cpdetect/cpdetect.h"
+#include "retdec/cpdetect/scan_service.h"
+#include "retdec/yaracpp/yara_detector.h"
+
+using namespace retdec::fileformat;
+using namespace retdec::yaracpp;
+
+namespace retdec {
+namespace cpdetect {
+
+/**
+ * Slot of a running scan
+ *
+ * The constructor waits until the number of running scans drops below the
+ * limit of YARA, the destructor lets another scan start.
+ */
+class ScanService::ScanSlot
+{
+	private:
+		ScanService &service;
+	public:
+		explicit ScanSlot(ScanService &scanService) : service(scanService)
+		{
+			std::unique_lock<std::mutex> lock(service.scanSlotsMutex);
+			service.scanSlotsCond.wait(lock,
+				[this]() { return service.freeScanSlots > 0; });
+			--service.freeScanSlots;
+		}
+
+		~ScanSlot()
+		{
+			{
+				std::lock_guard<std::mutex> lock(service.scanSlotsMutex);
+				++service.freeScanSlots;
+			}
+			service.scanSlotsCond.notify_one();
+		}
+
+		ScanSlot(const ScanSlot&) = delete;
+		ScanSlot& operator=(const ScanSlot&) = delete;
+};
+
+/**
+ * Constructor
+ * @param serviceSettings Settings of the service
+ *
+ * All YARA rule sets from @p serviceSettings are compiled here. If any of
+ * them cannot be loaded, the service is not in a valid state.
+ */
+ScanService::ScanService(const Settings &serviceSettings)
+		: settings(serviceSettings),
+		freeScanSlots(YaraDetector::getMaxConcurrentScans())
+{
+	for (const auto &ruleSet : settings.yaraRuleSets)
+	{
+		auto rules = std::make_unique<YaraDetector>();
+		stateIsValid &= rules->isInValidState();
+
+		unsigned cntr = 0;
+		for (const auto &ruleFile : ruleSet.second)
+		{
+			std::string nameSpace = ruleSet.first + "_" + std::to_string(cntr++);
+			stateIsValid &= rules->addRuleFile(ruleFile, nameSpace);
+		}
+
+		stateIsValid &= rules->compileRules();
+		yaraRuleSets.emplace(ruleSet.first, std::move(rules));
+	}
+}
+
+/**
+ * Destructor
+ */
+ScanService::~ScanService() = default;
+
+/**
+ * Get compiled signatures from the given internal rule files (and external
+ * databases from settings)
+ * @param internalRuleFiles Internal rule files
+ * @return Compiled signatures
+ *
+ * Signatures are compiled when they are requested for the first time. Inputs
+ * of the same format and architecture share them.
+ */
+const YaraDetector* ScanService::getSignatures(
+		const std::vector<std::string> &internalRuleFiles)
+{
+	std::lock_guard<std::mutex> lock(signaturesMutex);
+
+	auto &rules = signatures[internalRuleFiles];
+	if (!rules)
+	{
+		rules = std::make_unique<YaraDetector>();
+
+		unsigned iCntr = 0;
+		for (const auto &ruleFile : internalRuleFiles)
+		{
+			std::string nameSpace = "internal_" + std::to_string(iCntr++);
+			rules->addRuleFile(ruleFile, nameSpace);
+		}
+
+		unsigned eCntr = 0;
+		for (const auto &ruleFile : settings.externalDatabases)
+		{
+			std::string nameSpace = "external_" + std::to_string(eCntr++);
+			rules->addRuleFile(ruleFile, nameSpace);
+		}
+
+		rules->compileRules();
+	}
+
+	return rules.get();
+}
+
+/**
+ * Getter for state of instance
+ * @return @c true if all YARA rule sets were loaded, @c false otherwise
+ */
+bool ScanService::isInValidState() const
+{
+	return stateIsValid;
+}
+
+/**
+ * Get settings of the service
+ */
+const ScanService::Settings& ScanService::getSettings() const
+{
+	return settings;
+}
+
+/**
+ * Get number of distinct sets of tool signatures compiled so far
+ * @return Number of compiled signature sets; inputs with the same rule
+ *    files share one set
+ */
+std::size_t ScanService::getNumberOfCompiledSignatures() const
+{
+	std::lock_guard<std::mutex> lock(signaturesMutex);
+	return signatures.size();
+}
+
+/**
+ * Scan one input
+ * @param data Content of the input
+ * @param size Size of the input
+ * @return Detected tools and matched YARA rules
+ *
+ * This method can be called from multiple threads at once. If too many
+ * scans are already running, it waits until one of them finishes.
+ */
+ScanService::Result ScanService::scan(const std::uint8_t *data, std::size_t size)
+{
+	ScanSlot slot(*this);
+	Result result;
+
+	// YARA rules do not depend on the format of the input.
+	for (const auto &ruleSet : yaraRuleSets)
+	{
+		std::vector<YaraRule> detected;
+		result.yaraFailed |= !ruleSet.second->analyze(data, size, detected);
+		if (!detected.empty())
+		{
+			result.yaraMatches.emplace(ruleSet.first, std::move(detected));
+		}
+	}
+
+	auto parser = createFileFormat(data, size);
+	if (!parser)
+	{
+		result.status = ReturnCode::UNKNOWN_FORMAT;
+		return result;
+	}
+
+	result.format = parser->getFileFormat();
+	if (!parser->isInValidState())
+	{
+		result.status = ReturnCode::FORMAT_PARSER_PROBLEM;
+		return result;
+	}
+
+	DetectParams params(
+			settings.searchType,
+			true,
+			false,
+			settings.epBytesCount);
+	CompilerDetector detector(*parser, params, result.toolInfo);
+	detector.setSignatures(getSignatures(detector.getInternalRuleFiles()));
+	result.status = detector.getAllInformation();
+
+	return result;
+}
+
+/**
+ * Scan all the given inputs concurrently
+ * @param inputs Contents of the inputs
+ * @return Results in the same order as @p inputs
+ */
+std::vector<ScanService::Result> ScanService::scan(
+		const std::vector<std::vector<std::uint8_t>> &inputs)
+{
+	std::vector<Result> results(inputs.size());
+	retdec::utils::parallelFor(0, inputs.size(),
+		[&](std::size_t i)
+		{
+			results[i] = scan(inputs[i].data(), inputs[i].size());
+		},
+		retdec::utils::CancellationToken(),
+		1
+	);
+	return results;
+}
+
+} // namespace cpdetect
+} // namespace retdec
@@ -309,6 +309,96 @@ unsigned long long Search::findUnslashedSignature(
 	return (it != stopIterator) ? countImpNibbles(signPattern) : 0;
 }
 
+/**
+ * Search for several unslashed signatures in one pass over selected area
+ * of file
+ * @param signPatterns Signature patterns
+ * @param startOffset Start offset in file (in bytes)
+ * @param stopOffset Stop offset in file (in bytes)
+ * @return For each pattern from @a signPatterns the same value as returned
+ *         by findUnslashedSignature() called with that pattern
+ */
+std::vector<unsigned long long> Search::findUnslashedSignatures(
+		const std::vector<std::string> &signPatterns,
+		std::size_t startOffset,
+		std::size_t stopOffset) const
+{
+	std::vector<unsigned long long> result(signPatterns.size(), 0);
+	if (startOffset > stopOffset)
+	{
+		return result;
+	}
+
+	const auto startIndex = nibblesFromBytes(startOffset);
+	const auto stopIndex = std::min(
+			nibblesFromBytes(stopOffset) + 1,
+			nibbles.size());
+	const auto areaSize = startIndex < stopIndex ? stopIndex - startIndex : 0;
+
+	// Indexes of patterns by their first nibble, patterns starting with
+	// a wildcard must be tried on every position
+	std::vector<std::vector<std::size_t>> byFirstNibble(256);
+	std::vector<std::size_t> withWildcard;
+	std::vector<bool> found(signPatterns.size(), false);
+	std::size_t remaining = 0;
+	for (std::size_t i = 0, e = signPatterns.size(); i < e; ++i)
+	{
+		const auto &pattern = signPatterns[i];
+		if (pattern.empty() || pattern.size() > areaSize)
+		{
+			continue;
+		}
+
+		const auto first = pattern[0];
+		if (first == '-' || first == '?' || first == ';')
+		{
+			withWildcard.push_back(i);
+		}
+		else
+		{
+			byFirstNibble[static_cast<unsigned char>(first)].push_back(i);
+		}
+		++remaining;
+	}
+
+	const auto tryPattern = [&] (std::size_t patternIndex, std::size_t fileIndex)
+	{
+		const auto &pattern = signPatterns[patternIndex];
+		if (found[patternIndex] || stopIndex - fileIndex < pattern.size())
+		{
+			return;
+		}
+
+		for (std::size_t i = 0, e = pattern.size(); i < e; ++i)
+		{
+			const auto c = pattern[i];
+			if (c != nibbles[fileIndex + i] && c != '-' && c != '?' && c != ';')
+			{
+				return;
+			}
+		}
+
+		found[patternIndex] = true;
+		result[patternIndex] = countImpNibbles(pattern);
+		--remaining;
+	};
+
+	for (auto i = startIndex; i < stopIndex && remaining; ++i)
+	{
+		const auto nibble = static_cast<unsigned char>(nibbles[i]);
+		for (const auto patternIndex : byFirstNibble[nibble])
+		{
+			tryPattern(patternIndex, i);
+		}
+		for (const auto patternIndex : withWildcard)
+		{
+			tryPattern(patternIndex, i);
+		}
+	}
+
+	return result;
+}
+
 /**
  * Search if there is a slash(es) containing pattern in selected area
  * @param signPattern Signature pattern
@@ -624,6 +714,80 @@ bool Search::hasStringInSection(
 	return hasStringInSection(str, parser.getSection(sectionName));
 }
 
+/**
+ * Find the first occurrence of string in selected area of file
+ * @param str Coveted string
+ * @param startOffset Start offset in file (in bytes)
+ * @param stopOffset Stop offset in file (in bytes)
+ * @return Offset of @a str in file or @c std::string::npos if string
+ *         is not present in selected area of file
+ */
+std::size_t Search::findString(
+		const std::string &str,
+		std::size_t startOffset,
+		std::size_t stopOffset) const
+{
+	return findStrings({str}, startOffset, stopOffset)[0];
+}
+
+/**
+ * Find the first occurrences of several strings in one pass over selected
+ * area of file
+ * @param strs Coveted strings
+ * @param startOffset Start offset in file (in bytes)
+ * @param stopOffset Stop offset in file (in bytes)
+ * @return For each string from @a strs its offset in file or
+ *         @c std::string::npos if string is not present in selected area
+ *         of file
+ *
+ * String is present in the area if it starts at @a startOffset or after it
+ * and ends at @a stopOffset or before it.
+ */
+std::vector<std::size_t> Search::findStrings(
+		const std::vector<std::string> &strs,
+		std::size_t startOffset,
+		std::size_t stopOffset) const
+{
+	std::vector<std::size_t> result(strs.size(), std::string::npos);
+	if (startOffset > stopOffset || startOffset >= plain.size())
+	{
+		return result;
+	}
+
+	const auto stopIndex = stopOffset < plain.size()
+			? stopOffset + 1
+			: plain.size();
+
+	std::vector<std::vector<std::size_t>> byFirstChar(256);
+	std::size_t remaining = 0;
+	for (std::size_t i = 0, e = strs.size(); i < e; ++i)
+	{
+		if (!strs[i].empty() && strs[i].size() <= stopIndex - startOffset)
+		{
+			byFirstChar[static_cast<unsigned char>(strs[i][0])].push_back(i);
+			++remaining;
+		}
+	}
+
+	for (auto i = startOffset; i < stopIndex && remaining; ++i)
+	{
+		const auto c = static_cast<unsigned char>(plain[i]);
+		for (const auto strIndex : byFirstChar[c])
+		{
+			const auto &str = strs[strIndex];
+			if (result[strIndex] == std::string::npos
+					&& stopIndex - i >= str.size()
+					&& !plain.compare(i, str.size(), str))
+			{
+				result[strIndex] = i;
+				--remaining;
+			}
+		}
+	}
+
+	return result;
+}
+
 /**
  * Create signature from specified offset
  * @param pattern Into this parameter is stored resulted signature
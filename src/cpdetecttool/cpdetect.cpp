@@ -0,0 +1,804 @@
+/**
+ * @file src/cpdetecttool/cpdetect.cpp
+ * @brief Tool detection service and its local socket frontend.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ *
+ * Protocol of the socket frontend: a client connects to the socket and sends
+ * any number of requests. Every request is the size of the input (8 bytes,
+ * little endian) followed by the content of the input. The server answers
+ * every request by the size of the response (8 bytes, little endian)
+ * followed by the result of the scan in JSON. The connection is closed by
+ * the client, or by the server when a request is larger than 256 MiB.
+ * At most 8 clients are served at once, further clients wait until one of
+ * them disconnects. The socket is accessible only to its owner.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include "retdec/utils/conversion.h"
+#include "retdec/utils/io/log.h"
+#include "retdec/utils/thread_pool.h"
+#include "retdec/utils/version.h"
+#include "retdec/cpdetect/errors.h"
+#include "retdec/cpdetect/scan_service.h"
+#include "retdec/fileformat/utils/other.h"
+
+using namespace retdec::utils;
+using namespace retdec::utils::io;
+using namespace retdec::cpdetect;
+using namespace rapidjson;
+
+namespace {
+
+/**
+ * Maximal size of a single request accepted by the server (256 MiB).
+ */
+const std::uint64_t MAX_REQUEST_SIZE = 256ull << 20;
+
+/**
+ * Requests are read in chunks of this size, so memory is allocated only
+ * for data that have actually arrived, not for the announced size.
+ */
+const std::size_t READ_CHUNK_SIZE = 1 << 20;
+
+/**
+ * Maximal number of clients served at once by the server. Every client
+ * holds at most one request in memory.
+ */
+const std::size_t MAX_CLIENTS = 8;
+
+/**
+ * Delay before accepting clients again after accept() failed.
+ */
+const std::chrono::milliseconds ACCEPT_RETRY_DELAY(100);
+
+/**
+ * Print usage.
+ *
+ * @param log usage logger object
+ */
+void printUsage(Logger& log)
+{
+	log << "Usage: retdec-cpdetect [OPTIONS] FILE [FILE ...]\n"
+	"       retdec-cpdetect [OPTIONS] --serve SOCKET\n"
+	"       retdec-cpdetect --socket SOCKET FILE [FILE ...]\n\n"
+	"Detects compilers, packers and other tools and matches YARA rules.\n"
+	"Results are printed as JSON, one line per input file.\n\n"
+	"Options:\n\n"
+	"-h --help\n"
+	"    Show this help.\n\n"
+	"--version\n"
+	"    Show RetDec version.\n\n"
+	"--serve SOCKET\n"
+	"    Keep all rules compiled and scan inputs sent by clients to the\n"
+	"    given local socket until killed.\n\n"
+	"--socket SOCKET\n"
+	"    Send input files to the server listening on the given socket\n"
+	"    instead of scanning them in this process.\n\n"
+	"--yara NAME=FILE\n"
+	"    Match YARA rules from FILE and report them in the rule set NAME.\n"
+	"    May be given multiple times.\n\n"
+	"--external FILE\n"
+	"    Use FILE as an external signature database.\n"
+	"    May be given multiple times.\n\n"
+	"--search-mode exact|similar|sim-list\n"
+	"    Type of signature search (default: exact).\n\n"
+	"--ep-bytes N\n"
+	"    Number of bytes to load from entry point (default: "
+			<< EP_BYTES_SIZE << ").\n\n"
+	"--max-threads N\n"
+	"    Limit the number of threads used for scanning\n"
+	"    (default: 0 = number of CPU threads).\n\n";
+}
+
+/**
+ * Print error message and return non-zero value.
+ *
+ * @param errorMessage message to print
+ * @return non-zero value
+ */
+int printError(
+	const std::string &errorMessage)
+{
+	Log::error() << Log::Error << errorMessage << "\n";
+	return 1;
+}
+
+/**
+ * Convert result of a scan to JSON.
+ *
+ * @param result result of a scan
+ * @return result as a single line JSON object
+ */
+std::string resultToJson(
+	const ScanService::Result &result)
+{
+	StringBuffer buffer;
+	Writer<StringBuffer> writer(buffer);
+	const auto &toolInfo = result.toolInfo;
+
+	writer.StartObject();
+	writer.Key("status");
+	writer.String(result.status == ReturnCode::OK
+			? "ok"
+			: getErrorMessage(result.status, result.format));
+	writer.Key("format");
+	writer.String(retdec::fileformat::getFileFormatNameFromEnum(result.format));
+	writer.Key("packed");
+	writer.String(packedToString(toolInfo.isPacked()));
+
+	writer.Key("tools");
+	writer.StartArray();
+	for (const auto &tool : toolInfo.detectedTools)
+	{
+		writer.StartObject();
+		writer.Key("type");
+		writer.String(toolTypeToString(tool.type));
+		writer.Key("name");
+		writer.String(tool.name);
+		writer.Key("version");
+		writer.String(tool.versionInfo);
+		writer.Key("additionalInfo");
+		writer.String(tool.additionalInfo);
+		writer.Key("method");
+		writer.String(detectionMetodToString(tool.source));
+		writer.Key("reliable");
+		writer.Bool(tool.isReliable());
+		writer.EndObject();
+	}
+	writer.EndArray();
+
+	writer.Key("languages");
+	writer.StartArray();
+	for (const auto &language : toolInfo.detectedLanguages)
+	{
+		writer.StartObject();
+		writer.Key("name");
+		writer.String(language.name);
+		writer.Key("additionalInfo");
+		writer.String(language.additionalInfo);
+		writer.Key("bytecode");
+		writer.Bool(language.bytecode);
+		writer.EndObject();
+	}
+	writer.EndArray();
+
+	writer.Key("yaraStatus");
+	writer.String(result.yaraFailed ? "failed" : "ok");
+
+	writer.Key("yara");
+	writer.StartObject();
+	for (const auto &ruleSet : result.yaraMatches)
+	{
+		writer.Key(ruleSet.first);
+		writer.StartArray();
+		for (const auto &rule : ruleSet.second)
+		{
+			writer.StartObject();
+			writer.Key("name");
+			writer.String(rule.getName());
+			writer.Key("metas");
+			writer.StartObject();
+			for (const auto &meta : rule.getMetas())
+			{
+				writer.Key(meta.getId());
+				if (meta.getType() == retdec::yaracpp::YaraMeta::Type::Int)
+				{
+					writer.Uint64(meta.getIntValue());
+				}
+				else
+				{
+					writer.String(meta.getStringValue());
+				}
+			}
+			writer.EndObject();
+			writer.EndObject();
+		}
+		writer.EndArray();
+	}
+	writer.EndObject();
+
+	writer.EndObject();
+	return buffer.GetString();
+}
+
+/**
+ * Print result of a scan with the name of the input.
+ *
+ * @param input name of the input
+ * @param json result of the scan in JSON
+ */
+void printResult(
+	const std::string &input,
+	const std::string &json)
+{
+	Document result;
+	result.Parse(json.c_str());
+	if (!result.IsObject())
+	{
+		printError("invalid response for " + input);
+		return;
+	}
+
+	auto &alloc = result.GetAllocator();
+	Value name(input.c_str(), alloc);
+	result.AddMember("input", name, alloc);
+
+	StringBuffer buffer;
+	Writer<StringBuffer> writer(buffer);
+	result.Accept(writer);
+	Log::info() << buffer.GetString() << "\n";
+}
+
+/**
+ * Read the whole file.
+ *
+ * @param path path to the file
+ * @param bytes content of the file
+ * @return @c true if the file was read, @c false otherwise
+ */
+bool readFile(
+	const std::string &path,
+	std::vector<std::uint8_t> &bytes)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+
+	bytes.assign(
+			std::istreambuf_iterator<char>(file),
+			std::istreambuf_iterator<char>());
+	return !file.bad();
+}
+
+/**
+ * Scan the given files in this process.
+ *
+ * Every file is read by the task that scans it, so only files that are
+ * being scanned are held in memory.
+ *
+ * @param settings settings of the service
+ * @param inputs input files
+ * @return application error code
+ */
+int scanLocally(
+	const ScanService::Settings &settings,
+	const std::vector<std::string> &inputs)
+{
+	ScanService service(settings);
+	if (!service.isInValidState())
+	{
+		return printError("unable to load YARA rules");
+	}
+
+	std::vector<std::string> results(inputs.size());
+	std::vector<char> readFailed(inputs.size(), false);
+	parallelFor(0, inputs.size(),
+		[&](std::size_t i)
+		{
+			std::vector<std::uint8_t> content;
+			if (!readFile(inputs[i], content))
+			{
+				readFailed[i] = true;
+				return;
+			}
+			results[i] = resultToJson(service.scan(content.data(), content.size()));
+		},
+		CancellationToken(),
+		1
+	);
+
+	int ret = 0;
+	for (std::size_t i = 0; i < inputs.size(); ++i)
+	{
+		if (readFailed[i])
+		{
+			ret = printError("unable to read " + inputs[i]);
+		}
+		else
+		{
+			printResult(inputs[i], results[i]);
+		}
+	}
+
+	return ret;
+}
+
+#ifndef _WIN32
+
+/**
+ * Read exactly @a size bytes from the socket.
+ */
+bool readAll(int fd, void *data, std::size_t size)
+{
+	auto *ptr = static_cast<char*>(data);
+	while (size > 0)
+	{
+		auto n = ::read(fd, ptr, size);
+		if (n <= 0)
+		{
+			return false;
+		}
+		ptr += n;
+		size -= n;
+	}
+	return true;
+}
+
+/**
+ * Write exactly @a size bytes into the socket.
+ */
+bool writeAll(int fd, const void *data, std::size_t size)
+{
+	const auto *ptr = static_cast<const char*>(data);
+	while (size > 0)
+	{
+		auto n = ::write(fd, ptr, size);
+		if (n <= 0)
+		{
+			return false;
+		}
+		ptr += n;
+		size -= n;
+	}
+	return true;
+}
+
+/**
+ * Read the size of a message (8 bytes, little endian).
+ */
+bool readSize(int fd, std::uint64_t &size)
+{
+	std::uint8_t bytes[8];
+	if (!readAll(fd, bytes, sizeof(bytes)))
+	{
+		return false;
+	}
+
+	size = 0;
+	for (std::size_t i = 0; i < sizeof(bytes); ++i)
+	{
+		size |= std::uint64_t(bytes[i]) << (8 * i);
+	}
+	return true;
+}
+
+/**
+ * Write a message preceded by its size (8 bytes, little endian).
+ */
+bool writeMessage(int fd, const void *data, std::uint64_t size)
+{
+	std::uint8_t bytes[8];
+	for (std::size_t i = 0; i < sizeof(bytes); ++i)
+	{
+		bytes[i] = static_cast<std::uint8_t>(size >> (8 * i));
+	}
+	return writeAll(fd, bytes, sizeof(bytes)) && writeAll(fd, data, size);
+}
+
+/**
+ * Fill the address of the given local socket.
+ */
+bool getSocketAddress(const std::string &path, sockaddr_un &address)
+{
+	address = sockaddr_un();
+	address.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(address.sun_path))
+	{
+		return false;
+	}
+	path.copy(address.sun_path, path.size());
+	return true;
+}
+
+/**
+ * Read the content of a request of the given size.
+ *
+ * @param fd socket connected to the client
+ * @param size size of the request
+ * @param input content of the request
+ * @return @c true if the whole request was read, @c false otherwise
+ */
+bool readRequest(int fd, std::uint64_t size, std::vector<std::uint8_t> &input)
+{
+	input.clear();
+	while (input.size() < size)
+	{
+		auto offset = input.size();
+		auto chunk = std::min<std::uint64_t>(size - offset, READ_CHUNK_SIZE);
+		input.resize(offset + chunk);
+		if (!readAll(fd, input.data() + offset, chunk))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Scan the input in the global thread pool and wait for the result.
+ *
+ * @param service service scanning the inputs
+ * @param input content of the input
+ * @return result of the scan in JSON
+ */
+std::string scanInPool(
+	ScanService &service,
+	const std::vector<std::uint8_t> &input)
+{
+	auto task = std::make_shared<std::packaged_task<std::string()>>(
+		[&service, &input]()
+		{
+			return resultToJson(service.scan(input.data(), input.size()));
+		});
+	auto response = task->get_future();
+	ThreadPool::global().submit([task]() { (*task)(); });
+	return response.get();
+}
+
+/**
+ * Serve all requests of a single client.
+ *
+ * @param service service scanning the inputs
+ * @param fd socket connected to the client
+ */
+void serveClient(
+	ScanService &service,
+	int fd)
+{
+	std::uint64_t size = 0;
+	std::vector<std::uint8_t> input;
+	while (readSize(fd, size) && size <= MAX_REQUEST_SIZE)
+	{
+		if (!readRequest(fd, size, input))
+		{
+			break;
+		}
+
+		auto response = scanInPool(service, input);
+		if (!writeMessage(fd, response.data(), response.size()))
+		{
+			break;
+		}
+	}
+	::close(fd);
+}
+
+/**
+ * Accept clients on the given socket and serve them one after another.
+ *
+ * Never returns; the server runs until it is killed.
+ *
+ * @param service service scanning the inputs
+ * @param server listening socket
+ */
+[[noreturn]] void acceptClients(
+	ScanService &service,
+	int server)
+{
+	while (true)
+	{
+		int client = ::accept(server, nullptr, nullptr);
+		if (client < 0)
+		{
+			// Out of descriptors or memory; wait for other clients to
+			// disconnect instead of retrying at once.
+			if (errno != EINTR)
+			{
+				std::this_thread::sleep_for(ACCEPT_RETRY_DELAY);
+			}
+			continue;
+		}
+
+		try
+		{
+			serveClient(service, client);
+		}
+		catch (...)
+		{
+			::close(client);
+		}
+	}
+}
+
+/**
+ * Remove a socket left at the given path by a previous server.
+ *
+ * Other files are kept, so binding to them fails.
+ */
+void removeStaleSocket(const std::string &socketPath)
+{
+	struct stat info;
+	if (::lstat(socketPath.c_str(), &info) == 0 && S_ISSOCK(info.st_mode))
+	{
+		::unlink(socketPath.c_str());
+	}
+}
+
+/**
+ * Listen on the given socket and scan inputs sent by clients.
+ *
+ * Clients are served by a fixed number of threads, which only read requests
+ * and write responses, so at most @c MAX_CLIENTS clients are connected at
+ * once; others wait in the backlog of the socket. Inputs are scanned by the
+ * global thread pool, so at most as many inputs as there are threads are
+ * scanned at once and slow clients do not occupy the pool.
+ *
+ * The socket is accessible only to the user running the server.
+ *
+ * @param settings settings of the service
+ * @param socketPath path to the socket
+ * @return application error code
+ */
+int serve(
+	const ScanService::Settings &settings,
+	const std::string &socketPath)
+{
+	ScanService service(settings);
+	if (!service.isInValidState())
+	{
+		return printError("unable to load YARA rules");
+	}
+
+	sockaddr_un address;
+	if (!getSocketAddress(socketPath, address))
+	{
+		return printError("too long socket path " + socketPath);
+	}
+
+	// Clients may disconnect at any time.
+	std::signal(SIGPIPE, SIG_IGN);
+
+	int server = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (server < 0)
+	{
+		return printError("unable to listen on " + socketPath);
+	}
+
+	removeStaleSocket(socketPath);
+	auto oldMask = ::umask(S_IRWXG | S_IRWXO);
+	bool bound = ::bind(
+			server,
+			reinterpret_cast<sockaddr*>(&address),
+			sizeof(address)) == 0;
+	::umask(oldMask);
+	if (!bound || ::listen(server, SOMAXCONN) != 0)
+	{
+		::close(server);
+		return printError("unable to listen on " + socketPath);
+	}
+
+	std::vector<std::thread> servers;
+	for (std::size_t i = 1; i < MAX_CLIENTS; ++i)
+	{
+		try
+		{
+			servers.emplace_back(acceptClients, std::ref(service), server);
+		}
+		catch (const std::system_error &)
+		{
+			break;
+		}
+	}
+
+	acceptClients(service, server);
+}
+
+/**
+ * Send the given files to the server and print its responses.
+ *
+ * @param socketPath path to the socket of the server
+ * @param inputs input files
+ * @return application error code
+ */
+int scanRemotely(
+	const std::string &socketPath,
+	const std::vector<std::string> &inputs)
+{
+	sockaddr_un address;
+	if (!getSocketAddress(socketPath, address))
+	{
+		return printError("too long socket path " + socketPath);
+	}
+
+	int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0
+			|| ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		return printError("unable to connect to " + socketPath);
+	}
+
+	int ret = 0;
+	std::vector<std::uint8_t> input;
+	std::string response;
+	for (const auto &path : inputs)
+	{
+		std::uint64_t size = 0;
+		if (!readFile(path, input))
+		{
+			ret = printError("unable to read " + path);
+			break;
+		}
+		if (!writeMessage(fd, input.data(), input.size())
+				|| !readSize(fd, size))
+		{
+			ret = printError("connection to " + socketPath + " lost");
+			break;
+		}
+
+		response.resize(size);
+		if (!readAll(fd, &response[0], response.size()))
+		{
+			ret = printError("connection to " + socketPath + " lost");
+			break;
+		}
+		printResult(path, response);
+	}
+
+	::close(fd);
+	return ret;
+}
+
+#else
+
+int serve(
+	const ScanService::Settings &,
+	const std::string &)
+{
+	return printError("--serve is not supported on this platform");
+}
+
+int scanRemotely(
+	const std::string &,
+	const std::vector<std::string> &)
+{
+	return printError("--socket is not supported on this platform");
+}
+
+#endif
+
+/**
+ * Process arguments and run the chosen action.
+ *
+ * @param args vector with command line arguments
+ * @return application error code
+ */
+int doActions(
+	const std::vector<std::string> &args)
+{
+	ScanService::Settings settings;
+	std::string serveSocket;
+	std::string clientSocket;
+	std::vector<std::string> inputs;
+
+	for (std::size_t i = 0; i < args.size(); ++i)
+	{
+		const auto &arg = args[i];
+		bool hasValue = i + 1 < args.size();
+
+		if (arg == "-h" || arg == "--help")
+		{
+			printUsage(Log::get(Log::Type::Info));
+			return 0;
+		}
+		else if (arg == "--version")
+		{
+			Log::info() << version::getVersionStringLong() << "\n";
+			return 0;
+		}
+		else if (arg == "--serve" && hasValue)
+		{
+			serveSocket = args[++i];
+		}
+		else if (arg == "--socket" && hasValue)
+		{
+			clientSocket = args[++i];
+		}
+		else if (arg == "--yara" && hasValue)
+		{
+			const auto &value = args[++i];
+			auto eq = value.find('=');
+			if (eq == std::string::npos || eq == 0)
+			{
+				return printError("invalid --yara value " + value);
+			}
+			settings.yaraRuleSets[value.substr(0, eq)].insert(value.substr(eq + 1));
+		}
+		else if (arg == "--external" && hasValue)
+		{
+			settings.externalDatabases.push_back(args[++i]);
+		}
+		else if (arg == "--search-mode" && hasValue)
+		{
+			const auto &value = args[++i];
+			if (value == "exact")
+			{
+				settings.searchType = SearchType::EXACT_MATCH;
+			}
+			else if (value == "similar")
+			{
+				settings.searchType = SearchType::MOST_SIMILAR;
+			}
+			else if (value == "sim-list")
+			{
+				settings.searchType = SearchType::SIM_LIST;
+			}
+			else
+			{
+				return printError("invalid --search-mode value " + value);
+			}
+		}
+		else if (arg == "--ep-bytes" && hasValue)
+		{
+			if (!strToNum(args[++i], settings.epBytesCount))
+			{
+				return printError("invalid --ep-bytes value " + args[i]);
+			}
+		}
+		else if (arg == "--max-threads" && hasValue)
+		{
+			std::size_t threads = 0;
+			if (!strToNum(args[++i], threads))
+			{
+				return printError("invalid --max-threads value " + args[i]);
+			}
+			ThreadPool::setMaxConcurrency(threads);
+		}
+		else if (!arg.empty() && arg[0] == '-')
+		{
+			return printError("invalid argument " + arg);
+		}
+		else
+		{
+			inputs.push_back(arg);
+		}
+	}
+
+	if (!serveSocket.empty())
+	{
+		return serve(settings, serveSocket);
+	}
+	else if (inputs.empty())
+	{
+		printUsage(Log::get(Log::Type::Error));
+		return 1;
+	}
+	else if (!clientSocket.empty())
+	{
+		return scanRemotely(clientSocket, inputs);
+	}
+
+	return scanLocally(settings, inputs);
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+	return doActions(std::vector<std::string>(argv + 1, argv + argc));
+}
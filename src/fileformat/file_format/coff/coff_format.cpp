@@ -342,6 +342,7 @@ void CoffFormat::loadSections()
 void CoffFormat::loadSymbols()
 {
 	auto *table = new SymbolTable();
+	table->reserve(file->getNumberOfSymbols());
 	std::size_t index = 0;
 
 	for(const auto &item : file->symbols())
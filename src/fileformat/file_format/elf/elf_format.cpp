@@ -4,12 +4,15 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
 #include <elfio/elf_types.hpp>
+#include <fstream>
 #include <map>
 #include <regex>
 
 #include "retdec/utils/conversion.h"
 #include "retdec/utils/string.h"
+#include "retdec/utils/thread_pool.h"
 #include "retdec/fileformat/file_format/elf/elf_format.h"
 #include "retdec/fileformat/types/symbol_table/elf_symbol.h"
 #include "retdec/fileformat/utils/conversions.h"
@@ -1080,6 +1083,63 @@ Relocation createRelocation(const std::string &name, std::uint64_t offset, std::
 	return relocation;
 }
 
+/**
+ * Get load flags for ELF file with the given start
+ * @param header Start of file
+ * @param size Size of @a header
+ * @param loadFlags Load flags requested by caller
+ * @return @a loadFlags, with @c LoadFlags::LAZY_DIGESTS for core dumps
+ *
+ * Core dumps can be huge, so hashes of the whole file and digests of its
+ * segments are computed only if somebody asks for them. This has to be
+ * known before @c FileFormat computes the file hashes.
+ */
+LoadFlags getElfLoadFlags(const unsigned char *header, std::size_t size, LoadFlags loadFlags)
+{
+	if(size < EI_NIDENT + 2
+			|| header[EI_MAG0] != ELFMAG0 || header[EI_MAG1] != ELFMAG1
+			|| header[EI_MAG2] != ELFMAG2 || header[EI_MAG3] != ELFMAG3)
+	{
+		return loadFlags;
+	}
+
+	const std::uint16_t type = header[EI_DATA] == ELFDATA2MSB
+			? (header[EI_NIDENT] << 8) | header[EI_NIDENT + 1]
+			: header[EI_NIDENT] | (header[EI_NIDENT + 1] << 8);
+	return type == ET_CORE
+			? static_cast<LoadFlags>(loadFlags | LoadFlags::LAZY_DIGESTS)
+			: loadFlags;
+}
+
+/**
+ * Get load flags for ELF file read from the given stream
+ * @param inputStream Representation of input file, its position is kept
+ * @param loadFlags Load flags requested by caller
+ * @return The same value as the previous function
+ */
+LoadFlags getElfLoadFlags(std::istream &inputStream, LoadFlags loadFlags)
+{
+	unsigned char header[EI_NIDENT + 2] = {};
+	const auto position = inputStream.tellg();
+	inputStream.read(reinterpret_cast<char*>(header), sizeof(header));
+	const auto size = static_cast<std::size_t>(inputStream.gcount());
+	inputStream.clear();
+	inputStream.seekg(position);
+	return getElfLoadFlags(header, size, loadFlags);
+}
+
+/**
+ * Get load flags for ELF file with the given path
+ * @param pathToFile Path to input file
+ * @param loadFlags Load flags requested by caller
+ * @return The same value as the previous function
+ */
+LoadFlags getElfLoadFlags(const std::string &pathToFile, LoadFlags loadFlags)
+{
+	std::ifstream inputStream(pathToFile, std::ios::in | std::ios::binary);
+	return getElfLoadFlags(inputStream, loadFlags);
+}
+
 } // anonymous namespace
 
 /**
@@ -1088,7 +1148,7 @@ Relocation createRelocation(const std::string &name, std::uint64_t offset, std::
  * @param loadFlags Load flags
  */
 ElfFormat::ElfFormat(std::string pathToFile, LoadFlags loadFlags) :
-		FileFormat(pathToFile, loadFlags)
+		FileFormat(pathToFile, getElfLoadFlags(pathToFile, loadFlags))
 {
 	initStructures();
 }
@@ -1099,7 +1159,7 @@ ElfFormat::ElfFormat(std::string pathToFile, LoadFlags loadFlags) :
  * @param loadFlags Load flags
  */
 ElfFormat::ElfFormat(std::istream &inputStream, LoadFlags loadFlags) :
-		FileFormat(inputStream, loadFlags)
+		FileFormat(inputStream, getElfLoadFlags(inputStream, loadFlags))
 {
 	initStructures();
 }
@@ -1111,7 +1171,7 @@ ElfFormat::ElfFormat(std::istream &inputStream, LoadFlags loadFlags) :
  * @param loadFlags Load flags
  */
 ElfFormat::ElfFormat(const std::uint8_t *data, std::size_t size, LoadFlags loadFlags) :
-		FileFormat(data, size, loadFlags)
+		FileFormat(data, size, getElfLoadFlags(data, size, loadFlags))
 {
 	initStructures();
 }
@@ -1122,10 +1182,14 @@ ElfFormat::ElfFormat(const std::uint8_t *data, std::size_t size, LoadFlags loadF
 void ElfFormat::initStructures()
 {
 	elfClass = ELFCLASSNONE;
-	if(!(stateIsValid = reader.load(fileStream)))
+	// Whole file is already loaded in bytes, so ELFIO only references
+	// section and segment data instead of reading their copies.
+	const auto *fileData = reinterpret_cast<const char*>(bytes.data());
+	if(!(stateIsValid = reader.load(fileStream, fileData, bytes.size())))
 	{
 		return;
 	}
+	writer.set_file_data(fileData, bytes.size());
 	fileFormat = Format::ELF;
 	elfClass = reader.get_class();
 	loadSections();
@@ -1156,6 +1220,29 @@ std::size_t ElfFormat::initSectionTableHashOffsets()
 	return secHashInfo.size();
 }
 
+/**
+ * Set data of @a sec (usually from @a writer member of this class)
+ * @param sec Section to set data of
+ * @param data Section data
+ * @param size Size of @a data
+ *
+ * If @a data lie in the loaded input file, section only references them,
+ * otherwise they are copied.
+ */
+void ElfFormat::setSectionData(ELFIO::section *sec, const char *data, std::size_t size)
+{
+	const auto *fileData = reinterpret_cast<const char*>(bytes.data());
+	if(data && data >= fileData && data <= fileData + bytes.size()
+			&& size <= static_cast<std::size_t>(fileData + bytes.size() - data))
+	{
+		sec->set_data_reference(data, size);
+	}
+	else
+	{
+		sec->set_data(data, static_cast<ELFIO::Elf_Word>(size));
+	}
+}
+
 /**
  * Load ELF string table to @a writer member of this class
  * @param dynamicSection Section from @a writer which represents ELF dynamic segment
@@ -1206,7 +1293,7 @@ ELFIO::section* ElfFormat::addStringTable(ELFIO::section *dynamicSection, const
 				const auto* data = seg->get_data();
 				if(data)
 				{
-					stringTable->set_data(seg->get_data() + (strTabAddr - strTabSeg->getAddress()), strTabSize);
+					setSectionData(stringTable, seg->get_data() + (strTabAddr - strTabSeg->getAddress()), strTabSize);
 				}
 			}
 			else if(reader.get_istream())
@@ -1273,7 +1360,7 @@ ELFIO::section* ElfFormat::addSymbolTable(ELFIO::section *dynamicSection, const
 			symbolTable->set_addr_align(seg->get_align());
 			if(seg->get_data() && symTabSize + (symTabAddr - symTabSeg->getAddress()) <= symTabSeg->getSizeInFile())
 			{
-				symbolTable->set_data(seg->get_data() + (symTabAddr - symTabSeg->getAddress()), static_cast<Elf_Word>(symTabSize));
+				setSectionData(symbolTable, seg->get_data() + (symTabAddr - symTabSeg->getAddress()), symTabSize);
 			}
 			else if(reader.get_istream())
 			{
@@ -1331,7 +1418,7 @@ ELFIO::section* ElfFormat::addRelocationTable(ELFIO::section *dynamicSection, co
 			relocationTable->set_addr_align(seg->get_align());
 			if(seg->get_data() && info.size + (info.address - relSeg->getAddress()) <= relSeg->getSizeInFile())
 			{
-				relocationTable->set_data(seg->get_data() + (info.address - relSeg->getAddress()), info.size);
+				setSectionData(relocationTable, seg->get_data() + (info.address - relSeg->getAddress()), info.size);
 			}
 			else if(reader.get_istream())
 			{
@@ -1515,7 +1602,7 @@ ELFIO::section* ElfFormat::addGlobalOffsetTable(ELFIO::section *dynamicSection,
 				{
 					return nullptr;
 				}
-				gotTable->set_data(seg->get_data() + gotSegOffset, static_cast<Elf_Word>(w));
+				setSectionData(gotTable, seg->get_data() + gotSegOffset, w);
 			}
 		}
 	}
@@ -1628,9 +1715,10 @@ bool ElfFormat::getRelocationMask(unsigned relType, std::vector<std::uint8_t> &m
  * Load relocation tables which are related to @a symbolTable section
  * @param file Parser of ELF file
  * @param symbolTable Symbol table section
- * @param nameAddressMap Into this multimap is stored name and address of each stored relocation
+ * @param nameAddressMap Into this map are stored sorted unique addresses of stored relocations
+ *    for each relocation name
  */
-void ElfFormat::loadRelocations(const ELFIO::elfio *file, const ELFIO::section *symbolTable, std::unordered_multimap<std::string, unsigned long long> &nameAddressMap)
+void ElfFormat::loadRelocations(const ELFIO::elfio *file, const ELFIO::section *symbolTable, std::unordered_map<std::string, std::vector<unsigned long long>> &nameAddressMap)
 {
 	Relocation relocation;
 	std::string relName;
@@ -1678,7 +1766,7 @@ void ElfFormat::loadRelocations(const ELFIO::elfio *file, const ELFIO::section *
 						}
 						appSecs[i] ? relocation.setLinkToSection(appSecs[i]->get_index()) : relocation.invalidateLinkToSection();
 						reltab->addRelocation(relocation);
-						nameAddressMap.emplace(relName, relOffset + addrOffset);
+						nameAddressMap[relName].push_back(relOffset + addrOffset);
 					}
 				}
 			}
@@ -1697,7 +1785,7 @@ void ElfFormat::loadRelocations(const ELFIO::elfio *file, const ELFIO::section *
 				relocation.setLinkToSymbol(relSymbol);
 
 				reltab->addRelocation(relocation);
-				nameAddressMap.emplace(relName, relOffset + addrOffset);
+				nameAddressMap[relName].push_back(relOffset + addrOffset);
 			}
 		}
 
@@ -1705,6 +1793,14 @@ void ElfFormat::loadRelocations(const ELFIO::elfio *file, const ELFIO::section *
 		relocationTables.push_back(reltab);
 		delete relTables[i];
 	}
+
+	// sorted addresses ensure determinism of the created imports
+	for(auto &item : nameAddressMap)
+	{
+		auto &addresses = item.second;
+		std::sort(addresses.begin(), addresses.end());
+		addresses.erase(std::unique(addresses.begin(), addresses.end()), addresses.end());
+	}
 }
 
 /**
@@ -1733,7 +1829,7 @@ void ElfFormat::loadSymbols(const ELFIO::elfio *file, const ELFIO::symbol_sectio
 	Elf_Xword size = 0;
 	Elf64_Addr value = 0;
 	unsigned char bind = 0, type = 0, other = 0;
-	std::unordered_multimap<std::string, unsigned long long> importNameAddressMap;
+	std::unordered_map<std::string, std::vector<unsigned long long>> importNameAddressMap;
 	loadRelocations(file, section, importNameAddressMap);
 
 	/* check to ignore symbols from segments for telfhash this is pretty
@@ -1744,6 +1840,7 @@ void ElfFormat::loadSymbols(const ELFIO::elfio *file, const ELFIO::symbol_sectio
 		telfhashSymbols = {};
 	}
 
+	symtab->reserve(elfSymbolTable->get_loaded_symbols_num());
 	for(std::size_t i = 0, e = elfSymbolTable->get_loaded_symbols_num(); i < e; ++i)
 	{
 		auto symbol = std::make_shared<ElfSymbol>();
@@ -1780,18 +1877,19 @@ void ElfFormat::loadSymbols(const ELFIO::elfio *file, const ELFIO::symbol_sectio
 				{
 					importTable = new ElfImportTable();
 				}
-				auto keyIter = importNameAddressMap.equal_range(name);
-				// we create std::set from std::multimap values in order to ensure determinism
-				std::set<std::pair<std::string, unsigned long long>> addresses(keyIter.first, keyIter.second);
-				for(const auto &address : addresses)
+				auto keyIter = importNameAddressMap.find(name);
+				if(keyIter != importNameAddressMap.end())
 				{
-					auto import = std::make_unique<Import>();
-					import->setName(name);
-					import->setAddress(address.second);
-					import->setUsageType(symbolToImportUsage(symbol->getUsageType()));
-					importTable->addImport(std::move(import));
+					for(const auto address : keyIter->second)
+					{
+						auto import = std::make_unique<Import>();
+						import->setName(name);
+						import->setAddress(address);
+						import->setUsageType(symbolToImportUsage(symbol->getUsageType()));
+						importTable->addImport(std::move(import));
+					}
 				}
-				if(keyIter.first == keyIter.second && getSectionFromAddress(value))
+				else if(getSectionFromAddress(value))
 				{
 					auto import = std::make_unique<Import>();
 					import->setName(name);
@@ -2181,7 +2279,7 @@ void ElfFormat::loadInfoFromDynamicSegment()
 		dynamic->set_addr_align(seg->get_align());
 		dynamic->set_link(0);
 		dynamic->set_size(segSz);
-		dynamic->set_data(seg->get_data(), segSz);
+		setSectionData(dynamic, seg->get_data(), segSz);
 
 		dynamic_section_accessor accessor(writer, dynamic);
 		if (auto* tbl = loadDynamicTable(&accessor, dynamic))
@@ -2390,6 +2488,7 @@ void ElfFormat::loadNoteSecSeg(ElfNoteSecSeg& notes) const
 void ElfFormat::loadNotes()
 {
 	// Check sections first as they contain more information
+	std::vector<ElfNoteSecSeg> candidates;
 	for(const Section* sec : sections)
 	{
 		auto section = static_cast<const ElfSection*>(sec);
@@ -2397,14 +2496,10 @@ void ElfFormat::loadNotes()
 		if(section->getElfType() == SHT_NOTE
 				|| section->getName() == ".note.android.ident")
 		{
-			ElfNoteSecSeg res(section);
-			loadNoteSecSeg(res);
-			if(!res.isEmpty())
-			{
-				noteSecSegs.emplace_back(std::move(res));
-			}
+			candidates.emplace_back(section);
 		}
 	}
+	loadNoteSecSegs(candidates);
 
 	// Go to segments only if there are no sections or no information was
 	// loaded because SHT_NOTE sections must overlap with PT_NOTE segments
@@ -2414,17 +2509,34 @@ void ElfFormat::loadNotes()
 	}
 
 	// Check segments - kernel core dumps do not create sections
+	candidates.clear();
 	for(const Segment* seg : segments)
 	{
 		auto segment = static_cast<const ElfSegment*>(seg);
 		if(segment->getElfType() == PT_NOTE)
 		{
-			ElfNoteSecSeg res(segment);
-			loadNoteSecSeg(res);
-			if(!res.isEmpty())
-			{
-				noteSecSegs.emplace_back(std::move(res));
-			}
+			candidates.emplace_back(segment);
+		}
+	}
+	loadNoteSecSegs(candidates);
+}
+
+/**
+ * Load notes from all @a candidates in parallel and keep non-empty ones
+ * @param candidates Note sections or segments
+ */
+void ElfFormat::loadNoteSecSegs(std::vector<ElfNoteSecSeg> &candidates)
+{
+	utils::parallelFor(0, candidates.size(), [this, &candidates](std::size_t i)
+	{
+		loadNoteSecSeg(candidates[i]);
+	});
+
+	for(auto &res : candidates)
+	{
+		if(!res.isEmpty())
+		{
+			noteSecSegs.emplace_back(std::move(res));
 		}
 	}
 }
@@ -2433,11 +2545,12 @@ void ElfFormat::loadNotes()
  * Load file map from core file
  * @param offset offset off NT_FILE note data
  * @param size size of NT_FILE note data
+ * @param info structure to store the file map into
  *
  * This function expects only data from non-malformed notes to avoid multiple
  * offset sanity checks. Make sure this is not used with malformed notes!
  */
-void ElfFormat::loadCoreFileMap(std::size_t offset, std::size_t size)
+void ElfFormat::loadCoreFileMap(std::size_t offset, std::size_t size, ElfCoreInfo &info) const
 {
 	const auto endianness = getEndianness();
 	// As I have only two 32-bit MIPS samples from lldb test repository,
@@ -2459,6 +2572,7 @@ void ElfFormat::loadCoreFileMap(std::size_t offset, std::size_t size)
 	std::uint64_t pageSize;
 	getXByteOffset(currOff, entrySize, pageSize, endianness);
 	currOff += entrySize;
+	info.setPageSize(pageSize);
 
 	// We will use this to extract strings so we have to retype to signed type
 	const char* data = reinterpret_cast<const char*>(getLoadedBytes().data());
@@ -2483,7 +2597,7 @@ void ElfFormat::loadCoreFileMap(std::size_t offset, std::size_t size)
 		entry.filePath = data + pathOff;
 		pathOff += entry.filePath.size() + 1;
 
-		elfCoreInfo->addFileMapEntry(entry);
+		info.addFileMapEntry(entry);
 	}
 }
 
@@ -2491,11 +2605,12 @@ void ElfFormat::loadCoreFileMap(std::size_t offset, std::size_t size)
  * Load prstatus info struct from core file
  * @param offset offset off NT_PRSTATUS note data
  * @param size size of NT_PRSTATUS note data
+ * @param coreInfo structure to store the prstatus info into
  *
  * This function expects only data from non-malformed notes to avoid multiple
  * offset sanity checks. Make sure this is not used with malformed notes!
  */
-void ElfFormat::loadCorePrStat(std::size_t offset, std::size_t size)
+void ElfFormat::loadCorePrStat(std::size_t offset, std::size_t size, ElfCoreInfo &coreInfo) const
 {
 	PrStatusInfo info;
 	const auto endianness = getEndianness();
@@ -2563,18 +2678,19 @@ void ElfFormat::loadCorePrStat(std::size_t offset, std::size_t size)
 	}
 
 	// Store process info
-	elfCoreInfo->addPrStatusInfo(info);
+	coreInfo.addPrStatusInfo(info);
 }
 
 /**
  * Load prpsinfo info struct from core file
  * @param offset offset off NT_PRPSINFO note data
  * @param size size of NT_PRPSINFO note data
+ * @param info structure to store the application name and command line into
  *
  * This function expects only data from non-malformed notes to avoid multiple
  * offset sanity checks. Make sure this is not used with malformed notes!
  */
-void ElfFormat::loadCorePrPsInfo(std::size_t offset, std::size_t size)
+void ElfFormat::loadCorePrPsInfo(std::size_t offset, std::size_t size, ElfCoreInfo &info) const
 {
 	std::size_t currOff = offset + (elfClass == ELFCLASS32 ? 0x1c : 0x28);
 	if(currOff + 16 + 80 < offset + size)
@@ -2584,21 +2700,22 @@ void ElfFormat::loadCorePrPsInfo(std::size_t offset, std::size_t size)
 
 	std::string res;
 	getString(res, currOff, 16);
-	elfCoreInfo->setAppName(res.c_str());
+	info.setAppName(res.c_str());
 
 	getString(res, currOff + 16, 80);
-	elfCoreInfo->setCmdLine(res.c_str());
+	info.setCmdLine(res.c_str());
 }
 
 /**
  * Load info from auxiliary vector
  * @param offset offset off NT_AUXV note data
  * @param size size of NT_AUXV note data
+ * @param info structure to store the auxiliary vector into
  *
  * This function expects only data from non-malformed notes to avoid multiple
  * offset sanity checks. Make sure this is not used with malformed notes!
  */
-void ElfFormat::loadCoreAuxvInfo(std::size_t offset, std::size_t size)
+void ElfFormat::loadCoreAuxvInfo(std::size_t offset, std::size_t size, ElfCoreInfo &info) const
 {
 	const auto endianness = getEndianness();
 	const auto entrySize = elfClass == ELFCLASS32 ? 4 : 8;
@@ -2612,7 +2729,7 @@ void ElfFormat::loadCoreAuxvInfo(std::size_t offset, std::size_t size)
 		getXByteOffset(offset, entrySize, entry.second, endianness);
 		offset += entrySize;
 
-		elfCoreInfo->addAuxVectorEntry(entry);
+		info.addAuxVectorEntry(entry);
 	}
 }
 
@@ -2627,6 +2744,7 @@ void ElfFormat::loadCoreInfo()
 		return;
 	}
 
+	std::vector<const ElfNoteEntry*> coreNotes;
 	for(const auto& noteSeg : noteSecSegs)
 	{
 		if(noteSeg.isMalformed())
@@ -2638,29 +2756,43 @@ void ElfFormat::loadCoreInfo()
 		{
 			if(entry.name == "CORE")
 			{
-				switch(entry.type)
-				{
-					case NT_FILE:
-						loadCoreFileMap(entry.dataOffset, entry.dataLength);
-						break;
+				coreNotes.push_back(&entry);
+			}
+		}
+	}
 
-					case NT_PRSTATUS:
-						loadCorePrStat(entry.dataOffset, entry.dataLength);
-						break;
+	// Notes are independent (there is NT_PRSTATUS for every thread), so they
+	// are parsed in parallel and merged in their original order.
+	std::vector<ElfCoreInfo> noteInfos(coreNotes.size());
+	utils::parallelFor(0, coreNotes.size(), [this, &coreNotes, &noteInfos](std::size_t i)
+	{
+		const auto& entry = *coreNotes[i];
+		switch(entry.type)
+		{
+			case NT_FILE:
+				loadCoreFileMap(entry.dataOffset, entry.dataLength, noteInfos[i]);
+				break;
 
-					case NT_PRPSINFO:
-						loadCorePrPsInfo(entry.dataOffset, entry.dataLength);
-						break;
+			case NT_PRSTATUS:
+				loadCorePrStat(entry.dataOffset, entry.dataLength, noteInfos[i]);
+				break;
 
-					case NT_AUXV:
-						loadCoreAuxvInfo(entry.dataOffset, entry.dataLength);
-						break;
+			case NT_PRPSINFO:
+				loadCorePrPsInfo(entry.dataOffset, entry.dataLength, noteInfos[i]);
+				break;
 
-					default:
-						break;
-				}
-			}
+			case NT_AUXV:
+				loadCoreAuxvInfo(entry.dataOffset, entry.dataLength, noteInfos[i]);
+				break;
+
+			default:
+				break;
 		}
+	});
+
+	for(std::size_t i = 0, e = coreNotes.size(); i < e; ++i)
+	{
+		elfCoreInfo->merge(noteInfos[i]);
 	}
 
 	//elfCoreInfo->dump(std::cout); // Debug output
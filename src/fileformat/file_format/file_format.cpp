@@ -197,15 +197,38 @@ void FileFormat::init()
 		md5.clear();
 		sha256.clear();
 	}
+	else if (getLoadFlags() & LoadFlags::LAZY_DIGESTS)
+	{
+		lazyFileHashes = true;
+	}
 	else
 	{
-		crc32 = retdec::fileformat::getCrc32(bytes.data(), bytes.size());
-		md5 = retdec::fileformat::getMd5(bytes.data(), bytes.size());
-		sha256 = retdec::fileformat::getSha256(bytes.data(), bytes.size());
+		computeFileHashes();
 	}
 	initStream();
 }
 
+/**
+ * Compute all supported hashes of file content
+ */
+void FileFormat::computeFileHashes() const
+{
+	crc32 = retdec::fileformat::getCrc32(bytes.data(), bytes.size());
+	md5 = retdec::fileformat::getMd5(bytes.data(), bytes.size());
+	sha256 = retdec::fileformat::getSha256(bytes.data(), bytes.size());
+}
+
+/**
+ * Compute file hashes if they are lazy and this is the first request
+ */
+void FileFormat::loadLazyFileHashes() const
+{
+	if (lazyFileHashes)
+	{
+		std::call_once(fileHashesFlag, [this]() { computeFileHashes(); });
+	}
+}
+
 /**
  * Initialize internal state of member @c fileStream
  */
@@ -878,6 +901,7 @@ bool FileFormat::isWindowsDriver() const
  */
 bool FileFormat::hasCrc32() const
 {
+	loadLazyFileHashes();
 	return !crc32.empty();
 }
 
@@ -887,6 +911,7 @@ bool FileFormat::hasCrc32() const
  */
 bool FileFormat::hasMd5() const
 {
+	loadLazyFileHashes();
 	return !md5.empty();
 }
 
@@ -896,6 +921,7 @@ bool FileFormat::hasMd5() const
  */
 bool FileFormat::hasSha256() const
 {
+	loadLazyFileHashes();
 	return !sha256.empty();
 }
 
@@ -932,6 +958,7 @@ bool FileFormat::hasSectionTableSha256() const
  */
 std::string FileFormat::getCrc32() const
 {
+	loadLazyFileHashes();
 	return crc32;
 }
 
@@ -941,6 +968,7 @@ std::string FileFormat::getCrc32() const
  */
 std::string FileFormat::getMd5() const
 {
+	loadLazyFileHashes();
 	return md5;
 }
 
@@ -950,6 +978,7 @@ std::string FileFormat::getMd5() const
  */
 std::string FileFormat::getSha256() const
 {
+	loadLazyFileHashes();
 	return sha256;
 }
 
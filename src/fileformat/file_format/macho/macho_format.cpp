@@ -755,6 +755,11 @@ void MachOFormat::symtabCommand()
 	auto *symbolTable = new SymbolTable();
 	llvm::StringRef strTable = llvm::StringRef(strPtr, endPtr - strPtr);
 	const char *ptr = fileBuffer.get()->getBufferStart() + command.symoff + chosenArchOffset;
+	if(ptr < endPtr)
+	{
+		const std::size_t entrySize = is32 ? sizeof(MachO::nlist) : sizeof(MachO::nlist_64);
+		symbolTable->reserve(std::min<std::size_t>(command.nsyms, (endPtr - ptr) / entrySize));
+	}
 
 	for(std::uint32_t i = 0; i < command.nsyms; ++i)
 	{
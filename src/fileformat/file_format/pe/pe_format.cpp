@@ -1432,6 +1432,7 @@ void PeFormat::loadSymbols()
 {
 	const auto & symTab = file->coffSymTab();
 	auto *table = new SymbolTable();
+	table->reserve(symTab.getNumberOfStoredSymbols());
 
 	for(std::size_t i = 0, e = symTab.getNumberOfStoredSymbols(); i < e; ++i)
 	{
@@ -2548,6 +2549,24 @@ void PeFormat::parseMetadataStream(std::uint64_t baseAddress, std::uint64_t offs
 	}
 }
 
+/**
+ * Get view of the bytes of .NET metadata stream. Bytes are not copied.
+ * @param address Address of the stream.
+ * @param size Size of the stream.
+ * @return View of the stream bytes. If the stream is not entirely stored
+ *         in the file, only its stored prefix is returned.
+ */
+llvm::StringRef PeFormat::getStreamBytes(std::uint64_t address, std::uint64_t size) const
+{
+	const auto *secSeg = getSectionOrSegmentFromAddress(address);
+	if (!secSeg || !size)
+	{
+		return {};
+	}
+
+	return secSeg->getBytes(address - secSeg->getAddress(), size);
+}
+
 /**
  * Parses .NET blob stream.
  * @param baseAddress Base address of .NET metadata header.
@@ -2556,11 +2575,7 @@ void PeFormat::parseMetadataStream(std::uint64_t baseAddress, std::uint64_t offs
  */
 void PeFormat::parseBlobStream(std::uint64_t baseAddress, std::uint64_t offset, std::uint64_t size)
 {
-	std::vector<std::uint8_t> data;
-	auto address = baseAddress + offset;
-	getXBytes(address, size, data);
-	blobStream = std::make_unique<BlobStream>(std::move(data), offset, size);
-
+	blobStream = std::make_unique<BlobStream>(getStreamBytes(baseAddress + offset, size), offset, size);
 }
 
 /**
@@ -2589,26 +2604,7 @@ void PeFormat::parseGuidStream(std::uint64_t baseAddress, std::uint64_t offset,
  */
 void PeFormat::parseStringStream(std::uint64_t baseAddress, std::uint64_t offset, std::uint64_t size)
 {
-	stringStream = std::make_unique<StringStream>(offset, size);
-	auto address = baseAddress + offset;
-
-	// First string is always empty, so we just skip it
-	std::uint64_t currentOffset = 1;
-	while (currentOffset < size)
-	{
-		std::string string;
-		std::uint64_t c = 0;
-		auto successful_read = get1Byte(address + currentOffset, c, getEndianness());
-		// If the reading fails (OOB or other) don't continue and terminate
-		if (!successful_read)
-		{
-			break;
-		}
-		getNTBS(address + currentOffset, string);
-		stringStream->addString(currentOffset, string);
-		// +1 for null-terminator
-		currentOffset += 1 + string.length();
-	}
+	stringStream = std::make_unique<StringStream>(getStreamBytes(baseAddress + offset, size), offset, size);
 }
 
 /**
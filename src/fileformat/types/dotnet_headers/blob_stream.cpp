@@ -10,8 +10,14 @@
 namespace retdec {
 namespace fileformat {
 
-BlobStream::BlobStream(std::vector<std::uint8_t> data, std::uint64_t streamOffset, std::uint64_t streamSize)
-	: Stream(StreamType::Blob, streamOffset, streamSize), data(std::move(data))
+/**
+ * Constructor.
+ * @param data Bytes of the stream. They are not copied.
+ * @param streamOffset Offset of the stream.
+ * @param streamSize Size of the stream.
+ */
+BlobStream::BlobStream(llvm::StringRef data, std::uint64_t streamOffset, std::uint64_t streamSize)
+	: Stream(StreamType::Blob, streamOffset, streamSize), data(data)
 {
 }
 
@@ -21,49 +27,64 @@ BlobStream::BlobStream(std::vector<std::uint8_t> data, std::uint64_t streamOffse
  * @return Element data if it exists, otherwise empty sequence.
  */
 std::vector<std::uint8_t> BlobStream::getElement(std::size_t offset) const
+{
+	auto element = getElementCursor(offset);
+	return { element.begin(), element.end() };
+}
+
+/**
+ * Returns the view of the element at the specified offset in the blob.
+ * @param offset Offset of the element.
+ * @return Element data if it exists, otherwise empty view. The view is valid
+ *         as long as the file the stream is stored in.
+ */
+BlobCursor BlobStream::getElementCursor(std::size_t offset) const
 {
 	// Adapted from YARA
 	// https://github.com/VirusTotal/yara/blob/v4.1.2/libyara/modules/dotnet/dotnet.c#L130
 	std::uint32_t len = 0;
-	const unsigned char* ptr = data.data() + offset;
-	if (offset >= data.size())
+	const auto* bytes = reinterpret_cast<const std::uint8_t*>(data.data());
+	const auto size = data.size();
+	if (offset >= size)
 	{
 		return {};
 	}
+
+	const std::uint8_t* ptr = bytes + offset;
 	// ECMA 335 II.24.2.4
 	/* Blob starts with their length in big-endian order
 	which can be variable in size. We can figure out the
 	size of the length using first few bits of the first byte. */
 	// If first bit is 0, length is encoded in the first byte
-	else if ((*ptr & 0x80) == 0x00)
+	if ((*ptr & 0x80) == 0x00)
 	{
 		len = *ptr;
 		offset += 1;
-		if (offset + len <= data.size())
+		if (offset + len <= size)
 		{
-			return { data.begin() + offset, data.begin() + offset + len };
+			return { bytes + offset, len };
 		}
 	}
 	// If first 2 bits are 10, length is stored in 2 bytes
 	else if ((*ptr & 0xC0) == 0x80)
 	{
 		// Make sure we have one more byte.
-		if (offset + 1 < data.size())
+		if (offset + 1 < size)
 		{
 			// Shift remaining 6 bits left by 8 and OR in the remaining byte.
 			len = ((*ptr & 0x3F) << 8) | *(ptr + 1);
 			offset += 2;
 		}
-		if (offset + len <= data.size())
+		if (offset + len <= size)
 		{
-			return { data.begin() + offset, data.begin() + offset + len };
+			return { bytes + offset, len };
 		}
 	}
 	// If first 3 bits are 110, length is stored in 4 bytes
 	else if ((*ptr & 0xE0) == 0xC0)
 	{
 		// Make sure we have 3 more bytes.
-		if (offset + 3 < data.size())
+		if (offset + 3 < size)
 		{
 			// Shift remaining 6 bits left by 8 and OR in the remaining byte.
 			len = ((*ptr & 0x1F) << 24) |
@@ -72,9 +93,9 @@ std::vector<std::uint8_t> BlobStream::getElement(std::size_t offset) const
 					*(ptr + 3);
 			offset += 4;
 		}
-		if (offset + len <= data.size())
+		if (offset + len <= size)
 		{
-			return { data.begin() + offset, data.begin() + offset + len };
+			return { bytes + offset, len };
 		}
 	}
 
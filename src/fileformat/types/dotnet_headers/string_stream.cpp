@@ -9,45 +9,65 @@
 namespace retdec {
 namespace fileformat {
 
-StringStream::StringStream(std::uint64_t streamOffset, std::uint64_t streamSize) : Stream(StreamType::String, streamOffset, streamSize)
+/**
+ * Constructor.
+ * @param data Bytes of the stream. They are not copied.
+ * @param streamOffset Offset of the stream.
+ * @param streamSize Size of the stream.
+ */
+StringStream::StringStream(llvm::StringRef data, std::uint64_t streamOffset, std::uint64_t streamSize)
+	: Stream(StreamType::String, streamOffset, streamSize), data(data)
 {
-	strings.emplace(0, std::string{});
 }
 
+/**
+ * Get string at the given offset.
+ * @param offset Offset of the string in the stream.
+ * @param result Into this parameter the string is stored.
+ * @return @c true if there is a string at @a offset, otherwise @c false.
+ */
 bool StringStream::getString(std::size_t offset, std::string& result) const
+{
+	llvm::StringRef ref;
+	if (!getStringRef(offset, ref))
+		return false;
+
+	result = ref.str();
+	return true;
+}
+
+/**
+ * Get string at the given offset without copying it.
+ * @param offset Offset of the string in the stream.
+ * @param result Into this parameter the view of the string is stored. It is
+ *               valid as long as the file the stream is stored in.
+ * @return @c true if there is a string at @a offset, otherwise @c false.
+ */
+bool StringStream::getStringRef(std::size_t offset, llvm::StringRef& result) const
 {
 	if (offset >= getSize())
 		return false;
 
-	auto itr = strings.lower_bound(offset);
-	if (itr == strings.begin())
+	// First string is always empty
+	if (offset == 0)
 	{
-		result.clear();
+		result = llvm::StringRef();
 		return true;
 	}
 
-	// User can also request string at the offset in the middle of another string
-	// We need to find if there is a difference between string's offset and requested offset
-	if (itr != strings.end() && offset == itr->first)
-	{
-		result = itr->second;
-		return true;
-	}
+	// Stream is not fully available in the file
+	if (offset >= data.size())
+		return false;
 
-	// If so, move backwards by one element (lower bound returns the first element that is not greater than searched element)
-	--itr;
-	std::size_t substrOffset = offset - itr->first;
-	if (substrOffset >= itr->second.length())
+	// User can also request string at the offset in the middle of another string,
+	// but not at the terminator of a non-empty string
+	if (data[offset] == '\0' && data[offset - 1] != '\0')
 		return false;
 
-	result = itr->second.substr(offset - itr->first);
+	auto end = data.find('\0', offset);
+	result = data.slice(offset, end);
 	return true;
 }
 
-void StringStream::addString(std::size_t offset, const std::string& string)
-{
-	strings.emplace(offset, string);
-}
-
 } // namespace fileformat
 } // namespace retdec
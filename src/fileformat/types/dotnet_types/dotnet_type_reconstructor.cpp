@@ -31,7 +31,7 @@ const std::uint8_t Generic           = 0x10; ///< Flag indicating whether the me
  * @param [out] bytesRead Amount of bytes read out of signature.
  * @return Decoded unsigned integer.
  */
-std::uint64_t decodeUnsigned(const std::vector<std::uint8_t>& data, std::uint64_t& bytesRead)
+std::uint64_t decodeUnsigned(const BlobCursor& data, std::uint64_t& bytesRead)
 {
 	std::uint64_t result = 0;
 	bytesRead = 0;
@@ -80,7 +80,7 @@ std::uint64_t decodeUnsigned(const std::vector<std::uint8_t>& data, std::uint64_
  * @param [out] bytesRead Amount of bytes read out of signature.
  * @return Decoded signed integer.
  */
-std::int64_t decodeSigned(const std::vector<std::uint8_t>& data, std::uint64_t& bytesRead)
+std::int64_t decodeSigned(const BlobCursor& data, std::uint64_t& bytesRead)
 {
 	std::int64_t result = 0;
 	bytesRead = 0;
@@ -139,12 +139,37 @@ auto classesFromTable(const DotnetTypeReconstructor::ClassTable& classTable)
 	DotnetTypeReconstructor::ClassList classes;
 	classes.reserve(classTable.size());
 
-	for (auto& kv : classTable)
-		classes.push_back(kv.second);
+	for (auto& classType : classTable)
+	{
+		if (classType)
+			classes.push_back(classType);
+	}
 
 	return classes;
 }
 
+/**
+ * Finds the class in the class table.
+ * @param classTable Class table.
+ * @param index Index of the class record in its metadata table.
+ * @return Class if any exists, otherwise @c nullptr.
+ */
+DotnetClass* findClass(const DotnetTypeReconstructor::ClassTable& classTable, std::size_t index)
+{
+	return index < classTable.size() ? classTable[index].get() : nullptr;
+}
+
+/**
+ * Finds the method in the method table.
+ * @param methodTable Method table.
+ * @param index Index of the method record in MethodDef table.
+ * @return Method if any exists, otherwise @c nullptr.
+ */
+DotnetMethod* findMethod(const DotnetTypeReconstructor::MethodTable& methodTable, std::size_t index)
+{
+	return index < methodTable.size() ? methodTable[index] : nullptr;
+}
+
 /**
  * Extracts the generic parameter count out of class name that is stored in metadata tables.
  * Class names encode this information in form of "ClassName`N" where N is number of generic parameters.
@@ -272,9 +297,6 @@ DotnetTypeReconstructor::ClassList DotnetTypeReconstructor::getReferencedClasses
  */
 void DotnetTypeReconstructor::linkReconstructedClasses()
 {
-	std::vector<bool> visited (refClassTable.size(), false);
-	std::vector<bool> stack (refClassTable.size(), false);
-
 	auto typeRefTable = static_cast<const MetadataTable<TypeRef>*>(metadataStream->getMetadataTable(MetadataTableType::TypeRef));
 
 	if (!typeRefTable)
@@ -283,6 +305,8 @@ void DotnetTypeReconstructor::linkReconstructedClasses()
 	}
 
 	auto refClasses = getReferencedClasses();
+	std::vector<bool> visited (refClasses.size(), false);
+	std::vector<bool> stack (refClasses.size(), false);
 
 	for (size_t i = 1; i < refClasses.size(); i++)
 	{
@@ -374,6 +398,7 @@ bool DotnetTypeReconstructor::reconstructClasses()
 		return false;
 
 	// Reconstruct defined classes from TypeDef table
+	defClassTable.resize(typeDefTable->getNumberOfRows() + 1);
 	for (std::size_t i = 1; i <= typeDefTable->getNumberOfRows(); ++i)
 	{
 		auto typeDef = static_cast<const TypeDef*>(typeDefTable->getRow(i));
@@ -405,10 +430,11 @@ bool DotnetTypeReconstructor::reconstructClasses()
 		if (newClass == nullptr)
 			continue;
 
-		defClassTable.emplace(i, std::move(newClass));
+		defClassTable[i] = std::move(newClass);
 	}
 
 	// Reconstruct referenced classes from TypeRef table
+	refClassTable.resize(typeRefTable->getNumberOfRows() + 1);
 	for (std::size_t i = 1; i <= typeRefTable->getNumberOfRows(); ++i)
 	{
 		auto typeRef = typeRefTable->getRow(i);
@@ -417,7 +443,7 @@ bool DotnetTypeReconstructor::reconstructClasses()
 		if (newClass == nullptr)
 			continue;
 
-		refClassTable.emplace(i, std::move(newClass));
+		refClassTable[i] = std::move(newClass);
 	}
 
 	linkReconstructedClasses();
@@ -435,10 +461,13 @@ bool DotnetTypeReconstructor::reconstructMethods()
 	if (methodDefTable == nullptr)
 		return true;
 
-	for (const auto& kv : defClassTable)
+	methodTable.resize(methodDefTable->getNumberOfRows() + 1);
+	for (const auto& classType : defClassTable)
 	{
+		if (!classType)
+			continue;
+
 		// Obtain TypeDef from the class
-		const auto& classType = kv.second;
 		auto typeDef = classType->getRawTypeDef();
 
 		auto methodStartIndex = typeDef->methodList.getIndex();
@@ -453,7 +482,7 @@ bool DotnetTypeReconstructor::reconstructMethods()
 				continue;
 
 			// Place method into method table so we can later associate its table index with DotnetMethod object
-			methodTable.emplace(i, newMethod.get());
+			methodTable[i] = newMethod.get();
 
 			// Do not add method to the class yet, because we don't know if return type and parameter are OK
 			classToMethodTable[classType.get()].push_back(std::move(newMethod));
@@ -488,19 +517,19 @@ bool DotnetTypeReconstructor::reconstructGenericParameters()
 
 		if (classOrMethod == MetadataTableType::TypeDef)
 		{
-			auto itr = defClassTable.find(genericParam.owner.getIndex());
-			if (itr == defClassTable.end())
+			auto classType = findClass(defClassTable, genericParam.owner.getIndex());
+			if (classType == nullptr)
 				continue;
 
-			itr->second->addGenericParameter(std::move(genericParamName));
+			classType->addGenericParameter(std::move(genericParamName));
 		}
 		else if (classOrMethod == MetadataTableType::MethodDef)
 		{
-			auto itr = methodTable.find(genericParam.owner.getIndex());
-			if (itr == methodTable.end())
+			auto method = findMethod(methodTable, genericParam.owner.getIndex());
+			if (method == nullptr)
 				continue;
 
-			itr->second->addGenericParameter(std::move(genericParamName));
+			method->addGenericParameter(std::move(genericParamName));
 		}
 	}
 
@@ -514,9 +543,10 @@ bool DotnetTypeReconstructor::reconstructGenericParameters()
 bool DotnetTypeReconstructor::reconstructMethodParameters()
 {
 	// We need to iterate over classes because we need to know the owner of every single method
-	for (const auto& kv : defClassTable)
+	for (const auto& classType : defClassTable)
 	{
-		const auto& classType = kv.second;
+		if (!classType)
+			continue;
 
 		// Now iterate over all methods
 		for (auto&& method : classToMethodTable[classType.get()])
@@ -566,9 +596,11 @@ bool DotnetTypeReconstructor::reconstructFields()
 	if (fieldTable == nullptr)
 		return true;
 
-	for (const auto& kv : defClassTable)
+	for (const auto& classType : defClassTable)
 	{
-		const auto& classType = kv.second;
+		if (!classType)
+			continue;
+
 		auto typeDef = classType->getRawTypeDef();
 
 		auto fieldStartIndex = typeDef->fieldList.getIndex();
@@ -610,12 +642,11 @@ bool DotnetTypeReconstructor::reconstructProperties()
 
 		// First obtain owning class
 		auto ownerIndex = propertyMap->parent.getIndex();
-		auto itr = defClassTable.find(ownerIndex);
-		if (itr == defClassTable.end())
+		auto ownerClass = findClass(defClassTable, ownerIndex);
+		if (ownerClass == nullptr)
 		{
 			continue;
 		}
-		const auto& ownerClass = itr->second;
 
 		// Property count needs to be determined based on index the following record in the table stores
 		// We use size of the table for the last record
@@ -631,7 +662,7 @@ bool DotnetTypeReconstructor::reconstructProperties()
 			if (property == nullptr)
 				break;
 
-			auto newProperty = createProperty(property, ownerClass.get());
+			auto newProperty = createProperty(property, ownerClass);
 			if (newProperty == nullptr)
 				continue;
 
@@ -657,27 +688,27 @@ bool DotnetTypeReconstructor::reconstructNestedClasses()
 	{
 		auto nestedClass = nestedClassTable->getRow(i);
 
-		auto nestedItr = defClassTable.find(nestedClass->nestedClass.getIndex());
+		auto nested = findClass(defClassTable, nestedClass->nestedClass.getIndex());
 		// Validate that the type is actually nested
-		if (nestedItr == defClassTable.end() || !nestedItr->second->isNested())
+		if (nested == nullptr || !nested->isNested())
 			continue;
 
-		auto enclosingItr = defClassTable.find(nestedClass->enclosingClass.getIndex());
-		if (enclosingItr == defClassTable.end())
+		auto enclosing = findClass(defClassTable, nestedClass->enclosingClass.getIndex());
+		if (enclosing == nullptr)
 			continue;
 
 		// Ignore self-references
-		if (nestedItr == enclosingItr)
+		if (nested == enclosing)
 			continue;
 
-		const std::string& namespac = nestedItr->second->getNameSpace();
+		const std::string& namespac = nested->getNameSpace();
 		if (namespac.empty())
 		{
-			nestedItr->second->setNameSpace(enclosingItr->second->getFullyQualifiedName());
+			nested->setNameSpace(enclosing->getFullyQualifiedName());
 		}
 		else
 		{
-			nestedItr->second->setNameSpace(enclosingItr->second->getFullyQualifiedName() + "." + nestedItr->second->getNameSpace());
+			nested->setNameSpace(enclosing->getFullyQualifiedName() + "." + nested->getNameSpace());
 		}
 	}
 
@@ -694,9 +725,10 @@ bool DotnetTypeReconstructor::reconstructBaseTypes()
 	auto typeSpecTable = static_cast<const MetadataTable<TypeSpec>*>(metadataStream->getMetadataTable(MetadataTableType::TypeSpec));
 
 	// First reconstruct classic inheritance
-	for (const auto& kv : defClassTable)
+	for (const auto& classType : defClassTable)
 	{
-		const auto& classType = kv.second;
+		if (!classType)
+			continue;
 
 		std::unique_ptr<DotnetDataTypeBase> baseType;
 
@@ -708,19 +740,19 @@ bool DotnetTypeReconstructor::reconstructBaseTypes()
 
 		if (extendsTable == MetadataTableType::TypeDef)
 		{
-			auto itr = defClassTable.find(typeDef->extends.getIndex());
-			if (itr == defClassTable.end())
+			auto baseClass = findClass(defClassTable, typeDef->extends.getIndex());
+			if (baseClass == nullptr)
 				continue;
 
-			baseType = std::make_unique<DotnetDataTypeClass>(itr->second.get());
+			baseType = std::make_unique<DotnetDataTypeClass>(baseClass);
 		}
 		else if (extendsTable == MetadataTableType::TypeRef)
 		{
-			auto itr = refClassTable.find(typeDef->extends.getIndex());
-			if (itr == refClassTable.end())
+			auto baseClass = findClass(refClassTable, typeDef->extends.getIndex());
+			if (baseClass == nullptr)
 				continue;
 
-			baseType = std::make_unique<DotnetDataTypeClass>(itr->second.get());
+			baseType = std::make_unique<DotnetDataTypeClass>(baseClass);
 		}
 		else if (typeSpecTable && extendsTable == MetadataTableType::TypeSpec)
 		{
@@ -729,7 +761,7 @@ bool DotnetTypeReconstructor::reconstructBaseTypes()
 			if (typeSpec == nullptr)
 				continue;
 
-			auto signature = blobStream->getElement(typeSpec->signature.getIndex());
+			auto signature = blobStream->getElementCursor(typeSpec->signature.getIndex());
 			baseType = dataTypeFromSignature(signature, classType.get(), nullptr);
 			if (baseType == nullptr)
 				continue;
@@ -753,8 +785,8 @@ bool DotnetTypeReconstructor::reconstructBaseTypes()
 
 		std::unique_ptr<DotnetDataTypeBase> baseType;
 
-		auto itr = defClassTable.find(interfaceImpl->classType.getIndex());
-		if (itr == defClassTable.end())
+		auto classType = findClass(defClassTable, interfaceImpl->classType.getIndex());
+		if (classType == nullptr)
 			continue;
 
 		MetadataTableType interfaceTable;
@@ -763,19 +795,19 @@ bool DotnetTypeReconstructor::reconstructBaseTypes()
 
 		if (interfaceTable == MetadataTableType::TypeDef)
 		{
-			auto itr = defClassTable.find(interfaceImpl->interfaceType.getIndex());
-			if (itr == defClassTable.end())
+			auto baseClass = findClass(defClassTable, interfaceImpl->interfaceType.getIndex());
+			if (baseClass == nullptr)
 				continue;
 
-			baseType =  std::make_unique<DotnetDataTypeClass>(itr->second.get());
+			baseType = std::make_unique<DotnetDataTypeClass>(baseClass);
 		}
 		else if (interfaceTable == MetadataTableType::TypeRef)
 		{
-			auto itr = refClassTable.find(interfaceImpl->interfaceType.getIndex());
-			if (itr == refClassTable.end())
+			auto baseClass = findClass(refClassTable, interfaceImpl->interfaceType.getIndex());
+			if (baseClass == nullptr)
 				continue;
 
-			baseType = std::make_unique<DotnetDataTypeClass>(itr->second.get());
+			baseType = std::make_unique<DotnetDataTypeClass>(baseClass);
 		}
 		else if (typeSpecTable && interfaceTable == MetadataTableType::TypeSpec)
 		{
@@ -784,15 +816,15 @@ bool DotnetTypeReconstructor::reconstructBaseTypes()
 			if (typeSpec == nullptr)
 				continue;
 
-			auto signature = blobStream->getElement(typeSpec->signature.getIndex());
-			baseType = dataTypeFromSignature(signature, itr->second.get(), nullptr);
+			auto signature = blobStream->getElementCursor(typeSpec->signature.getIndex());
+			baseType = dataTypeFromSignature(signature, classType, nullptr);
 			if (baseType == nullptr)
 				continue;
 		}
 		else
 			continue;
 
-		itr->second->addBaseType(std::move(baseType));
+		classType->addBaseType(std::move(baseType));
 	}
 
 	return true;
@@ -907,11 +939,11 @@ std::unique_ptr<DotnetField> DotnetTypeReconstructor::createField(const Field* f
 		return nullptr;
 
 	fieldName = retdec::utils::replaceNonprintableChars(fieldName);
-	auto signature = blobStream->getElement(field->signature.getIndex());
+	auto signature = blobStream->getElementCursor(field->signature.getIndex());
 
 	if (signature.empty() || signature[0] != FieldSignature)
 		return nullptr;
-	signature.erase(signature.begin(), signature.begin() + 1);
+	signature.advance(1);
 
 	auto type = dataTypeFromSignature(signature, ownerClass, nullptr);
 	if (type == nullptr)
@@ -940,14 +972,14 @@ std::unique_ptr<DotnetProperty> DotnetTypeReconstructor::createProperty(const Pr
 		return nullptr;
 
 	propertyName = retdec::utils::replaceNonprintableChars(propertyName);
-	auto signature = blobStream->getElement(property->type.getIndex());
+	auto signature = blobStream->getElementCursor(property->type.getIndex());
 
 	if (signature.size() < 2 || (signature[0] & ~HasThis) != PropertySignature)
 		return nullptr;
 	bool hasThis = signature[0] & HasThis;
 	// Delete two bytes because the first is 0x08 (or 0x28 if HASTHIS is set) and the other one is number of parameters
 	// This seems like a weird thing, because I don't think that C# allows any parameters in getters/setters and therefore this will always be 0
-	signature.erase(signature.begin(), signature.begin() + 2);
+	signature.advance(2);
 
 	auto type = dataTypeFromSignature(signature, ownerClass, nullptr);
 	if (type == nullptr)
@@ -975,7 +1007,7 @@ std::unique_ptr<DotnetMethod> DotnetTypeReconstructor::createMethod(const Method
 		return nullptr;
 
 	methodName = retdec::utils::replaceNonprintableChars(methodName);
-	auto signature = blobStream->getElement(methodDef->signature.getIndex());
+	auto signature = blobStream->getElementCursor(methodDef->signature.getIndex());
 
 	if (methodName.empty() || signature.empty())
 		return nullptr;
@@ -983,7 +1015,7 @@ std::unique_ptr<DotnetMethod> DotnetTypeReconstructor::createMethod(const Method
 	// If method contains generic paramters, we need to read the number of these generic paramters
 	if (signature[0] & Generic)
 	{
-		signature.erase(signature.begin(), signature.begin() + 1);
+		signature.advance(1);
 
 		// We ignore this value just because we have this information already from the class name in format 'ClassName`N'
 		std::uint64_t bytesRead = 0;
@@ -991,11 +1023,11 @@ std::unique_ptr<DotnetMethod> DotnetTypeReconstructor::createMethod(const Method
 		if (bytesRead == 0)
 			return nullptr;
 
-		signature.erase(signature.begin(), signature.begin() + bytesRead);
+		signature.advance(bytesRead);
 	}
 	else
 	{
-		signature.erase(signature.begin(), signature.begin() + 1);
+		signature.advance(1);
 	}
 
 	// It is followed by number of parameters
@@ -1003,7 +1035,7 @@ std::unique_ptr<DotnetMethod> DotnetTypeReconstructor::createMethod(const Method
 	std::uint64_t paramsCount = decodeUnsigned(signature, bytesRead);
 	if (bytesRead == 0)
 		return nullptr;
-	signature.erase(signature.begin(), signature.begin() + bytesRead);
+	signature.advance(bytesRead);
 
 	auto newMethod = std::make_unique<DotnetMethod>();
 	newMethod->setRawRecord(methodDef);
@@ -1030,12 +1062,12 @@ std::unique_ptr<DotnetMethod> DotnetTypeReconstructor::createMethod(const Method
  * @param startIdx Index of the first Param record of the method
  * @param ownerClass Owning class.
  * @param ownerMethod Owning method.
- * @param signature Signature with data types. Is destroyed in the meantime.
+ * @param signature Signature with data types. Is consumed in the meantime.
  * @return New method parameter or @c nullptr in case of failure.
  */
 std::unique_ptr<DotnetParameter> DotnetTypeReconstructor::createMethodParameter(
 		std::size_t paramIdx, std::size_t startIdx, const DotnetClass* ownerClass,
-		const DotnetMethod* ownerMethod, std::vector<std::uint8_t>& signature)
+		const DotnetMethod* ownerMethod, BlobCursor& signature)
 {
 	std::string paramName;
 
@@ -1076,7 +1108,7 @@ std::unique_ptr<DotnetParameter> DotnetTypeReconstructor::createMethodParameter(
  * @return New data type or @c nullptr in case of failure.
  */
 template <typename T>
-std::unique_ptr<T> DotnetTypeReconstructor::createDataTypeFollowedByReference(std::vector<std::uint8_t>& data)
+std::unique_ptr<T> DotnetTypeReconstructor::createDataTypeFollowedByReference(BlobCursor& data)
 {
 	std::uint64_t bytesRead;
 	TypeDefOrRef typeRef;
@@ -1088,7 +1120,7 @@ std::unique_ptr<T> DotnetTypeReconstructor::createDataTypeFollowedByReference(st
 	if (classRef == nullptr)
 		return nullptr;
 
-	data.erase(data.begin(), data.begin() + bytesRead);
+	data.advance(bytesRead);
 	return std::make_unique<T>(classRef);
 }
 
@@ -1100,7 +1132,7 @@ std::unique_ptr<T> DotnetTypeReconstructor::createDataTypeFollowedByReference(st
  * @return New data type or @c nullptr in case of failure.
  */
 template <typename T>
-std::unique_ptr<T> DotnetTypeReconstructor::createDataTypeFollowedByType(std::vector<std::uint8_t>& data, const DotnetClass* ownerClass, const DotnetMethod* ownerMethod)
+std::unique_ptr<T> DotnetTypeReconstructor::createDataTypeFollowedByType(BlobCursor& data, const DotnetClass* ownerClass, const DotnetMethod* ownerMethod)
 {
 	auto type = dataTypeFromSignature(data, ownerClass, ownerMethod);
 	if (type == nullptr)
@@ -1116,7 +1148,7 @@ std::unique_ptr<T> DotnetTypeReconstructor::createDataTypeFollowedByType(std::ve
  * @return New data type or @c nullptr in case of failure.
  */
 template <typename T, typename U>
-std::unique_ptr<T> DotnetTypeReconstructor::createGenericReference(std::vector<std::uint8_t>& data, const U* owner)
+std::unique_ptr<T> DotnetTypeReconstructor::createGenericReference(BlobCursor& data, const U* owner)
 {
 	if (owner == nullptr)
 		return nullptr;
@@ -1131,7 +1163,7 @@ std::unique_ptr<T> DotnetTypeReconstructor::createGenericReference(std::vector<s
 	if (index >= genericParams.size())
 		return nullptr;
 
-	data.erase(data.begin(), data.begin() + bytesRead);
+	data.advance(bytesRead);
 	return std::make_unique<T>(&genericParams[index]);
 }
 
@@ -1142,7 +1174,7 @@ std::unique_ptr<T> DotnetTypeReconstructor::createGenericReference(std::vector<s
  * @param ownerMethod Owning method.
  * @return New data type or @c nullptr in case of failure.
  */
-std::unique_ptr<DotnetDataTypeGenericInst> DotnetTypeReconstructor::createGenericInstantiation(std::vector<std::uint8_t>& data, const DotnetClass* ownerClass, const DotnetMethod* ownerMethod)
+std::unique_ptr<DotnetDataTypeGenericInst> DotnetTypeReconstructor::createGenericInstantiation(BlobCursor& data, const DotnetClass* ownerClass, const DotnetMethod* ownerMethod)
 {
 	if (data.empty())
 		return nullptr;
@@ -1157,7 +1189,7 @@ std::unique_ptr<DotnetDataTypeGenericInst> DotnetTypeReconstructor::createGeneri
 
 	// Number of instantiated generic parameters
 	auto genericCount = data[0];
-	data.erase(data.begin(), data.begin() + 1);
+	data.advance(1);
 
 	// Generic parameters used for instantiation
 	std::vector<std::unique_ptr<DotnetDataTypeBase>> genericTypes;
@@ -1180,7 +1212,7 @@ std::unique_ptr<DotnetDataTypeGenericInst> DotnetTypeReconstructor::createGeneri
  * @param ownerMethod Owning method.
  * @return New data type or @c nullptr in case of failure.
  */
-std::unique_ptr<DotnetDataTypeArray> DotnetTypeReconstructor::createArray(std::vector<std::uint8_t>& data, const DotnetClass* ownerClass, const DotnetMethod* ownerMethod)
+std::unique_ptr<DotnetDataTypeArray> DotnetTypeReconstructor::createArray(BlobCursor& data, const DotnetClass* ownerClass, const DotnetMethod* ownerMethod)
 {
 	// First comes data type representing elements in array
 	auto type = dataTypeFromSignature(data, ownerClass, ownerMethod);
@@ -1192,7 +1224,7 @@ std::unique_ptr<DotnetDataTypeArray> DotnetTypeReconstructor::createArray(std::v
 	std::uint64_t rank = decodeUnsigned(data, bytesRead);
 	if (bytesRead == 0)
 		return nullptr;
-	data.erase(data.begin(), data.begin() + bytesRead);
+	data.advance(bytesRead);
 
 	// Rank must be non-zero number
 	if (rank == 0)
@@ -1204,7 +1236,7 @@ std::unique_ptr<DotnetDataTypeArray> DotnetTypeReconstructor::createArray(std::v
 	std::uint64_t numOfSizes = decodeUnsigned(data, bytesRead);
 	if (bytesRead == 0 || numOfSizes > rank)
 		return nullptr;
-	data.erase(data.begin(), data.begin() + bytesRead);
+	data.advance(bytesRead);
 
 	// Now get all those sizes
 	for (std::uint64_t i = 0; i < numOfSizes; ++i)
@@ -1212,14 +1244,14 @@ std::unique_ptr<DotnetDataTypeArray> DotnetTypeReconstructor::createArray(std::v
 		dimensions[i].second = decodeSigned(data, bytesRead);
 		if (bytesRead == 0)
 			return nullptr;
-		data.erase(data.begin(), data.begin() + bytesRead);
+		data.advance(bytesRead);
 	}
 
 	// And some dimensions can also be limited by special lower bound
 	std::size_t numOfLowBounds = decodeUnsigned(data, bytesRead);
 	if (bytesRead == 0 || numOfLowBounds > rank)
 		return nullptr;
-	data.erase(data.begin(), data.begin() + bytesRead);
+	data.advance(bytesRead);
 
 	// Make sure we don't get out of bounds with dimensions
 	numOfLowBounds = std::min(dimensions.size(), numOfLowBounds);
@@ -1228,7 +1260,7 @@ std::unique_ptr<DotnetDataTypeArray> DotnetTypeReconstructor::createArray(std::v
 		dimensions[i].first = decodeSigned(data, bytesRead);
 		if (bytesRead == 0)
 			return nullptr;
-		data.erase(data.begin(), data.begin() + bytesRead);
+		data.advance(bytesRead);
 
 		// Adjust higher bound according to lower bound
 		dimensions[i].second += dimensions[i].first;
@@ -1245,7 +1277,7 @@ std::unique_ptr<DotnetDataTypeArray> DotnetTypeReconstructor::createArray(std::v
  * @return New data type or @c nullptr in case of failure.
  */
 template <typename T>
-std::unique_ptr<T> DotnetTypeReconstructor::createModifier(std::vector<std::uint8_t>& data, const DotnetClass* ownerClass, const DotnetMethod* ownerMethod)
+std::unique_ptr<T> DotnetTypeReconstructor::createModifier(BlobCursor& data, const DotnetClass* ownerClass, const DotnetMethod* ownerMethod)
 {
 	// These modifiers are used to somehow specify data type using some data type
 	// The only usage we know about right know is 'volatile' keyword
@@ -1260,7 +1292,7 @@ std::unique_ptr<T> DotnetTypeReconstructor::createModifier(std::vector<std::uint
 	auto modifier = selectClass(typeRef);
 	if (modifier == nullptr)
 		return nullptr;
-	data.erase(data.begin(), data.begin() + bytesRead);
+	data.advance(bytesRead);
 
 	// Go further in signature because we only have modifier, we need to obtain type that is modified
 	auto type = dataTypeFromSignature(data, ownerClass, ownerMethod);
@@ -1277,20 +1309,20 @@ std::unique_ptr<T> DotnetTypeReconstructor::createModifier(std::vector<std::uint
  * @param ownerMethod Owning method.
  * @return New data type or @c nullptr in case of failure.
  */
-std::unique_ptr<DotnetDataTypeFnPtr> DotnetTypeReconstructor::createFnPtr(std::vector<std::uint8_t>& data, const DotnetClass* ownerClass, const DotnetMethod* ownerMethod)
+std::unique_ptr<DotnetDataTypeFnPtr> DotnetTypeReconstructor::createFnPtr(BlobCursor& data, const DotnetClass* ownerClass, const DotnetMethod* ownerMethod)
 {
 	if (data.empty())
 		return nullptr;
 
 	// Delete first byte, what does it even mean?
-	data.erase(data.begin(), data.begin() + 1);
+	data.advance(1);
 
 	// Read number of parameters
 	std::uint64_t bytesRead = 0;
 	std::uint64_t paramsCount = decodeUnsigned(data, bytesRead);
 	if (bytesRead == 0)
 		return nullptr;
-	data.erase(data.begin(), data.begin() + bytesRead);
+	data.advance(bytesRead);
 
 	auto returnType = dataTypeFromSignature(data, ownerClass, ownerMethod);
 	if (returnType == nullptr)
@@ -1316,14 +1348,14 @@ std::unique_ptr<DotnetDataTypeFnPtr> DotnetTypeReconstructor::createFnPtr(std::v
  * @param ownerMethod Owning method.
  * @return New data type or @c nullptr in case of failure.
  */
-std::unique_ptr<DotnetDataTypeBase> DotnetTypeReconstructor::dataTypeFromSignature(std::vector<std::uint8_t>& signature, const DotnetClass* ownerClass, const DotnetMethod* ownerMethod)
+std::unique_ptr<DotnetDataTypeBase> DotnetTypeReconstructor::dataTypeFromSignature(BlobCursor& signature, const DotnetClass* ownerClass, const DotnetMethod* ownerMethod)
 {
 	if (signature.empty())
 		return nullptr;
 
 	std::unique_ptr<DotnetDataTypeBase> result;
 	auto type = static_cast<ElementType>(signature[0]);
-	signature.erase(signature.begin(), signature.begin() + 1);
+	signature.advance(1);
 
 	switch (type)
 	{
@@ -1455,21 +1487,9 @@ const DotnetClass* DotnetTypeReconstructor::selectClass(const TypeDefOrRef& type
 
 	const DotnetClass* result = nullptr;
 	if (refTable == MetadataTableType::TypeDef)
-	{
-		auto itr = defClassTable.find(typeDefOrRef.getIndex());
-		if (itr == defClassTable.end())
-			return nullptr;
-
-		result = itr->second.get();
-	}
+		result = findClass(defClassTable, typeDefOrRef.getIndex());
 	else if (refTable == MetadataTableType::TypeRef)
-	{
-		auto itr = refClassTable.find(typeDefOrRef.getIndex());
-		if (itr == refClassTable.end())
-			return nullptr;
-
-		result = itr->second.get();
-	}
+		result = findClass(refClassTable, typeDefOrRef.getIndex());
 	// TODO TypeSpec is missing here
 
 	return result;
@@ -4,6 +4,8 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
+
 #include "retdec/fileformat/types/note_section/elf_core.h"
 
 namespace retdec {
@@ -15,6 +17,12 @@ namespace fileformat {
  */
 void ElfCoreInfo::addFileMapEntry(const FileMapEntry& entry)
 {
+	auto pos = std::upper_bound(fileMapByAddr.begin(), fileMapByAddr.end(),
+		entry.startAddr,
+		[this](std::uint64_t addr, std::size_t index) {
+			return addr < fileMap[index].startAddr;
+		});
+	fileMapByAddr.insert(pos, fileMap.size());
 	fileMap.emplace_back(entry);
 }
 
@@ -90,6 +98,63 @@ const std::vector<AuxVectorEntry>& ElfCoreInfo::getAuxVector() const
 	return auxVector;
 }
 
+/**
+ * Find file map entry which maps @a address
+ * @param address address to look for
+ * @return pointer to the entry or @c nullptr if @a address is not mapped
+ *
+ * Mapped ranges in NT_FILE note do not overlap, so only the entry with the
+ * highest start address not above @a address is checked.
+ */
+const FileMapEntry* ElfCoreInfo::getFileMapEntry(std::uint64_t address) const
+{
+	auto it = std::upper_bound(fileMapByAddr.begin(), fileMapByAddr.end(),
+		address,
+		[this](std::uint64_t addr, std::size_t index) {
+			return addr < fileMap[index].startAddr;
+		});
+
+	if(it == fileMapByAddr.begin())
+	{
+		return nullptr;
+	}
+
+	const auto& entry = fileMap[*--it];
+	return address < entry.endAddr ? &entry : nullptr;
+}
+
+/**
+ * Append information parsed from other notes
+ * @param other information to append
+ *
+ * File map, prstatus structures and auxiliary vector are appended, page size,
+ * application name and command line are taken over if they are set in
+ * @a other.
+ */
+void ElfCoreInfo::merge(const ElfCoreInfo& other)
+{
+	if(other.pageSize)
+	{
+		pageSize = other.pageSize;
+	}
+	for(const auto& entry : other.fileMap)
+	{
+		addFileMapEntry(entry);
+	}
+	prstatusInfos.insert(prstatusInfos.end(),
+		other.prstatusInfos.begin(), other.prstatusInfos.end());
+	auxVector.insert(auxVector.end(),
+		other.auxVector.begin(), other.auxVector.end());
+	if(!other.appName.empty())
+	{
+		appName = other.appName;
+	}
+	if(!other.cmdLine.empty())
+	{
+		cmdLine = other.cmdLine;
+	}
+}
+
 /**
  * Dump CORE file info
  * @param outStream target output stream
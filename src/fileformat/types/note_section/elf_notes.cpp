@@ -58,7 +58,7 @@ void ElfNoteSecSeg::addNote(const ElfNoteEntry& note)
  * Get notes for segment or section
  * @return vector of notes
  */
-std::vector<ElfNoteEntry> ElfNoteSecSeg::getNotes() const
+const std::vector<ElfNoteEntry>& ElfNoteSecSeg::getNotes() const
 {
 	return notes;
 }
@@ -32,6 +32,52 @@ void SecSeg::computeHashes()
 	sha256 = retdec::fileformat::getSha256(hashData, bytes.size());
 }
 
+/**
+ * Get lazily computed hashes, compute them if this is the first request
+ * @return Lazy digests with hashes or @c nullptr if hashes are not lazy
+ */
+const SecSeg::LazyDigests* SecSeg::getLazyHashes() const
+{
+	if(!lazyDigests || !lazyDigests->hashesRequested)
+	{
+		return nullptr;
+	}
+
+	auto *lazy = lazyDigests.get();
+	std::call_once(lazy->hashesFlag, [this, lazy]()
+	{
+		const auto *hashData = reinterpret_cast<const unsigned char*>(bytes.data());
+		lazy->crc32 = retdec::fileformat::getCrc32(hashData, bytes.size());
+		lazy->md5 = retdec::fileformat::getMd5(hashData, bytes.size());
+		lazy->sha256 = retdec::fileformat::getSha256(hashData, bytes.size());
+	});
+	return lazy;
+}
+
+/**
+ * Get lazily computed entropy, compute it if this is the first request
+ * @return Lazy digests with entropy or @c nullptr if entropy is not lazy
+ */
+const SecSeg::LazyDigests* SecSeg::getLazyEntropy() const
+{
+	if(!lazyDigests || !lazyDigests->entropyRequested)
+	{
+		return nullptr;
+	}
+
+	auto *lazy = lazyDigests.get();
+	std::call_once(lazy->entropyFlag, [this, lazy]()
+	{
+		auto data = reinterpret_cast<const uint8_t *>(bytes.data());
+		if(data && bytes.size())
+		{
+			lazy->entropy = computeDataEntropy(data, bytes.size());
+			lazy->isEntropyValid = true;
+		}
+	});
+	return lazy;
+}
+
 /**
  * Check if section type is undefined
  * @return @c true if section type is undefined, @c false otherwise
@@ -165,7 +211,8 @@ bool SecSeg::isValid(const FileFormat *sOwner) const
  */
 std::string SecSeg::getCrc32() const
 {
-	return crc32;
+	const auto *lazy = getLazyHashes();
+	return lazy ? lazy->crc32 : crc32;
 }
 
 /**
@@ -174,7 +221,8 @@ std::string SecSeg::getCrc32() const
  */
 std::string SecSeg::getMd5() const
 {
-	return md5;
+	const auto *lazy = getLazyHashes();
+	return lazy ? lazy->md5 : md5;
 }
 
 /**
@@ -183,7 +231,8 @@ std::string SecSeg::getMd5() const
  */
 std::string SecSeg::getSha256() const
 {
-	return sha256;
+	const auto *lazy = getLazyHashes();
+	return lazy ? lazy->sha256 : sha256;
 }
 
 /**
@@ -363,6 +412,16 @@ bool SecSeg::getMemory() const
  */
 bool SecSeg::getEntropy(double &res) const
 {
+	if (const auto *lazy = getLazyEntropy())
+	{
+		if (!lazy->isEntropyValid)
+		{
+			return false;
+		}
+		res = lazy->entropy;
+		return true;
+	}
+
 	if (!isEntropyValid)
 	{
 		return false;
@@ -520,6 +579,9 @@ void SecSeg::setMemory(bool sMemory)
 
 /**
  * Compute entropy of section data in <0,1>
+ *
+ * If digests of the section or segment are lazy, entropy is computed
+ * on the first request.
  */
 void SecSeg::computeEntropy()
 {
@@ -528,6 +590,12 @@ void SecSeg::computeEntropy()
 		return;
 	}
 
+	if (lazyDigests)
+	{
+		lazyDigests->entropyRequested = true;
+		return;
+	}
+
 	auto data = reinterpret_cast<const uint8_t *>(bytes.data());
 	auto size = bytes.size();
 	if (!data || size == 0)
@@ -571,6 +639,7 @@ void SecSeg::invalidateEntrySize()
  */
 void SecSeg::load(const FileFormat *sOwner)
 {
+	lazyDigests.reset();
 	if(!fileSize || !sOwner || offset >= sOwner->getLoadedFileLength())
 	{
 		bytes = "";
@@ -581,7 +650,12 @@ void SecSeg::load(const FileFormat *sOwner)
 	bytes = StringRef(reinterpret_cast<const char*>(sOwner->getLoadedBytesData() + offset), std::min(fileSize, sOwner->getLoadedFileLength() - offset));
 	loaded = true;
 
-	if (!(sOwner->getLoadFlags() & LoadFlags::NO_VERBOSE_HASHES))
+	if (sOwner->getLoadFlags() & LoadFlags::LAZY_DIGESTS)
+	{
+		lazyDigests = std::make_shared<LazyDigests>();
+		lazyDigests->hashesRequested = !(sOwner->getLoadFlags() & LoadFlags::NO_VERBOSE_HASHES);
+	}
+	else if (!(sOwner->getLoadFlags() & LoadFlags::NO_VERBOSE_HASHES))
 	{
 		computeHashes();
 	}
@@ -665,7 +739,7 @@ void SecSeg::dump(std::string &sDump) const
  */
 bool SecSeg::hasCrc32() const
 {
-	return !crc32.empty();
+	return !getCrc32().empty();
 }
 
 /**
@@ -674,7 +748,7 @@ bool SecSeg::hasCrc32() const
  */
 bool SecSeg::hasMd5() const
 {
-	return !md5.empty();
+	return !getMd5().empty();
 }
 
 /**
@@ -683,7 +757,7 @@ bool SecSeg::hasMd5() const
  */
 bool SecSeg::hasSha256() const
 {
-	return !sha256.empty();
+	return !getSha256().empty();
 }
 
 /**
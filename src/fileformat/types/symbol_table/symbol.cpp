@@ -6,12 +6,78 @@
 
 #include "retdec/utils/string.h"
 #include "retdec/fileformat/types/symbol_table/symbol.h"
+#include "retdec/fileformat/types/symbol_table/symbol_table.h"
 
 using namespace retdec::utils;
 
 namespace retdec {
 namespace fileformat {
 
+/**
+ * Copy constructor
+ * @param other Symbol to copy
+ *
+ * The copy is not stored in the table of @a other.
+ */
+Symbol::Symbol(const Symbol &other) : name(other.name), originalName(other.originalName), type(other.type),
+	usageType(other.usageType), index(other.index), address(other.address), size(other.size),
+	linkToSection(other.linkToSection), addressIsValid(other.addressIsValid), sizeIsValid(other.sizeIsValid),
+	linkIsValid(other.linkIsValid), thumbSymbol(other.thumbSymbol)
+{
+
+}
+
+/**
+ * Copy assignment operator
+ * @param other Symbol to copy
+ * @return This symbol, which stays in its table (if any)
+ */
+Symbol& Symbol::operator=(const Symbol &other)
+{
+	if(this != &other)
+	{
+		notifyRenaming();
+		name = other.name;
+		originalName = other.originalName;
+		type = other.type;
+		usageType = other.usageType;
+		index = other.index;
+		address = other.address;
+		size = other.size;
+		linkToSection = other.linkToSection;
+		addressIsValid = other.addressIsValid;
+		sizeIsValid = other.sizeIsValid;
+		linkIsValid = other.linkIsValid;
+		thumbSymbol = other.thumbSymbol;
+	}
+
+	return *this;
+}
+
+/**
+ * Let the table know that name of symbol is going to change. It has to
+ * be called before the name is modified because the table refers to it.
+ * The whole symbol is updated in the table afterwards.
+ */
+void Symbol::notifyRenaming()
+{
+	if(table)
+	{
+		table->symbolWillBeRenamed(tableRow);
+	}
+}
+
+/**
+ * Let the table know that an indexed property of symbol has changed
+ */
+void Symbol::notifyChange()
+{
+	if(table)
+	{
+		table->symbolChanged(tableRow);
+	}
+}
+
 /**
  * @return @c true if symbol is undefined, @c false otherwise
  */
@@ -274,6 +340,7 @@ bool Symbol::getLinkToSection(unsigned long long &sectionIndex) const
  */
 void Symbol::setName(const std::string & symbolName)
 {
+	notifyRenaming();
 	name = symbolName;
 }
 
@@ -293,6 +360,7 @@ void Symbol::setOriginalName(const std::string & symbolOriginalName)
 void Symbol::setType(Symbol::Type symbolType)
 {
 	type = symbolType;
+	notifyChange();
 }
 
 /**
@@ -302,6 +370,7 @@ void Symbol::setType(Symbol::Type symbolType)
 void Symbol::setUsageType(Symbol::UsageType symbolUsageType)
 {
 	usageType = symbolUsageType;
+	notifyChange();
 }
 
 /**
@@ -311,6 +380,7 @@ void Symbol::setUsageType(Symbol::UsageType symbolUsageType)
 void Symbol::setIndex(unsigned long long symbolIndex)
 {
 	index = symbolIndex;
+	notifyChange();
 }
 
 /**
@@ -321,6 +391,7 @@ void Symbol::setAddress(unsigned long long symbolAddress)
 {
 	address = symbolAddress;
 	addressIsValid = true;
+	notifyChange();
 }
 
 /**
@@ -341,6 +412,7 @@ void Symbol::setLinkToSection(unsigned long long sectionIndex)
 {
 	linkToSection = sectionIndex;
 	linkIsValid = true;
+	notifyChange();
 }
 
 /**
@@ -350,6 +422,7 @@ void Symbol::setLinkToSection(unsigned long long sectionIndex)
 void Symbol::setIsThumbSymbol(bool b)
 {
 	thumbSymbol = b;
+	notifyChange();
 }
 
 /**
@@ -362,6 +435,7 @@ void Symbol::setIsThumbSymbol(bool b)
 void Symbol::invalidateAddress()
 {
 	addressIsValid = false;
+	notifyChange();
 }
 
 /**
@@ -386,6 +460,7 @@ void Symbol::invalidateSize()
 void Symbol::invalidateLinkToSection()
 {
 	linkIsValid = false;
+	notifyChange();
 }
 
 } // namespace fileformat
@@ -0,0 +1,417 @@
+/**
+ * @file src/fileformat/types/symbol_table/symbol_store.cpp
+ * @brief Struct-of-arrays store of symbols with name and address indexes.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <algorithm>
+
+#include "retdec/fileformat/types/symbol_table/symbol_store.h"
+
+namespace retdec {
+namespace fileformat {
+
+/**
+ * Get number of rows (symbols) in store
+ * @return Number of rows in store
+ */
+std::size_t SymbolStore::size() const
+{
+	return nameIds.size();
+}
+
+/**
+ * @return @c true if there are no rows in store, @c false otherwise
+ */
+bool SymbolStore::empty() const
+{
+	return nameIds.empty();
+}
+
+/**
+ * Get number of distinct names in store
+ * @return Number of distinct names
+ */
+std::size_t SymbolStore::getNumberOfNames() const
+{
+	return nameToId.size();
+}
+
+/**
+ * Get name of symbol
+ * @param row Row of symbol
+ * @return Name of symbol
+ */
+std::string_view SymbolStore::getName(std::size_t row) const
+{
+	return symbols[row]->getName();
+}
+
+/**
+ * Get id of interned name of symbol
+ * @param row Row of symbol
+ * @return Name id; symbols with the same name have the same id
+ */
+std::size_t SymbolStore::getNameId(std::size_t row) const
+{
+	return nameIds[row];
+}
+
+/**
+ * Get interned name
+ * @param nameId Id of name
+ * @return Name with id @a nameId or empty name if no row has it any more
+ */
+std::string_view SymbolStore::getNameWithId(std::size_t nameId) const
+{
+	const auto row = firstRowWithName[nameId];
+	return row == noRow ? std::string_view() : getName(row);
+}
+
+/**
+ * Get usage type of symbol
+ * @param row Row of symbol
+ * @return Usage type of symbol
+ */
+Symbol::UsageType SymbolStore::getUsageType(std::size_t row) const
+{
+	return usageTypes[row];
+}
+
+/**
+ * Get index stored in symbol
+ * @param row Row of symbol
+ * @return Index of symbol
+ */
+unsigned long long SymbolStore::getIndex(std::size_t row) const
+{
+	return indexes[row];
+}
+
+/**
+ * Get virtual address of symbol
+ * @param row Row of symbol
+ * @param address Into this parameter is stored symbol virtual address
+ * @return @c true if symbol virtual address is valid, @c false otherwise
+ *
+ * See @c Symbol::getAddress()
+ */
+bool SymbolStore::getAddress(std::size_t row, unsigned long long &address) const
+{
+	if(flags[row] & ADDRESS_VALID)
+	{
+		address = addresses[row];
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * Get real virtual address of symbol
+ * @param row Row of symbol
+ * @param address Into this parameter is stored symbol real virtual address
+ * @return @c true if symbol real virtual address is valid, @c false otherwise
+ *
+ * See @c Symbol::getRealAddress()
+ */
+bool SymbolStore::getRealAddress(std::size_t row, unsigned long long &address) const
+{
+	if(flags[row] & REAL_ADDRESS_VALID)
+	{
+		address = realAddresses[row];
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * Find interned name
+ * @param name Name to find
+ * @return Id of name or @c npos if no symbol has name @a name
+ */
+std::size_t SymbolStore::findName(std::string_view name) const
+{
+	auto it = nameToId.find(name);
+	return it == nameToId.end() ? npos : it->second;
+}
+
+/**
+ * Find first symbol with name @a name
+ * @param name Name of symbol
+ * @return Row of symbol or @c npos if such symbol is not found
+ */
+std::size_t SymbolStore::findByName(std::string_view name) const
+{
+	auto id = findName(name);
+	return id == npos ? npos : firstRowWithName[id];
+}
+
+/**
+ * Find first symbol with valid address @a address
+ * @param address Address of symbol
+ * @return Row of symbol or @c npos if such symbol is not found
+ */
+std::size_t SymbolStore::findByAddress(unsigned long long address) const
+{
+	auto it = addressToRow.find(address);
+	return it == addressToRow.end() ? npos : it->second;
+}
+
+/**
+ * Find first symbol with index @a index
+ * @param index Index stored in symbol
+ * @return Row of symbol or @c npos if such symbol is not found
+ */
+std::size_t SymbolStore::findByIndex(unsigned long long index) const
+{
+	auto it = indexToRow.find(index);
+	return it == indexToRow.end() ? npos : it->second;
+}
+
+/**
+ * Add new row describing @a symbol
+ * @param symbol Symbol to add; it has to outlive the store
+ */
+void SymbolStore::add(const Symbol &symbol)
+{
+	const auto row = static_cast<std::uint32_t>(size());
+	symbols.push_back(&symbol);
+	nameIds.push_back(internName(row));
+
+	std::uint8_t f = 0;
+	unsigned long long address = 0, realAddress = 0;
+	if(symbol.getAddress(address))
+	{
+		f |= ADDRESS_VALID;
+		addressToRow.emplace(address, row);
+	}
+	if(symbol.getRealAddress(realAddress))
+	{
+		f |= REAL_ADDRESS_VALID;
+	}
+	addresses.push_back(address);
+	realAddresses.push_back(realAddress);
+	flags.push_back(f);
+
+	indexes.push_back(symbol.getIndex());
+	indexToRow.emplace(symbol.getIndex(), row);
+	usageTypes.push_back(symbol.getUsageType());
+}
+
+/**
+ * Remove row from the name index before its symbol is renamed
+ * @param row Row of symbol
+ *
+ * The index refers to the name of the symbol, so this has to be called
+ * while the symbol still has its old name. The row gets the new name in
+ * the following @c update(). If the row was the first one with its name,
+ * the next such row is searched for, which is linear in the number of rows.
+ */
+void SymbolStore::detachName(std::size_t row)
+{
+	const auto nameId = nameIds[row];
+	if(nameId == noRow)
+	{
+		return;
+	}
+
+	nameIds[row] = noRow;
+	if(firstRowWithName[nameId] == row)
+	{
+		nameToId.erase(getName(row));
+		setFirstRowWithName(nameId, findFirstRowWithName(nameId));
+	}
+}
+
+/**
+ * Update row after its symbol was modified
+ * @param row Row of symbol
+ *
+ * Indexes keep pointing to the first matching row. If the row was the first
+ * one with its old address or index, the next such row is searched for,
+ * which is linear in the number of rows.
+ */
+void SymbolStore::update(std::size_t row)
+{
+	const auto r = static_cast<std::uint32_t>(row);
+	const auto &symbol = *symbols[row];
+
+	if(nameIds[row] == noRow)
+	{
+		nameIds[row] = internName(r);
+	}
+
+	const bool oldAddressValid = flags[row] & ADDRESS_VALID;
+	const auto oldAddress = addresses[row];
+	unsigned long long address = 0, realAddress = 0;
+	const bool addressValid = symbol.getAddress(address);
+	std::uint8_t f = addressValid ? ADDRESS_VALID : 0;
+	if(symbol.getRealAddress(realAddress))
+	{
+		f |= REAL_ADDRESS_VALID;
+	}
+	addresses[row] = address;
+	realAddresses[row] = realAddress;
+	flags[row] = f;
+	if(oldAddressValid != addressValid || oldAddress != address)
+	{
+		if(oldAddressValid)
+		{
+			auto it = addressToRow.find(oldAddress);
+			if(it != addressToRow.end() && it->second == r)
+			{
+				const auto next = findFirstRowWithAddress(oldAddress);
+				if(next == noRow)
+				{
+					addressToRow.erase(it);
+				}
+				else
+				{
+					it->second = next;
+				}
+			}
+		}
+		if(addressValid)
+		{
+			auto res = addressToRow.emplace(address, r);
+			res.first->second = std::min(res.first->second, r);
+		}
+	}
+
+	const auto oldIndex = indexes[row];
+	indexes[row] = symbol.getIndex();
+	if(oldIndex != indexes[row])
+	{
+		auto it = indexToRow.find(oldIndex);
+		if(it != indexToRow.end() && it->second == r)
+		{
+			const auto next = findFirstRowWithIndex(oldIndex);
+			if(next == noRow)
+			{
+				indexToRow.erase(it);
+			}
+			else
+			{
+				it->second = next;
+			}
+		}
+		auto res = indexToRow.emplace(indexes[row], r);
+		res.first->second = std::min(res.first->second, r);
+	}
+
+	usageTypes[row] = symbol.getUsageType();
+}
+
+/**
+ * Reserve space for @a n rows
+ * @param n Number of rows
+ */
+void SymbolStore::reserve(std::size_t n)
+{
+	symbols.reserve(n);
+	nameIds.reserve(n);
+	addresses.reserve(n);
+	realAddresses.reserve(n);
+	indexes.reserve(n);
+	usageTypes.reserve(n);
+	flags.reserve(n);
+	addressToRow.reserve(n);
+	indexToRow.reserve(n);
+}
+
+/**
+ * Delete all rows and names
+ */
+void SymbolStore::clear()
+{
+	symbols.clear();
+	nameIds.clear();
+	addresses.clear();
+	realAddresses.clear();
+	indexes.clear();
+	usageTypes.clear();
+	flags.clear();
+	firstRowWithName.clear();
+	nameToId.clear();
+	addressToRow.clear();
+	indexToRow.clear();
+}
+
+/**
+ * Get id of name of symbol in row @a row, intern the name if it is new
+ * @param row Row of symbol
+ * @return Id of name
+ */
+std::uint32_t SymbolStore::internName(std::uint32_t row)
+{
+	auto it = nameToId.find(getName(row));
+	if(it == nameToId.end())
+	{
+		const auto id = static_cast<std::uint32_t>(firstRowWithName.size());
+		firstRowWithName.push_back(noRow);
+		setFirstRowWithName(id, row);
+		return id;
+	}
+
+	const auto id = it->second;
+	if(row < firstRowWithName[id])
+	{
+		nameToId.erase(it);
+		setFirstRowWithName(id, row);
+	}
+	return id;
+}
+
+/**
+ * Make @a row the first row with name @a nameId. The name index refers to
+ * the name of its symbol. The old key of the name must not be in the index.
+ * @param nameId Id of name
+ * @param row Row of symbol or @c noRow if no row has the name any more
+ */
+void SymbolStore::setFirstRowWithName(std::uint32_t nameId, std::uint32_t row)
+{
+	firstRowWithName[nameId] = row;
+	if(row != noRow)
+	{
+		nameToId.emplace(getName(row), nameId);
+	}
+}
+
+/**
+ * @return First row with name @a nameId or @c noRow if there is none
+ */
+std::uint32_t SymbolStore::findFirstRowWithName(std::uint32_t nameId) const
+{
+	auto it = std::find(nameIds.begin(), nameIds.end(), nameId);
+	return it == nameIds.end() ? noRow : static_cast<std::uint32_t>(it - nameIds.begin());
+}
+
+/**
+ * @return First row with valid address @a address or @c noRow if there is none
+ */
+std::uint32_t SymbolStore::findFirstRowWithAddress(unsigned long long address) const
+{
+	for(std::size_t i = 0, e = size(); i < e; ++i)
+	{
+		if((flags[i] & ADDRESS_VALID) && addresses[i] == address)
+		{
+			return static_cast<std::uint32_t>(i);
+		}
+	}
+
+	return noRow;
+}
+
+/**
+ * @return First row with index @a index or @c noRow if there is none
+ */
+std::uint32_t SymbolStore::findFirstRowWithIndex(unsigned long long index) const
+{
+	auto it = std::find(indexes.begin(), indexes.end(), index);
+	return it == indexes.end() ? noRow : static_cast<std::uint32_t>(it - indexes.begin());
+}
+
+} // namespace fileformat
+} // namespace retdec
@@ -4,6 +4,9 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
+#include <cassert>
+
 #include "retdec/utils/conversion.h"
 #include "retdec/fileformat/types/symbol_table/symbol_table.h"
 
@@ -12,6 +15,105 @@ using namespace retdec::utils;
 namespace retdec {
 namespace fileformat {
 
+/**
+ * Destructor
+ */
+SymbolTable::~SymbolTable()
+{
+	unlinkSymbols();
+}
+
+/**
+ * Index symbols added since the last call and update rows of symbols
+ * which have changed. @c storeMutex has to be locked by the caller.
+ * @return Up-to-date store of all symbols in table
+ */
+const SymbolStore& SymbolTable::syncStore() const
+{
+	if(!dirtyRows.empty())
+	{
+		std::sort(dirtyRows.begin(), dirtyRows.end());
+		dirtyRows.erase(std::unique(dirtyRows.begin(), dirtyRows.end()), dirtyRows.end());
+		for(auto i : dirtyRows)
+		{
+			store.update(i);
+		}
+		dirtyRows.clear();
+	}
+
+	if(store.size() < table.size())
+	{
+		store.reserve(table.size());
+		for(std::size_t i = store.size(), e = table.size(); i < e; ++i)
+		{
+			store.add(*table[i]);
+		}
+	}
+
+	return store;
+}
+
+/**
+ * Update row @a row before the next lookup. @c storeMutex has to be locked
+ * by the caller.
+ * @param row Row (index in table) of symbol which has changed
+ *
+ * Every update may search the whole store, so the store is rebuilt instead
+ * if a larger part of the symbols have changed.
+ */
+void SymbolTable::markRowDirty(std::size_t row)
+{
+	if(row >= store.size() || (!dirtyRows.empty() && dirtyRows.back() == row))
+	{
+		return;
+	}
+
+	if(dirtyRows.size() >= store.size() / 16)
+	{
+		store.clear();
+		dirtyRows.clear();
+	}
+	else
+	{
+		dirtyRows.push_back(row);
+	}
+}
+
+/**
+ * Called by symbol in row @a row before it is renamed
+ * @param row Row (index in table) of symbol
+ */
+void SymbolTable::symbolWillBeRenamed(std::size_t row)
+{
+	std::lock_guard<std::mutex> lock(storeMutex);
+	markRowDirty(row);
+	if(row < store.size())
+	{
+		store.detachName(row);
+	}
+}
+
+/**
+ * Called by symbol in row @a row after its indexed property has changed
+ * @param row Row (index in table) of symbol
+ */
+void SymbolTable::symbolChanged(std::size_t row)
+{
+	std::lock_guard<std::mutex> lock(storeMutex);
+	markRowDirty(row);
+}
+
+/**
+ * Detach all symbols from table, they may outlive it
+ */
+void SymbolTable::unlinkSymbols()
+{
+	for(auto &symbol : table)
+	{
+		symbol->table = nullptr;
+	}
+}
+
 /**
  * Get number of symbols in table
  * @return Number of symbols in table
@@ -38,15 +140,9 @@ const Symbol* SymbolTable::getSymbol(std::size_t symbolIndex) const
  */
 const Symbol* SymbolTable::getSymbol(const std::string &name) const
 {
-	for(const auto &s : table)
-	{
-		if(s->getName() == name)
-		{
-			return s.get();
-		}
-	}
-
-	return nullptr;
+	std::lock_guard<std::mutex> lock(storeMutex);
+	const auto row = syncStore().findByName(name);
+	return row != SymbolStore::npos ? table[row].get() : nullptr;
 }
 
 /**
@@ -56,16 +152,9 @@ const Symbol* SymbolTable::getSymbol(const std::string &name) const
  */
 const Symbol* SymbolTable::getSymbolOnAddress(unsigned long long addr) const
 {
-	for(const auto &s : table)
-	{
-		unsigned long long a;
-		if(s->getAddress(a) && a == addr)
-		{
-			return s.get();
-		}
-	}
-
-	return nullptr;
+	std::lock_guard<std::mutex> lock(storeMutex);
+	const auto row = syncStore().findByAddress(addr);
+	return row != SymbolStore::npos ? table[row].get() : nullptr;
 }
 
 /**
@@ -75,15 +164,9 @@ const Symbol* SymbolTable::getSymbolOnAddress(unsigned long long addr) const
  */
 const Symbol* SymbolTable::getSymbolWithIndex(std::size_t symbolIndex) const
 {
-	for(const auto &s : table)
-	{
-		if(s->getIndex() == symbolIndex)
-		{
-			return s.get();
-		}
-	}
-
-	return nullptr;
+	std::lock_guard<std::mutex> lock(storeMutex);
+	const auto row = syncStore().findByIndex(symbolIndex);
+	return row != SymbolStore::npos ? table[row].get() : nullptr;
 }
 
 /**
@@ -95,6 +178,20 @@ const std::string& SymbolTable::getName() const
 	return name;
 }
 
+/**
+ * Get struct-of-arrays store of all symbols in table
+ * @return Store with rows in the same order as symbols in table
+ *
+ * The store is valid until the table or its symbols are modified. It may be
+ * read concurrently with other const accesses to the table, they do not
+ * change an up-to-date store.
+ */
+const SymbolStore& SymbolTable::getStore() const
+{
+	std::lock_guard<std::mutex> lock(storeMutex);
+	return syncStore();
+}
+
 /**
  * Get pointer to symbol from table
  * @param symbolIndex Index of selected symbol (indexed from 0)
@@ -112,15 +209,9 @@ Symbol* SymbolTable::getSymbol(std::size_t symbolIndex)
  */
 Symbol* SymbolTable::getSymbol(const std::string &name)
 {
-	for(auto &s : table)
-	{
-		if(s->getName() == name)
-		{
-			return s.get();
-		}
-	}
-
-	return nullptr;
+	std::lock_guard<std::mutex> lock(storeMutex);
+	const auto row = syncStore().findByName(name);
+	return row != SymbolStore::npos ? table[row].get() : nullptr;
 }
 
 /**
@@ -130,16 +221,9 @@ Symbol* SymbolTable::getSymbol(const std::string &name)
  */
 Symbol* SymbolTable::getSymbolOnAddress(unsigned long long addr)
 {
-	for(auto &s : table)
-	{
-		unsigned long long a;
-		if(s->getAddress(a) && a == addr)
-		{
-			return s.get();
-		}
-	}
-
-	return nullptr;
+	std::lock_guard<std::mutex> lock(storeMutex);
+	const auto row = syncStore().findByAddress(addr);
+	return row != SymbolStore::npos ? table[row].get() : nullptr;
 }
 
 /**
@@ -149,15 +233,9 @@ Symbol* SymbolTable::getSymbolOnAddress(unsigned long long addr)
  */
 Symbol* SymbolTable::getSymbolWithIndex(std::size_t symbolIndex)
 {
-	for(auto &s : table)
-	{
-		if(s->getIndex() == symbolIndex)
-		{
-			return s.get();
-		}
-	}
-
-	return nullptr;
+	std::lock_guard<std::mutex> lock(storeMutex);
+	const auto row = syncStore().findByIndex(symbolIndex);
+	return row != SymbolStore::npos ? table[row].get() : nullptr;
 }
 
 /**
@@ -201,24 +279,40 @@ SymbolTable::symbolsIterator SymbolTable::end()
  */
 void SymbolTable::clear()
 {
+	std::lock_guard<std::mutex> lock(storeMutex);
+	unlinkSymbols();
 	table.clear();
+	store.clear();
+	dirtyRows.clear();
+}
+
+/**
+ * Reserve space for @a n symbols
+ * @param n Number of symbols
+ */
+void SymbolTable::reserve(std::size_t n)
+{
+	table.reserve(n);
 }
 
 /**
  * Add new symbol to table
- * @param symbol New symbol
+ * @param symbol New symbol; it must not be stored in another table
  */
 void SymbolTable::addSymbol(const std::shared_ptr<Symbol> &symbol)
 {
-	table.push_back(symbol);
+	addSymbol(std::shared_ptr<Symbol>(symbol));
 }
 
 /**
  * Add new symbol to table
- * @param symbol New symbol
+ * @param symbol New symbol; it must not be stored in another table
  */
 void SymbolTable::addSymbol(std::shared_ptr<Symbol> &&symbol)
 {
+	assert(!symbol->table && "symbol is already stored in a table");
+	symbol->table = this;
+	symbol->tableRow = table.size();
 	table.push_back(std::move(symbol));
 }
 
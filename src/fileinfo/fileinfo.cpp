@@ -14,6 +14,7 @@
 #include "retdec/utils/memory.h"
 #include "retdec/utils/io/log.h"
 #include "retdec/utils/string.h"
+#include "retdec/utils/system.h"
 #include "retdec/utils/time.h"
 #include "retdec/utils/version.h"
 #include "retdec/ar-extractor/detection.h"
@@ -79,6 +80,8 @@ struct ProgParams
 	LoadFlags loadFlags = LoadFlags::NONE;
 	/// flag whether to include analysis time into the output
 	bool analysisTime = false;
+	/// exit without freeing memory once the output is written
+	bool fastExit = false;
 
 	friend std::ostream& operator<<(std::ostream& os, const ProgParams& pp);
 };
@@ -100,6 +103,7 @@ std::ostream& operator<<(std::ostream& os, const ProgParams& pp)
 	os << "ep bytes count     : " << pp.epBytesCount << "\n";
 	os << "load flags         : " << pp.loadFlags << "\n";
 	os << "analysis time      : " << pp.analysisTime << "\n";
+	os << "fast exit          : " << pp.fastExit << "\n";
 
 	os << "yara malware rules : " << "\n";
 	for (auto& r : pp.yaraMalwarePaths)
@@ -224,6 +228,9 @@ void printHelp()
 				<< "                          Limit maximal memory to N bytes (0 means no limit).\n"
 				<< "    --max-memory-half-ram\n"
 				<< "                          Limit maximal memory to half of system RAM.\n"
+				<< "    --fast-exit\n"
+				<< "                          Exit right after the output is written without\n"
+				<< "                          freeing the memory used by the analysis.\n"
 				<< "\n"
 				<< "Options for specifying list of available DLLs:\n"
 				<< "    --dlls=filename\n"
@@ -396,6 +403,7 @@ bool doConfigString(
 	params.explanatory = retdec::serdes::deserializeBool(root, "explanatory", params.explanatory);
 	params.maxMemoryHalfRAM = retdec::serdes::deserializeBool(root, "maxMemoryHalf", params.maxMemoryHalfRAM);
 	params.analysisTime = retdec::serdes::deserializeBool(root, "analysisTime", params.analysisTime);
+	params.fastExit = retdec::serdes::deserializeBool(root, "fastExit", params.fastExit);
 
 	if (root.HasMember("loadStrings"))
 	{
@@ -653,6 +661,10 @@ bool doParams(int argc, char **_argv, ProgParams &params)
 		{
 			params.maxMemoryHalfRAM = true;
 		}
+		else if (c == "--fast-exit")
+		{
+			params.fastExit = true;
+		}
 		else if (c == "--no-hashes")
 		{
 			std::string value;
@@ -863,6 +875,13 @@ int main(int argc, char* argv[])
 		}
 	}
 
+	auto ret = isFatalError(res) ? static_cast<int>(res) : static_cast<int>(ReturnCode::OK);
+	if(params.fastExit)
+	{
+		// The parsed file and all the detected information are left to the OS.
+		retdec::utils::exitWithoutTeardown(ret);
+	}
+
 	delete fileDetector;
-	return isFatalError(res) ? static_cast<int>(res) : static_cast<int>(ReturnCode::OK);
+	return ret;
 }
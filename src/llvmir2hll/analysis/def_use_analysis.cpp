@@ -6,7 +6,6 @@
 
 #include "retdec/llvmir2hll/analysis/def_use_analysis.h"
 #include "retdec/llvmir2hll/analysis/value_analysis.h"
-#include "retdec/llvmir2hll/analysis/var_uses_visitor.h"
 #include "retdec/llvmir2hll/graphs/cfg/cfg_builders/recursive_cfg_builder.h"
 #include "retdec/llvmir2hll/ir/function.h"
 #include "retdec/llvmir2hll/ir/module.h"
@@ -15,28 +14,24 @@
 #include "retdec/llvmir2hll/support/debug.h"
 #include "retdec/utils/container.h"
 
-using retdec::utils::addToSet;
 using retdec::utils::hasItem;
 
 namespace retdec {
 namespace llvmir2hll {
 
-namespace {
-
-/// Set of nodes in a CFG.
-using NodeSet = std::set<ShPtr<CFG::Node>>;
-
-/// Order of nodes in a CFG.
-using NodeOrder = std::vector<ShPtr<CFG::Node>>;
-
-} // anonymous namespace
-
 /**
 * @brief Emits all the live variables info to standard error.
 *
 * Only for debugging purposes.
 */
 void DefUseChains::debugPrint() {
+	auto printUses = [this](const llvm::BitVector &useIndexes) {
+		for (auto i : useIndexes.set_bits()) {
+			llvm::errs() << "      (" << uses[i].first << ", "
+				<< uses[i].second->getName() << ")\n";
+		}
+	};
+
 	llvm::errs() << "[DefUseChains] Debug info for function '" << func->getName() << "':\n";
 	llvm::errs() << "\n";
 	llvm::errs() << "Out, in, gen, and kill sets:\n";
@@ -44,25 +39,13 @@ void DefUseChains::debugPrint() {
 	for (auto i = cfg->node_begin(), e = cfg->node_end(); i != e; ++i) {
 		llvm::errs() << "  " << (*i)->getLabel() << ":\n";
 		llvm::errs() << "    kill: \n";
-		for (auto j = kill[*i].begin(), f = kill[*i].end(); j != f; ++j) {
-			llvm::errs() << "      (" << j->first << ", "
-				<< j->second->getName() << ")\n";
-		}
+		printUses(dataflow->getKill(*i));
 		llvm::errs() << "\n    gen: \n";
-		for (auto j = gen[*i].begin(), f = gen[*i].end(); j != f; ++j) {
-			llvm::errs() << "      (" << j->first << ", "
-				<< j->second->getName() << ")\n";
-		}
+		printUses(dataflow->getGen(*i));
 		llvm::errs() << "\n    in: \n";
-		for (auto j = in[*i].begin(), f = in[*i].end(); j != f; ++j) {
-			llvm::errs() << "      (" << j->first << ", "
-				<< j->second->getName() << ")\n";
-		}
+		printUses(dataflow->getIn(*i));
 		llvm::errs() << "\n    out: \n";
-		for (auto j = out[*i].begin(), f = out[*i].end(); j != f; ++j) {
-			llvm::errs() << "      (" << j->first << ", "
-				<< j->second->getName() << ")\n";
-		}
+		printUses(dataflow->getOut(*i));
 		llvm::errs() << "\n\n";
 	}
 	llvm::errs() << "Def-use chains:\n";
@@ -84,15 +67,8 @@ void DefUseChains::debugPrint() {
 *
 * See create() for the description of the parameters.
 */
-DefUseAnalysis::DefUseAnalysis(ShPtr<Module> module,
-		ShPtr<ValueAnalysis> va, ShPtr<VarUsesVisitor> vuv):
-		module(module), va(va), vuv(vuv),
-		cfgBuilder(RecursiveCFGBuilder::create()) {
-	// If we don't have a visitor for obtaining uses of variables, create one.
-	if (!this->vuv) {
-		this->vuv = VarUsesVisitor::create(this->va);
-	}
-}
+DefUseAnalysis::DefUseAnalysis(ShPtr<Module> module, ShPtr<ValueAnalysis> va):
+		module(module), va(va), cfgBuilder(RecursiveCFGBuilder::create()) {}
 
 /**
 * @brief Returns def-use chains for the given function.
@@ -118,6 +94,7 @@ ShPtr<DefUseChains> DefUseAnalysis::getDefUseChains(
 		ducs->cfg = cfgBuilder->getCFG(func);
 	}
 
+	computeUses(ducs);
 	computeGenAndKill(ducs);
 	computeInAndOut(ducs);
 	computeDefUseChains(ducs);
@@ -130,9 +107,6 @@ ShPtr<DefUseChains> DefUseAnalysis::getDefUseChains(
 *
 * @param[in] module Module for which the analysis is created.
 * @param[in] va The used analysis of values.
-* @param[in] vuv The used visitor for obtaining uses of variables.
-*
-* If @a vuv is not provided, a new visitor is created.
 *
 * @par Preconditions
 *  - @a va is in a valid state
@@ -140,22 +114,65 @@ ShPtr<DefUseChains> DefUseAnalysis::getDefUseChains(
 * All methods of this class leave @a va in a valid state.
 */
 ShPtr<DefUseAnalysis> DefUseAnalysis::create(ShPtr<Module> module,
-		ShPtr<ValueAnalysis> va, ShPtr<VarUsesVisitor> vuv) {
+		ShPtr<ValueAnalysis> va) {
 	PRECONDITION(va->isInValidState(), "it is not in a valid state");
 
-	return ShPtr<DefUseAnalysis>(new DefUseAnalysis(module, va, vuv));
+	return ShPtr<DefUseAnalysis>(new DefUseAnalysis(module, va));
 }
 
 /**
-* @brief Computes the @c GEN[B] and @c KILL[B] sets for each CFG node @c B.
+* @brief Numbers all uses of variables in the CFG.
 *
+* The uses are numbered in the order of the CFG nodes and their statements.
 * This function modifies @a ducs.
 */
+void DefUseAnalysis::computeUses(ShPtr<DefUseChains> ducs) {
+	ducs->uses.clear();
+	ducs->usesOfVar.clear();
+
+	// For each statement in each node...
+	std::unordered_map<ShPtr<Variable>, std::vector<std::size_t>> useIndexes;
+	for (auto i = ducs->cfg->node_begin(), e = ducs->cfg->node_end();
+			i != e; ++i) {
+		for (auto j = (*i)->stmt_begin(), f = (*i)->stmt_end(); j != f; ++j) {
+			const auto &stmtData = va->getValueData(*j);
+			for (auto k = stmtData->dir_read_begin(),
+					g = stmtData->dir_read_end(); k != g; ++k) {
+				if (ducs->shouldBeIncluded(*k)) {
+					useIndexes[*k].push_back(ducs->uses.size());
+					ducs->uses.emplace_back(*j, *k);
+				}
+			}
+		}
+	}
+
+	ducs->usesOfVar.reserve(useIndexes.size());
+	for (const auto &p : useIndexes) {
+		auto &bits = ducs->usesOfVar.emplace(p.first,
+			llvm::BitVector(ducs->uses.size())).first->second;
+		for (auto index : p.second) {
+			bits.set(index);
+		}
+	}
+
+	ducs->dataflow = std::make_shared<BitVectorDataflow>(ducs->cfg,
+		ducs->uses.size(), BitVectorDataflow::Direction::Backward);
+}
+
+/**
+* @brief Computes the @c GEN[B] and @c KILL[B] sets for each CFG node @c B.
+*
+* computeUses() has to be run before this function. This function modifies
+* @a ducs.
+*/
 void DefUseAnalysis::computeGenAndKill(ShPtr<DefUseChains> ducs) {
+	// The nodes have to be traversed in the same order as in computeUses()
+	// so that the uses of each node start at useIndex.
+	std::size_t useIndex = 0;
 	// For each node B...
 	for (auto i = ducs->cfg->node_begin(), e = ducs->cfg->node_end();
 			i != e; ++i) {
-		computeGenAndKillForNode(ducs, *i);
+		computeGenAndKillForNode(ducs, *i, useIndex);
 	}
 }
 
@@ -163,18 +180,19 @@ void DefUseAnalysis::computeGenAndKill(ShPtr<DefUseChains> ducs) {
 * @brief Computes the @c GEN[B] and @c KILL[B] sets for the given CFG node @a
 *        node @c B.
 *
+* @param[in] ducs Information about def-use chains.
+* @param[in] node Currently processed basic block.
+* @param[in,out] useIndex Index of the first use in @a node. Upon return, it
+*                         is the index of the first use after @a node.
+*
 * This function modifies @a ducs.
 */
 void DefUseAnalysis::computeGenAndKillForNode(ShPtr<DefUseChains> ducs,
-	ShPtr<CFG::Node> node) {
+	ShPtr<CFG::Node> node, std::size_t &useIndex) {
 
 	// Aliases to speed up the computation.
-	auto &gen = ducs->gen[node];
-	auto &kill = ducs->kill[node];
-
-	// Initialization.
-	gen.clear();
-	kill.clear();
+	auto &gen = ducs->dataflow->getGen(node);
+	auto &kill = ducs->dataflow->getKill(node);
 
 	// Defined variables in the node (regularly updated).
 	VarSet defVars;
@@ -185,19 +203,17 @@ void DefUseAnalysis::computeGenAndKillForNode(ShPtr<DefUseChains> ducs,
 
 	// For each statement in the node...
 	for (auto i = node->stmt_begin(), e = node->stmt_end(); i != e; ++i) {
-		// Compute read/written variables in the current statement.
-		const auto &stmtData = va->getValueData(*i);
-
 		// Compute GEN[node] for the current statement.
-		for (auto j = stmtData->dir_read_begin(), f = stmtData->dir_read_end();
-				j != f; ++j) {
-			if (!hasItem(defVars, *j) && ducs->shouldBeIncluded(*j)) {
-				gen.emplace(*i, *j);
+		for (; useIndex < ducs->uses.size() &&
+				ducs->uses[useIndex].first == *i; ++useIndex) {
+			if (!hasItem(defVars, ducs->uses[useIndex].second)) {
+				gen.set(useIndex);
 			}
 		}
 
 		// Update the set of defined variables that the present statement
 		// defines.
+		const auto &stmtData = va->getValueData(*i);
 		for (auto j = stmtData->dir_written_begin(), f = stmtData->dir_written_end();
 				j != f; ++j) {
 			if (ducs->shouldBeIncluded(*j)) {
@@ -210,21 +226,11 @@ void DefUseAnalysis::computeGenAndKillForNode(ShPtr<DefUseChains> ducs,
 	// Compute KILL[node].
 	//
 
-	// For each defined variable in the node...
+	// For each defined variable in the node, kill all its uses.
 	for (const auto &defVar : defVars) {
-		// Get all statements where the current variable is used.
-		const auto &varUses = vuv->getUses(defVar, ducs->func)->dirUses;
-
-		// Insert to KILL[node] such statements from varUses that are not in
-		// the node.
-		for (const auto &varUse : varUses) {
-			// Consider only uses which are "read" uses, not "write" uses.
-			const auto &readVarsInVarUse = va->getValueData(varUse)->getDirReadVars();
-			if (!hasItem(readVarsInVarUse, defVar)) {
-				continue;
-			}
-
-			kill.emplace(varUse, defVar);
+		auto i = ducs->usesOfVar.find(defVar);
+		if (i != ducs->usesOfVar.end()) {
+			kill |= i->second;
 		}
 	}
 }
@@ -238,123 +244,10 @@ void DefUseAnalysis::computeGenAndKillForNode(ShPtr<DefUseChains> ducs,
 void DefUseAnalysis::computeInAndOut(ShPtr<DefUseChains> ducs) {
 	// The subsequent implementation is based on Section 6.3.6 in [ItC] (see
 	// the class description). The algorithm is the same as in the analysis of
-	// live variables (see page 112 in [ItC]).
-
-	// To speedup the execution, we first order the nodes so that when we
-	// compute IN and OUT in this order, it will require less iterations than
-	// computing these sets in a "random" order. At first, we add just the entry
-	// node to the order. Then, we add all its successors to the order. We
-	// keep traversing the CFG until we add all of its non-exit nodes. Notice
-	// that we have to add the nodes to the front of the order, not to the
-	// back (this would greatly lengthen the computation of IN and OUT).
-	NodeOrder order;
-	order.reserve(ducs->cfg->getNumberOfNodes());
-	order.push_back(ducs->cfg->getEntryNode());
-	// To check whether a node has already been added to the order, we use a
-	// set. The reason is that a vector searches in O(n) while a set searches
-	// in O(log(n)).
-	// Note: Using unordered_set instead of a set doesn't speed up the
-	//       computation, so we use just set.
-	NodeSet orderSet(order.begin(), order.end());
-	// We will keep iterating until we add all non-exit nodes to the order.
-	do {
-		// For every node in the order...
-		// Note: We have to iterate using indices because in the nested loop,
-		//       we modify order. If we used a range-based for loop, we may
-		//       ended up with invalid iterators. Another solution may be to
-		//       iterate over a copy of order, but this would be needlessly
-		//       inefficient (the computation of IN and OUT has to be as fast
-		//       as possible).
-		for (std::size_t i = 0, e = order.size(); i < e; ++i) {
-			const auto &node = order[i];
-			// For every predecessor of this node...
-			for (auto j = node->succ_begin(), f = node->succ_end(); j != f; ++j) {
-				const auto &pred = (*j)->getDst();
-				// Do not include the node if it is either already present in
-				// the order or it is the exit node.
-				if (!hasItem(orderSet, pred) && pred != ducs->cfg->getExitNode()) {
-					order.push_back(pred);
-					orderSet.insert(pred);
-				}
-			}
-		}
-	// The -1 below is for the exit node, which we do not add into the order.
-	} while (order.size() < ducs->cfg->getNumberOfNodes() - 1);
-
-	//
-	// Initialize the analysis.
-	//
-	ducs->in.clear();
-	ducs->out.clear();
-	// Normally, we would have to set IN[B] = \emptyset for each node B.
-	// However, since ducs->in[B] gets initialized to an empty set
-	// automatically upon first access, we don't have to do it.
-
-	//
-	// Perform the iterative algorithm to obtain IN and OUT for each node.
-	//
-	bool setChanged;
-	do {
-		setChanged = false;
-		// For each node in the computer order...
-		// Note: To use the order computed above, we have to traverse the
-		// vector in reverse, i.e. from its end towards its beginning.
-		for (auto i = order.rbegin(), e = order.rend(); i != e; ++i) {
-			setChanged |= computeInAndOutForNode(ducs, *i);
-		}
-	} while (setChanged);
-}
-
-/**
-* @brief Computes the @c IN[node] and @c OUT[node] set for the given node @a node.
-*
-* @return @c true if either of these two sets has been changed, @c false
-*         otherwise.
-*
-* This function modifies @a ducs.
-*
-* @par Preconditions
-*  - @a node is not the exit node of a CFG
-*/
-bool DefUseAnalysis::computeInAndOutForNode(ShPtr<DefUseChains> ducs,
-		ShPtr<CFG::Node> node) {
-	// See the implementation of computeInAndOut() for the description of the
-	// following algorithm.
-
-	// OUT[B] = \bigcup_{S \in succ(B)} IN[S]
-	DefUseChains::StmtVarPairSet newOut;
-	for (auto i = node->succ_begin(), e = node->succ_end(); i != e; ++i) {
-		addToSet(ducs->in[(*i)->getDst()], newOut);
-	}
-
-	// Check whether OUT[B] has been changed.
-	auto &out = ducs->out[node];
-	auto &in = ducs->in[node];
-	if (out.size() != newOut.size()) {
-		// We no longer need newOut, so we can make a move instead of a copy.
-		out = std::move(newOut);
-	} else if (!in.empty()) {
-		// OUT[B] hasn't been changed and IN[B] has already been
-		// computed, so we don't have to recompute IN[B] because it
-		// would remain unchanged.
-		return false;
-	}
-
-	// IN[B] = GEN[B] \cup (OUT[B] - KILL[B])
-	// The following code is faster than
-	// in = setUnion(ducs->gen[node], setDifference(out, ducs->kill[node]));
-	in = ducs->gen[node];
-	auto &kill = ducs->kill[node];
-	for (auto &item : out) {
-		if (!hasItem(kill, item)) {
-			in.insert(item);
-		}
-	}
-
-	// At this moment, OUT may be unchanged, but IN has been computed for the
-	// first time. Therefore, we have to check that at least one item has been
-	// added to IN.
-	return !in.empty();
+	// live variables (see page 112 in [ItC]): a backward problem whose meet
+	// operator is the union and whose boundary (OUT of the exit node) is
+	// empty.
+	ducs->dataflow->solve();
 }
 
 /**
@@ -440,10 +333,14 @@ void DefUseAnalysis::computeDefUseChainForStmt(ShPtr<DefUseChains> ducs,
 	// We have traversed all statements in the node without stopping the
 	// computation, so add also the relevant contents of OUT[node] to the
 	// def-use chain.
-	for (auto &item : ducs->out[node]) {
-		if (item.second == defVar) {
-			du.insert(item.first);
-		}
+	auto usesOfDefVar = ducs->usesOfVar.find(defVar);
+	if (usesOfDefVar == ducs->usesOfVar.end()) {
+		return;
+	}
+	llvm::BitVector reachableUses(ducs->dataflow->getOut(node));
+	reachableUses &= usesOfDefVar->second;
+	for (auto i : reachableUses.set_bits()) {
+		du.insert(ducs->uses[i].first);
 	}
 }
 
@@ -117,7 +117,7 @@ UPtr<JSONConfig> JSONConfig::fromFile(const std::string &path) {
 	auto config = UPtr<JSONConfig>(new JSONConfig());
 	config->impl->path = path;
 	try {
-		config->impl->config.readJsonFile(path);
+		config->impl->config.readFile(path);
 	} catch (const retdec::config::FileNotFoundException &ex) {
 		throw JSONConfigFileNotFoundError(ex.what());
 	} catch (const retdec::config::Exception &ex) {
@@ -127,7 +127,7 @@ UPtr<JSONConfig> JSONConfig::fromFile(const std::string &path) {
 }
 
 /**
-* @brief Parses and returns a config from the given JSON string.
+* @brief Parses and returns a config from the given JSON or binary string.
 *
 * @throw JSONConfigParsingError when there is a parsing error.
 */
@@ -135,7 +135,7 @@ UPtr<JSONConfig> JSONConfig::fromString(const std::string &str) {
 	// We cannot use std::make_unique() because JSONConfig() is private.
 	auto config = UPtr<JSONConfig>(new JSONConfig());
 	try {
-		config->impl->config.readJsonString(str);
+		config->impl->config.readString(str);
 	} catch (const retdec::config::Exception &ex) {
 		throw JSONConfigParsingError(ex.what());
 	}
@@ -151,7 +151,7 @@ UPtr<JSONConfig> JSONConfig::empty() {
 }
 
 void JSONConfig::saveTo(const std::string &path) {
-	impl->config.generateJsonFile(path);
+	impl->config.generateFile(path);
 }
 
 void JSONConfig::dump() {
@@ -0,0 +1,315 @@
+/**
+* @file src/llvmir2hll/graphs/cfg/bit_vector_dataflow.cpp
+* @brief Implementation of BitVectorDataflow.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <iterator>
+#include <utility>
+
+#include "retdec/llvmir2hll/graphs/cfg/bit_vector_dataflow.h"
+#include "retdec/llvmir2hll/support/debug.h"
+
+namespace retdec {
+namespace llvmir2hll {
+
+/**
+* @brief Constructs empty sets of facts of a node.
+*/
+BitVectorDataflow::NodeSets::NodeSets(std::size_t numOfFacts):
+	gen(numOfFacts), kill(numOfFacts), in(numOfFacts), out(numOfFacts) {}
+
+/**
+* @brief Constructs a new problem over the given CFG.
+*
+* @param[in] cfg CFG over which the problem is solved.
+* @param[in] numOfFacts Number of facts (the size of all the sets).
+* @param[in] direction Direction of the propagation of facts.
+* @param[in] meet Operator combining facts coming from several nodes.
+*
+* All the @c GEN, @c KILL, and boundary sets are initially empty.
+*
+* @par Preconditions
+*  - @a cfg is non-null
+*/
+BitVectorDataflow::BitVectorDataflow(ShPtr<CFG> cfg, std::size_t numOfFacts,
+		Direction direction, Meet meet):
+	cfg(cfg), numOfFacts(numOfFacts), direction(direction), meet(meet),
+	boundary(numOfFacts), nodes(cfg->node_begin(), cfg->node_end()),
+	nodeIndexes(), sets(), inputs(nodes.size()), dependents(nodes.size()),
+	order(), orderPositions(nodes.size()), numOfNodeEvaluations(0) {
+	PRECONDITION_NON_NULL(cfg);
+
+	nodeIndexes.reserve(nodes.size());
+	sets.reserve(nodes.size());
+	for (std::size_t i = 0, e = nodes.size(); i < e; ++i) {
+		nodeIndexes.emplace(nodes[i], i);
+		sets.emplace_back(numOfFacts);
+	}
+
+	for (std::size_t i = 0, e = nodes.size(); i < e; ++i) {
+		for (auto j = nodes[i]->succ_begin(), f = nodes[i]->succ_end();
+				j != f; ++j) {
+			std::size_t succ = getNodeIndex((*j)->getDst());
+			if (direction == Direction::Forward) {
+				dependents[i].push_back(succ);
+				inputs[succ].push_back(i);
+			} else {
+				dependents[succ].push_back(i);
+				inputs[i].push_back(succ);
+			}
+		}
+	}
+
+	computeOrder();
+}
+
+/**
+* @brief Returns the CFG over which the problem is solved.
+*/
+ShPtr<CFG> BitVectorDataflow::getCFG() const {
+	return cfg;
+}
+
+/**
+* @brief Returns the number of facts.
+*/
+std::size_t BitVectorDataflow::getNumOfFacts() const {
+	return numOfFacts;
+}
+
+/**
+* @brief Returns the @c GEN set of @a node so it can be set up.
+*
+* @par Preconditions
+*  - @a node is a node of the CFG of the problem
+*/
+llvm::BitVector &BitVectorDataflow::getGen(ShPtr<CFG::Node> node) {
+	return sets[getNodeIndex(node)].gen;
+}
+
+/**
+* @brief Returns the @c KILL set of @a node so it can be set up.
+*
+* @par Preconditions
+*  - @a node is a node of the CFG of the problem
+*/
+llvm::BitVector &BitVectorDataflow::getKill(ShPtr<CFG::Node> node) {
+	return sets[getNodeIndex(node)].kill;
+}
+
+/**
+* @brief Sets the value used for nodes without predecessors (forward
+*        problems) or successors (backward problems).
+*
+* @par Preconditions
+*  - the size of @a newBoundary is the number of facts
+*/
+void BitVectorDataflow::setBoundary(const llvm::BitVector &newBoundary) {
+	PRECONDITION(newBoundary.size() == numOfFacts,
+		"the boundary has " << newBoundary.size() << " facts instead of "
+		<< numOfFacts);
+
+	boundary = newBoundary;
+}
+
+/**
+* @brief Computes the @c IN and @c OUT sets of all nodes.
+*
+* The problem may be solved repeatedly, e.g. after changing some of the
+* @c GEN or @c KILL sets.
+*/
+void BitVectorDataflow::solve() {
+	// Union starts from the empty set, intersection from the full set.
+	for (auto &nodeSets : sets) {
+		if (meet == Meet::Union) {
+			nodeSets.in.reset();
+			nodeSets.out.reset();
+		} else {
+			nodeSets.in.set();
+			nodeSets.out.set();
+		}
+	}
+
+	// The worklist contains positions in the order so the pending node that
+	// comes first in the order is always evaluated first.
+	llvm::BitVector worklist(order.size(), true);
+	numOfNodeEvaluations = 0;
+	for (int pos = worklist.find_first(); pos != -1;
+			pos = worklist.find_first()) {
+		worklist.reset(pos);
+		std::size_t index = order[pos];
+		if (evaluateNode(index)) {
+			for (auto dependent : dependents[index]) {
+				worklist.set(orderPositions[dependent]);
+			}
+		}
+	}
+}
+
+/**
+* @brief Returns the @c GEN set of @a node.
+*
+* @par Preconditions
+*  - @a node is a node of the CFG of the problem
+*/
+const llvm::BitVector &BitVectorDataflow::getGen(
+		ShPtr<CFG::Node> node) const {
+	return sets[getNodeIndex(node)].gen;
+}
+
+/**
+* @brief Returns the @c KILL set of @a node.
+*
+* @par Preconditions
+*  - @a node is a node of the CFG of the problem
+*/
+const llvm::BitVector &BitVectorDataflow::getKill(
+		ShPtr<CFG::Node> node) const {
+	return sets[getNodeIndex(node)].kill;
+}
+
+/**
+* @brief Returns the @c IN set of @a node.
+*
+* @par Preconditions
+*  - @a node is a node of the CFG of the problem
+*  - solve() has been called
+*/
+const llvm::BitVector &BitVectorDataflow::getIn(
+		ShPtr<CFG::Node> node) const {
+	return sets[getNodeIndex(node)].in;
+}
+
+/**
+* @brief Returns the @c OUT set of @a node.
+*
+* @par Preconditions
+*  - @a node is a node of the CFG of the problem
+*  - solve() has been called
+*/
+const llvm::BitVector &BitVectorDataflow::getOut(
+		ShPtr<CFG::Node> node) const {
+	return sets[getNodeIndex(node)].out;
+}
+
+/**
+* @brief Returns the number of node evaluations performed by the last call of
+*        solve().
+*
+* For acyclic CFGs, it is equal to the number of nodes.
+*/
+std::size_t BitVectorDataflow::getNumOfNodeEvaluations() const {
+	return numOfNodeEvaluations;
+}
+
+/**
+* @brief Computes the order in which the nodes are evaluated.
+*
+* The order is the reverse postorder of a depth-first search in the direction
+* of the problem, started from the entry node (forward problems) or the exit
+* node (backward problems). Nodes not reached from there (e.g. nodes of
+* infinite loops in backward problems) are searched afterwards and placed
+* before the nodes into which their facts flow.
+*/
+void BitVectorDataflow::computeOrder() {
+	std::vector<std::size_t> postorder;
+	postorder.reserve(nodes.size());
+	std::vector<bool> visited(nodes.size(), false);
+
+	// The search is iterative so that large CFGs do not overflow the stack.
+	// Every item of the stack is a node and the position of its next
+	// dependent to be visited.
+	std::vector<std::pair<std::size_t, std::size_t>> stack;
+	auto search = [&](std::size_t start) {
+		visited[start] = true;
+		stack.emplace_back(start, 0);
+		while (!stack.empty()) {
+			auto &top = stack.back();
+			if (top.second < dependents[top.first].size()) {
+				std::size_t next = dependents[top.first][top.second++];
+				if (!visited[next]) {
+					visited[next] = true;
+					stack.emplace_back(next, 0);
+				}
+			} else {
+				postorder.push_back(top.first);
+				stack.pop_back();
+			}
+		}
+	};
+
+	if (!nodes.empty()) {
+		search(getNodeIndex(direction == Direction::Forward ?
+			cfg->getEntryNode() : cfg->getExitNode()));
+	}
+	for (std::size_t i = 0, e = nodes.size(); i < e; ++i) {
+		if (!visited[i]) {
+			search(i);
+		}
+	}
+
+	order.assign(postorder.rbegin(), postorder.rend());
+	for (std::size_t pos = 0, e = order.size(); pos < e; ++pos) {
+		orderPositions[order[pos]] = pos;
+	}
+}
+
+/**
+* @brief Returns the index of @a node.
+*
+* @par Preconditions
+*  - @a node is a node of the CFG of the problem
+*/
+std::size_t BitVectorDataflow::getNodeIndex(ShPtr<CFG::Node> node) const {
+	auto i = nodeIndexes.find(node);
+	PRECONDITION(i != nodeIndexes.end(), "the node is not in the CFG");
+
+	return i->second;
+}
+
+/**
+* @brief Recomputes the sets of the node with the given index.
+*
+* @return @c true if the set propagated to the dependents of the node has
+*         changed, @c false otherwise.
+*/
+bool BitVectorDataflow::evaluateNode(std::size_t index) {
+	++numOfNodeEvaluations;
+
+	auto &nodeSets = sets[index];
+	bool forward = direction == Direction::Forward;
+	llvm::BitVector &input = forward ? nodeSets.in : nodeSets.out;
+	llvm::BitVector &output = forward ? nodeSets.out : nodeSets.in;
+
+	// input = MEET of the outputs of the input nodes.
+	const auto &inputNodes = inputs[index];
+	if (inputNodes.empty()) {
+		input = boundary;
+	} else {
+		const auto &first = sets[inputNodes.front()];
+		input = forward ? first.out : first.in;
+		for (auto i = std::next(inputNodes.begin()), e = inputNodes.end();
+				i != e; ++i) {
+			const auto &other = forward ? sets[*i].out : sets[*i].in;
+			if (meet == Meet::Union) {
+				input |= other;
+			} else {
+				input &= other;
+			}
+		}
+	}
+
+	// output = GEN \cup (input - KILL)
+	llvm::BitVector newOutput(input);
+	newOutput.reset(nodeSets.kill);
+	newOutput |= nodeSets.gen;
+	if (newOutput == output) {
+		return false;
+	}
+	output = std::move(newOutput);
+	return true;
+}
+
+} // namespace llvmir2hll
+} // namespace retdec
@@ -10,7 +10,6 @@
 #include "retdec/llvmir2hll/ir/assign_stmt.h"
 #include "retdec/llvmir2hll/ir/constant.h"
 #include "retdec/llvmir2hll/ir/function.h"
-#include "retdec/llvmir2hll/ir/global_var_def.h"
 #include "retdec/llvmir2hll/ir/module.h"
 #include "retdec/llvmir2hll/ir/return_stmt.h"
 #include "retdec/llvmir2hll/ir/statement.h"
@@ -19,10 +18,7 @@
 #include "retdec/llvmir2hll/utils/ir.h"
 #include "retdec/utils/container.h"
 
-using retdec::utils::addToSet;
 using retdec::utils::hasItem;
-using retdec::utils::setDifference;
-using retdec::utils::setIntersection;
 
 namespace retdec {
 namespace llvmir2hll {
@@ -35,11 +31,11 @@ namespace llvmir2hll {
 OptimFuncInfoCFGTraversal::OptimFuncInfoCFGTraversal(ShPtr<Module> module,
 		ShPtr<OptimCallInfoObtainer> cio, ShPtr<ValueAnalysis> va,
 		ShPtr<CFG> cfg):
-	CFGTraversal(cfg, true), module(module), globalVars(module->getGlobalVars()),
-	cg(cio->getCG()), cio(cio), va(va), cfg(cfg),
-	traversedFunc(cfg->getCorrespondingFunction()),
+	CFGTraversal(cfg, true), module(module), cg(cio->getCG()), cio(cio),
+	va(va), cfg(cfg), traversedFunc(cfg->getCorrespondingFunction()),
 	calledFuncs(cg->getCalledFuncs(cfg->getCorrespondingFunction())),
-	funcInfo(new OptimFuncInfo(cfg->getCorrespondingFunction())) {}
+	funcInfo(new OptimFuncInfo(cfg->getCorrespondingFunction(),
+		cio->globalVarIndex)) {}
 
 /**
 * @brief Computes OptimFuncInfo for the function specified by its CFG.
@@ -70,6 +66,17 @@ ShPtr<OptimFuncInfo> OptimFuncInfoCFGTraversal::getOptimFuncInfo(
 	return traverser->performComputation();
 }
 
+/**
+* @brief Returns @c true if @a var is a global variable in @c module, @c false
+*        otherwise.
+*
+* Functions are not considered to be global variables here.
+*/
+bool OptimFuncInfoCFGTraversal::isGlobalVar(ShPtr<Variable> var) const {
+	std::size_t index = cio->globalVarIndex->getIndex(var);
+	return index != VarIndex::NO_INDEX && cio->moduleGlobalVars.test(index);
+}
+
 /**
 * @brief Computes the FuncInfo and returns it.
 */
@@ -133,8 +140,8 @@ ShPtr<OptimFuncInfo> OptimFuncInfoCFGTraversal::performComputation() {
 		// Check whether the statement is of the form localVar = globalVar.
 		ShPtr<Variable> localVar(cast<Variable>(lhs));
 		ShPtr<Variable> globalVar(cast<Variable>(rhs));
-		if (!localVar || !globalVar || hasItem(globalVars, localVar) ||
-				!hasItem(globalVars, globalVar)) {
+		if (!localVar || !globalVar || isGlobalVar(localVar) ||
+				!isGlobalVar(globalVar)) {
 			// It is not of the abovementioned form, so skip it.
 			currStmt = currStmt->getSuccessor();
 			continue;
@@ -169,34 +176,34 @@ ShPtr<OptimFuncInfo> OptimFuncInfoCFGTraversal::performComputation() {
 
 	// Update funcInfo->never{Read,Modified}Vars by global variables which are
 	// untouched in this function.
-	for (auto i = module->global_var_begin(), e = module->global_var_end();
-			i != e; ++i) {
-		ShPtr<Variable> var((*i)->getVar());
-		if (!hasItem(funcInfo->mayBeReadVars, var) &&
-				!hasItem(funcInfo->mayBeModifiedVars, var)) {
-			funcInfo->neverReadVars.insert(var);
-			funcInfo->neverModifiedVars.insert(var);
-		}
-	}
+	llvm::BitVector untouchedVars(cio->moduleGlobalVars);
+	untouchedVars.reset(funcInfo->mayBeReadVars.getIndexedVars());
+	untouchedVars.reset(funcInfo->mayBeModifiedVars.getIndexedVars());
+	funcInfo->neverReadVars.insertIndexedVars(untouchedVars);
+	funcInfo->neverModifiedVars.insertIndexedVars(untouchedVars);
 
 	// If the cfg contains only a single non-{entry,exit} node, every
 	// mayBe{Read,Modifed} variable can be turned into a always{Read,Modified}
 	// variable.
 	if (cfg->getNumberOfNodes() == 3) {
-		addToSet(funcInfo->mayBeReadVars, funcInfo->alwaysReadVars);
-		addToSet(funcInfo->mayBeModifiedVars, funcInfo->alwaysModifiedVars);
+		funcInfo->alwaysReadVars.insert(funcInfo->mayBeReadVars);
+		funcInfo->alwaysModifiedVars.insert(funcInfo->mayBeModifiedVars);
 	}
 
 	// Add all variables which are never read and never modified to
 	// varsWithNeverChangedValue.
-	VarSet neverReadAndModifedVars(setIntersection(funcInfo->neverReadVars,
-		funcInfo->neverModifiedVars));
-	addToSet(neverReadAndModifedVars, funcInfo->varsWithNeverChangedValue);
+	// Both sets contain just global variables.
+	llvm::BitVector neverReadAndModifedVars(
+		funcInfo->neverReadVars.getIndexedVars());
+	neverReadAndModifedVars &= funcInfo->neverModifiedVars.getIndexedVars();
+	funcInfo->varsWithNeverChangedValue.insertIndexedVars(
+		neverReadAndModifedVars);
 
 	// Add all global variables are not read in this function into
 	// varsAlwaysModifiedBeforeRead.
-	addToSet(setDifference(globalVars, funcInfo->mayBeReadVars),
-		funcInfo->varsAlwaysModifiedBeforeRead);
+	llvm::BitVector notReadVars(cio->moduleGlobalVars);
+	notReadVars.reset(funcInfo->mayBeReadVars.getIndexedVars());
+	funcInfo->varsAlwaysModifiedBeforeRead.insertIndexedVars(notReadVars);
 
 	return funcInfo;
 }
@@ -208,7 +215,7 @@ void OptimFuncInfoCFGTraversal::precomputeAlwaysModifiedVarsBeforeRead() {
 	// Initialization.
 	funcInfo->varsAlwaysModifiedBeforeRead.clear();
 	// Global variables which are read during the computation.
-	VarSet readVars;
+	IndexedVarSet readVars(cio->globalVarIndex);
 
 	// Currently, we only traverse the function's body up to the first compound
 	// statement. Moreover, we only consider global variables as the computed
@@ -225,22 +232,19 @@ void OptimFuncInfoCFGTraversal::precomputeAlwaysModifiedVarsBeforeRead() {
 		ShPtr<ValueData> stmtData(va->getValueData(stmt));
 
 		// Handle directly read variables.
-		addToSet(stmtData->getDirReadVars(), readVars);
+		readVars.insert(stmtData->getDirReadVars());
 
 		// Handle function calls (indirectly accessed variables).
 		for (auto i = stmtData->call_begin(), e = stmtData->call_end(); i != e; ++i) {
-			ShPtr<CallInfo> callInfo(cio->computeCallInfo(*i, traversedFunc));
-			for (const auto &var : globalVars) {
-				if (callInfo->mayBeRead(var)) {
-					readVars.insert(var);
-				}
-			}
+			ShPtr<OptimCallInfo> callInfo(cio->computeCallInfo(*i,
+				traversedFunc));
+			readVars.insertIndexedVars(callInfo->mayBeReadVars);
 		}
 
 		// Handle directly written variables.
 		for (auto i = stmtData->dir_written_begin(), e = stmtData->dir_written_end();
 				i != e; ++i) {
-			if (hasItem(globalVars, *i) && !hasItem(readVars, *i)) {
+			if (isGlobalVar(*i) && !readVars.hasVar(*i)) {
 				// This global variable is modified before read.
 				funcInfo->varsAlwaysModifiedBeforeRead.insert(*i);
 			}
@@ -264,12 +268,12 @@ void OptimFuncInfoCFGTraversal::updateFuncInfo(ShPtr<Statement> stmt) {
 	// example, if there is an if statement in the function, its body may never
 	// be entered etc.
 	ShPtr<ValueData> stmtData(va->getValueData(stmt));
-	addToSet(stmtData->getDirReadVars(), funcInfo->mayBeReadVars);
-	addToSet(stmtData->getMayBeReadVars(), funcInfo->mayBeReadVars);
-	addToSet(stmtData->getMustBeReadVars(), funcInfo->mayBeReadVars);
-	addToSet(stmtData->getDirWrittenVars(), funcInfo->mayBeModifiedVars);
-	addToSet(stmtData->getMayBeWrittenVars(), funcInfo->mayBeModifiedVars);
-	addToSet(stmtData->getMustBeWrittenVars(), funcInfo->mayBeModifiedVars);
+	funcInfo->mayBeReadVars.insert(stmtData->getDirReadVars());
+	funcInfo->mayBeReadVars.insert(stmtData->getMayBeReadVars());
+	funcInfo->mayBeReadVars.insert(stmtData->getMustBeReadVars());
+	funcInfo->mayBeModifiedVars.insert(stmtData->getDirWrittenVars());
+	funcInfo->mayBeModifiedVars.insert(stmtData->getMayBeWrittenVars());
+	funcInfo->mayBeModifiedVars.insert(stmtData->getMustBeWrittenVars());
 
 	// Update storedGlobalVars. If the statement writes into a variable in
 	// storedGlobalVars, we have to remove it from storedGlobalVars. Indeed, we
@@ -295,8 +299,8 @@ void OptimFuncInfoCFGTraversal::updateFuncInfo(ShPtr<Statement> stmt) {
 			cio->computeCallInfo(call, traversedFunc)
 		));
 
-		addToSet(callInfo->mayBeReadVars, funcInfo->mayBeReadVars);
-		addToSet(callInfo->mayBeModifiedVars, funcInfo->mayBeModifiedVars);
+		funcInfo->mayBeReadVars.insert(callInfo->mayBeReadVars);
+		funcInfo->mayBeModifiedVars.insert(callInfo->mayBeModifiedVars);
 	}
 }
 
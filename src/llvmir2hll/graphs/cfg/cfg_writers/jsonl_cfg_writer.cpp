@@ -0,0 +1,162 @@
+/**
+* @file src/llvmir2hll/graphs/cfg/cfg_writers/jsonl_cfg_writer.cpp
+* @brief Implementation of JsonlCFGWriter.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include "retdec/llvmir2hll/graphs/cfg/cfg.h"
+#include "retdec/llvmir2hll/graphs/cfg/cfg_writer_factory.h"
+#include "retdec/llvmir2hll/graphs/cfg/cfg_writers/jsonl_cfg_writer.h"
+#include "retdec/llvmir2hll/ir/expression.h"
+#include "retdec/llvmir2hll/ir/function.h"
+#include "retdec/llvmir2hll/ir/statement.h"
+
+namespace retdec {
+namespace llvmir2hll {
+
+REGISTER_AT_FACTORY("jsonl", JSONL_CFG_WRITER_ID, CFGWriterFactory,
+	JsonlCFGWriter::create);
+
+namespace {
+
+using JsonWriter = rapidjson::Writer<rapidjson::StringBuffer>;
+
+/**
+* @brief Writes @a str into @a writer as a JSON string.
+*/
+void writeString(JsonWriter &writer, const std::string &str) {
+	writer.String(str.c_str(), str.size());
+}
+
+/**
+* @brief Writes the given JSON object (a single line) into @a out.
+*/
+void writeLine(std::ostream &out, const rapidjson::StringBuffer &buffer) {
+	out.write(buffer.GetString(), buffer.GetSize());
+	out.put('\n');
+}
+
+/**
+* @brief Returns the textual representation of @a value without redundant
+*        brackets around the whole expression.
+*/
+std::string createText(ShPtr<Value> value) {
+	auto text = value->getTextRepr();
+	if (text.size() >= 2 && text.front() == '(' && text.back() == ')') {
+		return text.substr(1, text.size() - 2);
+	}
+	return text;
+}
+
+} // anonymous namespace
+
+/**
+* @brief Constructs a new JSON Lines CFG writer.
+*
+* See create() for the description of parameters.
+*/
+JsonlCFGWriter::JsonlCFGWriter(ShPtr<CFG> cfg, std::ostream &out):
+	CFGWriter(cfg, out) {}
+
+/**
+* @brief Creates a new JSON Lines CFG writer.
+*
+* @param[in] cfg CFG to be emitted.
+* @param[in] out Output stream into which the CFG will be emitted.
+*/
+ShPtr<CFGWriter> JsonlCFGWriter::create(ShPtr<CFG> cfg, std::ostream &out) {
+	return ShPtr<CFGWriter>(new JsonlCFGWriter(cfg, out));
+}
+
+std::string JsonlCFGWriter::getId() const {
+	return JSONL_CFG_WRITER_ID;
+}
+
+bool JsonlCFGWriter::emitCFG() {
+	auto funcName = cfg->getCorrespondingFunction()->getName();
+
+	NodeIdMapping nodeIds;
+	for (auto i = cfg->node_begin(), e = cfg->node_end(); i != e; ++i) {
+		auto id = nodeIds.size();
+		nodeIds.emplace(i->get(), id);
+		emitNode(*i, id, funcName);
+	}
+
+	for (auto i = cfg->edge_begin(), e = cfg->edge_end(); i != e; ++i) {
+		emitEdge(*i, nodeIds, funcName);
+	}
+	return true;
+}
+
+/**
+* @brief Emits the given node with number @a id to @c out.
+*/
+void JsonlCFGWriter::emitNode(ShPtr<CFG::Node> node, std::size_t id,
+		const std::string &funcName) {
+	rapidjson::StringBuffer buffer;
+	JsonWriter writer(buffer);
+
+	writer.StartObject();
+	writer.Key("type");
+	writer.String("node");
+	writer.Key("function");
+	writeString(writer, funcName);
+	writer.Key("id");
+	writer.Uint64(id);
+	auto label = node->getLabel();
+	if (!label.empty()) {
+		writer.Key("label");
+		writeString(writer, label);
+	}
+
+	for (auto i = node->stmt_begin(), e = node->stmt_end(); i != e; ++i) {
+		auto address = (*i)->getAddress();
+		if (address.isDefined()) {
+			writer.Key("address");
+			writeString(writer, address.toHexPrefixString());
+			break;
+		}
+	}
+
+	writer.Key("statements");
+	writer.StartArray();
+	for (auto i = node->stmt_begin(), e = node->stmt_end(); i != e; ++i) {
+		writeString(writer, createText(*i));
+	}
+	writer.EndArray();
+	writer.EndObject();
+
+	writeLine(out, buffer);
+}
+
+/**
+* @brief Emits the given edge to @c out.
+*/
+void JsonlCFGWriter::emitEdge(ShPtr<CFG::Edge> edge,
+		const NodeIdMapping &nodeIds, const std::string &funcName) {
+	rapidjson::StringBuffer buffer;
+	JsonWriter writer(buffer);
+
+	writer.StartObject();
+	writer.Key("type");
+	writer.String("edge");
+	writer.Key("function");
+	writeString(writer, funcName);
+	writer.Key("src");
+	writer.Uint64(nodeIds.at(edge->getSrc().get()));
+	writer.Key("dst");
+	writer.Uint64(nodeIds.at(edge->getDst().get()));
+	if (auto label = edge->getLabel()) {
+		writer.Key("cond");
+		writeString(writer, createText(label));
+	}
+	writer.EndObject();
+
+	writeLine(out, buffer);
+}
+
+} // namespace llvmir2hll
+} // namespace retdec
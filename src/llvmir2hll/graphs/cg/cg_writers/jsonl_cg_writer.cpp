@@ -0,0 +1,127 @@
+/**
+* @file src/llvmir2hll/graphs/cg/cg_writers/jsonl_cg_writer.cpp
+* @brief Implementation of JsonlCGWriter.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include "retdec/llvmir2hll/graphs/cg/cg.h"
+#include "retdec/llvmir2hll/graphs/cg/cg_writer_factory.h"
+#include "retdec/llvmir2hll/graphs/cg/cg_writers/jsonl_cg_writer.h"
+#include "retdec/llvmir2hll/ir/function.h"
+#include "retdec/llvmir2hll/ir/module.h"
+
+namespace retdec {
+namespace llvmir2hll {
+
+REGISTER_AT_FACTORY("jsonl", JSONL_CG_WRITER_ID, CGWriterFactory,
+	JsonlCGWriter::create);
+
+namespace {
+
+using JsonWriter = rapidjson::Writer<rapidjson::StringBuffer>;
+
+/**
+* @brief Writes @a str into @a writer as a JSON string.
+*/
+void writeString(JsonWriter &writer, const std::string &str) {
+	writer.String(str.c_str(), str.size());
+}
+
+/**
+* @brief Writes the given JSON object (a single line) into @a out.
+*/
+void writeLine(std::ostream &out, const rapidjson::StringBuffer &buffer) {
+	out.write(buffer.GetString(), buffer.GetSize());
+	out.put('\n');
+}
+
+} // anonymous namespace
+
+/**
+* @brief Constructs a new JSON Lines CG writer.
+*
+* See create() for the description of parameters.
+*/
+JsonlCGWriter::JsonlCGWriter(ShPtr<CG> cg, std::ostream &out):
+	CGWriter(cg, out) {}
+
+/**
+* @brief Creates a new JSON Lines CG writer.
+*
+* @param[in] cg CG to be emitted.
+* @param[in] out Output stream into which the CG will be emitted.
+*/
+ShPtr<CGWriter> JsonlCGWriter::create(ShPtr<CG> cg, std::ostream &out) {
+	return ShPtr<CGWriter>(new JsonlCGWriter(cg, out));
+}
+
+std::string JsonlCGWriter::getId() const {
+	return JSONL_CG_WRITER_ID;
+}
+
+bool JsonlCGWriter::emitCG() {
+	for (auto i = cg->caller_begin(), e = cg->caller_end(); i != e; ++i) {
+		emitFunc(i->second);
+	}
+
+	for (auto i = cg->caller_begin(), e = cg->caller_end(); i != e; ++i) {
+		for (const auto &callee : i->second->callees) {
+			emitCall(i->first, callee);
+		}
+	}
+	return true;
+}
+
+/**
+* @brief Emits the caller from @a calledFuncs to @c out.
+*/
+void JsonlCGWriter::emitFunc(ShPtr<CG::CalledFuncs> calledFuncs) {
+	rapidjson::StringBuffer buffer;
+	JsonWriter writer(buffer);
+	auto func = calledFuncs->caller;
+
+	writer.StartObject();
+	writer.Key("type");
+	writer.String("function");
+	writer.Key("name");
+	writeString(writer, func->getName());
+	// Functions without an address (e.g. declarations) have NO_ADDRESS_RANGE,
+	// whose start is a defined address 0.
+	auto range = cg->getCorrespondingModule()->getAddressRangeForFunc(func);
+	if (range != NO_ADDRESS_RANGE) {
+		writer.Key("address");
+		writeString(writer, range.getStart().toHexPrefixString());
+	}
+	writer.Key("defined");
+	writer.Bool(func->isDefinition());
+	writer.Key("callsByPointer");
+	writer.Bool(calledFuncs->callsByPointer);
+	writer.EndObject();
+
+	writeLine(out, buffer);
+}
+
+/**
+* @brief Emits a call from @a caller to @a callee to @c out.
+*/
+void JsonlCGWriter::emitCall(ShPtr<Function> caller, ShPtr<Function> callee) {
+	rapidjson::StringBuffer buffer;
+	JsonWriter writer(buffer);
+
+	writer.StartObject();
+	writer.Key("type");
+	writer.String("call");
+	writer.Key("caller");
+	writeString(writer, caller->getName());
+	writer.Key("callee");
+	writeString(writer, callee->getName());
+	writer.EndObject();
+
+	writeLine(out, buffer);
+}
+
+} // namespace llvmir2hll
+} // namespace retdec
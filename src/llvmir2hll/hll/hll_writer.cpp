@@ -11,6 +11,7 @@
 #include "retdec/llvmir2hll/hll/bracket_manager.h"
 #include "retdec/llvmir2hll/hll/hll_writer.h"
 #include "retdec/llvmir2hll/hll/output_manager.h"
+#include "retdec/llvmir2hll/hll/output_managers/binary_manager.h"
 #include "retdec/llvmir2hll/hll/output_managers/json_manager.h"
 #include "retdec/llvmir2hll/hll/output_managers/plain_manager.h"
 #include "retdec/llvmir2hll/ir/array_type.h"
@@ -149,7 +150,9 @@ HLLWriter::HLLWriter(llvm::raw_ostream &o, const std::string& outputFormat):
 	currFuncGotoLabelCounter(1),
 	currentIndent(DEFAULT_LEVEL_INDENT)
 {
-	if (outputFormat == "json") {
+	if (outputFormat == "binary") {
+		out = UPtr<OutputManager>(new BinaryOutputManager(o));
+	} else if (outputFormat == "json") {
 		out = UPtr<OutputManager>(new JsonOutputManagerPlain(o));
 	} else if (outputFormat == "json-human") {
 		out = UPtr<OutputManager>(new JsonOutputManagerPretty(o));
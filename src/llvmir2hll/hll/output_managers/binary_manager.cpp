@@ -0,0 +1,315 @@
+/**
+* @file src/llvmir2hll/hll/output_managers/binary_manager.cpp
+* @brief Implementation of BinaryOutputManager.
+* @copyright (c) 2019 Avast Software, licensed under the MIT license
+*/
+
+#include "retdec/llvmir2hll/hll/output_managers/binary_manager.h"
+#include "retdec/utils/string.h"
+
+namespace retdec {
+namespace llvmir2hll {
+
+using binary_tokens::Tag;
+using binary_tokens::TokenKind;
+
+namespace {
+
+/**
+ * See JsonOutputManager.
+ */
+#define HANDLE_COMMENT_MODIFIER(val)                 \
+{                                                    \
+	if (_commentModifierOn)                          \
+	{                                                \
+		_runningComment += val;                      \
+		return;                                      \
+	}                                                \
+}
+
+} // anonymous namespace
+
+BinaryOutputManager::BinaryOutputManager(llvm::raw_ostream& out) :
+		_out(out)
+{
+	_out.write(binary_tokens::MAGIC, sizeof(binary_tokens::MAGIC));
+	writeByte(binary_tokens::VERSION);
+
+	addressPush(Address::Undefined);
+}
+
+void BinaryOutputManager::finalize()
+{
+	writeByte(static_cast<std::uint8_t>(Tag::END));
+	writeString(getOutputLanguage());
+	_out.flush();
+}
+
+void BinaryOutputManager::newLine()
+{
+	if (_commentModifierOn)
+	{
+		// Clear it righ away because comment() is used to generate token
+		// and it checks for it.
+		_commentModifierOn = false;
+		if (!_runningComment.empty())
+		{
+			comment(_runningComment);
+			_runningComment.clear();
+		}
+	}
+
+	binaryToken(TokenKind::NEWLINE, "\n");
+}
+
+void BinaryOutputManager::space(const std::string& space)
+{
+	HANDLE_COMMENT_MODIFIER(space);
+	binaryToken(TokenKind::SPACE, space);
+}
+
+void BinaryOutputManager::punctuation(char p)
+{
+	HANDLE_COMMENT_MODIFIER(p);
+	binaryToken(TokenKind::PUNCTUATION, std::string(1, p));
+}
+
+void BinaryOutputManager::operatorX(const std::string& op)
+{
+	HANDLE_COMMENT_MODIFIER(op);
+	binaryToken(TokenKind::OPERATOR, op);
+}
+
+void BinaryOutputManager::globalVariableId(const std::string& id)
+{
+	HANDLE_COMMENT_MODIFIER(id);
+	binaryToken(TokenKind::ID_GVAR, id);
+}
+
+void BinaryOutputManager::localVariableId(const std::string& id)
+{
+	HANDLE_COMMENT_MODIFIER(id);
+	binaryToken(TokenKind::ID_LVAR, id);
+}
+
+void BinaryOutputManager::memberId(const std::string& id)
+{
+	HANDLE_COMMENT_MODIFIER(id);
+	binaryToken(TokenKind::ID_MEMBER, id);
+}
+
+void BinaryOutputManager::labelId(const std::string& id)
+{
+	HANDLE_COMMENT_MODIFIER(id);
+	binaryToken(TokenKind::ID_LABEL, id);
+}
+
+void BinaryOutputManager::functionId(const std::string& id)
+{
+	HANDLE_COMMENT_MODIFIER(id);
+	binaryToken(TokenKind::ID_FUNCTION, id);
+}
+
+void BinaryOutputManager::parameterId(const std::string& id)
+{
+	HANDLE_COMMENT_MODIFIER(id);
+	binaryToken(TokenKind::ID_PARAMETER, id);
+}
+
+void BinaryOutputManager::keyword(const std::string& k)
+{
+	HANDLE_COMMENT_MODIFIER(k);
+	binaryToken(TokenKind::KEYWORD, k);
+}
+
+void BinaryOutputManager::dataType(const std::string& t)
+{
+	HANDLE_COMMENT_MODIFIER(t);
+	binaryToken(TokenKind::DATA_TYPE, t);
+}
+
+void BinaryOutputManager::preprocessor(const std::string& p)
+{
+	HANDLE_COMMENT_MODIFIER(p);
+	binaryToken(TokenKind::PREPROCESSOR, p);
+}
+
+void BinaryOutputManager::include(const std::string& i)
+{
+	HANDLE_COMMENT_MODIFIER(i);
+	binaryToken(TokenKind::INCLUDE, "<" + i + ">");
+}
+
+void BinaryOutputManager::constantBool(const std::string& c)
+{
+	HANDLE_COMMENT_MODIFIER(c);
+	binaryToken(TokenKind::CONST_BOOL, c);
+}
+
+void BinaryOutputManager::constantInt(const std::string& c)
+{
+	HANDLE_COMMENT_MODIFIER(c);
+	binaryToken(TokenKind::CONST_INT, c);
+}
+
+void BinaryOutputManager::constantFloat(const std::string& c)
+{
+	HANDLE_COMMENT_MODIFIER(c);
+	binaryToken(TokenKind::CONST_FLOAT, c);
+}
+
+void BinaryOutputManager::constantString(const std::string& c)
+{
+	HANDLE_COMMENT_MODIFIER(c);
+	binaryToken(TokenKind::CONST_STRING, c);
+}
+
+void BinaryOutputManager::constantSymbol(const std::string& c)
+{
+	HANDLE_COMMENT_MODIFIER(c);
+	binaryToken(TokenKind::CONST_SYMBOL, c);
+}
+
+void BinaryOutputManager::constantPointer(const std::string& c)
+{
+	HANDLE_COMMENT_MODIFIER(c);
+	binaryToken(TokenKind::CONST_POINTER, c);
+}
+
+void BinaryOutputManager::comment(const std::string& c)
+{
+	HANDLE_COMMENT_MODIFIER(" " + c);
+	std::string str = getCommentPrefix();
+	if (!c.empty())
+	{
+		str += " " + utils::replaceCharsWithStrings(c, '\n', " ");
+	}
+	binaryToken(TokenKind::COMMENT, str);
+}
+
+void BinaryOutputManager::commentModifier()
+{
+	_commentModifierOn = true;
+}
+
+void BinaryOutputManager::addressPush(Address a)
+{
+	bool generate = true;
+
+	// Always generate the first pushed address so that first tokens are
+	// associated with something.
+	if (_addrs.empty())
+	{
+		generate = true;
+	}
+	// Do not generate address changes while in comment modifier mode.
+	// A single comment token is generated for all the stuff added in this mode
+	// and we cannot associate its individual parts with addresses.
+	else if (_commentModifierOn)
+	{
+		generate = false;
+	}
+	// Do not generate address if it is the same as the current top address.
+	// It is unnecessary.
+	else if (a == _addrs.top().first)
+	{
+		generate = false;
+	}
+
+	// Always do the push.
+	_addrs.push({a, generate});
+
+	if (generate)
+	{
+		generateAddressEntry(a);
+		_addrToGenerate = std::make_pair(Address::Undefined, false);
+	}
+}
+
+void BinaryOutputManager::addressPop()
+{
+	// Never pop the last entry.
+	if (_addrs.size() < 2)
+	{
+		return;
+	}
+
+	bool generated = _addrs.top().second;
+
+	// Always do the pop.
+	_addrs.pop();
+
+	// If the popped entry was generated, re-generate the last entry.
+	if (generated)
+	{
+		// Well actually, do not generate it right away because it is possible
+		// that the next address is going to get pushed before the next token
+		// is added, and therefore it would be unnecessary to re-generate the
+		// address if no token actually was associated with it.
+		_addrToGenerate = std::make_pair(_addrs.top().first, true);
+	}
+}
+
+void BinaryOutputManager::generateAddressEntry(Address a)
+{
+	if (a.isUndefined())
+	{
+		writeByte(static_cast<std::uint8_t>(Tag::NO_ADDRESS));
+		return;
+	}
+
+	// Zigzag encoding keeps small negative deltas small.
+	auto delta = static_cast<std::int64_t>(a.getValue() - _lastAddress);
+	writeByte(static_cast<std::uint8_t>(Tag::ADDRESS));
+	writeVarint((static_cast<std::uint64_t>(delta) << 1) ^ static_cast<std::uint64_t>(delta >> 63));
+	_lastAddress = a.getValue();
+}
+
+void BinaryOutputManager::binaryToken(TokenKind k, const std::string& v)
+{
+	if (_addrToGenerate.second)
+	{
+		generateAddressEntry(_addrToGenerate.first);
+		_addrToGenerate = std::make_pair(Address::Undefined, false);
+	}
+
+	writeByte(static_cast<std::uint8_t>(k));
+	writeString(v);
+}
+
+void BinaryOutputManager::writeByte(std::uint8_t b)
+{
+	_out << static_cast<char>(b);
+}
+
+void BinaryOutputManager::writeVarint(std::uint64_t v)
+{
+	while (v >= 0x80)
+	{
+		writeByte(static_cast<std::uint8_t>(v | 0x80));
+		v >>= 7;
+	}
+	writeByte(static_cast<std::uint8_t>(v));
+}
+
+/**
+ * Write a reference to @a s, the string itself is written only the first
+ * time it is used.
+ */
+void BinaryOutputManager::writeString(const std::string& s)
+{
+	auto it = _strings.find(s);
+	if (it != _strings.end())
+	{
+		writeVarint(it->second + 1);
+		return;
+	}
+
+	_strings.emplace(s, _strings.size());
+	writeVarint(0);
+	writeVarint(s.size());
+	_out.write(s.data(), s.size());
+}
+
+} // namespace llvmir2hll
+} // namespace retdec
@@ -0,0 +1,196 @@
+/**
+* @file src/llvmir2hll/hll/output_managers/binary_tokens.cpp
+* @brief Implementation of the binary token stream reader.
+* @copyright (c) 2019 Avast Software, licensed under the MIT license
+*/
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "retdec/llvmir2hll/hll/output_managers/binary_tokens.h"
+
+namespace retdec {
+namespace llvmir2hll {
+namespace binary_tokens {
+
+namespace {
+
+/**
+ * Token kind names -- the same as the JSON output uses.
+ */
+const char* TOKEN_KIND_NAMES[] =
+{
+	"nl",
+	"ws",
+	"punc",
+	"op",
+	"i_gvar",
+	"i_lvar",
+	"i_mem",
+	"i_lab",
+	"i_fnc",
+	"i_arg",
+	"keyw",
+	"type",
+	"preproc",
+	"inc",
+	"l_bool",
+	"l_int",
+	"l_fp",
+	"l_str",
+	"l_sym",
+	"l_ptr",
+	"cmnt",
+};
+
+static_assert(
+	sizeof(TOKEN_KIND_NAMES) / sizeof(TOKEN_KIND_NAMES[0])
+		== static_cast<std::size_t>(TokenKind::KINDS_COUNT),
+	"every token kind must have a name"
+);
+
+[[noreturn]] void throwMalformed(const std::string& what)
+{
+	throw std::runtime_error("malformed binary token stream: " + what);
+}
+
+} // anonymous namespace
+
+/**
+ * Get the name of the token kind used in the JSON output (e.g. "nl").
+ */
+const char* getTokenKindName(TokenKind kind)
+{
+	auto i = static_cast<std::size_t>(kind);
+	return i < static_cast<std::size_t>(TokenKind::KINDS_COUNT)
+			? TOKEN_KIND_NAMES[i]
+			: "";
+}
+
+/**
+ * Create a reader and check the stream header.
+ */
+BinaryTokenReader::BinaryTokenReader(std::istream& in) :
+		_in(in.rdbuf())
+{
+	for (char c : MAGIC)
+	{
+		if (readByte() != static_cast<std::uint8_t>(c))
+		{
+			throwMalformed("bad magic");
+		}
+	}
+	if (readByte() != VERSION)
+	{
+		throwMalformed("unsupported version");
+	}
+}
+
+/**
+ * Read the next token into @a token.
+ * @return @c false if there are no more tokens.
+ */
+bool BinaryTokenReader::next(Token& token)
+{
+	while (!_end)
+	{
+		auto tag = readByte();
+		if (tag < static_cast<std::uint8_t>(TokenKind::KINDS_COUNT))
+		{
+			token.kind = static_cast<TokenKind>(tag);
+			token.value = readString();
+			token.address = _address;
+			return true;
+		}
+
+		switch (static_cast<Tag>(tag))
+		{
+			case Tag::ADDRESS:
+			{
+				auto zz = readVarint();
+				auto delta = static_cast<std::int64_t>(zz >> 1) ^ -static_cast<std::int64_t>(zz & 1);
+				_lastAddress += static_cast<std::uint64_t>(delta);
+				_address = _lastAddress;
+				break;
+			}
+			case Tag::NO_ADDRESS:
+				_address = common::Address::Undefined;
+				break;
+			case Tag::END:
+				_language = readString();
+				_end = true;
+				break;
+			default:
+				throwMalformed("unknown record " + std::to_string(tag));
+		}
+	}
+	return false;
+}
+
+/**
+ * Get the output language. Available after all the tokens were read.
+ */
+const std::string& BinaryTokenReader::getLanguage() const
+{
+	return _language;
+}
+
+std::uint8_t BinaryTokenReader::readByte()
+{
+	auto c = _in->sbumpc();
+	if (c == std::char_traits<char>::eof())
+	{
+		throwMalformed("unexpected end");
+	}
+	return static_cast<std::uint8_t>(c);
+}
+
+std::uint64_t BinaryTokenReader::readVarint()
+{
+	std::uint64_t res = 0;
+	for (unsigned shift = 0; shift < 64; shift += 7)
+	{
+		auto b = readByte();
+		res |= std::uint64_t(b & 0x7f) << shift;
+		if ((b & 0x80) == 0)
+		{
+			return res;
+		}
+	}
+	throwMalformed("too long number");
+}
+
+const std::string& BinaryTokenReader::readString()
+{
+	auto ref = readVarint();
+	if (ref != 0)
+	{
+		if (ref > _strings.size())
+		{
+			throwMalformed("unknown string " + std::to_string(ref - 1));
+		}
+		return _strings[ref - 1];
+	}
+
+	// The length is not trusted, the string grows only as its bytes are
+	// really read from the stream.
+	auto length = readVarint();
+	std::string str;
+	char chunk[4096];
+	while (length != 0)
+	{
+		auto n = std::min<std::uint64_t>(length, sizeof(chunk));
+		if (_in->sgetn(chunk, n) != static_cast<std::streamsize>(n))
+		{
+			throwMalformed("unexpected end");
+		}
+		str.append(chunk, n);
+		length -= n;
+	}
+	_strings.push_back(std::move(str));
+	return _strings.back();
+}
+
+} // namespace binary_tokens
+} // namespace llvmir2hll
+} // namespace retdec
@@ -19,6 +19,7 @@
 #include "retdec/llvmir2hll/support/debug.h"
 #include "retdec/llvmir2hll/utils/ir.h"
 #include "retdec/llvmir2hll/utils/string.h"
+#include "retdec/utils/profiler.h"
 #include "retdec/utils/io/log.h"
 
 using namespace retdec::utils::io;
@@ -33,7 +34,7 @@ namespace llvmir2hll {
 */
 LLVMIR2BIRConverter::LLVMIR2BIRConverter(llvm::Pass *basePass):
 	basePass(basePass), optionStrictFPUSemantics(false),
-	enableDebug(false), converter(),
+	optionReleaseLLVMIR(false), enableDebug(false), converter(),
 	llvmModule(nullptr), resModule(), structConverter(), variablesManager() {}
 
 /**
@@ -58,6 +59,20 @@ void LLVMIR2BIRConverter::setOptionStrictFPUSemantics(bool strict) {
 	optionStrictFPUSemantics = strict;
 }
 
+/**
+* @brief Enables/disables releasing of LLVM IR during the conversion.
+*
+* @param[in] release If @c true, the body of every LLVM function is deleted
+*                    right after the function is converted into BIR, so the
+*                    whole LLVM IR and the whole BIR do not have to be kept in
+*                    memory at the same time. The input LLVM module then
+*                    contains only declarations, so it cannot be used after
+*                    the conversion.
+*/
+void LLVMIR2BIRConverter::setOptionReleaseLLVMIR(bool release) {
+	optionReleaseLLVMIR = release;
+}
+
 /**
 * @brief Converts the given LLVM module into a module in BIR.
 *
@@ -148,7 +163,8 @@ ShPtr<Expression> LLVMIR2BIRConverter::convertGlobalVariableInitializer(
 */
 void LLVMIR2BIRConverter::convertAndAddGlobalVariables() {
 	if (enableDebug) {
-		Log::phase("converting global variables", Log::SubPhase);
+		RETDEC_LOG_INFO << Log::SubPhase << "converting global variables"
+			<< Log::ElapsedTime << std::endl;
 	}
 
 	for (auto &globVar: llvmModule->globals()) {
@@ -198,7 +214,8 @@ ShPtr<Function> LLVMIR2BIRConverter::convertFuncDeclaration(
 void LLVMIR2BIRConverter::updateFuncToDefinition(llvm::Function &func) {
 	auto name = func.getName();
 	if (enableDebug) {
-		Log::phase("converting function " + name.str(), Log::SubPhase);
+		RETDEC_LOG_INFO << Log::SubPhase << "converting function "
+			<< name.str() << Log::ElapsedTime << std::endl;
 	}
 
 	auto birFunc = resModule->getFuncByName(name);
@@ -211,6 +228,10 @@ void LLVMIR2BIRConverter::updateFuncToDefinition(llvm::Function &func) {
 		birFunc->setLocalVars(variablesManager->getLocalVars());
 
 		generateVarDefinitions(birFunc);
+
+		static auto &structured = utils::Profiler::get().counter(
+			"llvmir2hll.functions_structured");
+		structured.fetch_add(1, std::memory_order_relaxed);
 	}
 }
 
@@ -267,8 +288,40 @@ void LLVMIR2BIRConverter::convertFuncsBodies() {
 	for (auto &func: llvmModule->functions()) {
 		if (!func.isDeclaration() && shouldBeConvertedAndAdded(func)) {
 			updateFuncToDefinition(func);
+			if (optionReleaseLLVMIR && canReleaseFuncBody(func)) {
+				releaseFuncBody(func);
+			}
+		}
+	}
+}
+
+/**
+* @brief Determines whether the body of the given LLVM function @a func can be
+*        released after its conversion.
+*
+* The converted BIR does not reference LLVM IR, so the only references to the
+* body may come from other (not yet converted) functions via addresses of
+* basic blocks.
+*/
+bool LLVMIR2BIRConverter::canReleaseFuncBody(const llvm::Function &func) const {
+	for (auto &bb: func) {
+		if (bb.hasAddressTaken()) {
+			return false;
 		}
 	}
+	return true;
+}
+
+/**
+* @brief Deletes the body of the given (already converted) LLVM function
+*        @a func, which makes it a declaration.
+*/
+void LLVMIR2BIRConverter::releaseFuncBody(llvm::Function &func) const {
+	static auto &released = utils::Profiler::get().counter(
+		"llvmir2hll.llvm_instructions_released");
+	released.fetch_add(func.getInstructionCount(), std::memory_order_relaxed);
+
+	func.deleteBody();
 }
 
 /**
@@ -2,9 +2,12 @@
 #include <algorithm>
 #include <fstream>
 #include <memory>
+#include <mutex>
 
 #include "retdec/llvmir2hll/llvmir2hll.h"
 #include "retdec/utils/io/log.h"
+#include "retdec/utils/profiler.h"
+#include "retdec/utils/thread_pool.h"
 
 using namespace llvm;
 using namespace retdec::utils::io;
@@ -25,13 +28,14 @@ std::string oArithmExprEvaluator = "c";
 bool ValidateModule = true;
 bool StrictFPUSemantics = false;
 std::string ForcedModuleName = "";
+// LLVM IR is not needed after its conversion into BIR (this pass is the last
+// one), so bodies of functions are released as soon as they are converted.
+bool ReleaseLLVMIR = true;
 // This could be implemented, but it would have to be across all parts
 // (including bin2llvmir), and all messages, not just pahses.
 // Otherwise it is useless half solution.
 bool Debug = true;
 bool EmitDebugComments = true;
-std::string oCFGWriter = "dot";
-std::string oCGWriter = "dot";
 std::string VarNameGenPrefix = "";
 std::string oVarNameGen = "fruit"; // fruit|num|word
 std::string oAliasAnalysis = "simple"; // simple|basic
@@ -149,7 +153,14 @@ void LlvmIr2Hll::getAnalysisUsage(llvm::AnalysisUsage &au) const
 
 bool LlvmIr2Hll::runOnModule(llvm::Module &m)
 {
-	Log::phase("initialization");
+	// Every phase is also measured (see utils::Profiler).
+	utils::ProfilePhases phases("llvmir2hll");
+	auto phase = [&phases](const std::string& name) {
+		Log::phase(name);
+		phases.next(name);
+	};
+
+	phase("initialization");
 
 	bool decompilationShouldContinue = initialize(m);
 	if (!decompilationShouldContinue)
@@ -157,7 +168,7 @@ bool LlvmIr2Hll::runOnModule(llvm::Module &m)
 		return false;
 	}
 
-	Log::phase("conversion of LLVM IR into BIR");
+	phase("conversion of LLVM IR into BIR");
 	decompilationShouldContinue = convertLLVMIRToBIR();
 	if (!decompilationShouldContinue)
 	{
@@ -166,7 +177,7 @@ bool LlvmIr2Hll::runOnModule(llvm::Module &m)
 
 	if (!globalConfig->parameters.isBackendKeepLibraryFuncs())
 	{
-		Log::phase("removing functions from standard libraries");
+		phase("removing functions from standard libraries");
 		removeLibraryFuncs();
 	}
 
@@ -175,76 +186,77 @@ bool LlvmIr2Hll::runOnModule(llvm::Module &m)
 	// the conversion of LLVM IR to BIR is not perfect, so it may introduce
 	// unreachable code. This causes problems later during optimizations
 	// because the code exists in BIR, but not in a CFG.
-	Log::phase("removing code that is not reachable in a CFG");
+	phase("removing code that is not reachable in a CFG");
 	removeCodeUnreachableInCFG();
 
-	Log::phase("signed/unsigned types fixing");
+	phase("signed/unsigned types fixing");
 	fixSignedUnsignedTypes();
 
-	Log::phase("converting LLVM intrinsic functions to standard functions");
+	phase("converting LLVM intrinsic functions to standard functions");
 	convertLLVMIntrinsicFunctions();
 
 	if (resModule->isDebugInfoAvailable())
 	{
-		Log::phase("obtaining debug information");
+		phase("obtaining debug information");
 		obtainDebugInfo();
 	}
 
 	if (!globalConfig->parameters.isBackendNoOpts())
 	{
-		Log::phase("alias analysis [" + aliasAnalysis->getId() + "]");
+		phase("alias analysis [" + aliasAnalysis->getId() + "]");
 		initAliasAnalysis();
 
-		Log::phase("optimizations");
+		phase("optimizations");
 		runOptimizations();
 	}
 
 	if (!globalConfig->parameters.isBackendNoVarRenaming())
 	{
-		Log::phase("variable renaming [" + varRenamer->getId() + "]");
+		phase("variable renaming [" + varRenamer->getId() + "]");
 		renameVariables();
 	}
 
 	if (!globalConfig->parameters.isBackendNoSymbolicNames())
 	{
-		Log::phase("converting constants to symbolic names");
+		phase("converting constants to symbolic names");
 		convertConstantsToSymbolicNames();
 	}
 
 	if (ValidateModule)
 	{
-		Log::phase("module validation");
+		phase("module validation");
 		validateResultingModule();
 	}
 
 	if (!FindPatterns.empty())
 	{
-		Log::phase("finding patterns");
+		phase("finding patterns");
 		findPatterns();
 	}
 
 	if (globalConfig->parameters.isBackendEmitCfg())
 	{
-		Log::phase("emission of control-flow graphs");
+		phase("emission of control-flow graphs");
 		emitCFGs();
 	}
 
 	if (globalConfig->parameters.isBackendEmitCg())
 	{
-		Log::phase("emission of a call graph");
+		phase("emission of a call graph");
 		emitCG();
 	}
 
-	Log::phase("emission of the target code [" + hllWriter->getId() + "]");
+	phase("emission of the target code [" + hllWriter->getId() + "]");
 	emitTargetHLLCode();
 
-	Log::phase("finalization");
+	phase("finalization");
 	finalize();
 
-	Log::phase("cleanup");
+	phase("cleanup");
 	cleanup();
 
-	return false;
+	// Bodies of the converted functions were deleted.
+	return ReleaseLLVMIR;
 }
 
 /**
@@ -475,7 +487,9 @@ bool LlvmIr2Hll::loadConfig()
 	try
 	{
 		config = llvmir2hll::JSONConfig::fromString(
-				globalConfig->generateJsonString()
+				globalConfig->parameters.isConfigFormatBinary()
+				? globalConfig->generateBinaryString()
+				: globalConfig->generateJsonString()
 		);
 		return true;
 	}
@@ -511,6 +525,7 @@ bool LlvmIr2Hll::convertLLVMIRToBIR()
 	auto llvm2BIRConverter = llvmir2hll::LLVMIR2BIRConverter::create(this);
 	// Options
 	llvm2BIRConverter->setOptionStrictFPUSemantics(StrictFPUSemantics);
+	llvm2BIRConverter->setOptionReleaseLLVMIR(ReleaseLLVMIR);
 
 	std::string moduleName = ForcedModuleName.empty()
 			? llvmModule->getModuleIdentifier()
@@ -543,7 +558,8 @@ void LlvmIr2Hll::removeLibraryFuncs()
 		llvmir2hll::sortByName(removedFuncs);
 		for (const auto &func : removedFuncs)
 		{
-			Log::phase("removing " + func->getName() + "()");
+			RETDEC_LOG_INFO << Log::Phase << "removing " << func->getName()
+				<< "()" << Log::ElapsedTime << std::endl;
 		}
 	}
 }
@@ -637,14 +653,21 @@ void LlvmIr2Hll::validateResultingModule()
 		llvmir2hll::ValidatorFactory::getInstance().getRegisteredObjects()
 	);
 	std::sort(regValidatorIDs.begin(), regValidatorIDs.end());
+	llvmir2hll::Validator::Validators validators;
+	std::string validatorNames;
 	for (const auto &id : regValidatorIDs)
 	{
-		Log::phase("running " + id + "Validator", Log::SubPhase);
-		ShPtr<llvmir2hll::Validator> validator(
+		validators.push_back(
 				llvmir2hll::ValidatorFactory::getInstance().createObject(id)
 		);
-		validator->validate(resModule, true);
+		validatorNames += (validatorNames.empty() ? "" : ", ") + id
+				+ "Validator";
 	}
+
+	// All the validators share a single traversal of the module, so enabling
+	// more of them does not multiply the time spent in validation.
+	Log::phase("running " + validatorNames, Log::SubPhase);
+	llvmir2hll::Validator::validateAll(validators, resModule, true, true);
 }
 
 /**
@@ -686,7 +709,13 @@ void LlvmIr2Hll::emitTargetHLLCode()
 void LlvmIr2Hll::finalize()
 {
 	saveConfig();
-	if (outFile) outFile->keep();
+	if (outFile)
+	{
+		outFile->keep();
+		// The pass may never be destroyed when the process exits without
+		// teardown, so make sure the output is complete now.
+		outFile->os().flush();
+	}
 }
 
 /**
@@ -705,6 +734,9 @@ void LlvmIr2Hll::cleanup()
 /**
 * @brief Emits a control-flow graph (CFG) for each function in the resulting
 *        module.
+*
+* CFGs are built one by one (building touches shared parts of BIR), but they
+* are written into their files in parallel, as soon as they are built.
 */
 void LlvmIr2Hll::emitCFGs()
 {
@@ -718,9 +750,10 @@ void LlvmIr2Hll::emitCFGs()
 	}
 
 	// Make sure that the requested CFG writer exists.
+	const auto& cfgWriterId = globalConfig->parameters.getBackendGraphFormat();
 	llvmir2hll::StringVector availCFGWriters(
 		llvmir2hll::CFGWriterFactory::getInstance().getRegisteredObjects());
-	if (!hasItem(availCFGWriters, oCFGWriter))
+	if (!hasItem(availCFGWriters, cfgWriterId))
 	{
 		printErrorUnsupportedObject<llvmir2hll::CFGWriterFactory>(
 			"CFG writer", "CFG writers");
@@ -734,43 +767,62 @@ void LlvmIr2Hll::emitCFGs()
 
 	// Get the extension of the files that will be written (we use the CFG
 	// writer's name for this purpose).
-	std::string fileExt(oCFGWriter);
+	std::string fileExt(cfgWriterId);
+
+	// Names of files that could not be opened. Errors are reported after all
+	// the writing tasks finish.
+	std::vector<std::string> failedFiles;
+	std::mutex failedFilesMutex;
 
 	// For each function in the resulting module...
+	utils::TaskGroup writers;
 	for (auto i = resModule->func_definition_begin(),
 			e = resModule->func_definition_end();
 			i != e;
 			++i)
 	{
-		// Open the output file.
 		std::string fileName(
 				globalConfig->parameters.getOutputFile()
 				+ ".cfg." + (*i)->getName() + "." + fileExt
 		);
-		std::ofstream out(fileName.c_str());
-		if (!out)
+		auto cfg = cfgBuilder->getCFG(*i);
+
+		// Emit the CFG into its file. The task owns the CFG, so it is freed
+		// right after it has been written.
+		writers.run([fileName, cfg, &cfgWriterId, &failedFiles, &failedFilesMutex]
+				() mutable
 		{
-			Log::error() << Log::Error
-				<< "Cannot open " + fileName + " for writing."
-				<< std::endl;
-			return;
-		}
-		// Create a CFG for the current function and emit it into the opened
-		// file.
-		auto& cfgwf = llvmir2hll::CFGWriterFactory::getInstance();
-		ShPtr<llvmir2hll::CFGWriter> writer(
-				cfgwf.createObject<ShPtr<llvmir2hll::CFG>, std::ostream &>(
-						oCFGWriter,
-						cfgBuilder->getCFG(*i),
-						out
-				)
-		);
-		ASSERT_MSG(
-				writer,
-				"instantiation of the requested CFG writer `"
-				<< oCFGWriter << "` failed"
-		);
-		writer->emitCFG();
+			std::ofstream out(fileName.c_str());
+			if (!out)
+			{
+				std::lock_guard<std::mutex> lock(failedFilesMutex);
+				failedFiles.push_back(fileName);
+				return;
+			}
+			auto& cfgwf = llvmir2hll::CFGWriterFactory::getInstance();
+			ShPtr<llvmir2hll::CFGWriter> writer(
+					cfgwf.createObject<ShPtr<llvmir2hll::CFG>, std::ostream &>(
+							cfgWriterId,
+							std::move(cfg),
+							out
+					)
+			);
+			ASSERT_MSG(
+					writer,
+					"instantiation of the requested CFG writer `"
+					<< cfgWriterId << "` failed"
+			);
+			writer->emitCFG();
+		});
+	}
+	writers.wait();
+
+	std::sort(failedFiles.begin(), failedFiles.end());
+	for (const auto& fileName : failedFiles)
+	{
+		Log::error() << Log::Error
+			<< "Cannot open " + fileName + " for writing."
+			<< std::endl;
 	}
 }
 
@@ -788,11 +840,12 @@ void LlvmIr2Hll::emitCG()
 	}
 
 	// Make sure that the requested CG writer exists.
+	const auto& cgWriterId = globalConfig->parameters.getBackendGraphFormat();
 	auto& inst = llvmir2hll::CGWriterFactory::getInstance();
 	llvmir2hll::StringVector availCGWriters(
 			inst.getRegisteredObjects()
 	);
-	if (!hasItem(availCGWriters, std::string(oCGWriter)))
+	if (!hasItem(availCGWriters, cgWriterId))
 	{
 		printErrorUnsupportedObject<llvmir2hll::CGWriterFactory>(
 				"CG writer", "CG writers"
@@ -802,7 +855,7 @@ void LlvmIr2Hll::emitCG()
 
 	// Get the extension of the file that will be written (we use the CG
 	// writer's name for this purpose).
-	std::string fileExt(oCGWriter);
+	std::string fileExt(cgWriterId);
 
 	// Open the output file.
 	std::string fileName(
@@ -821,12 +874,12 @@ void LlvmIr2Hll::emitCG()
 	auto& cgwf = llvmir2hll::CGWriterFactory::getInstance();
 	ShPtr<llvmir2hll::CGWriter> writer(
 			cgwf.createObject<ShPtr<llvmir2hll::CG>, std::ostream &>(
-			oCGWriter, llvmir2hll::CGBuilder::getCG(resModule), out
+			cgWriterId, llvmir2hll::CGBuilder::getCG(resModule), out
 	));
 	ASSERT_MSG(
 			writer,
 			"instantiation of the requested CG writer `"
-			<< oCGWriter << "` failed"
+			<< cgWriterId << "` failed"
 	);
 	writer->emitCG();
 }
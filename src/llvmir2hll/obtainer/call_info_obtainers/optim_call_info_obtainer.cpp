@@ -17,9 +17,7 @@
 #include "retdec/llvmir2hll/support/debug.h"
 #include "retdec/utils/io/log.h"
 
-using retdec::utils::addToSet;
 using retdec::utils::hasItem;
-using retdec::utils::setIntersection;
 using namespace retdec::utils::io;
 
 namespace retdec {
@@ -31,8 +29,17 @@ REGISTER_AT_FACTORY("optim", OPTIM_CALL_INFO_OBTAINER_ID, CallInfoObtainerFactor
 /**
 * @brief Constructs a new optimistic piece of information about the given
 *        function call.
+*
+* Global variables from @a globalVarIndex are stored in bit vectors.
 */
-OptimCallInfo::OptimCallInfo(ShPtr<CallExpr> call): CallInfo(call) {}
+OptimCallInfo::OptimCallInfo(ShPtr<CallExpr> call,
+		ShPtr<const VarIndex> globalVarIndex):
+	CallInfo(call), neverReadVars(globalVarIndex),
+	mayBeReadVars(globalVarIndex), alwaysReadVars(globalVarIndex),
+	neverModifiedVars(globalVarIndex), mayBeModifiedVars(globalVarIndex),
+	alwaysModifiedVars(globalVarIndex),
+	varsWithNeverChangedValue(globalVarIndex),
+	varsAlwaysModifiedBeforeRead(globalVarIndex) {}
 
 /**
 * @brief Emits the info to standard error.
@@ -43,69 +50,78 @@ void OptimCallInfo::debugPrint() {
 	Log::error() << "[OptimCallInfo] Debug info for '" << call << "':\n";
 
 	Log::error() << "  neverReadVars:      ";
-	dump(neverReadVars, dumpFuncGetName<ShPtr<Variable>>);
+	dump(neverReadVars.getVars(), dumpFuncGetName<ShPtr<Variable>>);
 
 	Log::error() << "  mayBeReadVars:      ";
-	dump(mayBeReadVars, dumpFuncGetName<ShPtr<Variable>>);
+	dump(mayBeReadVars.getVars(), dumpFuncGetName<ShPtr<Variable>>);
 
 	Log::error() << "  alwaysReadVars:     ";
-	dump(alwaysReadVars, dumpFuncGetName<ShPtr<Variable>>);
+	dump(alwaysReadVars.getVars(), dumpFuncGetName<ShPtr<Variable>>);
 
 	Log::error() << "  neverModifiedVars:  ";
-	dump(neverModifiedVars, dumpFuncGetName<ShPtr<Variable>>);
+	dump(neverModifiedVars.getVars(), dumpFuncGetName<ShPtr<Variable>>);
 
 	Log::error() << "  mayBeModifiedVars:  ";
-	dump(mayBeModifiedVars, dumpFuncGetName<ShPtr<Variable>>);
+	dump(mayBeModifiedVars.getVars(), dumpFuncGetName<ShPtr<Variable>>);
 
 	Log::error() << "  alwaysModifiedVars: ";
-	dump(alwaysModifiedVars, dumpFuncGetName<ShPtr<Variable>>);
+	dump(alwaysModifiedVars.getVars(), dumpFuncGetName<ShPtr<Variable>>);
 
 	Log::error() << "  varsWithNeverChangedValue: ";
-	dump(varsWithNeverChangedValue, dumpFuncGetName<ShPtr<Variable>>);
+	dump(varsWithNeverChangedValue.getVars(), dumpFuncGetName<ShPtr<Variable>>);
 
 	Log::error() << "  varsAlwaysModifiedBeforeRead: ";
-	dump(varsAlwaysModifiedBeforeRead, dumpFuncGetName<ShPtr<Variable>>);
+	dump(varsAlwaysModifiedBeforeRead.getVars(), dumpFuncGetName<ShPtr<Variable>>);
 
 	Log::error() << "\n";
 }
 
 bool OptimCallInfo::isNeverRead(ShPtr<Variable> var) const {
-	return hasItem(neverReadVars, var);
+	return neverReadVars.hasVar(var);
 }
 
 bool OptimCallInfo::mayBeRead(ShPtr<Variable> var) const {
-	return hasItem(mayBeReadVars, var);
+	return mayBeReadVars.hasVar(var);
 }
 
 bool OptimCallInfo::isAlwaysRead(ShPtr<Variable> var) const {
-	return hasItem(alwaysReadVars, var);
+	return alwaysReadVars.hasVar(var);
 }
 
 bool OptimCallInfo::isNeverModified(ShPtr<Variable> var) const {
-	return hasItem(neverModifiedVars, var);
+	return neverModifiedVars.hasVar(var);
 }
 
 bool OptimCallInfo::mayBeModified(ShPtr<Variable> var) const {
-	return hasItem(mayBeModifiedVars, var);
+	return mayBeModifiedVars.hasVar(var);
 }
 
 bool OptimCallInfo::isAlwaysModified(ShPtr<Variable> var) const {
-	return hasItem(alwaysModifiedVars, var);
+	return alwaysModifiedVars.hasVar(var);
 }
 
 bool OptimCallInfo::valueIsNeverChanged(ShPtr<Variable> var) const {
-	return hasItem(varsWithNeverChangedValue, var);
+	return varsWithNeverChangedValue.hasVar(var);
 }
 
 bool OptimCallInfo::isAlwaysModifiedBeforeRead(ShPtr<Variable> var) const {
-	return hasItem(varsAlwaysModifiedBeforeRead, var);
+	return varsAlwaysModifiedBeforeRead.hasVar(var);
 }
 
 /**
 * @brief Constructs a new optimistic piece of information about the given
 *        function.
+*
+* Global variables from @a globalVarIndex are stored in bit vectors.
 */
-OptimFuncInfo::OptimFuncInfo(ShPtr<Function> func): FuncInfo(func) {}
+OptimFuncInfo::OptimFuncInfo(ShPtr<Function> func,
+		ShPtr<const VarIndex> globalVarIndex):
+	FuncInfo(func), neverReadVars(globalVarIndex),
+	mayBeReadVars(globalVarIndex), alwaysReadVars(globalVarIndex),
+	neverModifiedVars(globalVarIndex), mayBeModifiedVars(globalVarIndex),
+	alwaysModifiedVars(globalVarIndex),
+	varsWithNeverChangedValue(globalVarIndex),
+	varsAlwaysModifiedBeforeRead(globalVarIndex) {}
 
 /**
 * @brief Emits the info to standard error.
@@ -116,62 +132,62 @@ void OptimFuncInfo::debugPrint() {
 	Log::error() << "[OptimFuncInfo] Debug info for function '" << func->getName() << "':\n";
 
 	Log::error() << "  neverReadVars:      ";
-	dump(neverReadVars, dumpFuncGetName<ShPtr<Variable>>);
+	dump(neverReadVars.getVars(), dumpFuncGetName<ShPtr<Variable>>);
 
 	Log::error() << "  mayBeReadVars:      ";
-	dump(mayBeReadVars, dumpFuncGetName<ShPtr<Variable>>);
+	dump(mayBeReadVars.getVars(), dumpFuncGetName<ShPtr<Variable>>);
 
 	Log::error() << "  alwaysReadVars:     ";
-	dump(alwaysReadVars, dumpFuncGetName<ShPtr<Variable>>);
+	dump(alwaysReadVars.getVars(), dumpFuncGetName<ShPtr<Variable>>);
 
 	Log::error() << "  neverModifiedVars:  ";
-	dump(neverModifiedVars, dumpFuncGetName<ShPtr<Variable>>);
+	dump(neverModifiedVars.getVars(), dumpFuncGetName<ShPtr<Variable>>);
 
 	Log::error() << "  mayBeModifiedVars:  ";
-	dump(mayBeModifiedVars, dumpFuncGetName<ShPtr<Variable>>);
+	dump(mayBeModifiedVars.getVars(), dumpFuncGetName<ShPtr<Variable>>);
 
 	Log::error() << "  alwaysModifiedVars: ";
-	dump(alwaysModifiedVars, dumpFuncGetName<ShPtr<Variable>>);
+	dump(alwaysModifiedVars.getVars(), dumpFuncGetName<ShPtr<Variable>>);
 
 	Log::error() << "  varsWithNeverChangedValue: ";
-	dump(varsWithNeverChangedValue, dumpFuncGetName<ShPtr<Variable>>);
+	dump(varsWithNeverChangedValue.getVars(), dumpFuncGetName<ShPtr<Variable>>);
 
 	Log::error() << "  varsAlwaysModifiedBeforeRead: ";
-	dump(varsAlwaysModifiedBeforeRead, dumpFuncGetName<ShPtr<Variable>>);
+	dump(varsAlwaysModifiedBeforeRead.getVars(), dumpFuncGetName<ShPtr<Variable>>);
 
 	Log::error() << "\n";
 }
 
 bool OptimFuncInfo::isNeverRead(ShPtr<Variable> var) const {
-	return hasItem(neverReadVars, var);
+	return neverReadVars.hasVar(var);
 }
 
 bool OptimFuncInfo::mayBeRead(ShPtr<Variable> var) const {
-	return hasItem(mayBeReadVars, var);
+	return mayBeReadVars.hasVar(var);
 }
 
 bool OptimFuncInfo::isAlwaysRead(ShPtr<Variable> var) const {
-	return hasItem(alwaysReadVars, var);
+	return alwaysReadVars.hasVar(var);
 }
 
 bool OptimFuncInfo::isNeverModified(ShPtr<Variable> var) const {
-	return hasItem(neverModifiedVars, var);
+	return neverModifiedVars.hasVar(var);
 }
 
 bool OptimFuncInfo::mayBeModified(ShPtr<Variable> var) const {
-	return hasItem(mayBeModifiedVars, var);
+	return mayBeModifiedVars.hasVar(var);
 }
 
 bool OptimFuncInfo::isAlwaysModified(ShPtr<Variable> var) const {
-	return hasItem(alwaysModifiedVars, var);
+	return alwaysModifiedVars.hasVar(var);
 }
 
 bool OptimFuncInfo::valueIsNeverChanged(ShPtr<Variable> var) const {
-	return hasItem(varsWithNeverChangedValue, var);
+	return varsWithNeverChangedValue.hasVar(var);
 }
 
 bool OptimFuncInfo::isAlwaysModifiedBeforeRead(ShPtr<Variable> var) const {
-	return hasItem(varsAlwaysModifiedBeforeRead, var);
+	return varsAlwaysModifiedBeforeRead.hasVar(var);
 }
 
 /**
@@ -181,6 +197,28 @@ bool OptimFuncInfo::isAlwaysModifiedBeforeRead(ShPtr<Variable> var) const {
 */
 OptimCallInfoObtainer::OptimCallInfoObtainer(): CallInfoObtainer() {}
 
+/**
+* @brief Creates @c globalVarIndex for the global variables in the module.
+*/
+void OptimCallInfoObtainer::initGlobalVarIndex() {
+	// Functions are also considered to be global variables (they may be
+	// considered as global constants). They are indexed after the global
+	// variables so that moduleGlobalVars is a prefix of the index.
+	VarSet moduleGlobalVarsSet(module->getGlobalVars());
+	VarVector globalVars(moduleGlobalVarsSet.begin(), moduleGlobalVarsSet.end());
+	for (auto i = module->func_begin(), e = module->func_end(); i != e; ++i) {
+		ShPtr<Variable> funcVar((*i)->getAsVar());
+		if (!hasItem(moduleGlobalVarsSet, funcVar)) {
+			globalVars.push_back(funcVar);
+		}
+	}
+
+	globalVarIndex = std::make_shared<VarIndex>(globalVars);
+	moduleGlobalVars.clear();
+	moduleGlobalVars.resize(globalVars.size());
+	moduleGlobalVars.set(0, moduleGlobalVarsSet.size());
+}
+
 /**
 * @brief Computes @c funcInfoMap for each function in the module.
 *
@@ -190,6 +228,14 @@ void OptimCallInfoObtainer::computeAllFuncInfos() {
 	// Obtain the order in which function information should be computed.
 	ShPtr<FuncInfoCompOrder> fico(getFuncInfoCompOrder(cg));
 
+	// For each function that is in an SCC, store the SCC.
+	std::map<ShPtr<Function>, const FuncSet *> funcSCCMap;
+	for (const auto &scc : fico->sccs) {
+		for (const auto &func : scc) {
+			funcSCCMap[func] = &scc;
+		}
+	}
+
 	// Compute the information from the obtained order.
 	for (const auto &func : fico->order) {
 		// Based on the description of CallInfoObtainer::FuncInfoOrder, we
@@ -197,11 +243,9 @@ void OptimCallInfoObtainer::computeAllFuncInfos() {
 		// SCC that contains it.
 		computeFuncInfo(func);
 
-		// For each SCC in the order...
-		for (const auto &scc : fico->sccs) {
-			if (hasItem(scc, func)) {
-				computeFuncInfos(scc);
-			}
+		auto sccIter = funcSCCMap.find(func);
+		if (sccIter != funcSCCMap.end()) {
+			computeFuncInfos(*sccIter->second);
 		}
 	}
 }
@@ -240,14 +284,6 @@ void OptimCallInfoObtainer::computeFuncInfos(const FuncSet &funcs) {
 	} while (hasChanged(oldFuncInfoMap, funcInfoMap));
 }
 
-/**
-* @brief Returns the set of variables that are in both @a vars and @c
-*        globalVars.
-*/
-VarSet OptimCallInfoObtainer::skipLocalVars(const VarSet &vars) {
-	return setIntersection(globalVars, vars);
-}
-
 /**
 * @brief Computes and returns a function info for the given function
 *        declaration.
@@ -257,13 +293,14 @@ VarSet OptimCallInfoObtainer::skipLocalVars(const VarSet &vars) {
 */
 ShPtr<OptimFuncInfo> OptimCallInfoObtainer::computeFuncInfoDeclaration(
 		ShPtr<Function> func) {
-	ShPtr<OptimFuncInfo> funcInfo(ShPtr<OptimFuncInfo>(new OptimFuncInfo(func)));
+	ShPtr<OptimFuncInfo> funcInfo(ShPtr<OptimFuncInfo>(
+		new OptimFuncInfo(func, globalVarIndex)));
 
 	// Use our assumption of global variables (see the class description).
-	funcInfo->neverReadVars = globalVars;
-	funcInfo->neverModifiedVars = globalVars;
-	funcInfo->varsWithNeverChangedValue = globalVars;
-	funcInfo->varsAlwaysModifiedBeforeRead = globalVars;
+	funcInfo->neverReadVars.insertAllIndexedVars();
+	funcInfo->neverModifiedVars.insertAllIndexedVars();
+	funcInfo->varsWithNeverChangedValue.insertAllIndexedVars();
+	funcInfo->varsAlwaysModifiedBeforeRead.insertAllIndexedVars();
 
 	return funcInfo;
 }
@@ -290,7 +327,7 @@ ShPtr<OptimFuncInfo> OptimCallInfoObtainer::computeFuncInfoDefinition(
 */
 ShPtr<OptimCallInfo> OptimCallInfoObtainer::computeCallInfo(ShPtr<CallExpr> call,
 		ShPtr<Function> caller) {
-	ShPtr<OptimCallInfo> callInfo(new OptimCallInfo(call));
+	ShPtr<OptimCallInfo> callInfo(new OptimCallInfo(call, globalVarIndex));
 
 	ShPtr<Variable> calledVar(cast<Variable>(call->getCalledExpr()));
 	ShPtr<Function> calledFunc;
@@ -303,8 +340,8 @@ ShPtr<OptimCallInfo> OptimCallInfoObtainer::computeCallInfo(ShPtr<CallExpr> call
 		// An indirect call may read/change every global variable.
 		// TODO Improve the info by browsing through all defined functions
 		//      and checking which variables they read/modify?
-		callInfo->mayBeReadVars = globalVars;
-		callInfo->mayBeModifiedVars = globalVars;
+		callInfo->mayBeReadVars.insertAllIndexedVars();
+		callInfo->mayBeModifiedVars.insertAllIndexedVars();
 
 		// TODO How to improve the callInfo even more?
 
@@ -329,23 +366,27 @@ ShPtr<OptimCallInfo> OptimCallInfoObtainer::computeCallInfo(ShPtr<CallExpr> call
 	// Then, if we included local variables, we would have that the variable a
 	// is modified in the call func(i - 1), which is not true.
 	ShPtr<OptimFuncInfo> calledFuncInfo(funcInfoMap[calledFunc]);
-	callInfo->neverReadVars = skipLocalVars(calledFuncInfo->neverReadVars);
-	callInfo->mayBeReadVars = skipLocalVars(calledFuncInfo->mayBeReadVars);
-	callInfo->alwaysReadVars = skipLocalVars(calledFuncInfo->alwaysReadVars);
-	callInfo->neverModifiedVars = skipLocalVars(calledFuncInfo->neverModifiedVars);
-	callInfo->mayBeModifiedVars = skipLocalVars(calledFuncInfo->mayBeModifiedVars);
-	callInfo->alwaysModifiedVars = skipLocalVars(calledFuncInfo->alwaysModifiedVars);
-	callInfo->varsWithNeverChangedValue = skipLocalVars(
+	// Since just global variables are indexed, we skip local variables by
+	// copying just the indexed variables.
+	callInfo->neverReadVars.insertIndexedVars(calledFuncInfo->neverReadVars);
+	callInfo->mayBeReadVars.insertIndexedVars(calledFuncInfo->mayBeReadVars);
+	callInfo->alwaysReadVars.insertIndexedVars(calledFuncInfo->alwaysReadVars);
+	callInfo->neverModifiedVars.insertIndexedVars(
+		calledFuncInfo->neverModifiedVars);
+	callInfo->mayBeModifiedVars.insertIndexedVars(
+		calledFuncInfo->mayBeModifiedVars);
+	callInfo->alwaysModifiedVars.insertIndexedVars(
+		calledFuncInfo->alwaysModifiedVars);
+	callInfo->varsWithNeverChangedValue.insertIndexedVars(
 		calledFuncInfo->varsWithNeverChangedValue);
-	callInfo->varsAlwaysModifiedBeforeRead = skipLocalVars(
+	callInfo->varsAlwaysModifiedBeforeRead.insertIndexedVars(
 		calledFuncInfo->varsAlwaysModifiedBeforeRead);
 
 	// We assume that function calls with no arguments don't modify any local
 	// variable from the caller.
 	const ExprVector &args(call->getArgs());
 	if (args.size() == 0) {
-		VarSet callerLocalVars(caller->getLocalVars(true));
-		addToSet(callerLocalVars, callInfo->neverModifiedVars);
+		callInfo->neverModifiedVars.insert(caller->getLocalVars(true));
 	}
 
 	// TODO How to improve the callInfo even more? What about the call's
@@ -366,14 +407,7 @@ void OptimCallInfoObtainer::init(ShPtr<CG> cg, ShPtr<ValueAnalysis> va) {
 	funcInfoMap.clear();
 	callInfoMap.clear();
 
-	// Initialize the set of global variables.
-	globalVars = module->getGlobalVars();
-	// We also add functions to it (they may be considered as global
-	// constants).
-	// For each function in the module...
-	for (auto i = module->func_begin(), e = module->func_end(); i != e; ++i) {
-		globalVars.insert((*i)->getAsVar());
-	}
+	initGlobalVarIndex();
 
 	// When, for example, computing a FuncInfo for function A which calls
 	// function B, it may happen that FuncInfo for B has not yet been computed
@@ -381,7 +415,7 @@ void OptimCallInfoObtainer::init(ShPtr<CG> cg, ShPtr<ValueAnalysis> va) {
 	// FuncInfos here before any computation.
 	// For each function in the module...
 	for (auto i = module->func_begin(), e = module->func_end(); i != e; ++i) {
-		funcInfoMap[*i] = ShPtr<OptimFuncInfo>(new OptimFuncInfo(*i));
+		funcInfoMap[*i] = std::make_shared<OptimFuncInfo>(*i, globalVarIndex);
 	}
 
 	computeAllFuncInfos();
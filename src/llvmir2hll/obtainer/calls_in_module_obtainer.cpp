@@ -5,8 +5,9 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <iterator>
+
 #include "retdec/llvmir2hll/ir/function.h"
-#include "retdec/llvmir2hll/ir/global_var_def.h"
 #include "retdec/llvmir2hll/ir/module.h"
 #include "retdec/llvmir2hll/obtainer/calls_in_module_obtainer.h"
 #include "retdec/llvmir2hll/support/debug.h"
@@ -14,74 +15,108 @@
 namespace retdec {
 namespace llvmir2hll {
 
-/**
-* @brief Constructs a new obtainer.
-*/
-CallsInModuleObtainer::CallsInModuleObtainer(ShPtr<Module> module):
-	OrderedAllVisitor(), module(module), currFunc(), foundCalls() {}
-
 /**
 * @brief Returns a list of all function calls in the given @a module.
 *
+* @param[in] module Module in which the calls are searched.
+* @param[in] filter If non-empty, only calls satisfying it are returned.
+*
 * @par Preconditions
 *  - @a module is non-null
 */
 CallsInModuleObtainer::Calls CallsInModuleObtainer::getCalls(
-		ShPtr<Module> module) {
+		ShPtr<Module> module, Filter filter) {
 	PRECONDITION_NON_NULL(module);
 
-	ShPtr<CallsInModuleObtainer> obtainer(new CallsInModuleObtainer(module));
-	return obtainer->getCallsImpl();
+	ShPtr<Collector> collector(Collector::create(filter));
+	FusedTraversal traversal;
+	traversal.addClient(collector);
+	traversal.run(module);
+	return collector->takeCalls();
 }
 
 /**
-* @brief Implementation of getCalls().
+* @brief Constructs a new collector.
+*
+* See create() for more information.
 */
-CallsInModuleObtainer::Calls CallsInModuleObtainer::getCallsImpl() {
-	obtainCallsInGlobalVars();
-	obtainCallsInFuncs();
-	return foundCalls;
-}
+CallsInModuleObtainer::Collector::Collector(Filter filter):
+	filter(filter), module(), currFunc(), foundCalls(), traversedModule() {}
 
 /**
-* @brief Obtain calls in all global variables and puts them into @c foundCalls.
+* @brief Creates a new collector.
+*
+* @param[in] filter If non-empty, only calls satisfying it are collected.
 */
-void CallsInModuleObtainer::obtainCallsInGlobalVars() {
-	for (auto i = module->global_var_begin(),
-			e = module->global_var_begin(); i != e; ++i) {
-		(*i)->accept(this);
-	}
+ShPtr<CallsInModuleObtainer::Collector> CallsInModuleObtainer::Collector::create(
+		Filter filter) {
+	return ShPtr<Collector>(new Collector(filter));
 }
 
 /**
-* @brief Obtain calls in all functions and puts them into @c foundCalls.
+* @brief Returns @c true if all calls in @a module have been collected and
+*        not taken yet, @c false otherwise.
 */
-void CallsInModuleObtainer::obtainCallsInFuncs() {
-	for (auto i = module->func_definition_begin(),
-			e = module->func_definition_end(); i != e; ++i) {
-		obtainCallsInFunc(*i);
-	}
+bool CallsInModuleObtainer::Collector::hasCallsFrom(
+		ShPtr<Module> module) const {
+	return module && traversedModule == module;
 }
 
 /**
-* @brief Obtain calls in all the given function and puts them into @c
-*        foundCalls.
+* @brief Returns the collected calls and forgets them.
 */
-void CallsInModuleObtainer::obtainCallsInFunc(ShPtr<Function> func) {
+CallsInModuleObtainer::Calls CallsInModuleObtainer::Collector::takeCalls() {
+	Calls calls;
+	calls.swap(foundCalls);
+	traversedModule.reset();
+	return calls;
+}
+
+void CallsInModuleObtainer::Collector::startModule(ShPtr<Module> module) {
+	this->module = module;
+	foundCalls.clear();
+	traversedModule.reset();
+}
+
+void CallsInModuleObtainer::Collector::startFunc(ShPtr<Function> func) {
 	currFunc = func;
-	func->accept(this);
 }
 
-void CallsInModuleObtainer::visit(ShPtr<CallExpr> expr) {
+void CallsInModuleObtainer::Collector::endFunc(ShPtr<Function> func) {
+	currFunc.reset();
+}
+
+void CallsInModuleObtainer::Collector::endModule(ShPtr<Module> module) {
+	traversedModule = module;
+	this->module.reset();
+}
+
+ShPtr<FusedTraversal::Client>
+		CallsInModuleObtainer::Collector::createEmptyCopy() const {
+	return create(filter);
+}
+
+void CallsInModuleObtainer::Collector::mergeCopy(FusedTraversal::Client &copy) {
+	auto &collectorCopy = static_cast<Collector &>(copy);
+	foundCalls.insert(foundCalls.end(),
+		std::make_move_iterator(collectorCopy.foundCalls.begin()),
+		std::make_move_iterator(collectorCopy.foundCalls.end()));
+	collectorCopy.foundCalls.clear();
+}
+
+void CallsInModuleObtainer::Collector::visit(ShPtr<CallExpr> expr) {
+	// Calls outside of functions are not part of any statement.
+	if (!currFunc || (filter && !filter(expr, module))) {
+		return;
+	}
+
 	CallInfo ci = {
-		expr,     // call
-		lastStmt, // stmt
-		currFunc, // func
-		module    // module
+		expr,             // call
+		getCurrentStmt(), // stmt
+		currFunc,         // func
+		module            // module
 	};
 	foundCalls.push_back(ci);
-
-	OrderedAllVisitor::visit(expr);
 }
 
 } // namespace llvmir2hll
@@ -46,6 +46,7 @@
 #include "retdec/llvmir2hll/optimizer/optimizers/while_true_to_while_cond_optimizer.h"
 #include "retdec/llvmir2hll/support/debug.h"
 #include "retdec/utils/container.h"
+#include "retdec/utils/profiler.h"
 #include "retdec/utils/string.h"
 #include "retdec/utils/system.h"
 #include "retdec/utils/io/log.h"
@@ -278,6 +279,7 @@ void OptimizerManager::runOptimizerProvidedItShouldBeRun(ShPtr<Optimizer> optimi
 	}
 
 	printOptimization(OPT_ID);
+	utils::ProfileScope scope("llvmir2hll/optimizations/" + OPT_ID);
 
 	if (recoverFromOutOfMemory) {
 		// Some optimizations, most notable CopyPropagation, may run out of
@@ -308,7 +310,8 @@ void OptimizerManager::runOptimizerProvidedItShouldBeRun(ShPtr<Optimizer> optimi
 */
 void OptimizerManager::printOptimization(const std::string &optId) const {
 	if (enableDebug) {
-		Log::phase("running "s + optId + OPT_SUFFIX, Log::SubPhase);
+		RETDEC_LOG_INFO << Log::SubPhase << "running " << optId
+			<< OPT_SUFFIX << Log::ElapsedTime << std::endl;
 	}
 }
 
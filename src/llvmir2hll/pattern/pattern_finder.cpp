@@ -31,5 +31,19 @@ PatternFinder::PatternFinder(ShPtr<ValueAnalysis> va,
 	PRECONDITION(cio->isInitialized(), "it is not initialized");
 }
 
+/**
+* @brief Returns a client gathering data needed by findPatterns().
+*
+* If a client is returned, PatternFinderRunner adds it to a traversal shared
+* by all the run finders, and findPatterns() may use the gathered data instead
+* of traversing the module by itself. findPatterns() has to work even if the
+* client has not been run.
+*
+* By default, it returns the null pointer.
+*/
+ShPtr<FusedTraversal::Client> PatternFinder::getFusedTraversalClient() const {
+	return ShPtr<FusedTraversal::Client>();
+}
+
 } // namespace llvmir2hll
 } // namespace retdec
@@ -16,13 +16,25 @@ namespace llvmir2hll {
 * @param[in] pfs Pattern finders to be run.
 * @param[in] module The module that is passed to the finders in @a pfs.
 *
-* More specifically, it calls <tt>run(pf, module)</tt> on every pattern finder
-* @c pf in @a pfs.
+* More specifically, it first traverses @a module once and lets the clients
+* of all finders (see PatternFinder::getFusedTraversalClient()) gather their
+* data. Then, it calls <tt>run(pf, module)</tt> on every pattern finder @c pf
+* in @a pfs.
 *
 * @par Preconditions
 *  - @a module is non-null
 */
 void PatternFinderRunner::run(const PatternFinders &pfs, ShPtr<Module> module) {
+	PRECONDITION_NON_NULL(module);
+
+	FusedTraversal traversal;
+	for (const auto &pf : pfs) {
+		if (auto client = pf->getFusedTraversalClient()) {
+			traversal.addClient(client);
+		}
+	}
+	traversal.run(module, true);
+
 	for (const auto &pf : pfs) {
 		run(pf, module);
 	}
@@ -138,17 +138,12 @@ using Calls = CallsInModuleObtainer::Calls;
 using Patterns = PatternFinder::Patterns;
 
 /**
-* @brief Returns the list of API calls in given list of calls.
+* @brief Returns @c true if @a call is a call of an interesting function, @c
+*        false otherwise.
 */
-Calls getAPICalls(const Calls &calls) {
-	Calls apiCalls;
-	for (const auto &call : calls) {
-		ShPtr<Variable> funcVar(cast<Variable>(call.call->getCalledExpr()));
-		if (funcVar && hasItem(API_CALL_FUNC_NAMES, funcVar->getName())) {
-			apiCalls.push_back(call);
-		}
-	}
-	return apiCalls;
+bool isAPICall(ShPtr<CallExpr> call, ShPtr<Module> module) {
+	ShPtr<Variable> funcVar(cast<Variable>(call->getCalledExpr()));
+	return funcVar && hasItem(API_CALL_FUNC_NAMES, funcVar->getName());
 }
 
 /**
@@ -171,7 +166,8 @@ Patterns makePatterns(const Calls &apiCalls) {
 */
 APICallPatternFinder::APICallPatternFinder(
 	ShPtr<ValueAnalysis> va, ShPtr<CallInfoObtainer> cio):
-		PatternFinder(va, cio) {}
+		PatternFinder(va, cio),
+		apiCallsCollector(CallsInModuleObtainer::Collector::create(isAPICall)) {}
 
 /**
 * @brief Creates and returns a new instance of APICallPatternFinder.
@@ -195,10 +191,19 @@ const std::string APICallPatternFinder::getId() const {
 */
 PatternFinder::Patterns APICallPatternFinder::findPatterns(
 		ShPtr<Module> module) {
-	Calls allCalls(CallsInModuleObtainer::getCalls(module));
-	Calls apiCalls(getAPICalls(allCalls));
+	Calls apiCalls(apiCallsCollector->hasCallsFrom(module) ?
+		apiCallsCollector->takeCalls() :
+		CallsInModuleObtainer::getCalls(module, isAPICall));
 	return makePatterns(apiCalls);
 }
 
+/**
+* @brief Returns a client collecting calls of interesting functions.
+*/
+ShPtr<FusedTraversal::Client> APICallPatternFinder::getFusedTraversalClient()
+		const {
+	return apiCallsCollector;
+}
+
 } // namespace llvmir2hll
 } // namespace retdec
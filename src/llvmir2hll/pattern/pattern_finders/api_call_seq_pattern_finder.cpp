@@ -1092,6 +1092,16 @@ const APICallInfoSeqMap &initAPICallInfoSeqMap() {
 /// that begin with that function.
 const APICallInfoSeqMap &API_CALL_INFO_SEQ_MAP(initAPICallInfoSeqMap());
 
+/**
+* @brief Returns @c true if @a call is a call of a function that begins a
+*        sequence in API_CALL_INFO_SEQ_MAP, @c false otherwise.
+*/
+bool beginsAPICallSeq(ShPtr<CallExpr> call, ShPtr<Module> module) {
+	std::string calledFuncName(getNameOfCalledFunc(call, module));
+	return !calledFuncName.empty() &&
+		API_CALL_INFO_SEQ_MAP.find(calledFuncName) != API_CALL_INFO_SEQ_MAP.end();
+}
+
 } // anonymous namespace
 
 /**
@@ -1101,7 +1111,9 @@ const APICallInfoSeqMap &API_CALL_INFO_SEQ_MAP(initAPICallInfoSeqMap());
 */
 APICallSeqPatternFinder::APICallSeqPatternFinder(
 	ShPtr<ValueAnalysis> va, ShPtr<CallInfoObtainer> cio):
-		PatternFinder(va, cio), foundPatterns() {}
+		PatternFinder(va, cio), foundPatterns(),
+		callsCollector(CallsInModuleObtainer::Collector::create(
+			beginsAPICallSeq)) {}
 
 /**
 * @brief Creates and returns a new instance of APICallSeqPatternFinder.
@@ -1129,12 +1141,15 @@ PatternFinder::Patterns APICallSeqPatternFinder::findPatterns(
 	//      function.
 	ShPtr<APICallSeqFinder> acf(new BasicBlockAPICallSeqFinder(va, cio));
 
-	// For every call in the module...
-	for (const auto &call : CallsInModuleObtainer::getCalls(module)) {
+	// The calls may have already been collected during a traversal shared
+	// with other pattern finders.
+	CallsInModuleObtainer::Calls calls(callsCollector->hasCallsFrom(module) ?
+		callsCollector->takeCalls() :
+		CallsInModuleObtainer::getCalls(module, beginsAPICallSeq));
+
+	// For every call that begins a sequence...
+	for (const auto &call : calls) {
 		std::string calledFuncName(getNameOfCalledFunc(call.call, module));
-		if (calledFuncName.empty()) {
-			continue;
-		}
 
 		// For every matching APICallInfoSeq...
 		auto foundInfos = API_CALL_INFO_SEQ_MAP.equal_range(calledFuncName);
@@ -1150,5 +1165,16 @@ PatternFinder::Patterns APICallSeqPatternFinder::findPatterns(
 	return foundPatterns;
 }
 
+/**
+* @brief Returns a client collecting calls that begin a sequence of API calls.
+*
+* Only the calls are collected during the traversal; the sequences are
+* searched for in findPatterns().
+*/
+ShPtr<FusedTraversal::Client> APICallSeqPatternFinder::getFusedTraversalClient()
+		const {
+	return callsCollector;
+}
+
 } // namespace llvmir2hll
 } // namespace retdec
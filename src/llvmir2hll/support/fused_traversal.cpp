@@ -0,0 +1,367 @@
+/**
+* @file src/llvmir2hll/support/fused_traversal.cpp
+* @brief Implementation of FusedTraversal.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <map>
+#include <mutex>
+
+#include "retdec/llvmir2hll/ir/assign_stmt.h"
+#include "retdec/llvmir2hll/ir/break_stmt.h"
+#include "retdec/llvmir2hll/ir/call_stmt.h"
+#include "retdec/llvmir2hll/ir/continue_stmt.h"
+#include "retdec/llvmir2hll/ir/empty_stmt.h"
+#include "retdec/llvmir2hll/ir/for_loop_stmt.h"
+#include "retdec/llvmir2hll/ir/function.h"
+#include "retdec/llvmir2hll/ir/global_var_def.h"
+#include "retdec/llvmir2hll/ir/goto_stmt.h"
+#include "retdec/llvmir2hll/ir/if_stmt.h"
+#include "retdec/llvmir2hll/ir/module.h"
+#include "retdec/llvmir2hll/ir/return_stmt.h"
+#include "retdec/llvmir2hll/ir/switch_stmt.h"
+#include "retdec/llvmir2hll/ir/ufor_loop_stmt.h"
+#include "retdec/llvmir2hll/ir/unreachable_stmt.h"
+#include "retdec/llvmir2hll/ir/var_def_stmt.h"
+#include "retdec/llvmir2hll/ir/while_loop_stmt.h"
+#include "retdec/llvmir2hll/support/debug.h"
+#include "retdec/llvmir2hll/support/fused_traversal.h"
+#include "retdec/llvmir2hll/support/visitors/ordered_all_visitor.h"
+#include "retdec/utils/thread_pool.h"
+
+namespace retdec {
+namespace llvmir2hll {
+
+/**
+* @brief Traverses the module and notifies clients about the visited nodes.
+*
+* A client is notified about a node before the children of the node are
+* traversed. When a client is notified about a statement, the statement is
+* already the current statement.
+*/
+class FusedTraversal::FusedVisitor: private OrderedAllVisitor {
+public:
+	explicit FusedVisitor(const Clients &clients): clients(clients) {
+		for (const auto &client : clients) {
+			client->currStmt = &lastStmt;
+		}
+	}
+
+	~FusedVisitor() {
+		for (const auto &client : clients) {
+			client->currStmt = nullptr;
+		}
+	}
+
+	void traverseGlobalVar(ShPtr<GlobalVarDef> varDef) {
+		lastStmt.reset();
+		varDef->accept(this);
+	}
+
+	void traverseFunc(ShPtr<Function> func) {
+		// Statements of different functions never overlap, so keep only the
+		// statements of the traversed function to keep the set small.
+		restart();
+		lastStmt.reset();
+		for (const auto &client : clients) {
+			client->startFunc(func);
+		}
+		func->accept(this);
+		for (const auto &client : clients) {
+			client->endFunc(func);
+		}
+	}
+
+private:
+	/// @name Visitor Interface
+	/// @{
+	#define FORWARD_VISIT(TYPE) \
+		virtual void visit(ShPtr<TYPE> node) override { \
+			for (const auto &client : clients) { \
+				client->visit(node); \
+			} \
+			OrderedAllVisitor::visit(node); \
+		}
+	#define FORWARD_VISIT_STMT(TYPE) \
+		virtual void visit(ShPtr<TYPE> stmt) override { \
+			lastStmt = stmt; \
+			for (const auto &client : clients) { \
+				client->visit(stmt); \
+			} \
+			OrderedAllVisitor::visit(stmt); \
+		}
+
+	FORWARD_VISIT(GlobalVarDef)
+	FORWARD_VISIT(Function)
+	// Statements
+	FORWARD_VISIT_STMT(AssignStmt)
+	FORWARD_VISIT_STMT(BreakStmt)
+	FORWARD_VISIT_STMT(CallStmt)
+	FORWARD_VISIT_STMT(ContinueStmt)
+	FORWARD_VISIT_STMT(EmptyStmt)
+	FORWARD_VISIT_STMT(ForLoopStmt)
+	FORWARD_VISIT_STMT(UForLoopStmt)
+	FORWARD_VISIT_STMT(GotoStmt)
+	FORWARD_VISIT_STMT(IfStmt)
+	FORWARD_VISIT_STMT(ReturnStmt)
+	FORWARD_VISIT_STMT(SwitchStmt)
+	FORWARD_VISIT_STMT(UnreachableStmt)
+	FORWARD_VISIT_STMT(VarDefStmt)
+	FORWARD_VISIT_STMT(WhileLoopStmt)
+	// Expressions
+	FORWARD_VISIT(AddOpExpr)
+	FORWARD_VISIT(AddressOpExpr)
+	FORWARD_VISIT(AndOpExpr)
+	FORWARD_VISIT(ArrayIndexOpExpr)
+	FORWARD_VISIT(AssignOpExpr)
+	FORWARD_VISIT(BitAndOpExpr)
+	FORWARD_VISIT(BitOrOpExpr)
+	FORWARD_VISIT(BitShlOpExpr)
+	FORWARD_VISIT(BitShrOpExpr)
+	FORWARD_VISIT(BitXorOpExpr)
+	FORWARD_VISIT(CallExpr)
+	FORWARD_VISIT(CommaOpExpr)
+	FORWARD_VISIT(DerefOpExpr)
+	FORWARD_VISIT(DivOpExpr)
+	FORWARD_VISIT(EqOpExpr)
+	FORWARD_VISIT(GtEqOpExpr)
+	FORWARD_VISIT(GtOpExpr)
+	FORWARD_VISIT(LtEqOpExpr)
+	FORWARD_VISIT(LtOpExpr)
+	FORWARD_VISIT(ModOpExpr)
+	FORWARD_VISIT(MulOpExpr)
+	FORWARD_VISIT(NegOpExpr)
+	FORWARD_VISIT(NeqOpExpr)
+	FORWARD_VISIT(NotOpExpr)
+	FORWARD_VISIT(OrOpExpr)
+	FORWARD_VISIT(StructIndexOpExpr)
+	FORWARD_VISIT(SubOpExpr)
+	FORWARD_VISIT(TernaryOpExpr)
+	FORWARD_VISIT(Variable)
+	// Casts
+	FORWARD_VISIT(BitCastExpr)
+	FORWARD_VISIT(ExtCastExpr)
+	FORWARD_VISIT(FPToIntCastExpr)
+	FORWARD_VISIT(IntToFPCastExpr)
+	FORWARD_VISIT(IntToPtrCastExpr)
+	FORWARD_VISIT(PtrToIntCastExpr)
+	FORWARD_VISIT(TruncCastExpr)
+	// Constants
+	FORWARD_VISIT(ConstArray)
+	FORWARD_VISIT(ConstBool)
+	FORWARD_VISIT(ConstFloat)
+	FORWARD_VISIT(ConstInt)
+	FORWARD_VISIT(ConstNullPointer)
+	FORWARD_VISIT(ConstString)
+	FORWARD_VISIT(ConstStruct)
+	FORWARD_VISIT(ConstSymbol)
+	// Types
+	FORWARD_VISIT(ArrayType)
+	FORWARD_VISIT(FloatType)
+	FORWARD_VISIT(IntType)
+	FORWARD_VISIT(PointerType)
+	FORWARD_VISIT(StringType)
+	FORWARD_VISIT(StructType)
+	FORWARD_VISIT(FunctionType)
+	FORWARD_VISIT(VoidType)
+	FORWARD_VISIT(UnknownType)
+
+	#undef FORWARD_VISIT_STMT
+	#undef FORWARD_VISIT
+	/// @}
+
+private:
+	/// Clients to be notified.
+	const Clients &clients;
+};
+
+/**
+* @brief Constructs a new traversal without clients.
+*/
+FusedTraversal::FusedTraversal(): clients() {}
+
+/**
+* @brief Adds @a client to the clients notified by the traversal.
+*
+* Clients are notified in the order in which they were added.
+*
+* @par Preconditions
+*  - @a client is non-null
+*/
+void FusedTraversal::addClient(ShPtr<Client> client) {
+	PRECONDITION_NON_NULL(client);
+
+	clients.push_back(client);
+}
+
+/**
+* @brief Returns all the added clients.
+*/
+const FusedTraversal::Clients &FusedTraversal::getClients() const {
+	return clients;
+}
+
+/**
+* @brief Returns @c true if all clients support a parallel traversal, @c false
+*        otherwise.
+*/
+bool FusedTraversal::canRunInParallel() const {
+	for (const auto &client : clients) {
+		if (!client->createEmptyCopy()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+* @brief Traverses @a module and notifies all clients.
+*
+* @param[in] module Module to be traversed.
+* @param[in] parallel If @c true and all clients support it, functions are
+*                     traversed in parallel.
+*
+* Before the traversal, Client::startModule() is called on every client.
+* After it, Client::endModule() is called on every client.
+*
+* @par Preconditions
+*  - @a module is non-null
+*/
+void FusedTraversal::run(ShPtr<Module> module, bool parallel) {
+	PRECONDITION_NON_NULL(module);
+
+	if (clients.empty()) {
+		return;
+	}
+
+	for (const auto &client : clients) {
+		client->startModule(module);
+	}
+
+	{
+		FusedVisitor visitor(clients);
+		for (auto i = module->global_var_begin(),
+				e = module->global_var_end(); i != e; ++i) {
+			visitor.traverseGlobalVar(*i);
+		}
+	}
+
+	if (parallel && canRunInParallel()) {
+		runInParallel(module);
+	} else {
+		runSerially(module);
+	}
+
+	for (const auto &client : clients) {
+		client->endModule(module);
+	}
+}
+
+/**
+* @brief Traverses all functions in @a module one after another.
+*/
+void FusedTraversal::runSerially(ShPtr<Module> module) {
+	FusedVisitor visitor(clients);
+	for (auto i = module->func_definition_begin(),
+			e = module->func_definition_end(); i != e; ++i) {
+		visitor.traverseFunc(*i);
+	}
+}
+
+/**
+* @brief Traverses chunks of functions in @a module in parallel.
+*
+* Every chunk is traversed by fresh copies of the clients. When all chunks are
+* done, the copies are merged into the clients in the order of the chunks.
+*/
+void FusedTraversal::runInParallel(ShPtr<Module> module) {
+	std::vector<ShPtr<Function>> funcs(module->func_definition_begin(),
+		module->func_definition_end());
+
+	std::mutex mutex;
+	std::map<std::size_t, Clients> copiesOfChunks;
+	retdec::utils::parallelForRanges(0, funcs.size(),
+		[&](std::size_t begin, std::size_t end) {
+			Clients copies;
+			copies.reserve(clients.size());
+			for (const auto &client : clients) {
+				copies.push_back(client->createEmptyCopy());
+				copies.back()->startModule(module);
+			}
+
+			FusedVisitor visitor(copies);
+			for (auto i = begin; i < end; ++i) {
+				visitor.traverseFunc(funcs[i]);
+			}
+
+			std::lock_guard<std::mutex> lock(mutex);
+			copiesOfChunks.emplace(begin, std::move(copies));
+		}
+	);
+
+	for (auto &chunk : copiesOfChunks) {
+		for (std::size_t i = 0; i < clients.size(); ++i) {
+			clients[i]->mergeCopy(*chunk.second[i]);
+		}
+	}
+}
+
+/**
+* @brief Constructs a new client.
+*/
+FusedTraversal::Client::Client(): currStmt(nullptr) {}
+
+/**
+* @brief Called before the traversal of @a module starts.
+*
+* It is also called on every copy of the client before the copy is used.
+*/
+void FusedTraversal::Client::startModule(ShPtr<Module> module) {}
+
+/**
+* @brief Called before @a func is traversed.
+*/
+void FusedTraversal::Client::startFunc(ShPtr<Function> func) {}
+
+/**
+* @brief Called after @a func has been traversed.
+*/
+void FusedTraversal::Client::endFunc(ShPtr<Function> func) {}
+
+/**
+* @brief Called after the whole @a module has been traversed and all copies
+*        have been merged.
+*/
+void FusedTraversal::Client::endModule(ShPtr<Module> module) {}
+
+/**
+* @brief Returns a new client of the same kind without any gathered data.
+*
+* Returns the null pointer if the client does not support a parallel traversal
+* (the default).
+*/
+ShPtr<FusedTraversal::Client> FusedTraversal::Client::createEmptyCopy() const {
+	return ShPtr<Client>();
+}
+
+/**
+* @brief Adds data gathered by @a copy (created by createEmptyCopy()) to this
+*        client.
+*
+* Copies are merged in the order of the functions they have traversed.
+*/
+void FusedTraversal::Client::mergeCopy(Client &copy) {}
+
+/**
+* @brief Returns the statement that has been entered by the traversal as the
+*        last one.
+*
+* It has the same meaning as @c lastStmt in OrderedAllVisitor. Outside of
+* functions, the null pointer is returned.
+*/
+ShPtr<Statement> FusedTraversal::Client::getCurrentStmt() const {
+	return currStmt ? *currStmt : ShPtr<Statement>();
+}
+
+} // namespace llvmir2hll
+} // namespace retdec
@@ -0,0 +1,222 @@
+/**
+* @file src/llvmir2hll/support/indexed_var_set.cpp
+* @brief Implementation of IndexedVarSet.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include "retdec/llvmir2hll/support/debug.h"
+#include "retdec/llvmir2hll/support/indexed_var_set.h"
+
+namespace retdec {
+namespace llvmir2hll {
+
+const std::size_t VarIndex::NO_INDEX = static_cast<std::size_t>(-1);
+
+/**
+* @brief Constructs an index of the given variables.
+*
+* @par Preconditions
+*  - @a vars does not contain duplicates
+*/
+VarIndex::VarIndex(const VarVector &vars): vars(vars), indexes() {
+	indexes.reserve(vars.size());
+	for (std::size_t i = 0, e = vars.size(); i < e; ++i) {
+		indexes.emplace(vars[i], i);
+	}
+	PRECONDITION(indexes.size() == vars.size(),
+		"the indexed variables contain duplicates");
+}
+
+/**
+* @brief Returns the number of indexed variables.
+*/
+std::size_t VarIndex::size() const {
+	return vars.size();
+}
+
+/**
+* @brief Returns @c true if @a var is indexed, @c false otherwise.
+*/
+bool VarIndex::hasVar(ShPtr<Variable> var) const {
+	return indexes.find(var) != indexes.end();
+}
+
+/**
+* @brief Returns the index of @a var.
+*
+* If @a var is not indexed, it returns @c NO_INDEX.
+*/
+std::size_t VarIndex::getIndex(ShPtr<Variable> var) const {
+	auto i = indexes.find(var);
+	return i != indexes.end() ? i->second : NO_INDEX;
+}
+
+/**
+* @brief Returns the variable with the given index.
+*
+* @par Preconditions
+*  - <tt>index < size()</tt>
+*/
+ShPtr<Variable> VarIndex::getVar(std::size_t index) const {
+	PRECONDITION(index < vars.size(), "index " << index << " is out of range");
+
+	return vars[index];
+}
+
+/**
+* @brief Returns all indexed variables in the order of their indexes.
+*/
+const VarVector &VarIndex::getVars() const {
+	return vars;
+}
+
+/**
+* @brief Constructs an empty set without an index.
+*
+* All variables inserted into such a set are stored in an ordinary set.
+*/
+IndexedVarSet::IndexedVarSet(): index(), indexedVars(), otherVars() {}
+
+/**
+* @brief Constructs an empty set storing variables from @a index as bits.
+*/
+IndexedVarSet::IndexedVarSet(ShPtr<const VarIndex> index):
+	index(index), indexedVars(index ? index->size() : 0), otherVars() {}
+
+/**
+* @brief Returns @c true if this set contains the same variables as @a other,
+*        @c false otherwise.
+*
+* Both sets are expected to use the same index.
+*/
+bool IndexedVarSet::operator==(const IndexedVarSet &other) const {
+	return indexedVars == other.indexedVars && otherVars == other.otherVars;
+}
+
+/**
+* @brief Returns @c true if this set differs from @a other, @c false
+*        otherwise.
+*/
+bool IndexedVarSet::operator!=(const IndexedVarSet &other) const {
+	return !(*this == other);
+}
+
+/**
+* @brief Returns @c true if @a var is in the set, @c false otherwise.
+*/
+bool IndexedVarSet::hasVar(ShPtr<Variable> var) const {
+	std::size_t i = index ? index->getIndex(var) : VarIndex::NO_INDEX;
+	if (i != VarIndex::NO_INDEX) {
+		return indexedVars.test(i);
+	}
+	return otherVars.find(var) != otherVars.end();
+}
+
+/**
+* @brief Returns @c true if the set is empty, @c false otherwise.
+*/
+bool IndexedVarSet::empty() const {
+	return indexedVars.none() && otherVars.empty();
+}
+
+/**
+* @brief Returns all variables in the set.
+*
+* The returned set is constructed on every call, so this function should not
+* be used in performance-critical code.
+*/
+VarSet IndexedVarSet::getVars() const {
+	VarSet vars(otherVars);
+	for (auto i : indexedVars.set_bits()) {
+		vars.insert(index->getVar(i));
+	}
+	return vars;
+}
+
+/**
+* @brief Returns the indexed variables in the set as a bit vector.
+*/
+const llvm::BitVector &IndexedVarSet::getIndexedVars() const {
+	return indexedVars;
+}
+
+/**
+* @brief Returns the variables in the set that are not indexed.
+*/
+const VarSet &IndexedVarSet::getOtherVars() const {
+	return otherVars;
+}
+
+/**
+* @brief Inserts @a var into the set.
+*/
+void IndexedVarSet::insert(ShPtr<Variable> var) {
+	std::size_t i = index ? index->getIndex(var) : VarIndex::NO_INDEX;
+	if (i != VarIndex::NO_INDEX) {
+		indexedVars.set(i);
+	} else {
+		otherVars.insert(var);
+	}
+}
+
+/**
+* @brief Inserts all variables from @a vars into the set.
+*/
+void IndexedVarSet::insert(const VarSet &vars) {
+	for (const auto &var : vars) {
+		insert(var);
+	}
+}
+
+/**
+* @brief Inserts all variables from @a vars into the set.
+*
+* @par Preconditions
+*  - @a vars uses the same index as this set
+*/
+void IndexedVarSet::insert(const IndexedVarSet &vars) {
+	insertIndexedVars(vars);
+	otherVars.insert(vars.otherVars.begin(), vars.otherVars.end());
+}
+
+/**
+* @brief Inserts just the indexed variables from @a vars into the set.
+*
+* @par Preconditions
+*  - @a vars uses the same index as this set
+*/
+void IndexedVarSet::insertIndexedVars(const IndexedVarSet &vars) {
+	insertIndexedVars(vars.indexedVars);
+}
+
+/**
+* @brief Inserts the indexed variables whose bits are set in @a vars into the
+*        set.
+*
+* @par Preconditions
+*  - the size of @a vars is the same as the size of the used index
+*/
+void IndexedVarSet::insertIndexedVars(const llvm::BitVector &vars) {
+	PRECONDITION(vars.size() == indexedVars.size(),
+		"the bit vector does not correspond to the used index");
+
+	indexedVars |= vars;
+}
+
+/**
+* @brief Inserts all indexed variables into the set.
+*/
+void IndexedVarSet::insertAllIndexedVars() {
+	indexedVars.set();
+}
+
+/**
+* @brief Removes all variables from the set.
+*/
+void IndexedVarSet::clear() {
+	indexedVars.reset();
+	otherVars.clear();
+}
+
+} // namespace llvmir2hll
+} // namespace retdec
@@ -5,11 +5,10 @@
 */
 
 #include "retdec/llvmir2hll/ir/function.h"
-#include "retdec/llvmir2hll/ir/global_var_def.h"
 #include "retdec/llvmir2hll/ir/module.h"
-#include "retdec/llvmir2hll/ir/variable.h"
 #include "retdec/llvmir2hll/support/debug.h"
 #include "retdec/llvmir2hll/validator/validator.h"
+#include "retdec/llvmir2hll/validator/validator_factory.h"
 
 namespace retdec {
 namespace llvmir2hll {
@@ -17,7 +16,8 @@ namespace llvmir2hll {
 /**
 * @brief Constructs a new validator.
 */
-Validator::Validator(): module(), func(), moduleIsCorrect(true) {}
+Validator::Validator(): module(), func(), printMessageOnError(false),
+	moduleIsCorrect(true), warningMessages() {}
 
 /**
 * @brief Validates the given module.
@@ -32,57 +32,97 @@ Validator::Validator(): module(), func(), moduleIsCorrect(true) {}
 * there are multiple errors and @a printMessageOnError is @c true, it prints a
 * warning message for each of these errors.
 *
+* To run several validators, use validateAll(), which traverses the module
+* only once.
+*
 * @par Preconditions
 *  - @a module is non-null
 */
 bool Validator::validate(ShPtr<Module> module, bool printMessageOnError) {
 	PRECONDITION_NON_NULL(module);
 
-	this->module = module;
-	this->printMessageOnError = printMessageOnError;
-	this->moduleIsCorrect = true;
+	// The validator is owned by the caller, so it must not be deleted by the
+	// traversal.
+	ShPtr<Validator> thisValidator(this, [](Validator *) {});
+	return validateAll({thisValidator}, module, printMessageOnError);
+}
+
+/**
+* @brief Validates the given module by all the given validators at once.
+*
+* @param[in] validators Validators to be run.
+* @param[in] module Module to be validated.
+* @param[in] printMessageOnError If @c true and the module is not valid, it
+*                                prints a warning message to standard error.
+* @param[in] parallel If @c true, functions are validated in parallel.
+*
+* @return @c true if the module is correct according to all validators, @c
+*         false otherwise.
+*
+* The module is traversed only once, no matter how many validators are given.
+* Warning messages are printed in the order of the validators, and the
+* messages of a single validator in the order of functions in the module.
+*
+* @par Preconditions
+*  - @a module is non-null
+*/
+bool Validator::validateAll(const Validators &validators,
+		ShPtr<Module> module, bool printMessageOnError, bool parallel) {
+	PRECONDITION_NON_NULL(module);
 
-	runValidation();
+	FusedTraversal traversal;
+	for (const auto &validator : validators) {
+		validator->printMessageOnError = printMessageOnError;
+		traversal.addClient(validator);
+	}
+	traversal.run(module, parallel);
 
+	bool moduleIsCorrect = true;
+	for (const auto &validator : validators) {
+		moduleIsCorrect &= validator->moduleIsCorrect;
+	}
 	return moduleIsCorrect;
 }
 
-/**
-* @brief Traverses all global variables in the current module and calls @c
-*        accept() on every one of them.
-*/
-void Validator::traverseAllGlobalVariables() {
-	for (auto i = module->global_var_begin(),
-			e = module->global_var_end(); i != e; ++i) {
-		(*i)->accept(this);
+void Validator::startModule(ShPtr<Module> module) {
+	this->module = module;
+	this->func.reset();
+	this->moduleIsCorrect = true;
+	this->warningMessages.clear();
+}
+
+void Validator::startFunc(ShPtr<Function> func) {
+	this->func = func;
+}
+
+void Validator::endModule(ShPtr<Module> module) {
+	for (const auto &warningMessage : warningMessages) {
+		Log::error() << Log::Warning << warningMessage << std::endl;
 	}
+	warningMessages.clear();
+	this->func.reset();
 }
 
 /**
-* @brief Traverses all functions in the current module and calls @c accept() on
-*        every one of them.
+* @brief Creates an empty copy of the validator by ValidatorFactory.
 *
-* Furthermore, before traversing a function, it sets the data member @c func to
-* the traversed function.
+* If the validator is not registered at the factory, the null pointer is
+* returned, so the module is then validated serially.
 */
-void Validator::traverseAllFunctions() {
-	for (auto i = module->func_definition_begin(),
-			e = module->func_definition_end(); i != e; ++i) {
-		func = *i;
-		func->accept(this);
+ShPtr<FusedTraversal::Client> Validator::createEmptyCopy() const {
+	ShPtr<Validator> copy(ValidatorFactory::getInstance().createObject(getId()));
+	if (copy) {
+		copy->printMessageOnError = printMessageOnError;
 	}
+	return copy;
 }
 
-/**
-* @brief Runs the validation over the module.
-*
-* By default, this function calls traverseAllGlobalVariables() and
-* traverseAllFunctions(). If you want to do anything else, redefine this member
-* function.
-*/
-void Validator::runValidation() {
-	traverseAllGlobalVariables();
-	traverseAllFunctions();
+void Validator::mergeCopy(FusedTraversal::Client &copy) {
+	auto &validatorCopy = static_cast<Validator &>(copy);
+	moduleIsCorrect &= validatorCopy.moduleIsCorrect;
+	warningMessages.insert(warningMessages.end(),
+		validatorCopy.warningMessages.begin(),
+		validatorCopy.warningMessages.end());
 }
 
 } // namespace llvmir2hll
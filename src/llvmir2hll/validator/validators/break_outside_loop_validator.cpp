@@ -40,7 +40,6 @@ void BreakOutsideLoopValidator::visit(ShPtr<BreakStmt> stmt) {
 		validationError("In " + func->getName() + "(), found `" + stmtStr.str()
 			+ "` outside of a loop or a switch statement.");
 	}
-	OrderedAllVisitor::visit(stmt);
 }
 
 void BreakOutsideLoopValidator::visit(ShPtr<ContinueStmt> stmt) {
@@ -53,7 +52,6 @@ void BreakOutsideLoopValidator::visit(ShPtr<ContinueStmt> stmt) {
 		validationError("In " + func->getName() + "(), found `" + stmtStr.str()
 			+"` outside of a loop.");
 	}
-	OrderedAllVisitor::visit(stmt);
 }
 
 } // namespace llvmir2hll
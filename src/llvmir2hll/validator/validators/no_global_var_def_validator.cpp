@@ -35,13 +35,12 @@ std::string NoGlobalVarDefValidator::getId() const {
 
 void NoGlobalVarDefValidator::visit(ShPtr<VarDefStmt> stmt) {
 	// The left-hand side of a VarDefStmt cannot be a global variable.
-	std::ostringstream stmtStr;
-	stmtStr << stmt;
 	if (module->isGlobalVar(stmt->getVar())) {
+		std::ostringstream stmtStr;
+		stmtStr << stmt;
 		validationError("In "+func->getName()+"(), found a VarDefStmt `"+
 			stmtStr.str()+"` that defines a global variable.");
 	}
-	OrderedAllVisitor::visit(stmt);
 }
 
 } // namespace llvmir2hll
@@ -50,8 +50,6 @@ void ReturnValidator::visit(ShPtr<ReturnStmt> stmt) {
 		validationError("In "+func->getName()+"(), which returns void, "
 			"found a ReturnStmt `"+stmtStr.str()+"` with a return value.");
 	}
-
-	OrderedAllVisitor::visit(stmt);
 }
 
 } // namespace llvmir2hll
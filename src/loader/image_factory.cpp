@@ -71,7 +71,8 @@ std::unique_ptr<Image> createImage(const std::string& filePath, bool isRaw)
 {
 	std::unique_ptr<retdec::fileformat::FileFormat> fileFormat = retdec::fileformat::createFileFormat(
 			filePath,
-			isRaw);
+			isRaw,
+			retdec::fileformat::LoadFlags::LAZY_DIGESTS);
 	std::shared_ptr<retdec::fileformat::FileFormat> fileFormatShared(std::move(fileFormat)); // Obtain ownership.
 	return createImageImpl(fileFormatShared);
 }
@@ -5,12 +5,15 @@
  */
 
 #include <fstream>
+#include <memory>
 #include <ostream>
 
+#include "retdec/stacofin/prefilter.h"
 #include "retdec/utils/filesystem.h"
 #include "retdec/utils/io/log.h"
 #include "retdec/utils/version.h"
 #include "pat2yara/processing.h"
+#include "pat2yara/utils.h"
 #include "yaramod/builder/yara_file_builder.h"
 #include "yaramod/builder/yara_rule_builder.h"
 #include "yaramod/yaramod.h"
@@ -31,7 +34,8 @@ void printUsage(Logger& log)
 {
 	log <<
 	"Usage: pat2yara [-o OUTPUT_FILE] [--max-size VALUE] [--min-size VALUE]\n"
-	"  [--min-pure VALUE] [-o OUTPUT_FILE] INPUT_FILE [INPUT_FILE...]\n\n"
+	"  [--min-pure VALUE] [-o OUTPUT_FILE] INPUT_FILE [INPUT_FILE...]\n"
+	"       pat2yara --prefilter-only RULES_FILE [-o OUTPUT_FILE]\n\n"
 	"-o --output OUTPUT_FILE\n"
 	"    Output file path (if not given, stdout is used).\n"
 	"    If multiple paths are given, only last one is used.\n\n"
@@ -48,7 +52,14 @@ void printUsage(Logger& log)
 	"--ignore-nops OPCODE\n"
 	"    Ignore NOPs with OPCODE when computing (pure) size.\n\n"
 	"--delphi\n"
-	"    Set special Delphi processing on.\n"
+	"    Set special Delphi processing on.\n\n"
+	"--prefilter\n"
+	"    Write prefilter index of the rules alongside OUTPUT_FILE.\n"
+	"    Static code detection uses it to skip files that can not match.\n\n"
+	"--prefilter-only RULES_FILE\n"
+	"    Do not process input files, only write prefilter index of rules\n"
+	"    in RULES_FILE created by pat2yara. The index is bound to OUTPUT_FILE\n"
+	"    (e.g. RULES_FILE compiled by yarac) if given, to RULES_FILE otherwise.\n\n"
 	"-h --help\n"
 	"    Show this help.\n"
 	"--version\n"
@@ -103,6 +114,77 @@ bool argumentToSize(
 	return false;
 }
 
+/**
+ * Write prefilter index of rules in @a yaraFile alongside @a outputPath.
+ * The rules have to be already written into @a outputPath because the index
+ * is bound to the current version of the file.
+ *
+ * @param yaraFile output rules
+ * @param outputPath path to the output rules
+ *
+ * @return @c true if index was written, @c false otherwise
+ */
+bool writePrefilterIndex(
+	const YaraFile &yaraFile,
+	const std::string &outputPath)
+{
+	using retdec::stacofin::Prefilter;
+
+	std::vector<std::uint32_t> anchors;
+	bool complete = true;
+	for (const auto &rule : yaraFile.getRules()) {
+		const auto condition = rule->getCondition()->getText();
+		if (condition == "false") {
+			// Rule never matches.
+			continue;
+		}
+
+		const auto hPattern = getHexPattern(rule.get(), "$1");
+		std::uint32_t anchor = 0;
+		if (condition != "$1" || !hPattern
+				|| !Prefilter::getAnchor(hPattern->getText(), anchor)) {
+			complete = false;
+			break;
+		}
+		anchors.push_back(anchor);
+	}
+
+	return Prefilter::writeIndex(outputPath, anchors, complete);
+}
+
+/**
+ * Write prefilter index of rules in existing file @a rulesPath alongside
+ * @a signaturePath.
+ *
+ * @param rulesPath rules created by pat2yara
+ * @param signaturePath file with the same rules the index is bound to
+ *
+ * @return return code
+ */
+int writePrefilterIndexOf(
+	const std::string &rulesPath,
+	const std::string &signaturePath)
+{
+	std::unique_ptr<YaraFile> yaraFile;
+	try {
+		yaraFile = Yaramod().parseFile(rulesPath);
+	}
+	catch (const std::exception &e) {
+		return dieWithError("cannot parse rules in '" + rulesPath + "': "
+			+ e.what());
+	}
+	if (!yaraFile) {
+		return dieWithError("cannot parse rules in '" + rulesPath + "'");
+	}
+
+	if (!writePrefilterIndex(*yaraFile, signaturePath)) {
+		return dieWithError("cannot write prefilter index for '"
+			+ signaturePath + "'");
+	}
+
+	return 0;
+}
+
 /**
  * Process program inputs.
  *
@@ -115,6 +197,8 @@ int processArguments(std::vector<std::string> &args)
 	ProcessingOptions options;
 	std::string outputPath;
 	std::string logPath;
+	std::string prefilterRulesPath;
+	bool prefilter = false;
 
 	for (std::size_t i = 0; i < args.size(); ++i) {
 		if (args[i] == "--help" || args[i] == "-h") {
@@ -129,6 +213,17 @@ int processArguments(std::vector<std::string> &args)
 		else if (args[i] == "--delphi") {
 			options.isDelphi = true;
 		}
+		else if (args[i] == "--prefilter") {
+			prefilter = true;
+		}
+		else if (args[i] == "--prefilter-only") {
+			if (args.size() > i + 1) {
+				prefilterRulesPath = args[++i];
+			}
+			else {
+				return dieWithError("option " + args[i] + " needs a value");
+			}
+		}
 		else if (args[i] == "--max-size") {
 			if (!argumentToSize(args, options.maxSize, ++i)) {
 				return dieWithError("invalid --max-size argument value");
@@ -177,11 +272,19 @@ int processArguments(std::vector<std::string> &args)
 		}
 	}
 
+	if (!prefilterRulesPath.empty()) {
+		return writePrefilterIndexOf(prefilterRulesPath,
+			outputPath.empty() ? prefilterRulesPath : outputPath);
+	}
+
 	// Check options.
 	std::string errorMessage;
 	if (!options.validate(errorMessage)) {
 		return dieWithError(errorMessage);
 	}
+	if (prefilter && outputPath.empty()) {
+		return dieWithError("option --prefilter needs --output");
+	}
 
 	// Process input files.
 	YaraFileBuilder logBuilder;
@@ -195,7 +298,14 @@ int processArguments(std::vector<std::string> &args)
 		}
 		else {
 			processFiles(fileBuilder, logBuilder, options);
-			outputStream << fileBuilder.get(false)->getText();
+			auto yaraFile = fileBuilder.get(false);
+			outputStream << yaraFile->getText();
+			outputStream.close();
+
+			if (prefilter && !writePrefilterIndex(*yaraFile, outputPath)) {
+				return dieWithError("cannot write prefilter index for '"
+					+ outputPath + "'");
+			}
 		}
 	}
 	else {
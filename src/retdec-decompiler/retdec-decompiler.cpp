@@ -46,7 +46,10 @@
 #include "retdec/utils/filesystem.h"
 #include "retdec/utils/io/log.h"
 #include "retdec/utils/memory.h"
+#include "retdec/utils/profiler.h"
 #include "retdec/utils/string.h"
+#include "retdec/utils/system.h"
+#include "retdec/utils/thread_pool.h"
 #include "retdec/utils/version.h"
 
 using namespace retdec::utils::io;
@@ -73,6 +76,10 @@ class ProgramOptions
 		std::string arExtractPath;
 		std::string arName;
 		std::optional<uint64_t> arIdx;
+		/// Output config path was derived from the input or output path
+		/// (it was not given by the user), so it gets the extension of
+		/// the config format.
+		bool derivedOutputConfigFile = false;
 
 		bool cleanup = false;
 		std::set<std::string> toClean;
@@ -265,7 +272,7 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 	else if (isParam(i, "-f", "--output-format"))
 	{
 		auto of = getParamOrDie(i);
-		if (!(of == "plain" || of == "json" || of == "json-human"))
+		if (!(of == "plain" || of == "json" || of == "json-human" || of == "binary"))
 		{
 			throw std::runtime_error(
 				"[-f|--output-format] unknown output format: " + of
@@ -288,6 +295,32 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 			);
 		}
 	}
+	else if (isParam(i, "", "--max-threads"))
+	{
+		auto val = getParamOrDie(i);
+		try
+		{
+			params.setMaxThreads(std::stoull(val));
+		}
+		catch (...)
+		{
+			throw std::runtime_error(
+				"[--max-threads] invalid value: " + val
+			);
+		}
+	}
+	else if (isParam(i, "", "--metrics-file"))
+	{
+		params.setMetricsFile(getParamOrDie(i));
+	}
+	else if (isParam(i, "", "--trace-file"))
+	{
+		params.setTraceFile(getParamOrDie(i));
+	}
+	else if (isParam(i, "", "--fast-exit"))
+	{
+		params.setIsFastExit(true);
+	}
 	else if (isParam(i, "", "--no-memory-limit"))
 	{
 		params.setMaxMemoryLimit(0);
@@ -307,6 +340,7 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 		params.setOutputBitcodeFile(out + ".bc");
 		params.setOutputLlvmirFile(out + ".ll");
 		params.setOutputConfigFile(out + ".config.json");
+		derivedOutputConfigFile = true;
 		params.setOutputUnpackedFile(out + "-unpacked");
 		arExtractPath = out + "-extracted";
 	}
@@ -355,6 +389,10 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 	{
 		params.setIsSelectedDecodeOnly(true);
 	}
+	else if (isParam(i, "", "--select-demand-driven"))
+	{
+		params.setIsSelectedDemandDriven(true);
+	}
 	else if (isParam(i, "", "--raw-section-vma"))
 	{
 		auto val = getParamOrDie(i);
@@ -388,10 +426,25 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 		getParamOrDie(i);
 		// ignore: it was already processed
 	}
+	else if (isParam(i, "", "--config-format"))
+	{
+		auto cf = getParamOrDie(i);
+		if (!(cf == "json" || cf == "binary"))
+		{
+			throw std::runtime_error(
+				"[--config-format] unknown config format: " + cf
+			);
+		}
+		params.setConfigFormat(cf);
+	}
 	else if (isParam(i, "", "--disable-static-code-detection"))
 	{
 		params.setIsDetectStaticCode(false);
 	}
+	else if (isParam(i, "", "--skip-static-code-lifting"))
+	{
+		params.setIsSkipStaticCodeLifting(true);
+	}
 	else if (isParam(i, "", "--backend-disabled-opts"))
 	{
 		params.setBackendDisabledOpts(getParamOrDie(i));
@@ -438,6 +491,17 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 	{
 		params.setIsBackendEmitCg(true);
 	}
+	else if (isParam(i, "", "--backend-graph-format"))
+	{
+		auto f = getParamOrDie(i);
+		if (!(f == "dot" || f == "jsonl"))
+		{
+			throw std::runtime_error(
+				"[--backend-graph-format] unknown format: " + f
+			);
+		}
+		params.setBackendGraphFormat(f);
+	}
 	else if (isParam(i, "", "--backend-keep-all-brackets"))
 	{
 		params.setIsBackendKeepAllBrackets(true);
@@ -544,11 +608,21 @@ void ProgramOptions::afterLoad()
 	if (params.getOutputLlvmirFile().empty())
 		params.setOutputLlvmirFile(in + ".ll");
 	if (params.getOutputConfigFile().empty())
+	{
 		params.setOutputConfigFile(in + ".config.json");
+		derivedOutputConfigFile = true;
+	}
+	if (params.isConfigFormatBinary() && derivedOutputConfigFile)
+	{
+		auto c = params.getOutputConfigFile();
+		params.setOutputConfigFile(c.substr(0, c.size() - 5) + ".bin");
+	}
 	if (params.getOutputFile().empty())
 	{
 		if (params.getOutputFormat() == "plain")
 			params.setOutputFile(in + ".c");
+		else if (params.getOutputFormat() == "binary")
+			params.setOutputFile(in + ".c.bin");
 		else
 			params.setOutputFile(in + ".c.json");
 	}
@@ -590,6 +664,14 @@ void ProgramOptions::afterLoad()
 		params.setIsKeepAllFunctions(true);
 	}
 
+	if (params.isSelectedDemandDriven() && !params.isSomethingSelected())
+	{
+		throw std::runtime_error(
+			"option --select-demand-driven requires --select-functions"
+			" or --select-ranges"
+		);
+	}
+
 	// After everything, input file must be set.
 	if (params.getInputFile().empty())
 	{
@@ -616,19 +698,22 @@ void ProgramOptions::printHelpAndDie()
 Mandatory arguments:
 	INPUT_FILE File to decompile.
 General arguments:
-	[-o|--output FILE] Output file (default: INPUT_FILE.c if OUTPUT_FORMAT is plain, INPUT_FILE.c.json if OUTPUT_FORMAT is json|json-human).
+	[-o|--output FILE] Output file (default: INPUT_FILE.c if OUTPUT_FORMAT is plain, INPUT_FILE.c.json if OUTPUT_FORMAT is json|json-human, INPUT_FILE.c.bin if OUTPUT_FORMAT is binary).
 	[-s|--silent] Turns off informative output of the decompilation.
-	[-f|--output-format OUTPUT_FORMAT] Output format [plain|json|json-human] (default: plain).
+	[-f|--output-format OUTPUT_FORMAT] Output format [plain|json|json-human|binary] (default: plain). The binary format is a compact token stream (see llvmir2hll/hll/output_managers/binary_tokens.h).
 	[-m|--mode MODE] Force the type of decompilation mode [bin|raw] (default: bin).
 	[-p|--pdb FILE] File with PDB debug information.
 	[-k|--keep-unreachable-funcs] Keep functions that are unreachable from the main function.
 	[--cleanup] Removes temporary files created during the decompilation.
-	[--config] Specify JSON decompilation configuration file.
+	[--config] Specify JSON or binary decompilation configuration file.
+	[--config-format FORMAT] Format of the generated configuration file [json|binary] (default: json). The default path of the generated binary configuration file ends with .config.bin.
 	[--disable-static-code-detection] Prevents detection of statically linked code.
+	[--skip-static-code-lifting] Does not decode detected statically linked functions, only declares them. Faster decompilation of statically linked binaries.
 Selective decompilation arguments:
 	[--select-ranges RANGES] Specify a comma separated list of ranges to decompile (example: 0x100-0x200,0x300-0x400,0x500-0x600).
 	[--select-functions FUNCS] Specify a comma separated list of functions to decompile (example: fnc1,fnc2,fnc3).
 	[--select-decode-only] Decode only selected parts (functions/ranges). Faster decompilation, but worse results.
+	[--select-demand-driven] Decode only selected functions, declare functions called from them and skip whole-program analyses.
 Raw or Intel HEX decompilation arguments:
 	[-a|--arch ARCH] Specify target architecture [mips|pic32|arm|thumb|arm64|powerpc|x86|x86-64].
 	                 Required if it cannot be autodetected from the input (e.g. raw mode, Intel HEX).
@@ -648,8 +733,9 @@ Backend arguments:
 	[--backend-call-info-obtainer NAME] Name of the obtainer of information about function calls [optim|pessim] (Default: optim).
 	[--backend-var-renamer STYLE] Used renamer of variables [address|hungarian|readable|simple|unified] (Default: readable).
 	[--backend-no-opts] Disables backend optimizations.
-	[--backend-emit-cfg] Emits a CFG for each function in the backend IR (in the .dot format).
-	[--backend-emit-cg] Emits a CG for the decompiled module in the backend IR (in the .dot format).
+	[--backend-emit-cfg] Emits a CFG for each function in the backend IR (in the format given by --backend-graph-format).
+	[--backend-emit-cg] Emits a CG for the decompiled module in the backend IR (in the format given by --backend-graph-format).
+	[--backend-graph-format FORMAT] Format of the emitted CFGs and CGs [dot|jsonl] (Default: dot). The jsonl format is an edge list in JSON Lines with addresses.
 	[--backend-keep-all-brackets] Keeps all brackets in the generated code.
 	[--backend-keep-library-funcs] Keep functions from standard libraries.
 	[--backend-no-time-varying-info] Do not emit time-varying information, like dates.
@@ -660,6 +746,10 @@ Decompilation process arguments:
 	[--timeout SECONDS]
 	[--max-memory MAX_MEMORY] Limits the maximal memory used by the given number of bytes.
 	[--no-memory-limit] Disables the default memory limit (half of system RAM).
+	[--max-threads N] Limits the number of threads used by the decompilation (Default: 0 = number of CPU threads).
+	[--metrics-file FILE] Writes time spent in individual decompilation phases and internal counters into FILE (JSON).
+	[--trace-file FILE] Writes a timeline of decompilation phases into FILE (Chrome trace event format, viewable in chrome://tracing or Perfetto).
+	[--fast-exit] Exits right after all the outputs are written, without freeing the memory used by the decompilation.
 LLVM IR debug arguments:
 	[--print-after-all] Dump LLVM IR to stderr after every LLVM pass.
 	[--print-before-all] Dump LLVM IR to stderr before every LLVM pass.
@@ -788,9 +878,14 @@ void setLogsFrom(const retdec::config::Parameters& params)
 	if (!errFile.empty()) {
 		Log::set(Log::Type::Error, Logger::Ptr(new FileLogger(errFile)));
 	}
+
+	Log::setAsync(verbose);
 }
 
-int decompile(retdec::config::Config& config, ProgramOptions& po)
+int decompile(
+		retdec::config::Config& config,
+		ProgramOptions& po,
+		retdec::DecompilationState& state)
 {
 	setLogsFrom(config.parameters);
 
@@ -942,7 +1037,11 @@ int decompile(retdec::config::Config& config, ProgramOptions& po)
 			unpackArgs[2].data(),
 			unpackArgs[3].data()
 	};
-	auto unpackCode = retdec::unpackertool::_main(4, uargv);
+	int unpackCode = 0;
+	{
+		retdec::utils::ProfileScope scope("unpacking");
+		unpackCode = retdec::unpackertool::_main(4, uargv);
+	}
 	if (unpackCode == 0) // EXIT_CODE_OK
 	{
 		config.parameters.setInputFile(
@@ -953,7 +1052,11 @@ int decompile(retdec::config::Config& config, ProgramOptions& po)
 
 	// Decompilation.
 	//
-	return retdec::decompile(config);
+	return retdec::decompile(
+			config,
+			nullptr,
+			config.parameters.isFastExit() ? &state : nullptr
+	);
 }
 
 //
@@ -1021,9 +1124,20 @@ int main(int argc, char **argv)
 	//
 	limitMaximalMemoryIfRequested(config.parameters);
 
+	// Limit number of threads used by all components.
+	//
+	retdec::utils::ThreadPool::setMaxConcurrency(
+			config.parameters.getMaxThreads());
+
+	// Keep the timeline of phases (including the unpacking) if requested.
+	//
+	retdec::utils::Profiler::get().setTraceEnabled(
+			!config.parameters.getTraceFile().empty());
+
 
 	// Decompile.
 	//
+	retdec::DecompilationState state;
 	int ret = 0;
 	try
 	{
@@ -1032,9 +1146,15 @@ int main(int argc, char **argv)
 		{
 			std::packaged_task<
 					int(retdec::config::Config&,
-					ProgramOptions&)> task(decompile);
+					ProgramOptions&,
+					retdec::DecompilationState&)> task(decompile);
 			auto future = task.get_future();
-			std::thread thr(std::move(task), std::ref(config), std::ref(po));
+			std::thread thr(
+					std::move(task),
+					std::ref(config),
+					std::ref(po),
+					std::ref(state)
+			);
 			auto timeout = std::chrono::seconds(config.parameters.getTimeout());
 			if (future.wait_for(timeout) != std::future_status::timeout)
 			{
@@ -1051,7 +1171,7 @@ int main(int argc, char **argv)
 		}
 		else
 		{
-			ret = decompile(config, po);
+			ret = decompile(config, po, state);
 		}
 	}
 	catch (const std::runtime_error& e)
@@ -1067,5 +1187,22 @@ int main(int argc, char **argv)
 
 	cleanup(po);
 
+	// All the outputs are written and closed at this point, so the teardown
+	// of the remaining objects can be left to the OS. Destroying the module
+	// and the passes (which hold the back-end IR) would only walk millions
+	// of nodes to free memory that the OS reclaims at once. After a timeout,
+	// the decompilation thread may still be using them.
+	//
+	if (config.parameters.isFastExit())
+	{
+		if (ret != EXIT_TIMEOUT)
+		{
+			state.passManager.release();
+			state.module.release();
+			state.context.release();
+		}
+		retdec::utils::exitWithoutTeardown(ret);
+	}
+
 	return ret;
 }
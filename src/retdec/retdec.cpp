@@ -50,7 +50,9 @@
 #include "retdec/config/config.h"
 #include "retdec/retdec/retdec.h"
 #include "retdec/utils/memory.h"
+#include "retdec/utils/profiler.h"
 #include "retdec/utils/io/log.h"
+#include "retdec/utils/thread_pool.h"
 
 using namespace retdec::utils::io;
 
@@ -359,6 +361,9 @@ class ModulePassPrinter : public ModulePass
 
 		static std::string LastPhase;
 		inline static const std::string LlvmAggregatePhaseName = "LLVM";
+		/// Measures the pass that follows the printer, i.e. it lasts until
+		/// the next printer is run.
+		static std::unique_ptr<utils::ProfileScope> CurrentScope;
 
 	public:
 		ModulePassPrinter(
@@ -374,6 +379,9 @@ class ModulePassPrinter : public ModulePass
 
 		bool runOnModule(Module &M) override
 		{
+			CurrentScope.reset();
+			CurrentScope = std::make_unique<utils::ProfileScope>(PhaseArg);
+
 			if (utils::startsWith(PhaseArg, "retdec"))
 			{
 				Log::phase(PhaseName);
@@ -407,6 +415,7 @@ class ModulePassPrinter : public ModulePass
 };
 char ModulePassPrinter::ID = 0;
 std::string ModulePassPrinter::LastPhase;
+std::unique_ptr<utils::ProfileScope> ModulePassPrinter::CurrentScope;
 
 /**
  * Add the pass to the pass manager - no verification.
@@ -458,16 +467,47 @@ void setLogsFrom(const retdec::config::Parameters& params)
 	if (!errFile.empty()) {
 		Log::set(Log::Type::Error, Logger::Ptr(new FileLogger(errFile)));
 	}
+
+	Log::setAsync(verbose);
 }
 
-bool decompile(retdec::config::Config& config, std::string* outString)
+/**
+ * Writes times of decompilation phases into files requested in @a params.
+ */
+void writeProfilingResults(const retdec::config::Parameters& params)
+{
+	auto& profiler = utils::Profiler::get();
+
+	auto metricsFile = params.getMetricsFile();
+	if (!metricsFile.empty() && !profiler.writeMetricsFile(metricsFile))
+	{
+		Log::error() << Log::Warning
+				<< "failed to write metrics into " << metricsFile << std::endl;
+	}
+
+	auto traceFile = params.getTraceFile();
+	if (!traceFile.empty() && !profiler.writeChromeTraceFile(traceFile))
+	{
+		Log::error() << Log::Warning
+				<< "failed to write trace into " << traceFile << std::endl;
+	}
+}
+
+bool decompile(
+		retdec::config::Config& config,
+		std::string* outString,
+		DecompilationState* state)
 {
 	setLogsFrom(config.parameters);
+	utils::Profiler::get().setTraceEnabled(
+			!config.parameters.getTraceFile().empty());
 
 	Log::phase("Initialization");
 	auto& passRegistry = initializeLlvmPasses();
 
 	// limitMaximalMemoryIfRequested(params);
+	retdec::utils::ThreadPool::setMaxConcurrency(
+			config.parameters.getMaxThreads());
 	// PrintAfterAll = true;
 
 	auto context = std::make_unique<llvm::LLVMContext>();
@@ -475,7 +515,7 @@ bool decompile(retdec::config::Config& config, std::string* outString)
 
 	// Create a PassManager to hold and optimize the collection of passes we
 	// are about to build.
-	llvm::legacy::PassManager pm;
+	auto pm = std::make_unique<llvm::legacy::PassManager>();
 
 	// Without this LLVM does more opts than we would like it to.
 	// e.g. printf() call -> puts() call
@@ -485,14 +525,14 @@ bool decompile(retdec::config::Config& config, std::string* outString)
 	TargetLibraryInfoImpl TLII(ModuleTriple);
 	// The -disable-simplify-libcalls flag actually disables all builtin optzns.
 	TLII.disableAllFunctions();
-	pm.add(new TargetLibraryInfoWrapperPass(TLII));
+	pm->add(new TargetLibraryInfoWrapperPass(TLII));
 
 	for (auto& p : config.parameters.llvmPasses)
 	{
 		if (auto* info = passRegistry.getPassInfo(p))
 		{
 			auto* pass = info->createPass();
-			addPass(pm, pass, info);
+			addPass(*pm, pass, info);
 
 			if (info->getTypeInfo() == &bin2llvmir::ProviderInitialization::ID)
 			{
@@ -513,7 +553,17 @@ bool decompile(retdec::config::Config& config, std::string* outString)
 	}
 
 	// Now that we have all of the passes ready, run them.
-	pm.run(*module);
+	pm->run(*module);
+	ModulePassPrinter::CurrentScope.reset();
+
+	writeProfilingResults(config.parameters);
+
+	if (state)
+	{
+		state->passManager = std::move(pm);
+		state->module = std::move(module);
+		state->context = std::move(context);
+	}
 
 	return EXIT_SUCCESS;
 }
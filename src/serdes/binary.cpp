@@ -0,0 +1,376 @@
+/**
+ * @file src/serdes/binary.cpp
+ * @brief Compact binary encoding of serialized objects.
+ * @copyright (c) 2019 Avast Software, licensed under the MIT license
+ */
+
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/reader.h>
+#include <rapidjson/stringbuffer.h>
+
+#include "retdec/serdes/binary.h"
+
+namespace {
+
+/**
+ * Is @a str a hexadecimal address in the canonical form produced by
+ * @c Address::toHexPrefixString(), i.e. it can be restored from its value?
+ */
+bool isCanonicalHexAddress(const char* str, std::size_t length, uint64_t& value)
+{
+	if (length < 3 || length > 2 + 16
+			|| str[0] != '0' || str[1] != 'x'
+			|| (str[2] == '0' && length != 3))
+	{
+		return false;
+	}
+
+	value = 0;
+	for (std::size_t i = 2; i < length; ++i)
+	{
+		char c = str[i];
+		if (c >= '0' && c <= '9')
+		{
+			value = (value << 4) | uint64_t(c - '0');
+		}
+		else if (c >= 'a' && c <= 'f')
+		{
+			value = (value << 4) | uint64_t(c - 'a' + 10);
+		}
+		else
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+} // anonymous namespace
+
+namespace retdec {
+namespace serdes {
+
+namespace binary {
+
+/**
+ * Does @a data start with the binary encoding header?
+ */
+bool isBinary(const char* data, std::size_t size)
+{
+	return size >= HeaderSize
+			&& std::memcmp(data, Magic, sizeof(Magic)) == 0;
+}
+
+bool isBinary(const std::string& data)
+{
+	return isBinary(data.data(), data.size());
+}
+
+} // namespace binary
+
+//
+//=============================================================================
+//  BinaryWriter
+//=============================================================================
+//
+
+BinaryWriter::BinaryWriter()
+{
+	_out.append(binary::Magic, sizeof(binary::Magic));
+	_out.push_back(static_cast<char>(binary::MajorVersion));
+	_out.push_back(static_cast<char>(binary::MinorVersion));
+}
+
+bool BinaryWriter::Null()
+{
+	writeTag(binary::Tag::Null);
+	return true;
+}
+
+bool BinaryWriter::Bool(bool b)
+{
+	writeTag(b ? binary::Tag::True : binary::Tag::False);
+	return true;
+}
+
+bool BinaryWriter::Int(int i)
+{
+	return Int64(i);
+}
+
+bool BinaryWriter::Uint(unsigned u)
+{
+	return Uint64(u);
+}
+
+bool BinaryWriter::Int64(std::int64_t i)
+{
+	writeTag(binary::Tag::Int);
+	writeVarint((static_cast<std::uint64_t>(i) << 1)
+			^ static_cast<std::uint64_t>(i >> 63));
+	return true;
+}
+
+bool BinaryWriter::Uint64(std::uint64_t u)
+{
+	writeTag(binary::Tag::Uint);
+	writeVarint(u);
+	return true;
+}
+
+bool BinaryWriter::Double(double d)
+{
+	std::uint64_t v;
+	std::memcpy(&v, &d, sizeof(v));
+	writeTag(binary::Tag::Double);
+	for (unsigned i = 0; i < 8; ++i)
+	{
+		_out.push_back(static_cast<char>(v >> (8 * i)));
+	}
+	return true;
+}
+
+/**
+ * Numbers kept in their textual form are stored as strings.
+ */
+bool BinaryWriter::RawNumber(
+		const char* str,
+		rapidjson::SizeType length,
+		bool copy)
+{
+	return String(str, length, copy);
+}
+
+bool BinaryWriter::String(
+		const char* str,
+		rapidjson::SizeType length,
+		bool /*copy*/)
+{
+	std::uint64_t address = 0;
+	if (isCanonicalHexAddress(str, length, address))
+	{
+		writeTag(binary::Tag::HexAddress);
+		writeVarint(address);
+		return true;
+	}
+
+	if (length > binary::MaxInternedLength)
+	{
+		writeTag(binary::Tag::String);
+		writeBytes(str, length);
+		return true;
+	}
+
+	auto res = _strings.emplace(std::string(str, length), _strings.size());
+	if (res.second)
+	{
+		writeTag(binary::Tag::InternedString);
+		writeBytes(str, length);
+	}
+	else
+	{
+		writeTag(binary::Tag::StringRef);
+		writeVarint(res.first->second);
+	}
+	return true;
+}
+
+bool BinaryWriter::String(const char* str)
+{
+	return String(str, static_cast<rapidjson::SizeType>(std::strlen(str)));
+}
+
+bool BinaryWriter::String(const std::string& str)
+{
+	return String(str.data(), static_cast<rapidjson::SizeType>(str.size()));
+}
+
+bool BinaryWriter::Key(const char* str, rapidjson::SizeType length, bool copy)
+{
+	return String(str, length, copy);
+}
+
+bool BinaryWriter::Key(const std::string& str)
+{
+	return String(str);
+}
+
+bool BinaryWriter::StartObject()
+{
+	writeTag(binary::Tag::StartObject);
+	return true;
+}
+
+bool BinaryWriter::EndObject(rapidjson::SizeType /*memberCount*/)
+{
+	writeTag(binary::Tag::EndObject);
+	return true;
+}
+
+bool BinaryWriter::StartArray()
+{
+	writeTag(binary::Tag::StartArray);
+	return true;
+}
+
+bool BinaryWriter::EndArray(rapidjson::SizeType /*elementCount*/)
+{
+	writeTag(binary::Tag::EndArray);
+	return true;
+}
+
+const std::string& BinaryWriter::getOutput() const
+{
+	return _out;
+}
+
+/**
+ * Move the encoded data out of the writer.
+ */
+std::string BinaryWriter::releaseOutput()
+{
+	return std::move(_out);
+}
+
+void BinaryWriter::writeTag(binary::Tag t)
+{
+	_out.push_back(static_cast<char>(t));
+}
+
+void BinaryWriter::writeVarint(std::uint64_t v)
+{
+	while (v >= 0x80)
+	{
+		_out.push_back(static_cast<char>((v & 0x7f) | 0x80));
+		v >>= 7;
+	}
+	_out.push_back(static_cast<char>(v));
+}
+
+void BinaryWriter::writeBytes(const char* str, std::size_t length)
+{
+	writeVarint(length);
+	_out.append(str, length);
+}
+
+//
+//=============================================================================
+//  BinaryReader
+//=============================================================================
+//
+
+BinaryReader::BinaryReader(const char* data, std::size_t size)
+		: _data(data)
+		, _size(size)
+{
+
+}
+
+bool BinaryReader::hasError() const
+{
+	return !_error.empty();
+}
+
+const std::string& BinaryReader::getError() const
+{
+	return _error;
+}
+
+/**
+ * @return Offset in the data at which the error was detected.
+ */
+std::size_t BinaryReader::getErrorOffset() const
+{
+	return _errorOffset;
+}
+
+bool BinaryReader::fail(const std::string& msg)
+{
+	if (_error.empty())
+	{
+		_error = msg;
+		_errorOffset = _pos;
+	}
+	return false;
+}
+
+bool BinaryReader::readVarint(std::uint64_t& v)
+{
+	v = 0;
+	for (unsigned shift = 0; shift < 64; shift += 7)
+	{
+		if (_pos >= _size)
+		{
+			return fail("truncated integer");
+		}
+		auto b = static_cast<std::uint8_t>(_data[_pos++]);
+		v |= std::uint64_t(b & 0x7f) << shift;
+		if ((b & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+	return fail("integer too long");
+}
+
+bool BinaryReader::readBytes(const char*& str, std::size_t& length)
+{
+	std::uint64_t l = 0;
+	if (!readVarint(l))
+	{
+		return false;
+	}
+	if (l > _size - _pos)
+	{
+		return fail("truncated string");
+	}
+	str = _data + _pos;
+	length = l;
+	_pos += l;
+	return true;
+}
+
+//
+//=============================================================================
+//  Conversions
+//=============================================================================
+//
+
+/**
+ * Convert JSON text into the binary encoding.
+ * @return @c true if @a json was parsed, @c false otherwise.
+ */
+bool jsonToBinary(const std::string& json, std::string& binary)
+{
+	BinaryWriter writer;
+	rapidjson::Reader reader;
+	rapidjson::StringStream ss(json.c_str());
+	if (!reader.Parse(ss, writer))
+	{
+		return false;
+	}
+
+	binary = writer.releaseOutput();
+	return true;
+}
+
+/**
+ * Convert the binary encoding into (pretty-printed) JSON text.
+ * @return @c true if @a binary was well formed, @c false otherwise.
+ */
+bool binaryToJson(const std::string& binary, std::string& json)
+{
+	rapidjson::StringBuffer sb;
+	rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(sb);
+	BinaryReader reader(binary.data(), binary.size());
+	if (!reader(writer))
+	{
+		return false;
+	}
+
+	json = sb.GetString();
+	return true;
+}
+
+} // namespace serdes
+} // namespace retdec
@@ -0,0 +1,362 @@
+/**
+ * @file src/stacofin/prefilter.cpp
+ * @brief Prefilter of static code signature files.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <cctype>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <system_error>
+
+#include "retdec/stacofin/prefilter.h"
+#include "retdec/utils/filesystem.h"
+
+namespace retdec {
+namespace stacofin {
+
+namespace {
+
+/// Number of bits of hashes of 4-grams.
+const unsigned HASH_BITS = 24;
+
+/// The first line of index files.
+const std::string INDEX_HEADER = "retdec-stacofin-prefilter 3";
+const std::string INDEX_COMPLETE = "complete";
+const std::string INDEX_INCOMPLETE = "incomplete";
+
+/**
+ * @return How common byte @a b is in code. Windows containing common bytes
+ *         (padding, alignment, prologues) make poor anchors.
+ */
+unsigned byteCommonness(std::uint8_t b)
+{
+	switch (b)
+	{
+		case 0x00:
+			return 8;
+		case 0xff:
+		case 0xcc:
+		case 0x90:
+			return 4;
+		case 0x55:
+		case 0x89:
+		case 0x8b:
+		case 0xe5:
+		case 0xec:
+		case 0x48:
+			return 2;
+		default:
+			return 1;
+	}
+}
+
+} // anonymous namespace
+
+/**
+ * Remember all 4-grams of @a size bytes on @a data.
+ */
+Prefilter::Prefilter(const std::uint8_t* data, std::size_t size) :
+		_ngrams((std::size_t(1) << HASH_BITS) / 64, 0)
+{
+	std::uint32_t ngram = 0;
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		ngram = (ngram >> 8) | (std::uint32_t(data[i]) << 24);
+		if (i >= 3)
+		{
+			auto h = hash(ngram);
+			_ngrams[h / 64] |= std::uint64_t(1) << (h % 64);
+		}
+	}
+}
+
+/**
+ * @return @c True if @a anchor may be present in the scanned data, @c false
+ *         if it surely is not.
+ */
+bool Prefilter::mayContain(std::uint32_t anchor) const
+{
+	auto h = hash(anchor);
+	return _ngrams[h / 64] & (std::uint64_t(1) << (h % 64));
+}
+
+/**
+ * @return @c False if no rule from signature file @a signaturePath can match
+ *         the scanned data, @c true otherwise.
+ */
+bool Prefilter::mayMatch(const std::string& signaturePath) const
+{
+	std::vector<std::uint32_t> anchors;
+	if (!readIndex(signaturePath, anchors))
+	{
+		return true;
+	}
+
+	for (auto a : anchors)
+	{
+		if (mayContain(a))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @return Path to the index of signature file @a signaturePath. It is the
+ *         signature path with extension replaced by @c .prefilter, so both
+ *         the source (@c .yara) and compiled (@c .yarac) signatures share it.
+ */
+std::string Prefilter::getIndexPath(const std::string& signaturePath)
+{
+	return fs::path(signaturePath).replace_extension(".prefilter").string();
+}
+
+/**
+ * Find anchor of a rule whose only string is YARA hex string @a hexString.
+ *
+ * The anchor is the least common window of four fixed bytes that are not
+ * inside alternatives.
+ *
+ * @return @c True if some anchor was found, @c false otherwise.
+ */
+bool Prefilter::getAnchor(const std::string& hexString, std::uint32_t& anchor)
+{
+	std::vector<std::uint8_t> run;
+	unsigned depth = 0;
+	unsigned bestScore = std::numeric_limits<unsigned>::max();
+
+	auto endRun = [&]()
+	{
+		for (std::size_t i = 0; i + 4 <= run.size(); ++i)
+		{
+			unsigned score = 0;
+			for (std::size_t j = i; j < i + 4; ++j)
+			{
+				score += byteCommonness(run[j]);
+			}
+			if (run[i] == run[i+1] && run[i] == run[i+2] && run[i] == run[i+3])
+			{
+				score += 8;
+			}
+
+			if (score < bestScore)
+			{
+				bestScore = score;
+				anchor = run[i]
+						| (std::uint32_t(run[i+1]) << 8)
+						| (std::uint32_t(run[i+2]) << 16)
+						| (std::uint32_t(run[i+3]) << 24);
+			}
+		}
+		run.clear();
+	};
+
+	for (std::size_t i = 0; i < hexString.size(); ++i)
+	{
+		char c = hexString[i];
+		if (std::isspace(static_cast<unsigned char>(c)) || c == '{' || c == '}')
+		{
+			continue;
+		}
+		else if (c == '(')
+		{
+			endRun();
+			++depth;
+		}
+		else if (c == ')')
+		{
+			endRun();
+			depth = depth ? depth - 1 : 0;
+		}
+		else if (c == '|')
+		{
+			endRun();
+		}
+		else if (c == '[')
+		{
+			endRun();
+			i = hexString.find(']', i);
+			if (i == std::string::npos)
+			{
+				break;
+			}
+		}
+		else if (c == '~')
+		{
+			// Negated byte -- skip it.
+			endRun();
+			i += 2;
+		}
+		else if (i + 1 < hexString.size()
+				&& std::isxdigit(static_cast<unsigned char>(c))
+				&& std::isxdigit(static_cast<unsigned char>(hexString[i+1]))
+				&& depth == 0)
+		{
+			run.push_back(std::stoul(hexString.substr(i, 2), nullptr, 16));
+			++i;
+		}
+		else
+		{
+			// Wildcards and bytes inside alternatives.
+			endRun();
+			++i;
+		}
+	}
+	endRun();
+
+	return bestScore != std::numeric_limits<unsigned>::max();
+}
+
+/**
+ * Compute digest of signature file @a signaturePath. The digest is the size of
+ * the file followed by the time of its last modification, so that an index
+ * created for a different version of the file is not used. The digest does not
+ * need the content of the file, so checking it costs just one @c stat().
+ *
+ * @return @c True if everything ok, @c false otherwise.
+ */
+bool Prefilter::getDigest(
+		const std::string& signaturePath,
+		std::string& digest)
+{
+	std::error_code ec;
+	auto size = fs::file_size(signaturePath, ec);
+	if (ec)
+	{
+		return false;
+	}
+	auto mtime = fs::last_write_time(signaturePath, ec);
+	if (ec)
+	{
+		return false;
+	}
+
+	digest = std::to_string(size) + " "
+			+ std::to_string(mtime.time_since_epoch().count());
+	return true;
+}
+
+/**
+ * Write index with @a anchors of signature file @a signaturePath. The index
+ * is written into getIndexPath() and it is bound to the current version of
+ * the signature file (see getDigest()), so the signature file has to be
+ * written first and must not be touched afterwards.
+ *
+ * @param signaturePath Path to the signature file.
+ * @param anchors Anchors of rules in the signature file.
+ * @param complete Every rule that can match has its anchor in @a anchors.
+ *                 Incomplete index is written to make it clear that the
+ *                 signature file can not be prefiltered.
+ *
+ * @return @c True if everything ok, @c false otherwise.
+ */
+bool Prefilter::writeIndex(
+		const std::string& signaturePath,
+		const std::vector<std::uint32_t>& anchors,
+		bool complete)
+{
+	std::string digest;
+	if (!getDigest(signaturePath, digest))
+	{
+		return false;
+	}
+
+	std::ofstream out(getIndexPath(signaturePath));
+	if (!out)
+	{
+		return false;
+	}
+
+	out << INDEX_HEADER << "\n";
+	out << digest << "\n";
+	out << (complete ? INDEX_COMPLETE : INDEX_INCOMPLETE) << "\n";
+	if (complete)
+	{
+		out << std::hex << std::setfill('0');
+		for (auto a : anchors)
+		{
+			out << std::setw(8) << a << "\n";
+		}
+	}
+
+	return bool(out);
+}
+
+/**
+ * Read anchors from index of signature file @a signaturePath into @a anchors.
+ *
+ * @return @c True if the index exists, is complete, and was created for the
+ *         current version of the signature file, i.e. it can be used to
+ *         prefilter the signature file, @c false otherwise. @a anchors are
+ *         left untouched if @c false is returned.
+ */
+bool Prefilter::readIndex(
+		const std::string& signaturePath,
+		std::vector<std::uint32_t>& anchors)
+{
+	std::ifstream in(getIndexPath(signaturePath));
+	if (!in)
+	{
+		return false;
+	}
+
+	std::string line;
+	if (!std::getline(in, line) || line != INDEX_HEADER)
+	{
+		return false;
+	}
+	std::string digest;
+	if (!std::getline(in, line)
+			|| !getDigest(signaturePath, digest)
+			|| line != digest)
+	{
+		return false;
+	}
+	if (!std::getline(in, line) || line != INDEX_COMPLETE)
+	{
+		return false;
+	}
+
+	std::vector<std::uint32_t> result;
+	while (std::getline(in, line))
+	{
+		if (line.empty())
+		{
+			continue;
+		}
+
+		std::size_t processed = 0;
+		unsigned long anchor = 0;
+		try
+		{
+			anchor = std::stoul(line, &processed, 16);
+		}
+		catch (const std::exception&)
+		{
+			return false;
+		}
+		if (processed != line.size()
+				|| anchor > std::numeric_limits<std::uint32_t>::max())
+		{
+			return false;
+		}
+		result.push_back(anchor);
+	}
+
+	anchors.insert(anchors.end(), result.begin(), result.end());
+	return true;
+}
+
+/**
+ * @return Hash of 4-gram @a ngram, it has @c HASH_BITS bits.
+ */
+std::size_t Prefilter::hash(std::uint32_t ngram)
+{
+	return std::uint32_t(ngram * 0x9e3779b1u) >> (32 - HASH_BITS);
+}
+
+} // namespace stacofin
+} // namespace retdec
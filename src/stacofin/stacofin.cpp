@@ -9,9 +9,11 @@
 
 #include "retdec/fileformat/fileformat.h"
 #include "retdec/loader/loader/image.h"
+#include "retdec/stacofin/prefilter.h"
 #include "retdec/stacofin/stacofin.h"
 #include "retdec/utils/string.h"
 #include "retdec/utils/filesystem.h"
+#include "retdec/utils/thread_pool.h"
 #include "retdec/yaracpp/yara_detector.h"
 
 /**
@@ -773,6 +775,9 @@ void Finder::search(
 /**
  * Search for static code in input file.
  *
+ * Signature files that can not match the input according to their prefilter
+ * indexes are skipped.
+ *
  * @param image input file image
  * @param yaraFiles static code signature files
  */
@@ -780,8 +785,23 @@ void Finder::search(
 	const retdec::loader::Image& image,
 	const std::set<std::string>& yaraFiles)
 {
+	const auto* fileFormat = image.getFileFormat();
+	if (!fileFormat)
+	{
+		return;
+	}
+
+	const auto& inputBytes = fileFormat->getLoadedBytes();
+	Prefilter prefilter(inputBytes.data(), inputBytes.size());
+
 	for (const auto& f : yaraFiles)
 	{
+		if (!prefilter.mayMatch(f))
+		{
+			LOG << "\t" << "prefilter -> skipped " << f << std::endl;
+			continue;
+		}
+
 		search(image, f);
 	}
 }
@@ -809,7 +829,7 @@ void Finder::searchAndConfirm(
 	_config = &config;
 	_image = &image;
 
-	if (initDisassembler() || _ceInsn == nullptr)
+	if (initDisassembler())
 	{
 		return;
 	}
@@ -861,9 +881,56 @@ void Finder::searchAndConfirm(
 				<< f->getName() << "', " << f->getAddress() << ")"
 				<< std::endl;
 	}
+}
+
+Finder::Disassembler::Disassembler(cs_arch arch, cs_mode mode) :
+		mode(mode)
+{
+	if (cs_open(arch, mode, &ce) != CS_ERR_OK)
+	{
+		ce = 0;
+		return;
+	}
+	if (cs_option(ce, CS_OPT_DETAIL, CS_OPT_ON) != CS_ERR_OK)
+	{
+		return;
+	}
+	insn = cs_malloc(ce);
+}
+
+Finder::Disassembler::~Disassembler()
+{
+	if (insn)
+	{
+		cs_free(insn, 1);
+	}
+	if (ce)
+	{
+		cs_close(&ce);
+	}
+}
 
-	cs_free(_ceInsn, 1);
-	cs_close(&_ce);
+bool Finder::Disassembler::isValid() const
+{
+	return ce != 0 && insn != nullptr;
+}
+
+/**
+ * Switch disassembler to mode \p m, if it is not already in it.
+ * @return @c True if everything ok, @c false otherwise.
+ */
+bool Finder::Disassembler::setMode(cs_mode m)
+{
+	if (m == mode)
+	{
+		return true;
+	}
+	if (cs_option(ce, CS_OPT_MODE, m) != CS_ERR_OK)
+	{
+		return false;
+	}
+	mode = m;
+	return true;
 }
 
 /**
@@ -871,26 +938,25 @@ void Finder::searchAndConfirm(
  */
 bool Finder::initDisassembler()
 {
-	cs_arch arch;
 	_ceMode = CS_MODE_LITTLE_ENDIAN;
 	if (_config->architecture.isX86())
 	{
-		arch = CS_ARCH_X86;
+		_ceArch = CS_ARCH_X86;
 		_ceMode = CS_MODE_32;
 	}
 	else if (_config->architecture.isMipsOrPic32())
 	{
-		arch = CS_ARCH_MIPS;
+		_ceArch = CS_ARCH_MIPS;
 		_ceMode = CS_MODE_MIPS32;
 	}
 	else if (_config->architecture.isArm32OrThumb())
 	{
-		arch = CS_ARCH_ARM;
+		_ceArch = CS_ARCH_ARM;
 		_ceMode = CS_MODE_ARM;
 	}
 	else if (_config->architecture.isPpc())
 	{
-		arch = CS_ARCH_PPC;
+		_ceArch = CS_ARCH_PPC;
 		_ceMode = CS_MODE_LITTLE_ENDIAN;
 	}
 	else
@@ -898,76 +964,99 @@ bool Finder::initDisassembler()
 		return true;
 	}
 
-	if (cs_open(arch, _ceMode, &_ce) != CS_ERR_OK)
-	{
-		return true;
-	}
-	if (cs_option(_ce, CS_OPT_DETAIL, CS_OPT_ON) != CS_ERR_OK)
-	{
-		return true;
-	}
-	_ceInsn = cs_malloc(_ce);
-
-	return false;
+	// Disassemblers are created by the threads resolving references, make
+	// sure it is possible at all.
+	return !Disassembler(_ceArch, _ceMode).isValid();
 }
 
+/**
+ * Resolve targets of references of all detections and check them.
+ *
+ * Detections are processed in parallel. A reference is resolved only from
+ * the image and the detections (which are not modified here), so the results
+ * do not depend on the order in which the detections are processed.
+ * Every chunk of detections is processed by its own disassembler. Chunks are
+ * contiguous in the address order, so detections on the same address, whose
+ * references usually are on the same addresses, share the disassembler's
+ * caches.
+ */
 void Finder::solveReferences()
 {
+	std::vector<DetectedFunction*> detections;
+	detections.reserve(_allDetections.size());
 	for (auto& p : _allDetections)
 	{
-		bool modeSwitch = false;
-		std::string& sigPath = p.second.signaturePath;
-		if (_config->architecture.isArm32OrThumb()
-				&& utils::containsCaseInsensitive(sigPath, "thumb"))
-		{
-			if (cs_option(_ce, CS_OPT_MODE, CS_MODE_THUMB) != CS_ERR_OK)
-			{
-				assert(false);
-				return;
-			}
-			modeSwitch = true;
-		}
+		detections.push_back(&p.second);
+	}
 
-		for (auto& r : p.second.references)
+	utils::parallelForRanges(0, detections.size(),
+			[this, &detections](std::size_t b, std::size_t e)
+	{
+		Disassembler d(_ceArch, _ceMode);
+		if (!d.isValid())
 		{
-			r.target = getAddressFromRef(r.address);
-			checkRef(r);
+			return;
 		}
 
-		if (modeSwitch)
+		for (std::size_t i = b; i < e; ++i)
 		{
-			if (cs_option(_ce, CS_OPT_MODE, _ceMode) != CS_ERR_OK)
-			{
-				assert(false);
-				return;
-			}
+			solveReferences(d, *detections[i]);
 		}
+	});
+}
+
+void Finder::solveReferences(Disassembler& d, DetectedFunction& f)
+{
+	bool thumb = _config->architecture.isArm32OrThumb()
+			&& utils::containsCaseInsensitive(f.signaturePath, "thumb");
+	if (!d.setMode(thumb ? CS_MODE_THUMB : _ceMode))
+	{
+		assert(false);
+		return;
+	}
+
+	for (auto& r : f.references)
+	{
+		r.target = getAddressFromRef(d, r.address);
+		checkRef(d, r);
 	}
 }
 
-common::Address Finder::getAddressFromRef(common::Address ref)
+common::Address Finder::getAddressFromRef(
+		Disassembler& d,
+		common::Address ref)
 {
+	auto key = std::make_pair(ref, d.mode);
+	auto cIt = d.refTargets.find(key);
+	if (cIt != d.refTargets.end())
+	{
+		return cIt->second;
+	}
+
+	Address target;
 	if (_config->architecture.isX86())
 	{
-		return getAddressFromRef_x86(ref);
+		target = getAddressFromRef_x86(ref);
 	}
 	else if (_config->architecture.isMipsOrPic32())
 	{
-		return getAddressFromRef_mips(ref);
+		target = getAddressFromRef_mips(d, ref);
 	}
 	else if (_config->architecture.isArm())
 	{
-		return getAddressFromRef_arm(ref);
+		target = getAddressFromRef_arm(d, ref);
 	}
 	else if (_config->architecture.isPpc())
 	{
-		return getAddressFromRef_ppc(ref);
+		target = getAddressFromRef_ppc(d, ref);
 	}
 	else
 	{
 		assert(false);
-		return Address();
 	}
+
+	d.refTargets.emplace(key, target);
+	return target;
 }
 
 common::Address Finder::getAddressFromRef_x86(common::Address ref)
@@ -1085,20 +1174,22 @@ bool isAddInsn_mips(csh ce, cs_insn* i)
  * On MIPS, reference is an instruction that needs to be disassembled and
  * inspected for reference target.
  */
-common::Address Finder::getAddressFromRef_mips(common::Address ref)
+common::Address Finder::getAddressFromRef_mips(
+		Disassembler& d,
+		common::Address ref)
 {
 	uint64_t addr = ref;
 	ByteData data = _image->getRawSegmentData(ref);
-	if (!cs_disasm_iter(_ce, &data.first, &data.second, &addr, _ceInsn))
+	if (!cs_disasm_iter(d.ce, &data.first, &data.second, &addr, d.insn))
 	{
 		return Address();
 	}
-	auto& mips = _ceInsn->detail->mips;
+	auto& mips = d.insn->detail->mips;
 
 	// j target_function
 	// jal target_function
 	//
-	if (isJumpInsn_mips(_ce, _ceInsn)
+	if (isJumpInsn_mips(d.ce, d.insn)
 			&& mips.op_count == 1
 			&& mips.operands[0].type == MIPS_OP_IMM)
 	{
@@ -1107,7 +1198,7 @@ common::Address Finder::getAddressFromRef_mips(common::Address ref)
 	// lui reg, upper
 	// ...
 	//
-	else if (_ceInsn->id == MIPS_INS_LUI
+	else if (d.insn->id == MIPS_INS_LUI
 			&& mips.op_count == 2
 			&& mips.operands[0].type == MIPS_OP_REG
 			&& mips.operands[1].type == MIPS_OP_IMM)
@@ -1116,7 +1207,7 @@ common::Address Finder::getAddressFromRef_mips(common::Address ref)
 		unsigned s = _config->architecture.getBitSize() / 2;
 		uint64_t upper = uint64_t(mips.operands[1].imm) << s;
 
-		if (!cs_disasm_iter(_ce, &data.first, &data.second, &addr, _ceInsn))
+		if (!cs_disasm_iter(d.ce, &data.first, &data.second, &addr, d.insn))
 		{
 			return Address();
 		}
@@ -1126,10 +1217,10 @@ common::Address Finder::getAddressFromRef_mips(common::Address ref)
 		// Maybe, we should check that skipped instruction does not use reg.
 		// Maybe, more than one instruction needs to be skipped.
 		//
-		if (!isLoadStoreInsn_mips(_ce, _ceInsn)
-				&& !isAddInsn_mips(_ce, _ceInsn))
+		if (!isLoadStoreInsn_mips(d.ce, d.insn)
+				&& !isAddInsn_mips(d.ce, d.insn))
 		{
-			if (!cs_disasm_iter(_ce, &data.first, &data.second, &addr, _ceInsn))
+			if (!cs_disasm_iter(d.ce, &data.first, &data.second, &addr, d.insn))
 			{
 				return Address();
 			}
@@ -1143,7 +1234,7 @@ common::Address Finder::getAddressFromRef_mips(common::Address ref)
 		// sw $zero, -0x1f14($at)
 		// ==> 0x891 E0EC
 		//
-		if (isLoadStoreInsn_mips(_ce, _ceInsn)
+		if (isLoadStoreInsn_mips(d.ce, d.insn)
 				&& mips.op_count == 2
 				&& mips.operands[1].type == MIPS_OP_MEM
 				&& mips.operands[1].mem.base == reg)
@@ -1155,7 +1246,7 @@ common::Address Finder::getAddressFromRef_mips(common::Address ref)
 		// addiu $a2, $a2, 0x5ff4
 		// ==> 0x891 5FF4
 		//
-		else if (isAddInsn_mips(_ce, _ceInsn)
+		else if (isAddInsn_mips(d.ce, d.insn)
 				&& mips.op_count == 3
 				&& mips.operands[1].type == MIPS_OP_REG
 				&& mips.operands[1].reg == reg
@@ -1176,7 +1267,9 @@ common::Address Finder::getAddressFromRef_mips(common::Address ref)
  * a word after the function that just needs to be read (it should point
  * somewhere to the loaded image, but that is checked later).
  */
-common::Address Finder::getAddressFromRef_arm(common::Address ref)
+common::Address Finder::getAddressFromRef_arm(
+		Disassembler& d,
+		common::Address ref)
 {
 	std::uint64_t ci = 0;
 	if (_image->getWord(ref, ci))
@@ -1206,13 +1299,13 @@ common::Address Finder::getAddressFromRef_arm(common::Address ref)
 	//
 	uint64_t addr = ref;
 	ByteData data = _image->getRawSegmentData(ref);
-	if (cs_disasm_iter(_ce, &data.first, &data.second, &addr, _ceInsn))
+	if (cs_disasm_iter(d.ce, &data.first, &data.second, &addr, d.insn))
 	{
-		auto& arm = _ceInsn->detail->arm;
+		auto& arm = d.insn->detail->arm;
 
-		bool isBr = cs_insn_group(_ce, _ceInsn, ARM_GRP_JUMP)
-				|| cs_insn_group(_ce, _ceInsn, ARM_GRP_CALL)
-				|| cs_insn_group(_ce, _ceInsn, ARM_GRP_BRANCH_RELATIVE);
+		bool isBr = cs_insn_group(d.ce, d.insn, ARM_GRP_JUMP)
+				|| cs_insn_group(d.ce, d.insn, ARM_GRP_CALL)
+				|| cs_insn_group(d.ce, d.insn, ARM_GRP_BRANCH_RELATIVE);
 
 		if (isBr
 				&& arm.op_count == 1
@@ -1233,7 +1326,7 @@ common::Address Finder::getAddressFromRef_arm(common::Address ref)
 		}
 		// mov pc, lr (return)
 		//
-		else if (_ceInsn->id == ARM_INS_MOV
+		else if (d.insn->id == ARM_INS_MOV
 				&& arm.op_count == 2
 				&& arm.operands[0].type == ARM_OP_REG
 				&& arm.operands[0].reg == ARM_REG_PC
@@ -1254,7 +1347,9 @@ common::Address Finder::getAddressFromRef_arm(common::Address ref)
 	return Address();
 }
 
-common::Address Finder::getAddressFromRef_ppc(common::Address ref)
+common::Address Finder::getAddressFromRef_ppc(
+		Disassembler& d,
+		common::Address ref)
 {
 	std::uint64_t ci = 0;
 	if (_image->getWord(ref, ci))
@@ -1279,11 +1374,11 @@ common::Address Finder::getAddressFromRef_ppc(common::Address ref)
 	//
 	uint64_t addr = ref;
 	ByteData data = _image->getRawSegmentData(ref);
-	if (cs_disasm_iter(_ce, &data.first, &data.second, &addr, _ceInsn))
+	if (cs_disasm_iter(d.ce, &data.first, &data.second, &addr, d.insn))
 	{
-		auto& ppc = _ceInsn->detail->ppc;
+		auto& ppc = d.insn->detail->ppc;
 
-		if (_ceInsn->id == PPC_INS_BL
+		if (d.insn->id == PPC_INS_BL
 				&& ppc.op_count == 1
 				&& ppc.operands[0].type == PPC_OP_IMM)
 		{
@@ -1300,7 +1395,7 @@ common::Address Finder::getAddressFromRef_ppc(common::Address ref)
 	return Address();
 }
 
-void Finder::checkRef(Reference& ref)
+void Finder::checkRef(Disassembler& d, Reference& ref)
 {
 	if (ref.target.isUndefined())
 	{
@@ -1369,7 +1464,7 @@ void Finder::checkRef(Reference& ref)
 	//
 	if (_config->architecture.isX86())
 	{
-		checkRef_x86(ref);
+		checkRef_x86(d, ref);
 	}
 	if (ref.ok)
 	{
@@ -1428,25 +1523,57 @@ void Finder::checkRef(Reference& ref)
 	}
 }
 
-void Finder::checkRef_x86(Reference& ref)
+void Finder::checkRef_x86(Disassembler& d, Reference& ref)
 {
 	if (ref.target.isUndefined())
 	{
 		return;
 	}
 
-	uint64_t addr = ref.target;
-	ByteData bytes = _image->getRawSegmentData(ref.target);
-	if (cs_disasm_iter(_ce, &bytes.first, &bytes.second, &addr, _ceInsn))
+	auto imp = getStubImport_x86(d, ref.target);
+	if (imp.isUndefined())
+	{
+		return;
+	}
+
+	auto fIt = _imports.find(imp);
+	if (fIt != _imports.end())
 	{
-		auto& x86 = _ceInsn->detail->x86;
+		if (utils::contains(fIt->second, ref.name)
+				|| utils::contains(ref.name, fIt->second))
+		{
+			ref.ok = true;
+		}
+	}
+}
+
+/**
+ * @return Address of the import that a stub function on address @a addr jumps
+ * to, or undefined address if there is no such stub on @a addr.
+ */
+common::Address Finder::getStubImport_x86(
+		Disassembler& d,
+		common::Address addr)
+{
+	auto cIt = d.stubImports.find(addr);
+	if (cIt != d.stubImports.end())
+	{
+		return cIt->second;
+	}
+
+	Address imp;
+	uint64_t a = addr;
+	ByteData bytes = _image->getRawSegmentData(addr);
+	if (cs_disasm_iter(d.ce, &bytes.first, &bytes.second, &a, d.insn))
+	{
+		auto& x86 = d.insn->detail->x86;
 
 		// Pattern: reference to stub function jumping to import:
 		//     _localeconv     proc near
 		//     FF 25 E0 B1 40 00        jmp ds:__imp__localeconv
 		//     _localeconv     endp
 		//
-		if (_ceInsn->id == X86_INS_JMP
+		if (d.insn->id == X86_INS_JMP
 				&& x86.op_count == 1
 				&& x86.operands[0].type == X86_OP_MEM
 				&& x86.operands[0].mem.segment == X86_REG_INVALID
@@ -1455,19 +1582,12 @@ void Finder::checkRef_x86(Reference& ref)
 				&& x86.operands[0].mem.scale == 1
 				&& x86.operands[0].mem.disp)
 		{
-			auto fIt = _imports.find(x86.operands[0].mem.disp);
-			if (fIt != _imports.end())
-			{
-				if (utils::contains(fIt->second, ref.name)
-						|| utils::contains(ref.name, fIt->second))
-				{
-					ref.ok = true;
-				}
-
-				return;
-			}
+			imp = x86.operands[0].mem.disp;
 		}
 	}
+
+	d.stubImports.emplace(addr, imp);
+	return imp;
 }
 
 /**
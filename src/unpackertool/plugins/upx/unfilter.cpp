@@ -7,6 +7,11 @@
 #include <memory>
 #include <algorithm>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UNFILTER_USE_SSE2
+#endif
+
 #include "unpackertool/plugins/upx/unfilter.h"
 
 using namespace retdec::utils;
@@ -15,6 +20,134 @@ namespace retdec {
 namespace unpackertool {
 namespace upx {
 
+namespace {
+
+/**
+ * Returns the index of the lowest set bit of the non-zero @c mask.
+ */
+std::uint32_t lowestSetBit(std::uint32_t mask)
+{
+	std::uint32_t index = 0;
+	while ((mask & 1) == 0)
+	{
+		mask >>= 1;
+		++index;
+	}
+	return index;
+}
+
+} // anonymous namespace
+
+/**
+ * Creates the unfilter.
+ *
+ * @param vectorized Whether to skip the data that cannot contain filtered instructions using SIMD.
+ */
+Unfilter::Unfilter(bool vectorized/* = true*/) : _vectorized(vectorized)
+{
+}
+
+/**
+ * Finds the first position which may contain the opcode of a filtered instruction.
+ * The byte @c b at the position satisfies <tt>(b & mask1) == value1 || (b & mask2) == value2</tt>.
+ *
+ * @param data The data being unfiltered.
+ * @param pos Position where to start the search.
+ * @param endPos Position where to end the search.
+ *
+ * @return The found position or @c endPos if there is none. If the unfilter is not
+ * vectorized, @c pos is returned and the caller checks every position itself.
+ */
+std::uint32_t Unfilter::findOpcode(const DynamicBuffer& data, std::uint32_t pos, std::uint32_t endPos, std::uint8_t mask1, std::uint8_t value1, std::uint8_t mask2, std::uint8_t value2) const
+{
+	if (!_vectorized)
+		return pos;
+
+	const std::uint8_t* bytes = data.getRawBuffer();
+
+#ifdef UNFILTER_USE_SSE2
+	const __m128i vMask1 = _mm_set1_epi8(static_cast<char>(mask1));
+	const __m128i vValue1 = _mm_set1_epi8(static_cast<char>(value1));
+	const __m128i vMask2 = _mm_set1_epi8(static_cast<char>(mask2));
+	const __m128i vValue2 = _mm_set1_epi8(static_cast<char>(value2));
+	for (; pos + 16 <= endPos; pos += 16)
+	{
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + pos));
+		__m128i found = _mm_or_si128(
+			_mm_cmpeq_epi8(_mm_and_si128(block, vMask1), vValue1),
+			_mm_cmpeq_epi8(_mm_and_si128(block, vMask2), vValue2));
+		std::uint32_t mask = _mm_movemask_epi8(found);
+		if (mask != 0)
+			return pos + lowestSetBit(mask);
+	}
+#endif
+
+	for (; pos < endPos; ++pos)
+	{
+		if ((bytes[pos] & mask1) == value1 || (bytes[pos] & mask2) == value2)
+			return pos;
+	}
+
+	return endPos;
+}
+
+/**
+ * Finds the first 4-byte instruction which may be filtered. Instructions start at @c pos
+ * and follow each other. The most significant byte @c b of the instruction satisfies
+ * <tt>(b & mask) == value</tt>.
+ *
+ * @param data The data being unfiltered.
+ * @param pos Position of the first instruction.
+ * @param endPos Position where to end the search.
+ *
+ * @return Position of the found instruction or the position after the last
+ * instruction lying entirely before @c endPos. Instructions after it are
+ * not checked. If the unfilter is not vectorized, @c pos is returned.
+ */
+std::uint32_t Unfilter::findInstruction(const DynamicBuffer& data, std::uint32_t pos, std::uint32_t endPos, std::uint8_t mask, std::uint8_t value) const
+{
+	if (!_vectorized)
+		return pos;
+
+	// Offset of the most significant byte in the instruction
+	std::uint32_t msbOffset;
+	switch (data.getEndianness())
+	{
+		case Endianness::LITTLE:
+			msbOffset = 3;
+			break;
+		case Endianness::BIG:
+			msbOffset = 0;
+			break;
+		default:
+			return pos;
+	}
+
+	const std::uint8_t* bytes = data.getRawBuffer();
+
+#ifdef UNFILTER_USE_SSE2
+	const __m128i vMask = _mm_set1_epi8(static_cast<char>(mask));
+	const __m128i vValue = _mm_set1_epi8(static_cast<char>(value));
+	const std::uint32_t msbLanes = 0x1111u << msbOffset;
+	for (; pos + 16 <= endPos; pos += 16)
+	{
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + pos));
+		__m128i found = _mm_cmpeq_epi8(_mm_and_si128(block, vMask), vValue);
+		std::uint32_t lanes = _mm_movemask_epi8(found) & msbLanes;
+		if (lanes != 0)
+			return pos + (lowestSetBit(lanes) & ~3u);
+	}
+#endif
+
+	for (; pos + 4 <= endPos; pos += 4)
+	{
+		if ((bytes[pos + msbOffset] & mask) == value)
+			return pos;
+	}
+
+	return pos;
+}
+
 /**
  * Runs the specified unfiltering on the provided data.
  *
@@ -92,6 +225,11 @@ void Unfilter11::perform(DynamicBuffer& unpackedData, std::uint32_t/* filterPara
 
 	while (readPos < endPos)
 	{
+		// Skip the bytes that are not opcodes of filtered instructions
+		readPos = findOpcode(unpackedData, readPos, endPos, 0xFF, 0xE8, 0xFF, 0xE8);
+		if (readPos >= endPos)
+			break;
+
 		// Read the opcode of an instruction
 		std::uint8_t opcode = unpackedData.read<std::uint8_t>(readPos++);
 
@@ -134,6 +272,11 @@ void Unfilter16::perform(DynamicBuffer& unpackedData, std::uint32_t/* filterPara
 
 	while (readPos < endPos)
 	{
+		// Skip the bytes that are not opcodes of filtered instructions
+		readPos = findOpcode(unpackedData, readPos, endPos, 0xFE, 0xE8, 0xFE, 0xE8);
+		if (readPos >= endPos)
+			break;
+
 		// Read the opcode of an instruction
 		std::uint8_t opcode = unpackedData.read<std::uint8_t>(readPos++);
 
@@ -182,6 +325,11 @@ void Unfilter24::perform(DynamicBuffer& unpackedData, std::uint32_t filterParam,
 
 	while (readPos < endPos)
 	{
+		// Skip the bytes that are not opcodes of filtered instructions
+		readPos = findOpcode(unpackedData, readPos, endPos, 0xFF, 0xE8, 0xFF, 0xE8);
+		if (readPos >= endPos)
+			break;
+
 		// Read the opcode of an instruction
 		std::uint8_t opcode = unpackedData.read<std::uint8_t>(readPos++);
 
@@ -232,6 +380,11 @@ void Unfilter26_46::perform(DynamicBuffer& unpackedData, std::uint32_t filterPar
 
 	while (readPos < endPos)
 	{
+		// Skip the bytes that are not opcodes of filtered instructions
+		readPos = findOpcode(unpackedData, readPos, endPos, 0xFE, 0xE8, 0xFE, 0xE8);
+		if (readPos >= endPos)
+			break;
+
 		// Read the opcode of an instruction
 		std::uint8_t opcode = unpackedData.read<std::uint8_t>(readPos++);
 
@@ -283,6 +436,11 @@ void Unfilter49::perform(DynamicBuffer& unpackedData, std::uint32_t filterParam,
 
 	while (readPos < endPos)
 	{
+		// Skip the bytes that are not opcodes of filtered instructions
+		readPos = findOpcode(unpackedData, readPos, endPos, 0xFE, 0xE8, 0xF0, 0x80);
+		if (readPos >= endPos)
+			break;
+
 		// Read the opcode of an instruction
 		std::uint8_t opcode = unpackedData.read<std::uint8_t>(readPos++);
 
@@ -335,6 +493,11 @@ void Unfilter50::perform(DynamicBuffer& unpackedData, std::uint32_t/* filterPara
 
 	while (readPos < endPos)
 	{
+		// Skip the instructions that are not filtered
+		readPos = findInstruction(unpackedData, readPos, endPos, 0x0F, 0x0B);
+		if (readPos >= endPos)
+			break;
+
 		// Read the instruction
 		std::uint32_t instruction = unpackedData.read<std::uint32_t>(readPos);
 
@@ -378,6 +541,11 @@ void UnfilterD0::perform(DynamicBuffer& unpackedData, std::uint32_t filterParam,
 
 	while (readPos < endPos)
 	{
+		// Skip the instructions that are not filtered
+		readPos = findInstruction(unpackedData, readPos, endPos, 0xFC, 0x48);
+		if (readPos >= endPos)
+			break;
+
 		// Read the instruction
 		std::uint32_t instruction = unpackedData.read<std::uint32_t>(readPos);
 
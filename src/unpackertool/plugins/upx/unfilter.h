@@ -35,14 +35,26 @@ enum Filters
 
 /**
  * Base abstract class for all unfiltering objects.
+ *
+ * Unfilters look for filtered instructions by their opcodes. If @c vectorized
+ * is set, the parts of the data that cannot contain any such instruction are
+ * skipped using SIMD comparisons (when available). Otherwise, every position
+ * is checked one by one. Both ways produce the same results.
  */
 struct Unfilter
 {
+	explicit Unfilter(bool vectorized = true);
 	virtual ~Unfilter() = default;
 
 	virtual void perform(DynamicBuffer& unpackedData, std::uint32_t filterParam, std::uint32_t filterCount, std::uint32_t startOffset, std::uint32_t size) = 0;
 
 	static bool run(DynamicBuffer& unpackedData, std::uint32_t filterId, std::uint32_t filterParam, std::uint32_t filterCount = 0, std::uint32_t startOffset = 0, std::uint32_t size = 0);
+
+protected:
+	std::uint32_t findOpcode(const DynamicBuffer& data, std::uint32_t pos, std::uint32_t endPos, std::uint8_t mask1, std::uint8_t value1, std::uint8_t mask2, std::uint8_t value2) const;
+	std::uint32_t findInstruction(const DynamicBuffer& data, std::uint32_t pos, std::uint32_t endPos, std::uint8_t mask, std::uint8_t value) const;
+
+	bool _vectorized; ///< Whether to skip over data using SIMD.
 };
 
 /**
@@ -50,6 +62,8 @@ struct Unfilter
  */
 struct Unfilter11 : public Unfilter
 {
+	using Unfilter::Unfilter;
+
 	virtual void perform(DynamicBuffer& unpackedData, std::uint32_t filterParam, std::uint32_t filterCount, std::uint32_t startOffset, std::uint32_t size) override;
 };
 
@@ -58,6 +72,8 @@ struct Unfilter11 : public Unfilter
  */
 struct Unfilter16 : public Unfilter
 {
+	using Unfilter::Unfilter;
+
 	virtual void perform(DynamicBuffer& unpackedData, std::uint32_t filterParam, std::uint32_t filterCount, std::uint32_t startOffset, std::uint32_t size) override;
 };
 
@@ -66,6 +82,8 @@ struct Unfilter16 : public Unfilter
  */
 struct Unfilter24 : public Unfilter
 {
+	using Unfilter::Unfilter;
+
 	virtual void perform(DynamicBuffer& unpackedData, std::uint32_t filterParam, std::uint32_t filterCount, std::uint32_t startOffset, std::uint32_t size) override;
 };
 
@@ -74,6 +92,8 @@ struct Unfilter24 : public Unfilter
  */
 struct Unfilter26_46 : public Unfilter
 {
+	using Unfilter::Unfilter;
+
 	virtual void perform(DynamicBuffer& unpackedData, std::uint32_t filterParam, std::uint32_t filterCount, std::uint32_t startOffset, std::uint32_t size) override;
 };
 
@@ -82,6 +102,8 @@ struct Unfilter26_46 : public Unfilter
  */
 struct Unfilter49 : public Unfilter
 {
+	using Unfilter::Unfilter;
+
 	virtual void perform(DynamicBuffer& unpackedData, std::uint32_t filterParam, std::uint32_t filterCount, std::uint32_t startOffset, std::uint32_t size) override;
 };
 
@@ -90,6 +112,8 @@ struct Unfilter49 : public Unfilter
  */
 struct Unfilter50 : public Unfilter
 {
+	using Unfilter::Unfilter;
+
 	virtual void perform(DynamicBuffer& unpackedData, std::uint32_t filterParam, std::uint32_t filterCount, std::uint32_t startOffset, std::uint32_t size) override;
 };
 
@@ -98,6 +122,8 @@ struct Unfilter50 : public Unfilter
  */
 struct UnfilterD0 : public Unfilter
 {
+	using Unfilter::Unfilter;
+
 	virtual void perform(DynamicBuffer& unpackedData, std::uint32_t filterParam, std::uint32_t filterCount, std::uint32_t startOffset, std::uint32_t size) override;
 };
 
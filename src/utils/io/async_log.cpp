@@ -0,0 +1,214 @@
+/**
+* @file src/utils/io/async_log.cpp
+* @brief Asynchronous backend of loggers.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <set>
+
+#include "retdec/utils/io/async_log.h"
+
+namespace retdec {
+namespace utils {
+namespace io {
+
+namespace {
+
+/**
+ * How often the flusher looks for new records when it is idle.
+ */
+const auto FlushPeriod = std::chrono::milliseconds(10);
+
+}
+
+std::atomic<bool> AsyncLogWriter::_running{false};
+
+AsyncLogWriter& AsyncLogWriter::get()
+{
+	static AsyncLogWriter writer;
+	return writer;
+}
+
+AsyncLogWriter::~AsyncLogWriter()
+{
+	stop();
+}
+
+/**
+ * Starts the background flusher. Does nothing if it is already running.
+ */
+void AsyncLogWriter::start()
+{
+	std::lock_guard<std::mutex> lock(_flusherMutex);
+	if (_flusher.joinable())
+		return;
+
+	_stopFlusher = false;
+	_flusher = std::thread(&AsyncLogWriter::flusherLoop, this);
+	_running = true;
+}
+
+/**
+ * Stops the background flusher and writes all remaining records.
+ */
+void AsyncLogWriter::stop()
+{
+	std::thread flusher;
+	{
+		std::lock_guard<std::mutex> lock(_flusherMutex);
+		_running = false;
+		_stopFlusher = true;
+		std::swap(flusher, _flusher);
+	}
+	_flusherCond.notify_all();
+	if (flusher.joinable())
+		flusher.join();
+
+	flush();
+}
+
+/**
+ * Queues @a text to be written into @a out.
+ *
+ * If the ring of the calling thread is full, waits until the flusher makes
+ * space in it.
+ */
+void AsyncLogWriter::write(std::ostream& out, std::string&& text)
+{
+	auto& ring = threadRing();
+	auto tail = ring.tail.load(std::memory_order_relaxed);
+	while (tail - ring.head.load(std::memory_order_acquire) >= Ring::Capacity)
+	{
+		if (!isRunning())
+		{
+			flush();
+			continue;
+		}
+		_flusherCond.notify_one();
+		std::this_thread::yield();
+	}
+
+	auto& record = ring.records[tail % Ring::Capacity];
+	record.seq = _seq.fetch_add(1, std::memory_order_relaxed);
+	record.out = &out;
+	record.text = std::move(text);
+	ring.tail.store(tail + 1, std::memory_order_release);
+
+	// The writer was stopped meanwhile, nobody else would write the record.
+	if (!isRunning())
+		flush();
+}
+
+/**
+ * Writes all queued records in the calling thread and flushes their streams.
+ */
+void AsyncLogWriter::flush()
+{
+	while (drain())
+	{
+	}
+}
+
+/**
+ * Returns the ring of the calling thread, creates it on the first call.
+ */
+AsyncLogWriter::Ring& AsyncLogWriter::threadRing()
+{
+	/**
+	 * Marks the ring as orphaned when its thread exits. The ring itself is
+	 * kept alive by the writer until all its records are written.
+	 */
+	struct Holder {
+		std::shared_ptr<Ring> ring;
+		~Holder() { if (ring) ring->orphaned = true; }
+	};
+	thread_local Holder holder;
+
+	if (!holder.ring)
+	{
+		holder.ring = std::make_shared<Ring>();
+		std::lock_guard<std::mutex> lock(_ringsMutex);
+		_rings.push_back(holder.ring);
+	}
+	return *holder.ring;
+}
+
+/**
+ * Writes all records that are currently in rings.
+ * @return @c true if some records were written, @c false otherwise.
+ */
+bool AsyncLogWriter::drain()
+{
+	std::lock_guard<std::mutex> drainLock(_drainMutex);
+
+	std::vector<std::shared_ptr<Ring>> rings;
+	{
+		std::lock_guard<std::mutex> lock(_ringsMutex);
+		rings = _rings;
+	}
+
+	std::vector<Record> batch;
+	for (auto& ring : rings)
+	{
+		auto head = ring->head.load(std::memory_order_relaxed);
+		auto tail = ring->tail.load(std::memory_order_acquire);
+		for (; head != tail; ++head)
+		{
+			batch.push_back(std::move(ring->records[head % Ring::Capacity]));
+		}
+		ring->head.store(head, std::memory_order_release);
+	}
+
+	if (batch.empty())
+	{
+		std::lock_guard<std::mutex> lock(_ringsMutex);
+		_rings.erase(
+			std::remove_if(_rings.begin(), _rings.end(),
+				[](const auto& r) {
+					return r->orphaned
+						&& r->head.load() == r->tail.load();
+				}),
+			_rings.end());
+		return false;
+	}
+
+	std::sort(batch.begin(), batch.end(),
+		[](const Record& a, const Record& b) { return a.seq < b.seq; });
+
+	std::set<std::ostream*> streams;
+	for (auto& r : batch)
+	{
+		*r.out << r.text;
+		streams.insert(r.out);
+	}
+	for (auto* s : streams)
+	{
+		s->flush();
+	}
+	return true;
+}
+
+/**
+ * Main loop of the background flusher.
+ */
+void AsyncLogWriter::flusherLoop()
+{
+	while (true)
+	{
+		if (drain())
+			continue;
+
+		std::unique_lock<std::mutex> lock(_flusherMutex);
+		if (_stopFlusher)
+			return;
+		_flusherCond.wait_for(lock, FlushPeriod);
+		if (_stopFlusher)
+			return;
+	}
+}
+
+}
+}
+}
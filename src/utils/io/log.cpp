@@ -48,9 +48,34 @@ void Log::set(const Log::Type& lt, Logger::Ptr&& logger)
 	// after Log::Type::Undefined in Log::Type enum.
 	assert(static_cast<int>(lt) <= static_cast<int>(Log::Type::Undefined));
 
+	// Queued records may refer to the stream of the replaced logger.
+	flush();
 	writers[static_cast<int>(lt)] = std::move(logger);
 }
 
+bool Log::isEnabled(const Log::Type& lt)
+{
+	return get(lt).isVerbose();
+}
+
+void Log::setAsync(bool async)
+{
+	Logger::setAsync(async);
+}
+
+void Log::flush()
+{
+	if (Logger::isAsync()) {
+		AsyncLogWriter::get().flush();
+		return;
+	}
+
+	for (auto& writer : writers)
+		if (writer)
+			writer->flush();
+	defaultLogger.flush();
+}
+
 Logger Log::info()
 {
 	return get(Log::Type::Info);
@@ -7,6 +7,8 @@
 #include <iomanip>
 #include <map>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 #include "retdec/utils/io/logger.h"
 #include "retdec/utils/os.h"
@@ -70,6 +72,57 @@ Logger::~Logger()
 {
 	if (_currentBrush != Color::Default)
 		*this << Color::Default;
+
+	if (isAsync())
+		commit();
+}
+
+/**
+ * Flushes the output stream. In the asynchronous mode, the records are
+ * written by the background writer, so use Log::flush() instead.
+ */
+void Logger::flush()
+{
+	if (!isAsync())
+		_out.flush();
+}
+
+void Logger::setAsync(bool async)
+{
+	if (async)
+		AsyncLogWriter::get().start();
+	else
+		AsyncLogWriter::get().stop();
+}
+
+std::ostringstream& Logger::pending()
+{
+	// Records are formatted per thread and per output stream so that
+	// loggers used by different threads do not mix their records.
+	thread_local std::vector<
+		std::pair<std::ostream*, std::unique_ptr<std::ostringstream>>> buffers;
+
+	for (auto& b : buffers) {
+		if (b.first == &_out)
+			return *b.second;
+	}
+
+	buffers.emplace_back(&_out, std::make_unique<std::ostringstream>());
+	return *buffers.back().second;
+}
+
+/**
+ * Passes the record formatted by the current thread to the asynchronous
+ * writer.
+ */
+void Logger::commit()
+{
+	auto& buffer = pending();
+	if (buffer.tellp() == 0)
+		return;
+
+	AsyncLogWriter::get().write(_out, buffer.str());
+	buffer.str("");
 }
 
 Logger& Logger::operator << (const Action& p)
@@ -155,6 +208,15 @@ FileLogger::FileLogger(const std::string& file, bool verbose):
 		throw std::runtime_error("unable to open file \""+file+"\" for writing.");
 }
 
+FileLogger::~FileLogger()
+{
+	// Queued records must be written before the file is closed.
+	if (isAsync()) {
+		commit();
+		AsyncLogWriter::get().flush();
+	}
+}
+
 }
 }
 }
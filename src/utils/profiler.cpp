@@ -0,0 +1,327 @@
+/**
+* @file src/utils/profiler.cpp
+* @brief Implementation of the instrumentation of decompilation phases.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+#include "retdec/utils/profiler.h"
+
+namespace retdec {
+namespace utils {
+
+namespace {
+
+/**
+* @brief Returns a small number identifying the current thread.
+*/
+std::uint32_t currentThreadNumber() {
+	static std::atomic<std::uint32_t> nextNumber{0};
+	thread_local std::uint32_t number = nextNumber++;
+	return number;
+}
+
+std::uint64_t toNs(Profiler::Clock::duration d) {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+}
+
+/**
+* @brief Writes @a str as a JSON string literal.
+*/
+void writeJsonString(std::ostream &out, const std::string &str) {
+	out << '"';
+	for (unsigned char c : str) {
+		switch (c) {
+			case '"': out << "\\\""; break;
+			case '\\': out << "\\\\"; break;
+			case '\n': out << "\\n"; break;
+			case '\t': out << "\\t"; break;
+			default:
+				if (c < 0x20) {
+					out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+						<< static_cast<unsigned>(c) << std::dec;
+				} else {
+					out << c;
+				}
+		}
+	}
+	out << '"';
+}
+
+/**
+* @brief Writes @a ns nanoseconds as seconds.
+*/
+void writeSeconds(std::ostream &out, std::uint64_t ns) {
+	out << std::fixed << std::setprecision(6) << ns / 1e9;
+}
+
+/**
+* @brief Writes @a ns nanoseconds as microseconds (unit of the Chrome trace).
+*/
+void writeMicroseconds(std::ostream &out, std::uint64_t ns) {
+	out << std::fixed << std::setprecision(3) << ns / 1e3;
+}
+
+} // anonymous namespace
+
+//
+//==============================================================================
+// Profiler
+//==============================================================================
+//
+
+Profiler::Profiler(): startTime(Clock::now()) {}
+
+/**
+* @brief Returns the profiler of the process.
+*/
+Profiler &Profiler::get() {
+	static Profiler profiler;
+	return profiler;
+}
+
+/**
+* @brief Records one execution of scope @a name.
+*/
+void Profiler::record(const std::string &name, Clock::time_point begin,
+		Clock::time_point end) {
+	auto duration = toNs(end - begin);
+	bool trace = isTraceEnabled();
+	auto thread = trace ? currentThreadNumber() : 0;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	auto &stats = scopes[name];
+	++stats.calls;
+	stats.totalNs += duration;
+	stats.maxNs = std::max(stats.maxNs, duration);
+	if (trace) {
+		auto beginNs = begin > startTime ? toNs(begin - startTime) : 0;
+		events.push_back(Event{name, beginNs, duration, thread});
+	}
+}
+
+/**
+* @brief Returns counter @a name, creates it if it does not exist.
+*
+* The returned reference stays valid, so hot code may look the counter up
+* once and then only increment it.
+*/
+std::atomic<std::uint64_t> &Profiler::counter(const std::string &name) {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto &c = counters[name];
+	if (!c) {
+		c = std::make_unique<std::atomic<std::uint64_t>>(0);
+	}
+	return *c;
+}
+
+/**
+* @brief Adds @a value to counter @a name.
+*/
+void Profiler::addToCounter(const std::string &name, std::uint64_t value) {
+	counter(name).fetch_add(value, std::memory_order_relaxed);
+}
+
+/**
+* @brief Enables/disables keeping of individual scope executions.
+*/
+void Profiler::setTraceEnabled(bool enabled) {
+	traceEnabled = enabled;
+}
+
+bool Profiler::isTraceEnabled() const {
+	return traceEnabled.load(std::memory_order_relaxed);
+}
+
+/**
+* @brief Drops all recorded data (counters are set to zero).
+*/
+void Profiler::reset() {
+	std::lock_guard<std::mutex> lock(mutex);
+	scopes.clear();
+	events.clear();
+	for (auto &c : counters) {
+		*c.second = 0;
+	}
+	startTime = Clock::now();
+}
+
+/**
+* @brief Returns aggregated times of all scopes.
+*/
+std::map<std::string, Profiler::ScopeStats> Profiler::getScopeStats() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return scopes;
+}
+
+/**
+* @brief Returns value of counter @a name (0 if it does not exist).
+*/
+std::uint64_t Profiler::getCounter(const std::string &name) const {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = counters.find(name);
+	return it != counters.end() ? it->second->load() : 0;
+}
+
+/**
+* @brief Writes aggregated metrics of the run in JSON.
+*
+* Format:
+* @code
+* {
+*     "wallTime": 1.5,
+*     "scopes": {"name": {"calls": 1, "totalTime": 1.2, "maxTime": 1.2}},
+*     "counters": {"name": 42}
+* }
+* @endcode
+* Times are in seconds.
+*/
+void Profiler::writeMetrics(std::ostream &out) const {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	out << "{\n\t\"wallTime\": ";
+	writeSeconds(out, toNs(Clock::now() - startTime));
+
+	out << ",\n\t\"scopes\": {";
+	bool first = true;
+	for (auto &s : scopes) {
+		out << (first ? "\n\t\t" : ",\n\t\t");
+		writeJsonString(out, s.first);
+		out << ": {\"calls\": " << s.second.calls << ", \"totalTime\": ";
+		writeSeconds(out, s.second.totalNs);
+		out << ", \"maxTime\": ";
+		writeSeconds(out, s.second.maxNs);
+		out << "}";
+		first = false;
+	}
+	out << (first ? "}" : "\n\t}");
+
+	out << ",\n\t\"counters\": {";
+	first = true;
+	for (auto &c : counters) {
+		out << (first ? "\n\t\t" : ",\n\t\t");
+		writeJsonString(out, c.first);
+		out << ": " << c.second->load();
+		first = false;
+	}
+	out << (first ? "}" : "\n\t}");
+	out << "\n}\n";
+}
+
+/**
+* @brief Writes recorded scope executions in the Chrome trace event format.
+*
+* The output can be loaded into @c chrome://tracing or Perfetto. Only scopes
+* executed while tracing was enabled are written; final values of counters
+* are written as counter events.
+*/
+void Profiler::writeChromeTrace(std::ostream &out) const {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	out << "{\"traceEvents\": [";
+	bool first = true;
+	std::uint64_t lastNs = 0;
+	for (auto &e : events) {
+		out << (first ? "\n" : ",\n");
+		out << "{\"name\": ";
+		writeJsonString(out, e.name);
+		out << ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << e.thread << ", \"ts\": ";
+		writeMicroseconds(out, e.beginNs);
+		out << ", \"dur\": ";
+		writeMicroseconds(out, e.durationNs);
+		out << "}";
+		lastNs = std::max(lastNs, e.beginNs + e.durationNs);
+		first = false;
+	}
+	for (auto &c : counters) {
+		out << (first ? "\n" : ",\n");
+		out << "{\"name\": ";
+		writeJsonString(out, c.first);
+		out << ", \"ph\": \"C\", \"pid\": 1, \"tid\": 0, \"ts\": ";
+		writeMicroseconds(out, lastNs);
+		out << ", \"args\": {\"value\": " << c.second->load() << "}}";
+		first = false;
+	}
+	out << "\n]}\n";
+}
+
+/**
+* @brief Writes metrics (see writeMetrics()) into file @a path.
+*
+* @return @c true if the file was written, @c false otherwise.
+*/
+bool Profiler::writeMetricsFile(const std::string &path) const {
+	std::ofstream out(path);
+	if (!out) {
+		return false;
+	}
+	writeMetrics(out);
+	return static_cast<bool>(out);
+}
+
+/**
+* @brief Writes the Chrome trace (see writeChromeTrace()) into file @a path.
+*
+* @return @c true if the file was written, @c false otherwise.
+*/
+bool Profiler::writeChromeTraceFile(const std::string &path) const {
+	std::ofstream out(path);
+	if (!out) {
+		return false;
+	}
+	writeChromeTrace(out);
+	return static_cast<bool>(out);
+}
+
+//
+//==============================================================================
+// ProfileScope
+//==============================================================================
+//
+
+ProfileScope::ProfileScope(std::string name):
+	name(std::move(name)), begin(Profiler::Clock::now()) {}
+
+ProfileScope::~ProfileScope() {
+	Profiler::get().record(name, begin, Profiler::Clock::now());
+}
+
+//
+//==============================================================================
+// ProfilePhases
+//==============================================================================
+//
+
+ProfilePhases::ProfilePhases(std::string prefix): prefix(std::move(prefix)) {}
+
+ProfilePhases::~ProfilePhases() {
+	end();
+}
+
+/**
+* @brief Ends the current phase (if any) and starts phase @a phase.
+*/
+void ProfilePhases::next(const std::string &phase) {
+	auto now = Profiler::Clock::now();
+	if (!current.empty()) {
+		Profiler::get().record(current, begin, now);
+	}
+	current = prefix + "/" + phase;
+	begin = now;
+}
+
+/**
+* @brief Ends the current phase (if any).
+*/
+void ProfilePhases::end() {
+	if (!current.empty()) {
+		Profiler::get().record(current, begin, Profiler::Clock::now());
+		current.clear();
+	}
+}
+
+} // namespace utils
+} // namespace retdec
@@ -4,6 +4,11 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "retdec/utils/io/log.h"
 #include "retdec/utils/os.h"
 #include "retdec/utils/system.h"
 
@@ -29,5 +34,28 @@ bool systemHasLongDouble() {
 	return sizeof(long double) >= 10;
 }
 
+/**
+* @brief Flushes all outputs and terminates the process with @a status without
+*        any teardown.
+*
+* Destructors of local and static objects and @c atexit() handlers are not run,
+* so huge data structures (e.g. the decompiled module) are not deallocated one
+* node after another; the operating system reclaims the whole memory at once.
+*
+* Logs, standard streams and C streams are flushed. Other outputs (files)
+* have to be closed or flushed by the caller.
+*/
+void exitWithoutTeardown(int status) {
+	// Stop the asynchronous log writer so that all records are written and
+	// no thread writes into the logged streams while they are flushed.
+	io::Log::setAsync(false);
+	io::Log::flush();
+	std::cout.flush();
+	std::cerr.flush();
+	std::clog.flush();
+	std::fflush(nullptr);
+	std::_Exit(status);
+}
+
 } // namespace utils
 } // namespace retdec
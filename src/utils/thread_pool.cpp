@@ -0,0 +1,414 @@
+/**
+* @file src/utils/thread_pool.cpp
+* @brief Implementation of the work-stealing thread pool.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+#include "retdec/utils/thread_pool.h"
+
+namespace retdec {
+namespace utils {
+
+namespace {
+
+/// Index meaning "the current thread is not a worker of the pool".
+const std::size_t NotWorker = std::numeric_limits<std::size_t>::max();
+
+/// Pool whose worker is the current thread (if any).
+thread_local ThreadPool *currentPool = nullptr;
+
+/// Index of the current thread in @c currentPool.
+thread_local std::size_t currentIndex = NotWorker;
+
+} // anonymous namespace
+
+//
+//==============================================================================
+// CancellationToken
+//==============================================================================
+//
+
+CancellationToken::CancellationToken():
+	cancelled(std::make_shared<std::atomic<bool>>(false)) {}
+
+/**
+* @brief Cancels the token and all its copies.
+*/
+void CancellationToken::cancel() const {
+	cancelled->store(true, std::memory_order_relaxed);
+}
+
+/**
+* @brief Returns @c true if the token was cancelled, @c false otherwise.
+*/
+bool CancellationToken::isCancelled() const {
+	return cancelled->load(std::memory_order_relaxed);
+}
+
+//
+//==============================================================================
+// ThreadPool
+//==============================================================================
+//
+
+std::atomic<std::size_t> ThreadPool::maxConcurrency{0};
+
+/**
+* @brief Creates a pool with the given number of worker threads.
+*
+* If @a threads is zero, submitted tasks are executed directly by the
+* submitting thread.
+*/
+ThreadPool::ThreadPool(std::size_t threads) {
+	for (std::size_t i = 0; i < std::max<std::size_t>(threads, 1); ++i) {
+		queues.push_back(std::make_unique<Queue>());
+	}
+	for (std::size_t i = 0; i < threads; ++i) {
+		workers.emplace_back(&ThreadPool::workerLoop, this, i);
+	}
+}
+
+/**
+* @brief Executes all remaining tasks and joins the workers.
+*/
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	sleepCond.notify_all();
+	for (auto &w : workers) {
+		w.join();
+	}
+}
+
+/**
+* @brief Returns the number of worker threads.
+*/
+std::size_t ThreadPool::getNumberOfThreads() const {
+	return workers.size();
+}
+
+/**
+* @brief Schedules @a task for execution.
+*
+* The task must not throw; use TaskGroup to propagate exceptions.
+*/
+void ThreadPool::submit(Task task) {
+	if (workers.empty()) {
+		task();
+		return;
+	}
+
+	auto q = currentPool == this
+		? currentIndex
+		: nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+	{
+		std::lock_guard<std::mutex> lock(queues[q]->mutex);
+		queues[q]->tasks.push_back(std::move(task));
+	}
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		++pending;
+	}
+	sleepCond.notify_one();
+}
+
+/**
+* @brief Executes one pending task in the calling thread.
+*
+* @return @c true if a task was executed, @c false if there was none.
+*
+* Used by threads waiting for their tasks so that they do not block workers.
+*/
+bool ThreadPool::runPendingTask() {
+	Task task;
+	if (!popTask(currentPool == this ? currentIndex : NotWorker, task)) {
+		return false;
+	}
+	task();
+	return true;
+}
+
+/**
+* @brief Takes a task from the own queue of worker @a self or steals one.
+*/
+bool ThreadPool::popTask(std::size_t self, Task &task) {
+	if (pending.load() == 0) {
+		return false;
+	}
+
+	if (self != NotWorker) {
+		auto &q = *queues[self];
+		std::lock_guard<std::mutex> lock(q.mutex);
+		if (!q.tasks.empty()) {
+			task = std::move(q.tasks.back());
+			q.tasks.pop_back();
+			--pending;
+			return true;
+		}
+	}
+
+	auto start = self == NotWorker ? 0 : self + 1;
+	for (std::size_t i = 0; i < queues.size(); ++i) {
+		auto &q = *queues[(start + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(q.mutex);
+		if (!q.tasks.empty()) {
+			task = std::move(q.tasks.front());
+			q.tasks.pop_front();
+			--pending;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+* @brief Main loop of worker @a index.
+*/
+void ThreadPool::workerLoop(std::size_t index) {
+	currentPool = this;
+	currentIndex = index;
+
+	while (true) {
+		Task task;
+		if (popTask(index, task)) {
+			task();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		sleepCond.wait(lock, [this]() { return stopping || pending > 0; });
+		if (stopping && pending == 0) {
+			return;
+		}
+	}
+}
+
+/**
+* @brief Returns the pool shared by all components.
+*
+* The pool is created on the first call with <tt>getMaxConcurrency() - 1</tt>
+* workers (the thread waiting for the results executes tasks as well).
+*/
+ThreadPool &ThreadPool::global() {
+	static ThreadPool pool(getMaxConcurrency() - 1);
+	return pool;
+}
+
+/**
+* @brief Limits the number of threads running tasks concurrently.
+*
+* @param[in] n Maximal number of threads, 0 means the number of hardware
+*              threads.
+*
+* The size of the global pool is decided when it is first used, so the limit
+* should be set at startup. Later changes are still honoured by parallelFor(),
+* which never splits the work among more threads than the limit allows.
+*/
+void ThreadPool::setMaxConcurrency(std::size_t n) {
+	maxConcurrency = n;
+}
+
+/**
+* @brief Returns the maximal number of concurrently running threads.
+*/
+std::size_t ThreadPool::getMaxConcurrency() {
+	if (auto n = maxConcurrency.load()) {
+		return n;
+	}
+	return std::max(1u, std::thread::hardware_concurrency());
+}
+
+//
+//==============================================================================
+// TaskGroup
+//==============================================================================
+//
+
+TaskGroup::TaskGroup(ThreadPool &pool, CancellationToken token):
+	pool(pool), token(std::move(token)), state(std::make_shared<State>()) {}
+
+/**
+* @brief Waits for all tasks; exceptions thrown by them are dropped.
+*/
+TaskGroup::~TaskGroup() {
+	try {
+		wait();
+	} catch (...) {
+	}
+}
+
+/**
+* @brief Runs @a task in the pool as a part of this group.
+*
+* The task is skipped if the group is cancelled before it starts.
+*/
+void TaskGroup::run(ThreadPool::Task task) {
+	{
+		std::lock_guard<std::mutex> lock(state->mutex);
+		++state->unfinished;
+	}
+
+	pool.submit([state = state, token = token, task = std::move(task)]() {
+		std::exception_ptr exception;
+		if (!token.isCancelled()) {
+			try {
+				task();
+			} catch (...) {
+				exception = std::current_exception();
+				token.cancel();
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(state->mutex);
+		if (exception && !state->exception) {
+			state->exception = exception;
+		}
+		if (--state->unfinished == 0) {
+			state->cond.notify_all();
+		}
+	});
+}
+
+/**
+* @brief Waits until all tasks of the group finish.
+*
+* Rethrows the first exception thrown by a task of the group.
+*/
+void TaskGroup::wait() {
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(state->mutex);
+			if (state->unfinished == 0) {
+				break;
+			}
+		}
+
+		if (!pool.runPendingTask()) {
+			// Our tasks are being executed by other threads. Sleep only for
+			// a while because the tasks may submit more work we can help with.
+			std::unique_lock<std::mutex> lock(state->mutex);
+			state->cond.wait_for(lock, std::chrono::milliseconds(1),
+				[this]() { return state->unfinished == 0; });
+		}
+	}
+
+	std::exception_ptr exception;
+	{
+		std::lock_guard<std::mutex> lock(state->mutex);
+		std::swap(exception, state->exception);
+	}
+	if (exception) {
+		std::rethrow_exception(exception);
+	}
+}
+
+/**
+* @brief Cancels tasks of the group that have not started yet.
+*/
+void TaskGroup::cancel() {
+	token.cancel();
+}
+
+/**
+* @brief Returns @c true if the group was cancelled, @c false otherwise.
+*/
+bool TaskGroup::isCancelled() const {
+	return token.isCancelled();
+}
+
+/**
+* @brief Returns the token cancelling the group.
+*
+* Tasks may check it to finish early.
+*/
+const CancellationToken &TaskGroup::getCancellationToken() const {
+	return token;
+}
+
+//
+//==============================================================================
+// Parallel loops
+//==============================================================================
+//
+
+/**
+* @brief Splits <tt>[begin, end)</tt> into chunks and calls @a fnc for each
+*        chunk in parallel.
+*
+* @param[in] begin First index.
+* @param[in] end Index after the last one.
+* @param[in] fnc Function called with the first index and the index after the
+*                last one of each chunk. It has to be thread-safe.
+* @param[in] token Once cancelled, no more chunks are started.
+* @param[in] grain Size of chunks (0 = chosen automatically).
+*
+* The first exception thrown from @a fnc is rethrown.
+*/
+void parallelForRanges(std::size_t begin, std::size_t end,
+		const std::function<void(std::size_t, std::size_t)> &fnc,
+		const CancellationToken &token,
+		std::size_t grain) {
+	if (begin >= end || token.isCancelled()) {
+		return;
+	}
+
+	auto &pool = ThreadPool::global();
+	auto threads = std::min(ThreadPool::getMaxConcurrency(),
+		pool.getNumberOfThreads() + 1);
+	auto count = end - begin;
+	if (grain == 0) {
+		// A few chunks per thread balance the load if chunks take different
+		// amounts of time.
+		grain = std::max<std::size_t>(1, count / (threads * 4));
+	}
+	auto chunks = (count + grain - 1) / grain;
+	if (threads <= 1 || chunks == 1) {
+		for (auto b = begin; b < end && !token.isCancelled(); b += grain) {
+			fnc(b, std::min(end, b + grain));
+		}
+		return;
+	}
+
+	// The calling thread helps while waiting, so the number of chunks
+	// executed at once never exceeds the concurrency limit.
+	// The group has its own token so that a failure does not cancel the
+	// caller's token.
+	TaskGroup group(pool);
+	std::atomic<std::size_t> nextChunk{0};
+	auto runChunks = [&]() {
+		for (auto c = nextChunk++; c < chunks; c = nextChunk++) {
+			if (token.isCancelled() || group.isCancelled()) {
+				return;
+			}
+			auto b = begin + c * grain;
+			fnc(b, std::min(end, b + grain));
+		}
+	};
+
+	for (std::size_t t = 1; t < std::min(threads, chunks); ++t) {
+		group.run(runChunks);
+	}
+	try {
+		runChunks();
+	} catch (...) {
+		// Chunks that are already running refer to locals of this
+		// function, so they have to finish before the exception leaves it.
+		group.cancel();
+		try {
+			group.wait();
+		} catch (...) {
+		}
+		throw;
+	}
+	group.wait();
+}
+
+} // namespace utils
+} // namespace retdec
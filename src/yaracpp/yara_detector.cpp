@@ -286,6 +286,7 @@ bool YaraDetector::addRules(const char *string)
 	const auto result = yr_compiler_add_string(compiler, string, nullptr);
 
 	needsRecompilation = (result == 0);
+	hasTextRules = hasTextRules || needsRecompilation;
 	return needsRecompilation;
 }
 
@@ -323,6 +324,7 @@ bool YaraDetector::addRuleFile(
 
 		files.push_back(file);
 		needsRecompilation = true;
+		hasTextRules = true;
 	}
 
 	return true;
@@ -337,6 +339,37 @@ bool YaraDetector::isInValidState() const
 	return stateIsValid;
 }
 
+/**
+ * Compile all text rules added so far, so that the instance can be used
+ * for const (and thus thread-safe) scanning.
+ * @return @c true if rules were successfully compiled, @c false otherwise.
+ *
+ * If only precompiled rules were added, there is nothing to compile and
+ * the instance is ready for scanning.
+ */
+bool YaraDetector::compileRules()
+{
+	if (!hasTextRules)
+	{
+		needsRecompilation = false;
+		return !precompiledRules.empty();
+	}
+
+	return getCompiledRules() != nullptr;
+}
+
+/**
+ * Get maximal number of scans that may run concurrently
+ * @return Maximal number of threads scanning by the same compiled rules
+ *
+ * YARA refuses to scan by rules which are already used by this number of
+ * threads, so concurrent callers of analyze() must not exceed it.
+ */
+std::size_t YaraDetector::getMaxConcurrentScans()
+{
+	return YR_MAX_THREADS;
+}
+
 /**
  * Analyze input file
  * @param pathToInputFile Path to input file
@@ -363,6 +396,49 @@ bool YaraDetector::analyze(std::vector<std::uint8_t> &bytes, bool storeAllRules)
 	return analyzeWithScan(bytes, storeAllRules);
 }
 
+/**
+ * Analyze input memory buffer and store detected rules into the given
+ * container instead of into this instance.
+ * @param bytes Pointer to the buffer to analyze
+ * @param size Size of the buffer
+ * @param detected Into this container detected rules will be appended
+ * @return @c true if analysis completed without any error, otherwise @c false.
+ *
+ * Rules must have been compiled by compileRules() beforehand. This method
+ * does not modify the detector, so it can be called concurrently from
+ * multiple threads.
+ */
+bool YaraDetector::analyze(
+		const std::uint8_t *bytes,
+		std::size_t size,
+		std::vector<YaraRule> &detected) const
+{
+	std::vector<YaraRule> undetected;
+	auto settings = CallbackSettings(false, detected, undetected);
+	return analyzeMemory(bytes, size, settings);
+}
+
+/**
+ * Analyze input memory buffer and store all rules into the given containers
+ * instead of into this instance.
+ * @param bytes Pointer to the buffer to analyze
+ * @param size Size of the buffer
+ * @param detected Into this container detected rules will be appended
+ * @param undetected Into this container undetected rules will be appended
+ * @return @c true if analysis completed without any error, otherwise @c false.
+ *
+ * The same as the previous method, but undetected rules are stored as well.
+ */
+bool YaraDetector::analyze(
+		const std::uint8_t *bytes,
+		std::size_t size,
+		std::vector<YaraRule> &detected,
+		std::vector<YaraRule> &undetected) const
+{
+	auto settings = CallbackSettings(true, detected, undetected);
+	return analyzeMemory(bytes, size, settings);
+}
+
 /**
  * Get detected rules
  * @return Detected rules
@@ -413,6 +489,50 @@ bool YaraDetector::analyzeWithScan(T&& value, bool storeAllRules)
 	return true;
 }
 
+/**
+ * Scan memory buffer by all compiled rules
+ * @param bytes Pointer to the buffer to analyze
+ * @param size Size of the buffer
+ * @param settings Settings for callback function
+ * @return @c true if analysis completed without any error, otherwise @c false.
+ */
+bool YaraDetector::analyzeMemory(
+		const std::uint8_t *bytes,
+		std::size_t size,
+		CallbackSettings &settings) const
+{
+	if (needsRecompilation)
+		return false;
+
+	std::vector<YR_RULES*> allRules;
+	if (textFilesRules)
+		allRules.push_back(textFilesRules);
+	allRules.insert(
+			allRules.end(),
+			precompiledRules.begin(),
+			precompiledRules.end()
+	);
+	if (allRules.empty())
+		return false;
+
+	for (auto* rules : allRules)
+	{
+		if (yr_rules_scan_mem(
+				rules,
+				const_cast<std::uint8_t*>(bytes),
+				size,
+				0,
+				yaraCallback,
+				&settings,
+				0) != ERROR_SUCCESS)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 /**
  * Returns the compiled rules from text files.
  * @return Compiled rules.
@@ -8,6 +8,7 @@ import sys
 import hashlib
 import os
 import shutil
+import subprocess
 import tarfile
 import urllib.request
 
@@ -15,17 +16,32 @@ def cleanup(support_dir):
     shutil.rmtree(support_dir, ignore_errors=True)
 
 
+def write_prefilter_indexes(support_dir, pat2yara):
+    """Write prefilter indexes for all static code signature files that are
+    not compiled. install-yara.py keeps them valid when compiling the files.
+    The indexes are written by retdec-pat2yara, see src/stacofin/prefilter.cpp.
+    """
+    static_code_dir = os.path.join(support_dir, 'generic', 'yara_patterns', 'static-code')
+    for root, dirnames, filenames in os.walk(static_code_dir):
+        for filename in filenames:
+            if filename.endswith('.yara'):
+                yara_path = os.path.join(root, filename)
+                ret = subprocess.call([pat2yara, '--prefilter-only', yara_path])
+                if ret != 0:
+                    raise OSError('retdec-pat2yara failed for ' + yara_path)
+
+
 def get_args(argv):
-    if len(argv) != 5:
+    if len(argv) not in (5, 6):
         print('ERROR: Unexpected number of arguments.')
-        print('       Expecting tuple: (install path, URL, SHA256, version).')
+        print('       Expecting tuple: (install path, URL, SHA256, version[, pat2yara path]).')
         sys.exit(1)
     else:
-        return (argv[1], argv[2], argv[3], argv[4])
+        return (argv[1], argv[2], argv[3], argv[4], argv[5] if len(argv) == 6 else None)
 
 
 def main():
-    install_path, arch_url, sha256hash_ref, version = get_args(sys.argv)
+    install_path, arch_url, sha256hash_ref, version, pat2yara = get_args(sys.argv)
     support_dir = os.path.join(install_path, 'share', 'retdec', 'support')
     arch_path = os.path.join(support_dir, 'retdec-support.tar.xz')
 
@@ -85,6 +101,17 @@ def main():
     # Remove archive.
     os.remove(arch_path)
 
+    # Index static code signatures so that stacofin can skip files that
+    # cannot match the input.
+    if pat2yara:
+        print('Writing prefilter indexes ...')
+        try:
+            write_prefilter_indexes(support_dir, pat2yara)
+        except OSError as ex:
+            print('ERROR: failed to write prefilter indexes', ex)
+            cleanup(support_dir)
+            sys.exit(1)
+
     print('RetDec support directory downloaded OK')
     sys.exit(0)
 
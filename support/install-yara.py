@@ -1,11 +1,12 @@
 #!/usr/bin/env python3
 
 """Install all the *.yara files.
-Usage: install-yara.py yarac-path install-path yara-patterns-path compile
+Usage: install-yara.py yarac-path install-path yara-patterns-path compile [pat2yara-path]
     yarac-path         Path to the yarac binary to use for YARA rules compilation.
     install-path       Path to the installation directory where to place the results.
     yara-patterns-path Path to the source YARA patterns directory from where to copy (and compile) YARA rules.
     compile            Flag (0|1, ON|OFF, True|False) determining if the YARA rules are to be compiled.
+    pat2yara-path      Path to the retdec-pat2yara binary to use for prefilter indexes of compiled rules.
 """
 
 import fnmatch
@@ -19,14 +20,16 @@ import threading
 
 
 def print_help():
-    print('Usage: %s yarac-path install-path yara-patterns-path compile' % sys.argv[0])
+    print('Usage: %s yarac-path install-path yara-patterns-path compile [pat2yara-path]' % sys.argv[0])
 
 
 def get_arguments():
-    if len(sys.argv) != 5:
+    if len(sys.argv) not in (5, 6):
         print_help()
         sys.exit(1)
-    return sys.argv[1], sys.argv[2], sys.argv[3], (sys.argv[4] == '1' or sys.argv[4].lower() == 'true' or sys.argv[4].lower() == 'on')
+    return (sys.argv[1], sys.argv[2], sys.argv[3],
+            (sys.argv[4] == '1' or sys.argv[4].lower() == 'true' or sys.argv[4].lower() == 'on'),
+            sys.argv[5] if len(sys.argv) == 6 else None)
 
 
 def print_arguments(yarac, install_dir, yara_patterns_dir, compile):
@@ -61,7 +64,21 @@ def copy_yara_patterns(yara_patterns_dir, install_dir):
                 shutil.copy(input, output)
 
 
-def compile_yara_file(input_file, yarac, install_dir, stdout_lock):
+def update_prefilter_index(input_file, output_file, pat2yara):
+    """ Rewrite the prefilter index of the given .yara file (if any) so that
+    it is bound to the given compiled .yarac file. Both files share the index.
+    The index is removed if it cannot be rewritten.
+    """
+    index_file = pathlib.Path(input_file).with_suffix('.prefilter')
+    if not index_file.is_file():
+        return
+
+    if (not pat2yara
+            or subprocess.call([pat2yara, '--prefilter-only', input_file, '-o', output_file]) != 0):
+        index_file.unlink()
+
+
+def compile_yara_file(input_file, yarac, pat2yara, install_dir, stdout_lock):
     """ Compile the given .yara file in the given installation directory using
     the provided YARAC program into a *.yarac file.
     Remove the source *.yara file.
@@ -76,10 +93,11 @@ def compile_yara_file(input_file, yarac, install_dir, stdout_lock):
         print('Error: yarac failed during compilation of file', input_file, file=sys.stderr)
         sys.exit(1)
 
+    update_prefilter_index(input_file, output_file, pat2yara)
     os.remove(input_file)
 
 
-def compile_yara_files(yarac, install_dir):
+def compile_yara_files(yarac, pat2yara, install_dir):
     """ Compile all *.yara files in the given installation directory using the
     provided YARAC program into *.yarac files.
     Remove the source *.yara files.
@@ -95,17 +113,17 @@ def compile_yara_files(yarac, install_dir):
     stdout_lock = threading.Lock()
     with multiprocessing.pool.ThreadPool() as pool:
         args = [
-            (input_file, yarac, install_dir, stdout_lock) for input_file in inputs
+            (input_file, yarac, pat2yara, install_dir, stdout_lock) for input_file in inputs
         ]
         pool.starmap(compile_yara_file, args)
 
 
 def main():
-    yarac, install_dir, yara_patterns_dir, compile = get_arguments()
+    yarac, install_dir, yara_patterns_dir, compile, pat2yara = get_arguments()
     copy_yara_patterns(yara_patterns_dir, install_dir)
 
     if compile:
-        compile_yara_files(yarac, install_dir)
+        compile_yara_files(yarac, pat2yara, install_dir)
 
     sys.exit(0)
 
@@ -61,6 +61,141 @@ TEST_F(InstructionOptimizerTests, optimizationReturnsTrue)
 	EXPECT_TRUE(ret);
 }
 
+TEST_F(InstructionOptimizerTests, optimizationsAreAppliedUntilNothingChanges)
+{
+	parseInput(R"(
+		@reg = global i32 0
+		define i32 @fnc() {
+			%a = load i32, i32* @reg
+			%b = add i32 %a, 1
+			%c = add i32 %b, 2
+			%d = add i32 %c, 0
+			%e = add i32 %d, 3
+			ret i32 %e
+		}
+	)");
+
+	bool ret = pass.runOnModuleCustom(*module);
+
+	std::string exp = R"(
+		@reg = global i32 0
+		define i32 @fnc() {
+			%a = load i32, i32* @reg
+			%e = add i32 %a, 6
+			ret i32 %e
+		}
+	)";
+	checkModuleAgainstExpectedIr(exp);
+	EXPECT_TRUE(ret);
+	std::map<std::string, std::size_t> expHits = {
+		{"addSequence", 2},
+		{"addZero", 1}
+	};
+	EXPECT_EQ(expHits, pass.getRuleHits());
+}
+
+TEST_F(InstructionOptimizerTests, nextRunOptimizesOnlyChangedInstructions)
+{
+	parseInput(R"(
+		@reg = global i32 0
+		define i32 @fnc() {
+			%a = load i32, i32* @reg
+			%b = add i32 %a, 0
+			ret i32 %b
+		}
+	)");
+	EXPECT_TRUE(pass.runOnModuleCustom(*module));
+	EXPECT_FALSE(pass.runOnModuleCustom(*module));
+	EXPECT_TRUE(pass.getRuleHits().empty());
+	EXPECT_EQ(0, pass.getNumberOfVisitedInstructions());
+
+	auto* ret = getNthInstruction<ReturnInst>();
+	auto* add = BinaryOperator::CreateAdd(
+			ret->getReturnValue(),
+			ConstantInt::get(ret->getReturnValue()->getType(), 0),
+			"c",
+			ret);
+	ret->setOperand(0, add);
+
+	InstructionOptimizer next;
+	bool b = next.runOnModuleCustom(*module);
+
+	std::string exp = R"(
+		@reg = global i32 0
+		define i32 @fnc() {
+			%a = load i32, i32* @reg
+			ret i32 %a
+		}
+	)";
+	checkModuleAgainstExpectedIr(exp);
+	EXPECT_TRUE(b);
+	// New %c, its user ret, and %a whose use was rewritten by the rule.
+	EXPECT_EQ(3, next.getNumberOfVisitedInstructions());
+}
+
+TEST_F(InstructionOptimizerTests, nextRunVisitsOnlyChangedInstructionsAndTheirUsers)
+{
+	parseInput(R"(
+		@reg = global i32 0
+		define i32 @fnc() {
+			%a = load i32, i32* @reg
+			%b = mul i32 %a, 3
+			%c = xor i32 %b, 5
+			%d = sub i32 %c, %a
+			store i32 %d, i32* @reg
+			%e = load i32, i32* @reg
+			ret i32 %e
+		}
+	)");
+	EXPECT_FALSE(pass.runOnModuleCustom(*module));
+	EXPECT_EQ(7, pass.getNumberOfVisitedInstructions());
+
+	auto* store = getNthInstruction<StoreInst>();
+	auto* d = store->getValueOperand();
+	auto* f = BinaryOperator::CreateMul(
+			d,
+			ConstantInt::get(d->getType(), 7),
+			"f",
+			store);
+	store->setOperand(0, f);
+
+	EXPECT_FALSE(pass.runOnModuleCustom(*module));
+	// New %f and its user store, nothing else.
+	EXPECT_EQ(2, pass.getNumberOfVisitedInstructions());
+	EXPECT_TRUE(pass.getRuleHits().empty());
+
+	EXPECT_FALSE(pass.runOnModuleCustom(*module));
+	EXPECT_EQ(0, pass.getNumberOfVisitedInstructions());
+}
+
+TEST_F(InstructionOptimizerTests, fingerprintsOfErasedInstructionsAreDropped)
+{
+	parseInput(R"(
+		@reg = global i32 0
+		define i32 @fnc() {
+			%a = load i32, i32* @reg
+			%b = mul i32 %a, 3
+			ret i32 %b
+		}
+	)");
+	EXPECT_FALSE(pass.runOnModuleCustom(*module));
+
+	// Replace %b by an identical instruction. It is likely allocated at the
+	// address of the erased one, but it must be visited anyway.
+	auto* b = getNthInstruction<BinaryOperator>();
+	auto* ret = getNthInstruction<ReturnInst>();
+	auto* a = b->getOperand(0);
+	auto* three = b->getOperand(1);
+	b->replaceAllUsesWith(UndefValue::get(b->getType()));
+	b->eraseFromParent();
+	auto* c = BinaryOperator::CreateMul(a, three, "b", ret);
+	ret->setOperand(0, c);
+
+	EXPECT_FALSE(pass.runOnModuleCustom(*module));
+	// The new %b and its user ret.
+	EXPECT_EQ(2, pass.getNumberOfVisitedInstructions());
+}
+
 } // namespace tests
 } // namespace bin2llvmir
 } // namespace retdec
@@ -0,0 +1,269 @@
+/**
+* @file tests/bin2llvmir/optimizations/provider_init/crypto_patterns_tests.cpp
+* @brief Tests for the @c CryptoPatterns detection.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <fstream>
+
+#include "bin2llvmir/utils/llvmir_tests.h"
+#include "retdec/bin2llvmir/optimizations/provider_init/crypto_patterns.h"
+#include "retdec/fileformat/types/sec_seg/section.h"
+#include "retdec/loader/loader/image.h"
+#include "retdec/utils/filesystem.h"
+
+using namespace ::testing;
+using namespace llvm;
+using namespace retdec::fileformat;
+using namespace retdec::loader;
+
+namespace retdec {
+namespace bin2llvmir {
+namespace tests {
+
+namespace {
+
+const std::string PATTERN_BYTES = "\xde\xad\xbe\xef\x01\x02\x03\x04";
+
+const std::string PATTERN_RULE = R"(
+rule Test_Const__32_lil_
+{
+	meta:
+		description = "Test constant"
+	strings:
+		$c0 = { de ad be ef 01 02 03 04 }
+	condition:
+		$c0
+}
+)";
+
+/**
+ * Image with hand-made segments:
+ * - .data at 0x1000 (file offset 0x400), pattern at offset 8,
+ * - .bss at 0x2000, its memory contains the pattern at offset 0,
+ * - nameless segment without section at 0x3000, pattern at offset 4,
+ * - segment at 0x4000 without any data.
+ */
+class TestImage : public Image
+{
+	public:
+		TestImage(const std::shared_ptr<FileFormat>& fileFormat) :
+				Image(fileFormat)
+		{
+			load();
+		}
+
+		virtual bool load() override
+		{
+			auto* data = addSection(".data", SecSeg::Type::DATA, 0x400, 0x1000);
+			addSegment(data, 0x1000, std::string(8, '\0') + PATTERN_BYTES);
+
+			auto* bss = addSection(".bss", SecSeg::Type::BSS, 0, 0x2000);
+			addSegment(bss, 0x2000, PATTERN_BYTES + std::string(8, '\0'));
+
+			addSegment(nullptr, 0x3000, std::string(4, '\0') + PATTERN_BYTES);
+
+			insertSegment(std::make_unique<loader::Segment>(
+					nullptr,
+					0x4000,
+					0x100,
+					std::make_unique<SegmentDataSource>()));
+
+			return true;
+		}
+
+	private:
+		const Section* addSection(
+				const std::string& name,
+				SecSeg::Type type,
+				unsigned long long offset,
+				unsigned long long address)
+		{
+			auto s = std::make_unique<Section>();
+			s->setName(name);
+			s->setType(type);
+			s->setOffset(offset);
+			s->setAddress(address);
+			_sections.push_back(std::move(s));
+			return _sections.back().get();
+		}
+
+		void addSegment(
+				const Section* section,
+				std::uint64_t address,
+				const std::string& content)
+		{
+			_contents.push_back(std::make_unique<std::string>(content));
+			auto& c = *_contents.back();
+			insertSegment(std::make_unique<loader::Segment>(
+					section,
+					address,
+					c.size(),
+					std::make_unique<SegmentDataSource>(c)));
+		}
+
+	private:
+		std::vector<std::unique_ptr<Section>> _sections;
+		std::vector<std::unique_ptr<std::string>> _contents;
+};
+
+} // anonymous namespace
+
+/**
+ * @brief Tests for the @c CryptoPatterns detection.
+ */
+class CryptoPatternsTests: public LlvmIrTests
+{
+	protected:
+		void SetUp() override
+		{
+			LlvmIrTests::SetUp();
+			CryptoPatterns::clear();
+		}
+
+		void TearDown() override
+		{
+			CryptoPatterns::clear();
+			for (const auto& f : tempFiles)
+			{
+				std::error_code ec;
+				fs::remove(f, ec);
+			}
+			LlvmIrTests::TearDown();
+		}
+
+		std::string writeRuleFile(const std::string& content)
+		{
+			auto* info = UnitTest::GetInstance()->current_test_info();
+			auto path = fs::temp_directory_path()
+					/ (std::string("retdec-") + info->name() + ".yara");
+			std::ofstream(path.string()) << content;
+			tempFiles.push_back(path.string());
+			return path.string();
+		}
+
+		Config createConfig(const std::string& rulePath)
+		{
+			auto c = Config::empty(module.get());
+			auto& arch = c.getConfig().architecture;
+			arch.setIsX86();
+			arch.setBitSize(32);
+			arch.setIsEndianLittle();
+			c.getConfig().parameters.cryptoPatternPaths = {rulePath};
+			return c;
+		}
+
+		std::unique_ptr<FileImage> createImage(Config& c)
+		{
+			return std::make_unique<FileImage>(
+					module.get(),
+					std::make_unique<TestImage>(createFormat()),
+					&c);
+		}
+
+	private:
+		std::vector<std::string> tempFiles;
+};
+
+TEST_F(CryptoPatternsTests, nothingIsDetectedWithoutRulePaths)
+{
+	auto c = Config::empty(module.get());
+	c.getConfig().architecture.setIsX86();
+	c.getConfig().architecture.setBitSize(32);
+	auto image = createImage(c);
+
+	EXPECT_EQ(0, CryptoPatterns::detect(image.get(), &c));
+	EXPECT_TRUE(c.getConfig().patterns.empty());
+}
+
+TEST_F(CryptoPatternsTests, onlyInitializedSegmentsAreScanned)
+{
+	auto c = createConfig(writeRuleFile(PATTERN_RULE));
+	auto image = createImage(c);
+
+	ASSERT_EQ(1, CryptoPatterns::detect(image.get(), &c));
+
+	auto& patterns = c.getConfig().patterns;
+	ASSERT_EQ(1, patterns.size());
+	auto& matches = patterns.front().matches;
+	ASSERT_EQ(2, matches.size());
+	EXPECT_EQ(0x1008, matches[0].getAddress());
+	EXPECT_EQ(0x3004, matches[1].getAddress());
+}
+
+TEST_F(CryptoPatternsTests, matchOffsetsAreMappedToAddressesAndFileOffsets)
+{
+	auto c = createConfig(writeRuleFile(PATTERN_RULE));
+	auto image = createImage(c);
+
+	CryptoPatterns::detect(image.get(), &c, false);
+
+	auto& patterns = c.getConfig().patterns;
+	ASSERT_EQ(1, patterns.size());
+	auto& p = patterns.front();
+	EXPECT_TRUE(p.isTypeCrypto());
+	EXPECT_EQ("Test_Const", p.getName());
+	EXPECT_EQ("Test constant (32-bit, little endian)", p.getDescription());
+	EXPECT_TRUE(p.isEndianLittle());
+
+	ASSERT_EQ(2, p.matches.size());
+	auto& inData = p.matches[0];
+	EXPECT_EQ(0x1008, inData.getAddress());
+	EXPECT_EQ(0x408, inData.getOffset());
+	EXPECT_EQ(PATTERN_BYTES.size(), inData.getSize().value_or(0));
+	EXPECT_EQ(4, inData.getEntrySize().value_or(0));
+	EXPECT_TRUE(inData.isTypeIntegral());
+
+	// There is no section, so the file offset is not known.
+	auto& inNameless = p.matches[1];
+	EXPECT_EQ(0x3004, inNameless.getAddress());
+	EXPECT_FALSE(inNameless.isOffsetDefined());
+}
+
+TEST_F(CryptoPatternsTests, parallelAndSequentialScansGiveSameResults)
+{
+	auto path = writeRuleFile(PATTERN_RULE);
+	auto c1 = createConfig(path);
+	auto image1 = createImage(c1);
+	auto c2 = createConfig(path);
+	auto image2 = createImage(c2);
+
+	CryptoPatterns::detect(image1.get(), &c1, true);
+	CryptoPatterns::detect(image2.get(), &c2, false);
+
+	auto& p1 = c1.getConfig().patterns;
+	auto& p2 = c2.getConfig().patterns;
+	ASSERT_EQ(1, p1.size());
+	ASSERT_EQ(1, p2.size());
+	ASSERT_EQ(p2.front().matches.size(), p1.front().matches.size());
+	for (std::size_t i = 0; i < p1.front().matches.size(); ++i)
+	{
+		EXPECT_EQ(
+				p2.front().matches[i].getAddress(),
+				p1.front().matches[i].getAddress());
+	}
+}
+
+TEST_F(CryptoPatternsTests, rulesAreCompiledOnceAndReused)
+{
+	auto path = writeRuleFile(PATTERN_RULE);
+	auto c1 = createConfig(path);
+	auto image1 = createImage(c1);
+	ASSERT_EQ(1, CryptoPatterns::detect(image1.get(), &c1));
+
+	// Compiled rules are reused, the rule file is not read again.
+	fs::remove(path);
+	auto c2 = createConfig(path);
+	auto image2 = createImage(c2);
+	EXPECT_EQ(1, CryptoPatterns::detect(image2.get(), &c2));
+
+	// Until they are dropped.
+	CryptoPatterns::clear();
+	auto c3 = createConfig(path);
+	auto image3 = createImage(c3);
+	EXPECT_EQ(0, CryptoPatterns::detect(image3.get(), &c3));
+}
+
+} // namespace tests
+} // namespace bin2llvmir
+} // namespace retdec
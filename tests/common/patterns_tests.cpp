@@ -344,6 +344,81 @@ TEST_F(PatternTests, SimilarPatternsWithDifferentMatchesAreNotEqual)
 	EXPECT_TRUE(p1 != p2);
 }
 
+//
+//=============================================================================
+// PatternIndex
+//=============================================================================
+//
+
+class PatternIndexTests : public Test
+{
+	protected:
+		PatternContainer patterns;
+
+		void SetUp() override
+		{
+			auto p1 = Pattern::crypto("p1");
+			p1.matches.push_back(Pattern::Match::integral(0x10, 0x1000, 0x100));
+			p1.matches.push_back(Pattern::Match::integral(0x20, 0x3000, 0x10));
+			auto p2 = Pattern::crypto("p2");
+			p2.matches.push_back(Pattern::Match::integral(0x30, 0x1000, 0x20));
+			p2.matches.push_back(Pattern::Match::integral(0x40));
+			auto p3 = Pattern::other("p3");
+			p3.matches.push_back(Pattern::Match::unknown(0x50, 0x2000));
+			patterns = {p1, p2, p3};
+		}
+};
+
+TEST_F(PatternIndexTests, defaultIndexIsEmpty)
+{
+	PatternIndex idx;
+
+	EXPECT_TRUE(idx.empty());
+	EXPECT_EQ(0, idx.size());
+	EXPECT_TRUE(idx.findAt(0x1000).empty());
+}
+
+TEST_F(PatternIndexTests, buildIndexesOnlyMatchesWithDefinedAddresses)
+{
+	PatternIndex idx(patterns);
+
+	EXPECT_FALSE(idx.empty());
+	EXPECT_EQ(4, idx.size());
+}
+
+TEST_F(PatternIndexTests, findAtReturnsAllMatchesStartingAtAddress)
+{
+	PatternIndex idx(patterns);
+
+	auto res = idx.findAt(0x1000);
+
+	ASSERT_EQ(2, res.size());
+	EXPECT_EQ(0, res[0].pattern);
+	EXPECT_EQ(0, res[0].match);
+	EXPECT_EQ(Address(0x1100), res[0].end);
+	EXPECT_EQ(1, res[1].pattern);
+	EXPECT_EQ(0, res[1].match);
+	EXPECT_TRUE(idx.findAt(0x1001).empty());
+	EXPECT_TRUE(idx.findAt(Address::Undefined).empty());
+}
+
+TEST_F(PatternIndexTests, insertAddsMatchesOfNewPattern)
+{
+	PatternIndex idx(patterns);
+	auto p = Pattern::crypto("p4");
+	p.matches.push_back(Pattern::Match::integral(0x60, 0x3008, 0x4));
+	patterns.push_back(p);
+
+	idx.insert(patterns.back(), patterns.size() - 1);
+
+	auto res = idx.findAt(0x3008);
+	ASSERT_EQ(1, res.size());
+	EXPECT_EQ(3, res[0].pattern);
+	EXPECT_EQ(0, res[0].match);
+	EXPECT_EQ(Address(0x300c), res[0].end);
+	EXPECT_EQ(5, idx.size());
+}
+
 } // namespace tests
 } // namespace common
 } // namespace retdec
@@ -4,9 +4,14 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
 #include <gtest/gtest.h>
 
 #include "retdec/config/config.h"
+#include "retdec/utils/filesystem.h"
 
 using namespace ::testing;
 
@@ -16,8 +21,29 @@ namespace tests {
 
 class ConfigTests : public Test
 {
+	protected:
+		/// Returns a path in the temporary directory unique to the test.
+		std::string tempPath(const std::string& suffix)
+		{
+			auto* info = UnitTest::GetInstance()->current_test_info();
+			auto path = fs::temp_directory_path()
+					/ (std::string("retdec-") + info->name() + suffix);
+			tempFiles.push_back(path.string());
+			return path.string();
+		}
+
+		void TearDown() override
+		{
+			for (const auto& f : tempFiles)
+			{
+				std::error_code ec;
+				fs::remove(f, ec);
+			}
+		}
+
 	protected:
 		Config config;
+		std::vector<std::string> tempFiles;
 };
 
 TEST_F(ConfigTests, ReadNonexistentFileThrowsAnException)
@@ -54,6 +80,160 @@ TEST_F(ConfigTests, FailedReadJsonStringKeepsAllConfigData)
 	EXPECT_EQ(expectedAbiPaths, config.parameters.abiPaths);
 }
 
+TEST_F(ConfigTests, BinaryStringRoundTripKeepsConfigData)
+{
+	config.parameters.setInputFile("/input/file");
+	config.parameters.setConfigFormat("binary");
+	config.parameters.abiPaths.insert("/abi/path");
+	config.architecture.setName("x86");
+	common::Function f(0x1000, 0x1010, "main");
+	f.setIsVariadic(true);
+	config.functions.insert(f);
+	config.functions.insert(common::Function(0x2000, 0x2020, "foo"));
+
+	auto binary = config.generateBinaryString();
+	ASSERT_TRUE(Config::isBinary(binary));
+	EXPECT_LT(binary.size(), config.generateJsonString().size());
+
+	auto c = Config::fromBinaryString(binary);
+
+	EXPECT_EQ("/input/file", c.parameters.getInputFile());
+	EXPECT_TRUE(c.parameters.isConfigFormatBinary());
+	EXPECT_EQ(config.parameters.abiPaths, c.parameters.abiPaths);
+	EXPECT_TRUE(c.architecture.isX86());
+	ASSERT_EQ(2, c.functions.size());
+	auto* main = c.functions.getFunctionByName("main");
+	ASSERT_NE(nullptr, main);
+	EXPECT_EQ(0x1000, main->getStart());
+	EXPECT_EQ(0x1010, main->getEnd());
+	EXPECT_TRUE(main->isVariadic());
+	EXPECT_NE(nullptr, c.functions.getFunctionByName("foo"));
+}
+
+TEST_F(ConfigTests, ReadStringDetectsConfigFormat)
+{
+	config.parameters.setInputFile("/input/file");
+
+	Config c;
+	c.readString(config.generateBinaryString());
+	EXPECT_EQ("/input/file", c.parameters.getInputFile());
+
+	c = Config();
+	c.readString(config.generateJsonString());
+	EXPECT_EQ("/input/file", c.parameters.getInputFile());
+}
+
+TEST_F(ConfigTests, FailedReadBinaryStringKeepsAllConfigData)
+{
+	std::string abi = "/abi/path";
+	config.parameters.abiPaths.insert(abi);
+	auto binary = config.generateBinaryString();
+	binary.resize(binary.size() / 2);
+
+	ASSERT_THROW(config.readBinaryString(binary), ParseException);
+
+	std::set<std::string> expectedAbiPaths{abi};
+	EXPECT_EQ(expectedAbiPaths, config.parameters.abiPaths);
+}
+
+TEST_F(ConfigTests, ReadFileReadsBothConfigFormats)
+{
+	config.parameters.setInputFile("/input/file");
+	config.functions.insert(common::Function(0x1000, 0x1010, "main"));
+	auto binaryPath = config.generateBinaryFile(tempPath(".config.bin"));
+	auto jsonPath = config.generateJsonFile(tempPath(".config.json"));
+
+	auto b = Config::fromFile(binaryPath);
+	auto j = Config::fromFile(jsonPath);
+
+	EXPECT_EQ("/input/file", b.parameters.getInputFile());
+	EXPECT_NE(nullptr, b.functions.getFunctionByName("main"));
+	EXPECT_EQ("/input/file", j.parameters.getInputFile());
+	EXPECT_NE(nullptr, j.functions.getFunctionByName("main"));
+}
+
+TEST_F(ConfigTests, ReadFileOfEmptyFileThrowsAnException)
+{
+	auto path = tempPath(".config.json");
+	std::ofstream(path).close();
+
+	ASSERT_THROW(config.readFile(path), ParseException);
+}
+
+TEST_F(ConfigTests, ReadFileOfTruncatedBinaryFileThrowsAnException)
+{
+	config.parameters.setInputFile("/input/file");
+	auto binary = config.generateBinaryString();
+	auto path = tempPath(".config.bin");
+	std::ofstream(path, std::ios::binary)
+			<< binary.substr(0, binary.size() / 2);
+
+	ASSERT_THROW(config.readFile(path), ParseException);
+}
+
+TEST_F(ConfigTests, DemandDrivenDecompilationNeedsSomethingSelected)
+{
+	config.parameters.setIsSelectedDemandDriven(true);
+
+	EXPECT_FALSE(config.parameters.isDemandDriven());
+
+	config.parameters.selectedFunctions.insert("main");
+
+	EXPECT_TRUE(config.parameters.isDemandDriven());
+
+	config.parameters.setIsSelectedDemandDriven(false);
+
+	EXPECT_FALSE(config.parameters.isDemandDriven());
+}
+
+/**
+ * Not a test -- compares sizes and read/write times of JSON and binary
+ * config files. Run with --gtest_also_run_disabled_tests to see the results.
+ */
+TEST_F(ConfigTests, DISABLED_BenchmarkJsonAgainstBinary)
+{
+	using Clock = std::chrono::steady_clock;
+
+	// 100k functions, each with 4 basic blocks with 4 calls.
+	for (unsigned i = 0; i < 100000; ++i)
+	{
+		common::Address start = 0x400000 + i * 0x40;
+		common::Function f(start, start + 0x3f, "function_" + std::to_string(i));
+		for (unsigned b = 0; b < 4; ++b)
+		{
+			common::BasicBlock bb;
+			bb.setStartEnd(start + b * 0x10, start + b * 0x10 + 0xf);
+			for (unsigned k = 0; k < 4; ++k)
+			{
+				bb.calls.insert({start + b * 0x10 + k, 0x400000 + ((i + k) % 1000) * 0x40});
+			}
+			f.basicBlocks.insert(bb);
+		}
+		config.functions.insert(f);
+	}
+
+	auto ms = [](auto start) {
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	};
+	auto measure = [&](const std::string& name, const std::string& path, auto generate) {
+		auto start = Clock::now();
+		generate(path);
+		auto writeMs = ms(start);
+
+		start = Clock::now();
+		auto c = Config::fromFile(path);
+		auto readMs = ms(start);
+
+		ASSERT_EQ(config.functions.size(), c.functions.size());
+		std::cout << name << ": " << fs::file_size(path) / (1024 * 1024) << " MiB, "
+				<< "write " << writeMs << " ms, read " << readMs << " ms\n";
+	};
+
+	measure("json  ", tempPath(".config.json"), [&](auto& p) { config.generateJsonFile(p); });
+	measure("binary", tempPath(".config.bin"), [&](auto& p) { config.generateBinaryFile(p); });
+	std::cout << std::flush;
+}
+
 TEST_F(ConfigTests, ClassesGetElementByIdReturnsNullPointerWhenThereIsNoSuchClass)
 {
 	ASSERT_EQ(config.classes.end(), config.classes.find("ClassName"));
@@ -0,0 +1,32 @@
+/**
+ * @file tests/cpdetect/cpdetect_tests.cpp
+ * @brief Inputs shared by tests of the @c cpdetect module.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include "cpdetect/cpdetect_tests.h"
+
+namespace retdec {
+namespace cpdetect {
+namespace tests {
+
+/**
+ * Small x86 ELF executable; its identification padding contains "Hi World".
+ */
+const std::vector<std::uint8_t> elfBytes = {
+	0x7f, 0x45, 0x4c, 0x46, 0x01, 0x01, 0x01, 0x48, 0x69, 0x20, 0x57, 0x6f, 0x72, 0x6c, 0x64, 0x0a,
+	0x02, 0x00, 0x03, 0x00, 0x01, 0x00, 0x00, 0x00, 0x80, 0x80, 0x04, 0x08, 0x34, 0x00, 0x00, 0x00,
+	0xf8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x34, 0x00, 0x20, 0x00, 0x02, 0x00, 0x28, 0x00,
+	0x05, 0x00, 0x04, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x04, 0x08,
+	0x00, 0x80, 0x04, 0x08, 0xa2, 0x00, 0x00, 0x00, 0xa2, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+	0x00, 0x10, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0xa4, 0x00, 0x00, 0x00, 0xa4, 0x90, 0x04, 0x08,
+	0xa4, 0x90, 0x04, 0x08, 0x09, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00,
+	0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0xba, 0x09, 0x00, 0x00, 0x00, 0xb9, 0x07, 0x90, 0x04, 0x08, 0xbb, 0x01, 0x00, 0x00, 0x00, 0xb8,
+	0x04, 0x00, 0x00, 0x00, 0xcd, 0x80, 0xbb, 0x00, 0x00, 0x00, 0x00, 0xb8, 0x01, 0x00, 0x00, 0x00,
+	0xcd, 0x80, 0x00, 0x00
+};
+
+} // namespace tests
+} // namespace cpdetect
+} // namespace retdec
@@ -0,0 +1,23 @@
+/**
+ * @file tests/cpdetect/cpdetect_tests.h
+ * @brief Inputs shared by tests of the @c cpdetect module.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#ifndef TESTS_CPDETECT_CPDETECT_TESTS_H
+#define TESTS_CPDETECT_CPDETECT_TESTS_H
+
+#include <cstdint>
+#include <vector>
+
+namespace retdec {
+namespace cpdetect {
+namespace tests {
+
+extern const std::vector<std::uint8_t> elfBytes;
+
+} // namespace tests
+} // namespace cpdetect
+} // namespace retdec
+
+#endif
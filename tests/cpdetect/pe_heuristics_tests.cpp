@@ -0,0 +1,177 @@
+/**
+ * @file tests/cpdetect/pe_heuristics_tests.cpp
+ * @brief Tests for the @c pe_heuristics module.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/cpdetect/scan_service.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace cpdetect {
+namespace tests {
+
+namespace {
+
+const std::string msvcRuntimeString = "Microsoft Visual C++ Runtime Library";
+
+/**
+ * Section of a PE file created by createPe()
+ */
+struct PeSection
+{
+	std::string name;
+	/// content in file; section without content has no raw data
+	std::vector<std::uint8_t> content;
+};
+
+void put16(std::vector<std::uint8_t> &bytes, std::size_t offset, std::uint16_t value)
+{
+	bytes[offset] = value & 0xff;
+	bytes[offset + 1] = value >> 8;
+}
+
+void put32(std::vector<std::uint8_t> &bytes, std::size_t offset, std::uint32_t value)
+{
+	put16(bytes, offset, value & 0xffff);
+	put16(bytes, offset + 2, value >> 16);
+}
+
+/**
+ * Create x86 PE file with the given sections
+ *
+ * Every section occupies one page in memory and at most 0x200 bytes in file.
+ * Sections without content have zero file offset and zero raw size.
+ */
+std::vector<std::uint8_t> createPe(const std::vector<PeSection> &sections)
+{
+	const std::size_t peOffset = 0x40;
+	const std::size_t optionalHeaderOffset = peOffset + 0x18;
+	const std::size_t sectionTableOffset = optionalHeaderOffset + 0xe0;
+	const std::uint32_t fileAlignment = 0x200;
+	const std::uint32_t sectionAlignment = 0x1000;
+
+	std::vector<std::uint8_t> bytes(fileAlignment, 0);
+	bytes[0] = 'M';
+	bytes[1] = 'Z';
+	put32(bytes, 0x3c, peOffset);
+
+	bytes[peOffset] = 'P';
+	bytes[peOffset + 1] = 'E';
+	put16(bytes, peOffset + 4, 0x14c);
+	put16(bytes, peOffset + 6, sections.size());
+	put16(bytes, peOffset + 20, 0xe0);
+	put16(bytes, peOffset + 22, 0x102);
+
+	const auto oh = optionalHeaderOffset;
+	put16(bytes, oh, 0x10b);
+	put32(bytes, oh + 16, sectionAlignment);
+	put32(bytes, oh + 20, sectionAlignment);
+	put32(bytes, oh + 28, 0x400000);
+	put32(bytes, oh + 32, sectionAlignment);
+	put32(bytes, oh + 36, fileAlignment);
+	put16(bytes, oh + 40, 4);
+	put16(bytes, oh + 48, 4);
+	put32(bytes, oh + 56, sectionAlignment * (sections.size() + 1));
+	put32(bytes, oh + 60, fileAlignment);
+	put16(bytes, oh + 68, 3);
+	put32(bytes, oh + 72, 0x100000);
+	put32(bytes, oh + 76, 0x1000);
+	put32(bytes, oh + 80, 0x100000);
+	put32(bytes, oh + 84, 0x1000);
+	put32(bytes, oh + 92, 16);
+
+	for (std::size_t i = 0; i < sections.size(); ++i)
+	{
+		const auto &section = sections[i];
+		const auto header = sectionTableOffset + 40 * i;
+		std::copy(
+				section.name.begin(),
+				section.name.begin() + std::min<std::size_t>(section.name.size(), 8),
+				bytes.begin() + header);
+		put32(bytes, header + 8, sectionAlignment);
+		put32(bytes, header + 12, sectionAlignment * (i + 1));
+		put32(bytes, header + 36, 0x40000040);
+
+		if (!section.content.empty())
+		{
+			put32(bytes, header + 16, fileAlignment);
+			put32(bytes, header + 20, bytes.size());
+			auto content = section.content;
+			content.resize(fileAlignment, 0);
+			bytes.insert(bytes.end(), content.begin(), content.end());
+		}
+	}
+
+	return bytes;
+}
+
+/**
+ * Content of a section with the MSVC runtime string
+ */
+std::vector<std::uint8_t> msvcRuntimeContent()
+{
+	std::vector<std::uint8_t> content = {0xc3, 0x00, 0x00, 0x00};
+	content.insert(content.end(), msvcRuntimeString.begin(), msvcRuntimeString.end());
+	return content;
+}
+
+/**
+ * Names of tools detected in the given file
+ */
+std::vector<std::string> detectTools(const std::vector<std::uint8_t> &file)
+{
+	ScanService service(ScanService::Settings{});
+	auto result = service.scan(file.data(), file.size());
+	EXPECT_EQ(retdec::fileformat::Format::PE, result.format);
+
+	std::vector<std::string> names;
+	for (const auto &tool : result.toolInfo.detectedTools)
+	{
+		names.push_back(tool.name);
+	}
+	return names;
+}
+
+bool contains(const std::vector<std::string> &names, const std::string &name)
+{
+	return std::find(names.begin(), names.end(), name) != names.end();
+}
+
+} // anonymous namespace
+
+TEST(PeHeuristicsTests, msvcRuntimeStringInRdataIsDetected)
+{
+	auto file = createPe({
+		{".text", {0xc3}},
+		{".rdata", msvcRuntimeContent()},
+		{".reloc", {0x00}}
+	});
+
+	EXPECT_TRUE(contains(detectTools(file), "MSVC"));
+}
+
+TEST(PeHeuristicsTests, msvcRuntimeStringOutsideOfEmptyRdataAtOffsetZeroIsNotDetected)
+{
+	// .rdata has zero file offset and no raw data, so its area must not
+	// wrap around and cover the whole file.
+	auto file = createPe({
+		{".text", msvcRuntimeContent()},
+		{".rdata", {}},
+		{".reloc", {0x00}}
+	});
+
+	EXPECT_FALSE(contains(detectTools(file), "MSVC"));
+}
+
+} // namespace tests
+} // namespace cpdetect
+} // namespace retdec
@@ -0,0 +1,252 @@
+/**
+ * @file tests/cpdetect/scan_service_tests.cpp
+ * @brief Tests for the @c scan_service module.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/cpdetect/scan_service.h"
+#include "retdec/utils/filesystem.h"
+#include "retdec/yaracpp/yara_detector.h"
+#include "cpdetect/cpdetect_tests.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace cpdetect {
+namespace tests {
+
+namespace {
+
+const std::string markerRule = R"(
+rule marker
+{
+	strings:
+		$m = "RETDEC_MARKER"
+	condition:
+		$m
+}
+)";
+
+const std::string toolSignature = R"(
+rule test_tool
+{
+	meta:
+		tool = "C"
+		name = "TestTool"
+	strings:
+		$h = "Hi World"
+	condition:
+		$h
+}
+)";
+
+/**
+ * Names of tools detected in the given result
+ */
+std::vector<std::string> toolNames(const ScanService::Result &result)
+{
+	std::vector<std::string> names;
+	for (const auto &tool : result.toolInfo.detectedTools)
+	{
+		names.push_back(tool.name);
+	}
+	return names;
+}
+
+/**
+ * Names of rules from the given rule set matched in the given result
+ */
+std::vector<std::string> matchedRules(
+		const ScanService::Result &result,
+		const std::string &ruleSet)
+{
+	std::vector<std::string> names;
+	auto it = result.yaraMatches.find(ruleSet);
+	if (it != result.yaraMatches.end())
+	{
+		for (const auto &rule : it->second)
+		{
+			names.push_back(rule.getName());
+		}
+	}
+	return names;
+}
+
+} // anonymous namespace
+
+/**
+ * Tests for the @c scan_service module
+ */
+class ScanServiceTests : public Test
+{
+	protected:
+		std::string writeTempFile(const std::string &suffix, const std::string &content)
+		{
+			auto *info = UnitTest::GetInstance()->current_test_info();
+			auto path = fs::temp_directory_path()
+					/ (std::string("retdec-") + info->name() + suffix);
+			std::ofstream(path.string()) << content;
+			tempFiles.push_back(path.string());
+			return path.string();
+		}
+
+		ScanService::Settings createSettings()
+		{
+			ScanService::Settings settings;
+			settings.yaraRuleSets["test"] = {writeTempFile(".marker.yar", markerRule)};
+			settings.externalDatabases = {writeTempFile(".tool.yar", toolSignature)};
+			return settings;
+		}
+
+		/**
+		 * ELF inputs, every other one with the marker appended
+		 */
+		std::vector<std::vector<std::uint8_t>> createInputs(std::size_t count)
+		{
+			const std::string marker = "RETDEC_MARKER";
+			std::vector<std::vector<std::uint8_t>> inputs(count, elfBytes);
+			for (std::size_t i = 0; i < count; i += 2)
+			{
+				inputs[i].insert(inputs[i].end(), marker.begin(), marker.end());
+			}
+			return inputs;
+		}
+
+		void TearDown() override
+		{
+			for (const auto &f : tempFiles)
+			{
+				std::error_code ec;
+				fs::remove(f, ec);
+			}
+		}
+
+	private:
+		std::vector<std::string> tempFiles;
+};
+
+TEST_F(ScanServiceTests, serviceWithMissingRuleFileIsNotInValidState)
+{
+	ScanService::Settings settings;
+	settings.yaraRuleSets["test"] = {"/nonexistent/rules.yar"};
+
+	ScanService service(settings);
+
+	EXPECT_FALSE(service.isInValidState());
+}
+
+TEST_F(ScanServiceTests, scanOfBatchReportsResultsInOrderOfInputs)
+{
+	ScanService service(createSettings());
+	ASSERT_TRUE(service.isInValidState());
+	auto inputs = createInputs(32);
+
+	auto results = service.scan(inputs);
+
+	ASSERT_EQ(inputs.size(), results.size());
+	for (std::size_t i = 0; i < results.size(); ++i)
+	{
+		EXPECT_EQ(retdec::fileformat::Format::ELF, results[i].format);
+		EXPECT_EQ(std::vector<std::string>{"TestTool"}, toolNames(results[i]));
+		EXPECT_EQ(
+				i % 2 == 0
+						? std::vector<std::string>{"marker"}
+						: std::vector<std::string>{},
+				matchedRules(results[i], "test"));
+	}
+}
+
+TEST_F(ScanServiceTests, concurrentScansShareCompiledSignatures)
+{
+	ScanService service(createSettings());
+	ASSERT_TRUE(service.isInValidState());
+	auto inputs = createInputs(16);
+	auto expected = service.scan(inputs);
+	ASSERT_EQ(1, service.getNumberOfCompiledSignatures());
+
+	const std::size_t threadCount = 8;
+	std::vector<std::vector<ScanService::Result>> results(threadCount);
+	std::vector<std::thread> threads;
+	for (std::size_t t = 0; t < threadCount; ++t)
+	{
+		threads.emplace_back([&, t]() {
+			for (const auto &input : inputs)
+			{
+				results[t].push_back(service.scan(input.data(), input.size()));
+			}
+		});
+	}
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	EXPECT_EQ(1, service.getNumberOfCompiledSignatures());
+	for (const auto &threadResults : results)
+	{
+		ASSERT_EQ(inputs.size(), threadResults.size());
+		for (std::size_t i = 0; i < inputs.size(); ++i)
+		{
+			EXPECT_EQ(expected[i].status, threadResults[i].status);
+			EXPECT_EQ(toolNames(expected[i]), toolNames(threadResults[i]));
+			EXPECT_EQ(
+					matchedRules(expected[i], "test"),
+					matchedRules(threadResults[i], "test"));
+		}
+	}
+}
+
+TEST_F(ScanServiceTests, scansOverYaraThreadLimitWaitInsteadOfFailing)
+{
+	ScanService service(createSettings());
+	ASSERT_TRUE(service.isInValidState());
+	auto inputs = createInputs(2);
+
+	const std::size_t threadCount =
+			2 * retdec::yaracpp::YaraDetector::getMaxConcurrentScans();
+	std::vector<ScanService::Result> results(threadCount);
+	std::vector<std::thread> threads;
+	for (std::size_t t = 0; t < threadCount; ++t)
+	{
+		threads.emplace_back([&, t]() {
+			const auto &input = inputs[0];
+			results[t] = service.scan(input.data(), input.size());
+		});
+	}
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	for (const auto &result : results)
+	{
+		EXPECT_FALSE(result.yaraFailed);
+		EXPECT_EQ(std::vector<std::string>{"marker"}, matchedRules(result, "test"));
+		EXPECT_EQ(std::vector<std::string>{"TestTool"}, toolNames(result));
+	}
+}
+
+TEST_F(ScanServiceTests, inputOfUnknownFormatIsStillMatchedByRuleSets)
+{
+	ScanService service(createSettings());
+	const std::string input = "plain text with RETDEC_MARKER";
+
+	auto result = service.scan(
+			reinterpret_cast<const std::uint8_t*>(input.data()),
+			input.size());
+
+	EXPECT_EQ(std::vector<std::string>{"marker"}, matchedRules(result, "test"));
+	EXPECT_TRUE(result.toolInfo.detectedTools.empty());
+	EXPECT_EQ(0, service.getNumberOfCompiledSignatures());
+}
+
+} // namespace tests
+} // namespace cpdetect
+} // namespace retdec
@@ -0,0 +1,303 @@
+/**
+ * @file tests/cpdetect/search_tests.cpp
+ * @brief Tests for the @c search module.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/cpdetect/search.h"
+#include "retdec/fileformat/format_factory.h"
+#include "cpdetect/cpdetect_tests.h"
+
+using namespace ::testing;
+using namespace retdec::fileformat;
+
+namespace retdec {
+namespace cpdetect {
+namespace tests {
+
+namespace {
+
+/**
+ * Nibbles that match any nibble of the file
+ */
+const std::string wildcards = "-?;";
+
+/**
+ * Random bytes from a small alphabet, so that random patterns have matches
+ */
+std::vector<std::uint8_t> randomBytes(std::mt19937 &gen, std::size_t size)
+{
+	const std::vector<std::uint8_t> alphabet = {0x00, 0x11, 0x12, 0x21, 0x41, 0x42, 0xff};
+	std::uniform_int_distribution<std::size_t> dist(0, alphabet.size() - 1);
+	std::vector<std::uint8_t> bytes(size);
+	for (auto &b : bytes)
+	{
+		b = alphabet[dist(gen)];
+	}
+	return bytes;
+}
+
+/**
+ * Random substring of @a str with length in <tt>[1, maxLength]</tt>,
+ * sometimes modified so that it may not be present in @a str
+ */
+std::string randomPart(
+		std::mt19937 &gen,
+		const std::string &str,
+		std::size_t maxLength,
+		const std::string &replacements)
+{
+	std::uniform_int_distribution<std::size_t> lengthDist(1, maxLength);
+	const auto length = lengthDist(gen);
+	std::uniform_int_distribution<std::size_t> startDist(0, str.size() - length);
+	auto part = str.substr(startDist(gen), length);
+
+	std::uniform_int_distribution<std::size_t> posDist(0, part.size() - 1);
+	std::uniform_int_distribution<std::size_t> replDist(0, replacements.size() - 1);
+	std::uniform_int_distribution<unsigned> coin(0, 3);
+	while (coin(gen) == 0)
+	{
+		part[posDist(gen)] = replacements[replDist(gen)];
+	}
+	return part;
+}
+
+} // anonymous namespace
+
+/**
+ * Tests for the @c search module
+ */
+class SearchTests : public Test
+{
+	protected:
+		void loadFile(const std::vector<std::uint8_t> &appendedBytes)
+		{
+			bytes = elfBytes;
+			bytes.insert(bytes.end(), appendedBytes.begin(), appendedBytes.end());
+			parser = createFileFormat(bytes.data(), bytes.size());
+			ASSERT_NE(nullptr, parser);
+			search = std::make_unique<Search>(*parser);
+			ASSERT_TRUE(search->isFileSupported());
+		}
+
+		/**
+		 * Check that findUnslashedSignatures() returns the same values as
+		 * findUnslashedSignature() for all patterns
+		 */
+		void expectSameSignatureResults(
+				const std::vector<std::string> &patterns,
+				std::size_t startOffset,
+				std::size_t stopOffset)
+		{
+			auto results = search->findUnslashedSignatures(
+					patterns,
+					startOffset,
+					stopOffset);
+
+			ASSERT_EQ(patterns.size(), results.size());
+			for (std::size_t i = 0; i < patterns.size(); ++i)
+			{
+				EXPECT_EQ(
+						search->findUnslashedSignature(
+								patterns[i],
+								startOffset,
+								stopOffset),
+						results[i])
+						<< "pattern " << patterns[i] << ", area "
+						<< startOffset << "-" << stopOffset;
+			}
+		}
+
+		/**
+		 * Check that findStrings() finds the first occurrence of every string
+		 * in the area exactly when hasString() reports it
+		 */
+		void expectSameStringResults(
+				const std::vector<std::string> &strs,
+				std::size_t startOffset,
+				std::size_t stopOffset)
+		{
+			const auto &plain = search->getPlainString();
+			auto results = search->findStrings(strs, startOffset, stopOffset);
+
+			ASSERT_EQ(strs.size(), results.size());
+			for (std::size_t i = 0; i < strs.size(); ++i)
+			{
+				const auto present = search->hasString(
+						strs[i],
+						startOffset,
+						stopOffset);
+				auto expected = present
+						? plain.find(strs[i], startOffset)
+						: std::string::npos;
+				EXPECT_EQ(expected, results[i])
+						<< "string " << strs[i] << ", area "
+						<< startOffset << "-" << stopOffset;
+			}
+		}
+
+		std::vector<std::uint8_t> bytes;
+		std::unique_ptr<FileFormat> parser;
+		std::unique_ptr<Search> search;
+};
+
+TEST_F(SearchTests, findUnslashedSignaturesGivesSameResultsAsFindUnslashedSignature)
+{
+	loadFile({0x55, 0x8b, 0xec, 0x83, 0xec, 0x10, 0xe8, 0x11, 0x22, 0x33, 0x44});
+	const auto end = bytes.size() - 1;
+	const std::vector<std::string> patterns = {
+		"558BEC83EC10",   // present
+		"558BEC83EC11",   // not present
+		"E8--------",     // wildcards
+		"--8BEC??EC;;",   // leading wildcards
+		"8BEC8",          // odd number of nibbles
+		"58BEC",          // starts in the middle of a byte
+		"7F454C46",       // at the beginning of the file
+		"11223344",       // at the end of the file
+		"1122334455"      // crosses the end of the file
+	};
+
+	ASSERT_NE(0, search->findUnslashedSignature(patterns[0], 0, end));
+	expectSameSignatureResults(patterns, 0, end);
+	expectSameSignatureResults(patterns, elfBytes.size(), end);
+	expectSameSignatureResults(patterns, elfBytes.size(), end + 100);
+	expectSameSignatureResults(patterns, elfBytes.size() + 1, end - 2);
+	expectSameSignatureResults(patterns, elfBytes.size(), elfBytes.size() + 3);
+	expectSameSignatureResults(patterns, end, end);
+	expectSameSignatureResults(patterns, end, 0);
+}
+
+TEST_F(SearchTests, findStringsGivesSameResultsAsHasString)
+{
+	const std::string appended = "UPX0 PEC2 .NETZ UPX1";
+	loadFile(std::vector<std::uint8_t>(appended.begin(), appended.end()));
+	const auto end = bytes.size() - 1;
+	const std::vector<std::string> strs = {
+		"UPX",        // present twice
+		"PEC2",       // present once
+		"PECompact",  // not present
+		"\x7f" "ELF", // at the beginning of the file
+		"UPX1",       // at the end of the file
+		"UPX1 "       // crosses the end of the file
+	};
+
+	ASSERT_TRUE(search->hasString(strs[0], 0, end));
+	expectSameStringResults(strs, 0, end);
+	expectSameStringResults(strs, elfBytes.size() + 1, end);
+	expectSameStringResults(strs, elfBytes.size(), end + 100);
+	expectSameStringResults(strs, elfBytes.size(), end - 1);
+	expectSameStringResults(strs, elfBytes.size() + 5, elfBytes.size() + 8);
+	expectSameStringResults(strs, end, end);
+	expectSameStringResults(strs, end, 0);
+}
+
+TEST_F(SearchTests, batchSearchesGiveSameResultsAsSingleSearchesOnRandomInputs)
+{
+	std::mt19937 gen(42);
+	loadFile(randomBytes(gen, 512));
+	const auto &nibbles = search->getNibbles();
+	const auto &plain = search->getPlainString();
+	std::uniform_int_distribution<std::size_t> offsetDist(0, bytes.size() - 1);
+	std::uniform_int_distribution<std::size_t> stopDist(0, bytes.size() + 16);
+
+	for (std::size_t round = 0; round < 200; ++round)
+	{
+		std::vector<std::string> patterns;
+		std::vector<std::string> strs;
+		for (std::size_t i = 0; i < 8; ++i)
+		{
+			patterns.push_back(randomPart(gen, nibbles, 16, wildcards + "0F"));
+			strs.push_back(randomPart(gen, plain, 8, std::string("\x42\x13", 2)));
+		}
+
+		const auto startOffset = offsetDist(gen);
+		const auto stopOffset = stopDist(gen);
+		expectSameSignatureResults(patterns, startOffset, stopOffset);
+		expectSameStringResults(strs, startOffset, stopOffset);
+		if (HasFailure())
+		{
+			return;
+		}
+	}
+}
+
+/**
+ * Not a test -- compares times of batch searches and single searches of
+ * patterns that are not present in a large file. Run with
+ * --gtest_also_run_disabled_tests to see the results.
+ */
+TEST_F(SearchTests, DISABLED_BenchmarkBatchAgainstSingleSearches)
+{
+	using Clock = std::chrono::steady_clock;
+	const std::size_t patternCount = 10;
+	const std::size_t repetitions = 5;
+
+	std::mt19937 gen(42);
+	loadFile(randomBytes(gen, 16 * 1024 * 1024));
+	const auto end = bytes.size() - 1;
+	std::vector<std::string> patterns;
+	std::vector<std::string> strs;
+	for (std::size_t i = 0; i < patternCount; ++i)
+	{
+		patterns.push_back("558BEC" + std::string(1, "0123456789ABCDEF"[i]) + "-E8");
+		strs.push_back("PECompact" + std::to_string(i));
+	}
+
+	const auto measure = [&](auto &&f)
+	{
+		const auto start = Clock::now();
+		for (std::size_t i = 0; i < repetitions; ++i)
+		{
+			f();
+		}
+		return std::chrono::duration<double, std::milli>(
+				Clock::now() - start).count() / repetitions;
+	};
+
+	unsigned long long found = 0;
+	const auto singleSignatures = measure([&]() {
+		for (const auto &p : patterns)
+		{
+			found += search->findUnslashedSignature(p, 0, end);
+		}
+	});
+	const auto batchSignatures = measure([&]() {
+		for (auto r : search->findUnslashedSignatures(patterns, 0, end))
+		{
+			found += r;
+		}
+	});
+	const auto singleStrings = measure([&]() {
+		for (const auto &s : strs)
+		{
+			found += search->hasString(s, 0, end);
+		}
+	});
+	const auto batchStrings = measure([&]() {
+		for (auto r : search->findStrings(strs, 0, end))
+		{
+			found += r != std::string::npos;
+		}
+	});
+
+	std::cout << "file size:  " << bytes.size() << " B, "
+			<< patternCount << " patterns\n"
+			<< "signatures: single " << singleSignatures << " ms, batch "
+			<< batchSignatures << " ms\n"
+			<< "strings:    single " << singleStrings << " ms, batch "
+			<< batchStrings << " ms\n";
+	EXPECT_EQ(0, found);
+}
+
+} // namespace tests
+} // namespace cpdetect
+} // namespace retdec
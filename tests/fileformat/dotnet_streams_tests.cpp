@@ -0,0 +1,228 @@
+/**
+ * @file tests/fileformat/dotnet_streams_tests.cpp
+ * @brief Tests for the \#Blob and \#Strings streams of .NET metadata.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <gtest/gtest.h>
+
+#include "retdec/fileformat/types/dotnet_headers/blob_stream.h"
+#include "retdec/fileformat/types/dotnet_headers/string_stream.h"
+
+using namespace ::testing;
+using namespace std::string_literals;
+
+namespace retdec {
+namespace fileformat {
+namespace tests {
+
+namespace {
+
+llvm::StringRef toRef(const std::vector<std::uint8_t>& bytes)
+{
+	return llvm::StringRef(
+			reinterpret_cast<const char*>(bytes.data()),
+			bytes.size());
+}
+
+} // anonymous namespace
+
+//
+// BlobCursor
+//
+
+TEST(BlobCursorTests, advanceConsumesBytesFromFront)
+{
+	std::vector<std::uint8_t> bytes = {1, 2, 3};
+	BlobCursor cursor(bytes.data(), bytes.size());
+
+	cursor.advance(1);
+
+	ASSERT_EQ(2, cursor.size());
+	EXPECT_EQ(2, cursor[0]);
+	EXPECT_EQ(3, cursor[1]);
+}
+
+TEST(BlobCursorTests, advanceBeyondEndMakesCursorEmpty)
+{
+	std::vector<std::uint8_t> bytes = {1, 2, 3};
+	BlobCursor cursor(bytes.data(), bytes.size());
+
+	cursor.advance(10);
+
+	EXPECT_TRUE(cursor.empty());
+	EXPECT_EQ(cursor.begin(), cursor.end());
+}
+
+//
+// BlobStream
+//
+
+TEST(BlobStreamTests, elementWithOneByteLengthIsReturned)
+{
+	std::vector<std::uint8_t> bytes = {0x00, 0x03, 0xAA, 0xBB, 0xCC, 0xDD};
+	BlobStream stream(toRef(bytes), 0, bytes.size());
+
+	auto element = stream.getElementCursor(1);
+
+	ASSERT_EQ(3, element.size());
+	EXPECT_EQ(bytes.data() + 2, element.begin());
+	EXPECT_EQ(std::vector<std::uint8_t>({0xAA, 0xBB, 0xCC}), stream.getElement(1));
+}
+
+TEST(BlobStreamTests, elementWithTwoByteLengthIsReturned)
+{
+	std::vector<std::uint8_t> bytes = {0x81, 0x02};
+	bytes.resize(bytes.size() + 0x102, 0x11);
+	BlobStream stream(toRef(bytes), 0, bytes.size());
+
+	auto element = stream.getElementCursor(0);
+
+	ASSERT_EQ(0x102, element.size());
+	EXPECT_EQ(bytes.data() + 2, element.begin());
+}
+
+TEST(BlobStreamTests, elementWithFourByteLengthIsReturned)
+{
+	std::vector<std::uint8_t> bytes = {0xC0, 0x00, 0x40, 0x01};
+	bytes.resize(bytes.size() + 0x4001, 0x22);
+	BlobStream stream(toRef(bytes), 0, bytes.size());
+
+	auto element = stream.getElementCursor(0);
+
+	ASSERT_EQ(0x4001, element.size());
+	EXPECT_EQ(bytes.data() + 4, element.begin());
+}
+
+TEST(BlobStreamTests, elementWithZeroLengthIsEmpty)
+{
+	std::vector<std::uint8_t> bytes = {0x00};
+	BlobStream stream(toRef(bytes), 0, bytes.size());
+
+	EXPECT_TRUE(stream.getElementCursor(0).empty());
+	EXPECT_TRUE(stream.getElement(0).empty());
+}
+
+TEST(BlobStreamTests, elementOutOfStreamIsEmpty)
+{
+	std::vector<std::uint8_t> bytes = {0x01, 0xAA};
+	BlobStream stream(toRef(bytes), 0, bytes.size());
+
+	EXPECT_TRUE(stream.getElementCursor(2).empty());
+	EXPECT_TRUE(stream.getElementCursor(1000).empty());
+	EXPECT_TRUE(stream.getElement(1000).empty());
+}
+
+TEST(BlobStreamTests, truncatedElementIsEmpty)
+{
+	std::vector<std::uint8_t> bytes = {0x05, 0xAA, 0xBB};
+	BlobStream stream(toRef(bytes), 0, bytes.size());
+
+	EXPECT_TRUE(stream.getElementCursor(0).empty());
+}
+
+TEST(BlobStreamTests, truncatedLengthIsEmpty)
+{
+	std::vector<std::uint8_t> twoBytes = {0x00, 0x81};
+	BlobStream twoStream(toRef(twoBytes), 0, twoBytes.size());
+	std::vector<std::uint8_t> fourBytes = {0xC0, 0x00, 0x01};
+	BlobStream fourStream(toRef(fourBytes), 0, fourBytes.size());
+
+	EXPECT_TRUE(twoStream.getElementCursor(1).empty());
+	EXPECT_TRUE(fourStream.getElementCursor(0).empty());
+}
+
+TEST(BlobStreamTests, oversizedElementIsEmpty)
+{
+	std::vector<std::uint8_t> bytes = {0xDF, 0xFF, 0xFF, 0xFF, 0xAA, 0xBB};
+	BlobStream stream(toRef(bytes), 0, bytes.size());
+
+	EXPECT_TRUE(stream.getElementCursor(0).empty());
+	EXPECT_TRUE(stream.getElement(0).empty());
+}
+
+TEST(BlobStreamTests, elementWithInvalidLengthPrefixIsEmpty)
+{
+	std::vector<std::uint8_t> bytes = {0xE0, 0x00, 0x00, 0x00, 0x00};
+	BlobStream stream(toRef(bytes), 0, bytes.size());
+
+	EXPECT_TRUE(stream.getElementCursor(0).empty());
+}
+
+//
+// StringStream
+//
+
+TEST(StringStreamTests, firstStringIsEmpty)
+{
+	std::string bytes = "\0abc\0"s;
+	StringStream stream(bytes, 0, bytes.size());
+
+	std::string result = "x";
+	ASSERT_TRUE(stream.getString(0, result));
+	EXPECT_EQ("", result);
+}
+
+TEST(StringStreamTests, stringIsReturnedWithoutCopy)
+{
+	std::string bytes = "\0abc\0de\0"s;
+	StringStream stream(bytes, 0, bytes.size());
+
+	llvm::StringRef ref;
+	ASSERT_TRUE(stream.getStringRef(5, ref));
+	EXPECT_EQ("de", ref.str());
+	EXPECT_EQ(bytes.data() + 5, ref.data());
+}
+
+TEST(StringStreamTests, stringInTheMiddleOfAnotherStringIsReturned)
+{
+	std::string bytes = "\0abc\0"s;
+	StringStream stream(bytes, 0, bytes.size());
+
+	std::string result;
+	ASSERT_TRUE(stream.getString(2, result));
+	EXPECT_EQ("bc", result);
+}
+
+TEST(StringStreamTests, terminatorOfNonEmptyStringIsNotString)
+{
+	std::string bytes = "\0abc\0"s;
+	StringStream stream(bytes, 0, bytes.size());
+
+	std::string result;
+	EXPECT_FALSE(stream.getString(4, result));
+}
+
+TEST(StringStreamTests, offsetOutOfStreamIsNotString)
+{
+	std::string bytes = "\0abc\0"s;
+	StringStream stream(bytes, 0, bytes.size());
+
+	std::string result;
+	EXPECT_FALSE(stream.getString(5, result));
+	EXPECT_FALSE(stream.getString(1000, result));
+}
+
+TEST(StringStreamTests, offsetOutOfTruncatedStreamIsNotString)
+{
+	// Stream header declares more bytes than are present in the file.
+	std::string bytes = "\0abc"s;
+	StringStream stream(bytes, 0, 16);
+
+	std::string result;
+	EXPECT_FALSE(stream.getString(8, result));
+}
+
+TEST(StringStreamTests, unterminatedStringEndsAtEndOfStream)
+{
+	std::string bytes = "\0abc"s;
+	StringStream stream(bytes, 0, 16);
+
+	std::string result;
+	ASSERT_TRUE(stream.getString(1, result));
+	EXPECT_EQ("abc", result);
+}
+
+} // namespace tests
+} // namespace fileformat
+} // namespace retdec
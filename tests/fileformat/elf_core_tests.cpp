@@ -0,0 +1,70 @@
+/**
+ * @file tests/fileformat/elf_core_tests.cpp
+ * @brief Tests for the @c elf_core module.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <gtest/gtest.h>
+
+#include "retdec/fileformat/types/note_section/elf_core.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace fileformat {
+namespace tests {
+
+class ElfCoreInfoTests : public Test
+{
+	protected:
+		FileMapEntry entry(
+				std::uint64_t start,
+				std::uint64_t end,
+				const std::string &path)
+		{
+			return FileMapEntry{start, end, 0, path};
+		}
+};
+
+TEST_F(ElfCoreInfoTests, fileMapEntryIsFoundByAddress)
+{
+	ElfCoreInfo info;
+	info.addFileMapEntry(entry(0x3000, 0x4000, "c"));
+	info.addFileMapEntry(entry(0x1000, 0x2000, "a"));
+	info.addFileMapEntry(entry(0x2000, 0x2800, "b"));
+
+	ASSERT_EQ(3, info.getFileMap().size());
+	EXPECT_EQ("c", info.getFileMap().front().filePath);
+	EXPECT_EQ(nullptr, info.getFileMapEntry(0x0));
+	EXPECT_EQ("a", info.getFileMapEntry(0x1000)->filePath);
+	EXPECT_EQ("a", info.getFileMapEntry(0x1fff)->filePath);
+	EXPECT_EQ("b", info.getFileMapEntry(0x2000)->filePath);
+	EXPECT_EQ(nullptr, info.getFileMapEntry(0x2800));
+	EXPECT_EQ("c", info.getFileMapEntry(0x3abc)->filePath);
+	EXPECT_EQ(nullptr, info.getFileMapEntry(0x4000));
+}
+
+TEST_F(ElfCoreInfoTests, mergeAppendsInOrder)
+{
+	ElfCoreInfo info, first, second;
+	first.setPageSize(0x1000);
+	first.addFileMapEntry(entry(0x1000, 0x2000, "a"));
+	first.addAuxVectorEntry({1, 2});
+	second.addFileMapEntry(entry(0x5000, 0x6000, "b"));
+	second.addAuxVectorEntry({3, 4});
+
+	info.merge(first);
+	info.merge(second);
+
+	EXPECT_EQ(0x1000, info.getPageSize());
+	ASSERT_EQ(2, info.getFileMap().size());
+	EXPECT_EQ("a", info.getFileMap()[0].filePath);
+	EXPECT_EQ("b", info.getFileMap()[1].filePath);
+	EXPECT_EQ("b", info.getFileMapEntry(0x5000)->filePath);
+	ASSERT_EQ(2, info.getAuxVector().size());
+	EXPECT_EQ(3, info.getAuxVector()[1].first);
+}
+
+} // namespace tests
+} // namespace fileformat
+} // namespace retdec
@@ -116,6 +116,68 @@ TEST_F(ElfFormatTests_data, DataInterpretationDefault)
 	EXPECT_EQ(0x48010101464c457f, res);
 }
 
+/**
+ * ELF format exposing whether the hashes of the whole file were computed.
+ */
+class HashObservingElfFormat : public ElfFormat
+{
+	public:
+		using ElfFormat::ElfFormat;
+
+		bool fileHashesComputed() const
+		{
+			return !crc32.empty() || !md5.empty() || !sha256.empty();
+		}
+};
+
+/**
+ * Tests for the @c elf_format module - loading of core dumps.
+ */
+class ElfFormatTests_core : public Test
+{
+	protected:
+		std::vector<uint8_t> coreBytes = elfBytes;
+	public:
+		ElfFormatTests_core()
+		{
+			coreBytes[16] = ET_CORE;
+		}
+};
+
+TEST_F(ElfFormatTests_core, fileHashesOfCoreAreComputedOnRequest)
+{
+	HashObservingElfFormat parser(coreBytes.data(), coreBytes.size());
+	ASSERT_TRUE(parser.isInValidState());
+	EXPECT_TRUE(parser.getLoadFlags() & LoadFlags::LAZY_DIGESTS);
+	EXPECT_FALSE(parser.fileHashesComputed());
+
+	EXPECT_TRUE(parser.hasCrc32());
+	EXPECT_TRUE(parser.fileHashesComputed());
+
+	HashObservingElfFormat eager(elfBytes.data(), elfBytes.size());
+	EXPECT_EQ(eager.getCrc32(), parser.getCrc32());
+	EXPECT_EQ(eager.getMd5(), parser.getMd5());
+	EXPECT_EQ(eager.getSha256(), parser.getSha256());
+}
+
+TEST_F(ElfFormatTests_core, coreIsDetectedBeforeReadingStream)
+{
+	std::stringstream coreStream(std::string(coreBytes.begin(), coreBytes.end()));
+	HashObservingElfFormat parser(coreStream);
+
+	EXPECT_TRUE(parser.isInValidState());
+	EXPECT_EQ(2, parser.getNumberOfSegments());
+	EXPECT_FALSE(parser.fileHashesComputed());
+}
+
+TEST_F(ElfFormatTests_core, fileHashesOfExecutableAreComputedAtLoad)
+{
+	HashObservingElfFormat parser(elfBytes.data(), elfBytes.size());
+
+	EXPECT_FALSE(parser.getLoadFlags() & LoadFlags::LAZY_DIGESTS);
+	EXPECT_TRUE(parser.fileHashesComputed());
+}
+
 } // namespace tests
 } // namespace fileformat
 } // namespace retdec
@@ -0,0 +1,338 @@
+/**
+ * @file tests/fileformat/symbol_table_tests.cpp
+ * @brief Tests for the @c symbol_table module.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/fileformat/types/symbol_table/symbol_table.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace fileformat {
+namespace tests {
+
+class SymbolTableTests : public Test
+{
+	protected:
+		std::shared_ptr<Symbol> addSymbol(
+				const std::string &name,
+				unsigned long long index,
+				unsigned long long address,
+				bool thumb = false)
+		{
+			auto symbol = std::make_shared<Symbol>();
+			symbol->setName(name);
+			symbol->setIndex(index);
+			symbol->setAddress(address);
+			symbol->setLinkToSection(1);
+			symbol->setIsThumbSymbol(thumb);
+			symbol->setUsageType(Symbol::UsageType::FUNCTION);
+			table.addSymbol(symbol);
+			return symbol;
+		}
+
+	protected:
+		SymbolTable table;
+};
+
+TEST_F(SymbolTableTests, lookupsReturnFirstMatchingSymbol)
+{
+	auto s1 = addSymbol("a", 0, 0x1000);
+	auto s2 = addSymbol("b", 1, 0x2000);
+	addSymbol("a", 2, 0x2000);
+	const auto &cTable = table;
+
+	EXPECT_EQ(s1.get(), cTable.getSymbol("a"));
+	EXPECT_EQ(s2.get(), cTable.getSymbol("b"));
+	EXPECT_EQ(nullptr, cTable.getSymbol("c"));
+	EXPECT_EQ(s2.get(), cTable.getSymbolOnAddress(0x2000));
+	EXPECT_EQ(nullptr, cTable.getSymbolOnAddress(0x3000));
+	EXPECT_EQ(s2.get(), cTable.getSymbolWithIndex(1));
+	EXPECT_EQ(nullptr, cTable.getSymbolWithIndex(3));
+}
+
+TEST_F(SymbolTableTests, symbolsAddedAfterLookupAreFound)
+{
+	addSymbol("a", 0, 0x1000);
+	const auto &cTable = table;
+	EXPECT_FALSE(cTable.hasSymbol("b"));
+
+	auto s2 = addSymbol("b", 1, 0x2000);
+
+	EXPECT_EQ(s2.get(), cTable.getSymbol("b"));
+	EXPECT_TRUE(cTable.hasSymbol(0x2000));
+}
+
+TEST_F(SymbolTableTests, symbolsModifiedThroughNonConstAccessAreReindexed)
+{
+	addSymbol("a", 0, 0x1000);
+	const auto &cTable = table;
+	EXPECT_TRUE(cTable.hasSymbol(0x1000));
+
+	for (auto &s : table)
+	{
+		s->setAddress(0x5000);
+		s->setName("renamed");
+	}
+
+	EXPECT_FALSE(cTable.hasSymbol(0x1000));
+	EXPECT_TRUE(cTable.hasSymbol(0x5000));
+	EXPECT_FALSE(cTable.hasSymbol("a"));
+	EXPECT_TRUE(cTable.hasSymbol("renamed"));
+}
+
+TEST_F(SymbolTableTests, symbolsModifiedThroughConstIteratorAreReindexed)
+{
+	addSymbol("a", 0, 0x1000);
+	const auto &cTable = table;
+	EXPECT_TRUE(cTable.hasSymbol("a"));
+
+	for (auto it = cTable.begin(), e = cTable.end(); it != e; ++it)
+	{
+		(*it)->setAddress(0x5000);
+		(*it)->setName("renamed");
+	}
+
+	EXPECT_FALSE(cTable.hasSymbol(0x1000));
+	EXPECT_EQ(table.getSymbol(0), cTable.getSymbolOnAddress(0x5000));
+	EXPECT_EQ(nullptr, cTable.getSymbol("a"));
+	EXPECT_EQ(table.getSymbol(0), cTable.getSymbol("renamed"));
+}
+
+TEST_F(SymbolTableTests, symbolModifiedThroughNonConstGetterIsReindexed)
+{
+	for (unsigned long long i = 0; i < 64; ++i)
+	{
+		addSymbol("s" + std::to_string(i), i, 0x1000 + i);
+	}
+	auto s64 = addSymbol("s1", 64, 0x1001);
+	const auto &cTable = table;
+	EXPECT_EQ(table.getSymbol(1), cTable.getSymbol("s1"));
+
+	auto *s1 = table.getSymbolOnAddress(0x1001);
+	ASSERT_NE(nullptr, s1);
+	s1->setAddress(0x9000);
+	s1->setName("moved");
+	s1->setIndex(100);
+
+	EXPECT_EQ(s1, cTable.getSymbolOnAddress(0x9000));
+	EXPECT_EQ(s1, cTable.getSymbol("moved"));
+	EXPECT_EQ(s1, cTable.getSymbolWithIndex(100));
+	EXPECT_EQ(nullptr, cTable.getSymbolWithIndex(1));
+	EXPECT_EQ(s64.get(), cTable.getSymbolOnAddress(0x1001));
+	EXPECT_EQ(s64.get(), cTable.getSymbol("s1"));
+	EXPECT_EQ(table.getSymbol(2), cTable.getSymbolOnAddress(0x1002));
+	EXPECT_EQ("moved", cTable.getStore().getName(1));
+}
+
+TEST_F(SymbolTableTests, symbolMovedBeforeFirstMatchBecomesFirstMatch)
+{
+	for (unsigned long long i = 0; i < 64; ++i)
+	{
+		addSymbol("s" + std::to_string(i), i, 0x1000 + i);
+	}
+	const auto &cTable = table;
+	EXPECT_EQ(table.getSymbol(10), cTable.getSymbol("s10"));
+
+	auto *s5 = table.getSymbol(5);
+	s5->setName("s10");
+	s5->setAddress(0x100a);
+
+	EXPECT_EQ(s5, cTable.getSymbol("s10"));
+	EXPECT_EQ(s5, cTable.getSymbolOnAddress(0x100a));
+	EXPECT_FALSE(cTable.hasSymbol("s5"));
+	EXPECT_FALSE(cTable.hasSymbol(0x1005));
+}
+
+TEST_F(SymbolTableTests, iteratingWithoutChangesKeepsStore)
+{
+	for (unsigned long long i = 0; i < 64; ++i)
+	{
+		addSymbol("s" + std::to_string(i), i, 0x1000 + i);
+	}
+	const auto &cTable = table;
+	const auto *name = cTable.getStore().getName(3).data();
+
+	for (auto &s : table)
+	{
+		(void)s;
+	}
+
+	EXPECT_EQ(table.getSymbol(3), cTable.getSymbol("s3"));
+	EXPECT_EQ(name, cTable.getStore().getName(3).data());
+}
+
+TEST_F(SymbolTableTests, storeInternsNamesAndKeepsSymbolOrder)
+{
+	addSymbol("a", 0, 0x1000);
+	addSymbol("b", 1, 0x2001, true);
+	addSymbol("a", 2, 0x3000);
+
+	const auto &store = table.getStore();
+	ASSERT_EQ(3, store.size());
+	EXPECT_EQ(2, store.getNumberOfNames());
+	EXPECT_EQ(store.getNameId(0), store.getNameId(2));
+	EXPECT_EQ("b", store.getName(1));
+
+	unsigned long long a = 0;
+	EXPECT_TRUE(store.getAddress(1, a));
+	EXPECT_EQ(0x2001, a);
+	EXPECT_TRUE(store.getRealAddress(1, a));
+	EXPECT_EQ(0x2000, a);
+	EXPECT_EQ(2, store.getIndex(2));
+	EXPECT_EQ(Symbol::UsageType::FUNCTION, store.getUsageType(0));
+}
+
+TEST_F(SymbolTableTests, symbolKeptAcrossLookupsIsReindexedWhenModified)
+{
+	addSymbol("a", 0, 0x1000);
+	addSymbol("b", 1, 0x2000);
+	const auto &cTable = table;
+	auto *b = table.getSymbol("b");
+	ASSERT_NE(nullptr, b);
+	EXPECT_TRUE(cTable.hasSymbol("a"));
+
+	b->setName("c");
+	b->setAddress(0x3000);
+
+	EXPECT_EQ(b, cTable.getSymbol("c"));
+	EXPECT_EQ(b, cTable.getSymbolOnAddress(0x3000));
+	EXPECT_FALSE(cTable.hasSymbol("b"));
+	EXPECT_FALSE(cTable.hasSymbol(0x2000));
+
+	b->setName("d");
+
+	EXPECT_EQ(b, cTable.getSymbol("d"));
+	EXPECT_FALSE(cTable.hasSymbol("c"));
+}
+
+TEST_F(SymbolTableTests, renamingFirstOfSymbolsWithSameNameFindsNextOne)
+{
+	for (unsigned long long i = 0; i < 64; ++i)
+	{
+		addSymbol("s" + std::to_string(i), i, 0x1000 + i);
+	}
+	auto a1 = addSymbol("a", 64, 0x2000);
+	auto a2 = addSymbol("a", 65, 0x2001);
+	const auto &cTable = table;
+	EXPECT_EQ(a1.get(), cTable.getSymbol("a"));
+
+	a1->setName("z");
+
+	EXPECT_EQ(a2.get(), cTable.getSymbol("a"));
+	EXPECT_EQ(a1.get(), cTable.getSymbol("z"));
+	EXPECT_EQ("z", cTable.getStore().getName(64));
+	EXPECT_EQ("a", cTable.getStore().getName(65));
+}
+
+TEST_F(SymbolTableTests, assignedSymbolIsReindexed)
+{
+	for (unsigned long long i = 0; i < 64; ++i)
+	{
+		addSymbol("s" + std::to_string(i), i, 0x1000 + i);
+	}
+	const auto &cTable = table;
+	EXPECT_TRUE(cTable.hasSymbol("s3"));
+
+	Symbol other;
+	other.setName("other");
+	other.setAddress(0x9000);
+	*table.getSymbol(3) = other;
+
+	EXPECT_EQ(table.getSymbol(3), cTable.getSymbol("other"));
+	EXPECT_EQ(table.getSymbol(3), cTable.getSymbolOnAddress(0x9000));
+	EXPECT_FALSE(cTable.hasSymbol("s3"));
+}
+
+TEST_F(SymbolTableTests, copyOfStoredSymbolIsNotIndexed)
+{
+	auto s1 = addSymbol("a", 0, 0x1000);
+	const auto &cTable = table;
+	EXPECT_TRUE(cTable.hasSymbol("a"));
+
+	Symbol copy(*s1);
+	copy.setName("copy");
+	copy.setAddress(0x2000);
+
+	EXPECT_EQ(s1.get(), cTable.getSymbol("a"));
+	EXPECT_FALSE(cTable.hasSymbol("copy"));
+	EXPECT_FALSE(cTable.hasSymbol(0x2000));
+}
+
+TEST_F(SymbolTableTests, manyModifiedSymbolsAreReindexed)
+{
+	for (unsigned long long i = 0; i < 64; ++i)
+	{
+		addSymbol("s" + std::to_string(i), i, 0x1000 + i);
+	}
+	const auto &cTable = table;
+	EXPECT_TRUE(cTable.hasSymbol("s0"));
+
+	for (auto &s : table)
+	{
+		s->setName("t" + s->getName());
+	}
+
+	EXPECT_FALSE(cTable.hasSymbol("s5"));
+	EXPECT_EQ(table.getSymbol(5), cTable.getSymbol("ts5"));
+	EXPECT_EQ(table.getSymbol(63), cTable.getSymbol("ts63"));
+}
+
+TEST_F(SymbolTableTests, symbolsOutliveTheirTable)
+{
+	auto symbol = std::make_shared<Symbol>();
+	{
+		SymbolTable other;
+		other.addSymbol(symbol);
+		EXPECT_TRUE(other.hasSymbol(""));
+	}
+	symbol->setName("a");
+
+	auto s1 = addSymbol("b", 0, 0x1000);
+	EXPECT_TRUE(table.hasSymbol("b"));
+	table.clear();
+	s1->setName("c");
+	EXPECT_FALSE(table.hasSymbol("c"));
+}
+
+TEST_F(SymbolTableTests, concurrentLookupsFindSymbols)
+{
+	for (unsigned long long i = 0; i < 256; ++i)
+	{
+		addSymbol("s" + std::to_string(i), i, 0x1000 + i);
+	}
+	const auto &cTable = table;
+
+	std::vector<std::thread> threads;
+	std::vector<int> found(4, 0);
+	for (std::size_t t = 0; t < found.size(); ++t)
+	{
+		threads.emplace_back([&, t]()
+		{
+			bool all = true;
+			for (unsigned long long i = 0; i < 256; ++i)
+			{
+				all = all
+						&& cTable.getSymbol("s" + std::to_string(i)) == cTable.getSymbol(i)
+						&& cTable.getSymbolOnAddress(0x1000 + i) == cTable.getSymbol(i);
+			}
+			found[t] = all;
+		});
+	}
+	for (auto &t : threads)
+	{
+		t.join();
+	}
+
+	EXPECT_EQ(std::vector<int>(4, 1), found);
+}
+
+} // namespace tests
+} // namespace fileformat
+} // namespace retdec
@@ -0,0 +1,227 @@
+/**
+* @file tests/llvmir2hll/analysis/def_use_analysis_tests.cpp
+* @brief Tests for the @c def_use_analysis module.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <chrono>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include "retdec/llvmir2hll/analysis/def_use_analysis.h"
+#include "llvmir2hll/analysis/tests_with_value_analysis.h"
+#include "retdec/llvmir2hll/graphs/cfg/cfg.h"
+#include "retdec/llvmir2hll/graphs/cfg/cfg_builders/non_recursive_cfg_builder.h"
+#include "retdec/llvmir2hll/ir/add_op_expr.h"
+#include "retdec/llvmir2hll/ir/assign_stmt.h"
+#include "retdec/llvmir2hll/ir/const_int.h"
+#include "retdec/llvmir2hll/ir/if_stmt.h"
+#include "retdec/llvmir2hll/ir/int_type.h"
+#include "llvmir2hll/ir/tests_with_module.h"
+#include "retdec/llvmir2hll/ir/variable.h"
+#include "retdec/llvmir2hll/ir/while_loop_stmt.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace llvmir2hll {
+namespace tests {
+
+/**
+* @brief Tests for the @c def_use_analysis module.
+*/
+class DefUseAnalysisTests: public TestsWithModule {
+protected:
+	virtual void SetUp() override {
+		TestsWithModule::SetUp();
+		cfgBuilder = NonRecursiveCFGBuilder::create();
+		varA = Variable::create("a", IntType::create(32));
+		varB = Variable::create("b", IntType::create(32));
+		varC = Variable::create("c", IntType::create(32));
+		testFunc->addLocalVar(varA);
+		testFunc->addLocalVar(varB);
+		testFunc->addLocalVar(varC);
+	}
+
+	/// Returns the def-use chain of @a var defined in @a stmt.
+	StmtSet getDU(ShPtr<DefUseChains> ducs, ShPtr<Statement> stmt,
+			ShPtr<Variable> var) {
+		for (const auto &p : ducs->du) {
+			if (p.first.first == stmt && p.first.second == var) {
+				return p.second;
+			}
+		}
+		ADD_FAILURE() << "there is no def-use chain for " << var->getName();
+		return StmtSet();
+	}
+
+protected:
+	ShPtr<CFGBuilder> cfgBuilder;
+	ShPtr<Variable> varA;
+	ShPtr<Variable> varB;
+	ShPtr<Variable> varC;
+};
+
+TEST_F(DefUseAnalysisTests,
+DefUseChainContainsUsesReachableFromDefinition) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     a = 1;
+	//     if (c) {
+	//         b = a;
+	//     }
+	//     c = a;
+	// }
+	//
+	ShPtr<AssignStmt> assignBA(AssignStmt::create(varB, varA));
+	ShPtr<AssignStmt> assignCA(AssignStmt::create(varC, varA));
+	ShPtr<AssignStmt> assignA1(AssignStmt::create(varA, ConstInt::create(1, 32),
+		IfStmt::create(varC, assignBA, assignCA)));
+	testFunc->setBody(assignA1);
+
+	INSTANTIATE_ALIAS_ANALYSIS_AND_VALUE_ANALYSIS(module);
+	ShPtr<DefUseAnalysis> dua(DefUseAnalysis::create(module, va));
+	ShPtr<DefUseChains> ducs(dua->getDefUseChains(testFunc,
+		cfgBuilder->getCFG(testFunc)));
+
+	EXPECT_EQ(StmtSet({assignBA, assignCA}), getDU(ducs, assignA1, varA));
+	EXPECT_EQ(StmtSet(), getDU(ducs, assignBA, varB));
+}
+
+TEST_F(DefUseAnalysisTests,
+RedefinitionOfVarEndsDefUseChain) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     a = 1;
+	//     a = 2;
+	//     b = a;
+	// }
+	//
+	ShPtr<AssignStmt> assignBA(AssignStmt::create(varB, varA));
+	ShPtr<AssignStmt> assignA2(AssignStmt::create(varA, ConstInt::create(2, 32), assignBA));
+	ShPtr<AssignStmt> assignA1(AssignStmt::create(varA, ConstInt::create(1, 32), assignA2));
+	testFunc->setBody(assignA1);
+
+	INSTANTIATE_ALIAS_ANALYSIS_AND_VALUE_ANALYSIS(module);
+	ShPtr<DefUseAnalysis> dua(DefUseAnalysis::create(module, va));
+	ShPtr<DefUseChains> ducs(dua->getDefUseChains(testFunc,
+		cfgBuilder->getCFG(testFunc)));
+
+	EXPECT_EQ(StmtSet(), getDU(ducs, assignA1, varA));
+	EXPECT_EQ(StmtSet({assignBA}), getDU(ducs, assignA2, varA));
+}
+
+TEST_F(DefUseAnalysisTests,
+DefUseChainContainsUsesInNextIterationOfLoop) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     a = 1;
+	//     while (c) {
+	//         b = a;
+	//         a = 2;
+	//     }
+	// }
+	//
+	ShPtr<AssignStmt> assignA2(AssignStmt::create(varA, ConstInt::create(2, 32)));
+	ShPtr<AssignStmt> assignBA(AssignStmt::create(varB, varA, assignA2));
+	ShPtr<AssignStmt> assignA1(AssignStmt::create(varA, ConstInt::create(1, 32),
+		WhileLoopStmt::create(varC, assignBA)));
+	testFunc->setBody(assignA1);
+
+	INSTANTIATE_ALIAS_ANALYSIS_AND_VALUE_ANALYSIS(module);
+	ShPtr<DefUseAnalysis> dua(DefUseAnalysis::create(module, va));
+	ShPtr<DefUseChains> ducs(dua->getDefUseChains(testFunc,
+		cfgBuilder->getCFG(testFunc)));
+
+	EXPECT_EQ(StmtSet({assignBA}), getDU(ducs, assignA1, varA));
+	EXPECT_EQ(StmtSet({assignBA}), getDU(ducs, assignA2, varA));
+}
+
+TEST_F(DefUseAnalysisTests,
+UsesOfVarsThatShouldNotBeIncludedAreNotConsidered) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     a = 1;
+	//     b = a;
+	//     c = b;
+	// }
+	//
+	ShPtr<AssignStmt> assignCB(AssignStmt::create(varC, varB));
+	ShPtr<AssignStmt> assignBA(AssignStmt::create(varB, varA, assignCB));
+	ShPtr<AssignStmt> assignA1(AssignStmt::create(varA, ConstInt::create(1, 32), assignBA));
+	testFunc->setBody(assignA1);
+
+	INSTANTIATE_ALIAS_ANALYSIS_AND_VALUE_ANALYSIS(module);
+	ShPtr<DefUseAnalysis> dua(DefUseAnalysis::create(module, va));
+	ShPtr<DefUseChains> ducs(dua->getDefUseChains(testFunc,
+		cfgBuilder->getCFG(testFunc),
+		[this](auto var) { return var != varA; }));
+
+	ASSERT_EQ(1, ducs->uses.size());
+	EXPECT_EQ(DefUseChains::StmtVarPair(assignCB, varB), ducs->uses[0]);
+	EXPECT_EQ(StmtSet({assignCB}), getDU(ducs, assignBA, varB));
+}
+
+/**
+* Not a test -- measures the computation of def-use chains in a function with
+* thousands of variables. Run with --gtest_also_run_disabled_tests to see the
+* results.
+*/
+TEST_F(DefUseAnalysisTests,
+DISABLED_BenchmarkFunctionWithThousandsOfVars) {
+	using Clock = std::chrono::steady_clock;
+
+	// Set-up the module.
+	//
+	// void test() {
+	//     while (c) {
+	//         v1 = v0 + v7;
+	//         if (c) {
+	//             v2 = v1 + v14;
+	//         }
+	//         v3 = v2 + v21;
+	//         ...
+	//     }
+	// }
+	//
+	const std::size_t NUM_OF_VARS = 5000;
+	VarVector vars;
+	for (std::size_t i = 0; i < NUM_OF_VARS; ++i) {
+		vars.push_back(Variable::create("v" + std::to_string(i), IntType::create(32)));
+		testFunc->addLocalVar(vars.back());
+	}
+	ShPtr<Statement> body;
+	for (std::size_t i = NUM_OF_VARS - 1; i > 0; --i) {
+		ShPtr<Statement> stmt(AssignStmt::create(vars[i],
+			AddOpExpr::create(vars[i - 1], vars[(i * 7) % NUM_OF_VARS])));
+		if (i % 2 == 0) {
+			body = IfStmt::create(varC, stmt, body);
+		} else {
+			stmt->setSuccessor(body);
+			body = stmt;
+		}
+	}
+	testFunc->setBody(WhileLoopStmt::create(varC, body));
+
+	INSTANTIATE_ALIAS_ANALYSIS_AND_VALUE_ANALYSIS(module);
+	ShPtr<CFG> cfg(cfgBuilder->getCFG(testFunc));
+	ShPtr<DefUseAnalysis> dua(DefUseAnalysis::create(module, va));
+
+	auto start = Clock::now();
+	ShPtr<DefUseChains> ducs(dua->getDefUseChains(testFunc, cfg));
+	auto ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	std::cout << NUM_OF_VARS << " variables, " << cfg->getNumberOfNodes()
+		<< " CFG nodes, " << ducs->uses.size() << " uses: " << ms << " ms, "
+		<< ducs->dataflow->getNumOfNodeEvaluations() << " node evaluations"
+		<< std::endl;
+}
+
+} // namespace tests
+} // namespace llvmir2hll
+} // namespace retdec
@@ -0,0 +1,197 @@
+/**
+* @file tests/llvmir2hll/graphs/cfg/bit_vector_dataflow_tests.cpp
+* @brief Tests for the @c bit_vector_dataflow module.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <gtest/gtest.h>
+
+#include "retdec/llvmir2hll/graphs/cfg/bit_vector_dataflow.h"
+#include "retdec/llvmir2hll/graphs/cfg/cfg.h"
+#include "retdec/llvmir2hll/graphs/cfg/cfg_builders/non_recursive_cfg_builder.h"
+#include "retdec/llvmir2hll/ir/assign_stmt.h"
+#include "retdec/llvmir2hll/ir/const_int.h"
+#include "retdec/llvmir2hll/ir/if_stmt.h"
+#include "retdec/llvmir2hll/ir/int_type.h"
+#include "llvmir2hll/ir/tests_with_module.h"
+#include "retdec/llvmir2hll/ir/variable.h"
+#include "retdec/llvmir2hll/ir/while_loop_stmt.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace llvmir2hll {
+namespace tests {
+
+/**
+* @brief Tests for the @c bit_vector_dataflow module.
+*/
+class BitVectorDataflowTests: public TestsWithModule {
+protected:
+	virtual void SetUp() override {
+		TestsWithModule::SetUp();
+		cfgBuilder = NonRecursiveCFGBuilder::create();
+		varA = Variable::create("a", IntType::create(32));
+		varB = Variable::create("b", IntType::create(32));
+		varC = Variable::create("c", IntType::create(32));
+		testFunc->addLocalVar(varA);
+		testFunc->addLocalVar(varB);
+		testFunc->addLocalVar(varC);
+	}
+
+	/// Returns the CFG node containing @a stmt.
+	ShPtr<CFG::Node> getNode(ShPtr<CFG> cfg, ShPtr<Statement> stmt) {
+		return cfg->getNodeForStmt(stmt).first;
+	}
+
+	/// Returns a bit vector of size @a size with the given bits set.
+	llvm::BitVector bits(std::size_t size, std::initializer_list<unsigned> setBits) {
+		llvm::BitVector result(size);
+		for (auto bit : setBits) {
+			result.set(bit);
+		}
+		return result;
+	}
+
+protected:
+	ShPtr<CFGBuilder> cfgBuilder;
+	ShPtr<Variable> varA;
+	ShPtr<Variable> varB;
+	ShPtr<Variable> varC;
+};
+
+TEST_F(BitVectorDataflowTests,
+ForwardUnionProblemPropagatesFactsAlongAnyPath) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     a = 1;      // GEN = {0}
+	//     if (c) {
+	//         b = 2;  // GEN = {1}, KILL = {0}
+	//     }
+	// }
+	//
+	ShPtr<AssignStmt> assignB2(AssignStmt::create(varB, ConstInt::create(2, 32)));
+	ShPtr<IfStmt> ifStmt(IfStmt::create(varC, assignB2));
+	ShPtr<AssignStmt> assignA1(AssignStmt::create(varA, ConstInt::create(1, 32), ifStmt));
+	testFunc->setBody(assignA1);
+	ShPtr<CFG> cfg(cfgBuilder->getCFG(testFunc));
+
+	BitVectorDataflow dataflow(cfg, 2, BitVectorDataflow::Direction::Forward);
+	dataflow.getGen(getNode(cfg, assignA1)).set(0);
+	dataflow.getGen(getNode(cfg, assignB2)).set(1);
+	dataflow.getKill(getNode(cfg, assignB2)).set(0);
+	dataflow.solve();
+
+	EXPECT_EQ(bits(2, {}), dataflow.getIn(cfg->getEntryNode()));
+	EXPECT_EQ(bits(2, {0}), dataflow.getIn(getNode(cfg, assignB2)));
+	EXPECT_EQ(bits(2, {1}), dataflow.getOut(getNode(cfg, assignB2)));
+	EXPECT_EQ(bits(2, {0, 1}), dataflow.getIn(cfg->getExitNode()));
+}
+
+TEST_F(BitVectorDataflowTests,
+ForwardIntersectionProblemPropagatesOnlyFactsFromAllPaths) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     a = 1;      // GEN = {0, 1}
+	//     if (c) {
+	//         b = 2;  // KILL = {0}
+	//     }
+	// }
+	//
+	ShPtr<AssignStmt> assignB2(AssignStmt::create(varB, ConstInt::create(2, 32)));
+	ShPtr<IfStmt> ifStmt(IfStmt::create(varC, assignB2));
+	ShPtr<AssignStmt> assignA1(AssignStmt::create(varA, ConstInt::create(1, 32), ifStmt));
+	testFunc->setBody(assignA1);
+	ShPtr<CFG> cfg(cfgBuilder->getCFG(testFunc));
+
+	BitVectorDataflow dataflow(cfg, 2, BitVectorDataflow::Direction::Forward,
+		BitVectorDataflow::Meet::Intersection);
+	dataflow.getGen(getNode(cfg, assignA1)) = bits(2, {0, 1});
+	dataflow.getKill(getNode(cfg, assignB2)).set(0);
+	dataflow.solve();
+
+	EXPECT_EQ(bits(2, {}), dataflow.getIn(cfg->getEntryNode()));
+	EXPECT_EQ(bits(2, {1}), dataflow.getIn(cfg->getExitNode()));
+}
+
+TEST_F(BitVectorDataflowTests,
+BackwardProblemPropagatesFactsAroundLoops) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     while (c) {
+	//         a = 1;  // GEN = {0}
+	//     }
+	//     b = 2;      // GEN = {1}
+	// }
+	//
+	ShPtr<AssignStmt> assignB2(AssignStmt::create(varB, ConstInt::create(2, 32)));
+	ShPtr<AssignStmt> assignA1(AssignStmt::create(varA, ConstInt::create(1, 32)));
+	ShPtr<WhileLoopStmt> whileLoop(WhileLoopStmt::create(varC, assignA1, assignB2));
+	testFunc->setBody(whileLoop);
+	ShPtr<CFG> cfg(cfgBuilder->getCFG(testFunc));
+
+	BitVectorDataflow dataflow(cfg, 2, BitVectorDataflow::Direction::Backward);
+	dataflow.getGen(getNode(cfg, assignA1)).set(0);
+	dataflow.getGen(getNode(cfg, assignB2)).set(1);
+	dataflow.solve();
+
+	EXPECT_EQ(bits(2, {}), dataflow.getOut(cfg->getExitNode()));
+	EXPECT_EQ(bits(2, {0, 1}), dataflow.getOut(getNode(cfg, assignA1)));
+	EXPECT_EQ(bits(2, {0, 1}), dataflow.getIn(cfg->getEntryNode()));
+}
+
+TEST_F(BitVectorDataflowTests,
+BoundaryIsUsedForNodesWithoutPredecessors) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     a = 1;  // KILL = {0}
+	// }
+	//
+	ShPtr<AssignStmt> assignA1(AssignStmt::create(varA, ConstInt::create(1, 32)));
+	testFunc->setBody(assignA1);
+	ShPtr<CFG> cfg(cfgBuilder->getCFG(testFunc));
+
+	BitVectorDataflow dataflow(cfg, 2, BitVectorDataflow::Direction::Forward);
+	dataflow.getKill(getNode(cfg, assignA1)).set(0);
+	dataflow.setBoundary(bits(2, {0, 1}));
+	dataflow.solve();
+
+	EXPECT_EQ(bits(2, {0, 1}), dataflow.getIn(cfg->getEntryNode()));
+	EXPECT_EQ(bits(2, {1}), dataflow.getIn(cfg->getExitNode()));
+}
+
+TEST_F(BitVectorDataflowTests,
+AcyclicCFGIsSolvedByEvaluatingEveryNodeOnce) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     a = 1;
+	//     if (c) {
+	//         b = 2;
+	//     }
+	// }
+	//
+	ShPtr<AssignStmt> assignB2(AssignStmt::create(varB, ConstInt::create(2, 32)));
+	ShPtr<IfStmt> ifStmt(IfStmt::create(varC, assignB2));
+	ShPtr<AssignStmt> assignA1(AssignStmt::create(varA, ConstInt::create(1, 32), ifStmt));
+	testFunc->setBody(assignA1);
+	ShPtr<CFG> cfg(cfgBuilder->getCFG(testFunc));
+
+	for (auto direction : {BitVectorDataflow::Direction::Forward,
+			BitVectorDataflow::Direction::Backward}) {
+		BitVectorDataflow dataflow(cfg, 1, direction);
+		dataflow.getGen(getNode(cfg, assignA1)).set(0);
+		dataflow.getGen(getNode(cfg, assignB2)).set(0);
+		dataflow.solve();
+
+		EXPECT_EQ(cfg->getNumberOfNodes(), dataflow.getNumOfNodeEvaluations());
+	}
+}
+
+} // namespace tests
+} // namespace llvmir2hll
+} // namespace retdec
@@ -0,0 +1,99 @@
+/**
+* @file tests/llvmir2hll/graphs/cfg/cfg_writers/jsonl_cfg_writer_tests.cpp
+* @brief Tests for the @c jsonl_cfg_writer module.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "retdec/llvmir2hll/graphs/cfg/cfg.h"
+#include "retdec/llvmir2hll/graphs/cfg/cfg_writer_factory.h"
+#include "retdec/llvmir2hll/graphs/cfg/cfg_writers/jsonl_cfg_writer.h"
+#include "retdec/llvmir2hll/ir/assign_stmt.h"
+#include "retdec/llvmir2hll/ir/const_int.h"
+#include "retdec/llvmir2hll/ir/int_type.h"
+#include "retdec/llvmir2hll/ir/lt_op_expr.h"
+#include "llvmir2hll/ir/tests_with_module.h"
+#include "retdec/llvmir2hll/ir/variable.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace llvmir2hll {
+namespace tests {
+
+/**
+* @brief Tests for the @c jsonl_cfg_writer module.
+*/
+class JsonlCFGWriterTests: public TestsWithModule {
+protected:
+	std::string emitCFG(ShPtr<CFG> cfg);
+};
+
+/**
+* @brief Emits @a cfg by JsonlCFGWriter and returns the output.
+*/
+std::string JsonlCFGWriterTests::emitCFG(ShPtr<CFG> cfg) {
+	std::ostringstream out;
+	auto writer = JsonlCFGWriter::create(cfg, out);
+	EXPECT_TRUE(writer->emitCFG());
+	return out.str();
+}
+
+TEST_F(JsonlCFGWriterTests,
+WriterIsRegisteredAtFactoryUnderJsonl) {
+	std::ostringstream out;
+
+	auto writer = CFGWriterFactory::getInstance().createObject<
+		ShPtr<CFG>, std::ostream &>("jsonl", std::make_shared<CFG>(testFunc), out);
+
+	ASSERT_TRUE(writer);
+	EXPECT_EQ("jsonl", writer->getId());
+}
+
+TEST_F(JsonlCFGWriterTests,
+NodesAndEdgesAreEmittedOnePerLineWithAddressesAndConditions) {
+	// void test() {
+	//     a = 1;     // 0x1000
+	//     b = a;     // 0x1004
+	//     if (a < 1) {
+	//         b = 2;
+	//     }
+	// }
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(32)));
+	ShPtr<Variable> varB(Variable::create("b", IntType::create(32)));
+
+	ShPtr<CFG> cfg(new CFG(testFunc));
+	cfg->addEntryNode(ShPtr<CFG::Node>(new CFG::Node("entry")));
+	ShPtr<CFG::Node> nodeA(new CFG::Node());
+	nodeA->addStmt(AssignStmt::create(varA, ConstInt::create(1, 32),
+		nullptr, 0x1000));
+	nodeA->addStmt(AssignStmt::create(varB, varA, nullptr, 0x1004));
+	cfg->addNode(nodeA);
+	ShPtr<CFG::Node> nodeB(new CFG::Node());
+	nodeB->addStmt(AssignStmt::create(varB, ConstInt::create(2, 32)));
+	cfg->addNode(nodeB);
+	cfg->addExitNode(ShPtr<CFG::Node>(new CFG::Node("exit")));
+	cfg->addEdge(cfg->getEntryNode(), nodeA);
+	cfg->addEdge(nodeA, nodeB, LtOpExpr::create(varA, ConstInt::create(1, 32)));
+	cfg->addEdge(nodeA, cfg->getExitNode());
+	cfg->addEdge(nodeB, cfg->getExitNode());
+
+	EXPECT_EQ(
+		R"({"type":"node","function":"test","id":0,"label":"entry","statements":[]})" "\n"
+		R"({"type":"node","function":"test","id":1,"address":"0x1000","statements":["a = 1","b = a"]})" "\n"
+		R"({"type":"node","function":"test","id":2,"statements":["b = 2"]})" "\n"
+		R"({"type":"node","function":"test","id":3,"label":"exit","statements":[]})" "\n"
+		R"({"type":"edge","function":"test","src":0,"dst":1})" "\n"
+		R"({"type":"edge","function":"test","src":1,"dst":2,"cond":"a < 1"})" "\n"
+		R"({"type":"edge","function":"test","src":1,"dst":3})" "\n"
+		R"({"type":"edge","function":"test","src":2,"dst":3})" "\n",
+		emitCFG(cfg)
+	);
+}
+
+} // namespace tests
+} // namespace llvmir2hll
+} // namespace retdec
@@ -0,0 +1,140 @@
+/**
+* @file tests/llvmir2hll/graphs/cg/cg_writers/jsonl_cg_writer_tests.cpp
+* @brief Tests for the @c jsonl_cg_writer module.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/llvmir2hll/graphs/cg/cg.h"
+#include "retdec/llvmir2hll/graphs/cg/cg_builder.h"
+#include "retdec/llvmir2hll/graphs/cg/cg_writer_factory.h"
+#include "retdec/llvmir2hll/graphs/cg/cg_writers/jsonl_cg_writer.h"
+#include "retdec/llvmir2hll/ir/call_expr.h"
+#include "retdec/llvmir2hll/ir/call_stmt.h"
+#include "retdec/llvmir2hll/ir/function_type.h"
+#include "retdec/llvmir2hll/ir/pointer_type.h"
+#include "llvmir2hll/ir/tests_with_module.h"
+#include "retdec/llvmir2hll/ir/variable.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace llvmir2hll {
+namespace tests {
+
+/**
+* @brief Tests for the @c jsonl_cg_writer module.
+*/
+class JsonlCGWriterTests: public TestsWithModule {
+protected:
+	virtual void SetUp() override;
+
+	std::vector<std::string> emitCG(ShPtr<CG> cg);
+};
+
+void JsonlCGWriterTests::SetUp() {
+	// The same as the config returns for functions without an address.
+	ON_CALL(*configMock, getAddressRangeForFunc(_))
+		.WillByDefault(Return(NO_ADDRESS_RANGE));
+}
+
+/**
+* @brief Emits @a cg by JsonlCGWriter and returns the output lines.
+*/
+std::vector<std::string> JsonlCGWriterTests::emitCG(ShPtr<CG> cg) {
+	std::ostringstream out;
+	auto writer = JsonlCGWriter::create(cg, out);
+	EXPECT_TRUE(writer->emitCG());
+
+	std::vector<std::string> lines;
+	std::istringstream in(out.str());
+	for (std::string line; std::getline(in, line);) {
+		lines.push_back(line);
+	}
+	return lines;
+}
+
+TEST_F(JsonlCGWriterTests,
+WriterIsRegisteredAtFactoryUnderJsonl) {
+	std::ostringstream out;
+
+	auto writer = CGWriterFactory::getInstance().createObject<
+		ShPtr<CG>, std::ostream &>("jsonl", CGBuilder::getCG(module), out);
+
+	ASSERT_TRUE(writer);
+	EXPECT_EQ("jsonl", writer->getId());
+}
+
+TEST_F(JsonlCGWriterTests,
+FunctionsAndCallsAreEmittedOnePerLineFunctionsFirst) {
+	// void f() {}
+	// void printf();
+	//
+	// void test() {      // 0x1000
+	//     f();
+	//     printf();
+	//     p();           // call through a pointer
+	// }
+	ON_CALL(*configMock, getAddressRangeForFunc("test"))
+		.WillByDefault(Return(AddressRange(0x1000, 0x1020)));
+	addFuncDef("f");
+	addFuncDecl("printf");
+	addCall("test", "f");
+	addCall("test", "printf");
+	ShPtr<Variable> varP(Variable::create("p",
+		PointerType::create(FunctionType::create())));
+	testFunc->addLocalVar(varP);
+	testFunc->setBody(Statement::mergeStatements(testFunc->getBody(),
+		CallStmt::create(CallExpr::create(varP))));
+
+	auto lines = emitCG(CGBuilder::getCG(module));
+
+	// Functions are emitted before calls, the order of functions and calls
+	// themselves is not specified.
+	ASSERT_EQ(5, lines.size());
+	auto firstCall = std::find_if(lines.begin(), lines.end(),
+		[](const std::string &line) {
+			return line.find(R"({"type":"call")") == 0;
+		});
+	EXPECT_EQ(3, firstCall - lines.begin());
+	std::sort(lines.begin(), firstCall);
+	std::sort(firstCall, lines.end());
+	EXPECT_EQ(
+		std::vector<std::string>({
+			R"({"type":"function","name":"f","defined":true,"callsByPointer":false})",
+			R"({"type":"function","name":"printf","defined":false,"callsByPointer":false})",
+			R"({"type":"function","name":"test","address":"0x1000","defined":true,"callsByPointer":true})",
+			R"({"type":"call","caller":"test","callee":"f"})",
+			R"({"type":"call","caller":"test","callee":"printf"})",
+		}),
+		lines
+	);
+}
+
+TEST_F(JsonlCGWriterTests,
+CallsThroughPointerAreNotEmittedAsCalls) {
+	// void test() {
+	//     p();
+	// }
+	ShPtr<Variable> varP(Variable::create("p",
+		PointerType::create(FunctionType::create())));
+	testFunc->addLocalVar(varP);
+	testFunc->setBody(CallStmt::create(CallExpr::create(varP)));
+
+	EXPECT_EQ(
+		std::vector<std::string>({
+			R"({"type":"function","name":"test","defined":true,"callsByPointer":true})",
+		}),
+		emitCG(CGBuilder::getCG(module))
+	);
+}
+
+} // namespace tests
+} // namespace llvmir2hll
+} // namespace retdec
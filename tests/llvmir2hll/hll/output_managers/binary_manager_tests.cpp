@@ -0,0 +1,326 @@
+/**
+* @file tests/llvmir2hll/hll/output_managers/binary_manager_tests.cpp
+* @brief Implementation of class for tests of binary output manager.
+* @copyright (c) 2019 Avast Software, licensed under the MIT license
+*/
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+#include <rapidjson/document.h>
+
+#include "llvmir2hll/hll/output_managers/output_manager_tests.h"
+#include "retdec/llvmir2hll/hll/output_managers/binary_manager.h"
+#include "retdec/llvmir2hll/hll/output_managers/json_manager.h"
+
+using namespace ::testing;
+using namespace retdec::llvmir2hll::binary_tokens;
+
+namespace retdec {
+namespace llvmir2hll {
+namespace tests {
+
+class BinaryOutputManagerTests: public OutputManagerTests
+{
+	protected:
+		virtual void SetUp() override;
+
+		std::string emitTokens();
+};
+
+void BinaryOutputManagerTests::SetUp()
+{
+	OutputManagerTests::SetUp();
+	manager = UPtr<OutputManager>(new BinaryOutputManager(codeStream));
+	manager->setCommentPrefix("//");
+	manager->setOutputLanguage("C");
+}
+
+/**
+ * Emits the code, reads it back and returns all the tokens in a readable
+ * form: <tt>kind:value@address</tt> separated by spaces.
+ */
+std::string BinaryOutputManagerTests::emitTokens()
+{
+	std::istringstream in(emitCode());
+	BinaryTokenReader reader(in);
+
+	std::string res;
+	Token t;
+	while (reader.next(t))
+	{
+		res += res.empty() ? "" : " ";
+		res += getTokenKindName(t.kind);
+		res += ":" + std::string(t.value);
+		if (t.address.isDefined())
+		{
+			res += "@" + t.address.toHexPrefixString();
+		}
+	}
+	EXPECT_EQ("C", reader.getLanguage());
+	return res;
+}
+
+/**
+ * Emits a sequence of tokens resembling a decompiled function.
+ */
+void emitFunction(OutputManager& m, unsigned index, Address start)
+{
+	m.addressPush(start);
+	m.dataType("int32_t");
+	m.space();
+	m.functionId("function_" + std::to_string(index));
+	m.punctuation('(');
+	m.dataType("int32_t");
+	m.space();
+	m.parameterId("a1");
+	m.punctuation(')');
+	m.space();
+	m.punctuation('{');
+	m.newLine();
+	for (unsigned i = 0; i < 20; ++i)
+	{
+		m.addressPush(start + 4 * i);
+		m.space("    ");
+		m.localVariableId("v" + std::to_string(i % 4));
+		m.operatorX("=", true, true);
+		m.localVariableId("v" + std::to_string((i + 1) % 4));
+		m.operatorX("+", true, true);
+		m.constantInt(std::to_string(i));
+		m.punctuation(';');
+		m.newLine();
+		m.addressPop();
+	}
+	m.space("    ");
+	m.keyword("return");
+	m.space();
+	m.localVariableId("v0");
+	m.punctuation(';');
+	m.newLine();
+	m.punctuation('}');
+	m.newLine();
+	m.addressPop();
+}
+
+//
+// tokens
+//
+
+TEST_F(BinaryOutputManagerTests, stream_without_tokens_has_only_header_and_language)
+{
+	EXPECT_EQ("", emitTokens());
+	EXPECT_EQ(std::string("RDTK\x01\x81\xff\x00\x01" "C", 10), code);
+}
+
+TEST_F(BinaryOutputManagerTests, all_token_kinds_are_read_back)
+{
+	manager->newLine();
+	manager->space("  ");
+	manager->punctuation('(');
+	manager->operatorX("==");
+	manager->globalVariableId("g");
+	manager->localVariableId("l");
+	manager->memberId("m");
+	manager->labelId("lab");
+	manager->functionId("f");
+	manager->parameterId("a");
+	manager->keyword("while");
+	manager->dataType("int");
+	manager->preprocessor("#include");
+	manager->include("stdio.h");
+	manager->constantBool("true");
+	manager->constantInt("1");
+	manager->constantFloat("1.0");
+	manager->constantString("\"s\"");
+	manager->constantSymbol("UINT_MAX");
+	manager->constantPointer("NULL");
+	manager->comment("c");
+
+	EXPECT_EQ(
+		"nl:\n ws:   punc:( op:== i_gvar:g i_lvar:l i_mem:m i_lab:lab i_fnc:f "
+		"i_arg:a keyw:while type:int preproc:#include inc:<stdio.h> "
+		"l_bool:true l_int:1 l_fp:1.0 l_str:\"s\" l_sym:UINT_MAX l_ptr:NULL "
+		"cmnt:// c",
+		emitTokens());
+}
+
+TEST_F(BinaryOutputManagerTests, repeated_values_are_written_only_once)
+{
+	std::string once;
+	llvm::raw_string_ostream onceStream(once);
+	BinaryOutputManager onceManager(onceStream);
+	onceManager.setOutputLanguage("C");
+	onceManager.localVariableId("variable");
+	onceManager.finalize();
+	onceStream.flush();
+
+	manager->localVariableId("variable");
+	manager->localVariableId("variable");
+	std::string twice = emitCode();
+
+	// Tag and index of the already written string.
+	EXPECT_EQ(once.size() + 2, twice.size());
+}
+
+//
+// commentModifier()
+//
+
+TEST_F(BinaryOutputManagerTests, commentModifier_creates_comment_until_end_of_line)
+{
+	manager->commentModifier();
+	manager->localVariableId("hello");
+	manager->space();
+	manager->operatorX("=");
+	manager->space();
+	manager->constantInt("1234");
+	manager->punctuation(';');
+	manager->newLine();
+	manager->functionId("f");
+
+	EXPECT_EQ("cmnt:// hello = 1234; nl:\n i_fnc:f", emitTokens());
+}
+
+//
+// addressPush()
+// addressPop()
+//
+
+TEST_F(BinaryOutputManagerTests, addresses_are_associated_with_tokens)
+{
+	manager->addressPush(0x1000);
+	manager->localVariableId("v1");
+	manager->addressPush(Address::Undefined);
+	manager->functionId("f");
+	manager->addressPop();
+	manager->localVariableId("v2");
+	manager->addressPush(0x800);
+	manager->localVariableId("v3");
+	manager->addressPop();
+	manager->addressPop();
+
+	EXPECT_EQ(
+		"i_lvar:v1@0x1000 i_fnc:f i_lvar:v2@0x1000 i_lvar:v3@0x800",
+		emitTokens());
+}
+
+//
+// reader
+//
+
+TEST_F(BinaryOutputManagerTests, reader_rejects_stream_with_bad_magic)
+{
+	std::istringstream in("{\"tokens\":[]}");
+
+	EXPECT_THROW(BinaryTokenReader reader(in), std::runtime_error);
+}
+
+TEST_F(BinaryOutputManagerTests, reader_rejects_truncated_stream)
+{
+	manager->functionId("function");
+	std::string data = emitCode();
+	std::istringstream in(data.substr(0, data.size() - 4));
+	BinaryTokenReader reader(in);
+	Token t;
+
+	EXPECT_THROW(
+		while (reader.next(t)) {},
+		std::runtime_error);
+}
+
+TEST_F(BinaryOutputManagerTests, reader_rejects_string_longer_than_stream)
+{
+	// Token with a new string claiming to be about 2^63 bytes long.
+	std::string data("RDTK\x01\x02\x00", 7);
+	data += std::string(8, '\xff') + "\x7f" + "ab";
+	std::istringstream in(data);
+	BinaryTokenReader reader(in);
+	Token t;
+
+	EXPECT_THROW(reader.next(t), std::runtime_error);
+}
+
+//
+// comparison with JSON
+//
+
+TEST_F(BinaryOutputManagerTests, output_is_much_smaller_than_json)
+{
+	std::string json;
+	llvm::raw_string_ostream jsonStream(json);
+	JsonOutputManagerPlain jsonManager(jsonStream);
+	jsonManager.setOutputLanguage("C");
+
+	for (unsigned i = 0; i < 10; ++i)
+	{
+		emitFunction(*manager, i, 0x401000 + 0x100 * i);
+		emitFunction(jsonManager, i, 0x401000 + 0x100 * i);
+	}
+	jsonManager.finalize();
+	jsonStream.flush();
+	std::string binary = emitCode();
+
+	EXPECT_LT(binary.size() * 5, json.size());
+}
+
+/**
+ * Not a test -- compares size and speed of the binary and JSON outputs.
+ * Run with --gtest_also_run_disabled_tests to see the results.
+ */
+TEST_F(BinaryOutputManagerTests, DISABLED_benchmark_against_json)
+{
+	const unsigned functions = 5000;
+	using Clock = std::chrono::steady_clock;
+	auto ms = [](Clock::duration d) {
+		return std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+	};
+
+	auto start = Clock::now();
+	for (unsigned i = 0; i < functions; ++i)
+	{
+		emitFunction(*manager, i, 0x401000 + 0x100 * i);
+	}
+	std::string binary = emitCode();
+	auto binaryWrite = Clock::now() - start;
+
+	start = Clock::now();
+	std::istringstream in(binary);
+	BinaryTokenReader reader(in);
+	Token t;
+	std::size_t tokens = 0;
+	while (reader.next(t))
+	{
+		++tokens;
+	}
+	auto binaryRead = Clock::now() - start;
+
+	std::string json;
+	llvm::raw_string_ostream jsonStream(json);
+	start = Clock::now();
+	{
+		JsonOutputManagerPlain jsonManager(jsonStream);
+		for (unsigned i = 0; i < functions; ++i)
+		{
+			emitFunction(jsonManager, i, 0x401000 + 0x100 * i);
+		}
+		jsonManager.finalize();
+		jsonStream.flush();
+	}
+	auto jsonWrite = Clock::now() - start;
+
+	start = Clock::now();
+	rapidjson::Document doc;
+	doc.Parse(json.c_str());
+	auto jsonRead = Clock::now() - start;
+
+	std::cout << "tokens: " << tokens << "\n"
+			<< "binary: " << binary.size() << " B, write " << ms(binaryWrite)
+			<< " ms, read " << ms(binaryRead) << " ms\n"
+			<< "json:   " << json.size() << " B, write " << ms(jsonWrite)
+			<< " ms, parse " << ms(jsonRead) << " ms" << std::endl;
+}
+
+} // namespace tests
+} // namespace llvmir2hll
+} // namespace retdec
@@ -95,7 +95,7 @@ ShPtr<Module> LLVMIR2BIRConverterBaseTests::ConversionPass::getConvertedModule()
 
 LLVMIR2BIRConverterBaseTests::LLVMIR2BIRConverterBaseTests():
 	configMock(std::make_shared<NiceMock<ConfigMock>>()),
-	optionStrictFPUSemantics(false) {}
+	optionStrictFPUSemantics(false), optionReleaseLLVMIR(false) {}
 
 /**
 * @brief Converts the given LLVM IR code into a BIR module.
@@ -122,8 +122,12 @@ ShPtr<Module> LLVMIR2BIRConverterBaseTests::convertLLVMIR2BIR(const std::string
 	// Peform the conversion.
 	auto converter = LLVMIR2BIRConverter::create(conversionPass);
 	converter->setOptionStrictFPUSemantics(optionStrictFPUSemantics);
+	converter->setOptionReleaseLLVMIR(optionReleaseLLVMIR);
 	conversionPass->setUsedConverter(converter);
 	llvmModule = parseLLVMIR(code);
+	if (onModuleParsed) {
+		onModuleParsed(*llvmModule);
+	}
 	passManager.run(*llvmModule);
 	return conversionPass->getConvertedModule();
 }
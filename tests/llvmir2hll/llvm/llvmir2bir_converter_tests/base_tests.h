@@ -7,6 +7,7 @@
 #ifndef BACKEND_BIR_LLVM_TESTS_LLVMIR2BIR_CONVERTER_TESTS_BASE_TESTS_H
 #define BACKEND_BIR_LLVM_TESTS_LLVMIR2BIR_CONVERTER_TESTS_BASE_TESTS_H
 
+#include <functional>
 #include <string>
 
 #include <gmock/gmock.h>
@@ -110,6 +111,12 @@ protected:
 	/// Use strict FPU semantics?
 	bool optionStrictFPUSemantics;
 
+	/// Release bodies of LLVM functions once they are converted?
+	bool optionReleaseLLVMIR;
+
+	/// Called with the parsed LLVM module right before its conversion.
+	std::function<void (llvm::Module &)> onModuleParsed;
+
 	/// Context for the LLVM module.
 	// Implementation note: Do NOT use llvm::getGlobalContext() because that
 	//                      would make the context same for all tests (we want
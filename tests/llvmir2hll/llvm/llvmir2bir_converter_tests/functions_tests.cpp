@@ -4,7 +4,14 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+
 #include <gtest/gtest.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/ValueHandle.h>
 
 #include "llvmir2hll/llvm/llvmir2bir_converter_tests/base_tests.h"
 #include "retdec/llvmir2hll/ir/function.h"
@@ -14,6 +21,7 @@
 #include "retdec/llvmir2hll/ir/variable.h"
 #include "retdec/llvmir2hll/ir/void_type.h"
 #include "retdec/llvmir2hll/support/smart_ptr.h"
+#include "retdec/utils/profiler.h"
 
 using namespace ::testing;
 using namespace std::string_literals;
@@ -25,7 +33,53 @@ namespace tests {
 /**
 * @brief Tests for functions conversion in @c LLVMIR2BIRConverter.
 */
-class LLVMIR2BIRConverterFunctionsTests: public LLVMIR2BIRConverterBaseTests {};
+class LLVMIR2BIRConverterFunctionsTests: public LLVMIR2BIRConverterBaseTests {
+protected:
+	/**
+	* @brief Calls the given callback when the watched LLVM value is deleted.
+	*/
+	class DeletionWatcher: public llvm::CallbackVH {
+	public:
+		DeletionWatcher(llvm::Value *value, std::function<void ()> onDeleted):
+			llvm::CallbackVH(value), onDeleted(std::move(onDeleted)) {}
+
+		virtual void deleted() override {
+			onDeleted();
+			llvm::CallbackVH::deleted();
+		}
+
+	private:
+		std::function<void ()> onDeleted;
+	};
+
+	static std::string createModuleWithCallChain(unsigned funcCount);
+};
+
+/**
+* @brief Creates LLVM IR with @a funcCount functions with loops, each of them
+*        calling the previous one. All functions have the same number of
+*        instructions.
+*/
+std::string LLVMIR2BIRConverterFunctionsTests::createModuleWithCallChain(
+		unsigned funcCount) {
+	std::string code = "declare i32 @ext(i32)\n";
+	for (unsigned i = 0; i < funcCount; ++i) {
+		auto callee = i == 0 ? "@ext"s : "@f" + std::to_string(i - 1);
+		code += "define i32 @f" + std::to_string(i) + "(i32 %n) {\n"
+			"entry:\n"
+			"  br label %loop\n"
+			"loop:\n"
+			"  %i = phi i32 [ 0, %entry ], [ %next, %loop ]\n"
+			"  %r = call i32 " + callee + "(i32 %i)\n"
+			"  %next = add i32 %i, %r\n"
+			"  %c = icmp slt i32 %next, %n\n"
+			"  br i1 %c, label %loop, label %exit\n"
+			"exit:\n"
+			"  ret i32 %next\n"
+			"}\n";
+	}
+	return code;
+}
 
 TEST_F(LLVMIR2BIRConverterFunctionsTests,
 FunctionDeclarationIsCorrectlyAddedToModuleAsDeclaration) {
@@ -180,6 +234,100 @@ LocalVariableWithInvalidIdentifierNameHasValidIdentifierNameAfterConversion) {
 	ASSERT_EQ("_24_example_variable1", var->getName());
 }
 
+TEST_F(LLVMIR2BIRConverterFunctionsTests,
+BodiesOfConvertedFunctionsAreReleasedWhenRequested) {
+	// A large module with many calls between functions with loops. It checks
+	// that no LLVM IR is kept after the conversion.
+	const unsigned funcCount = 200;
+	auto code = createModuleWithCallChain(funcCount);
+	optionReleaseLLVMIR = true;
+
+	auto module = convertLLVMIR2BIR(code);
+
+	for (unsigned i = 0; i < funcCount; ++i) {
+		auto name = "f" + std::to_string(i);
+		auto f = module->getFuncByName(name);
+		ASSERT_TRUE(f);
+		ASSERT_TRUE(f->isDefinition());
+		ASSERT_TRUE(f->getBody());
+		auto llvmFunc = llvmModule->getFunction(name);
+		ASSERT_TRUE(llvmFunc);
+		ASSERT_TRUE(llvmFunc->isDeclaration());
+	}
+	std::size_t llvmInstructions = 0;
+	for (auto &func: *llvmModule) {
+		llvmInstructions += func.getInstructionCount();
+	}
+	ASSERT_EQ(0, llvmInstructions);
+}
+
+TEST_F(LLVMIR2BIRConverterFunctionsTests,
+LiveLLVMInstructionsAreBoundedByUnconvertedFunctionsDuringConversion) {
+	// While a function is converted, only the LLVM IR of the functions that
+	// have not been converted yet may be alive, plus the function whose body
+	// is being released. Without releasing, all instructions would stay alive
+	// until the end of the conversion.
+	const unsigned funcCount = 50;
+	auto code = createModuleWithCallChain(funcCount);
+	optionReleaseLLVMIR = true;
+
+	auto &structured = utils::Profiler::get().counter(
+		"llvmir2hll.functions_structured");
+	std::uint64_t structuredBefore = 0;
+	std::size_t live = 0;
+	std::size_t perFunc = 0;
+	std::size_t maxExcess = 0;
+	std::vector<std::unique_ptr<DeletionWatcher>> watchers;
+	onModuleParsed = [&](llvm::Module &module) {
+		structuredBefore = structured;
+		for (auto &func: module) {
+			for (auto &inst: llvm::instructions(func)) {
+				watchers.push_back(std::make_unique<DeletionWatcher>(
+					&inst,
+					[&]() {
+						--live;
+						auto converted = structured - structuredBefore;
+						auto bound = (funcCount - converted + 1) * perFunc;
+						if (live > bound) {
+							maxExcess = std::max(maxExcess, live - bound);
+						}
+					}
+				));
+			}
+		}
+		live = watchers.size();
+		perFunc = live / funcCount;
+	};
+
+	convertLLVMIR2BIR(code);
+	onModuleParsed = nullptr;
+
+	ASSERT_EQ(funcCount * perFunc, watchers.size());
+	ASSERT_EQ(funcCount, structured - structuredBefore);
+	ASSERT_EQ(0, live);
+	ASSERT_EQ(0, maxExcess);
+}
+
+TEST_F(LLVMIR2BIRConverterFunctionsTests,
+BodyOfFunctionWithAddressTakenBlockIsNotReleased) {
+	optionReleaseLLVMIR = true;
+
+	auto module = convertLLVMIR2BIR(R"(
+		@target = global i8* blockaddress(@function, %bb)
+
+		define void @function() {
+			br label %bb
+		bb:
+			ret void
+		}
+	)");
+
+	auto f = module->getFuncByName("function");
+	ASSERT_TRUE(f);
+	ASSERT_TRUE(f->isDefinition());
+	ASSERT_FALSE(llvmModule->getFunction("function")->isDeclaration());
+}
+
 } // namespace tests
 } // namespace llvmir2hll
 } // namespace retdec
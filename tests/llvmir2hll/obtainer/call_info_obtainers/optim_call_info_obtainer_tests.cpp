@@ -0,0 +1,127 @@
+/**
+* @file tests/llvmir2hll/obtainer/call_info_obtainers/optim_call_info_obtainer_tests.cpp
+* @brief Tests for the @c optim_call_info_obtainer module.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <gtest/gtest.h>
+
+#include "llvmir2hll/analysis/tests_with_value_analysis.h"
+#include "retdec/llvmir2hll/graphs/cg/cg_builder.h"
+#include "retdec/llvmir2hll/ir/assign_stmt.h"
+#include "retdec/llvmir2hll/ir/call_stmt.h"
+#include "retdec/llvmir2hll/ir/const_int.h"
+#include "retdec/llvmir2hll/ir/int_type.h"
+#include "llvmir2hll/ir/tests_with_module.h"
+#include "retdec/llvmir2hll/ir/variable.h"
+#include "retdec/llvmir2hll/obtainer/call_info_obtainers/optim_call_info_obtainer.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace llvmir2hll {
+namespace tests {
+
+/**
+* @brief Tests for the @c optim_call_info_obtainer module.
+*/
+class OptimCallInfoObtainerTests: public TestsWithModule {};
+
+TEST_F(OptimCallInfoObtainerTests,
+CallOfFuncModifyingGlobalVarMayModifyThisVarButNotLocalVarsOfCallee) {
+	// Set-up the module.
+	//
+	// int g;
+	//
+	// void f() {
+	//     int a;
+	//     a = 1;
+	//     g = a;
+	// }
+	//
+	// void test() {
+	//     f();
+	// }
+	//
+	ShPtr<Variable> varG(Variable::create("g", IntType::create(32)));
+	module->addGlobalVar(varG);
+	ShPtr<Function> f(addFuncDef("f"));
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(32)));
+	f->addLocalVar(varA);
+	ShPtr<AssignStmt> assignGA(AssignStmt::create(varG, varA));
+	f->setBody(AssignStmt::create(varA, ConstInt::create(1, 32), assignGA));
+	ShPtr<CallStmt> callF(addCall("test", "f"));
+
+	INSTANTIATE_ALIAS_ANALYSIS_AND_VALUE_ANALYSIS(module);
+	ShPtr<CallInfoObtainer> cio(OptimCallInfoObtainer::create());
+	cio->init(CGBuilder::getCG(module), va);
+
+	ShPtr<FuncInfo> fInfo(cio->getFuncInfo(f));
+	EXPECT_TRUE(fInfo->mayBeModified(varG));
+	EXPECT_TRUE(fInfo->mayBeModified(varA));
+	EXPECT_TRUE(fInfo->mayBeRead(varA));
+	EXPECT_FALSE(fInfo->isNeverModified(varG));
+
+	ShPtr<CallInfo> callInfo(cio->getCallInfo(callF->getCall(), testFunc));
+	EXPECT_TRUE(callInfo->mayBeModified(varG));
+	EXPECT_FALSE(callInfo->mayBeModified(varA));
+	EXPECT_FALSE(callInfo->mayBeRead(varA));
+}
+
+TEST_F(OptimCallInfoObtainerTests,
+DeclaredFuncNeverReadsOrModifiesGlobalVars) {
+	// Set-up the module.
+	//
+	// int g;
+	//
+	// void f();
+	//
+	ShPtr<Variable> varG(Variable::create("g", IntType::create(32)));
+	module->addGlobalVar(varG);
+	ShPtr<Function> f(addFuncDecl("f"));
+
+	INSTANTIATE_ALIAS_ANALYSIS_AND_VALUE_ANALYSIS(module);
+	ShPtr<CallInfoObtainer> cio(OptimCallInfoObtainer::create());
+	cio->init(CGBuilder::getCG(module), va);
+
+	ShPtr<FuncInfo> fInfo(cio->getFuncInfo(f));
+	EXPECT_TRUE(fInfo->isNeverRead(varG));
+	EXPECT_TRUE(fInfo->isNeverModified(varG));
+	EXPECT_TRUE(fInfo->valueIsNeverChanged(varG));
+	EXPECT_FALSE(fInfo->mayBeRead(varG));
+}
+
+TEST_F(OptimCallInfoObtainerTests,
+InfoOfRecursiveFuncIncludesGlobalVarsModifiedInOtherFuncsFromItsSCC) {
+	// Set-up the module.
+	//
+	// int g;
+	//
+	// void f() {
+	//     g = 1;
+	//     test();
+	// }
+	//
+	// void test() {
+	//     f();
+	// }
+	//
+	ShPtr<Variable> varG(Variable::create("g", IntType::create(32)));
+	module->addGlobalVar(varG);
+	ShPtr<Function> f(addFuncDef("f"));
+	f->setBody(AssignStmt::create(varG, ConstInt::create(1, 32)));
+	addCall("f", "test");
+	addCall("test", "f");
+
+	INSTANTIATE_ALIAS_ANALYSIS_AND_VALUE_ANALYSIS(module);
+	ShPtr<CallInfoObtainer> cio(OptimCallInfoObtainer::create());
+	cio->init(CGBuilder::getCG(module), va);
+
+	EXPECT_TRUE(cio->getFuncInfo(testFunc)->mayBeModified(varG));
+	EXPECT_FALSE(cio->getFuncInfo(testFunc)->isNeverModified(varG));
+	EXPECT_TRUE(cio->getFuncInfo(f)->mayBeModified(varG));
+}
+
+} // namespace tests
+} // namespace llvmir2hll
+} // namespace retdec
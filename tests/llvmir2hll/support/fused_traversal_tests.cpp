@@ -0,0 +1,178 @@
+/**
+* @file tests/llvmir2hll/support/fused_traversal_tests.cpp
+* @brief Tests for the @c fused_traversal module.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/llvmir2hll/ir/break_stmt.h"
+#include "retdec/llvmir2hll/ir/call_expr.h"
+#include "retdec/llvmir2hll/ir/call_stmt.h"
+#include "retdec/llvmir2hll/ir/function.h"
+#include "llvmir2hll/ir/tests_with_module.h"
+#include "retdec/llvmir2hll/support/fused_traversal.h"
+#include "retdec/llvmir2hll/validator/validators/break_outside_loop_validator.h"
+#include "retdec/llvmir2hll/validator/validators/return_validator.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace llvmir2hll {
+namespace tests {
+
+namespace {
+
+/**
+* @brief A client recording traversed functions and calls.
+*/
+class CallsRecorder: public FusedTraversal::Client {
+public:
+	static ShPtr<CallsRecorder> create(bool supportsCopies = true) {
+		return ShPtr<CallsRecorder>(new CallsRecorder(supportsCopies));
+	}
+
+	using FusedTraversal::Client::visit;
+
+	virtual void startFunc(ShPtr<Function> func) override {
+		funcs.push_back(func->getName());
+	}
+
+	virtual void visit(ShPtr<CallStmt> stmt) override {
+		callStmts.push_back(stmt);
+	}
+
+	virtual void visit(ShPtr<CallExpr> expr) override {
+		stmtsOfCalls.push_back(getCurrentStmt());
+	}
+
+	virtual ShPtr<FusedTraversal::Client> createEmptyCopy() const override {
+		return supportsCopies ? create() : nullptr;
+	}
+
+	virtual void mergeCopy(FusedTraversal::Client &copy) override {
+		auto &recorderCopy = static_cast<CallsRecorder &>(copy);
+		funcs.insert(funcs.end(), recorderCopy.funcs.begin(),
+			recorderCopy.funcs.end());
+		callStmts.insert(callStmts.end(), recorderCopy.callStmts.begin(),
+			recorderCopy.callStmts.end());
+		stmtsOfCalls.insert(stmtsOfCalls.end(),
+			recorderCopy.stmtsOfCalls.begin(), recorderCopy.stmtsOfCalls.end());
+	}
+
+public:
+	std::vector<std::string> funcs;
+	std::vector<ShPtr<Statement>> callStmts;
+	std::vector<ShPtr<Statement>> stmtsOfCalls;
+
+private:
+	explicit CallsRecorder(bool supportsCopies):
+		supportsCopies(supportsCopies) {}
+
+private:
+	bool supportsCopies;
+};
+
+} // anonymous namespace
+
+/**
+* @brief Tests for the @c fused_traversal module.
+*/
+class FusedTraversalTests: public TestsWithModule {};
+
+TEST_F(FusedTraversalTests,
+AllClientsAreNotifiedAboutAllFunctionsAndCallsInSingleTraversal) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     f();
+	// }
+	//
+	// void f() {
+	//     test();
+	// }
+	//
+	addFuncDef("f");
+	ShPtr<CallStmt> callOfF(addCall("test", "f"));
+	ShPtr<CallStmt> callOfTest(addCall("f", "test"));
+
+	ShPtr<CallsRecorder> recorder1(CallsRecorder::create());
+	ShPtr<CallsRecorder> recorder2(CallsRecorder::create());
+	FusedTraversal traversal;
+	traversal.addClient(recorder1);
+	traversal.addClient(recorder2);
+	traversal.run(module);
+
+	std::vector<std::string> refFuncs{"test", "f"};
+	std::vector<ShPtr<Statement>> refStmts{callOfF, callOfTest};
+	for (const auto &recorder : {recorder1, recorder2}) {
+		EXPECT_EQ(refFuncs, recorder->funcs);
+		EXPECT_EQ(refStmts, recorder->callStmts);
+		EXPECT_EQ(refStmts, recorder->stmtsOfCalls);
+	}
+}
+
+TEST_F(FusedTraversalTests,
+ParallelTraversalGivesSameResultsAsSerialTraversal) {
+	for (std::size_t i = 0; i < 100; ++i) {
+		addFuncDef("f" + std::to_string(i));
+		addCall("f" + std::to_string(i), "test");
+		addCall("test", "f" + std::to_string(i));
+	}
+
+	ShPtr<CallsRecorder> serialRecorder(CallsRecorder::create());
+	FusedTraversal serialTraversal;
+	serialTraversal.addClient(serialRecorder);
+	serialTraversal.run(module, false);
+
+	ShPtr<CallsRecorder> parallelRecorder(CallsRecorder::create());
+	FusedTraversal parallelTraversal;
+	parallelTraversal.addClient(parallelRecorder);
+	ASSERT_TRUE(parallelTraversal.canRunInParallel());
+	parallelTraversal.run(module, true);
+
+	EXPECT_EQ(101, serialRecorder->funcs.size());
+	EXPECT_EQ(200, serialRecorder->callStmts.size());
+	EXPECT_EQ(serialRecorder->funcs, parallelRecorder->funcs);
+	EXPECT_EQ(serialRecorder->callStmts, parallelRecorder->callStmts);
+	EXPECT_EQ(serialRecorder->stmtsOfCalls, parallelRecorder->stmtsOfCalls);
+}
+
+TEST_F(FusedTraversalTests,
+ClientWithoutCopiesIsRunSeriallyEvenWhenParallelTraversalIsRequested) {
+	addFuncDef("f");
+	addCall("f", "test");
+
+	ShPtr<CallsRecorder> recorder(CallsRecorder::create(false));
+	FusedTraversal traversal;
+	traversal.addClient(CallsRecorder::create());
+	traversal.addClient(recorder);
+	EXPECT_FALSE(traversal.canRunInParallel());
+	traversal.run(module, true);
+
+	EXPECT_EQ(std::vector<std::string>({"test", "f"}), recorder->funcs);
+	EXPECT_EQ(1, recorder->callStmts.size());
+}
+
+TEST_F(FusedTraversalTests,
+ValidateAllFailsWhenAnyOfValidatorsSharingTraversalFails) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     break;
+	// }
+	//
+	testFunc->setBody(BreakStmt::create());
+
+	EXPECT_TRUE(Validator::validateAll({ReturnValidator::create()}, module));
+	EXPECT_FALSE(Validator::validateAll(
+		{ReturnValidator::create(), BreakOutsideLoopValidator::create()},
+		module, false, true));
+}
+
+} // namespace tests
+} // namespace llvmir2hll
+} // namespace retdec
@@ -0,0 +1,104 @@
+/**
+* @file tests/llvmir2hll/support/indexed_var_set_tests.cpp
+* @brief Tests for the @c indexed_var_set module.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <gtest/gtest.h>
+
+#include "retdec/llvmir2hll/ir/int_type.h"
+#include "retdec/llvmir2hll/ir/variable.h"
+#include "retdec/llvmir2hll/support/indexed_var_set.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace llvmir2hll {
+namespace tests {
+
+/**
+* @brief Tests for the @c indexed_var_set module.
+*/
+class IndexedVarSetTests: public Test {
+protected:
+	IndexedVarSetTests():
+		varA(Variable::create("a", IntType::create(32))),
+		varB(Variable::create("b", IntType::create(32))),
+		varC(Variable::create("c", IntType::create(32))),
+		index(std::make_shared<VarIndex>(VarVector{varA, varB})) {}
+
+protected:
+	ShPtr<Variable> varA;
+	ShPtr<Variable> varB;
+	ShPtr<Variable> varC;
+	ShPtr<VarIndex> index;
+};
+
+TEST_F(IndexedVarSetTests,
+VarIndexAssignsIndexesInOrderOfVars) {
+	EXPECT_EQ(2, index->size());
+	EXPECT_EQ(0, index->getIndex(varA));
+	EXPECT_EQ(1, index->getIndex(varB));
+	EXPECT_EQ(VarIndex::NO_INDEX, index->getIndex(varC));
+	EXPECT_EQ(varB, index->getVar(1));
+}
+
+TEST_F(IndexedVarSetTests,
+SetContainsInsertedIndexedAndNotIndexedVars) {
+	IndexedVarSet vars(index);
+	EXPECT_TRUE(vars.empty());
+
+	vars.insert(varA);
+	vars.insert(varC);
+
+	EXPECT_FALSE(vars.empty());
+	EXPECT_TRUE(vars.hasVar(varA));
+	EXPECT_FALSE(vars.hasVar(varB));
+	EXPECT_TRUE(vars.hasVar(varC));
+	EXPECT_EQ(VarSet({varA, varC}), vars.getVars());
+	EXPECT_EQ(VarSet({varC}), vars.getOtherVars());
+}
+
+TEST_F(IndexedVarSetTests,
+InsertIndexedVarsSkipsNotIndexedVars) {
+	IndexedVarSet vars(index);
+	vars.insert(VarSet{varB, varC});
+
+	IndexedVarSet indexedVars(index);
+	indexedVars.insertIndexedVars(vars);
+
+	EXPECT_EQ(VarSet({varB}), indexedVars.getVars());
+}
+
+TEST_F(IndexedVarSetTests,
+InsertAllIndexedVarsInsertsAllVarsFromIndex) {
+	IndexedVarSet vars(index);
+	vars.insertAllIndexedVars();
+
+	EXPECT_EQ(VarSet({varA, varB}), vars.getVars());
+}
+
+TEST_F(IndexedVarSetTests,
+SetsWithSameVarsAreEqual) {
+	IndexedVarSet vars1(index);
+	vars1.insert(VarSet{varA, varC});
+	IndexedVarSet vars2(index);
+	vars2.insert(varC);
+	EXPECT_NE(vars1, vars2);
+
+	vars2.insert(varA);
+	EXPECT_EQ(vars1, vars2);
+}
+
+TEST_F(IndexedVarSetTests,
+SetWithoutIndexStoresAllVarsAsNotIndexedVars) {
+	IndexedVarSet vars;
+	vars.insert(varA);
+
+	EXPECT_TRUE(vars.hasVar(varA));
+	EXPECT_EQ(VarSet({varA}), vars.getOtherVars());
+}
+
+} // namespace tests
+} // namespace llvmir2hll
+} // namespace retdec
@@ -0,0 +1,152 @@
+/**
+ * @file tests/serdes/binary_tests.cpp
+ * @brief Tests for the binary encoding module.
+ * @copyright (c) 2019 Avast Software, licensed under the MIT license
+ */
+
+#include <gtest/gtest.h>
+
+#include <rapidjson/document.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#include "retdec/common/address.h"
+#include "retdec/common/pattern.h"
+#include "retdec/serdes/address.h"
+#include "retdec/serdes/binary.h"
+#include "retdec/serdes/pattern.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace serdes {
+namespace tests {
+
+class BinaryTests : public Test
+{
+	protected:
+		std::string toJson(const std::string& json)
+		{
+			rapidjson::Document root;
+			root.Parse(json);
+			rapidjson::StringBuffer sb;
+			rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(sb);
+			root.Accept(writer);
+			return sb.GetString();
+		}
+
+		rapidjson::Document read(const std::string& binary)
+		{
+			BinaryReader reader(binary.data(), binary.size());
+			rapidjson::Document root;
+			root.Populate(reader);
+			EXPECT_FALSE(reader.hasError()) << reader.getError();
+			return root;
+		}
+};
+
+TEST_F(BinaryTests, jsonToBinaryAndBackIsLossless)
+{
+	std::string json = R"({
+		"null": null,
+		"bools": [true, false],
+		"ints": [0, 1, -1, 127, 128, -4294967296, 9223372036854775807],
+		"uint": 18446744073709551615,
+		"double": 3.25,
+		"strings": ["", "abc", "abc", "0x0", "0x401000", "0x0401000", "0X10", "0xABC"],
+		"long": "0123456789012345678901234567890123456789012345678901234567890123456789",
+		"nested": {"a": {"b": [[], {}]}}
+	})";
+
+	std::string binary;
+	ASSERT_TRUE(jsonToBinary(json, binary));
+	EXPECT_TRUE(binary::isBinary(binary));
+	EXPECT_LT(binary.size(), json.size());
+
+	std::string back;
+	ASSERT_TRUE(binaryToJson(binary, back));
+	EXPECT_EQ(toJson(json), back);
+}
+
+TEST_F(BinaryTests, repeatedStringsAreStoredOnce)
+{
+	std::string value(40, 'x');
+	std::string once, twice;
+	ASSERT_TRUE(jsonToBinary("[\"" + value + "\"]", once));
+	ASSERT_TRUE(jsonToBinary("[\"" + value + "\",\"" + value + "\"]", twice));
+
+	EXPECT_LT(twice.size() - once.size(), 4);
+}
+
+TEST_F(BinaryTests, serializedObjectsCanBeDeserialized)
+{
+	auto p1 = common::Pattern::crypto("name", "description", "yara rule");
+	p1.setIsEndianLittle();
+	p1.matches.push_back(
+			common::Pattern::Match::integral(0x1000, 0x401000, 0x100, 4));
+
+	BinaryWriter writer;
+	serialize(writer, p1);
+	auto root = read(writer.getOutput());
+
+	common::Pattern p2;
+	deserialize(root, p2);
+	EXPECT_EQ("name", p2.getName());
+	EXPECT_EQ("description", p2.getDescription());
+	EXPECT_EQ("yara rule", p2.getYaraRuleName());
+	EXPECT_TRUE(p2.isTypeCrypto());
+	EXPECT_TRUE(p2.isEndianLittle());
+	ASSERT_EQ(1, p2.matches.size());
+	EXPECT_EQ(0x1000, p2.matches.front().getOffset());
+	EXPECT_EQ(0x401000, p2.matches.front().getAddress());
+	EXPECT_EQ(0x100, p2.matches.front().getSize());
+	EXPECT_EQ(4, p2.matches.front().getEntrySize());
+}
+
+TEST_F(BinaryTests, readerRejectsMissingHeader)
+{
+	std::string data = "{}";
+	BinaryReader reader(data.data(), data.size());
+	rapidjson::Document root;
+	root.Populate(reader);
+
+	EXPECT_TRUE(reader.hasError());
+}
+
+TEST_F(BinaryTests, readerRejectsNewerMajorVersion)
+{
+	std::string binary;
+	ASSERT_TRUE(jsonToBinary("{}", binary));
+	binary[sizeof(binary::Magic)] = binary::MajorVersion + 1;
+
+	std::string json;
+	EXPECT_FALSE(binaryToJson(binary, json));
+}
+
+TEST_F(BinaryTests, readerRejectsTruncatedData)
+{
+	std::string binary;
+	ASSERT_TRUE(jsonToBinary(R"({"a": [1, "abc", {"b": null}]})", binary));
+
+	for (std::size_t size = 0; size < binary.size(); ++size)
+	{
+		std::string json;
+		EXPECT_FALSE(binaryToJson(binary.substr(0, size), json)) << size;
+	}
+}
+
+TEST_F(BinaryTests, readerRejectsNonStringKeys)
+{
+	BinaryWriter writer;
+	writer.StartObject();
+	writer.Uint64(1);
+	writer.Uint64(2);
+	writer.EndObject();
+
+	std::string json;
+	EXPECT_FALSE(binaryToJson(writer.getOutput(), json));
+}
+
+} // namespace tests
+} // namespace serdes
+} // namespace retdec
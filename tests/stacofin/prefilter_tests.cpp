@@ -0,0 +1,262 @@
+/**
+ * @file tests/stacofin/prefilter_tests.cpp
+ * @brief Tests for the @c prefilter module.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/stacofin/prefilter.h"
+#include "retdec/utils/filesystem.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace stacofin {
+namespace tests {
+
+/**
+ * Tests for the @c prefilter module
+ */
+class PrefilterTests : public Test
+{
+	protected:
+		std::string writeTempFile(const std::string &suffix, const std::string &content)
+		{
+			auto *info = UnitTest::GetInstance()->current_test_info();
+			auto path = fs::temp_directory_path()
+					/ (std::string("retdec-") + info->name() + suffix);
+			std::ofstream(path.string(), std::ios::binary) << content;
+			tempFiles.push_back(path.string());
+			return path.string();
+		}
+
+		/**
+		 * Signature file with an index written by Prefilter::writeIndex()
+		 */
+		std::string writeSignatureFile(
+				const std::vector<std::uint32_t> &anchors,
+				bool complete = true)
+		{
+			auto path = writeTempFile(".yara", "rule r { condition: true }\n");
+			tempFiles.push_back(Prefilter::getIndexPath(path));
+			EXPECT_TRUE(Prefilter::writeIndex(path, anchors, complete));
+			return path;
+		}
+
+		/**
+		 * Overwrite the index of signature file @a path with @a content
+		 */
+		void writeIndexContent(const std::string &path, const std::string &content)
+		{
+			std::ofstream(Prefilter::getIndexPath(path)) << content;
+		}
+
+		std::string getIndexContent(const std::string &path)
+		{
+			std::ifstream in(Prefilter::getIndexPath(path));
+			return std::string(
+					std::istreambuf_iterator<char>(in),
+					std::istreambuf_iterator<char>());
+		}
+
+		void TearDown() override
+		{
+			for (const auto &f : tempFiles)
+			{
+				std::error_code ec;
+				fs::remove(f, ec);
+			}
+		}
+
+	private:
+		std::vector<std::string> tempFiles;
+};
+
+//
+// getAnchor()
+//
+
+TEST_F(PrefilterTests, anchorIsLeastCommonWindowOfFourFixedBytes)
+{
+	std::uint32_t anchor = 0;
+
+	ASSERT_TRUE(Prefilter::getAnchor("{ 00 00 00 00 12 34 56 78 }", anchor));
+	EXPECT_EQ(0x78563412, anchor);
+}
+
+TEST_F(PrefilterTests, anchorDoesNotContainNibbleWildcards)
+{
+	std::uint32_t anchor = 0;
+
+	ASSERT_TRUE(Prefilter::getAnchor("{ 55 8B EC 8? 11 22 33 44 }", anchor));
+	EXPECT_EQ(0x44332211, anchor);
+	ASSERT_TRUE(Prefilter::getAnchor("{ 1? 22 33 44 55 }", anchor));
+	EXPECT_EQ(0x55443322, anchor);
+	EXPECT_FALSE(Prefilter::getAnchor("{ 11 22 33 ?4 55 ?? }", anchor));
+}
+
+TEST_F(PrefilterTests, anchorDoesNotContainNegatedBytes)
+{
+	std::uint32_t anchor = 0;
+
+	ASSERT_TRUE(Prefilter::getAnchor("{ 11 22 ~33 44 55 66 77 }", anchor));
+	EXPECT_EQ(0x77665544, anchor);
+	EXPECT_FALSE(Prefilter::getAnchor("{ 11 22 ~33 44 55 }", anchor));
+}
+
+TEST_F(PrefilterTests, anchorDoesNotSpanJumps)
+{
+	std::uint32_t anchor = 0;
+
+	ASSERT_TRUE(Prefilter::getAnchor("{ 11 22 33 [2-4] 44 55 66 77 }", anchor));
+	EXPECT_EQ(0x77665544, anchor);
+	EXPECT_FALSE(Prefilter::getAnchor("{ 11 22 [4] 33 44 }", anchor));
+}
+
+TEST_F(PrefilterTests, anchorIsNotTakenFromAlternatives)
+{
+	std::uint32_t anchor = 0;
+
+	EXPECT_FALSE(Prefilter::getAnchor(
+			"{ ( 11 22 33 44 | 55 66 77 88 ) 99 }", anchor));
+	ASSERT_TRUE(Prefilter::getAnchor(
+			"{ 11 (22|(33|44)) 55 66 77 88 }", anchor));
+	EXPECT_EQ(0x88776655, anchor);
+}
+
+//
+// readIndex()
+//
+
+TEST_F(PrefilterTests, writtenIndexIsRead)
+{
+	auto path = writeSignatureFile({0x11223344, 0xaabbccdd});
+
+	std::vector<std::uint32_t> anchors;
+	ASSERT_TRUE(Prefilter::readIndex(path, anchors));
+	EXPECT_EQ(std::vector<std::uint32_t>({0x11223344, 0xaabbccdd}), anchors);
+}
+
+TEST_F(PrefilterTests, missingIndexIsNotRead)
+{
+	auto path = writeTempFile(".yara", "rule r { condition: true }\n");
+
+	std::vector<std::uint32_t> anchors;
+	EXPECT_FALSE(Prefilter::readIndex(path, anchors));
+}
+
+TEST_F(PrefilterTests, incompleteIndexIsNotRead)
+{
+	auto path = writeSignatureFile({}, false);
+
+	std::vector<std::uint32_t> anchors;
+	EXPECT_FALSE(Prefilter::readIndex(path, anchors));
+}
+
+TEST_F(PrefilterTests, indexOfModifiedSignatureFileIsNotRead)
+{
+	auto path = writeSignatureFile({0x11223344});
+	std::ofstream(path, std::ios::app) << "rule s { condition: true }\n";
+
+	std::vector<std::uint32_t> anchors;
+	EXPECT_FALSE(Prefilter::readIndex(path, anchors));
+}
+
+TEST_F(PrefilterTests, indexOfSignatureFileModifiedWithoutChangingSizeIsNotRead)
+{
+	auto path = writeSignatureFile({0x11223344});
+	auto mtime = fs::last_write_time(path);
+	std::ofstream(path, std::ios::binary) << "rule q { condition: true }\n";
+	fs::last_write_time(path, mtime + std::chrono::seconds(1));
+
+	std::vector<std::uint32_t> anchors;
+	EXPECT_FALSE(Prefilter::readIndex(path, anchors));
+}
+
+TEST_F(PrefilterTests, indexWithOtherHeaderIsNotRead)
+{
+	auto path = writeSignatureFile({0x11223344});
+	auto content = getIndexContent(path);
+	writeIndexContent(path, "retdec-stacofin-prefilter 2\n"
+			+ content.substr(content.find('\n') + 1));
+
+	std::vector<std::uint32_t> anchors;
+	EXPECT_FALSE(Prefilter::readIndex(path, anchors));
+}
+
+TEST_F(PrefilterTests, malformedIndexIsNotRead)
+{
+	auto path = writeSignatureFile({0x11223344});
+	auto content = getIndexContent(path);
+
+	for (const auto &anchor : {"1122zz44", "-1", "123456789", "xyz"})
+	{
+		writeIndexContent(path, content + anchor + "\n");
+
+		std::vector<std::uint32_t> anchors;
+		EXPECT_FALSE(Prefilter::readIndex(path, anchors)) << anchor;
+		EXPECT_TRUE(anchors.empty()) << anchor;
+	}
+}
+
+TEST_F(PrefilterTests, truncatedIndexIsNotRead)
+{
+	auto path = writeSignatureFile({0x11223344});
+	auto content = getIndexContent(path);
+	writeIndexContent(path, content.substr(0, content.find('\n') + 1));
+
+	std::vector<std::uint32_t> anchors;
+	EXPECT_FALSE(Prefilter::readIndex(path, anchors));
+}
+
+//
+// mayMatch()
+//
+
+TEST_F(PrefilterTests, signatureFileWhoseAnchorIsPresentIsKept)
+{
+	std::uint32_t anchor = 0;
+	ASSERT_TRUE(Prefilter::getAnchor("{ 55 8B EC 83 ?? 10 }", anchor));
+	auto path = writeSignatureFile({0x01020304, anchor});
+	const std::vector<std::uint8_t> data = {0x00, 0x55, 0x8b, 0xec, 0x83, 0x7d};
+
+	Prefilter prefilter(data.data(), data.size());
+
+	EXPECT_TRUE(prefilter.mayContain(anchor));
+	EXPECT_TRUE(prefilter.mayMatch(path));
+}
+
+TEST_F(PrefilterTests, signatureFileWithoutPresentAnchorsIsSkipped)
+{
+	auto path = writeSignatureFile({0x44332211, 0x88776655});
+	const std::vector<std::uint8_t> data = {0x11, 0x22, 0x33, 0x55, 0x66, 0x77};
+
+	Prefilter prefilter(data.data(), data.size());
+
+	EXPECT_FALSE(prefilter.mayMatch(path));
+}
+
+TEST_F(PrefilterTests, signatureFileWithoutUsableIndexIsKept)
+{
+	auto incomplete = writeSignatureFile({}, false);
+	auto modified = writeSignatureFile({0x44332211});
+	std::ofstream(modified, std::ios::app) << "\n";
+	auto missing = writeTempFile(".missing.yara", "");
+	const std::vector<std::uint8_t> data = {0x99, 0x99, 0x99, 0x99};
+
+	Prefilter prefilter(data.data(), data.size());
+
+	EXPECT_TRUE(prefilter.mayMatch(incomplete));
+	EXPECT_TRUE(prefilter.mayMatch(modified));
+	EXPECT_TRUE(prefilter.mayMatch(missing));
+}
+
+} // namespace tests
+} // namespace stacofin
+} // namespace retdec
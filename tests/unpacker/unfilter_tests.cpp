@@ -0,0 +1,179 @@
+/**
+* @file tests/unpacker/unfilter_tests.cpp
+* @brief Tests for the @c unfilter module of the UPX plugin.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "unpackertool/plugins/upx/unfilter.h"
+
+using namespace ::testing;
+using namespace retdec::utils;
+using namespace retdec::unpackertool::upx;
+
+namespace retdec {
+namespace unpacker {
+namespace tests {
+
+class UnfilterTests : public Test
+{
+	protected:
+		/**
+		* Creates data resembling filtered code: random bytes with many opcodes
+		* of filtered instructions.
+		*/
+		std::vector<std::uint8_t> createData(std::size_t size, std::uint32_t seed)
+		{
+			static const std::uint8_t interesting[] = {0xE8, 0xE9, 0x0F, 0x85, 0x8F, 0x0B, 0x4B, 0x48, 0x12};
+
+			std::mt19937 gen(seed);
+			std::vector<std::uint8_t> data(size);
+			for (auto& byte : data)
+			{
+				auto r = gen();
+				byte = (r % 8 == 0)
+					? interesting[(r >> 8) % sizeof(interesting)]
+					: static_cast<std::uint8_t>(r >> 16);
+			}
+			return data;
+		}
+
+		/**
+		* Unfilters @c data both by scalar and vectorized unfilter and checks
+		* that the results are the same.
+		*/
+		template <typename T>
+		void checkSameAsScalar(
+				const std::vector<std::uint8_t>& data,
+				Endianness endianness,
+				std::uint32_t filterParam,
+				std::uint32_t filterCount,
+				std::uint32_t startOffset,
+				std::uint32_t size)
+		{
+			DynamicBuffer scalarData(data, endianness);
+			DynamicBuffer vectorizedData(data, endianness);
+
+			T(false).perform(scalarData, filterParam, filterCount, startOffset, size);
+			T(true).perform(vectorizedData, filterParam, filterCount, startOffset, size);
+
+			ASSERT_EQ(scalarData.getBuffer(), vectorizedData.getBuffer())
+				<< "param " << filterParam << ", count " << filterCount
+				<< ", start " << startOffset << ", size " << size;
+		}
+
+		template <typename T>
+		void checkSameAsScalar(Endianness endianness = Endianness::LITTLE)
+		{
+			for (std::uint32_t seed = 0; seed < 4; ++seed)
+			{
+				auto data = createData(4096 + seed * 7, seed);
+				std::uint32_t fullSize = static_cast<std::uint32_t>(data.size());
+				for (std::uint32_t param : {0x00, 0x0B, 0x12})
+				{
+					checkSameAsScalar<T>(data, endianness, param, 0, 0, fullSize);
+					checkSameAsScalar<T>(data, endianness, param, 0, 3, fullSize - 3);
+					checkSameAsScalar<T>(data, endianness, param, 0, 5, fullSize - 27);
+					checkSameAsScalar<T>(data, endianness, param, 0, 1, 30);
+					checkSameAsScalar<T>(data, endianness, param, 17, 2, fullSize - 2);
+				}
+			}
+		}
+};
+
+TEST_F(UnfilterTests,
+Filter11UnfiltersCallInstructions) {
+	DynamicBuffer data(std::vector<std::uint8_t>{
+		0x90, 0xE8, 0x10, 0x00, 0x00, 0x00, 0x90, 0xE9, 0x10, 0x00, 0x00, 0x00
+	});
+
+	EXPECT_TRUE(Unfilter::run(data, FILTER_11, 0));
+
+	EXPECT_EQ(std::vector<std::uint8_t>({
+		0x90, 0xE8, 0x0E, 0x00, 0x00, 0x00, 0x90, 0xE9, 0x10, 0x00, 0x00, 0x00
+	}), data.getBuffer());
+}
+
+TEST_F(UnfilterTests,
+Filter11IsSameAsScalar) {
+	checkSameAsScalar<Unfilter11>();
+}
+
+TEST_F(UnfilterTests,
+Filter16IsSameAsScalar) {
+	checkSameAsScalar<Unfilter16>();
+}
+
+TEST_F(UnfilterTests,
+Filter24IsSameAsScalar) {
+	checkSameAsScalar<Unfilter24>();
+}
+
+TEST_F(UnfilterTests,
+Filter26_46IsSameAsScalar) {
+	checkSameAsScalar<Unfilter26_46>();
+}
+
+TEST_F(UnfilterTests,
+Filter49IsSameAsScalar) {
+	checkSameAsScalar<Unfilter49>();
+}
+
+TEST_F(UnfilterTests,
+Filter50IsSameAsScalar) {
+	checkSameAsScalar<Unfilter50>(Endianness::LITTLE);
+}
+
+TEST_F(UnfilterTests,
+Filter51IsSameAsScalar) {
+	checkSameAsScalar<Unfilter50>(Endianness::BIG);
+}
+
+TEST_F(UnfilterTests,
+FilterD0IsSameAsScalar) {
+	checkSameAsScalar<UnfilterD0>(Endianness::BIG);
+	checkSameAsScalar<UnfilterD0>(Endianness::LITTLE);
+}
+
+/**
+* Not a test -- compares throughput of the scalar and vectorized unfilters.
+* Run with --gtest_also_run_disabled_tests to see the results.
+*/
+TEST_F(UnfilterTests,
+DISABLED_BenchmarkScalarAgainstVectorized) {
+	using Clock = std::chrono::steady_clock;
+
+	// Code with a CALL instruction every ~100 bytes.
+	std::mt19937 gen(0);
+	std::vector<std::uint8_t> code(64 * 1024 * 1024);
+	for (auto& byte : code)
+	{
+		auto r = gen();
+		byte = (r % 100 == 0) ? 0xE8 : static_cast<std::uint8_t>(r % 0xE0);
+	}
+
+	auto measure = [&](Unfilter&& unfilter) {
+		DynamicBuffer data(code);
+		auto start = Clock::now();
+		unfilter.perform(data, 0, 0, 0, data.getRealDataSize());
+		auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		return code.size() / seconds / (1024 * 1024);
+	};
+
+	std::cout << "filter 11 scalar:     " << measure(Unfilter11(false)) << " MiB/s\n"
+			<< "filter 11 vectorized: " << measure(Unfilter11(true)) << " MiB/s\n"
+			<< "filter 49 scalar:     " << measure(Unfilter49(false)) << " MiB/s\n"
+			<< "filter 49 vectorized: " << measure(Unfilter49(true)) << " MiB/s\n"
+			<< "filter 50 scalar:     " << measure(Unfilter50(false)) << " MiB/s\n"
+			<< "filter 50 vectorized: " << measure(Unfilter50(true)) << " MiB/s" << std::endl;
+}
+
+} // namespace tests
+} // namespace unpacker
+} // namespace retdec
@@ -0,0 +1,113 @@
+/**
+* @file tests/utils/async_log_tests.cpp
+* @brief Tests for the asynchronous logging.
+* @copyright (c) 2020 Avast Software, licensed under the MIT license
+*/
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/utils/io/log.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace utils {
+namespace io {
+namespace tests {
+
+/**
+* @brief Tests for the asynchronous logging.
+*/
+class AsyncLogTests: public Test {
+protected:
+	virtual void SetUp() override {
+		Log::set(Log::Type::Debug, Logger::Ptr(new Logger(out)));
+	}
+
+	virtual void TearDown() override {
+		Log::setAsync(false);
+		Log::set(Log::Type::Debug, nullptr);
+	}
+
+	std::ostringstream out;
+};
+
+TEST_F(AsyncLogTests,
+RecordsAreWrittenAfterFlush) {
+	Log::setAsync(true);
+	Log::debug() << "a" << 1 << std::endl;
+	Log::debug() << "b";
+	Log::flush();
+
+	ASSERT_EQ("a1\nb", out.str());
+}
+
+TEST_F(AsyncLogTests,
+RecordsOfThreadsAreNotMixed) {
+	Log::setAsync(true);
+	const int threads = 4;
+	const int lines = 2000;
+	std::vector<std::thread> ts;
+	for (int t = 0; t < threads; ++t) {
+		ts.emplace_back([t]() {
+			for (int i = 0; i < lines; ++i) {
+				Log::debug() << "thread " << t << " line " << i << std::endl;
+			}
+		});
+	}
+	for (auto& t : ts) {
+		t.join();
+	}
+	Log::flush();
+
+	std::vector<int> next(threads, 0);
+	std::istringstream in(out.str());
+	std::string word1, word2;
+	int t = 0, i = 0, count = 0;
+	while (in >> word1 >> t >> word2 >> i) {
+		ASSERT_EQ("thread", word1);
+		ASSERT_EQ("line", word2);
+		ASSERT_EQ(next[t]++, i);
+		++count;
+	}
+	ASSERT_EQ(threads * lines, count);
+}
+
+TEST_F(AsyncLogTests,
+StoppingWritesQueuedRecords) {
+	Log::setAsync(true);
+	Log::debug() << "a" << std::endl;
+	Log::setAsync(false);
+	Log::debug() << "b" << std::endl;
+
+	ASSERT_EQ("a\nb\n", out.str());
+}
+
+TEST_F(AsyncLogTests,
+MacroDoesNotEvaluateValuesForNonVerboseLogger) {
+	Log::set(Log::Type::Debug, Logger::Ptr(new Logger(out, false)));
+	int evaluated = 0;
+	RETDEC_LOG_DEBUG << ++evaluated << std::endl;
+
+	ASSERT_EQ(0, evaluated);
+	ASSERT_TRUE(out.str().empty());
+}
+
+TEST_F(AsyncLogTests,
+MacroLogsIntoVerboseLogger) {
+	int evaluated = 0;
+	RETDEC_LOG_DEBUG << ++evaluated << std::endl;
+
+	ASSERT_EQ(1, evaluated);
+	ASSERT_EQ("1\n", out.str());
+}
+
+} // namespace tests
+} // namespace io
+} // namespace utils
+} // namespace retdec
@@ -0,0 +1,112 @@
+/**
+* @file tests/utils/profiler_tests.cpp
+* @brief Tests for the @c profiler module.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <sstream>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "retdec/utils/profiler.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace utils {
+namespace tests {
+
+/**
+* @brief Tests for the @c profiler module.
+*/
+class ProfilerTests: public Test {
+protected:
+	virtual void SetUp() override {
+		Profiler::get().reset();
+		Profiler::get().setTraceEnabled(false);
+	}
+};
+
+TEST_F(ProfilerTests,
+ScopesWithSameNameAreAggregated) {
+	for (int i = 0; i < 3; ++i) {
+		ProfileScope scope("a");
+	}
+	{
+		ProfileScope scope("b");
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+
+	auto stats = Profiler::get().getScopeStats();
+	ASSERT_EQ(2, stats.size());
+	ASSERT_EQ(3, stats["a"].calls);
+	ASSERT_EQ(1, stats["b"].calls);
+	ASSERT_LE(2000000, stats["b"].totalNs);
+	ASSERT_EQ(stats["b"].totalNs, stats["b"].maxNs);
+}
+
+TEST_F(ProfilerTests,
+PhasesLastUntilNextPhaseStarts) {
+	{
+		ProfilePhases phases("tool");
+		phases.next("first");
+		phases.next("second");
+		phases.next("first");
+	}
+
+	auto stats = Profiler::get().getScopeStats();
+	ASSERT_EQ(2, stats.size());
+	ASSERT_EQ(2, stats["tool/first"].calls);
+	ASSERT_EQ(1, stats["tool/second"].calls);
+}
+
+TEST_F(ProfilerTests,
+CountersAreSummed) {
+	auto &c = Profiler::get().counter("bytes");
+	c += 10;
+	Profiler::get().addToCounter("bytes", 5);
+
+	ASSERT_EQ(15, Profiler::get().getCounter("bytes"));
+	ASSERT_EQ(0, Profiler::get().getCounter("unknown"));
+}
+
+TEST_F(ProfilerTests,
+MetricsContainScopesAndCounters) {
+	{
+		ProfileScope scope("phase \"x\"");
+	}
+	Profiler::get().addToCounter("functions", 7);
+
+	std::ostringstream out;
+	Profiler::get().writeMetrics(out);
+
+	auto json = out.str();
+	EXPECT_NE(std::string::npos, json.find("\"wallTime\": "));
+	EXPECT_NE(std::string::npos, json.find("\"phase \\\"x\\\"\": {\"calls\": 1, "));
+	EXPECT_NE(std::string::npos, json.find("\"functions\": 7"));
+}
+
+TEST_F(ProfilerTests,
+TraceContainsOnlyScopesExecutedWhileTracingIsEnabled) {
+	{
+		ProfileScope scope("hidden");
+	}
+	Profiler::get().setTraceEnabled(true);
+	{
+		ProfileScope scope("visible");
+	}
+	Profiler::get().setTraceEnabled(false);
+
+	std::ostringstream out;
+	Profiler::get().writeChromeTrace(out);
+
+	auto json = out.str();
+	EXPECT_EQ(0, json.find("{\"traceEvents\": ["));
+	EXPECT_NE(std::string::npos, json.find("{\"name\": \"visible\", \"ph\": \"X\""));
+	EXPECT_EQ(std::string::npos, json.find("hidden"));
+}
+
+} // namespace tests
+} // namespace utils
+} // namespace retdec
@@ -0,0 +1,260 @@
+/**
+* @file tests/utils/thread_pool_tests.cpp
+* @brief Tests for the @c thread_pool module.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/utils/thread_pool.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace utils {
+namespace tests {
+
+/**
+* @brief Tests for the @c thread_pool module.
+*/
+class ThreadPoolTests: public Test {};
+
+//
+// ThreadPool
+//
+
+TEST_F(ThreadPoolTests,
+PoolExecutesAllSubmittedTasksBeforeDestruction) {
+	std::atomic<int> counter{0};
+	{
+		ThreadPool pool(4);
+		for (int i = 0; i < 1000; ++i) {
+			pool.submit([&counter]() { ++counter; });
+		}
+	}
+	ASSERT_EQ(1000, counter);
+}
+
+TEST_F(ThreadPoolTests,
+PoolWithoutWorkersExecutesTasksInSubmittingThread) {
+	ThreadPool pool(0);
+	auto id = std::this_thread::get_id();
+	std::thread::id executedIn;
+	pool.submit([&executedIn]() { executedIn = std::this_thread::get_id(); });
+	ASSERT_EQ(id, executedIn);
+}
+
+//
+// TaskGroup
+//
+
+TEST_F(ThreadPoolTests,
+WaitReturnsAfterAllTasksOfGroupFinish) {
+	ThreadPool pool(3);
+	std::atomic<int> counter{0};
+	TaskGroup group(pool);
+	for (int i = 0; i < 100; ++i) {
+		group.run([&counter]() { ++counter; });
+	}
+	group.wait();
+	ASSERT_EQ(100, counter);
+}
+
+TEST_F(ThreadPoolTests,
+NestedGroupsDoNotDeadlockEvenWithOneWorker) {
+	ThreadPool pool(1);
+	std::atomic<int> counter{0};
+	TaskGroup outer(pool);
+	for (int i = 0; i < 10; ++i) {
+		outer.run([&pool, &counter]() {
+			TaskGroup inner(pool);
+			for (int j = 0; j < 10; ++j) {
+				inner.run([&counter]() { ++counter; });
+			}
+			inner.wait();
+		});
+	}
+	outer.wait();
+	ASSERT_EQ(100, counter);
+}
+
+TEST_F(ThreadPoolTests,
+WaitRethrowsExceptionThrownFromTask) {
+	ThreadPool pool(2);
+	TaskGroup group(pool);
+	group.run([]() { throw std::runtime_error("failure"); });
+	ASSERT_THROW(group.wait(), std::runtime_error);
+	ASSERT_TRUE(group.isCancelled());
+}
+
+TEST_F(ThreadPoolTests,
+TasksOfCancelledGroupAreNotStarted) {
+	ThreadPool pool(0);
+	CancellationToken token;
+	token.cancel();
+	bool executed = false;
+	TaskGroup group(pool, token);
+	group.run([&executed]() { executed = true; });
+	group.wait();
+	ASSERT_FALSE(executed);
+}
+
+//
+// parallelFor
+//
+
+TEST_F(ThreadPoolTests,
+ParallelForCallsFunctionForEveryIndexOnce) {
+	std::vector<std::atomic<int>> calls(10000);
+	parallelFor(0, calls.size(), [&calls](std::size_t i) { ++calls[i]; });
+	for (auto &c : calls) {
+		ASSERT_EQ(1, c);
+	}
+}
+
+TEST_F(ThreadPoolTests,
+ParallelForRangesSplitsRangeIntoChunksOfGivenGrain) {
+	std::atomic<std::size_t> sum{0};
+	std::atomic<int> chunks{0};
+	parallelForRanges(10, 110, [&](std::size_t b, std::size_t e) {
+			EXPECT_LE(e - b, 10);
+			for (auto i = b; i < e; ++i) {
+				sum += i;
+			}
+			++chunks;
+		},
+		CancellationToken(), 10);
+	ASSERT_EQ(5950, sum);
+	ASSERT_EQ(10, chunks);
+}
+
+TEST_F(ThreadPoolTests,
+ParallelForOverEmptyRangeDoesNothing) {
+	bool called = false;
+	parallelFor(5, 5, [&called](std::size_t) { called = true; });
+	ASSERT_FALSE(called);
+}
+
+TEST_F(ThreadPoolTests,
+ParallelForStopsWhenTokenIsCancelled) {
+	CancellationToken token;
+	std::atomic<std::size_t> processed{0};
+	parallelFor(0, 100000, [&](std::size_t i) {
+			if (i == 0) {
+				token.cancel();
+			}
+			++processed;
+		},
+		token, 1);
+	ASSERT_TRUE(token.isCancelled());
+	ASSERT_LT(processed, 100000);
+}
+
+TEST_F(ThreadPoolTests,
+ParallelForRethrowsExceptionAndDoesNotCancelCallersToken) {
+	CancellationToken token;
+	ASSERT_THROW(
+		parallelFor(0, 1000, [](std::size_t i) {
+				if (i == 500) {
+					throw std::runtime_error("failure");
+				}
+			},
+			token, 1),
+		std::runtime_error);
+	ASSERT_FALSE(token.isCancelled());
+}
+
+TEST_F(ThreadPoolTests,
+ParallelForRangesWaitsForRunningChunksBeforeRethrowing) {
+	ThreadPool::setMaxConcurrency(4);
+	auto id = std::this_thread::get_id();
+	std::atomic<int> running{0};
+	std::atomic<bool> otherStarted{false};
+	ASSERT_THROW(
+		parallelForRanges(0, 4, [&](std::size_t, std::size_t) {
+				if (std::this_thread::get_id() == id) {
+					// Let another chunk start before failing.
+					for (int i = 0; i < 200 && !otherStarted; ++i) {
+						std::this_thread::sleep_for(std::chrono::milliseconds(1));
+					}
+					throw std::runtime_error("failure");
+				}
+				++running;
+				otherStarted = true;
+				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+				--running;
+			},
+			CancellationToken(), 1),
+		std::runtime_error);
+	ThreadPool::setMaxConcurrency(0);
+	ASSERT_EQ(0, running);
+}
+
+TEST_F(ThreadPoolTests,
+MaxConcurrencyZeroMeansAllHardwareThreads) {
+	ThreadPool::setMaxConcurrency(0);
+	ASSERT_LE(1, ThreadPool::getMaxConcurrency());
+	ThreadPool::setMaxConcurrency(3);
+	ASSERT_EQ(3, ThreadPool::getMaxConcurrency());
+	ThreadPool::setMaxConcurrency(0);
+}
+
+TEST_F(ThreadPoolTests,
+ParallelForWithConcurrencyOneRunsInCallingThread) {
+	ThreadPool::setMaxConcurrency(1);
+	auto id = std::this_thread::get_id();
+	std::atomic<bool> otherThread{false};
+	parallelFor(0, 1000, [&](std::size_t) {
+			if (std::this_thread::get_id() != id) {
+				otherThread = true;
+			}
+		},
+		CancellationToken(), 1);
+	ThreadPool::setMaxConcurrency(0);
+	ASSERT_FALSE(otherThread);
+}
+
+//
+// Benchmark (run with --gtest_also_run_disabled_tests).
+//
+
+TEST_F(ThreadPoolTests,
+DISABLED_SchedulingOverheadBenchmark) {
+	using Clock = std::chrono::steady_clock;
+	const std::size_t tasks = 200000;
+
+	ThreadPool pool(std::thread::hardware_concurrency());
+	std::atomic<std::size_t> counter{0};
+	auto start = Clock::now();
+	{
+		TaskGroup group(pool);
+		for (std::size_t i = 0; i < tasks; ++i) {
+			group.run([&counter]() { ++counter; });
+		}
+		group.wait();
+	}
+	auto taskNs = std::chrono::duration<double, std::nano>(
+		Clock::now() - start).count() / tasks;
+
+	std::vector<std::size_t> data(10000000);
+	std::iota(data.begin(), data.end(), 0);
+	start = Clock::now();
+	parallelFor(0, data.size(), [&data](std::size_t i) { data[i] *= 3; });
+	auto forMs = std::chrono::duration<double, std::milli>(
+		Clock::now() - start).count();
+
+	std::cout << "task submit+run: " << taskNs << " ns/task\n"
+		<< "parallelFor over " << data.size() << " items: " << forMs << " ms\n";
+	ASSERT_EQ(tasks, counter);
+}
+
+} // namespace tests
+} // namespace utils
+} // namespace retdec
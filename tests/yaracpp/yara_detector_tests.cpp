@@ -0,0 +1,256 @@
+/**
+ * @file tests/yaracpp/yara_detector_tests.cpp
+ * @brief Tests for the @c YaraDetector class.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <yara.h>
+
+#include "retdec/utils/filesystem.h"
+#include "retdec/yaracpp/yara_detector.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace yaracpp {
+namespace tests {
+
+namespace {
+
+const char* TEXT_RULE = R"(
+rule text_rule
+{
+	meta:
+		description = "text"
+	strings:
+		$a = { de ad be ef }
+	condition:
+		$a
+}
+)";
+
+const char* COMPILED_RULE = R"(
+rule compiled_rule
+{
+	strings:
+		$a = { ca fe ba be }
+	condition:
+		$a
+}
+)";
+
+} // anonymous namespace
+
+/**
+ * Tests for the @c YaraDetector class
+ */
+class YaraDetectorTests : public Test
+{
+	protected:
+		std::vector<std::uint8_t> bytes = {
+			0x00, 0x00, 0xde, 0xad, 0xbe, 0xef, 0x00, 0x00,
+			0x00, 0xca, 0xfe, 0xba, 0xbe, 0x00, 0xde, 0xad,
+			0xbe, 0xef
+		};
+
+		std::string tempPath(const std::string &suffix)
+		{
+			auto *info = UnitTest::GetInstance()->current_test_info();
+			auto path = fs::temp_directory_path()
+					/ (std::string("retdec-") + info->name() + suffix);
+			tempFiles.push_back(path.string());
+			return path.string();
+		}
+
+		std::string writeTextRuleFile(const std::string &content)
+		{
+			auto path = tempPath(".yara");
+			std::ofstream(path) << content;
+			return path;
+		}
+
+		/**
+		 * Compile @a content by libyara and save it as a @c .yarac file
+		 */
+		std::string writeCompiledRuleFile(const std::string &content)
+		{
+			auto path = tempPath(".yarac");
+
+			EXPECT_EQ(ERROR_SUCCESS, yr_initialize());
+			YR_COMPILER *compiler = nullptr;
+			YR_RULES *rules = nullptr;
+			EXPECT_EQ(ERROR_SUCCESS, yr_compiler_create(&compiler));
+			EXPECT_EQ(0, yr_compiler_add_string(compiler, content.c_str(), nullptr));
+			EXPECT_EQ(ERROR_SUCCESS, yr_compiler_get_rules(compiler, &rules));
+			EXPECT_EQ(ERROR_SUCCESS, yr_rules_save(rules, path.c_str()));
+			yr_rules_destroy(rules);
+			yr_compiler_destroy(compiler);
+			yr_finalize();
+
+			return path;
+		}
+
+		void TearDown() override
+		{
+			for (const auto &f : tempFiles)
+			{
+				std::error_code ec;
+				fs::remove(f, ec);
+			}
+		}
+
+	private:
+		std::vector<std::string> tempFiles;
+};
+
+TEST_F(YaraDetectorTests, compileRulesFailsWithoutRules)
+{
+	YaraDetector detector;
+
+	EXPECT_FALSE(detector.compileRules());
+}
+
+TEST_F(YaraDetectorTests, constAnalyzeFailsWhenTextRulesAreNotCompiled)
+{
+	YaraDetector detector;
+	ASSERT_TRUE(detector.addRules(TEXT_RULE));
+
+	std::vector<YaraRule> detected;
+	EXPECT_FALSE(detector.analyze(bytes.data(), bytes.size(), detected));
+	EXPECT_TRUE(detected.empty());
+}
+
+TEST_F(YaraDetectorTests, compiledTextRulesReportMatchOffsets)
+{
+	YaraDetector detector;
+	ASSERT_TRUE(detector.addRules(TEXT_RULE));
+	ASSERT_TRUE(detector.compileRules());
+
+	std::vector<YaraRule> detected;
+	ASSERT_TRUE(detector.analyze(bytes.data(), bytes.size(), detected));
+
+	ASSERT_EQ(1, detected.size());
+	EXPECT_EQ("text_rule", detected[0].getName());
+	ASSERT_NE(nullptr, detected[0].getMeta("description"));
+	EXPECT_EQ("text", detected[0].getMeta("description")->getStringValue());
+	ASSERT_EQ(2, detected[0].getNumberOfMatches());
+	EXPECT_EQ(2, detected[0].getMatch(0)->getOffset());
+	EXPECT_EQ(4, detected[0].getMatch(0)->getDataSize());
+	EXPECT_EQ(14, detected[0].getMatch(1)->getOffset());
+}
+
+TEST_F(YaraDetectorTests, constAnalyzeDoesNotStoreResultsInDetector)
+{
+	YaraDetector detector;
+	ASSERT_TRUE(detector.addRules(TEXT_RULE));
+	ASSERT_TRUE(detector.compileRules());
+
+	std::vector<YaraRule> detected;
+	ASSERT_TRUE(detector.analyze(bytes.data(), bytes.size(), detected));
+
+	EXPECT_EQ(1, detected.size());
+	EXPECT_TRUE(detector.getDetectedRules().empty());
+}
+
+TEST_F(YaraDetectorTests, undetectedRulesAreStoredOnlyWhenRequested)
+{
+	YaraDetector detector;
+	ASSERT_TRUE(detector.addRules(TEXT_RULE));
+	ASSERT_TRUE(detector.compileRules());
+	std::vector<std::uint8_t> noMatch(16, 0);
+
+	std::vector<YaraRule> detected, undetected;
+	ASSERT_TRUE(detector.analyze(noMatch.data(), noMatch.size(), detected));
+	EXPECT_TRUE(detected.empty());
+	ASSERT_TRUE(detector.analyze(
+			noMatch.data(),
+			noMatch.size(),
+			detected,
+			undetected));
+	EXPECT_TRUE(detected.empty());
+	ASSERT_EQ(1, undetected.size());
+	EXPECT_EQ("text_rule", undetected[0].getName());
+}
+
+TEST_F(YaraDetectorTests, textRuleFileIsCompiledByCompileRules)
+{
+	YaraDetector detector;
+	ASSERT_TRUE(detector.addRuleFile(writeTextRuleFile(TEXT_RULE)));
+	ASSERT_TRUE(detector.compileRules());
+
+	std::vector<YaraRule> detected;
+	ASSERT_TRUE(detector.analyze(bytes.data(), bytes.size(), detected));
+	ASSERT_EQ(1, detected.size());
+	EXPECT_EQ("text_rule", detected[0].getName());
+}
+
+TEST_F(YaraDetectorTests, precompiledOnlyRulesCanBeScannedAfterCompileRules)
+{
+	YaraDetector detector;
+	ASSERT_TRUE(detector.addRuleFile(writeCompiledRuleFile(COMPILED_RULE)));
+	ASSERT_TRUE(detector.compileRules());
+
+	std::vector<YaraRule> detected;
+	ASSERT_TRUE(detector.analyze(bytes.data(), bytes.size(), detected));
+	ASSERT_EQ(1, detected.size());
+	EXPECT_EQ("compiled_rule", detected[0].getName());
+	ASSERT_EQ(1, detected[0].getNumberOfMatches());
+	EXPECT_EQ(9, detected[0].getMatch(0)->getOffset());
+}
+
+TEST_F(YaraDetectorTests, precompiledAndTextRulesAreScannedTogether)
+{
+	YaraDetector detector;
+	ASSERT_TRUE(detector.addRuleFile(writeCompiledRuleFile(COMPILED_RULE)));
+	ASSERT_TRUE(detector.addRuleFile(writeTextRuleFile(TEXT_RULE)));
+	ASSERT_TRUE(detector.compileRules());
+
+	std::vector<YaraRule> detected;
+	ASSERT_TRUE(detector.analyze(bytes.data(), bytes.size(), detected));
+	ASSERT_EQ(2, detected.size());
+	EXPECT_EQ("text_rule", detected[0].getName());
+	EXPECT_EQ("compiled_rule", detected[1].getName());
+}
+
+TEST_F(YaraDetectorTests, compiledRulesCanBeScannedConcurrently)
+{
+	YaraDetector detector;
+	ASSERT_TRUE(detector.addRules(TEXT_RULE));
+	ASSERT_TRUE(detector.compileRules());
+
+	std::atomic<std::size_t> found(0);
+	std::vector<std::thread> threads;
+	auto n = std::min<std::size_t>(8, YaraDetector::getMaxConcurrentScans());
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		threads.emplace_back([&]()
+		{
+			for (int j = 0; j < 20; ++j)
+			{
+				std::vector<YaraRule> detected;
+				if (detector.analyze(bytes.data(), bytes.size(), detected)
+						&& detected.size() == 1)
+				{
+					++found;
+				}
+			}
+		});
+	}
+	for (auto &t : threads)
+	{
+		t.join();
+	}
+
+	EXPECT_EQ(n * 20, found);
+}
+
+} // namespace tests
+} // namespace yaracpp
+} // namespace retdec